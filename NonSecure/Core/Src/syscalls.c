@@ -29,10 +29,16 @@
 #include <time.h>
 #include <sys/time.h>
 #include <sys/times.h>
-#include "secure_nsc.h"
+#include "main.h"
 
 
+/* Log ring handed to the secure side once; printf output goes out by DMA */
+#define LOG_RING_SIZE 2048U   /* power of two */
+
 /* Variables */
+static uint32_t log_storage[(sizeof(NSC_LogRingTypeDef) + LOG_RING_SIZE) / sizeof(uint32_t)]
+  __attribute__((section(".nsc_shared")));
+static int log_state = 0;     /* 0 not attached yet, 1 attached, -1 refused */
 extern int __io_putchar(int ch) __attribute__((weak));
 extern int __io_getchar(void) __attribute__((weak));
 
@@ -84,15 +90,49 @@ __attribute__((weak)) int _read(int file, char *ptr, int len)
   return len;
 }
 
+static void log_publish(NSC_LogRingTypeDef *ring, uint32_t head)
+{
+  __DMB();   /* text before head */
+  ring->head = head;
+  NSC_LogSubmit();
+}
+
 __attribute__((weak)) int _write(int file, char *ptr, int len)
 {
   (void)file;
+  NSC_LogRingTypeDef *ring = (NSC_LogRingTypeDef *)log_storage;
+  uint32_t head;
   int DataIdx;
 
+  if (log_state == 0)
+  {
+    ring->head = 0;
+    ring->tail = 0;
+    ring->size = LOG_RING_SIZE;
+    log_state = (NSC_LogAttach(ring) == 0) ? 1 : -1;
+  }
+
+  if (log_state < 0)
+  {
+    for (DataIdx = 0; DataIdx < len; DataIdx++)
+    {
+      __io_putchar(*ptr++);
+    }
+    return len;
+  }
+
+  /* One gateway call per write; a full ring is handed over and drained first */
+  head = ring->head;
   for (DataIdx = 0; DataIdx < len; DataIdx++)
   {
-    __io_putchar(*ptr++);
+    while ((head - ring->tail) >= LOG_RING_SIZE)
+    {
+      log_publish(ring, head);
+    }
+    ring->data[head & (LOG_RING_SIZE - 1U)] = (uint8_t)*ptr++;
+    head++;
   }
+  log_publish(ring, head);
   return len;
 }
 
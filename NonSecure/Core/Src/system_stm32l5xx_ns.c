@@ -102,8 +102,13 @@
 #else
 #define VECT_TAB_BASE_ADDRESS   FLASH_BASE_NS   /*!< Vector Table base address field.
                                                      This value must be a multiple of 0x200. */
-#define VECT_TAB_OFFSET         0x00040100U     /*!< Vector Table base offset field.
-                                                     This value must be a multiple of 0x200. */
+#ifndef NS_IMAGE_ADDR
+#define NS_IMAGE_ADDR           0x08040000U     /*!< Header of the A/B slot the image is linked for
+                                                     (Makefile NS_SLOT, also the ROM origin). */
+#endif
+#define VECT_TAB_OFFSET         (NS_IMAGE_ADDR - FLASH_BASE_NS + 0x100U) /*!< Vector Table base offset field:
+                                                     the table follows the 256-byte image header, as
+                                                     SECBOOT_BootManager_JumpTo sets it. */
 #endif /* VECT_TAB_SRAM */
 #endif /* USER_VECT_TAB_ADDRESS */
 
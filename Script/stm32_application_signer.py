@@ -3,10 +3,18 @@
 #
 # 1. Reads the raw application binary file.
 # 2. Calculates the SHA-256 hash of the binary.
+#    v2 format: hashes every 2KB block and hashes the block table instead.
 # 3. Signs the hash using an ECDSA private key.
 # 4. Constructs a firmware header with metadata + signature.
 # 5. Appends CRC and pads the header to 256 bytes with 0xFF.
 # 6. Prepends the header to the binary and writes the output image.
+#    v2 format: appends the block table, 8-byte aligned, after the binary.
+# 7. Optionally writes an encrypted update image (AES-CTR or AES-GCM): clear
+#    header with an encryption descriptor at 0xC0, then everything after the
+#    header encrypted as one stream.
+#    Optionally the stream is LZSS compressed before encryption, with a
+#    compression descriptor at 0xB0; the bootloader decompresses it on its
+#    way to flash.
 #
 # Requirements: pip install pycryptodome ecdsa
 # =============================================================================
@@ -16,6 +24,8 @@ from hashlib import sha256
 from cryptography.hazmat.primitives import hashes, serialization
 from cryptography.hazmat.primitives.asymmetric import ec, utils
 from cryptography.hazmat.backends import default_backend
+from cryptography.hazmat.primitives.ciphers import Cipher, algorithms, modes
+from cryptography.hazmat.primitives.ciphers.aead import AESGCM
 
 
 def compute_crc32(data_bytes):
@@ -37,17 +47,102 @@ def compute_crc32(data_bytes):
         crc &= 0xFFFFFFFF  # Ensure 32-bit
     return crc 
 
+
+def lzss_compress(data):
+    """
+    LZSS as decoded by secboot_lz.c: a flag byte per 8 tokens (LSB first,
+    1 = match), literal bytes, and 2-byte matches ((offset - 1) << 6 |
+    (length - 3)) reaching back up to LZ_WINDOW_SIZE bytes.
+    Greedy parse, one hash chain per 3-byte prefix.
+    """
+    out = bytearray()
+    chains = {}
+    flags_at = -1
+    token_count = 0
+    i = 0
+
+    def add_position(pos):
+        if pos + LZ_MIN_MATCH <= len(data):
+            chain = chains.setdefault(data[pos:pos + LZ_MIN_MATCH], [])
+            chain.append(pos)
+            if len(chain) > LZ_MAX_CHAIN:
+                del chain[0]
+
+    while i < len(data):
+        if token_count % 8 == 0:
+            flags_at = len(out)
+            out.append(0)
+
+        best_len, best_off = 0, 0
+        for j in reversed(chains.get(data[i:i + LZ_MIN_MATCH], [])):
+            if i - j > LZ_WINDOW_SIZE:
+                break
+            n = 0
+            limit = min(LZ_MAX_MATCH, len(data) - i)
+            while n < limit and data[j + n] == data[i + n]:
+                n += 1
+            if n > best_len:
+                best_len, best_off = n, i - j
+                if n == limit:
+                    break
+
+        if best_len >= LZ_MIN_MATCH:
+            out[flags_at] |= 1 << (token_count % 8)
+            out += struct.pack('<H', ((best_off - 1) << 6) | (best_len - LZ_MIN_MATCH))
+            for k in range(best_len):
+                add_position(i + k)
+            i += best_len
+        else:
+            out.append(data[i])
+            add_position(i)
+            i += 1
+        token_count += 1
+
+    return bytes(out)
+
 # --- Configuration ---
 APP_BINARY_PATH = "/home/pi/Documents/STM32/SecBoot/Makefile/NonSecure/build/SecBoot_NS.bin"
 OUTPUT_IMAGE_PATH = "/home/pi/Documents/STM32/SecBoot/Artifacts/Secboot_MainApp.bin"
 PRIVATE_KEY_PATH = "/home/pi/Documents/STM32/SecBoot/Script/keys/ec_private.pem"
 
+# --- Image Format ---
+# 1: flat SHA-256 of the binary (all-or-nothing verification)
+# 2: per-block SHA-256 table under a signed root (block-level verification,
+#    needs a bootloader that knows FW_MAGIC_NUMBER_V2)
+FW_IMAGE_FORMAT = 2
+FW_BLOCK_SIZE = 2048
+
+# --- Payload Encryption ---
+# None:  clear image only
+# "ctr": AES-128-CTR, blocks can be decrypted in any order (resumable updates)
+# "gcm": AES-128-GCM, decryption and authentication in one pass
+# The key is aes_key_1 from the "secboot_secrets" keyring (see store_keys.py),
+# the 16-byte update key the bootloader unwraps (FW_UPDATE_KEY_SIZE).
+FW_ENCRYPTION = None
+ENCRYPTED_IMAGE_PATH = "/home/pi/Documents/STM32/SecBoot/Artifacts/Secboot_MainApp_enc.bin"
+FW_ENC_INFO_OFFSET = 0xC0
+FW_ENC_MAGIC = 0xE4C0DE01
+FW_ENC_MODES = {"ctr": 0, "gcm": 1}  # SECBOOT_AES_ModeTypeDef
+
+# --- Update Compression ---
+# True: LZSS compress the stream of the encrypted update image (installed
+# images stay uncompressed, they run in place)
+FW_COMPRESSION = False
+FW_COMP_INFO_OFFSET = 0xB0
+FW_COMP_MAGIC_LZSS = 0xC0DE1255
+LZ_WINDOW_SIZE = 1024    # SECBOOT_LZ_WINDOW_SIZE
+LZ_MIN_MATCH = 3
+LZ_MAX_MATCH = 66
+LZ_MAX_CHAIN = 64        # candidates tried per position (ratio vs. speed)
+
 # --- Firmware Metadata ---
-FW_MAGIC_NUMBER = 0xDEADBEEF
+FW_MAGIC_NUMBER = 0xDEADBEEF if FW_IMAGE_FORMAT == 1 else 0xDEADB10C
 FW_VERSION_MAJOR = 1
 FW_VERSION_MINOR = 0
 FW_VERSION_PATCH = 0
 FW_VERSION_BUILD = 0
+# A/B updates run in place: link and sign for the inactive slot,
+# 0x08040100 for slot A (main app) or 0x0804D100 for slot B (slot 1)
 APP_ENTRY_POINT = 0x08040100
 
 # Read application binary
@@ -61,10 +156,21 @@ print(f"• Binary Path:    {APP_BINARY_PATH}")
 print(f"• Binary Size:    {image_size} bytes")
 
 # Calculate SHA-256 hash
-firmware_hash = sha256(app_binary).digest()
+block_table = b''
+if FW_IMAGE_FORMAT == 2:
+    # One hash per block; the signed value is the hash of the table
+    for offset in range(0, image_size, FW_BLOCK_SIZE):
+        block_table += sha256(app_binary[offset:offset + FW_BLOCK_SIZE]).digest()
+    firmware_hash = sha256(block_table).digest()
+else:
+    firmware_hash = sha256(app_binary).digest()
 print("\n[SECURITY] Cryptographic Hashes:")
 print("========================================")
-print(f"• SHA-256 Digest: {firmware_hash.hex().upper()}")
+if FW_IMAGE_FORMAT == 2:
+    print(f"• Block Table:    {len(block_table) // 32} x {FW_BLOCK_SIZE}-byte blocks")
+    print(f"• SHA-256 Root:   {firmware_hash.hex().upper()}")
+else:
+    print(f"• SHA-256 Digest: {firmware_hash.hex().upper()}")
 
 # Load private key (PEM, EC key)
 with open(PRIVATE_KEY_PATH, "rb") as key_file:
@@ -130,14 +236,82 @@ print(f"• Padding Added:  {padding_len} bytes")
 print(f"• Final Size:     {len(final_header)} bytes")
 
 # Write output file
+# v2: block table after the binary, padded to a flash double-word
+table_padding = b''
+if FW_IMAGE_FORMAT == 2:
+    table_padding = b'\xFF' * (-image_size % 8)
+
 with open(OUTPUT_IMAGE_PATH, "wb") as f:
     f.write(final_header)
     f.write(app_binary)
+    f.write(table_padding)
+    f.write(block_table)
 
 print("\n[SUCCESS] Signed Firmware Created:")
 print("========================================")
 print(f"• Output Path:    {OUTPUT_IMAGE_PATH}")
-print(f"• Total Size:     {len(final_header) + image_size} bytes")
+print(f"• Total Size:     {len(final_header) + image_size + len(table_padding) + len(block_table)} bytes")
+print(f"• Image Format:   v{FW_IMAGE_FORMAT}")
 print(f"• Header Magic:   0x{FW_MAGIC_NUMBER:08X}")
 print(f"• Entry Point:    0x{APP_ENTRY_POINT:08X}")
-print(f"• Version:        {FW_VERSION_MAJOR}.{FW_VERSION_MINOR}.{FW_VERSION_PATCH}.{FW_VERSION_BUILD}")
\ No newline at end of file
+print(f"• Version:        {FW_VERSION_MAJOR}.{FW_VERSION_MINOR}.{FW_VERSION_PATCH}.{FW_VERSION_BUILD}")
+
+# Encrypted update image
+if FW_ENCRYPTION is not None:
+    import keyring
+
+    key_hex = keyring.get_password("secboot_secrets", "aes_key_1")
+    if key_hex is None:
+        raise SystemExit("[ERROR] aes_key_1 missing from keyring, run store_keys.py")
+    enc_key = bytes.fromhex(key_hex)
+
+    # Payload, v2 pad and block table form one stream
+    enc_body = app_binary + table_padding + block_table
+    stream_size = len(enc_body)
+    use_compression = FW_COMPRESSION
+    if use_compression:
+        compressed = lzss_compress(enc_body)
+        if len(compressed) < stream_size:
+            enc_body = compressed
+        else:
+            print(f"\n[WARNING] LZSS does not shrink the stream ({len(compressed)} bytes), storing it uncompressed")
+            use_compression = False
+
+    if FW_ENCRYPTION == "ctr":
+        # 96-bit nonce, 32-bit block counter from 0 (the AES peripheral
+        # increments the low word only)
+        enc_iv = os.urandom(12) + bytes(4)
+        encryptor = Cipher(algorithms.AES(enc_key), modes.CTR(enc_iv), backend=default_backend()).encryptor()
+        enc_payload = encryptor.update(enc_body) + encryptor.finalize()
+        enc_tag = b'\xFF' * 16
+    elif FW_ENCRYPTION == "gcm":
+        # The clear header fields are authenticated as AAD
+        gcm_iv = os.urandom(12)
+        sealed = AESGCM(enc_key).encrypt(gcm_iv, enc_body, final_header[:len(header_without_crc) + 4])
+        enc_payload, enc_tag = sealed[:-16], sealed[-16:]
+        enc_iv = gcm_iv + bytes(4)
+    else:
+        raise SystemExit(f"[ERROR] Unknown FW_ENCRYPTION '{FW_ENCRYPTION}'")
+
+    enc_info = struct.pack('<II16s16s', FW_ENC_MAGIC, FW_ENC_MODES[FW_ENCRYPTION], enc_iv, enc_tag)
+    enc_header = (final_header[:FW_ENC_INFO_OFFSET] + enc_info +
+                  final_header[FW_ENC_INFO_OFFSET + len(enc_info):])
+    if use_compression:
+        comp_info = struct.pack('<II', FW_COMP_MAGIC_LZSS, len(enc_body))
+        enc_header = (enc_header[:FW_COMP_INFO_OFFSET] + comp_info +
+                      enc_header[FW_COMP_INFO_OFFSET + len(comp_info):])
+
+    with open(ENCRYPTED_IMAGE_PATH, "wb") as f:
+        f.write(enc_header)
+        f.write(enc_payload)
+
+    print("\n[SECURITY] Encrypted Update Image:")
+    print("========================================")
+    print(f"• Output Path:    {ENCRYPTED_IMAGE_PATH}")
+    print(f"• Mode:           AES-{len(enc_key) * 8}-{FW_ENCRYPTION.upper()}")
+    print(f"• IV:             {enc_iv.hex().upper()}")
+    if FW_ENCRYPTION == "gcm":
+        print(f"• GCM Tag:        {enc_tag.hex().upper()}")
+    if use_compression:
+        print(f"• LZSS:           {stream_size} -> {len(enc_body)} bytes "
+              f"({100.0 * len(enc_body) / stream_size:.1f}%)")
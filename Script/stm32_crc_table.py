@@ -0,0 +1,36 @@
+# =============================================================================
+# Slicing-by-8 Table Builder for the Software CRC-32
+#
+# Prints the crc32_table initializer of Secure/Core/Src/secboot_crc32.c:
+# eight 256-entry tables for the STM32 CRC unit convention (polynomial
+# 0x04C11DB7, MSB first, no reflection, no final XOR). Table 0 is the
+# classic byte-at-a-time table; table k gives the CRC contribution of a
+# byte followed by k zero bytes, so eight input bytes are folded with eight
+# lookups.
+# Run it again only if the polynomial changes.
+#
+# Requirements: none
+# =============================================================================
+POLY = 0x04C11DB7
+SLICES = 8
+PER_LINE = 6
+
+tables = [[0] * 256 for _ in range(SLICES)]
+for i in range(256):
+    crc = i << 24
+    for _ in range(8):
+        crc = ((crc << 1) ^ POLY) if crc & 0x80000000 else (crc << 1)
+    tables[0][i] = crc & 0xFFFFFFFF
+for k in range(1, SLICES):
+    for i in range(256):
+        prev = tables[k - 1][i]
+        tables[k][i] = ((prev << 8) & 0xFFFFFFFF) ^ tables[0][prev >> 24]
+
+print(f"static const uint32_t crc32_table[SECBOOT_CRC32_SLICES][256] = {{")
+for k, table in enumerate(tables):
+    print(f"    {{ /* T{k} */")
+    for row in range(0, 256, PER_LINE):
+        words = ", ".join(f"0x{v:08X}U" for v in table[row:row + PER_LINE])
+        print(f"        {words}{',' if row + PER_LINE < 256 else ''}")
+    print("    }," if k < SLICES - 1 else "    }")
+print("};")
@@ -0,0 +1,346 @@
+# =============================================================================
+# Delta Update Builder for STM32 Bootloader
+#
+# 1. Reads two signed clear images from stm32_application_signer.py: the base
+#    (the image running on the device) and the new image, linked and signed
+#    for the other A/B slot.
+# 2. Diffs the stream after the header (payload, v2 pad and block table) of
+#    the new image against the stream of the base into a list of ops:
+#    COPY / RELOC runs from the base, INSERT / REPLACE literals, SEEK moves.
+#    RELOC covers the words that differ only by the slot address offset, so
+#    relinking for the other slot costs almost nothing.
+# 3. Applies the patch to the base and checks the result byte for byte.
+# 4. Writes the delta update image: the signed header of the new image with a
+#    delta descriptor at 0x80 (patch size, base firmwareHash) and an
+#    encryption descriptor at 0xC0, followed by the encrypted patch.
+#    The bootloader rebuilds the new image from the active slot and checks it
+#    against the signed header exactly like a full update.
+#
+# Usage: python3 stm32_delta_builder.py [BASE NEW DELTA]  (default: the paths
+#        below). The key is $SECBOOT_AES_KEY_1 when set, as for secboot_image.
+#
+# Requirements: pip install cryptography keyring
+# =============================================================================
+import os
+import struct
+import sys
+from cryptography.hazmat.primitives.ciphers import Cipher, algorithms, modes
+from cryptography.hazmat.primitives.ciphers.aead import AESGCM
+from cryptography.hazmat.backends import default_backend
+
+# --- Configuration ---
+BASE_IMAGE_PATH = "/home/pi/Documents/STM32/SecBoot/Artifacts/Secboot_MainApp.bin"
+NEW_IMAGE_PATH = "/home/pi/Documents/STM32/SecBoot/Artifacts/Secboot_MainApp_B.bin"
+DELTA_IMAGE_PATH = "/home/pi/Documents/STM32/SecBoot/Artifacts/Secboot_MainApp_delta.bin"
+if len(sys.argv) == 4:
+    BASE_IMAGE_PATH, NEW_IMAGE_PATH, DELTA_IMAGE_PATH = sys.argv[1:]
+elif len(sys.argv) != 1:
+    raise SystemExit("usage: stm32_delta_builder.py [BASE NEW DELTA]")
+
+# --- Payload Encryption ---
+# "ctr" or "gcm", as in stm32_application_signer.py; the bootloader only
+# installs encrypted images. The key is aes_key_1 from the "secboot_secrets"
+# keyring (see store_keys.py), or $SECBOOT_AES_KEY_1.
+FW_ENCRYPTION = "gcm"
+FW_ENC_INFO_OFFSET = 0xC0
+FW_ENC_MAGIC = 0xE4C0DE01
+FW_ENC_MODES = {"ctr": 0, "gcm": 1}  # SECBOOT_AES_ModeTypeDef
+
+# --- Image Format ---
+FW_HEADER_SIZE = 256
+FW_HEADER_FIELDS = 116  # sizeof(FirmwareHeader_TypeDef), GCM AAD
+FW_MAGIC_V1 = 0xDEADBEEF
+FW_MAGIC_V2 = 0xDEADB10C
+FW_BLOCK_SIZE = 2048
+FW_DELTA_INFO_OFFSET = 0x80
+FW_DELTA_MAGIC = 0xDE17A001
+
+# --- Delta Ops (secboot_delta.h) ---
+OP_COPY, OP_INSERT, OP_REPLACE, OP_RELOC, OP_SEEK_FWD, OP_SEEK_BACK = range(6)
+OP_NAMES = ["COPY", "INSERT", "REPLACE", "RELOC", "SEEK_FWD", "SEEK_BACK"]
+LENGTH_INLINE = 28
+MIN_MATCH = 12         # shorter matches cost more as ops than as literals
+WINDOW = 8             # bytes hashed to find match candidates
+MAX_CANDIDATES = 16    # base positions kept per window
+
+
+def compute_crc32(data_bytes):
+    """
+    Same CRC32 as stm32_application_signer.py (STM32 CRC peripheral default)
+    """
+    crc = 0xFFFFFFFF
+    for byte in data_bytes:
+        crc ^= (byte << 24)
+        for _ in range(8):
+            if crc & 0x80000000:
+                crc = (crc << 1) ^ 0x04C11DB7
+            else:
+                crc = (crc << 1)
+        crc &= 0xFFFFFFFF
+    return crc
+
+
+def load_image(path):
+    """Return (header, stream, entry point, firmwareHash) of a signed clear image"""
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) <= FW_HEADER_SIZE:
+        raise SystemExit(f"[ERROR] {path}: too short for a signed image")
+
+    magic, image_size = struct.unpack_from('<II', data, 0)
+    entry_point, = struct.unpack_from('<I', data, 12)
+    firmware_hash = data[16:48]
+    header_crc, = struct.unpack_from('<I', data, FW_HEADER_FIELDS - 4)
+    if magic not in (FW_MAGIC_V1, FW_MAGIC_V2):
+        raise SystemExit(f"[ERROR] {path}: not a signed image (magic 0x{magic:08X})")
+    if compute_crc32(data[:FW_HEADER_FIELDS - 4]) != header_crc:
+        raise SystemExit(f"[ERROR] {path}: header CRC mismatch")
+    if data[FW_ENC_INFO_OFFSET:FW_ENC_INFO_OFFSET + 4] != b'\xFF' * 4:
+        raise SystemExit(f"[ERROR] {path}: encrypted image, use the clear one")
+
+    stream_size = image_size
+    if magic == FW_MAGIC_V2:
+        blocks = (image_size + FW_BLOCK_SIZE - 1) // FW_BLOCK_SIZE
+        stream_size = ((image_size + 7) & ~7) + blocks * 32
+    stream = data[FW_HEADER_SIZE:FW_HEADER_SIZE + stream_size]
+    if len(stream) != stream_size:
+        raise SystemExit(f"[ERROR] {path}: truncated ({len(stream)} of {stream_size} stream bytes)")
+
+    return data[:FW_HEADER_SIZE], stream, entry_point, firmware_hash
+
+
+def normalize(stream, entry_point):
+    """
+    Replace every aligned word that points into the image by its offset from
+    the entry point, so that code linked for another slot looks identical
+    """
+    low, high = entry_point - FW_HEADER_SIZE, entry_point + len(stream)
+    out = bytearray(stream)
+    for i in range(0, len(stream) - 3, 4):
+        word, = struct.unpack_from('<I', stream, i)
+        if low <= word < high:
+            struct.pack_into('<I', out, i, (word - entry_point) & 0xFFFFFFFF)
+    return bytes(out)
+
+
+def match_length(a, i, b, j):
+    n = 0
+    limit = min(len(a) - i, len(b) - j)
+    while n < limit and a[i + n] == b[j + n]:
+        n += 1
+    return n
+
+
+def encode_op(op, length):
+    if length < 1:
+        raise ValueError("empty op")
+    if length <= LENGTH_INLINE:
+        return bytes([(op << 5) | (length - 1)])
+    extra = (length.bit_length() + 7) // 8
+    return bytes([(op << 5) | (LENGTH_INLINE - 1 + extra)]) + length.to_bytes(extra, 'little')
+
+
+class PatchWriter:
+    """Collects ops, merging runs of the same kind"""
+
+    def __init__(self):
+        self.ops = []  # [op, length, literal bytes]
+
+    def add(self, op, length, literal=b''):
+        if self.ops and self.ops[-1][0] == op and op in (OP_COPY, OP_INSERT, OP_REPLACE, OP_RELOC):
+            self.ops[-1][1] += length
+            self.ops[-1][2] += literal
+        else:
+            self.ops.append([op, length, bytearray(literal)])
+
+    def seek(self, delta):
+        if delta > 0:
+            self.add(OP_SEEK_FWD, delta)
+        elif delta < 0:
+            self.add(OP_SEEK_BACK, -delta)
+
+    def encode(self):
+        out = bytearray()
+        for op, length, literal in self.ops:
+            out += encode_op(op, length) + literal
+        return bytes(out)
+
+
+def emit_match(patch, base, j, new, i, length, reloc):
+    """Emit a normalized match as COPY, RELOC and short REPLACE runs"""
+    k = 0
+    while k < length:
+        if k + 4 <= length:
+            base_word, = struct.unpack_from('<I', base, j + k)
+            new_word, = struct.unpack_from('<I', new, i + k)
+            if base_word != new_word and (base_word + reloc) & 0xFFFFFFFF == new_word:
+                patch.add(OP_RELOC, 1)
+                k += 4
+                continue
+        if new[i + k] == base[j + k]:
+            patch.add(OP_COPY, 1)
+        else:
+            patch.add(OP_REPLACE, 1, new[i + k:i + k + 1])
+        k += 1
+
+
+def build_patch(base, base_entry, new, new_entry):
+    reloc = (new_entry - base_entry) & 0xFFFFFFFF
+    base_norm = normalize(base, base_entry)
+    new_norm = normalize(new, new_entry)
+
+    index = {}
+    for j in range(len(base_norm) - WINDOW + 1):
+        candidates = index.setdefault(base_norm[j:j + WINDOW], [])
+        if len(candidates) < MAX_CANDIDATES:
+            candidates.append(j)
+
+    patch = PatchWriter()
+    base_pos = 0
+    pending = bytearray()
+    i = 0
+    while i < len(new_norm):
+        best_j, best_len = -1, 0
+        # Prefer the base cursor (after a literal of the same length as the
+        # bytes it replaced), then the indexed candidates
+        for j in [base_pos + len(pending)] + index.get(new_norm[i:i + WINDOW], []):
+            if 0 <= j < len(base_norm):
+                n = match_length(new_norm, i, base_norm, j)
+                if n > best_len:
+                    best_j, best_len = j, n
+
+        if best_len < MIN_MATCH:
+            pending.append(new[i])
+            i += 1
+            continue
+
+        if pending:
+            if best_j == base_pos + len(pending):
+                patch.add(OP_REPLACE, len(pending), pending)
+                base_pos += len(pending)
+            else:
+                patch.add(OP_INSERT, len(pending), pending)
+            pending = bytearray()
+        patch.seek(best_j - base_pos)
+        emit_match(patch, base, best_j, new, i, best_len, reloc)
+        base_pos = best_j + best_len
+        i += best_len
+
+    if pending:
+        patch.add(OP_INSERT, len(pending), pending)
+    return patch
+
+
+def apply_patch(base, patch, reloc):
+    """Reference decoder, same rules as secboot_delta.c"""
+    out = bytearray()
+    pos = 0
+    p = 0
+    while p < len(patch):
+        tag = patch[p]
+        p += 1
+        op, code = tag >> 5, tag & 0x1F
+        if code < LENGTH_INLINE:
+            length = code + 1
+        else:
+            extra = code - LENGTH_INLINE + 1
+            length = int.from_bytes(patch[p:p + extra], 'little')
+            p += extra
+        if op == OP_COPY:
+            out += base[pos:pos + length]
+            pos += length
+        elif op in (OP_INSERT, OP_REPLACE):
+            out += patch[p:p + length]
+            p += length
+            if op == OP_REPLACE:
+                pos += length
+        elif op == OP_RELOC:
+            for _ in range(length):
+                word, = struct.unpack_from('<I', base, pos)
+                out += struct.pack('<I', (word + reloc) & 0xFFFFFFFF)
+                pos += 4
+        elif op == OP_SEEK_FWD:
+            pos += length
+        elif op == OP_SEEK_BACK:
+            pos -= length
+        else:
+            raise ValueError(f"bad op {op}")
+        if pos < 0 or pos > len(base):
+            raise ValueError("base cursor out of bounds")
+    return bytes(out)
+
+
+# Read both images
+base_header, base_stream, base_entry, base_hash = load_image(BASE_IMAGE_PATH)
+new_header, new_stream, new_entry, new_hash = load_image(NEW_IMAGE_PATH)
+
+print("\n[INFO] Delta Inputs:")
+print("========================================")
+print(f"• Base Image:     {BASE_IMAGE_PATH}")
+print(f"• Base Entry:     0x{base_entry:08X}, {len(base_stream)} stream bytes")
+print(f"• New Image:      {NEW_IMAGE_PATH}")
+print(f"• New Entry:      0x{new_entry:08X}, {len(new_stream)} stream bytes")
+
+if new_entry == base_entry:
+    raise SystemExit("[ERROR] The new image must be linked for the other A/B slot than the base")
+
+# Diff and check
+patch = build_patch(base_stream, base_entry, new_stream, new_entry)
+patch_bytes = patch.encode()
+rebuilt = apply_patch(base_stream, patch_bytes, (new_entry - base_entry) & 0xFFFFFFFF)
+if rebuilt != new_stream:
+    raise SystemExit("[ERROR] Patch does not rebuild the new image")
+
+op_bytes = {}
+for op, length, literal in patch.ops:
+    op_bytes[OP_NAMES[op]] = op_bytes.get(OP_NAMES[op], 0) + (length * 4 if op == OP_RELOC else length)
+
+print("\n[DELTA] Patch:")
+print("========================================")
+print(f"• Ops:            {len(patch.ops)}")
+for name in OP_NAMES:
+    if name in op_bytes:
+        print(f"• {name + ':':<15} {op_bytes[name]} bytes")
+print(f"• Patch Size:     {len(patch_bytes)} bytes ({100.0 * len(patch_bytes) / len(new_stream):.1f}% of the stream)")
+print("• Self-check:     patch rebuilds the new image")
+
+# Encrypt the patch like a full stream
+key_hex = os.environ.get("SECBOOT_AES_KEY_1")
+if key_hex is None:
+    import keyring
+    key_hex = keyring.get_password("secboot_secrets", "aes_key_1")
+if key_hex is None:
+    raise SystemExit("[ERROR] aes_key_1 missing from keyring, run store_keys.py")
+enc_key = bytes.fromhex(key_hex)
+
+if FW_ENCRYPTION == "ctr":
+    enc_iv = os.urandom(12) + bytes(4)
+    encryptor = Cipher(algorithms.AES(enc_key), modes.CTR(enc_iv), backend=default_backend()).encryptor()
+    enc_payload = encryptor.update(patch_bytes) + encryptor.finalize()
+    enc_tag = b'\xFF' * 16
+elif FW_ENCRYPTION == "gcm":
+    gcm_iv = os.urandom(12)
+    sealed = AESGCM(enc_key).encrypt(gcm_iv, patch_bytes, new_header[:FW_HEADER_FIELDS])
+    enc_payload, enc_tag = sealed[:-16], sealed[-16:]
+    enc_iv = gcm_iv + bytes(4)
+else:
+    raise SystemExit(f"[ERROR] Unknown FW_ENCRYPTION '{FW_ENCRYPTION}'")
+
+delta_info = struct.pack('<II32s', FW_DELTA_MAGIC, len(patch_bytes), base_hash)
+enc_info = struct.pack('<II16s16s', FW_ENC_MAGIC, FW_ENC_MODES[FW_ENCRYPTION], enc_iv, enc_tag)
+delta_header = bytearray(new_header)
+delta_header[FW_DELTA_INFO_OFFSET:FW_DELTA_INFO_OFFSET + len(delta_info)] = delta_info
+delta_header[FW_ENC_INFO_OFFSET:FW_ENC_INFO_OFFSET + len(enc_info)] = enc_info
+
+with open(DELTA_IMAGE_PATH, "wb") as f:
+    f.write(delta_header)
+    f.write(enc_payload)
+
+print("\n[SUCCESS] Delta Update Image Created:")
+print("========================================")
+print(f"• Output Path:    {DELTA_IMAGE_PATH}")
+print(f"• Total Size:     {len(delta_header) + len(enc_payload)} bytes "
+      f"(full image: {FW_HEADER_SIZE + len(new_stream)} bytes)")
+print(f"• Base Hash:      {base_hash.hex().upper()}")
+print(f"• Target Hash:    {new_hash.hex().upper()}")
+print(f"• Mode:           AES-{len(enc_key) * 8}-{FW_ENCRYPTION.upper()}")
@@ -0,0 +1,71 @@
+# =============================================================================
+# Generator Table Builder for the Software P-256 Verifier
+#
+# Prints the p256_generator_table initializer of
+# Secure/Core/Src/secboot_p256.c: the multiples 1*G .. 15*G of the P-256
+# base point, affine, in the Montgomery domain of the field (x * 2^256 mod p)
+# as eight little-endian 32-bit limbs. The verifier picks one entry per
+# 4-bit window of u1 in u1*G + u2*Q.
+# With --montgomery it prints the Montgomery parameters of
+# Secure/Core/Src/prime256v1.c instead: R^2 mod p and R^2 mod n, R = 2^256,
+# least significant word first.
+# Run it again only if the window width or the limb layout changes.
+#
+# Requirements: none
+# =============================================================================
+import sys
+
+P = 0xFFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF
+A = P - 3
+GX = 0x6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296
+GY = 0x4FE342E2FE1A7F9B8EE7EB4A7C0F9E162BCE33576B315ECECBB6406837BF51F5
+N = 0xFFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551
+WINDOW_BITS = 4
+R = 1 << 256
+
+
+def point_add(p1, p2):
+    """Affine addition, None is the point at infinity."""
+    if p1 is None:
+        return p2
+    if p2 is None:
+        return p1
+    (x1, y1), (x2, y2) = p1, p2
+    if x1 == x2:
+        if (y1 + y2) % P == 0:
+            return None
+        lam = (3 * x1 * x1 + A) * pow(2 * y1, -1, P) % P
+    else:
+        lam = (y2 - y1) * pow(x2 - x1, -1, P) % P
+    x3 = (lam * lam - x1 - x2) % P
+    return x3, (lam * (x1 - x3) - y1) % P
+
+
+def limbs(value):
+    return ", ".join(f"0x{(value >> (32 * i)) & 0xFFFFFFFF:08X}U" for i in range(8))
+
+
+def montgomery_table(name, modulus):
+    value = R * R % modulus
+    print(f"static const uint32_t {name}[] = {{")
+    words = [f"0x{(value >> (32 * i)) & 0xFFFFFFFF:08x}" for i in range(8)]
+    print("    " + ", ".join(words[:4]) + ",")
+    print("    " + ", ".join(words[4:]))
+    print("};")
+
+
+if "--montgomery" in sys.argv[1:]:
+    montgomery_table("prime256v1_MontgomeryP", P)
+    montgomery_table("prime256v1_MontgomeryN", N)
+    sys.exit(0)
+
+point = None
+print("static const p256_affine p256_generator_table[P256_TABLE_SIZE - 1U] = {")
+for k in range(1, 1 << WINDOW_BITS):
+    point = point_add(point, (GX, GY))
+    x, y = point
+    print(f"    {{ /* {k}G */")
+    print(f"        {{ {{ {limbs(x * R % P)} }} }},")
+    print(f"        {{ {{ {limbs(y * R % P)} }} }}")
+    print("    }," if k < (1 << WINDOW_BITS) - 1 else "    }")
+print("};")
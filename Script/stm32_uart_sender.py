@@ -0,0 +1,273 @@
+# =============================================================================
+# UART Update Sender for STM32 Bootloader
+#
+# 1. Opens the serial line at the bootloader's baud rate and sends HELLO
+#    until the device answers, asking for TARGET_BAUD; both ends then switch.
+#    The bootloader listens for a HELLO only briefly after reset, and only
+#    when built with SECBOOT_TRANSFER_LISTEN_MS (0 by default): start the
+#    sender, then reset the device.
+# 2. Sends START with the size and CRC32 of the update image. The answer
+#    carries the chunk bitmap, so an interrupted transfer resumes where it
+#    stopped instead of starting over.
+# 3. Streams DATA frames in half-window batches, each closed by a QUERY.
+#    Two batches are in flight at most, which is what the device's DMA ring
+#    holds while it erases a flash page. Each QUERY answer is a selective
+#    acknowledgement (SACK): chunks of the batch that it does not list are
+#    sent again, nothing else is.
+# 4. Sends COMMIT; the device checks the CRC32 of the received image, or,
+#    when it installs the image as it arrives, confirms the install.
+#    Installing, the device answers REJECTED as soon as the image fails a
+#    check (header and signature right after the first chunk) and the
+#    transfer stops there.
+#
+# The image is sent as is (an encrypted update image from
+# stm32_application_signer.py or stm32_delta_builder.py): it is verified when
+# the bootloader installs it, not here.
+# Protocol: Secure/Core/Inc/secboot_transfer.h
+#
+# Requirements: none (termios, Linux/macOS)
+# =============================================================================
+import os
+import select
+import struct
+import sys
+import termios
+import time
+import tty
+
+# --- Configuration ---
+SERIAL_PORT = "/dev/ttyACM0"
+IMAGE_PATH = "/home/pi/Documents/STM32/SecBoot/Artifacts/Secboot_MainApp_update.bin"
+INITIAL_BAUD = 9600        # huart1 as configured by the bootloader
+TARGET_BAUD = 460800       # the device may answer with less
+HELLO_INTERVAL = 0.025     # seconds between HELLOs: a whole one fits SECBOOT_TRANSFER_LISTEN_MS
+HELLO_ATTEMPTS = 1200
+REPLY_TIMEOUT = 1.0        # seconds past the expected line time of a batch
+MAX_TIMEOUTS = 10          # consecutive unanswered queries before giving up
+
+# --- Protocol (secboot_transfer.h) ---
+SYNC = b'\xA5\x5A'
+HEADER_SIZE = 8
+CRC_SIZE = 4
+T_HELLO, T_START, T_DATA, T_QUERY, T_COMMIT = 0x01, 0x02, 0x03, 0x04, 0x05
+T_REPLY = 0x80
+RESULTS = ["OK", "BAD_FRAME", "TOO_LARGE", "NO_SESSION", "INCOMPLETE", "CRC_MISMATCH", "FLASH_ERROR",
+           "REJECTED"]
+
+
+def compute_crc32(data_bytes):
+    """
+    Same CRC32 as stm32_application_signer.py (STM32 CRC peripheral default)
+    """
+    crc = 0xFFFFFFFF
+    for byte in data_bytes:
+        crc ^= (byte << 24)
+        for _ in range(8):
+            if crc & 0x80000000:
+                crc = (crc << 1) ^ 0x04C11DB7
+            else:
+                crc = (crc << 1)
+        crc &= 0xFFFFFFFF
+    return crc
+
+
+class Line:
+    """Raw serial line with a frame parser on the receive side."""
+
+    def __init__(self, path, baud):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        tty.setraw(self.fd)
+        self.rx = bytearray()
+        self.set_baud(baud)
+
+    def set_baud(self, baud):
+        speed = getattr(termios, f"B{baud}", None)
+        if speed is None:
+            raise SystemExit(f"[ERROR] Baud rate {baud} not supported by this host")
+        attrs = termios.tcgetattr(self.fd)
+        attrs[4] = attrs[5] = speed
+        termios.tcsetattr(self.fd, termios.TCSADRAIN, attrs)
+        self.baud = baud
+
+    def send(self, ftype, index, payload=b''):
+        body = struct.pack('<BBHH', ftype, 0, index, len(payload)) + payload
+        os.write(self.fd, SYNC + body + struct.pack('<I', compute_crc32(body)))
+
+    def line_time(self, nbytes):
+        return nbytes * 10 / self.baud
+
+    def receive(self, timeout):
+        """Next valid device frame as (type, index, payload), or None."""
+        deadline = time.monotonic() + timeout
+        while True:
+            frame = self._parse()
+            if frame is not None:
+                return frame
+            left = deadline - time.monotonic()
+            if left <= 0 or not select.select([self.fd], [], [], left)[0]:
+                return None
+            self.rx += os.read(self.fd, 4096)
+
+    def _parse(self):
+        while True:
+            start = self.rx.find(SYNC)
+            if start < 0:
+                del self.rx[:max(0, len(self.rx) - 1)]
+                return None
+            del self.rx[:start]
+            if len(self.rx) < HEADER_SIZE:
+                return None
+            ftype, _, index, length = struct.unpack_from('<BBHH', self.rx, 2)
+            total = HEADER_SIZE + length + CRC_SIZE
+            if len(self.rx) < total:
+                return None
+            body = bytes(self.rx[2:HEADER_SIZE + length])
+            (crc,) = struct.unpack_from('<I', self.rx, HEADER_SIZE + length)
+            if crc != compute_crc32(body) or not ftype & T_REPLY:
+                del self.rx[:1]    # resync on the next sync pattern
+                continue
+            del self.rx[:total]
+            return ftype & ~T_REPLY, index, body[6:]
+
+    def close(self):
+        os.close(self.fd)
+
+
+def request(line, ftype, payload=b'', index=0, timeout=REPLY_TIMEOUT):
+    """Send a frame and wait for its answer; other answers are skipped."""
+    line.send(ftype, index, payload)
+    deadline = time.monotonic() + timeout
+    while True:
+        reply = line.receive(max(0, deadline - time.monotonic()))
+        if reply is None:
+            return None
+        if reply[0] == ftype and reply[1] == index:
+            return reply[2]
+
+
+def parse_state(payload):
+    """SACK: (result, set of received chunks) from a START/QUERY/COMMIT answer."""
+    if len(payload) < 3:
+        return payload[0], set()
+    (count,) = struct.unpack_from('<H', payload, 1)
+    bitmap = payload[3:]
+    return payload[0], {i for i in range(count) if bitmap[i // 8] & (1 << (i % 8))}
+
+
+def result_name(code):
+    return RESULTS[code] if code < len(RESULTS) else f"0x{code:02X}"
+
+
+# --- Main ---
+if len(sys.argv) > 1:
+    SERIAL_PORT = sys.argv[1]
+if len(sys.argv) > 2:
+    IMAGE_PATH = sys.argv[2]
+
+with open(IMAGE_PATH, "rb") as f:
+    image = f.read()
+image_crc = compute_crc32(image)
+
+line = Line(SERIAL_PORT, INITIAL_BAUD)
+
+# 1. HELLO until the device listens; it may still be booting
+print(f"[INFO] Waiting for the bootloader on {SERIAL_PORT} ...")
+hello = None
+for _ in range(HELLO_ATTEMPTS):
+    hello = request(line, T_HELLO, struct.pack('<I', TARGET_BAUD), timeout=HELLO_INTERVAL)
+    if hello is not None:
+        break
+if hello is None or len(hello) < 13 or hello[0] != 0:
+    raise SystemExit("[ERROR] No HELLO answer from the bootloader")
+_, version, window, chunk_size, baud, max_image = struct.unpack('<BBBHII', hello[:13])
+if len(image) > max_image:
+    raise SystemExit(f"[ERROR] Image of {len(image)} bytes, the update slot holds {max_image}")
+
+# The device switched after its answer left the line
+termios.tcdrain(line.fd)
+line.set_baud(baud)
+line.rx.clear()
+
+# 2. START (or resume)
+chunk_count = (len(image) + chunk_size - 1) // chunk_size
+state = request(line, T_START, struct.pack('<II', len(image), image_crc))
+if state is None:
+    raise SystemExit(f"[ERROR] No START answer at {baud} baud")
+result, received = parse_state(state)
+if result != 0:
+    raise SystemExit(f"[ERROR] START refused: {result_name(result)}")
+if received:
+    print(f"[INFO] Resuming: {len(received)}/{chunk_count} chunks already on the device")
+
+# 3. DATA in SACK-acknowledged batches
+batch_size = max(1, window // 2)
+frame_bytes = HEADER_SIZE + chunk_size + CRC_SIZE
+pending = [i for i in range(chunk_count) if i not in received]
+in_flight = []             # (query index, chunks) in send order
+query_index = 0
+resent = 0
+timeouts = 0
+started = time.monotonic()
+
+while pending or in_flight:
+    while pending and len(in_flight) < 2:
+        batch, pending = pending[:batch_size], pending[batch_size:]
+        for chunk in batch:
+            line.send(T_DATA, chunk, image[chunk * chunk_size:(chunk + 1) * chunk_size])
+        query_index = (query_index + 1) & 0xFFFF
+        line.send(T_QUERY, query_index)
+        in_flight.append((query_index, batch))
+
+    reply = line.receive(REPLY_TIMEOUT + line.line_time(2 * batch_size * frame_bytes))
+    if reply is None:
+        # Lost QUERY or answer: ask again what arrived, resend the rest
+        timeouts += 1
+        if timeouts > MAX_TIMEOUTS:
+            raise SystemExit("[ERROR] The bootloader stopped answering")
+        query_index = (query_index + 1) & 0xFFFF
+        state = request(line, T_QUERY, index=query_index)
+        if state is None:
+            continue
+        result, received = parse_state(state)
+        lost = [c for _, batch in in_flight for c in batch if c not in received]
+        resent += len(lost)
+        pending = lost + pending
+        in_flight = []
+        continue
+
+    ftype, index, payload = reply
+    if ftype != T_QUERY or not any(q == index for q, _ in in_flight):
+        continue
+    timeouts = 0
+    result, received = parse_state(payload)
+    if result != 0:
+        raise SystemExit(f"[ERROR] Transfer aborted by the device: {result_name(result)}")
+    # The answer covers its batch and all batches before it
+    while in_flight:
+        q, batch = in_flight.pop(0)
+        lost = [c for c in batch if c not in received]
+        resent += len(lost)
+        pending = lost + pending
+        if q == index:
+            break
+    print(f"\r[INFO] {len(received)}/{chunk_count} chunks", end="", flush=True)
+
+elapsed = time.monotonic() - started
+print()
+
+# 4. COMMIT
+state = request(line, T_COMMIT, timeout=REPLY_TIMEOUT + 5.0)
+line.close()
+if state is None:
+    raise SystemExit("[ERROR] No COMMIT answer")
+result, _ = parse_state(state)
+if result != 0:
+    raise SystemExit(f"[ERROR] COMMIT failed: {result_name(result)}")
+
+print("\n[SUCCESS] Update Image Transferred:")
+print("========================================")
+print(f"• Image:          {IMAGE_PATH} ({len(image)} bytes, CRC 0x{image_crc:08X})")
+print(f"• Line:           {SERIAL_PORT} at {baud} baud, protocol v{version}")
+print(f"• Chunks:         {chunk_count} x {chunk_size} bytes, window {window}, {resent} resent")
+print(f"• Rate:           {len(image) / max(elapsed, 1e-6) / 1024:.1f} KB/s "
+      f"(line limit {baud / 10 / 1024:.1f} KB/s)")
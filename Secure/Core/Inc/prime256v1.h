@@ -34,6 +34,10 @@ typedef struct {
     const uint8_t *order;      /*!< Order of G */
     uint32_t order_len;        /*!< Length of order */
 
+    const uint32_t *montgomeryP; /*!< R^2 mod P, R = 2^256, least significant word first */
+    const uint32_t *montgomeryN; /*!< R^2 mod order, same layout */
+    uint32_t montgomery_len;   /*!< Length of each Montgomery parameter in words */
+
     uint32_t cofactor;         /*!< Curve cofactor */
 
     const uint8_t *seed;       /*!< Optional curve seed */
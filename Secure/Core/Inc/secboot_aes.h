@@ -4,9 +4,11 @@
   * @author  Soulaimane Oulad Belayachi
   * @date    2025-06-05
   * @version 1.0
-  * @note    Uses STM32 HAL CRYP for AES-CBC with PKCS7 padding
+  * @note    Uses STM32 HAL CRYP for AES-CBC with PKCS7 padding, AES-CTR and
+  *          AES-GCM
   * @details This module provides hardware-accelerated AES-CBC with PKCS7 padding
-  *          for secure firmware updates on STM32L5 devices.
+  *          for secure firmware updates on STM32L5 devices, and streaming
+  *          CTR / GCM decryption of encrypted firmware images.
   */
 
 #ifndef SECBOOT_AES_H
@@ -17,10 +19,17 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stddef.h>
+#include <stdbool.h>
 
 #define AES_BLOCK_SIZE 16   ///< AES block size in bytes
 #define KEY_WORD_SIZE  4    ///< AES-128 key size in 32-bit words
 #define IV_WORD_SIZE   4    ///< Initialization vector size in 32-bit words
+#define AES_BLOCK_WORD_SIZE (AES_BLOCK_SIZE / 4)  ///< AES block size in 32-bit words
+#define AES_STREAM_MAX_CHUNK 0xFFF0U  ///< Largest block-aligned byte count per CRYP call (16-bit Size)
+#define AES_MAX_KEY_WORD_SIZE 8     ///< AES-256 key size in 32-bit words
+#define AES_CTR_IV_SIZE      16     ///< CTR initial counter block: nonce (12 bytes) || counter (4 bytes)
+#define AES_GCM_IV_SIZE      12     ///< GCM IV size in bytes
+#define AES_GCM_TAG_SIZE     16     ///< GCM authentication tag size in bytes
 
 #define SECBOOT_ORIGIN_ADDR              0x0C000000       ///< Secure boot origin address in flash
 #define SECBOOT_AES_KEY_ADDR             (SECBOOT_ORIGIN_ADDR + 0xA040)  ///< Default AES key address (secure zone)
@@ -31,9 +40,16 @@ typedef enum {
     SECBOOT_AES_OK = 0,            ///< Operation successful
     SECBOOT_AES_ERROR,             ///< General error (e.g., HAL failure)
     SECBOOT_AES_INVALID_PARAM,     ///< Invalid input parameters
-    SECBOOT_AES_PADDING_ERROR      ///< PKCS7 padding validation failed
+    SECBOOT_AES_PADDING_ERROR,     ///< PKCS7 padding validation failed
+    SECBOOT_AES_AUTH_ERROR         ///< GCM authentication tag mismatch
 } SECBOOT_AES_StatusTypeDef;
 
+/** @brief Chaining modes of SECBOOT_AES_CipherContext */
+typedef enum {
+    SECBOOT_AES_MODE_CTR = 0,      ///< AES-CTR, random access, no authentication
+    SECBOOT_AES_MODE_GCM           ///< AES-GCM authenticated decryption, sequential
+} SECBOOT_AES_ModeTypeDef;
+
 /** 
   * @brief AES cryptographic context
   * @warning The key and IV should be stored in secure memory when using TrustZone
@@ -53,6 +69,47 @@ typedef struct {
     uint32_t iv[IV_WORD_SIZE];     ///< Initialization vector
 } SECBOOT_AES_Secrets;
 
+/**
+  * @brief AES-CBC streaming decrypt context
+  * @note  Holds at most two blocks of data whatever the stream length: the
+  *        bytes of an incomplete ciphertext block and the newest plaintext
+  *        block, which is withheld until SECBOOT_AES_StreamFinal because it
+  *        may carry the PKCS7 padding. The CBC chaining value is kept here
+  *        rather than in the peripheral, so other CRYP users may run between
+  *        two updates.
+  * @warning Holds the key; SECBOOT_AES_StreamFinal wipes it
+  */
+typedef struct {
+    CRYP_HandleTypeDef hcryp;                ///< STM32 HAL CRYP handle (byte data type)
+    uint32_t key[KEY_WORD_SIZE];             ///< AES-128 key
+    uint32_t chain[IV_WORD_SIZE];            ///< IV, then the last ciphertext block
+    uint32_t partial[AES_BLOCK_WORD_SIZE];   ///< Incomplete ciphertext block
+    uint32_t held[AES_BLOCK_WORD_SIZE];      ///< Last plaintext block, not yet released
+    uint32_t partialLength;                  ///< Valid bytes in partial
+    bool     holding;                        ///< held contains a block
+} SECBOOT_AES_StreamContext;
+
+/**
+  * @brief AES-CTR / AES-GCM streaming decrypt context
+  * @note  CTR keeps the counter here and reloads it on every CRYP call, so
+  *        chunks may be decrypted in any order (SECBOOT_AES_CipherSeek).
+  *        GCM keeps the GHASH state in the peripheral between calls
+  *        (CRYP_KEYIVCONFIG_ONCE): from the first update to
+  *        SECBOOT_AES_CipherFinal no other code may use the CRYP.
+  * @warning Holds the key; SECBOOT_AES_CipherFinal wipes it
+  */
+typedef struct {
+    CRYP_HandleTypeDef hcryp;                ///< STM32 HAL CRYP handle (byte data type)
+    uint32_t key[AES_MAX_KEY_WORD_SIZE];     ///< AES-128 or AES-256 key
+    uint32_t initial[IV_WORD_SIZE];          ///< Counter block of payload offset 0
+    uint32_t counter[IV_WORD_SIZE];          ///< Counter block of the next CRYP call
+    uint32_t keystream[AES_BLOCK_WORD_SIZE]; ///< CTR: key stream of a partly used block
+    uint32_t keystreamUsed;                  ///< CTR: bytes of keystream already used (16 = none left)
+    uint32_t position;                       ///< Payload offset of the next byte
+    SECBOOT_AES_ModeTypeDef mode;            ///< Chaining mode
+    bool     finished;                       ///< GCM: an unaligned (last) update was made
+} SECBOOT_AES_CipherContext;
+
 /**
   * @brief  Initialize AES context for CBC mode
   * @param  ctx   Pointer to AES context (must be in secure memory if using TrustZone)
@@ -86,6 +143,7 @@ SECBOOT_AES_StatusTypeDef SECBOOT_AES_DeInit(SECBOOT_AES_Context *ctx);
   * @param  ciphertext      Output buffer for ciphertext (must be 32-bit aligned)
   * @param  ciphertext_len  Output length of ciphertext in words
   * @retval SECBOOT_AES_StatusTypeDef
+  * @note   Encrypts one block per CRYP call; no plaintext-sized buffers
   * @warning Plaintext buffer must not be in secure memory if called from non-secure zone
   */
 SECBOOT_AES_StatusTypeDef SECBOOT_AES_Encrypt(
@@ -104,7 +162,8 @@ SECBOOT_AES_StatusTypeDef SECBOOT_AES_Encrypt(
   * @param  plaintext       Output buffer for plaintext
   * @param  plaintext_len   Output length of plaintext in bytes
   * @retval SECBOOT_AES_StatusTypeDef
-  * @note   Automatically validates PKCS7 padding
+  * @note   Automatically validates PKCS7 padding. Runs block by block through
+  *         a stream context, so stack use does not depend on ciphertext_len.
   */
 SECBOOT_AES_StatusTypeDef SECBOOT_AES_Decrypt(
     SECBOOT_AES_Context *ctx,
@@ -114,4 +173,100 @@ SECBOOT_AES_StatusTypeDef SECBOOT_AES_Decrypt(
     size_t *plaintext_len
 );
 
+/**
+  * @brief  Start a streaming AES-CBC decryption
+  * @param  ctx   Pointer to stream context (secure memory)
+  * @param  key   Pointer to 128-bit key (4x uint32_t, same format as SECBOOT_AES_Init)
+  * @param  iv    Pointer to initialization vector (4x uint32_t)
+  * @retval SECBOOT_AES_StatusTypeDef
+  */
+SECBOOT_AES_StatusTypeDef SECBOOT_AES_StreamInit(SECBOOT_AES_StreamContext *ctx, const uint32_t *key,
+                                                 const uint32_t *iv);
+
+/**
+  * @brief  Decrypt the next part of a ciphertext stream
+  * @param  ctx         Pointer to stream context
+  * @param  input       Ciphertext bytes, any length and alignment
+  * @param  input_len   Number of ciphertext bytes
+  * @param  output      Plaintext output; needs room for input_len + AES_BLOCK_SIZE bytes
+  * @param  output_len  Number of plaintext bytes written
+  * @retval SECBOOT_AES_StatusTypeDef
+  * @note   Word-aligned input and output are decrypted in place by the CRYP
+  *         without intermediate copies. input and output must not overlap.
+  */
+SECBOOT_AES_StatusTypeDef SECBOOT_AES_StreamUpdate(SECBOOT_AES_StreamContext *ctx, const uint8_t *input,
+                                                   size_t input_len, uint8_t *output, size_t *output_len);
+
+/**
+  * @brief  Finish a streaming decryption and strip the PKCS7 padding
+  * @param  ctx         Pointer to stream context, wiped on return
+  * @param  output      Output for the last plaintext bytes (up to AES_BLOCK_SIZE - 1)
+  * @param  output_len  Number of plaintext bytes written
+  * @retval SECBOOT_AES_PADDING_ERROR if the stream was not block aligned or
+  *         the padding is invalid
+  */
+SECBOOT_AES_StatusTypeDef SECBOOT_AES_StreamFinal(SECBOOT_AES_StreamContext *ctx, uint8_t *output,
+                                                  size_t *output_len);
+
+/**
+  * @brief  Abandon a streaming decryption and wipe the context
+  * @param  ctx Pointer to stream context
+  */
+void SECBOOT_AES_StreamAbort(SECBOOT_AES_StreamContext *ctx);
+
+/**
+  * @brief  Start an AES-CTR or AES-GCM decryption
+  * @param  ctx      Pointer to cipher context (secure memory)
+  * @param  mode     SECBOOT_AES_MODE_CTR or SECBOOT_AES_MODE_GCM
+  * @param  key      AES key bytes
+  * @param  key_len  16 (AES-128) or 32 (AES-256)
+  * @param  iv       CTR: AES_CTR_IV_SIZE-byte counter block of offset 0;
+  *                  GCM: AES_GCM_IV_SIZE-byte IV
+  * @param  aad      GCM additional authenticated data (32-bit aligned), may be
+  *                  NULL; must stay valid until the first update
+  * @param  aad_len  Length of aad in bytes
+  * @retval SECBOOT_AES_StatusTypeDef
+  */
+SECBOOT_AES_StatusTypeDef SECBOOT_AES_CipherInit(SECBOOT_AES_CipherContext *ctx, SECBOOT_AES_ModeTypeDef mode,
+                                                 const uint8_t *key, size_t key_len, const uint8_t *iv,
+                                                 const uint8_t *aad, size_t aad_len);
+
+/**
+  * @brief  Decrypt the next part of the payload
+  * @param  ctx     Pointer to cipher context
+  * @param  input   Ciphertext
+  * @param  length  Number of bytes; GCM: a multiple of AES_BLOCK_SIZE except
+  *                 for the last update
+  * @param  output  Plaintext, length bytes (may equal input)
+  * @retval SECBOOT_AES_StatusTypeDef
+  * @warning GCM plaintext is unauthenticated until SECBOOT_AES_CipherFinal
+  *          returns SECBOOT_AES_OK
+  */
+SECBOOT_AES_StatusTypeDef SECBOOT_AES_CipherUpdate(SECBOOT_AES_CipherContext *ctx, const uint8_t *input,
+                                                   size_t length, uint8_t *output);
+
+/**
+  * @brief  Move a CTR decryption to another payload offset
+  * @param  ctx     Pointer to cipher context (CTR mode)
+  * @param  offset  Payload byte offset of the next update
+  * @retval SECBOOT_AES_INVALID_PARAM in GCM mode
+  */
+SECBOOT_AES_StatusTypeDef SECBOOT_AES_CipherSeek(SECBOOT_AES_CipherContext *ctx, uint32_t offset);
+
+/**
+  * @brief  Finish a decryption and check the GCM tag
+  * @param  ctx  Pointer to cipher context, wiped on return
+  * @param  tag  GCM: expected AES_GCM_TAG_SIZE-byte tag; CTR: ignored, may be NULL
+  * @retval SECBOOT_AES_AUTH_ERROR if the tag does not match
+  */
+SECBOOT_AES_StatusTypeDef SECBOOT_AES_CipherFinal(SECBOOT_AES_CipherContext *ctx, const uint8_t *tag);
+
+/**
+  * @brief  Abandon a CTR/GCM decryption and wipe the context
+  * @note   Also deinitialises the AES peripheral and clears its key and
+  *         IV registers.
+  * @param  ctx Pointer to cipher context
+  */
+void SECBOOT_AES_CipherAbort(SECBOOT_AES_CipherContext *ctx);
+
 #endif // SECBOOT_AES_H
\ No newline at end of file
@@ -19,11 +19,17 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "stm32l5xx.h"
 #include "secboot_aes.h"
 #include "secboot_sha256.h"
 #include "secboot_ecdsa.h"
 #include "secboot_crc.h"
+#include "secboot_seal.h"
+#include "secboot_slots.h"
+#include "secboot_flashwriter.h"
+#include "secboot_delta.h"
+#include "secboot_lz.h"
 #include "secure_nsc.h"
 #include "secboot_config.h"
 
@@ -40,18 +46,34 @@ extern "C" {
 #define BOOTLOADER_SIZE           32*1024        /**< Bootloader size in bytes (32KB) */
 #define AES_KEY_OFFSET            (BOOTLOADER_START_ADDR+0x8000)  /**< AES key storage offset */
 #define AES_KEY_SIZE              32              /**< AES-256 key size in bytes */
+#define FW_UPDATE_KEY_SIZE        16              /**< Update image key: AES-128, the unwrapped AES_KEY1 */
 #define AES_IV_OFFSET             (BOOTLOADER_START_ADDR+0x8020)  /**< AES IV storage offset */
 #define AES_IV_SIZE               16              /**< AES IV size in bytes */
 #define ECC_PUBKEY_OFFSET         (BOOTLOADER_START_ADDR+0x8030)  /**< ECC public key offset */
 #define ECC_PUBKEY_SIZE           64              /**< ECC P-256 public key size in bytes */
 #define BOOTLOADER_CRC_OFFSET     (BOOTLOADER_START_ADDR+0x8070)  /**< Bootloader CRC offset */
 #define FW_MAGIC_NUMBER           0xDEADBEEF      /**< Firmware magic number identifier */
+#define FW_MAGIC_NUMBER_V2        0xDEADB10C      /**< Block-table (v2) firmware identifier */
 #define FW_VERSION_SIZE           4               /**< Firmware version field size */
 #define FW_HASH_SIZE              32              /**< SHA-256 hash size */
 #define FW_SIGNATURE_SIZE         64              /**< ECDSA P-256 signature size */
 #define VTOR_TABLE_APP_START_ADDR 0x08040100UL    /**< Application vector table start */
 #define APP_START_ADDRESS         0x08040100UL    /**< Application start address in flash */
 #define APP_IMAGE_START_ADDRESS   0x08040000UL    /**< Application Image start address in flash */
+#define FW_HEADER_CRC_SPAN        offsetof(FirmwareHeader_TypeDef, headerCRC) /**< Header bytes covered by headerCRC */
+#define FW_VERIFY_CHUNK_SIZE      2048            /**< Payload bytes per hash/CRC step (one flash page) */
+#define FW_BLOCK_SIZE             2048            /**< v2: payload bytes covered by one block hash */
+#define FW_BLOCK_COUNT(size)      (((size) + FW_BLOCK_SIZE - 1U) / FW_BLOCK_SIZE)  /**< v2: block hashes for a payload */
+#define FW_BLOCK_TABLE_OFFSET(size) (((size) + 7U) & ~7U)  /**< v2: table offset from entryPoint (double-word aligned) */
+#define FW_DELTA_INFO_OFFSET      0x80            /**< Delta descriptor offset in the header padding */
+#define FW_DELTA_MAGIC            0xDE17A001UL    /**< Delta descriptor identifier */
+#define FW_COMP_INFO_OFFSET       0xB0            /**< Compression descriptor offset in the header padding */
+#define FW_COMP_MAGIC_LZSS        0xC0DE1255UL    /**< Compression descriptor identifier, LZSS (secboot_lz.h) */
+#define FW_ENC_INFO_OFFSET        0xC0            /**< Encryption descriptor offset in the header padding */
+#define FW_ENC_MAGIC              0xE4C0DE01UL    /**< Encryption descriptor identifier */
+#define FW_INSTALL_CHUNK_SIZE     2048            /**< Install: bytes decrypted per step (one flash page) */
+#define FW_INSTALL_SLICE_SIZE     256             /**< Install: bytes hashed between two flash writer polls */
+#define FW_INSTALL_MAX_BLOCKS     FW_BLOCK_COUNT(SECBOOT_UPDATE_SLOT_SIZE - SECBOOT_FW_HEADER_SIZE)  /**< Install: v2 block digests kept in RAM */
 /**
   * @}
   */
@@ -90,7 +112,9 @@ typedef enum {
     SECBOOT_BOOTMANAGER_VERSION_ROLLBACK,       /**< Attempt to install older firmware version */
     SECBOOT_BOOTMANAGER_SECURE_VIOLATION,       /**< TrustZone security violation */
     SECBOOT_BOOTMANAGER_HW_SECURE_FAULT,        /**< Hardware security fault detected */
-    SECBOOT_BOOTMANAGER_JUMP_FAILED             /**< Failed to jump to application */
+    SECBOOT_BOOTMANAGER_JUMP_FAILED,            /**< Failed to jump to application */
+    SECBOOT_BOOTMANAGER_DELTA_BASE_MISMATCH,    /**< Delta image built against another base image */
+    SECBOOT_BOOTMANAGER_NOT_VERIFIED            /**< Not checked: an image before it was chosen */
 } SECBOOT_BOOTMANAGER_StatusTypeDef;
 /**
   * @}
@@ -102,10 +126,17 @@ typedef enum {
 
 /**
   * @brief  Firmware header structure containing security metadata
+  * @note   Two image formats share this header:
+  *         - v1 (FW_MAGIC_NUMBER): firmwareHash is the SHA-256 of the payload
+  *         - v2 (FW_MAGIC_NUMBER_V2): the payload is followed by a table of
+  *           SHA-256 hashes, one per FW_BLOCK_SIZE block, and firmwareHash
+  *           is the SHA-256 of that table. The signature covers this root,
+  *           so any block can be checked on its own once the root is trusted.
+  *         v2 slot layout: header | payload (at entryPoint) | 0xFF pad to 8 | table
   */
 typedef struct __attribute__((packed)) {
     uint32_t magicNumber;       /**< Magic number to identify valid firmware (FW_MAGIC_NUMBER) */
-    uint32_t imageSize;         /**< Complete firmware image size including header */
+    uint32_t imageSize;         /**< Payload size in bytes, excluding the 256-byte header */
     uint8_t  version[FW_VERSION_SIZE];  /**< Firmware version (4 bytes) */
     uint32_t entryPoint;        /**< Application entry point address */
     uint8_t  firmwareHash[FW_HASH_SIZE];  /**< SHA-256 hash of firmware payload */
@@ -117,6 +148,63 @@ typedef struct __attribute__((packed)) {
     uint32_t AES_key[4];   
     uint32_t AES_iv[4];        
 } AES_Secrets_TypeDef;
+
+/**
+  * @brief  Encryption descriptor of an encrypted update image
+  * @note   Stored at FW_ENC_INFO_OFFSET in the header padding; the header
+  *         itself stays in clear text. Everything after the 256-byte header
+  *         (payload, v2 pad and block table) is encrypted as one stream.
+  *         CTR: iv is the counter block of byte 0 (96-bit nonce, 32-bit
+  *         counter 0), blocks can be decrypted in any order.
+  *         GCM: iv holds the 96-bit IV, the first sizeof(FirmwareHeader_TypeDef)
+  *         header bytes are the AAD and tag authenticates header and
+  *         ciphertext in the same pass as decryption.
+  */
+typedef struct __attribute__((packed)) {
+    uint32_t magic;                       /**< FW_ENC_MAGIC */
+    uint32_t mode;                        /**< SECBOOT_AES_ModeTypeDef */
+    uint8_t  iv[AES_CTR_IV_SIZE];         /**< CTR counter block, or GCM IV zero-extended */
+    uint8_t  tag[AES_GCM_TAG_SIZE];       /**< GCM tag, 0xFF for CTR */
+} FirmwareEncryption_TypeDef;
+
+/**
+  * @brief  Delta descriptor of a delta update image
+  * @note   Stored at FW_DELTA_INFO_OFFSET in the header padding. The header
+  *         is the signed header of the new image; instead of its stream the
+  *         update image carries patchSize bytes of ops (secboot_delta.h)
+  *         that rebuild the stream from the image identified by baseHash.
+  *         The patch is encrypted like a full stream (FirmwareEncryption_TypeDef),
+  *         and the rebuilt stream is hashed against firmwareHash as usual.
+  */
+typedef struct __attribute__((packed)) {
+    uint32_t magic;                       /**< FW_DELTA_MAGIC */
+    uint32_t patchSize;                   /**< Patch bytes after the header */
+    uint8_t  baseHash[FW_HASH_SIZE];      /**< firmwareHash of the base image */
+} FirmwareDelta_TypeDef;
+
+/**
+  * @brief  Compression descriptor of a compressed update image
+  * @note   Stored at FW_COMP_INFO_OFFSET in the header padding. The stream
+  *         (payload, v2 pad and block table) is compressed to
+  *         compressedSize bytes, then encrypted; the install decompresses it
+  *         on its way to flash and the signed digest covers the
+  *         decompressed stream. Installed images are never compressed:
+  *         they run in place.
+  */
+typedef struct __attribute__((packed)) {
+    uint32_t magic;                       /**< FW_COMP_MAGIC_LZSS */
+    uint32_t compressedSize;              /**< Compressed bytes after the header */
+} FirmwareCompression_TypeDef;
+
+/**
+  * @brief  Source of a streamed update image
+  *         (SECBOOT_BootManager_UpdateFirmwareStream)
+  * @param  ctx  Caller context
+  * @param  pData  Output buffer
+  * @param  length  Next bytes of the update image wanted, in order
+  * @retval false when the source is lost; the install is abandoned
+  */
+typedef bool (*SECBOOT_BootManager_FetchFn)(void *ctx, uint8_t *pData, uint32_t length);
 /**
   * @}
   */
@@ -155,20 +243,115 @@ SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_VerifyBootloaderCRC(void);
   * @brief  Verify the integrity and authenticity of the firmware image
   * @note   Performs cryptographic signature verification and hash check of the application.
   *         Uses hardware-accelerated cryptography where available.
+  *         The header is validated first, so a corrupted slot is rejected
+  *         without reading its payload. With SECBOOT_ENABLE_FAST_BOOT a
+  *         header sealed by a previous full verification skips the ECDSA
+  *         check, and a successful full verification seals the slot.
   * @retval SECBOOT_BOOTMANAGER_StatusTypeDef Verification status code
   */
 SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_VerifyAppSignature(uint32_t image_address);
 
+
+
+/**
+  * @brief  Verify images in boot order and pick the first valid one
+  * @param  pImages  Header addresses, most preferred first
+  * @param  count    Number of images
+  * @param  pStatus  Per image: the SECBOOT_BootManager_VerifyAppSignature
+  *                  status. Images after the chosen one read
+  *                  SECBOOT_BOOTMANAGER_NOT_VERIFIED, or the header or hash
+  *                  failure found while they were hashed ahead.
+  * @retval Index of the chosen image, count if none is valid
+  * @note   Same checks and seals as VerifyAppSignature on each image in
+  *         turn, pipelined over the engines: the PKA checks the signature
+  *         of one image from its interrupt while the core and the HASH
+  *         recompute the digest of the next one. When an image fails its
+  *         signature, the next one is already hashed and goes straight to
+  *         the PKA. A sealed first image returns before anything else is
+  *         read.
+  */
+uint32_t SECBOOT_BootManager_VerifyFirstValid(const uint32_t *pImages, uint32_t count,
+                                              SECBOOT_BOOTMANAGER_StatusTypeDef *pStatus);
+
+/**
+  * @brief  Reject a malformed image from its header alone
+  * @note   Reads only the header, in this order:
+  *         - magic number (v1 or v2)
+  *         - headerCRC over the fields that precede it
+  *         - imageSize (plus the v2 block table) bounded by the slot
+  *         - entryPoint right after the 256-byte header
+  *         Costs microseconds, so it runs before any payload read.
+  * @param  image_address Address of the firmware header in flash
+  * @retval SECBOOT_BOOTMANAGER_OK or SECBOOT_BOOTMANAGER_INVALID_HEADER
+  */
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_CheckHeader(uint32_t image_address);
+
+/**
+  * @brief  Stream an image payload through the HASH engine
+  * @note   The payload is read in FW_VERIFY_CHUNK_SIZE steps.
+  *         The header must have passed SECBOOT_BootManager_CheckHeader.
+  * @param  image_address Address of the firmware header in flash
+  * @param  pDigest       32-byte output for the payload SHA-256
+  * @retval SECBOOT_BOOTMANAGER_StatusTypeDef Hashing status
+  */
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_HashPayload(uint32_t image_address, uint8_t *pDigest);
+
+/**
+  * @brief  Authenticate the block table of a v2 image
+  * @note   Checks the header, hashes the table against firmwareHash and
+  *         verifies the ECDSA signature over it. No payload block is read:
+  *         an update can authenticate the table first and then check each
+  *         block with SECBOOT_BootManager_VerifyBlocks as it is written.
+  * @param  image_address Address of the firmware header in flash
+  * @retval SECBOOT_BOOTMANAGER_StatusTypeDef Verification status
+  */
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_VerifyBlockTable(uint32_t image_address);
+
+/**
+  * @brief  Check a range of v2 payload blocks against the block table
+  * @note   Trusts the table in flash: authenticate it first with
+  *         SECBOOT_BootManager_VerifyBlockTable (or a full verification).
+  *         Lets a caller re-check only the pages it rewrote, or resume an
+  *         interrupted verification at the first unchecked block.
+  * @param  image_address Address of the firmware header in flash
+  * @param  firstBlock    Index of the first block to check
+  * @param  blockCount    Number of blocks to check
+  * @param  pFailedBlock  Index of the first mismatching block, may be NULL
+  * @retval SECBOOT_BOOTMANAGER_OK, SECBOOT_BOOTMANAGER_INVALID_HASH on a
+  *         mismatch, SECBOOT_BOOTMANAGER_INVALID_HEADER for a bad range
+  */
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_VerifyBlocks(uint32_t image_address, uint32_t firstBlock, uint32_t blockCount, uint32_t *pFailedBlock);
+
 /**
   * @brief  Decrypt and flash the firmware image to target address
-  * @note   Uses AES-256 in CTR mode for firmware decryption during flashing.
-  *         Performs automatic flash erase and write operations.
-  * @param  srcAddr Source address of encrypted firmware
-  * @param  destAddr Destination address in flash memory
-  * @param  size Size of firmware image in bytes
-  * @param  key Pointer to AES-256 key (32 bytes)
-  * @param  iv Pointer to initialization vector (16 bytes)
-  * @retval SECBOOT_BOOTMANAGER_StatusTypeDef Flash operation status code
+  * @note   The source is an encrypted update image: clear header carrying a
+  *         FirmwareEncryption_TypeDef (AES-128 CTR or GCM) followed by the
+  *         encrypted payload, optionally LZSS compressed before encryption
+  *         (FirmwareCompression_TypeDef). Decryption, decompression,
+  *         hashing and flash programming are pipelined page by page: while
+  *         one page buffer is programmed (interrupt-completed double-word
+  *         writes, pages erased ahead of the write cursor) the next page is
+  *         decrypted (and decompressed) into the other one and hashed. The signed digest (payload hash, or v2 table root and
+  *         every block) and the GCM tag are checked on the plaintext on its
+  *         way to flash, so the destination is never read back.
+  *         The ECDSA signature over the header digest is checked before the
+  *         destination is touched. The first double-word of the header
+  *         (magic and size) is programmed last, once the digest and tag
+  *         match: an interrupted or rejected install leaves an erased magic
+  *         that CheckHeader refuses. The destination is then sealed.
+  *         On STM32L5 the flash is the bottleneck (a page erase plus 256
+  *         double-word programs per 2KB), so the install time approaches
+  *         the erase and program time of the image.
+  * @param  srcAddr Source address of encrypted firmware (header included)
+  * @param  destAddr Destination slot address; the header must target it
+  * @param  size Size of firmware image in bytes: header, payload and, for
+  *         v2, the padded block table
+  * @param  key Pointer to AES-128 update key (FW_UPDATE_KEY_SIZE bytes)
+  * @param  iv Pointer to initialization vector (16 bytes), or NULL to use
+  *         the one in the encryption descriptor
+  * @retval SECBOOT_BOOTMANAGER_StatusTypeDef Flash operation status code;
+  *         SECBOOT_BOOTMANAGER_INVALID_HEADER for a delta image, which
+  *         needs a base (SECBOOT_BootManager_UpdateFirmware)
   */
 SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_FlashFirmware(
     uint32_t srcAddr, 
@@ -188,13 +371,87 @@ SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_JumpTo(uint32_t image_addr
 
 /**
   * @brief  Perform secure firmware update
-  * @note   Complete firmware update procedure including verification, flashing,
-  *         and integrity checks. Handles both full and delta updates.
-  * @param  fwHeader Pointer to the new firmware header structure
-  * @param  fwData Pointer to the new firmware data
-  * @retval SECBOOT_BOOTMANAGER_StatusTypeDef Update process status code
+  * @note   A/B update: the image is installed with
+  *         SECBOOT_BootManager_FlashFirmware into the slot that is not
+  *         active, then promoted with one slot state record
+  *         (SECBOOT_Slots_Activate). The running image is never written and
+  *         becomes the fallback, so the update costs one slot write and a
+  *         power loss at any point boots either the old or the new image.
+  *         The image must be linked for the inactive slot (header
+  *         entryPoint = slot + 256), otherwise it is rejected with
+  *         SECBOOT_BOOTMANAGER_INVALID_HEADER before anything is written.
+  *         A delta image (FirmwareDelta_TypeDef) is applied against the
+  *         active image, read in place: the new stream is rebuilt page by
+  *         page into the inactive slot and verified on its way to flash
+  *         exactly like a full image. A delta built against any other
+  *         image is rejected with SECBOOT_BOOTMANAGER_DELTA_BASE_MISMATCH
+  *         before anything is written; send the full image instead.
+  * @param  srcAddr Encrypted update image, e.g. in the update slot
+  * @param  size Size of the update image in bytes
+  * @param  key Pointer to AES-128 update key (FW_UPDATE_KEY_SIZE bytes)
+  * @retval SECBOOT_BootManager_FlashFirmware status, or
+  *         SECBOOT_BOOTMANAGER_FLASH_ERROR if the promotion failed
+  */
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_UpdateFirmware(uint32_t srcAddr, uint32_t size, const uint8_t* key);
+
+/**
+  * @brief  Perform a secure firmware update from a stream
+  * @note   Same as SECBOOT_BootManager_UpdateFirmware, but the update image
+  *         is pulled in order from fetch as it arrives (e.g. over the UART)
+  *         instead of being staged in flash first. The header is fetched
+  *         first, and the header checks, the size against the header and
+  *         the ECDSA signature run before any payload is asked for, so a
+  *         wrong image is refused after its first 256 bytes. The payload is
+  *         then decrypted, hashed and programmed as it is fetched: the
+  *         image is verified, committed and promoted as soon as its last
+  *         byte arrives, with no pass over a staged copy.
+  * @note   The only ingestion path is USART1: SECBOOT_Transfer_Install,
+  *         run from the boot-time listen window (SECBOOT_Transfer_Listen).
+  *         There is no NSC gateway that submits update chunks from the
+  *         non-secure application; that path is out of scope.
+  * @param  size Size of the update image in bytes
+  * @param  key Pointer to AES-128 update key (FW_UPDATE_KEY_SIZE bytes)
+  * @param  fetch Source of the update image
+  * @param  ctx Context for fetch
+  * @retval SECBOOT_BootManager_UpdateFirmware status;
+  *         SECBOOT_BOOTMANAGER_ERROR when fetch gave up
+  */
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_UpdateFirmwareStream(uint32_t size, const uint8_t* key,
+                                                                           SECBOOT_BootManager_FetchFn fetch, void *ctx);
+
+/**
+  * @brief  Install the update image staged in the update slot, if any
+  * @note   Boot-time trigger of SECBOOT_BootManager_UpdateFirmware. Does
+  *         nothing when SECBOOT_UPDATE_SLOT_ADDR holds no v1/v2 header.
+  *         Only an image whose version is newer than the active image's is
+  *         installed, so a stale staged image cannot undo a UART update or
+  *         bring back a reverted one. The image size follows from the
+  *         header and its delta or compression descriptor. Once installed
+  *         and promoted, or refused, the image is retired by erasing the
+  *         first update slot page; a power loss during the install leaves
+  *         it staged, and the next boot installs it again.
+  * @param  key Pointer to AES-128 update key (FW_UPDATE_KEY_SIZE bytes), e.g.
+  *         SECBOOT_BootManager_GetUpdateKey
+  * @retval SECBOOT_BOOTMANAGER_OK when there was nothing to install or the
+  *         update was installed and promoted,
+  *         SECBOOT_BOOTMANAGER_VERSION_ROLLBACK for an image not newer than
+  *         the active one, the SECBOOT_BootManager_UpdateFirmware status
+  *         otherwise
+  */
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_UpdateStaged(const uint8_t* key);
+
+/**
+  * @brief  Provisioned AES-128 update key
+  * @note   The security block holds no key of its own for update images:
+  *         the update key is AES_KEY1, unwrapped from AES_KEY_OFFSET with
+  *         the device key, in the byte order the provisioning scripts print
+  *         it. It is the same on every device of a batch, as the update
+  *         images are. AES_IV is not part of it: it is stored in clear text.
+  * @param  key Output, FW_UPDATE_KEY_SIZE bytes; wipe it after use
+  * @retval SECBOOT_BOOTMANAGER_OK, or SECBOOT_BOOTMANAGER_DECRYPTION_ERROR
+  *         when the security block does not unwrap on this device
   */
-SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_UpdateFirmware(FirmwareHeader_TypeDef* fwHeader, uint8_t* fwData);
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_GetUpdateKey(uint8_t* key);
 
 /**
   * @brief  Check for firmware rollback protection
@@ -16,7 +16,6 @@ extern "C" {
 
 /* Memory Layout ----------------------------------------------------------*/
 #define SECBOOT_BOOTLOADER_ADDR        0x0C000000UL  /* Secure bootloader area */
-#define SECBOOT_DIAG_LOG_BASE          0x0C00A000UL  /* Last 2KB sector */
 
 #define SECBOOT_MAIN_APP_IMAGE_ADDR    0x08040000UL  // Start address of the main application image
 #define SECBOOT_MAIN_APP_IMAGE_SIZE    (50 * 1024)   // Size of the main application image (50KB)
@@ -34,10 +33,6 @@ extern "C" {
 #define SECBOOT_BACKUP_IMAGE_SIZE      (50 * 1024)   // Size of backup image (50KB)
 
 
-
-#define SECBOOT_DIAG_LOG_SIZE          64    /* Bytes per log entry */
-#define SECBOOT_DIAG_MAX_LOGS          16    /* Circular buffer size */
-
 /* Bootloader Layout ----------------------------------------------------------*/
 #define BOOTLOADER_START_ADDR          0x0C000000UL   /**< Secure bootloader start address in flash */
 #define BOOTLOADER_SIZE                32*1024        /**< Bootloader size in bytes (32KB) */
@@ -65,10 +60,80 @@ extern "C" {
 #define ECC_PUBKEY_SIZE           64              /**< ECC P-256 public key size in bytes */
 #define BOOTLOADER_CRC_OFFSET     (BOOTLOADER_START_ADDR+0x8070)  /**< Bootloader CRC offset */
 
+/* Signature Engine -----------------------------------------------------*/
+#define SECBOOT_ECDSA_ENGINE_PKA       0             /* PKA, software verifier on PKA faults */
+#define SECBOOT_ECDSA_ENGINE_SOFT      1             /* Software verifier only (secboot_p256.c) */
+
+#ifndef SECBOOT_ECDSA_ENGINE
+  #if defined(__linux__)
+    #define SECBOOT_ECDSA_ENGINE       SECBOOT_ECDSA_ENGINE_SOFT  /* Host builds have no PKA */
+  #else
+    #define SECBOOT_ECDSA_ENGINE       SECBOOT_ECDSA_ENGINE_PKA
+  #endif
+#endif
+#ifndef SECBOOT_ECDSA_SOFT_FALLBACK
+  #define SECBOOT_ECDSA_SOFT_FALLBACK  1             /* 0 = a PKA fault fails the verification */
+#endif
+#ifndef SECBOOT_ECDSA_BENCHMARK
+  #define SECBOOT_ECDSA_BENCHMARK      0             /* Build SECBOOT_ECDSA_Benchmark */
+#endif
+
+/* CRC Engine -----------------------------------------------------------*/
+#define SECBOOT_CRC_ENGINE_HW          0             /* CRC unit, word input, DMA-fed for long buffers */
+#define SECBOOT_CRC_ENGINE_SOFT        1             /* Slicing-by-8 software CRC only (secboot_crc32.c) */
+
+#ifndef SECBOOT_CRC_ENGINE
+  #if defined(__linux__)
+    #define SECBOOT_CRC_ENGINE         SECBOOT_CRC_ENGINE_SOFT  /* Host builds have no CRC unit */
+  #else
+    #define SECBOOT_CRC_ENGINE         SECBOOT_CRC_ENGINE_HW
+  #endif
+#endif
+#ifndef SECBOOT_CRC_DMA_MIN_SIZE
+  #define SECBOOT_CRC_DMA_MIN_SIZE     1024          /* Shorter buffers are fed by the core */
+#endif
+
 /* Boot Policy ----------------------------------------------------------*/
 #define SECBOOT_BOOT_DELAY_MS          100           /* Anti-glitch delay */
 #define SECBOOT_MIN_FW_VERSION         0x00010000    /* v1.0.0.0 */
 
+/* Fast Boot Seal -------------------------------------------------------*/
+#define SECBOOT_SEAL_BASE              0x0C00A800UL  /* Second page after the SECRETS region */
+#define SECBOOT_SEAL_PAGE_SIZE         2048          /* One flash page of seal records */
+
+#ifndef SECBOOT_ENABLE_FAST_BOOT
+  #define SECBOOT_ENABLE_FAST_BOOT     1             /* Skip ECDSA for sealed images */
+#endif
+#ifndef SECBOOT_SEAL_REHASH_PAYLOAD
+  #define SECBOOT_SEAL_REHASH_PAYLOAD  1             /* 0 = trust WRP, skip the payload hash too */
+#endif
+
+/* A/B Slots ------------------------------------------------------------*/
+#define SECBOOT_SLOT_A_ADDR            SECBOOT_MAIN_APP_IMAGE_ADDR  /* Boots by default */
+#define SECBOOT_SLOT_B_ADDR            SECBOOT_SLOT1_ADDR           /* Other half of the A/B pair */
+#define SECBOOT_SLOTS_BASE             0x0C00B000UL  /* Page after the SEAL region */
+#define SECBOOT_SLOTS_PAGE_SIZE        2048          /* Two pages, written alternately */
+
+/* Diagnostic Log -------------------------------------------------------*/
+#define SECBOOT_DIAG_LOG_BASE          0x0C00C000UL  /* Page after the SLOTS region */
+#define SECBOOT_DIAG_LOG_PAGE_SIZE     2048          /* One flash page of log entries */
+#define SECBOOT_DIAG_LOG_PAGES         4             /* Ring of pages, one kept erased */
+#define SECBOOT_DIAG_STAGE_SIZE        16            /* Distinct events staged in RAM per flush */
+
+/* UART Transfer --------------------------------------------------------*/
+#define SECBOOT_TRANSFER_MIN_BAUD      9600UL        /* Slowest baud a HELLO may select */
+#define SECBOOT_TRANSFER_MAX_BAUD      460800UL      /* Fastest: 0.8% error from HSI16 at 16x */
+#define SECBOOT_TRANSFER_IDLE_TIMEOUT_MS   20000U    /* Give up without a valid frame */
+#define SECBOOT_TRANSFER_BAUD_FALLBACK_MS  1000U     /* Silent at a negotiated baud: back to the entry baud */
+#ifndef SECBOOT_TRANSFER_LISTEN_MS
+  #define SECBOOT_TRANSFER_LISTEN_MS   0U            /* Boot: wait this long for a HELLO; 0 = no UART updates (opt-in, 50 typ.) */
+#endif
+
+/* Non-Secure Services --------------------------------------------------*/
+#define SECBOOT_NSC_SHARED_BASE        0x20030000UL  /* SRAM2, non-secure: buffers of NSC requests */
+#define SECBOOT_NSC_SHARED_SIZE        (64 * 1024)
+#define SECBOOT_NSCRYPTO_MAX_QUEUE     16            /* Crypto requests per gateway call */
+
 /* Debug Controls -------------------------------------------------------*/
 #ifdef SECBOOT_DEBUG
   #define SECBOOT_ALLOW_DEBUG          1             /* Enable debug in dev */
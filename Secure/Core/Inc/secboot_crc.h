@@ -4,7 +4,13 @@
   * @author  Soulaimane Oulad Belayachi
   * @date    2025-06-12
   * @version 1.0
-  * @note    Uses STM32 hardware CRC peripheral for fast integrity checking
+  * @note    Uses STM32 hardware CRC peripheral for fast integrity checking.
+  *          The unit takes 32-bit words: the core byte-swaps the data into
+  *          a stage buffer, so the result is the byte-stream CRC of the
+  *          scripts, and buffers of SECBOOT_CRC_DMA_MIN_SIZE bytes or more
+  *          are pushed to the unit by memory-to-memory DMA while the next
+  *          block is swapped. SECBOOT_CRC_ENGINE_SOFT builds use the
+  *          bit-exact software CRC of secboot_crc32.c instead.
   * @warning Not cryptographically secure - use with other verification methods
   */
 
@@ -17,6 +23,8 @@
 
 #define SECBOOT_CRC32_INIT_VALUE  0xFFFFFFFFUL  ///< Standard CRC32 initialization value
 #define SECBOOT_CRC_POLYNOMIAL    0x04C11DB7UL  ///< Ethernet/PNG standard polynomial
+#define SECBOOT_CRC_DMA_CHANNEL   DMA1_Channel1 ///< Memory-to-memory feed of the CRC unit
+#define SECBOOT_CRC_DMA_TIMEOUT_MS 10U          ///< One stage block
 
 /** @brief CRC status codes */
 typedef enum {
@@ -41,8 +49,7 @@ SECBOOT_CRC_StatusTypeDef SECBOOT_CRC_Init(void);
   * @param  dataLength  Length of data in bytes
   * @param  pCrcResult  Pointer to store computed CRC32
   * @retval SECBOOT_CRC_StatusTypeDef
-  * @note   Uses STM32 hardware CRC accelerator
-  * @warning Data must be word-aligned for optimal performance
+  * @note   Uses STM32 hardware CRC accelerator; any alignment
   */
 SECBOOT_CRC_StatusTypeDef SECBOOT_CRC_Calculate(uint8_t *pData, uint32_t dataLength, uint32_t *pCrcResult);
 
@@ -66,7 +73,9 @@ SECBOOT_CRC_StatusTypeDef SECBOOT_CRC_Verify(
   * @param  dataLength  Length of current chunk
   * @param  currentCrc  Current CRC value (updated in-place)
   * @retval SECBOOT_CRC_StatusTypeDef
-  * @note   Initialize *currentCrc with SECBOOT_CRC32_INIT_VALUE
+  * @note   Initialize *currentCrc with SECBOOT_CRC32_INIT_VALUE. The unit
+  *         restarts from *currentCrc, so other CRC calculations may run
+  *         between the chunks of a stream.
   */
 SECBOOT_CRC_StatusTypeDef SECBOOT_CRC_Calculate_Chunk(
     const uint8_t *pData, 
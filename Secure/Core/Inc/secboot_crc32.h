@@ -0,0 +1,43 @@
+/**
+  * @file    secboot_crc32.h
+  * @brief   Software CRC-32 of the STM32 CRC unit convention
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    Portable C, no HAL: SECBOOT_CRC_ENGINE_SOFT builds of
+  *          secboot_crc.c use it instead of the CRC unit, and the host
+  *          tools link it directly. Bit-exact with SECBOOT_CRC_Calculate
+  *          and compute_crc32 of the scripts: polynomial 0x04C11DB7, MSB
+  *          first, initial value 0xFFFFFFFF, no reflection, no final XOR
+  *          (CRC-32/MPEG-2; "123456789" gives 0x0376E6E7).
+  *          Slicing-by-8: eight input bytes per step through eight
+  *          256-entry tables (8 KB, from Script/stm32_crc_table.py).
+  */
+
+#ifndef __SECBOOT_CRC32_H
+#define __SECBOOT_CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SECBOOT_CRC32_SLICES  8U   ///< Bytes folded per table step
+
+/**
+  * @brief  CRC-32 of a buffer, from the initial value 0xFFFFFFFF
+  * @param  pData   Data, any alignment
+  * @param  length  Bytes
+  * @retval CRC of the unit after feeding the bytes in order
+  */
+uint32_t SECBOOT_CRC32_Calculate(const void *pData, size_t length);
+
+/**
+  * @brief  Continue a CRC-32 over the next bytes of a stream
+  * @param  crc     Result of the previous Calculate or Accumulate
+  * @param  pData   Data, any alignment
+  * @param  length  Bytes
+  * @retval CRC of everything fed so far
+  * @note   Split points do not matter: Accumulate(Calculate(a), b) equals
+  *         Calculate(a || b).
+  */
+uint32_t SECBOOT_CRC32_Accumulate(uint32_t crc, const void *pData, size_t length);
+
+#endif /* __SECBOOT_CRC32_H */
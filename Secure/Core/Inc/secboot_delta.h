@@ -0,0 +1,116 @@
+/**
+  * @file    secboot_delta.h
+  * @brief   Streaming decoder for delta (differential) update images
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    A patch rebuilds the stream of a new image (payload, v2 pad and
+  *          block table) from the stream of the image already installed
+  *          (the base) and a sequence of ops. Output is produced on demand,
+  *          any number of bytes at a time, so the install pipeline pulls one
+  *          flash page at a time; the decoder holds no more than
+  *          SECBOOT_DELTA_INPUT_SIZE patch bytes in RAM.
+  *
+  *          Op encoding: one tag byte, op in bits 7..5, length code in bits
+  *          4..0. Codes 0..27 mean a length of 1..28; codes 28..31 mean the
+  *          length follows as a 1..4 byte little-endian value (not 0).
+  *          - COPY n:    n bytes of the base at the base cursor; cursor += n
+  *          - INSERT n:  n literal bytes follow; the cursor stays
+  *          - REPLACE n: n literal bytes follow; cursor += n
+  *          - RELOC n:   n 32-bit base words at the cursor, each plus the
+  *                       relocation delta (new minus base entryPoint);
+  *                       cursor += 4n
+  *          - SEEK_FWD n / SEEK_BACK n: move the cursor, no output
+  *          A/B images are linked for their slot, so a new build differs
+  *          from the running one in every absolute address; RELOC keeps
+  *          those runs out of the literal data.
+  *          Every base access is bounds checked. The output itself is not
+  *          trusted here: the caller hashes it against the signed header.
+  */
+
+#ifndef __SECBOOT_DELTA_H
+#define __SECBOOT_DELTA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SECBOOT_DELTA_INPUT_SIZE   256U   ///< Patch bytes buffered (multiple of the AES block)
+
+#define SECBOOT_DELTA_OP_COPY       0U
+#define SECBOOT_DELTA_OP_INSERT     1U
+#define SECBOOT_DELTA_OP_REPLACE    2U
+#define SECBOOT_DELTA_OP_RELOC      3U
+#define SECBOOT_DELTA_OP_SEEK_FWD   4U
+#define SECBOOT_DELTA_OP_SEEK_BACK  5U
+#define SECBOOT_DELTA_OP_SHIFT      5U    ///< Op position in the tag byte
+#define SECBOOT_DELTA_LENGTH_MASK   0x1FU ///< Length code bits of the tag byte
+#define SECBOOT_DELTA_LENGTH_INLINE 28U   ///< Codes below this are length - 1
+
+/** @brief Delta decoder status codes */
+typedef enum {
+    SECBOOT_DELTA_OK = 0,           ///< Operation successful
+    SECBOOT_DELTA_INVALID_PARAM,    ///< NULL pointer or zero length
+    SECBOOT_DELTA_CORRUPT,          ///< Bad op, base access out of bounds, or patch too short/long
+    SECBOOT_DELTA_READ_ERROR        ///< The patch source failed
+} SECBOOT_Delta_StatusTypeDef;
+
+/**
+  * @brief  Patch source: provide exactly length further patch bytes
+  * @param  source  Caller context given to SECBOOT_Delta_Init
+  * @param  pData   Output buffer
+  * @param  length  Bytes wanted; SECBOOT_DELTA_INPUT_SIZE except at the end
+  * @retval SECBOOT_DELTA_OK or SECBOOT_DELTA_READ_ERROR
+  */
+typedef SECBOOT_Delta_StatusTypeDef (*SECBOOT_Delta_ReadFn)(void *source, uint8_t *pData, uint32_t length);
+
+/**
+  * @brief Delta decoder context
+  */
+typedef struct {
+    uint8_t  input[SECBOOT_DELTA_INPUT_SIZE];  ///< Patch bytes (first: word aligned)
+    const uint8_t *base;            ///< First byte of the base stream
+    uint32_t baseSize;              ///< Bytes in the base stream
+    uint32_t basePos;               ///< Base cursor
+    uint32_t relocDelta;            ///< Added to every RELOC word
+    SECBOOT_Delta_ReadFn read;      ///< Patch source
+    void    *source;                ///< Patch source context
+    uint32_t patchRemaining;        ///< Patch bytes not yet read from the source
+    uint32_t inputPos;              ///< Next unused byte of input
+    uint32_t inputLen;              ///< Valid bytes of input
+    uint32_t op;                    ///< Op being expanded
+    uint32_t opRemaining;           ///< Output bytes left in it, 0 between ops
+    uint8_t  word[sizeof(uint32_t)];///< RELOC: current relocated word
+} SECBOOT_Delta_Context;
+
+/**
+  * @brief  Start decoding a patch
+  * @param  ctx         Decoder context
+  * @param  base        Base stream: the bytes after the base image header
+  * @param  baseSize    Bytes in the base stream
+  * @param  relocDelta  New entryPoint minus base entryPoint
+  * @param  read        Patch source
+  * @param  source      Context for read
+  * @param  patchSize   Bytes of patch read returns in total
+  * @retval SECBOOT_Delta_StatusTypeDef
+  */
+SECBOOT_Delta_StatusTypeDef SECBOOT_Delta_Init(SECBOOT_Delta_Context *ctx, const uint8_t *base, uint32_t baseSize,
+                                               uint32_t relocDelta, SECBOOT_Delta_ReadFn read, void *source,
+                                               uint32_t patchSize);
+
+/**
+  * @brief  Produce the next bytes of the new stream
+  * @param  ctx     Decoder context
+  * @param  pOut    Output buffer
+  * @param  length  Bytes to produce; ops may span calls
+  * @retval SECBOOT_DELTA_CORRUPT if the patch ends early or is malformed
+  */
+SECBOOT_Delta_StatusTypeDef SECBOOT_Delta_Output(SECBOOT_Delta_Context *ctx, uint8_t *pOut, uint32_t length);
+
+/**
+  * @brief  Check that the whole patch was used, then wipe the context
+  * @param  ctx  Decoder context
+  * @retval SECBOOT_DELTA_CORRUPT if ops or patch bytes are left over
+  * @note   Trailing SEEK ops are accepted
+  */
+SECBOOT_Delta_StatusTypeDef SECBOOT_Delta_Finish(SECBOOT_Delta_Context *ctx);
+
+#endif /* __SECBOOT_DELTA_H */
@@ -32,8 +32,9 @@ typedef enum {
 } SECBOOT_Diag_TypeDef;
 
 /* Constants ------------------------------------------------------------*/
-#define SECBOOT_DIAG_LOG_SIZE      64    /* Bytes per log entry */
-#define SECBOOT_DIAG_MAX_LOGS      16    /* Circular buffer size */
+#define SECBOOT_DIAG_LOG_SIZE      32    /* Bytes per log entry (4 flash double-words) */
+#define SECBOOT_DIAG_PAGE_ENTRIES  (SECBOOT_DIAG_LOG_PAGE_SIZE / SECBOOT_DIAG_LOG_SIZE)
+#define SECBOOT_DIAG_MAX_LOGS      ((SECBOOT_DIAG_LOG_PAGES - 1) * SECBOOT_DIAG_PAGE_ENTRIES)  /* Kept history */
 
 /* Event Types ---------------------------------------------------------*/
 typedef enum {
@@ -57,7 +58,9 @@ typedef enum {
     SIG_FAIL_BACKUP_IMAGE    = 0x21,  // Backup FW signature invalid
     SIG_FAIL_CONFIG_SIGNATURE= 0x22,  // Config data signature fail
     SIG_FAIL_KEY_EXPIRED     = 0x23,  // Cryptographic key expiry
-    SIG_FAIL_HW_CRYPTO_ERROR = 0x24   // PKA/CRC hardware fault
+    SIG_FAIL_HW_CRYPTO_ERROR = 0x24,  // PKA/CRC hardware fault
+    SIG_FAIL_HW_FALLBACK     = 0x25,  // PKA fault, signature checked in software
+    SIG_FAIL_PUBKEY_INVALID  = 0x26   // Provisioned public key not on the curve
 } Signature_FailureCodes;
 
 typedef enum {
@@ -86,26 +89,58 @@ typedef enum {
 } SECBOOT_Diag_ResponseLevel;
 
 /* Log Entry Structure ------------------------------------------------*/
+/**
+  * @note   Entries are programmed in order into a ring of
+  *         SECBOOT_DIAG_LOG_PAGES flash pages, so the newest one is found
+  *         at startup from the first entry of each page and a binary
+  *         search for the first erased entry of the newest page. The page
+  *         after the newest is kept erased (spare): a full page moves on
+  *         to it and only then erases the oldest page, so a power cut never
+  *         costs the entries being written.
+  */
 typedef struct {
-    uint32_t timestamp;
-    SECBOOT_Diag_EventType event;
-    uint8_t error_code;
+    uint32_t sequence;        ///< Entry number, increasing across the whole ring
+    uint32_t boot;            ///< Number of the logging boot (boots without events are not counted)
+    uint32_t timestamp;       ///< HAL_GetTick() at the first occurrence
+    uint32_t last_timestamp;  ///< HAL_GetTick() at the last occurrence
+    uint8_t  event;           ///< SECBOOT_Diag_EventType
+    uint8_t  error_code;
+    uint16_t count;           ///< Identical events coalesced into this entry
     uint32_t context_data;
-    uint32_t crc;
+    uint32_t reserved;        ///< 0xFFFFFFFF
+    uint32_t crc;             ///< CRC over all fields above
 } SECBOOT_Diag_LogEntry;
 
 
 /* Function Prototypes ------------------------------------------------*/
 
+/**
+  * @brief  Find the head of the log ring
+  * @retval SECBOOT_Diag_TypeDef Status
+  * @note   Needs SECBOOT_CRC_Init. Done by the first flush if not called.
+  */
+SECBOOT_Diag_TypeDef SECBOOT_Diag_Init(void);
+
 /**
   * @brief  Log a security event
   * @param  event Event type
   * @param  code Error code
   * @param  data Context data
   * @retval SECBOOT_Diag_TypeDef Status
+  * @note   The event is staged in secure RAM; an event identical to one
+  *         already staged only counts up. Nothing reaches flash before
+  *         SECBOOT_Diag_Flush, unless the stage is full.
   */
 SECBOOT_Diag_TypeDef SECBOOT_Diag_LogEvent(SECBOOT_Diag_EventType event,uint8_t code,uint32_t data);
 
+/**
+  * @brief  Program the staged events in one batch
+  * @retval SECBOOT_Diag_TypeDef Status
+  * @note   Called by SECBOOT_BootManager_JumpTo and before a lockdown;
+  *         returns at once when nothing is staged.
+  */
+SECBOOT_Diag_TypeDef SECBOOT_Diag_Flush(void);
+
 /**
   * @brief  Handle CRC verification failure
   * @param  status CRC error status
@@ -120,6 +155,12 @@ SECBOOT_Diag_ResponseLevel SECBOOT_Diag_HandleCrcFail(SECBOOT_CRC_StatusTypeDef
   */
 SECBOOT_Diag_ResponseLevel SECBOOT_Diag_HandleSigFail(SECBOOT_ECDSA_StatusTypeDef status);
 
+/**
+  * @brief  Basic system lockdown
+  * @note   Flushes the staged events, then halts; never returns
+  */
+void system_lockdown(void);
+
 
 
 #ifdef __cplusplus
@@ -23,6 +23,7 @@
 
 #define SECBOOT_ECDSA_SHA256_DIGEST_SIZE 32  ///< Required digest size for P-256
 #define SECBOOT_ECDSA_PKA_TIMEOUT_MS 1000    ///< PKA operation timeout in ms
+#define SECBOOT_ECDSA_IRQ_PRIORITY   6U      ///< PKA_IRQn preemption priority (background verify)
 
 #define SECBOOT_ORIGIN_ADDR        0x0C000000      ///< Secure boot base address
 #define SECBOOT_PUBKEY_QX_ADDR     (SECBOOT_ORIGIN_ADDR + 0xA000)  ///< Default public key X address
@@ -71,6 +72,16 @@ typedef struct {
   uint8_t S[ECC_SIGNATURE_S_SIZE];  ///< Signature S component (big-endian)
 } SECBOOT_ECC_Signature;
 
+/**
+  * @brief  Result of SECBOOT_ECDSA_Benchmark
+  */
+typedef struct {
+  uint32_t pkaCycles;                        ///< Core cycles of one PKA verification
+  uint32_t softCycles;                       ///< Core cycles of one software verification
+  SECBOOT_ECDSA_StatusTypeDef pkaStatus;     ///< SECBOOT_ECDSA_VERIFICATION_SUCCESS expected
+  SECBOOT_ECDSA_StatusTypeDef softStatus;    ///< SECBOOT_ECDSA_VERIFICATION_SUCCESS expected
+} SECBOOT_ECDSA_BenchmarkTypeDef;
+
 /* --- Function Prototypes --- */
 
 /**
@@ -88,6 +99,19 @@ SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_Init(void);
   */
 SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_DeInit(void);
 
+/**
+  * @brief  Point-check the trusted public key once and prepare its verifications
+  * @param  pPubKey  Provisioned public key (ECC_PUBKEY_OFFSET)
+  * @retval SECBOOT_ECDSA_OK if the key is on the curve,
+  *         SECBOOT_ECDSA_INVALID_PUBKEY if it is not
+  * @note   Needs SECBOOT_ECDSA_Init. The key is copied to the verifier
+  *         context together with the curve and key operands of the PKA,
+  *         so each verification against it (main, backup, update) only
+  *         loads digest and signature. After a failed check they return
+  *         SECBOOT_ECDSA_INVALID_PUBKEY. Other keys are verified as before.
+  */
+SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_Provision(const SECBOOT_ECC_PublicKey *pPubKey);
+
 /**
   * @brief  Verify ECDSA signature of a firmware digest
   * @param  pDigest      Pointer to SHA-256 hash (32 bytes)
@@ -103,4 +127,48 @@ SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_Verify_Signature(
     SECBOOT_ECC_Signature* pSignature,
     SECBOOT_ECC_PublicKey* pPubKey);
 
+/**
+  * @brief  Start verifying a signature in the background
+  * @param  pDigest      SHA-256 hash (32 bytes)
+  * @param  pSignature   ECDSA signature to verify
+  * @param  pPubKey      Trusted public key
+  * @retval SECBOOT_ECDSA_OK once the verification is under way
+  * @note   The PKA completes from PKA_IRQHandler (SECBOOT_ECDSA_IRQHandler)
+  *         while the core does other work; SECBOOT_ECDSA_Verify_Finish
+  *         collects the verdict. The buffers must stay valid until then: a
+  *         PKA fault is retried in software there, as in
+  *         SECBOOT_ECDSA_Verify_Signature. Software engine builds verify
+  *         here and Finish only reports.
+  * @warning One verification at a time; SECBOOT_ECDSA_Verify_Signature
+  *          returns SECBOOT_ECDSA_INVALID_STATE while one is open
+  */
+SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_Verify_Start(uint8_t *pDigest, SECBOOT_ECC_Signature *pSignature,
+                                                       SECBOOT_ECC_PublicKey *pPubKey);
+
+/**
+  * @brief  Whether the background verification is still running
+  */
+bool SECBOOT_ECDSA_Verify_Busy(void);
+
+/**
+  * @brief  Wait (WFI) for the background verification and close it
+  * @retval Verdict as from SECBOOT_ECDSA_Verify_Signature,
+  *         SECBOOT_ECDSA_INVALID_STATE if none was started
+  */
+SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_Verify_Finish(void);
+
+/**
+  * @brief  PKA interrupt service, called from PKA_IRQHandler
+  */
+void SECBOOT_ECDSA_IRQHandler(void);
+
+/**
+  * @brief  Verify a built-in signature once with each engine and time them
+  * @param  pResult  Cycles and verdict of the PKA and the software engine
+  * @retval SECBOOT_ECDSA_OK when both engines accept the signature
+  * @note   Built with SECBOOT_ECDSA_BENCHMARK; needs SECBOOT_ECDSA_Init.
+  *         Tools/build/secboot_p256_bench gives the host figure.
+  */
+SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_Benchmark(SECBOOT_ECDSA_BenchmarkTypeDef *pResult);
+
 #endif /* SECBOOT_ECDSA_H */
\ No newline at end of file
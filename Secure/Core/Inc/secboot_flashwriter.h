@@ -0,0 +1,102 @@
+/**
+  * @file    secboot_flashwriter.h
+  * @brief   Interrupt-completed flash writer for STM32L5 image installs
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    Programs a page-aligned flash region from a short queue of RAM
+  *          buffers while the caller produces the next buffer. Each page
+  *          erase and double-word program is started with the HAL _IT
+  *          functions and completed by FLASH_IRQHandler; the core sleeps
+  *          (WFI) only when it has nothing else to do.
+  *          The HAL keeps the flash lock until its IRQ handler has run the
+  *          callbacks, so operations are always started from thread mode:
+  *          the caller must call SECBOOT_FlashWriter_Poll between short
+  *          units of work (a few hundred cycles each) to keep the flash
+  *          controller busy.
+  *          Pages are erased ahead of the write cursor whenever no queued
+  *          data can be programmed, and every page of the region is erased
+  *          by SECBOOT_FlashWriter_Close even if no data was written to it.
+  *          Double-words that are all 0xFF are left erased rather than
+  *          programmed: padding costs no program time, and the caller may
+  *          program such a double-word later (e.g. a commit marker).
+  * @warning The STM32L5 cannot read a bank while it programs or erases it:
+  *          call SECBOOT_FlashWriter_Settle before reading flash in the
+  *          bank being written, or the bus stalls for the whole operation.
+  */
+
+#ifndef __SECBOOT_FLASHWRITER_H
+#define __SECBOOT_FLASHWRITER_H
+
+#include "stm32l5xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SECBOOT_FLASHWRITER_QUEUE_DEPTH   2U    ///< Buffers in flight (double buffering)
+#define SECBOOT_FLASHWRITER_IRQ_PRIORITY  0U    ///< FLASH_IRQn preemption priority
+
+/** @brief Flash writer status codes */
+typedef enum {
+    SECBOOT_FLASHWRITER_OK = 0,          ///< Operation successful
+    SECBOOT_FLASHWRITER_INVALID_PARAM,   ///< Bad address, length or alignment
+    SECBOOT_FLASHWRITER_BUSY,            ///< Writer already open, or queue full
+    SECBOOT_FLASHWRITER_FLASH_ERROR      ///< Erase or programming failed
+} SECBOOT_FlashWriter_StatusTypeDef;
+
+/**
+  * @brief  Open the writer on a flash region
+  * @param  address  First byte of the region, page aligned
+  * @param  length   Region size in bytes; rounded up to whole pages
+  * @retval SECBOOT_FlashWriter_StatusTypeDef
+  * @note   Unlocks the flash, enables FLASH_IRQn and starts erasing the
+  *         first page. The region must lie in one bank.
+  */
+SECBOOT_FlashWriter_StatusTypeDef SECBOOT_FlashWriter_Open(uint32_t address, uint32_t length);
+
+/**
+  * @brief  Append a buffer to the data programmed at the write cursor
+  * @param  data    Buffer to program; must stay unchanged until
+  *                 SECBOOT_FlashWriter_WaitSlot returns for it
+  * @param  length  Bytes to program, multiple of 8 (pad the tail with 0xFF)
+  * @retval SECBOOT_FLASHWRITER_BUSY when SECBOOT_FLASHWRITER_QUEUE_DEPTH
+  *         buffers are already queued
+  */
+SECBOOT_FlashWriter_StatusTypeDef SECBOOT_FlashWriter_Queue(const uint8_t *data, uint32_t length);
+
+/**
+  * @brief  Start the next erase or program if the flash controller is idle
+  * @retval SECBOOT_FLASHWRITER_FLASH_ERROR once an operation has failed
+  * @note   Cheap when the controller is busy; call it often
+  */
+SECBOOT_FlashWriter_StatusTypeDef SECBOOT_FlashWriter_Poll(void);
+
+/**
+  * @brief  Wait until a queue entry is free, i.e. the oldest buffer is
+  *         fully programmed and may be reused
+  * @retval SECBOOT_FlashWriter_StatusTypeDef
+  */
+SECBOOT_FlashWriter_StatusTypeDef SECBOOT_FlashWriter_WaitSlot(void);
+
+/**
+  * @brief  Wait for the operation in progress without starting another
+  * @retval SECBOOT_FlashWriter_StatusTypeDef
+  * @note   After it returns, the bank can be read at full speed until the
+  *         next SECBOOT_FlashWriter_Poll
+  */
+SECBOOT_FlashWriter_StatusTypeDef SECBOOT_FlashWriter_Settle(void);
+
+/**
+  * @brief  Program all queued data, erase the rest of the region and
+  *         release the flash
+  * @retval SECBOOT_FlashWriter_StatusTypeDef
+  */
+SECBOOT_FlashWriter_StatusTypeDef SECBOOT_FlashWriter_Close(void);
+
+/**
+  * @brief  Drop queued data and release the flash after the operation in
+  *         progress completes
+  * @note   Safe to call when the writer is not open. The region is left
+  *         partly written and must not be trusted.
+  */
+void SECBOOT_FlashWriter_Abort(void);
+
+#endif /* __SECBOOT_FLASHWRITER_H */
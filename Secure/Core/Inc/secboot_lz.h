@@ -0,0 +1,94 @@
+/**
+  * @file    secboot_lz.h
+  * @brief   Streaming LZSS decompressor for compressed update images
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    Small-window LZSS, produced by stm32_application_signer.py.
+  *          Output is produced on demand, any number of bytes at a time,
+  *          from a fixed RAM budget: the SECBOOT_LZ_WINDOW_SIZE history ring
+  *          and SECBOOT_LZ_INPUT_SIZE bytes of compressed input.
+  *
+  *          Encoding: a flag byte announces the next eight tokens, least
+  *          significant bit first. A 0 bit is one literal byte; a 1 bit is a
+  *          match of two little-endian bytes, ((offset - 1) << 6) |
+  *          (length - 3): copy length (3..66) bytes starting offset (1..1024)
+  *          bytes back in the output. Unused flag bits of the last flag
+  *          byte are 0.
+  *          The output is not trusted here: the caller hashes it against
+  *          the signed header.
+  */
+
+#ifndef __SECBOOT_LZ_H
+#define __SECBOOT_LZ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SECBOOT_LZ_WINDOW_SIZE   1024U  ///< History ring, largest match offset (power of 2)
+#define SECBOOT_LZ_INPUT_SIZE    256U   ///< Compressed bytes buffered (multiple of the AES block)
+#define SECBOOT_LZ_LENGTH_BITS   6U     ///< Match length bits of a match token
+#define SECBOOT_LZ_MIN_MATCH     3U     ///< Shortest match
+
+/** @brief Decompressor status codes */
+typedef enum {
+    SECBOOT_LZ_OK = 0,              ///< Operation successful
+    SECBOOT_LZ_INVALID_PARAM,       ///< NULL pointer or zero length
+    SECBOOT_LZ_CORRUPT,             ///< Match before the start of the output, or input too short/long
+    SECBOOT_LZ_READ_ERROR           ///< The compressed source failed
+} SECBOOT_LZ_StatusTypeDef;
+
+/**
+  * @brief  Compressed source: provide exactly length further input bytes
+  * @param  source  Caller context given to SECBOOT_LZ_Init
+  * @param  pData   Output buffer
+  * @param  length  Bytes wanted; SECBOOT_LZ_INPUT_SIZE except at the end
+  * @retval SECBOOT_LZ_OK or SECBOOT_LZ_READ_ERROR
+  */
+typedef SECBOOT_LZ_StatusTypeDef (*SECBOOT_LZ_ReadFn)(void *source, uint8_t *pData, uint32_t length);
+
+/**
+  * @brief Decompressor context
+  */
+typedef struct {
+    uint8_t  input[SECBOOT_LZ_INPUT_SIZE];     ///< Compressed bytes (first: word aligned)
+    uint8_t  window[SECBOOT_LZ_WINDOW_SIZE];   ///< Last output bytes
+    SECBOOT_LZ_ReadFn read;         ///< Compressed source
+    void    *source;                ///< Compressed source context
+    uint32_t inputRemaining;        ///< Compressed bytes not yet read from the source
+    uint32_t inputPos;              ///< Next unused byte of input
+    uint32_t inputLen;              ///< Valid bytes of input
+    uint32_t produced;              ///< Output bytes so far (window position)
+    uint32_t flags;                 ///< Flag bits not yet used
+    uint32_t flagCount;             ///< Number of them
+    uint32_t matchOffset;           ///< Match being copied: distance back
+    uint32_t matchRemaining;        ///< Match being copied: bytes left
+} SECBOOT_LZ_Context;
+
+/**
+  * @brief  Start decompressing
+  * @param  ctx             Decompressor context
+  * @param  read            Compressed source
+  * @param  source          Context for read
+  * @param  compressedSize  Bytes read returns in total
+  * @retval SECBOOT_LZ_StatusTypeDef
+  */
+SECBOOT_LZ_StatusTypeDef SECBOOT_LZ_Init(SECBOOT_LZ_Context *ctx, SECBOOT_LZ_ReadFn read, void *source,
+                                         uint32_t compressedSize);
+
+/**
+  * @brief  Produce the next decompressed bytes
+  * @param  ctx     Decompressor context
+  * @param  pOut    Output buffer
+  * @param  length  Bytes to produce; matches may span calls
+  * @retval SECBOOT_LZ_CORRUPT if the input ends early or is malformed
+  */
+SECBOOT_LZ_StatusTypeDef SECBOOT_LZ_Output(SECBOOT_LZ_Context *ctx, uint8_t *pOut, uint32_t length);
+
+/**
+  * @brief  Check that all input was used, then wipe the context
+  * @param  ctx  Decompressor context
+  * @retval SECBOOT_LZ_CORRUPT if a match or input bytes are left over
+  */
+SECBOOT_LZ_StatusTypeDef SECBOOT_LZ_Finish(SECBOOT_LZ_Context *ctx);
+
+#endif /* __SECBOOT_LZ_H */
@@ -0,0 +1,36 @@
+/**
+  * @file    secboot_nscrypto.h
+  * @brief   Crypto engines offered to the non-secure application
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    BootManager_Init keeps HASH, AES and PKA secure. The non-secure
+  *          side reaches them through NSC_CryptoSubmit with a queue of
+  *          NSC_CryptoRequestTypeDef (secure_nsc.h): any number of SHA-256,
+  *          AES-CTR and ECDSA P-256 verify requests, up to
+  *          SECBOOT_NSCRYPTO_MAX_QUEUE, per gateway call.
+  *          The queue and every buffer it names must lie in the shared
+  *          non-secure SRAM2 window (SECBOOT_NSC_SHARED_BASE); each request
+  *          is copied to secure RAM before its pointers are checked, then
+  *          the engines work on the non-secure buffers in place.
+  *          A streaming SHA-256 may stay open across calls; it holds the
+  *          HASH peripheral until its FINAL or ABORT request, or until a
+  *          START from another queue drops it.
+  */
+
+#ifndef __SECBOOT_NSCRYPTO_H
+#define __SECBOOT_NSCRYPTO_H
+
+#include "secure_nsc.h"
+#include <stdint.h>
+
+/**
+  * @brief  Process a queue of requests in order
+  * @param  queue  Requests in the shared window; status of each is written
+  * @param  count  1 to SECBOOT_NSCRYPTO_MAX_QUEUE
+  * @retval Number of requests that completed with NSC_CRYPTO_OK; 0 and no
+  *         status written when the queue itself is refused
+  * @note   A failed request does not stop the queue.
+  */
+uint32_t SECBOOT_NSCrypto_Submit(NSC_CryptoRequestTypeDef *queue, uint32_t count);
+
+#endif /* __SECBOOT_NSCRYPTO_H */
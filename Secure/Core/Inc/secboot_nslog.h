@@ -0,0 +1,72 @@
+/**
+  * @file    secboot_nslog.h
+  * @brief   Batched non-secure log output through USART1 TX DMA
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    The non-secure application writes its log text into a ring in
+  *          its own SRAM2 (NSC_LogRingTypeDef, secure_nsc.h) and hands
+  *          everything written so far to the secure side with one
+  *          NSC_LogSubmit call. The secure side sends the ring straight
+  *          from non-secure memory with DMA, one contiguous span at a
+  *          time; the next span is started from the transmit-complete
+  *          interrupt, so the ring drains without further gateway calls
+  *          and the caller never waits for the line.
+  *          The ring is checked once, at attach time, with the CMSE
+  *          address range check; its size is read once and kept in secure
+  *          RAM, and the head index the application writes is never
+  *          trusted beyond the ring bounds.
+  */
+
+#ifndef __SECBOOT_NSLOG_H
+#define __SECBOOT_NSLOG_H
+
+#include "stm32l5xx_hal.h"
+#include "secure_nsc.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SECBOOT_NSLOG_DMA_CHANNEL     DMA2_Channel6  ///< USART1 TX (channel 7 is the receive DMA of secboot_transfer.c)
+#define SECBOOT_NSLOG_DMA_IRQn        DMA2_Channel6_IRQn
+#define SECBOOT_NSLOG_IRQ_PRIORITY    7U             ///< Below USART1_IRQn and the flash writer
+#define SECBOOT_NSLOG_MIN_RING        64U            ///< Smallest accepted ring (bytes of data)
+#define SECBOOT_NSLOG_MAX_RING        32768U         ///< Largest accepted ring (bytes of data)
+
+/** @brief Non-secure log status codes */
+typedef enum {
+    SECBOOT_NSLOG_OK = 0,           ///< Operation successful
+    SECBOOT_NSLOG_INVALID_PARAM,    ///< Ring not in non-secure RAM, or bad size
+    SECBOOT_NSLOG_NOT_ATTACHED,     ///< No ring attached
+    SECBOOT_NSLOG_UART_ERROR        ///< DMA could not be set up or started
+} SECBOOT_NSLog_StatusTypeDef;
+
+/**
+  * @brief  Attach the non-secure ring and its UART
+  * @param  huart  Initialised UART the log goes out on
+  * @param  ring   Ring in non-secure memory; size must be a power of two
+  *                between SECBOOT_NSLOG_MIN_RING and SECBOOT_NSLOG_MAX_RING
+  * @retval SECBOOT_NSLog_StatusTypeDef
+  * @note   Bytes already in the ring are dropped. A ring attached before
+  *         is drained first.
+  */
+SECBOOT_NSLog_StatusTypeDef SECBOOT_NSLog_Attach(UART_HandleTypeDef *huart, NSC_LogRingTypeDef *ring);
+
+/**
+  * @brief  Start sending what the non-secure side wrote to the ring
+  * @retval SECBOOT_NSLog_StatusTypeDef
+  * @note   Returns at once; a transfer already running picks the new
+  *         bytes up when it completes.
+  */
+SECBOOT_NSLog_StatusTypeDef SECBOOT_NSLog_Submit(void);
+
+/**
+  * @brief  Wait until every submitted byte has left, e.g. before a
+  *         blocking transmit on the same UART
+  */
+void SECBOOT_NSLog_Flush(void);
+
+/**
+  * @brief  DMA channel interrupt, called from DMA2_Channel6_IRQHandler
+  */
+void SECBOOT_NSLog_DMA_IRQHandler(void);
+
+#endif /* __SECBOOT_NSLOG_H */
@@ -0,0 +1,113 @@
+/**
+  * @file    secboot_p256.h
+  * @brief   Software ECDSA P-256 signature verification (and signing for host tools)
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    Portable C, no HAL: the bootloader uses it when the PKA fails
+  *          (secboot_ecdsa.c) and host builds use it instead of the PKA;
+  *          the host tools link it directly.
+  *          u1*G + u2*Q is computed in one pass of 4-bit windows (Shamir's
+  *          trick): four doublings per window, then one addition from a
+  *          compile-time table of G multiples and one from a table of Q
+  *          multiples built per call. Table entries are read with masks
+  *          over the whole table and additions use complete formulas, so
+  *          time and memory accesses do not depend on the scalars.
+  *          Curve constants come from prime256v1.c.
+  *          SECBOOT_P256_Sign, SECBOOT_P256_PublicKey and
+  *          SECBOOT_P256_VerifyBatch serve the host image tools (Tools/);
+  *          the bootloader never calls them and --gc-sections drops them
+  *          from its image.
+  */
+
+#ifndef __SECBOOT_P256_H
+#define __SECBOOT_P256_H
+
+#include <stdint.h>
+
+#define SECBOOT_P256_SIZE       32U   ///< Bytes of a coordinate, a scalar or the digest
+#define SECBOOT_P256_BATCH_MAX  16U   ///< Signatures of a batch sharing one inversion
+
+/** @brief Software P-256 status codes */
+typedef enum {
+    SECBOOT_P256_OK = 0,             ///< Signature valid
+    SECBOOT_P256_BAD_SIGNATURE,      ///< Signature does not match digest and key
+    SECBOOT_P256_INVALID_SIGNATURE,  ///< r or s outside [1, n-1]
+    SECBOOT_P256_INVALID_PUBKEY,     ///< Key coordinates out of range or not on the curve
+    SECBOOT_P256_INVALID_PARAM,      ///< NULL pointer
+    SECBOOT_P256_INVALID_SCALAR      ///< Private key or nonce outside [1, n-1], or a nonce giving r or s = 0
+} SECBOOT_P256_StatusTypeDef;
+
+/** @brief One signature of SECBOOT_P256_VerifyBatch */
+typedef struct {
+    const uint8_t *digest;               ///< SHA-256 digest
+    const uint8_t *r;                    ///< Signature r, big-endian
+    const uint8_t *s;                    ///< Signature s, big-endian
+    SECBOOT_P256_StatusTypeDef status;   ///< Verdict (out)
+} SECBOOT_P256_BatchEntry;
+
+/**
+  * @brief  Verify an ECDSA P-256 signature
+  * @param  digest  SHA-256 digest, SECBOOT_P256_SIZE bytes
+  * @param  r       Signature r, big-endian
+  * @param  s       Signature s, big-endian
+  * @param  qx      Public key x, big-endian
+  * @param  qy      Public key y, big-endian
+  * @retval SECBOOT_P256_StatusTypeDef
+  * @note   Reentrant: no static state, about 2.5 KB of stack.
+  */
+SECBOOT_P256_StatusTypeDef SECBOOT_P256_Verify(const uint8_t *digest, const uint8_t *r, const uint8_t *s,
+                                               const uint8_t *qx, const uint8_t *qy);
+
+/**
+  * @brief  Verify signatures made with one key
+  * @param  entries  Signatures; each gets the verdict SECBOOT_P256_Verify
+  *                  would give it
+  * @param  count    Number of entries
+  * @param  qx       Public key x, big-endian
+  * @param  qy       Public key y, big-endian
+  * @retval SECBOOT_P256_OK, or SECBOOT_P256_INVALID_PUBKEY (also set in
+  *         every entry) or SECBOOT_P256_INVALID_PARAM
+  * @note   The key is checked and its window table built once per call,
+  *         and the s^-1 of up to SECBOOT_P256_BATCH_MAX entries come from
+  *         one inversion (Montgomery's trick). About 4 KB of stack.
+  */
+SECBOOT_P256_StatusTypeDef SECBOOT_P256_VerifyBatch(SECBOOT_P256_BatchEntry *entries, uint32_t count,
+                                                    const uint8_t *qx, const uint8_t *qy);
+
+/**
+  * @brief  Check that a public key is a point of the curve
+  * @param  qx      Public key x, big-endian
+  * @param  qy      Public key y, big-endian
+  * @retval SECBOOT_P256_OK, or SECBOOT_P256_INVALID_PUBKEY when a
+  *         coordinate is out of range or the point is not on the curve
+  * @note   The check SECBOOT_P256_Verify makes on every call.
+  */
+SECBOOT_P256_StatusTypeDef SECBOOT_P256_CheckKey(const uint8_t *qx, const uint8_t *qy);
+
+/**
+  * @brief  Sign a digest with ECDSA P-256
+  * @param  digest  SHA-256 digest, SECBOOT_P256_SIZE bytes
+  * @param  d       Private key, big-endian
+  * @param  k       Per-signature nonce, big-endian; never reused, and
+  *                 secret (RFC 6979 derives it from d and the digest)
+  * @param  r       Signature r, big-endian (out)
+  * @param  s       Signature s, big-endian (out)
+  * @retval SECBOOT_P256_OK, or SECBOOT_P256_INVALID_SCALAR when d or k is
+  *         out of range or k gives r or s = 0 (pick the next nonce)
+  * @note   k*G runs over the same masked generator table as the
+  *         verifier; inversions are by a public exponent.
+  */
+SECBOOT_P256_StatusTypeDef SECBOOT_P256_Sign(const uint8_t *digest, const uint8_t *d, const uint8_t *k,
+                                             uint8_t *r, uint8_t *s);
+
+/**
+  * @brief  Public key of a private key, Q = d*G
+  * @param  d       Private key, big-endian
+  * @param  qx      Public key x, big-endian (out)
+  * @param  qy      Public key y, big-endian (out)
+  * @retval SECBOOT_P256_OK, or SECBOOT_P256_INVALID_SCALAR when d is out
+  *         of range
+  */
+SECBOOT_P256_StatusTypeDef SECBOOT_P256_PublicKey(const uint8_t *d, uint8_t *qx, uint8_t *qy);
+
+#endif /* __SECBOOT_P256_H */
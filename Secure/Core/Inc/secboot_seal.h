@@ -0,0 +1,84 @@
+/**
+  * @file    secboot_seal.h
+  * @brief   Verified-image seal for fast boot on STM32L5
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    After a full SHA-256 + ECDSA verification the bootloader appends
+  *          a seal record to the secure flash page at SECBOOT_SEAL_BASE.
+  *          The record binds the slot address, the SHA-256 of the
+  *          256-byte header (which carries the signed payload hash) and a
+  *          record sequence number. Later boots accept a sealed header
+  *          without running the PKA.
+  * @warning Every secure writer must call SECBOOT_Seal_Invalidate before it
+  *          erases or programs a slot. With SECBOOT_SEAL_REHASH_PAYLOAD = 0
+  *          the payload is not re-read, which is only sound when the slots
+  *          are write-protected from the non-secure world.
+  */
+
+#ifndef __SECBOOT_SEAL_H
+#define __SECBOOT_SEAL_H
+
+#include "stm32l5xx_hal.h"
+#include "secboot_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SECBOOT_SEAL_MAGIC          0x5EA1ED01UL  ///< Record seals a verified image
+#define SECBOOT_SEAL_REVOKED_MAGIC  0x5EA1DEADUL  ///< Record revokes earlier seals of a slot
+#define SECBOOT_SEAL_RECORD_SIZE    64            ///< Bytes per record (8 flash double-words)
+#define SECBOOT_SEAL_MAX_RECORDS    (SECBOOT_SEAL_PAGE_SIZE / SECBOOT_SEAL_RECORD_SIZE)
+
+/** @brief Seal status codes */
+typedef enum {
+    SECBOOT_SEAL_OK = 0,           ///< Operation successful / image is sealed
+    SECBOOT_SEAL_ERROR,            ///< HASH or CRC failure
+    SECBOOT_SEAL_INVALID_PARAM,    ///< Invalid parameters provided
+    SECBOOT_SEAL_NOT_SEALED,       ///< No valid seal for this slot and header
+    SECBOOT_SEAL_FLASH_ERROR       ///< Seal page erase or programming failed
+} SECBOOT_Seal_StatusTypeDef;
+
+/**
+  * @brief Seal record as stored in flash
+  * @note  Records are appended; the newest record of a slot, the last one
+  *        on the page, decides. The sequence is one above the highest
+  *        sequence among the intact records on the page when the record is
+  *        written (carried over a page erase, back to 1 if the page is
+  *        lost). It orders the records only: it does not count slot writes
+  *        and nothing checks it against the slots.
+  */
+typedef struct {
+    uint32_t magic;                ///< SECBOOT_SEAL_MAGIC or SECBOOT_SEAL_REVOKED_MAGIC
+    uint32_t slotAddress;          ///< Header address of the slot
+    uint32_t sequence;             ///< Record sequence number on the seal page
+    uint32_t imageSize;            ///< Payload size from the sealed header
+    uint8_t  headerDigest[32];     ///< SHA-256 of the 256-byte header
+    uint32_t reserved[3];          ///< Left erased
+    uint32_t crc;                  ///< CRC32 of the preceding fields
+} SECBOOT_Seal_Entry;
+
+/**
+  * @brief  Check whether a slot holds the image that was last sealed there
+  * @param  slotAddress  Header address of the slot
+  * @retval SECBOOT_SEAL_OK if sealed, SECBOOT_SEAL_NOT_SEALED otherwise
+  * @note   Costs one SHA-256 over the header and a scan of the seal page
+  */
+SECBOOT_Seal_StatusTypeDef SECBOOT_Seal_Check(uint32_t slotAddress);
+
+/**
+  * @brief  Seal the image in a slot after a successful full verification
+  * @param  slotAddress  Header address of the verified image
+  * @retval SECBOOT_Seal_StatusTypeDef
+  * @note   Erases the seal page when it is full or holds foreign data;
+  *         seals of other slots are then lost and rebuilt on their next
+  *         full verification
+  */
+SECBOOT_Seal_StatusTypeDef SECBOOT_Seal_Record(uint32_t slotAddress);
+
+/**
+  * @brief  Revoke the seal of a slot before it is written
+  * @param  slotAddress  Header address of the slot about to change
+  * @retval SECBOOT_Seal_StatusTypeDef
+  */
+SECBOOT_Seal_StatusTypeDef SECBOOT_Seal_Invalidate(uint32_t slotAddress);
+
+#endif /* __SECBOOT_SEAL_H */
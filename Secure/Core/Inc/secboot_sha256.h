@@ -21,9 +21,24 @@ typedef enum {
     SECBOOT_SHA256_ERROR_COMPUTE,           ///< Digest computation failed
     SECBOOT_SHA256_ERROR_NULL_PTR,          ///< NULL pointer encountered
     SECBOOT_SHA256_ERROR_INVALID_LENGTH,    ///< Input length is zero or invalid
-    SECBOOT_SHA256_ERROR_TIMEOUT            ///< Hardware operation timeout
+    SECBOOT_SHA256_ERROR_TIMEOUT,           ///< Hardware operation timeout
+    SECBOOT_SHA256_ERROR_BUSY               ///< HASH peripheral owned by another context
 } SECBOOT_SHA_StatusTypeDef;
 
+/**
+  * @brief SHA-256 streaming context
+  * @note  The intermediate digest lives in the HASH peripheral registers, so
+  *        only one context can be open at a time. The HAL accumulates whole
+  *        32-bit words; up to 3 trailing bytes of an Update are held here
+  *        until the next Update or Final.
+  */
+typedef struct {
+    HASH_HandleTypeDef hhash;      ///< STM32 HAL HASH handle for this operation
+    uint32_t totalLength;          ///< Bytes absorbed so far
+    uint8_t  pending[4];           ///< Bytes waiting for a complete word
+    uint32_t pendingLength;        ///< Valid bytes in pending[]
+} SECBOOT_SHA256_Context;
+
 /**
   * @brief  Initialize the SHA-256 hardware accelerator
   * @retval SECBOOT_SHA_StatusTypeDef 
@@ -43,5 +58,41 @@ SECBOOT_SHA_StatusTypeDef SECBOOT_SHA256_Init(void);
   */
 SECBOOT_SHA_StatusTypeDef SECBOOT_SHA256_Compute(uint8_t *pInput, uint32_t inputLength, uint8_t *pOutputHash);
 
+/**
+  * @brief  Open a streaming SHA-256 operation
+  * @param[out] ctx  Context to initialize
+  * @retval SECBOOT_SHA_StatusTypeDef
+  * @note   The context owns the HASH peripheral until Final or Abort
+  * @warning Returns SECBOOT_SHA256_ERROR_BUSY while another context is open
+  */
+SECBOOT_SHA_StatusTypeDef SECBOOT_SHA256_Start(SECBOOT_SHA256_Context *ctx);
+
+/**
+  * @brief  Absorb the next chunk of the message
+  * @param[in,out] ctx          Open context
+  * @param[in]     pInput       Chunk to hash (any alignment, RAM or flash)
+  * @param[in]     inputLength  Chunk length in bytes, may be zero
+  * @retval SECBOOT_SHA_StatusTypeDef
+  * @note   Chunks of any size can be mixed; the digest equals a single
+  *         Compute over their concatenation
+  * @warning On error the context is released and must be restarted
+  */
+SECBOOT_SHA_StatusTypeDef SECBOOT_SHA256_Update(SECBOOT_SHA256_Context *ctx, const uint8_t *pInput, uint32_t inputLength);
+
+/**
+  * @brief  Complete the digest and release the HASH peripheral
+  * @param[in,out] ctx          Open context
+  * @param[out]    pOutputHash  32-byte output buffer
+  * @retval SECBOOT_SHA_StatusTypeDef
+  */
+SECBOOT_SHA_StatusTypeDef SECBOOT_SHA256_Final(SECBOOT_SHA256_Context *ctx, uint8_t *pOutputHash);
+
+/**
+  * @brief  Drop an open operation without producing a digest
+  * @param[in,out] ctx  Context to release
+  * @note   Safe to call on a context that is already closed
+  */
+void SECBOOT_SHA256_Abort(SECBOOT_SHA256_Context *ctx);
+
 #endif 
 /* __SECBOOT_SHA256_H */
\ No newline at end of file
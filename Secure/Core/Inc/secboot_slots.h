@@ -0,0 +1,86 @@
+/**
+  * @file    secboot_slots.h
+  * @brief   A/B slot state for direct-XIP firmware updates on STM32L5
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    Every image runs in place from the slot it was linked for: its
+  *          header entryPoint is the slot address + 256 and
+  *          SECBOOT_BootManager_CheckHeader enforces it. An update is
+  *          therefore written once into the inactive slot and promoted by
+  *          appending one record here; nothing is copied or swapped, and
+  *          the image it replaces stays in place as the fallback.
+  *          Records are appended to one of two secure flash pages. When a
+  *          page is full the next record opens the other page, which is
+  *          erased first; the newest record by sequence number decides.
+  *          A torn record fails its CRC and the previous state stays in
+  *          force, so a power loss at any point leaves a bootable state.
+  */
+
+#ifndef __SECBOOT_SLOTS_H
+#define __SECBOOT_SLOTS_H
+
+#include "stm32l5xx_hal.h"
+#include "secboot_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SECBOOT_SLOTS_MAGIC         0xAB510700UL  ///< Record holds an A/B slot state
+#define SECBOOT_SLOTS_RECORD_SIZE   32            ///< Bytes per record (4 flash double-words)
+#define SECBOOT_SLOTS_MAX_RECORDS   (SECBOOT_SLOTS_PAGE_SIZE / SECBOOT_SLOTS_RECORD_SIZE)
+#define SECBOOT_SLOTS_PAGE_COUNT    2U            ///< Pages written alternately
+
+/** @brief Slot state status codes */
+typedef enum {
+    SECBOOT_SLOTS_OK = 0,          ///< Operation successful
+    SECBOOT_SLOTS_ERROR,           ///< CRC failure
+    SECBOOT_SLOTS_INVALID_PARAM,   ///< Not an A/B slot address
+    SECBOOT_SLOTS_FLASH_ERROR      ///< State page erase or programming failed
+} SECBOOT_Slots_StatusTypeDef;
+
+/**
+  * @brief Slot state record as stored in flash
+  */
+typedef struct {
+    uint32_t magic;                ///< SECBOOT_SLOTS_MAGIC
+    uint32_t sequence;             ///< Grows by one with every record written
+    uint32_t active;               ///< Header address of the slot to boot
+    uint32_t fallback;             ///< Header address of the previous image
+    uint32_t reserved[3];          ///< Left erased
+    uint32_t crc;                  ///< CRC32 of the preceding fields
+} SECBOOT_Slots_Entry;
+
+/** @brief Current A/B slot state */
+typedef struct {
+    uint32_t active;               ///< Slot to boot first
+    uint32_t fallback;             ///< Slot to boot if the active image fails
+    uint32_t sequence;             ///< Sequence of the newest record, 0 if none
+} SECBOOT_Slots_StateTypeDef;
+
+/**
+  * @brief  Read the current slot state
+  * @param  state  Output state. With no valid record: slot A active, slot B
+  *                as the fallback.
+  * @retval SECBOOT_Slots_StatusTypeDef
+  * @note   Reads both state pages; no flash write
+  */
+SECBOOT_Slots_StatusTypeDef SECBOOT_Slots_Read(SECBOOT_Slots_StateTypeDef *state);
+
+/**
+  * @brief  Slot an update must be written to
+  * @param  state  Current state from SECBOOT_Slots_Read
+  * @retval Header address of the A/B slot that is not active
+  */
+uint32_t SECBOOT_Slots_Inactive(const SECBOOT_Slots_StateTypeDef *state);
+
+/**
+  * @brief  Make a slot the active one, keeping the current one as fallback
+  * @param  slotAddress  SECBOOT_SLOT_A_ADDR or SECBOOT_SLOT_B_ADDR
+  * @retval SECBOOT_Slots_StatusTypeDef
+  * @note   Promotes an installed update, or reverts to the fallback.
+  *         Costs one record (four double-word programs), plus one page
+  *         erase every SECBOOT_SLOTS_MAX_RECORDS records. Nothing is
+  *         written when the slot is already active.
+  */
+SECBOOT_Slots_StatusTypeDef SECBOOT_Slots_Activate(uint32_t slotAddress);
+
+#endif /* __SECBOOT_SLOTS_H */
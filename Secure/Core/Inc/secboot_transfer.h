@@ -0,0 +1,150 @@
+/**
+  * @file    secboot_transfer.h
+  * @brief   Windowed UART transfer of update images
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    USART1 receives through a circular DMA ring, so bytes keep
+  *          arriving while the core erases or programs flash; the host may
+  *          keep SECBOOT_TRANSFER_WINDOW data frames in flight and is told
+  *          which chunks arrived with a selective acknowledgement (SACK)
+  *          bitmap, so only lost or corrupted chunks are sent again.
+  *          Two sinks share the protocol:
+  *          - SECBOOT_Transfer_Receive stages the image in the update slot,
+  *            in any chunk order; SECBOOT_BootManager_UpdateFirmware
+  *            installs it later.
+  *          - SECBOOT_Transfer_Install feeds the chunks in order to
+  *            SECBOOT_BootManager_UpdateFirmwareStream, which checks the
+  *            header and its signature as soon as chunk 0 is in, and
+  *            decrypts, hashes and programs the rest as it arrives: the
+  *            image is verified when its last byte lands, and nothing is
+  *            read back. Chunks past a gap are not taken; the SACK shows
+  *            them missing. SECBOOT_Transfer_Listen runs it at boot; it is
+  *            the only caller, as updates are not taken from the
+  *            non-secure application over NSC.
+  *
+  *          Frame, little-endian, CRC-32 of the STM32 CRC unit (same as
+  *          compute_crc32 of the scripts) over type..payload:
+  *            0xA5 0x5A | type u8 | 0 u8 | index u16 | length u16 |
+  *            payload[length] | crc u32
+  *          Host to device:
+  *          - HELLO  payload baud u32: the device answers at the current
+  *                   baud, then switches to the accepted one
+  *          - START  payload size u32, crc u32 of the whole image: opens a
+  *                   session, or resumes the session of the same image
+  *          - DATA   index = chunk, payload = SECBOOT_TRANSFER_CHUNK_SIZE
+  *                   image bytes (fewer for the last chunk); no answer
+  *          - QUERY  index = query number, echoed by the SACK
+  *          - COMMIT staged: checks the received image against the START
+  *                   crc; installing: answers once the image is installed
+  *          Device to host: type | SECBOOT_TRANSFER_REPLY, payload starts
+  *          with a SECBOOT_TRANSFER_RESULT_ code.
+  *          - HELLO  + version u8, window u8, chunk size u16, baud u32,
+  *                   largest image u32
+  *          - START, QUERY, COMMIT + chunk count u16, then the received
+  *                   bitmap, chunk 0 in bit 0 of the first byte
+  *          Installing, QUERY and COMMIT answer
+  *          SECBOOT_TRANSFER_RESULT_REJECTED once the image failed a check;
+  *          the host stops sending it.
+  *          The session and its bitmap survive a disconnect and a baud
+  *          fallback, so the host resumes with START after reconnecting;
+  *          staged sessions also survive the return of
+  *          SECBOOT_Transfer_Receive.
+  */
+
+#ifndef __SECBOOT_TRANSFER_H
+#define __SECBOOT_TRANSFER_H
+
+#include "stm32l5xx_hal.h"
+#include "secboot_bootmanager.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SECBOOT_TRANSFER_VERSION          1U
+#define SECBOOT_TRANSFER_SYNC0            0xA5U
+#define SECBOOT_TRANSFER_SYNC1            0x5AU
+#define SECBOOT_TRANSFER_HEADER_SIZE      8U     ///< Sync to length
+#define SECBOOT_TRANSFER_CRC_SIZE         4U
+#define SECBOOT_TRANSFER_CHUNK_SIZE       512U   ///< Image bytes per DATA frame (divides the flash page)
+#define SECBOOT_TRANSFER_MAX_FRAME        (SECBOOT_TRANSFER_HEADER_SIZE + SECBOOT_TRANSFER_CHUNK_SIZE + \
+                                           SECBOOT_TRANSFER_CRC_SIZE)
+#define SECBOOT_TRANSFER_RING_SIZE        8192U  ///< DMA receive ring
+/** DATA frames in flight; one frame of the ring is left for QUERY frames */
+#define SECBOOT_TRANSFER_WINDOW           ((SECBOOT_TRANSFER_RING_SIZE / SECBOOT_TRANSFER_MAX_FRAME) - 1U)
+#define SECBOOT_TRANSFER_DMA_CHANNEL      DMA2_Channel7  ///< Reserved for USART1 RX by MX_DMA_Init
+
+#define SECBOOT_TRANSFER_HELLO            0x01U
+#define SECBOOT_TRANSFER_START            0x02U
+#define SECBOOT_TRANSFER_DATA             0x03U
+#define SECBOOT_TRANSFER_QUERY            0x04U
+#define SECBOOT_TRANSFER_COMMIT           0x05U
+#define SECBOOT_TRANSFER_REPLY            0x80U  ///< Set in the type of device frames
+
+#define SECBOOT_TRANSFER_RESULT_OK        0U
+#define SECBOOT_TRANSFER_RESULT_BAD_FRAME 1U     ///< Unknown type or wrong payload length
+#define SECBOOT_TRANSFER_RESULT_TOO_LARGE 2U     ///< Image does not fit the update slot
+#define SECBOOT_TRANSFER_RESULT_NO_SESSION 3U    ///< QUERY or COMMIT before START
+#define SECBOOT_TRANSFER_RESULT_INCOMPLETE 4U    ///< COMMIT with chunks missing
+#define SECBOOT_TRANSFER_RESULT_CRC_MISMATCH 5U  ///< COMMIT: image crc differs; the session restarts
+#define SECBOOT_TRANSFER_RESULT_FLASH_ERROR 6U   ///< Erase or program failed; the transfer ends
+#define SECBOOT_TRANSFER_RESULT_REJECTED 7U      ///< Installing: header, signature, digest or tag check failed
+
+/** @brief Transfer status codes */
+typedef enum {
+    SECBOOT_TRANSFER_OK = 0,           ///< Image committed to the update slot
+    SECBOOT_TRANSFER_INVALID_PARAM,    ///< NULL pointer
+    SECBOOT_TRANSFER_TIMEOUT,          ///< Nothing valid received for SECBOOT_TRANSFER_IDLE_TIMEOUT_MS
+    SECBOOT_TRANSFER_UART_ERROR,       ///< UART or DMA could not be started
+    SECBOOT_TRANSFER_FLASH_ERROR,      ///< Erase or program of the update slot failed
+    SECBOOT_TRANSFER_REJECTED          ///< Installing: the image was refused (see the install status)
+} SECBOOT_Transfer_StatusTypeDef;
+
+/**
+  * @brief  Receive an update image into SECBOOT_UPDATE_SLOT_ADDR
+  * @param  huart       Initialised UART; its baud rate is restored on return
+  * @param  pImageSize  Size of the committed image
+  * @retval SECBOOT_Transfer_StatusTypeDef
+  * @note   Needs SECBOOT_CRC_Init. Sleeps (WFI) while the ring is empty.
+  *         Takes over SECBOOT_TRANSFER_DMA_CHANNEL for the call; frames
+  *         are polled, no DMA interrupt is used.
+  */
+SECBOOT_Transfer_StatusTypeDef SECBOOT_Transfer_Receive(UART_HandleTypeDef *huart, uint32_t *pImageSize);
+
+/**
+  * @brief  Receive an update image and install it as it arrives (A/B)
+  * @param  huart           Initialised UART; its baud rate is restored on return
+  * @param  key             AES-128 update key (FW_UPDATE_KEY_SIZE bytes)
+  * @param  pInstallStatus  SECBOOT_BootManager_UpdateFirmwareStream status
+  *                         of the last image started
+  * @retval SECBOOT_TRANSFER_OK once the image is installed and promoted,
+  *         SECBOOT_TRANSFER_REJECTED when it was refused
+  * @note   Needs SECBOOT_CRC_Init and the installer's engines. The image is
+  *         never staged, so an install interrupted for longer than
+  *         SECBOOT_TRANSFER_IDLE_TIMEOUT_MS starts over; the slots are left
+  *         as they were.
+  */
+SECBOOT_Transfer_StatusTypeDef SECBOOT_Transfer_Install(UART_HandleTypeDef *huart, const uint8_t *key,
+                                                        SECBOOT_BOOTMANAGER_StatusTypeDef *pInstallStatus);
+
+/**
+  * @brief  Boot-time entry of SECBOOT_Transfer_Install
+  * @param  huart           Initialised UART; its baud rate is restored on return
+  * @param  window          Listen this long (ms) for the host; 0 returns at once
+  * @param  key             AES-128 update key (FW_UPDATE_KEY_SIZE bytes)
+  * @param  pInstallStatus  As for SECBOOT_Transfer_Install
+  * @retval SECBOOT_TRANSFER_TIMEOUT when no host said HELLO within window,
+  *         SECBOOT_Transfer_Install results otherwise
+  * @note   Same as SECBOOT_Transfer_Install, except that the link ends
+  *         after window ms of silence until the first HELLO; from then on
+  *         SECBOOT_TRANSFER_IDLE_TIMEOUT_MS applies. A host that wants the
+  *         device to take an update keeps sending HELLO while the device
+  *         resets, more often than window.
+  */
+SECBOOT_Transfer_StatusTypeDef SECBOOT_Transfer_Listen(UART_HandleTypeDef *huart, uint32_t window, const uint8_t *key,
+                                                       SECBOOT_BOOTMANAGER_StatusTypeDef *pInstallStatus);
+
+/**
+  * @brief  Forget the session, so the next START starts from scratch
+  */
+void SECBOOT_Transfer_Reset(void);
+
+#endif /* __SECBOOT_TRANSFER_H */
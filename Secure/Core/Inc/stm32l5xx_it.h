@@ -56,7 +56,11 @@ void SVC_Handler(void);
 void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
+void DMA2_Channel6_IRQHandler(void);
 void USART1_IRQHandler(void);
+void FLASH_IRQHandler(void);
+void FLASH_S_IRQHandler(void);
+void PKA_IRQHandler(void);
 /* USER CODE BEGIN EFP */
 
 /* USER CODE END EFP */
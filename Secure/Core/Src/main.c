@@ -22,12 +22,14 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include <stdio.h>
+#include <string.h>
 #include "secboot_aes.h"
 #include "secboot_bootmanager.h"
 #include "secboot_sha256.h"
 #include "secboot_ecdsa.h"
 #include "secboot_diag.h"
 #include "secboot_crc.h"
+#include "secboot_transfer.h"
 #include "stm32l5xx_hal_crc.h"
 #include "secboot_config.h"
 
@@ -68,6 +70,17 @@ static void MX_USART1_UART_Init(void);
   */
 int main(void)
 {
+  /* A/B slot state: the image to boot and the previous one kept as its fallback. */
+  SECBOOT_Slots_StateTypeDef slots = {0};
+  /* Active, fallback and backup image, their verification status and the index of the one to boot. */
+  uint32_t images[3];
+  SECBOOT_BOOTMANAGER_StatusTypeDef image_status[3];
+  uint32_t chosen;
+  /* AES-128 update key (AES_KEY1), unwrapped from the security block for the update installs and wiped before the jump. */
+  uint8_t update_key[FW_UPDATE_KEY_SIZE];
+  /* Install status of an update received over USART1. */
+  SECBOOT_BOOTMANAGER_StatusTypeDef update_status;
+
   /* SAU/IDAU, FPU and interrupts secure/non-secure allocation setup done in SystemInit() based on partition_stm32l562xx.h file's definitions, crucial for TrustZone. */
 
   /* MCU Configuration--------------------------------------------------------*/
@@ -97,6 +110,12 @@ int main(void)
   SECBOOT_CRC_Init();
   /* Initializes the SHA256 hashing module for generating data fingerprints during signature verification. */
   SECBOOT_SHA256_Init();
+  /* Finds the newest entry of the diagnostic log, so this boot's events are appended after it. */
+  SECBOOT_Diag_Init();
+  /* Point-checks the provisioned public key once and keeps it with its PKA operands for every image verification; a key off the curve is logged and fails all of them. */
+  if(SECBOOT_ECDSA_Provision((SECBOOT_ECC_PublicKey*)ECC_PUBKEY_OFFSET) == SECBOOT_ECDSA_INVALID_PUBKEY){
+    SECBOOT_Diag_LogEvent(SECBOOT_DIAG_SIG_FAIL,SIG_FAIL_PUBKEY_INVALID,0);
+  }
 
   /* Initializes the secure boot manager, orchestrating the secure boot process. */
   SECBOOT_BootManager_Init();
@@ -107,18 +126,47 @@ int main(void)
     SECBOOT_Diag_LogEvent(SECBOOT_DIAG_CRC_FAIL,0,0);
   }
 
-  /* Verifies the digital signature of the main application image; if verification fails, logs an event and attempts to jump to a backup image. */
-  if(SECBOOT_BootManager_VerifyAppSignature(SECBOOT_MAIN_APP_IMAGE_ADDR) != SECBOOT_BOOTMANAGER_OK){
+  /* Unwraps the update key; a security block that does not unwrap on this device leaves the key zero, which no update image decrypts with. */
+  if(SECBOOT_BootManager_GetUpdateKey(update_key) != SECBOOT_BOOTMANAGER_OK){
+    memset(update_key,0,sizeof(update_key));
+  }
+  /* Listens on USART1 for an update host, in builds that open the window (SECBOOT_TRANSFER_LISTEN_MS, 0 by default); a HELLO within the window installs the update it then sends into the inactive A/B slot as it arrives, verified when its last byte lands. */
+  if(SECBOOT_Transfer_Listen(&huart1,SECBOOT_TRANSFER_LISTEN_MS,update_key,&update_status) == SECBOOT_TRANSFER_REJECTED){
+    SECBOOT_Diag_LogEvent(SECBOOT_DIAG_SIG_FAIL,0,(uint32_t)update_status);
+  }
+  /* Installs an update image staged in the update slot into the inactive A/B slot and promotes it if its version is newer than the active image's; the staged image is then retired, and a refused one is logged. */
+  if(SECBOOT_BootManager_UpdateStaged(update_key) != SECBOOT_BOOTMANAGER_OK){
+    SECBOOT_Diag_LogEvent(SECBOOT_DIAG_SIG_FAIL,0,SECBOOT_UPDATE_SLOT_ADDR);
+  }
+  memset(update_key,0,sizeof(update_key));
+  /* Reads which A/B slot is active; without any update this is the main application image. */
+  SECBOOT_Slots_Read(&slots);
+
+  /* Verifies the active image, then the fallback image of the A/B pair, then the backup image, in one pipeline: each image is hashed while the PKA checks the signature of the one before, so a failing image costs no second hashing pass. */
+  images[0] = slots.active;
+  images[1] = slots.fallback;
+  images[2] = SECBOOT_BACKUP_IMAGE_ADDR;
+  chosen = SECBOOT_BootManager_VerifyFirstValid(images, 3U, image_status);
+  if(chosen != 0U){
     /* Logs a diagnostic event for application signature failure, indicating an untrusted or corrupted image. */
     SECBOOT_Diag_LogEvent(SECBOOT_DIAG_SIG_FAIL,0,0);
-    /* Attempts to transfer execution to the backup application image as a recovery mechanism. */
-    SECBOOT_BootManager_JumpTo(SECBOOT_BACKUP_IMAGE_ADDR);
+    if(chosen == 2U){
+      /* Both A/B images failed: transfers execution to the verified backup application image as a recovery mechanism. */
+      SECBOOT_BootManager_JumpTo(SECBOOT_BACKUP_IMAGE_ADDR);
+    }
+    if(chosen != 1U){
+      /* No image passed, or the backup could not be started: locks the system down rather than run unverified code. */
+      system_lockdown();
+    }
+    /* Reverts to the fallback image so later boots do not verify the failed one first. */
+    SECBOOT_Slots_Activate(slots.fallback);
+    slots.active = slots.fallback;
   }
 
   /*************** Setup and jump to non-secure *******************************/
 
-  /* Transfers execution to the authenticated and verified main application image in non-secure mode. */
-  SECBOOT_BootManager_JumpTo(SECBOOT_MAIN_APP_IMAGE_ADDR);
+  /* Transfers execution to the authenticated and verified active image in non-secure mode. */
+  SECBOOT_BootManager_JumpTo(slots.active);
 
   /* Infinite loop */
   while (1);
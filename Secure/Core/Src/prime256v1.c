@@ -68,6 +68,18 @@ static const uint8_t prime256v1_Order[] = {
 };
 static const uint32_t prime256v1_Order_len = 32;
 
+/* Montgomery parameters R^2 mod P and R^2 mod Order, R = 2^256, least
+   significant word first; from Script/stm32_p256_table.py --montgomery */
+static const uint32_t prime256v1_MontgomeryP[] = {
+    0x00000003, 0x00000000, 0xffffffff, 0xfffffffb,
+    0xfffffffe, 0xffffffff, 0xfffffffd, 0x00000004
+};
+static const uint32_t prime256v1_MontgomeryN[] = {
+    0xbe79eea2, 0x83244c95, 0x49bd6fa6, 0x4699799c,
+    0x2b6bec59, 0x2845b239, 0xf3d95620, 0x66e12d94
+};
+static const uint32_t prime256v1_Montgomery_len = 8;
+
 static const uint32_t prime256v1_Cofactor = 1;
 
 static const uint8_t prime256v1_Seed[] = {
@@ -101,6 +113,10 @@ static const ECC_Curve_Parameters prime256v1_curve = {
     .order = prime256v1_Order,
     .order_len = prime256v1_Order_len,
 
+    .montgomeryP = prime256v1_MontgomeryP,
+    .montgomeryN = prime256v1_MontgomeryN,
+    .montgomery_len = prime256v1_Montgomery_len,
+
     .cofactor = prime256v1_Cofactor,
 
     .seed = prime256v1_Seed,
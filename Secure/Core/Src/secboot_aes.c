@@ -1,6 +1,7 @@
 /** 
   * @file    secboot_aes.c
-  * @brief   Implementation of secure boot AES-CBC with PKCS7 padding
+  * @brief   Implementation of secure boot AES-CBC with PKCS7 padding and
+  *          streaming AES-CTR / AES-GCM decryption
   * @author  Soulaimane Oulad Belayachi
   * @date    2025-06-05
   * @note    Uses STM32L5 hardware crypto accelerator (CRYP)
@@ -21,7 +22,6 @@ typedef enum {
 static PKCS7_Status PKCS7_Pad(const uint8_t *input, size_t len, uint8_t *output, size_t *out_len);
 static PKCS7_Status PKCS7_Unpad(uint8_t *input, size_t input_len, uint8_t *output, size_t *output_len);
 static void bytes_to_uint32_be(uint8_t *input, size_t input_len, uint32_t *output);
-static void uint32_to_bytes_be(uint32_t *input, size_t word_count, uint8_t *output);
 
 /**
   * @brief  Apply PKCS7 padding to input data
@@ -86,18 +86,78 @@ static void bytes_to_uint32_be(uint8_t *input, size_t input_len, uint32_t *outpu
 }
 
 /**
-  * @brief  Convert 32-bit words to big-endian byte array
-  * @param  input       Input word array (big-endian)
-  * @param  word_count  Number of 32-bit words
-  * @param  output      Output byte array (little-endian)
+  * @brief  Stop the AES peripheral and wipe its key and IV registers
+  * @note   HAL_CRYP_DeInit only disables the peripheral and gates its
+  *         clock; the key and IV registers would keep their values, so
+  *         they are overwritten first, while EN is clear and the clock on.
   */
-static void uint32_to_bytes_be(uint32_t *input, size_t word_count, uint8_t *output) {
-    for (size_t i = 0; i < word_count; i++) {
-        output[4*i + 0] = (uint8_t)(input[i] >> 24);
-        output[4*i + 1] = (uint8_t)(input[i] >> 16);
-        output[4*i + 2] = (uint8_t)(input[i] >> 8);
-        output[4*i + 3] = (uint8_t)(input[i]);
+static void AES_Release(CRYP_HandleTypeDef *hcryp) {
+    AES_TypeDef *aes = hcryp->Instance;
+
+    __HAL_CRYP_DISABLE(hcryp);
+    aes->KEYR0 = 0; aes->KEYR1 = 0; aes->KEYR2 = 0; aes->KEYR3 = 0;
+    aes->KEYR4 = 0; aes->KEYR5 = 0; aes->KEYR6 = 0; aes->KEYR7 = 0;
+    aes->IVR0 = 0; aes->IVR1 = 0; aes->IVR2 = 0; aes->IVR3 = 0;
+    (void)HAL_CRYP_DeInit(hcryp);
+}
+
+/**
+  * @brief  Configure a CRYP handle for AES-128-CBC on byte streams
+  * @note   CRYP_DATATYPE_8B makes the peripheral take and return blocks in
+  *         memory byte order, so no software byte swapping is needed. The
+  *         key and IV are reloaded on every call; the IV comes from the
+  *         caller's chaining value (see AES_CBC_Run).
+  */
+static SECBOOT_AES_StatusTypeDef AES_HandleInit(CRYP_HandleTypeDef *hcryp, uint32_t *key, uint32_t *chain) {
+    hcryp->Instance = AES;
+    hcryp->Init.DataType = CRYP_DATATYPE_8B;
+    hcryp->Init.KeySize = CRYP_KEYSIZE_128B;
+    hcryp->Init.pKey = key;
+    hcryp->Init.pInitVect = chain;
+    hcryp->Init.Algorithm = CRYP_AES_CBC;
+    hcryp->Init.DataWidthUnit = CRYP_DATAWIDTHUNIT_BYTE;
+    hcryp->Init.KeyIVConfigSkip = CRYP_KEYIVCONFIG_ALWAYS;
+
+    if (HAL_CRYP_Init(hcryp) != HAL_OK) {
+        return SECBOOT_AES_ERROR;
     }
+    return SECBOOT_AES_OK;
+}
+
+/**
+  * @brief  Run whole CBC blocks through the CRYP and advance the chaining value
+  * @param  hcryp    Handle configured by AES_HandleInit
+  * @param  chain    IV in, last ciphertext block out (big-endian words)
+  * @param  encrypt  Direction
+  * @param  input    Input blocks (word aligned)
+  * @param  output   Output blocks (word aligned)
+  * @param  len      Bytes, a multiple of AES_BLOCK_SIZE up to AES_STREAM_MAX_CHUNK
+  */
+static SECBOOT_AES_StatusTypeDef AES_CBC_Run(CRYP_HandleTypeDef *hcryp, uint32_t *chain, bool encrypt,
+                                             uint32_t *input, uint32_t *output, size_t len) {
+    uint32_t next[IV_WORD_SIZE];
+    HAL_StatusTypeDef hal;
+
+    /* Take the next chaining value before an in-place decrypt overwrites it */
+    if (!encrypt) {
+        bytes_to_uint32_be((uint8_t*)input + len - AES_BLOCK_SIZE, AES_BLOCK_SIZE, next);
+    }
+
+    hcryp->Init.pInitVect = chain;
+    if (encrypt) {
+        hal = HAL_CRYP_Encrypt(hcryp, input, (uint16_t)len, output, HAL_MAX_DELAY);
+    } else {
+        hal = HAL_CRYP_Decrypt(hcryp, input, (uint16_t)len, output, HAL_MAX_DELAY);
+    }
+    if (hal != HAL_OK) {
+        return SECBOOT_AES_ERROR;
+    }
+
+    if (encrypt) {
+        bytes_to_uint32_be((uint8_t*)output + len - AES_BLOCK_SIZE, AES_BLOCK_SIZE, next);
+    }
+    memcpy(chain, next, sizeof(next));
+    return SECBOOT_AES_OK;
 }
 
 SECBOOT_AES_StatusTypeDef SECBOOT_AES_Init(SECBOOT_AES_Context *ctx, uint32_t *key, uint32_t *iv) {
@@ -106,20 +166,7 @@ SECBOOT_AES_StatusTypeDef SECBOOT_AES_Init(SECBOOT_AES_Context *ctx, uint32_t *k
     memcpy(ctx->iv, iv, IV_WORD_SIZE * sizeof(uint32_t));
     memcpy(ctx->key, key, KEY_WORD_SIZE * sizeof(uint32_t));
 
-    ctx->hcryp.Instance = AES;
-    ctx->hcryp.Init.DataType = CRYP_DATATYPE_32B;
-    ctx->hcryp.Init.KeySize = CRYP_KEYSIZE_128B;
-    ctx->hcryp.Init.pKey = (uint32_t *)ctx->key;
-    ctx->hcryp.Init.pInitVect = (uint32_t *)ctx->iv;
-    ctx->hcryp.Init.Algorithm = CRYP_AES_CBC;
-    ctx->hcryp.Init.DataWidthUnit = CRYP_DATAWIDTHUNIT_WORD;
-    ctx->hcryp.Init.KeyIVConfigSkip = CRYP_KEYIVCONFIG_ALWAYS;
-
-    if (HAL_CRYP_Init(&ctx->hcryp) != HAL_OK) {
-        return SECBOOT_AES_ERROR;
-    }    
-
-    return SECBOOT_AES_OK;
+    return AES_HandleInit(&ctx->hcryp, ctx->key, ctx->iv);
 }
 
 /**
@@ -174,30 +221,41 @@ SECBOOT_AES_StatusTypeDef SECBOOT_AES_Encrypt(
         return SECBOOT_AES_INVALID_PARAM;
     }
 
-    size_t padding_size_bytes = plaintext_len + AES_BLOCK_SIZE - (plaintext_len % AES_BLOCK_SIZE);
-    size_t padding_size_words = padding_size_bytes / 4;
-    uint8_t padded_bytes_input[padding_size_bytes];
-    uint32_t padded_words_input[padding_size_words];
-    uint32_t cipher_output[padding_size_words];
+    uint32_t chain[IV_WORD_SIZE];
+    uint32_t block[AES_BLOCK_WORD_SIZE];
+    size_t padded_len = plaintext_len + AES_BLOCK_SIZE - (plaintext_len % AES_BLOCK_SIZE);
+    size_t tail_offset = plaintext_len - (plaintext_len % AES_BLOCK_SIZE);
+    size_t padded_block_len = 0;
+    SECBOOT_AES_StatusTypeDef status = SECBOOT_AES_OK;
 
-    size_t padded_bytes_len = 0;
-    size_t padded_words_len = 0;
-    
-    if (PKCS7_Pad(plaintext, plaintext_len, padded_bytes_input, &padded_bytes_len) != PKCS7_PAD_OK) {
-        return SECBOOT_AES_PADDING_ERROR;
-    }
+    memcpy(chain, ctx->iv, sizeof(chain));
 
-    padded_words_len = padded_bytes_len / 4;
-    bytes_to_uint32_be(padded_bytes_input, padded_bytes_len, padded_words_input);
+    for (size_t offset = 0; offset < padded_len && status == SECBOOT_AES_OK; offset += AES_BLOCK_SIZE) {
+        uint32_t *out = &ciphertext[offset / 4];
 
-    if (HAL_CRYP_Encrypt(&ctx->hcryp, padded_words_input, (uint16_t)padded_words_len, 
-                         cipher_output, HAL_MAX_DELAY) != HAL_OK) {
-        return SECBOOT_AES_ERROR;
+        if (offset < tail_offset) {
+            memcpy(block, &plaintext[offset], AES_BLOCK_SIZE);
+        } else if (PKCS7_Pad(&plaintext[offset], plaintext_len - offset, (uint8_t*)block,
+                             &padded_block_len) != PKCS7_PAD_OK) {
+            status = SECBOOT_AES_PADDING_ERROR;
+            break;
+        }
+
+        status = AES_CBC_Run(&ctx->hcryp, chain, true, block, out, AES_BLOCK_SIZE);
+
+        /* Ciphertext words are returned big-endian, as the chaining value */
+        for (size_t i = 0; i < AES_BLOCK_WORD_SIZE; i++) {
+            out[i] = chain[i];
+        }
     }
 
-    memcpy(ciphertext, cipher_output, padded_words_len * sizeof(uint32_t));
-    *ciphertext_len = padded_words_len;
-    return SECBOOT_AES_OK;
+    ctx->hcryp.Init.pInitVect = ctx->iv;
+    memset(block, 0, sizeof(block));
+
+    if (status == SECBOOT_AES_OK) {
+        *ciphertext_len = padded_len / 4;
+    }
+    return status;
 }
 
 SECBOOT_AES_StatusTypeDef SECBOOT_AES_Decrypt(
@@ -207,28 +265,387 @@ SECBOOT_AES_StatusTypeDef SECBOOT_AES_Decrypt(
     uint8_t *plaintext,
     size_t *plaintext_len
 ) {
-    size_t plaintextPadded_words_len = ciphertext_len;
-    size_t plaintextPadded_bytes_len = ciphertext_len * 4;
-    uint32_t plaintextPadded_words[plaintextPadded_words_len];
-    uint8_t plaintextPadded_bytes[plaintextPadded_bytes_len];
-    uint8_t plaintextUnpadded_bytes[plaintextPadded_bytes_len];
-    size_t plaintextUnpadded_bytes_len = 0;
-
-    if (HAL_CRYP_Decrypt(&ctx->hcryp, ciphertext, ciphertext_len,
-                         plaintextPadded_words, HAL_MAX_DELAY) != HAL_OK) {
+    SECBOOT_AES_StreamContext stream;
+    uint32_t block[AES_BLOCK_WORD_SIZE];
+    size_t produced = 0;
+    size_t chunk_len = 0;
+    SECBOOT_AES_StatusTypeDef status;
+
+    if (!ctx || !ciphertext || !plaintext || !plaintext_len) {
+        return SECBOOT_AES_INVALID_PARAM;
+    }
+    if (ciphertext_len == 0 || (ciphertext_len % AES_BLOCK_WORD_SIZE) != 0) {
+        return SECBOOT_AES_PADDING_ERROR;
+    }
+
+    status = SECBOOT_AES_StreamInit(&stream, ctx->key, ctx->iv);
+
+    /* Ciphertext words are big-endian: byte-reverse each one into stream order */
+    for (size_t w = 0; w < ciphertext_len && status == SECBOOT_AES_OK; w += AES_BLOCK_WORD_SIZE) {
+        for (size_t i = 0; i < AES_BLOCK_WORD_SIZE; i++) {
+            block[i] = __REV(ciphertext[w + i]);
+        }
+        status = SECBOOT_AES_StreamUpdate(&stream, (uint8_t*)block, AES_BLOCK_SIZE,
+                                          &plaintext[produced], &chunk_len);
+        produced += chunk_len;
+    }
+
+    if (status == SECBOOT_AES_OK) {
+        status = SECBOOT_AES_StreamFinal(&stream, &plaintext[produced], &chunk_len);
+        produced += chunk_len;
+    } else {
+        SECBOOT_AES_StreamAbort(&stream);
+    }
+
+    memset(block, 0, sizeof(block));
+
+    if (status == SECBOOT_AES_OK) {
+        *plaintext_len = produced;
+    }
+    return status;
+}
+
+/**
+  * @brief  Start a streaming AES-CBC decryption
+  * @param  ctx   Pointer to stream context (secure memory)
+  * @param  key   Pointer to 128-bit key
+  * @param  iv    Pointer to initialization vector
+  * @retval SECBOOT_AES_StatusTypeDef
+  */
+SECBOOT_AES_StatusTypeDef SECBOOT_AES_StreamInit(SECBOOT_AES_StreamContext *ctx, const uint32_t *key,
+                                                 const uint32_t *iv) {
+    if (!ctx || !key || !iv) {
+        return SECBOOT_AES_INVALID_PARAM;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    memcpy(ctx->key, key, sizeof(ctx->key));
+    memcpy(ctx->chain, iv, sizeof(ctx->chain));
+
+    return AES_HandleInit(&ctx->hcryp, ctx->key, ctx->chain);
+}
+
+/**
+  * @brief  Decrypt the next part of a ciphertext stream
+  * @note   Whole blocks are decrypted straight from input to output; the
+  *         last plaintext block of every call is moved to ctx->held and
+  *         released by the next call (or by SECBOOT_AES_StreamFinal).
+  *         Unaligned buffers and block fragments go through ctx->partial.
+  */
+SECBOOT_AES_StatusTypeDef SECBOOT_AES_StreamUpdate(SECBOOT_AES_StreamContext *ctx, const uint8_t *input,
+                                                   size_t input_len, uint8_t *output, size_t *output_len) {
+    uint32_t block[AES_BLOCK_WORD_SIZE];
+    size_t produced = 0;
+
+    if (!ctx || (!input && input_len != 0) || !output || !output_len) {
+        return SECBOOT_AES_INVALID_PARAM;
+    }
+
+    while (input_len > 0) {
+        bool aligned = ((((uintptr_t)input) | ((uintptr_t)&output[produced])) & 3U) == 0U;
+        uint32_t *plain;
+        size_t len;
+
+        if (ctx->partialLength > 0 || input_len < AES_BLOCK_SIZE || !aligned) {
+            /* Collect one block */
+            len = AES_BLOCK_SIZE - ctx->partialLength;
+            if (len > input_len) {
+                len = input_len;
+            }
+            memcpy((uint8_t*)ctx->partial + ctx->partialLength, input, len);
+            ctx->partialLength += len;
+            input += len;
+            input_len -= len;
+
+            if (ctx->partialLength < AES_BLOCK_SIZE) {
+                break;
+            }
+            ctx->partialLength = 0;
+
+            if (AES_CBC_Run(&ctx->hcryp, ctx->chain, false, ctx->partial, block, AES_BLOCK_SIZE) != SECBOOT_AES_OK) {
+                return SECBOOT_AES_ERROR;
+            }
+            plain = block;
+            len = AES_BLOCK_SIZE;
+        } else {
+            /* Decrypt whole blocks in place, after the block released below */
+            len = input_len - (input_len % AES_BLOCK_SIZE);
+            if (len > AES_STREAM_MAX_CHUNK) {
+                len = AES_STREAM_MAX_CHUNK;
+            }
+            plain = (uint32_t*)&output[produced + (ctx->holding ? AES_BLOCK_SIZE : 0)];
+
+            if (AES_CBC_Run(&ctx->hcryp, ctx->chain, false, (uint32_t*)input, plain, len) != SECBOOT_AES_OK) {
+                return SECBOOT_AES_ERROR;
+            }
+            input += len;
+            input_len -= len;
+        }
+
+        /* Release the previously held block, hold back the newest one */
+        if (ctx->holding) {
+            memcpy(&output[produced], ctx->held, AES_BLOCK_SIZE);
+            produced += AES_BLOCK_SIZE;
+        }
+        if (plain != block) {
+            produced += len - AES_BLOCK_SIZE;
+        }
+        memcpy(ctx->held, (uint8_t*)plain + len - AES_BLOCK_SIZE, AES_BLOCK_SIZE);
+        ctx->holding = true;
+    }
+
+    memset(block, 0, sizeof(block));
+    *output_len = produced;
+    return SECBOOT_AES_OK;
+}
+
+/**
+  * @brief  Finish a streaming decryption and strip the PKCS7 padding
+  */
+SECBOOT_AES_StatusTypeDef SECBOOT_AES_StreamFinal(SECBOOT_AES_StreamContext *ctx, uint8_t *output,
+                                                  size_t *output_len) {
+    SECBOOT_AES_StatusTypeDef status = SECBOOT_AES_PADDING_ERROR;
+    size_t tail_len = 0;
+
+    if (!ctx || !output || !output_len) {
+        return SECBOOT_AES_INVALID_PARAM;
+    }
+
+    if (ctx->holding && ctx->partialLength == 0 &&
+        PKCS7_Unpad((uint8_t*)ctx->held, AES_BLOCK_SIZE, output, &tail_len) == PKCS7_UNPAD_OK) {
+        *output_len = tail_len;
+        status = SECBOOT_AES_OK;
+    }
+
+    SECBOOT_AES_StreamAbort(ctx);
+    return status;
+}
+
+/**
+  * @brief  Abandon a streaming decryption and wipe the context
+  * @note   The peripheral is left initialised for other users
+  */
+void SECBOOT_AES_StreamAbort(SECBOOT_AES_StreamContext *ctx) {
+    if (!ctx) {
+        return;
+    }
+
+    volatile uint8_t *p = (volatile uint8_t *)ctx;
+    for (size_t i = 0; i < sizeof(*ctx); i++) {
+        p[i] = 0;
+    }
+}
+
+/**
+  * @brief  Run bytes through the CRYP in the context's mode
+  * @note   CTR reloads ctx->counter on every call and advances it here;
+  *         GCM loads it once and the peripheral keeps counting.
+  */
+static SECBOOT_AES_StatusTypeDef Cipher_Run(SECBOOT_AES_CipherContext *ctx, const uint32_t *input,
+                                            uint32_t *output, size_t len) {
+    if (HAL_CRYP_Decrypt(&ctx->hcryp, (uint32_t*)input, (uint16_t)len, output, HAL_MAX_DELAY) != HAL_OK) {
         return SECBOOT_AES_ERROR;
     }
+    if (ctx->mode == SECBOOT_AES_MODE_CTR) {
+        ctx->counter[IV_WORD_SIZE - 1] += (uint32_t)(len / AES_BLOCK_SIZE);
+    }
+    return SECBOOT_AES_OK;
+}
 
-    uint32_to_bytes_be(plaintextPadded_words, plaintextPadded_words_len, plaintextPadded_bytes);
+/** @brief CTR: produce the key stream of the next counter block */
+static SECBOOT_AES_StatusTypeDef Cipher_NextKeystream(SECBOOT_AES_CipherContext *ctx) {
+    static const uint32_t zero[AES_BLOCK_WORD_SIZE] = {0};
 
-    if (PKCS7_Unpad(plaintextPadded_bytes, plaintextPadded_bytes_len,
-                    plaintextUnpadded_bytes, &plaintextUnpadded_bytes_len) != PKCS7_UNPAD_OK) {
-        return SECBOOT_AES_PADDING_ERROR;
+    ctx->keystreamUsed = 0;
+    return Cipher_Run(ctx, zero, ctx->keystream, AES_BLOCK_SIZE);
+}
+
+/**
+  * @brief  Start an AES-CTR or AES-GCM decryption
+  * @note   GCM takes the 96-bit IV; the first payload counter is IV || 2 as
+  *         the peripheral expects (IV || 1 is kept for the tag).
+  */
+SECBOOT_AES_StatusTypeDef SECBOOT_AES_CipherInit(SECBOOT_AES_CipherContext *ctx, SECBOOT_AES_ModeTypeDef mode,
+                                                 const uint8_t *key, size_t key_len, const uint8_t *iv,
+                                                 const uint8_t *aad, size_t aad_len) {
+    if (!ctx || !key || !iv || (key_len != 16 && key_len != 32)) {
+        return SECBOOT_AES_INVALID_PARAM;
+    }
+    if (mode != SECBOOT_AES_MODE_CTR && mode != SECBOOT_AES_MODE_GCM) {
+        return SECBOOT_AES_INVALID_PARAM;
+    }
+    if (mode == SECBOOT_AES_MODE_GCM && ((aad_len != 0 && !aad) || ((uintptr_t)aad & 3U) != 0U)) {
+        return SECBOOT_AES_INVALID_PARAM;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->mode = mode;
+    ctx->keystreamUsed = AES_BLOCK_SIZE;
+    bytes_to_uint32_be((uint8_t*)key, key_len, ctx->key);
+
+    if (mode == SECBOOT_AES_MODE_CTR) {
+        bytes_to_uint32_be((uint8_t*)iv, AES_CTR_IV_SIZE, ctx->initial);
+    } else {
+        bytes_to_uint32_be((uint8_t*)iv, AES_GCM_IV_SIZE, ctx->initial);
+        ctx->initial[IV_WORD_SIZE - 1] = 2;
+    }
+    memcpy(ctx->counter, ctx->initial, sizeof(ctx->counter));
+
+    ctx->hcryp.Instance = AES;
+    ctx->hcryp.Init.DataType = CRYP_DATATYPE_8B;
+    ctx->hcryp.Init.KeySize = (key_len == 32) ? CRYP_KEYSIZE_256B : CRYP_KEYSIZE_128B;
+    ctx->hcryp.Init.pKey = ctx->key;
+    ctx->hcryp.Init.pInitVect = ctx->counter;
+    ctx->hcryp.Init.DataWidthUnit = CRYP_DATAWIDTHUNIT_BYTE;
+
+    if (mode == SECBOOT_AES_MODE_CTR) {
+        ctx->hcryp.Init.Algorithm = CRYP_AES_CTR;
+        ctx->hcryp.Init.KeyIVConfigSkip = CRYP_KEYIVCONFIG_ALWAYS;
+    } else {
+        ctx->hcryp.Init.Algorithm = CRYP_AES_GCM_GMAC;
+        ctx->hcryp.Init.Header = (uint32_t*)aad;
+        ctx->hcryp.Init.HeaderSize = (uint32_t)aad_len;
+        ctx->hcryp.Init.HeaderWidthUnit = CRYP_HEADERWIDTHUNIT_BYTE;
+        ctx->hcryp.Init.KeyIVConfigSkip = CRYP_KEYIVCONFIG_ONCE;
+    }
+
+    if (HAL_CRYP_Init(&ctx->hcryp) != HAL_OK) {
+        SECBOOT_AES_CipherAbort(ctx);
+        return SECBOOT_AES_ERROR;
+    }
+    return SECBOOT_AES_OK;
+}
+
+/**
+  * @brief  Decrypt the next part of the payload
+  * @note   Aligned whole blocks go straight through the CRYP. CTR serves
+  *         block fragments and unaligned buffers from a key-stream block;
+  *         GCM bounces them through a local block.
+  */
+SECBOOT_AES_StatusTypeDef SECBOOT_AES_CipherUpdate(SECBOOT_AES_CipherContext *ctx, const uint8_t *input,
+                                                   size_t length, uint8_t *output) {
+    uint32_t block[AES_BLOCK_WORD_SIZE];
+    SECBOOT_AES_StatusTypeDef status = SECBOOT_AES_OK;
+
+    if (!ctx || ((!input || !output) && length != 0)) {
+        return SECBOOT_AES_INVALID_PARAM;
+    }
+    if (ctx->mode == SECBOOT_AES_MODE_GCM && ctx->finished && length != 0) {
+        return SECBOOT_AES_INVALID_PARAM;
+    }
+
+    while (length > 0 && status == SECBOOT_AES_OK) {
+        bool aligned = ((((uintptr_t)input) | ((uintptr_t)output)) & 3U) == 0U;
+        size_t len;
+
+        if (ctx->mode == SECBOOT_AES_MODE_CTR && ctx->keystreamUsed < AES_BLOCK_SIZE) {
+            len = AES_BLOCK_SIZE - ctx->keystreamUsed;
+            if (len > length) {
+                len = length;
+            }
+            for (size_t i = 0; i < len; i++) {
+                output[i] = input[i] ^ ((uint8_t*)ctx->keystream)[ctx->keystreamUsed + i];
+            }
+            ctx->keystreamUsed += len;
+        } else if (aligned && length >= AES_BLOCK_SIZE) {
+            len = length - (length % AES_BLOCK_SIZE);
+            if (len > AES_STREAM_MAX_CHUNK) {
+                len = AES_STREAM_MAX_CHUNK;
+            }
+            status = Cipher_Run(ctx, (const uint32_t*)input, (uint32_t*)output, len);
+        } else if (ctx->mode == SECBOOT_AES_MODE_CTR) {
+            status = Cipher_NextKeystream(ctx);
+            continue;
+        } else {
+            /* GCM: unaligned block, or the short last block */
+            len = (length < AES_BLOCK_SIZE) ? length : AES_BLOCK_SIZE;
+            memset(block, 0, sizeof(block));
+            memcpy(block, input, len);
+            status = Cipher_Run(ctx, block, block, len);
+            memcpy(output, block, len);
+            ctx->finished = (len < AES_BLOCK_SIZE);
+        }
+
+        input += len;
+        output += len;
+        length -= len;
+        ctx->position += len;
     }
 
-    memcpy(plaintext, plaintextUnpadded_bytes, plaintextUnpadded_bytes_len);
-    *plaintext_len = plaintextUnpadded_bytes_len;
+    memset(block, 0, sizeof(block));
+    return status;
+}
+
+/**
+  * @brief  Move a CTR decryption to another payload offset
+  */
+SECBOOT_AES_StatusTypeDef SECBOOT_AES_CipherSeek(SECBOOT_AES_CipherContext *ctx, uint32_t offset) {
+    if (!ctx || ctx->mode != SECBOOT_AES_MODE_CTR) {
+        return SECBOOT_AES_INVALID_PARAM;
+    }
+
+    memcpy(ctx->counter, ctx->initial, sizeof(ctx->counter));
+    ctx->counter[IV_WORD_SIZE - 1] += offset / AES_BLOCK_SIZE;
+    ctx->keystreamUsed = AES_BLOCK_SIZE;
+    ctx->position = offset;
+
+    if ((offset % AES_BLOCK_SIZE) != 0) {
+        if (Cipher_NextKeystream(ctx) != SECBOOT_AES_OK) {
+            return SECBOOT_AES_ERROR;
+        }
+        ctx->keystreamUsed = offset % AES_BLOCK_SIZE;
+    }
     return SECBOOT_AES_OK;
 }
 
+/**
+  * @brief  Finish a decryption and check the GCM tag
+  * @note   The tag comparison does not stop at the first differing byte.
+  *         A GCM stream without payload is rejected.
+  */
+SECBOOT_AES_StatusTypeDef SECBOOT_AES_CipherFinal(SECBOOT_AES_CipherContext *ctx, const uint8_t *tag) {
+    uint32_t computed[AES_GCM_TAG_SIZE / 4];
+    SECBOOT_AES_StatusTypeDef status = SECBOOT_AES_OK;
+    uint8_t diff = 0;
+
+    if (!ctx) {
+        return SECBOOT_AES_INVALID_PARAM;
+    }
+
+    if (ctx->mode == SECBOOT_AES_MODE_GCM) {
+        if (!tag) {
+            status = SECBOOT_AES_INVALID_PARAM;
+        } else if (ctx->position == 0 ||
+                   HAL_CRYPEx_AESGCM_GenerateAuthTAG(&ctx->hcryp, computed, HAL_MAX_DELAY) != HAL_OK) {
+            status = SECBOOT_AES_AUTH_ERROR;
+        } else {
+            for (size_t i = 0; i < AES_GCM_TAG_SIZE; i++) {
+                diff |= ((uint8_t*)computed)[i] ^ tag[i];
+            }
+            status = (diff == 0) ? SECBOOT_AES_OK : SECBOOT_AES_AUTH_ERROR;
+        }
+        memset(computed, 0, sizeof(computed));
+    }
+
+    SECBOOT_AES_CipherAbort(ctx);
+    return status;
+}
 
+/**
+  * @brief  Abandon a CTR/GCM decryption and wipe the context
+  * @note   The peripheral is deinitialised and its key registers cleared
+  *         as well; a context aborted before is left alone.
+  */
+void SECBOOT_AES_CipherAbort(SECBOOT_AES_CipherContext *ctx) {
+    if (!ctx) {
+        return;
+    }
+    if (ctx->hcryp.Instance != NULL) {
+        AES_Release(&ctx->hcryp);
+    }
+
+    volatile uint8_t *p = (volatile uint8_t *)ctx;
+    for (size_t i = 0; i < sizeof(*ctx); i++) {
+        p[i] = 0;
+    }
+}
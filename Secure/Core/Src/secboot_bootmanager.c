@@ -1,4 +1,5 @@
 #include "secboot_bootmanager.h"
+#include "secboot_diag.h"
 
 
 
@@ -219,66 +220,1105 @@ SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_VerifyBootloaderCRC(){
 }
 
 
-SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_VerifyAppSignature(uint32_t image_address)
+/**
+  * @brief  Size of the flash slot that starts at an image address
+  * @param  image_address Firmware header address
+  * @retval Slot size in bytes, 0 if the address is not a slot
+  */
+static uint32_t BootManager_SlotSize(uint32_t image_address)
 {
-    // Initialize status to error as default (fail-safe)
-    SECBOOT_BOOTMANAGER_StatusTypeDef status = SECBOOT_BOOTMANAGER_ERROR;
+    switch (image_address) {
+        case SECBOOT_MAIN_APP_IMAGE_ADDR: return SECBOOT_MAIN_APP_IMAGE_SIZE;
+        case SECBOOT_SLOT1_ADDR:          return SECBOOT_SLOT1_SIZE;
+        case SECBOOT_SLOT2_ADDR:          return SECBOOT_SLOT2_SIZE;
+        case SECBOOT_UPDATE_SLOT_ADDR:    return SECBOOT_UPDATE_SLOT_SIZE;
+        case SECBOOT_BACKUP_IMAGE_ADDR:   return SECBOOT_BACKUP_IMAGE_SIZE;
+        default:                          return 0;
+    }
+}
 
-    // Buffer to store computed SHA-256 hash of application
-    uint8_t pDigitApp[FW_HASH_SIZE] = {0};
 
-    // Pointer to firmware header structure in flash memory
+/**
+  * @brief  Check a header for installation at a slot address
+  * @param  pAppHeader   Header to check (in the slot, or a copy)
+  * @param  slot_address Slot the image runs from
+  */
+static SECBOOT_BOOTMANAGER_StatusTypeDef BootManager_CheckHeaderFor(const FirmwareHeader_TypeDef* pAppHeader, uint32_t slot_address)
+{
+    uint32_t slot_size = BootManager_SlotSize(slot_address);
+    uint32_t computed_crc = 0;
+
+    if (slot_size == 0) {
+        return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+    }
+
+    // 1. Magic number: one word read rejects erased or foreign slots
+    if (pAppHeader->magicNumber != FW_MAGIC_NUMBER && pAppHeader->magicNumber != FW_MAGIC_NUMBER_V2) {
+        return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+    }
+
+    // 2. Header CRC: every field used below is covered by it
+    if (SECBOOT_CRC_Calculate((uint8_t*)pAppHeader, FW_HEADER_CRC_SPAN, &computed_crc) != SECBOOT_CRC_OK) {
+        return SECBOOT_BOOTMANAGER_ERROR;
+    }
+    if (computed_crc != pAppHeader->headerCRC) {
+        return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+    }
+
+    // 3. Size bounds: the payload (and v2 block table) must fit in the slot
+    if (pAppHeader->imageSize == 0 || pAppHeader->imageSize > slot_size - SECBOOT_FW_HEADER_SIZE) {
+        return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+    }
+    if (pAppHeader->magicNumber == FW_MAGIC_NUMBER_V2 &&
+        FW_BLOCK_TABLE_OFFSET(pAppHeader->imageSize) + (FW_BLOCK_COUNT(pAppHeader->imageSize) * FW_HASH_SIZE) >
+        slot_size - SECBOOT_FW_HEADER_SIZE) {
+        return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+    }
+
+    // 4. The payload (and vector table) starts right after the header
+    if (pAppHeader->entryPoint != slot_address + SECBOOT_FW_HEADER_SIZE) {
+        return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+    }
+
+    return SECBOOT_BOOTMANAGER_OK;
+}
+
+
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_CheckHeader(uint32_t image_address)
+{
+    return BootManager_CheckHeaderFor((const FirmwareHeader_TypeDef*)image_address, image_address);
+}
+
+
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_HashPayload(uint32_t image_address, uint8_t *pDigest)
+{
     const FirmwareHeader_TypeDef* pAppHeader = (const FirmwareHeader_TypeDef*)image_address;
-    // Pointer to start of application binary in flash
-    uint8_t* pAppBinary = (uint8_t*)(pAppHeader->entryPoint);
+    const uint8_t* pChunk = (const uint8_t*)(pAppHeader->entryPoint);
+    uint32_t remaining = pAppHeader->imageSize;
+    SECBOOT_SHA256_Context sha_ctx;
 
-    // 1. First check: Verify firmware header magic number
-    if(pAppHeader->magicNumber != FW_MAGIC_NUMBER) {
-        status = SECBOOT_BOOTMANAGER_INVALID_HEADER;
-        return status; // Early return if header is invalid
+    if (pDigest == NULL) {
+        return SECBOOT_BOOTMANAGER_ERROR;
     }
 
-    // 2. Second check: Compute and verify SHA-256 hash
-    // Compute hash of application binary using hardware accelerator
-    if(SECBOOT_SHA256_Compute(pAppBinary,pAppHeader->imageSize,pDigitApp) != SECBOOT_SHA256_OK){
-        status = SECBOOT_BOOTMANAGER_ERROR;
-        return status; // Return if hash computation fails
+    if (SECBOOT_SHA256_Start(&sha_ctx) != SECBOOT_SHA256_OK) {
+        return SECBOOT_BOOTMANAGER_ERROR;
     }
 
-    // Compare computed hash with hash stored in firmware header
-    if(memcmp((uint8_t*)pDigitApp,(uint8_t*)pAppHeader->firmwareHash,FW_HASH_SIZE) != 0){
-        status = SECBOOT_BOOTMANAGER_INVALID_HASH;
-        return status; // Return if hashes don't match
+    while (remaining > 0) {
+        uint32_t chunk = (remaining > FW_VERIFY_CHUNK_SIZE) ? FW_VERIFY_CHUNK_SIZE : remaining;
+
+        if (SECBOOT_SHA256_Update(&sha_ctx, pChunk, chunk) != SECBOOT_SHA256_OK) {
+            return SECBOOT_BOOTMANAGER_ERROR;
+        }
+
+        pChunk += chunk;
+        remaining -= chunk;
     }
 
-    // 3. Third check: Verify ECDSA signature
+    if (SECBOOT_SHA256_Final(&sha_ctx, pDigest) != SECBOOT_SHA256_OK) {
+        return SECBOOT_BOOTMANAGER_ERROR;
+    }
+
+    return SECBOOT_BOOTMANAGER_OK;
+}
+
+
+/**
+  * @brief  Start of the v2 block table of an image
+  */
+static const uint8_t* BootManager_BlockTable(const FirmwareHeader_TypeDef* pAppHeader)
+{
+    return (const uint8_t*)(pAppHeader->entryPoint + FW_BLOCK_TABLE_OFFSET(pAppHeader->imageSize));
+}
+
+
+/**
+  * @brief  Hash the v2 block table, i.e. recompute the signed root
+  */
+static SECBOOT_BOOTMANAGER_StatusTypeDef BootManager_HashBlockTable(const FirmwareHeader_TypeDef* pAppHeader, uint8_t *pDigest)
+{
+    uint32_t table_size = FW_BLOCK_COUNT(pAppHeader->imageSize) * FW_HASH_SIZE;
+
+    if (SECBOOT_SHA256_Compute((uint8_t*)BootManager_BlockTable(pAppHeader), table_size, pDigest) != SECBOOT_SHA256_OK) {
+        return SECBOOT_BOOTMANAGER_ERROR;
+    }
+    return SECBOOT_BOOTMANAGER_OK;
+}
+
+
+/**
+  * @brief  Recompute the value the signature covers and match it to the header
+  * @note   v1: SHA-256 of the payload. v2: SHA-256 of the block table, then
+  *         every block against the table.
+  * @param  image_address Address of a header that passed CheckHeader
+  * @param  pDigest       32-byte output for the recomputed signed digest
+  */
+static SECBOOT_BOOTMANAGER_StatusTypeDef BootManager_VerifyPayload(uint32_t image_address, uint8_t *pDigest)
+{
+    const FirmwareHeader_TypeDef* pAppHeader = (const FirmwareHeader_TypeDef*)image_address;
+
+    if (pAppHeader->magicNumber == FW_MAGIC_NUMBER_V2) {
+        if (BootManager_HashBlockTable(pAppHeader, pDigest) != SECBOOT_BOOTMANAGER_OK) {
+            return SECBOOT_BOOTMANAGER_ERROR;
+        }
+    } else {
+        if (SECBOOT_BootManager_HashPayload(image_address, pDigest) != SECBOOT_BOOTMANAGER_OK) {
+            return SECBOOT_BOOTMANAGER_ERROR;
+        }
+    }
+
+    if (memcmp(pDigest, pAppHeader->firmwareHash, FW_HASH_SIZE) != 0) {
+        return SECBOOT_BOOTMANAGER_INVALID_HASH;
+    }
+
+    if (pAppHeader->magicNumber == FW_MAGIC_NUMBER_V2) {
+        return SECBOOT_BootManager_VerifyBlocks(image_address, 0, FW_BLOCK_COUNT(pAppHeader->imageSize), NULL);
+    }
+
+    return SECBOOT_BOOTMANAGER_OK;
+}
+
+
+/**
+  * @brief  ECDSA check of a signed digest against the header signature
+  */
+static SECBOOT_BOOTMANAGER_StatusTypeDef BootManager_VerifyRootSignature(const FirmwareHeader_TypeDef* pAppHeader, uint8_t *pDigest)
+{
     // Get public key from predefined secure location
     SECBOOT_ECC_PublicKey *public_key = (SECBOOT_ECC_PublicKey*) ECC_PUBKEY_OFFSET;
     // Get signature from firmware header
     SECBOOT_ECC_Signature *signature = (SECBOOT_ECC_Signature*) pAppHeader->signature;
 
-    // Verify signature using ECDSA
-    if(SECBOOT_ECDSA_Verify_Signature(pDigitApp,FW_HASH_SIZE,signature,public_key) == SECBOOT_ECDSA_VERIFICATION_SUCCESS){
-        status = SECBOOT_BOOTMANAGER_OK; // All verifications passed
-    }else{
-        status = SECBOOT_BOOTMANAGER_INVALID_SIGNATURE;
-        return status; // Return if signature verification fails
+    if (SECBOOT_ECDSA_Verify_Signature(pDigest, FW_HASH_SIZE, signature, public_key) != SECBOOT_ECDSA_VERIFICATION_SUCCESS) {
+        return SECBOOT_BOOTMANAGER_INVALID_SIGNATURE;
+    }
+    return SECBOOT_BOOTMANAGER_OK;
+}
+
+
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_VerifyBlockTable(uint32_t image_address)
+{
+    const FirmwareHeader_TypeDef* pAppHeader = (const FirmwareHeader_TypeDef*)image_address;
+    SECBOOT_BOOTMANAGER_StatusTypeDef status;
+    uint8_t root[FW_HASH_SIZE] = {0};
+
+    status = SECBOOT_BootManager_CheckHeader(image_address);
+    if (status != SECBOOT_BOOTMANAGER_OK) {
+        return status;
+    }
+    if (pAppHeader->magicNumber != FW_MAGIC_NUMBER_V2) {
+        return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+    }
+
+    status = BootManager_HashBlockTable(pAppHeader, root);
+    if (status == SECBOOT_BOOTMANAGER_OK && memcmp(root, pAppHeader->firmwareHash, FW_HASH_SIZE) != 0) {
+        status = SECBOOT_BOOTMANAGER_INVALID_HASH;
+    }
+    if (status == SECBOOT_BOOTMANAGER_OK) {
+        status = BootManager_VerifyRootSignature((const FirmwareHeader_TypeDef*)image_address, root);
+    }
+
+    memset(root, 0, sizeof(root));
+    return status;
+}
+
+
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_VerifyBlocks(uint32_t image_address, uint32_t firstBlock, uint32_t blockCount, uint32_t *pFailedBlock)
+{
+    const FirmwareHeader_TypeDef* pAppHeader = (const FirmwareHeader_TypeDef*)image_address;
+    const uint8_t* pTable;
+    uint32_t total_blocks;
+    uint8_t digest[FW_HASH_SIZE];
+
+    if (SECBOOT_BootManager_CheckHeader(image_address) != SECBOOT_BOOTMANAGER_OK ||
+        pAppHeader->magicNumber != FW_MAGIC_NUMBER_V2) {
+        return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+    }
+
+    total_blocks = FW_BLOCK_COUNT(pAppHeader->imageSize);
+    if (firstBlock > total_blocks || blockCount > total_blocks - firstBlock) {
+        return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+    }
+
+    pTable = BootManager_BlockTable(pAppHeader);
+
+    for (uint32_t block = firstBlock; block < firstBlock + blockCount; block++) {
+        uint32_t offset = block * FW_BLOCK_SIZE;
+        uint32_t length = pAppHeader->imageSize - offset;
+
+        if (length > FW_BLOCK_SIZE) {
+            length = FW_BLOCK_SIZE;
+        }
+
+        if (SECBOOT_SHA256_Compute((uint8_t*)(pAppHeader->entryPoint + offset), length, digest) != SECBOOT_SHA256_OK) {
+            return SECBOOT_BOOTMANAGER_ERROR;
+        }
+
+        if (memcmp(digest, &pTable[block * FW_HASH_SIZE], FW_HASH_SIZE) != 0) {
+            if (pFailedBlock != NULL) {
+                *pFailedBlock = block;
+            }
+            return SECBOOT_BOOTMANAGER_INVALID_HASH;
+        }
+    }
+
+    return SECBOOT_BOOTMANAGER_OK;
+}
+
+
+/**
+  * @brief  Every check of VerifyAppSignature up to the ECDSA one
+  * @param  image_address Image to check
+  * @param  pDigest       32-byte output for the recomputed signed digest
+  * @param  pSealed       Set when a fast-boot seal stands in for the ECDSA check
+  */
+static SECBOOT_BOOTMANAGER_StatusTypeDef BootManager_PrepareVerify(uint32_t image_address, uint8_t *pDigest, bool *pSealed)
+{
+    SECBOOT_BOOTMANAGER_StatusTypeDef status;
+
+    *pSealed = false;
+
+    // 1. First check: header only (magic, header CRC, size and entry bounds)
+    status = SECBOOT_BootManager_CheckHeader(image_address);
+    if(status != SECBOOT_BOOTMANAGER_OK) {
+        return status; // Early return before any payload read
     }
 
+#if SECBOOT_ENABLE_FAST_BOOT
+    // Fast path: this exact header already passed ECDSA and the slot has
+    // not been written since, so the signature check is skipped
+    if(SECBOOT_Seal_Check(image_address) == SECBOOT_SEAL_OK) {
+        *pSealed = true;
+#if SECBOOT_SEAL_REHASH_PAYLOAD
+        status = BootManager_VerifyPayload(image_address,pDigest);
+#endif
+        return status;
+    }
+#endif
+
+    // 2. Second check: recompute the signed digest and match the header
+    // Single pass over the payload using the hardware accelerator
+    return BootManager_VerifyPayload(image_address,pDigest);
+}
+
+
+/**
+  * @brief  Record a full verification that passed
+  */
+static void BootManager_Verified(uint32_t image_address)
+{
+#if SECBOOT_ENABLE_FAST_BOOT
+    // Best effort: a failed seal only costs a full verification next boot
+    (void)SECBOOT_Seal_Record(image_address);
+#else
+    (void)image_address;
+#endif
+}
+
+
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_VerifyAppSignature(uint32_t image_address)
+{
+    // Initialize status to error as default (fail-safe)
+    SECBOOT_BOOTMANAGER_StatusTypeDef status = SECBOOT_BOOTMANAGER_ERROR;
+
+    // Buffer to store the recomputed signed digest (payload hash or v2 table root)
+    uint8_t pDigitApp[FW_HASH_SIZE] = {0};
+    bool sealed = false;
+
+    // 1-2. Header, then the signed digest (or the fast-boot seal)
+    status = BootManager_PrepareVerify(image_address,pDigitApp,&sealed);
+    if(status != SECBOOT_BOOTMANAGER_OK || sealed){
+        memset((uint8_t*)pDigitApp,0,FW_HASH_SIZE);
+        return status; // Return if hashing fails or hashes don't match
+    }
+
+    // 3. Third check: Verify ECDSA signature over the recomputed digest
+    status = BootManager_VerifyRootSignature((const FirmwareHeader_TypeDef*)image_address,pDigitApp);
+
     // Security cleanup: Wipe sensitive data from memory
+    // public_key and signature point into flash, not into RAM copies: a plain
+    // store there is a flash programming error, so only the RAM digest is wiped
     memset((uint8_t*)pDigitApp,0,FW_HASH_SIZE); // Clear computed hash
-    memset((SECBOOT_ECC_PublicKey*)public_key,0,sizeof(SECBOOT_ECC_PublicKey)); // Clear public key copy
-    memset((SECBOOT_ECC_Signature*)signature,0,sizeof(SECBOOT_ECC_Signature)); // Clear signature copy
+
+    if(status == SECBOOT_BOOTMANAGER_OK){
+        BootManager_Verified(image_address);
+    }
 
     return status; // Return final verification status
 }
 
 
+/**
+  * @brief  Collect the background ECDSA check started on an image
+  */
+static SECBOOT_BOOTMANAGER_StatusTypeDef BootManager_FinishSignature(uint32_t image_address)
+{
+    if (SECBOOT_ECDSA_Verify_Finish() != SECBOOT_ECDSA_VERIFICATION_SUCCESS) {
+        return SECBOOT_BOOTMANAGER_INVALID_SIGNATURE;
+    }
+    BootManager_Verified(image_address);
+    return SECBOOT_BOOTMANAGER_OK;
+}
+
+
+uint32_t SECBOOT_BootManager_VerifyFirstValid(const uint32_t *pImages, uint32_t count,
+                                              SECBOOT_BOOTMANAGER_StatusTypeDef *pStatus)
+{
+    // One digest for the image at the PKA, one for the image being hashed
+    uint8_t digests[2][FW_HASH_SIZE];
+    uint32_t atPka = count;         // Image whose signature the PKA checks
+    uint32_t chosen = count;
+
+    if (pImages == NULL || pStatus == NULL) {
+        return count;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        pStatus[i] = SECBOOT_BOOTMANAGER_NOT_VERIFIED;
+    }
+
+    for (uint32_t i = 0; i < count && chosen == count; i++) {
+        const FirmwareHeader_TypeDef* pAppHeader = (const FirmwareHeader_TypeDef*)pImages[i];
+        uint8_t *pDigest = digests[i & 1U];
+        bool sealed = false;
+
+        // Header and digest of image i, while the PKA works on image atPka
+        SECBOOT_BOOTMANAGER_StatusTypeDef status = BootManager_PrepareVerify(pImages[i], pDigest, &sealed);
+
+        // The earlier image has precedence over this one
+        if (atPka != count) {
+            pStatus[atPka] = BootManager_FinishSignature(pImages[atPka]);
+            if (pStatus[atPka] == SECBOOT_BOOTMANAGER_OK) {
+                chosen = atPka;
+            }
+            atPka = count;
+        }
+        if (chosen != count) {
+            if (status != SECBOOT_BOOTMANAGER_OK) {
+                pStatus[i] = status;
+            }
+            break;
+        }
+
+        pStatus[i] = status;
+        if (status != SECBOOT_BOOTMANAGER_OK) {
+            continue;
+        }
+        if (sealed) {
+            chosen = i;
+            break;
+        }
+
+        // Signature in the background, chosen by the next round or below
+        if (SECBOOT_ECDSA_Verify_Start(pDigest, (SECBOOT_ECC_Signature*)pAppHeader->signature,
+                                       (SECBOOT_ECC_PublicKey*)ECC_PUBKEY_OFFSET) != SECBOOT_ECDSA_OK) {
+            pStatus[i] = SECBOOT_BOOTMANAGER_INVALID_SIGNATURE;
+            continue;
+        }
+        pStatus[i] = SECBOOT_BOOTMANAGER_NOT_VERIFIED;
+        atPka = i;
+    }
+
+    if (atPka != count) {
+        pStatus[atPka] = BootManager_FinishSignature(pImages[atPka]);
+        if (pStatus[atPka] == SECBOOT_BOOTMANAGER_OK) {
+            chosen = atPka;
+        }
+    }
+
+    memset(digests, 0, sizeof(digests));
+    return chosen;
+}
+
+
+/**
+  * @brief  Plaintext digests of an install in progress
+  * @note   v1: one SHA-256 over the payload. v2: one SHA-256 per block, kept
+  *         until the block table arrives at the end of the stream, then the
+  *         table root; every table byte is matched against the kept digests.
+  */
+typedef struct {
+    FirmwareHeader_TypeDef header;           /**< Copy of the header, GCM AAD (first: word aligned) */
+    SECBOOT_SHA256_Context sha;              /**< Payload, current block or table */
+    uint32_t position;                       /**< Stream offset of the next byte */
+    uint32_t tableOffset;                    /**< v2: stream offset of the block table */
+    bool     tableMismatch;                  /**< v2: a table entry differs from its block */
+    uint8_t  blockDigest[FW_INSTALL_MAX_BLOCKS][FW_HASH_SIZE];  /**< v2: digests of the blocks */
+} BootManager_InstallHashTypeDef;
+
+/**
+  * @brief  Producer of the plaintext stream of an install
+  * @note   Full image: the decrypted source. Delta image: the decrypted
+  *         source is the patch, expanded against the base by the decoder.
+  *         Compressed image: the decrypted source is decompressed.
+  */
+typedef struct {
+    SECBOOT_AES_CipherContext *cipher;       /**< Decrypts the source after its header */
+    SECBOOT_BootManager_FetchFn fetch;       /**< Streamed source, NULL if it is in flash */
+    void *fetchCtx;                          /**< Context for fetch */
+    const uint8_t *pNext;                    /**< Next ciphertext byte in flash */
+    uint32_t remaining;                      /**< Ciphertext bytes not yet decrypted */
+    SECBOOT_Delta_Context *delta;            /**< Delta decoder, NULL if not a delta image */
+    SECBOOT_LZ_Context *lz;                  /**< Decompressor, NULL if not compressed */
+} BootManager_InstallSourceTypeDef;
+
+static uint8_t install_pages[2][FW_INSTALL_CHUNK_SIZE] __ALIGNED(8);
+static BootManager_InstallHashTypeDef install_hash;
+static SECBOOT_Delta_Context install_delta;
+static SECBOOT_LZ_Context install_lz;
+
+
+/**
+  * @brief  Stream bytes after the header of an image: payload, and for v2
+  *         the padded block table
+  */
+static uint32_t BootManager_StreamSize(const FirmwareHeader_TypeDef* pAppHeader)
+{
+    if (pAppHeader->magicNumber == FW_MAGIC_NUMBER_V2) {
+        return FW_BLOCK_TABLE_OFFSET(pAppHeader->imageSize) + (FW_BLOCK_COUNT(pAppHeader->imageSize) * FW_HASH_SIZE);
+    }
+    return pAppHeader->imageSize;
+}
+
+
+/**
+  * @brief  Feed the next plaintext bytes of the stream to the digests
+  */
+static SECBOOT_BOOTMANAGER_StatusTypeDef BootManager_InstallAbsorb(BootManager_InstallHashTypeDef *st, const uint8_t *data, uint32_t length)
+{
+    const FirmwareHeader_TypeDef* pHeader = &st->header;
+
+    while (length > 0) {
+        uint32_t pos = st->position;
+        uint32_t n = length;
+
+        if (pHeader->magicNumber != FW_MAGIC_NUMBER_V2) {
+            if (SECBOOT_SHA256_Update(&st->sha, data, n) != SECBOOT_SHA256_OK) {
+                return SECBOOT_BOOTMANAGER_ERROR;
+            }
+        } else if (pos < pHeader->imageSize) {
+            uint32_t block = pos / FW_BLOCK_SIZE;
+            uint32_t block_end = (block + 1U) * FW_BLOCK_SIZE;
+
+            if (block_end > pHeader->imageSize) {
+                block_end = pHeader->imageSize;
+            }
+            if (n > block_end - pos) {
+                n = block_end - pos;
+            }
+
+            if ((pos % FW_BLOCK_SIZE) == 0 && SECBOOT_SHA256_Start(&st->sha) != SECBOOT_SHA256_OK) {
+                return SECBOOT_BOOTMANAGER_ERROR;
+            }
+            if (SECBOOT_SHA256_Update(&st->sha, data, n) != SECBOOT_SHA256_OK) {
+                return SECBOOT_BOOTMANAGER_ERROR;
+            }
+            if (pos + n == block_end && SECBOOT_SHA256_Final(&st->sha, st->blockDigest[block]) != SECBOOT_SHA256_OK) {
+                return SECBOOT_BOOTMANAGER_ERROR;
+            }
+        } else if (pos < st->tableOffset) {
+            // Double-word padding between payload and table: not signed
+            if (n > st->tableOffset - pos) {
+                n = st->tableOffset - pos;
+            }
+        } else {
+            if (pos == st->tableOffset && SECBOOT_SHA256_Start(&st->sha) != SECBOOT_SHA256_OK) {
+                return SECBOOT_BOOTMANAGER_ERROR;
+            }
+            if (SECBOOT_SHA256_Update(&st->sha, data, n) != SECBOOT_SHA256_OK) {
+                return SECBOOT_BOOTMANAGER_ERROR;
+            }
+            if (memcmp(data, &st->blockDigest[0][0] + (pos - st->tableOffset), n) != 0) {
+                st->tableMismatch = true;
+            }
+        }
+
+        data += n;
+        length -= n;
+        st->position += n;
+    }
+
+    return SECBOOT_BOOTMANAGER_OK;
+}
+
+
+/**
+  * @brief  Hash one decrypted page in slices, keeping the flash writer busy
+  */
+static SECBOOT_BOOTMANAGER_StatusTypeDef BootManager_InstallHashPage(const uint8_t *data, uint32_t length)
+{
+    while (length > 0) {
+        uint32_t slice = (length > FW_INSTALL_SLICE_SIZE) ? FW_INSTALL_SLICE_SIZE : length;
+
+        if (BootManager_InstallAbsorb(&install_hash, data, slice) != SECBOOT_BOOTMANAGER_OK) {
+            return SECBOOT_BOOTMANAGER_ERROR;
+        }
+        if (SECBOOT_FlashWriter_Poll() != SECBOOT_FLASHWRITER_OK) {
+            return SECBOOT_BOOTMANAGER_FLASH_ERROR;
+        }
+
+        data += slice;
+        length -= slice;
+    }
+
+    return SECBOOT_BOOTMANAGER_OK;
+}
+
+
+/**
+  * @brief  Decrypt the next bytes of the source
+  */
+static bool BootManager_InstallDecrypt(BootManager_InstallSourceTypeDef *pSource, uint8_t *pData, uint32_t length)
+{
+    const uint8_t *pCipher = pSource->pNext;
+
+    if (length > pSource->remaining) {
+        return false;
+    }
+    // A streamed source is decrypted in place
+    if (pSource->fetch != NULL) {
+        if (!pSource->fetch(pSource->fetchCtx, pData, length)) {
+            return false;
+        }
+        pCipher = pData;
+    }
+    if (SECBOOT_AES_CipherUpdate(pSource->cipher, pCipher, length, pData) != SECBOOT_AES_OK) {
+        return false;
+    }
+
+    pSource->pNext += length;
+    pSource->remaining -= length;
+    return true;
+}
+
+
+/**
+  * @brief  Delta decoder input: the decrypted patch
+  */
+static SECBOOT_Delta_StatusTypeDef BootManager_InstallReadPatch(void *source, uint8_t *pData, uint32_t length)
+{
+    return BootManager_InstallDecrypt((BootManager_InstallSourceTypeDef*)source, pData, length) ?
+           SECBOOT_DELTA_OK : SECBOOT_DELTA_READ_ERROR;
+}
+
+
+/**
+  * @brief  Decompressor input: the decrypted compressed stream
+  */
+static SECBOOT_LZ_StatusTypeDef BootManager_InstallReadCompressed(void *source, uint8_t *pData, uint32_t length)
+{
+    return BootManager_InstallDecrypt((BootManager_InstallSourceTypeDef*)source, pData, length) ?
+           SECBOOT_LZ_OK : SECBOOT_LZ_READ_ERROR;
+}
+
+
+/**
+  * @brief  Produce the next plaintext bytes of the stream
+  */
+static SECBOOT_BOOTMANAGER_StatusTypeDef BootManager_InstallProduce(BootManager_InstallSourceTypeDef *pSource,
+                                                                    uint8_t *pData, uint32_t length)
+{
+    if (pSource->delta != NULL) {
+        switch (SECBOOT_Delta_Output(pSource->delta, pData, length)) {
+            case SECBOOT_DELTA_OK:         return SECBOOT_BOOTMANAGER_OK;
+            case SECBOOT_DELTA_READ_ERROR: return SECBOOT_BOOTMANAGER_DECRYPTION_ERROR;
+            default:                       return SECBOOT_BOOTMANAGER_INVALID_HASH;  // Patch cannot rebuild the image
+        }
+    }
+
+    if (pSource->lz != NULL) {
+        switch (SECBOOT_LZ_Output(pSource->lz, pData, length)) {
+            case SECBOOT_LZ_OK:            return SECBOOT_BOOTMANAGER_OK;
+            case SECBOOT_LZ_READ_ERROR:    return SECBOOT_BOOTMANAGER_DECRYPTION_ERROR;
+            default:                       return SECBOOT_BOOTMANAGER_INVALID_HASH;  // Not the signed image
+        }
+    }
+
+    return BootManager_InstallDecrypt(pSource, pData, length) ?
+           SECBOOT_BOOTMANAGER_OK : SECBOOT_BOOTMANAGER_DECRYPTION_ERROR;
+}
+
+
+/**
+  * @brief  Wipe the decoder state of an install
+  */
+static void BootManager_InstallWipeDecoders(void)
+{
+    memset(&install_delta, 0, sizeof(install_delta));
+    memset(&install_lz, 0, sizeof(install_lz));
+}
+
+
+/**
+  * @brief  Produce, hash and program the stream of an image
+  * @note   install_pages[0] already holds the destination header. Each
+  *         page is produced (decrypted, or rebuilt from a delta) while the
+  *         flash is idle (source and base share bank 2 with every slot),
+  *         then hashed in slices while the other page buffer is being
+  *         programmed.
+  * @param  size  Destination image size: header and stream
+  */
+static SECBOOT_BOOTMANAGER_StatusTypeDef BootManager_InstallStream(BootManager_InstallSourceTypeDef *pSource,
+                                                                   uint32_t destAddr, uint32_t size)
+{
+    SECBOOT_BOOTMANAGER_StatusTypeDef status;
+    uint32_t remaining = size - SECBOOT_FW_HEADER_SIZE;
+    uint32_t page = 0;
+    bool writer_open = false;
+
+    while (remaining > 0) {
+        uint8_t *pBuffer = install_pages[page % 2U];
+        uint32_t offset = (page == 0) ? SECBOOT_FW_HEADER_SIZE : 0U;
+        uint32_t chunk = FW_INSTALL_CHUNK_SIZE - offset;
+        uint32_t padded;
+
+        if (chunk > remaining) {
+            chunk = remaining;
+        }
+
+        if (writer_open && SECBOOT_FlashWriter_Settle() != SECBOOT_FLASHWRITER_OK) {
+            return SECBOOT_BOOTMANAGER_FLASH_ERROR;
+        }
+        status = BootManager_InstallProduce(pSource, pBuffer + offset, chunk);
+        if (status != SECBOOT_BOOTMANAGER_OK) {
+            return status;
+        }
+
+        // The destination is only erased once the first page is ready
+        if (!writer_open) {
+            if (SECBOOT_FlashWriter_Open(destAddr, size) != SECBOOT_FLASHWRITER_OK) {
+                return SECBOOT_BOOTMANAGER_FLASH_ERROR;
+            }
+            writer_open = true;
+        }
+
+        if (BootManager_InstallHashPage(pBuffer + offset, chunk) != SECBOOT_BOOTMANAGER_OK) {
+            return SECBOOT_BOOTMANAGER_ERROR;
+        }
+
+        padded = (offset + chunk + 7U) & ~7U;
+        memset(pBuffer + offset + chunk, 0xFF, padded - (offset + chunk));
+
+        if (SECBOOT_FlashWriter_Queue(pBuffer, padded) != SECBOOT_FLASHWRITER_OK ||
+            SECBOOT_FlashWriter_WaitSlot() != SECBOOT_FLASHWRITER_OK) {
+            return SECBOOT_BOOTMANAGER_FLASH_ERROR;
+        }
+
+        remaining -= chunk;
+        page++;
+    }
+
+    if (SECBOOT_FlashWriter_Close() != SECBOOT_FLASHWRITER_OK) {
+        return SECBOOT_BOOTMANAGER_FLASH_ERROR;
+    }
+    return SECBOOT_BOOTMANAGER_OK;
+}
+
+
+/**
+  * @brief  Install a full or delta update image
+  * @param  srcAddr   Update image in flash, 0 when fetch streams it
+  * @param  fetch     Streamed update image, NULL when it is at srcAddr
+  * @param  baseAddr  Header address of the image a delta applies to, 0 to
+  *                   accept full images only
+  * @note   See SECBOOT_BootManager_FlashFirmware
+  */
+static SECBOOT_BOOTMANAGER_StatusTypeDef BootManager_Install(uint32_t srcAddr, SECBOOT_BootManager_FetchFn fetch,
+                                                             void *fetchCtx, uint32_t baseAddr, uint32_t destAddr,
+                                                             uint32_t size, const uint8_t* key, const uint8_t* iv)
+{
+    const FirmwareHeader_TypeDef* pHeader = &install_hash.header;
+    FirmwareDelta_TypeDef* pDelta = (FirmwareDelta_TypeDef*)(install_pages[0] + FW_DELTA_INFO_OFFSET);
+    FirmwareCompression_TypeDef* pComp = (FirmwareCompression_TypeDef*)(install_pages[0] + FW_COMP_INFO_OFFSET);
+    FirmwareEncryption_TypeDef* pEnc = (FirmwareEncryption_TypeDef*)(install_pages[0] + FW_ENC_INFO_OFFSET);
+    BootManager_InstallSourceTypeDef source = {0};
+    SECBOOT_AES_CipherContext cipher;
+    SECBOOT_BOOTMANAGER_StatusTypeDef status;
+    uint8_t tag[AES_GCM_TAG_SIZE];
+    uint8_t digest[FW_HASH_SIZE];
+    uint32_t stream_size;
+    uint32_t region_size;
+    uint64_t commit;
+    bool is_delta;
+    bool is_compressed;
+
+    if (key == NULL || (srcAddr == 0) == (fetch == NULL) || size <= SECBOOT_FW_HEADER_SIZE) {
+        return SECBOOT_BOOTMANAGER_ERROR;
+    }
+
+    // 1. Work on RAM copies of the header: one is checked and authenticated,
+    //    the other becomes the start of page 0 of the destination. A
+    //    streamed header is all there is until the payload is fetched.
+    if (fetch != NULL) {
+        if (!fetch(fetchCtx, install_pages[0], SECBOOT_FW_HEADER_SIZE)) {
+            return SECBOOT_BOOTMANAGER_ERROR;
+        }
+    } else {
+        memcpy(install_pages[0], (const uint8_t*)srcAddr, SECBOOT_FW_HEADER_SIZE);
+    }
+    memset(&install_hash, 0, sizeof(install_hash));
+    memcpy(&install_hash.header, install_pages[0], sizeof(FirmwareHeader_TypeDef));
+
+    status = BootManager_CheckHeaderFor(pHeader, destAddr);
+    if (status != SECBOOT_BOOTMANAGER_OK) {
+        return status;
+    }
+
+    if (pHeader->magicNumber == FW_MAGIC_NUMBER_V2 && FW_BLOCK_COUNT(pHeader->imageSize) > FW_INSTALL_MAX_BLOCKS) {
+        return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+    }
+    stream_size = BootManager_StreamSize(pHeader);
+
+    // A delta carries a patch instead of the stream; its base is read in place
+    is_delta = (pDelta->magic == FW_DELTA_MAGIC);
+    is_compressed = (pComp->magic == FW_COMP_MAGIC_LZSS);
+    if (is_delta && is_compressed) {
+        return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+    }
+    if (is_delta) {
+        const FirmwareHeader_TypeDef* pBase = (const FirmwareHeader_TypeDef*)baseAddr;
+
+        if (baseAddr == 0 || size != SECBOOT_FW_HEADER_SIZE + pDelta->patchSize) {
+            return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+        }
+        status = SECBOOT_BootManager_CheckHeader(baseAddr);
+        if (status != SECBOOT_BOOTMANAGER_OK) {
+            return status;
+        }
+        if (memcmp(pDelta->baseHash, pBase->firmwareHash, FW_HASH_SIZE) != 0) {
+            return SECBOOT_BOOTMANAGER_DELTA_BASE_MISMATCH;
+        }
+        region_size = SECBOOT_FW_HEADER_SIZE + BootManager_StreamSize(pBase);
+        if (baseAddr < destAddr + BootManager_SlotSize(destAddr) && destAddr < baseAddr + region_size) {
+            return SECBOOT_BOOTMANAGER_ERROR;
+        }
+    } else if (is_compressed) {
+        if (size != SECBOOT_FW_HEADER_SIZE + pComp->compressedSize) {
+            return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+        }
+    } else if (size != SECBOOT_FW_HEADER_SIZE + stream_size) {
+        return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+    }
+    if (pEnc->magic != FW_ENC_MAGIC || (pEnc->mode != SECBOOT_AES_MODE_CTR && pEnc->mode != SECBOOT_AES_MODE_GCM)) {
+        return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+    }
+
+    // The source must survive until its last page is decrypted
+    region_size = ((SECBOOT_FW_HEADER_SIZE + stream_size + FLASH_PAGE_SIZE - 1U) / FLASH_PAGE_SIZE) * FLASH_PAGE_SIZE;
+    if (fetch == NULL && srcAddr < destAddr + region_size && destAddr < srcAddr + size) {
+        return SECBOOT_BOOTMANAGER_ERROR;
+    }
+
+    // 2. Reject unsigned images before the destination is touched (and,
+    //    streamed, before any payload is fetched)
+    memcpy(digest, pHeader->firmwareHash, FW_HASH_SIZE);
+    status = BootManager_VerifyRootSignature(pHeader, digest);
+    if (status != SECBOOT_BOOTMANAGER_OK) {
+        return status;
+    }
+
+    if (SECBOOT_AES_CipherInit(&cipher, (SECBOOT_AES_ModeTypeDef)pEnc->mode, key, FW_UPDATE_KEY_SIZE,
+                               (iv != NULL) ? iv : pEnc->iv,
+                               (const uint8_t*)pHeader, sizeof(FirmwareHeader_TypeDef)) != SECBOOT_AES_OK) {
+        return SECBOOT_BOOTMANAGER_DECRYPTION_ERROR;
+    }
+
+    source.cipher = &cipher;
+    source.fetch = fetch;
+    source.fetchCtx = fetchCtx;
+    source.pNext = (const uint8_t*)(srcAddr + SECBOOT_FW_HEADER_SIZE);
+    source.remaining = size - SECBOOT_FW_HEADER_SIZE;
+    if (is_delta) {
+        const FirmwareHeader_TypeDef* pBase = (const FirmwareHeader_TypeDef*)baseAddr;
+
+        // Relocation: both images are linked for their own slot
+        if (SECBOOT_Delta_Init(&install_delta, (const uint8_t*)pBase->entryPoint, BootManager_StreamSize(pBase),
+                               pHeader->entryPoint - pBase->entryPoint, BootManager_InstallReadPatch, &source,
+                               pDelta->patchSize) != SECBOOT_DELTA_OK) {
+            SECBOOT_AES_CipherAbort(&cipher);
+            return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+        }
+        source.delta = &install_delta;
+    }
+    if (is_compressed) {
+        if (SECBOOT_LZ_Init(&install_lz, BootManager_InstallReadCompressed, &source,
+                            pComp->compressedSize) != SECBOOT_LZ_OK) {
+            SECBOOT_AES_CipherAbort(&cipher);
+            return SECBOOT_BOOTMANAGER_INVALID_HEADER;
+        }
+        source.lz = &install_lz;
+    }
+
+    // 3. The installed header carries no delta, compression or encryption
+    //    descriptor, and its first double-word stays erased until the image
+    //    is accepted
+    memcpy(tag, pEnc->tag, sizeof(tag));
+    memset(pDelta, 0xFF, sizeof(FirmwareDelta_TypeDef));
+    memset(pComp, 0xFF, sizeof(FirmwareCompression_TypeDef));
+    memset(pEnc, 0xFF, sizeof(FirmwareEncryption_TypeDef));
+    memcpy(&commit, install_pages[0], sizeof(commit));
+    memset(install_pages[0], 0xFF, sizeof(commit));
+
+    install_hash.tableOffset = FW_BLOCK_TABLE_OFFSET(pHeader->imageSize);
+    if (pHeader->magicNumber != FW_MAGIC_NUMBER_V2 && SECBOOT_SHA256_Start(&install_hash.sha) != SECBOOT_SHA256_OK) {
+        SECBOOT_AES_CipherAbort(&cipher);
+        BootManager_InstallWipeDecoders();
+        return SECBOOT_BOOTMANAGER_ERROR;
+    }
+
+    if (SECBOOT_Seal_Invalidate(destAddr) != SECBOOT_SEAL_OK) {
+        SECBOOT_SHA256_Abort(&install_hash.sha);
+        SECBOOT_AES_CipherAbort(&cipher);
+        BootManager_InstallWipeDecoders();
+        return SECBOOT_BOOTMANAGER_FLASH_ERROR;
+    }
+
+    // 4. Decrypt (and rebuild or decompress), hash and program in one pass
+    status = BootManager_InstallStream(&source, destAddr, SECBOOT_FW_HEADER_SIZE + stream_size);
+    if (status != SECBOOT_BOOTMANAGER_OK) {
+        SECBOOT_FlashWriter_Abort();
+        SECBOOT_SHA256_Abort(&install_hash.sha);
+        SECBOOT_AES_CipherAbort(&cipher);
+        memset(install_pages, 0, sizeof(install_pages));
+        BootManager_InstallWipeDecoders();
+        return status;
+    }
+
+    // 5. The whole patch or compressed stream must have been used (and
+    //    decrypted, for the tag)
+    if (is_delta && SECBOOT_Delta_Finish(&install_delta) != SECBOOT_DELTA_OK) {
+        status = SECBOOT_BOOTMANAGER_INVALID_HASH;
+    }
+    if (is_compressed && SECBOOT_LZ_Finish(&install_lz) != SECBOOT_LZ_OK) {
+        status = SECBOOT_BOOTMANAGER_INVALID_HASH;
+    }
+
+    // 6. Signed digest (v1 payload hash, v2 table root and blocks) and GCM tag
+    if (SECBOOT_SHA256_Final(&install_hash.sha, digest) != SECBOOT_SHA256_OK) {
+        status = SECBOOT_BOOTMANAGER_ERROR;
+    } else if (status == SECBOOT_BOOTMANAGER_OK &&
+               (memcmp(digest, pHeader->firmwareHash, FW_HASH_SIZE) != 0 || install_hash.tableMismatch)) {
+        status = SECBOOT_BOOTMANAGER_INVALID_HASH;
+    }
+
+    if (SECBOOT_AES_CipherFinal(&cipher, tag) != SECBOOT_AES_OK && status == SECBOOT_BOOTMANAGER_OK) {
+        status = SECBOOT_BOOTMANAGER_DECRYPTION_ERROR;
+    }
+
+    memset(digest, 0, sizeof(digest));
+    memset(install_pages, 0, sizeof(install_pages));
+    memset(&install_hash, 0, sizeof(install_hash));
+
+    if (status != SECBOOT_BOOTMANAGER_OK) {
+        return status;
+    }
+
+    // 7. Commit: the magic makes the image visible to CheckHeader
+    HAL_FLASH_Unlock();
+    if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD_NS, destAddr, commit) != HAL_OK) {
+        HAL_FLASH_Lock();
+        return SECBOOT_BOOTMANAGER_FLASH_ERROR;
+    }
+    HAL_FLASH_Lock();
+
+#if SECBOOT_ENABLE_FAST_BOOT
+    // Best effort: a failed seal only costs a full verification next boot
+    (void)SECBOOT_Seal_Record(destAddr);
+#endif
+
+    return SECBOOT_BOOTMANAGER_OK;
+}
+
+
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_FlashFirmware(
+    uint32_t srcAddr,
+    uint32_t destAddr,
+    uint32_t size,
+    const uint8_t* key,
+    const uint8_t* iv)
+{
+    return BootManager_Install(srcAddr, NULL, NULL, 0, destAddr, size, key, iv);
+}
+
+
+/**
+  * @brief  A/B update from flash or from a stream
+  */
+static SECBOOT_BOOTMANAGER_StatusTypeDef BootManager_Update(uint32_t srcAddr, SECBOOT_BootManager_FetchFn fetch,
+                                                            void *fetchCtx, uint32_t size, const uint8_t* key)
+{
+    SECBOOT_Slots_StateTypeDef slots;
+    SECBOOT_BOOTMANAGER_StatusTypeDef status;
+    uint32_t target;
+
+    if (SECBOOT_Slots_Read(&slots) != SECBOOT_SLOTS_OK) {
+        return SECBOOT_BOOTMANAGER_ERROR;
+    }
+
+    // 1. Install into the slot that is not running; until the promotion
+    //    below the slot state still boots the current image, which is also
+    //    the base of a delta image
+    target = SECBOOT_Slots_Inactive(&slots);
+    status = BootManager_Install(srcAddr, fetch, fetchCtx, slots.active, target, size, key, NULL);
+    if (status != SECBOOT_BOOTMANAGER_OK) {
+        return status;
+    }
+
+    // 2. Promote: one record, the current image becomes the fallback
+    if (SECBOOT_Slots_Activate(target) != SECBOOT_SLOTS_OK) {
+        return SECBOOT_BOOTMANAGER_FLASH_ERROR;
+    }
+
+    return SECBOOT_BOOTMANAGER_OK;
+}
+
+
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_UpdateFirmware(uint32_t srcAddr, uint32_t size, const uint8_t* key)
+{
+    if (srcAddr == 0) {
+        return SECBOOT_BOOTMANAGER_ERROR;
+    }
+    return BootManager_Update(srcAddr, NULL, NULL, size, key);
+}
+
+
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_UpdateFirmwareStream(uint32_t size, const uint8_t* key,
+                                                                           SECBOOT_BootManager_FetchFn fetch, void *ctx)
+{
+    if (fetch == NULL) {
+        return SECBOOT_BOOTMANAGER_ERROR;
+    }
+    return BootManager_Update(0, fetch, ctx, size, key);
+}
+
+
+/**
+  * @brief  Erase the non-secure flash page holding address
+  */
+static SECBOOT_BOOTMANAGER_StatusTypeDef BootManager_ErasePage(uint32_t address)
+{
+    FLASH_EraseInitTypeDef erase = {0};
+    uint32_t offset = (address & ~(FLASH_PAGE_SIZE - 1U)) - FLASH_BASE_NS;
+    uint32_t page_error = 0;
+    HAL_StatusTypeDef hal_status;
+
+    erase.TypeErase = FLASH_TYPEERASE_PAGES_NS;
+    erase.Banks = (offset < FLASH_BANK_SIZE) ? FLASH_BANK_1 : FLASH_BANK_2;
+    erase.Page = (offset % FLASH_BANK_SIZE) / FLASH_PAGE_SIZE;
+    erase.NbPages = 1;
+
+    HAL_FLASH_Unlock();
+    hal_status = HAL_FLASHEx_Erase(&erase, &page_error);
+    HAL_FLASH_Lock();
+
+    return (hal_status == HAL_OK) ? SECBOOT_BOOTMANAGER_OK : SECBOOT_BOOTMANAGER_FLASH_ERROR;
+}
+
+
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_UpdateStaged(const uint8_t* key)
+{
+    const FirmwareHeader_TypeDef* pHeader = (const FirmwareHeader_TypeDef*)SECBOOT_UPDATE_SLOT_ADDR;
+    const FirmwareDelta_TypeDef* pDelta = (const FirmwareDelta_TypeDef*)(SECBOOT_UPDATE_SLOT_ADDR + FW_DELTA_INFO_OFFSET);
+    const FirmwareCompression_TypeDef* pComp = (const FirmwareCompression_TypeDef*)(SECBOOT_UPDATE_SLOT_ADDR + FW_COMP_INFO_OFFSET);
+    const FirmwareHeader_TypeDef* pActive;
+    SECBOOT_Slots_StateTypeDef slots;
+    SECBOOT_BOOTMANAGER_StatusTypeDef status;
+    uint32_t size;
+
+    // 1. Nothing staged
+    if (pHeader->magicNumber != FW_MAGIC_NUMBER && pHeader->magicNumber != FW_MAGIC_NUMBER_V2) {
+        return SECBOOT_BOOTMANAGER_OK;
+    }
+    if (SECBOOT_Slots_Read(&slots) != SECBOOT_SLOTS_OK) {
+        return SECBOOT_BOOTMANAGER_ERROR;
+    }
+    pActive = (const FirmwareHeader_TypeDef*)slots.active;
+
+    // 2. The staged image runs already: the power failed between its
+    //    promotion and the erase below
+    if (memcmp(pHeader->firmwareHash, pActive->firmwareHash, FW_HASH_SIZE) == 0) {
+        return (BootManager_ErasePage(SECBOOT_UPDATE_SLOT_ADDR) == SECBOOT_BOOTMANAGER_OK) ?
+               SECBOOT_BOOTMANAGER_OK : SECBOOT_BOOTMANAGER_FLASH_ERROR;
+    }
+
+    // 3. Only a newer image replaces the active one. An older one would
+    //    undo an update that arrived another way (UART), or put back an
+    //    image that was reverted. Versions compare major byte first.
+    if (memcmp(pHeader->version, pActive->version, FW_VERSION_SIZE) <= 0) {
+        status = SECBOOT_BOOTMANAGER_VERSION_ROLLBACK;
+    } else {
+        // Size of the update image; the install checks it against the
+        // header again, this only bounds it by the update slot
+        if (pDelta->magic == FW_DELTA_MAGIC) {
+            size = SECBOOT_FW_HEADER_SIZE + pDelta->patchSize;
+        } else if (pComp->magic == FW_COMP_MAGIC_LZSS) {
+            size = SECBOOT_FW_HEADER_SIZE + pComp->compressedSize;
+        } else {
+            size = SECBOOT_FW_HEADER_SIZE + BootManager_StreamSize(pHeader);
+        }
+        if (size <= SECBOOT_FW_HEADER_SIZE || size > SECBOOT_UPDATE_SLOT_SIZE) {
+            status = SECBOOT_BOOTMANAGER_INVALID_HEADER;
+        } else {
+            status = SECBOOT_BootManager_UpdateFirmware(SECBOOT_UPDATE_SLOT_ADDR, size, key);
+        }
+    }
+
+    // 4. Retire the image, installed or refused: erasing its header page
+    //    keeps it from being installed again at a later boot. A power loss
+    //    during the install leaves it staged, and the next boot retries.
+    if (BootManager_ErasePage(SECBOOT_UPDATE_SLOT_ADDR) != SECBOOT_BOOTMANAGER_OK &&
+        status == SECBOOT_BOOTMANAGER_OK) {
+        status = SECBOOT_BOOTMANAGER_FLASH_ERROR;
+    }
+    return status;
+}
+
+
+/**
+  * @brief  Store a word as four bytes, most significant first
+  */
+static void BootManager_StoreBE(uint32_t word, uint8_t *pOut)
+{
+    pOut[0] = (uint8_t)(word >> 24);
+    pOut[1] = (uint8_t)(word >> 16);
+    pOut[2] = (uint8_t)(word >> 8);
+    pOut[3] = (uint8_t)word;
+}
+
+
+SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_GetUpdateKey(uint8_t* key)
+{
+    AES_Secrets_TypeDef secrets = {0};
+    volatile uint8_t *pWipe = (volatile uint8_t*)&secrets;
+    SECBOOT_BOOTMANAGER_StatusTypeDef status = SECBOOT_BOOTMANAGER_DECRYPTION_ERROR;
+
+    if (key == NULL) {
+        return SECBOOT_BOOTMANAGER_ERROR;
+    }
+
+    // get_AES_key leaves the key as big-endian words
+    if (get_AES_key(&secrets) == SECBOOT_AES_OK) {
+        for (size_t i = 0; i < FW_UPDATE_KEY_SIZE / sizeof(uint32_t); i++) {
+            BootManager_StoreBE(secrets.AES_key[i], &key[4U * i]);
+        }
+        status = SECBOOT_BOOTMANAGER_OK;
+    }
+
+    for (size_t i = 0; i < sizeof(secrets); i++) {
+        pWipe[i] = 0x00;
+    }
+    return status;
+}
+
+
 SECBOOT_BOOTMANAGER_StatusTypeDef SECBOOT_BootManager_JumpTo(uint32_t jump_to_address)
 {
 
     funcptr_NS NonSecureApp_ResetHandler;
-    
+
+    /* 1. Write out the events of this boot while the secure world still runs */
+    SECBOOT_Diag_Flush();
+
     /* 2. Get pointer to application header in flash */
     const FirmwareHeader_TypeDef* pAppHeader = (const FirmwareHeader_TypeDef*)jump_to_address;
 
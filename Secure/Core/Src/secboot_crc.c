@@ -4,10 +4,21 @@
   * @author  Soulaimane Oulad Belayachi
   * @date    2025-06-12
   * @version 1.0
-  * @note    Uses STM32 hardware CRC peripheral for fast integrity checks
+  * @note    Uses STM32 hardware CRC peripheral for fast integrity checks.
+  *          The unit shifts each 32-bit write MSB first, so a byte-swapped
+  *          word gives the same CRC as its four bytes in stream order.
+  *          Every calculation restarts the unit from its seed through the
+  *          INIT register: no state is carried in DR between calls.
   */
 
 #include "secboot_crc.h"
+#include "secboot_config.h"
+#include "secboot_crc32.h"
+#include <string.h>
+
+#if SECBOOT_CRC_ENGINE == SECBOOT_CRC_ENGINE_HW
+
+#define CRC_STAGE_WORDS  128U   ///< Words byte-swapped per block (512 bytes)
 
 /* Private variables ---------------------------------------------------------*/
 
@@ -17,6 +28,117 @@
   */
 static CRC_HandleTypeDef hcrc;
 
+static DMA_HandleTypeDef hdma_crc;                ///< Memory-to-memory feed of DR
+static bool dmaReady = false;
+static uint32_t stage[2][CRC_STAGE_WORDS];        ///< Swapped blocks: one fed, one filled
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Bind the memory-to-memory DMA channel to the CRC data register
+  */
+static bool CRC_DmaInit(void)
+{
+    __HAL_RCC_DMAMUX1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    // In memory-to-memory mode the "peripheral" side is the source
+    hdma_crc.Instance = SECBOOT_CRC_DMA_CHANNEL;
+    hdma_crc.Init.Request = DMA_REQUEST_MEM2MEM;
+    hdma_crc.Init.Direction = DMA_MEMORY_TO_MEMORY;
+    hdma_crc.Init.PeriphInc = DMA_PINC_ENABLE;
+    hdma_crc.Init.MemInc = DMA_MINC_DISABLE;
+    hdma_crc.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    hdma_crc.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdma_crc.Init.Mode = DMA_NORMAL;
+    hdma_crc.Init.Priority = DMA_PRIORITY_HIGH;
+    if (HAL_DMA_Init(&hdma_crc) != HAL_OK) {
+        return false;
+    }
+    return HAL_DMA_ConfigChannelAttributes(&hdma_crc, DMA_CHANNEL_PRIV | DMA_CHANNEL_SEC | DMA_CHANNEL_SRC_SEC |
+                                                      DMA_CHANNEL_DEST_SEC) == HAL_OK;
+}
+
+/**
+  * @brief  Byte-swap the next words of the stream into a stage block
+  */
+static void CRC_Stage(uint32_t *pStage, const uint8_t *pData, uint32_t words)
+{
+    for (uint32_t i = 0; i < words; i++) {
+        uint32_t word;
+
+        memcpy(&word, &pData[4U * i], sizeof(word));
+        pStage[i] = __REV(word);
+    }
+}
+
+/**
+  * @brief  CRC of a buffer on the unit, starting from seed
+  * @note   The first block is fed by the core and restarts the unit; the
+  *         next blocks go by DMA for long buffers, each swapped while the
+  *         previous one is in flight. The last 1-3 bytes are fed in byte
+  *         format.
+  */
+static SECBOOT_CRC_StatusTypeDef CRC_Feed(uint32_t seed, const uint8_t *pData, uint32_t length, uint32_t *pCrc)
+{
+    uint32_t words = length / 4U;
+    uint32_t block = (words < CRC_STAGE_WORDS) ? words : CRC_STAGE_WORDS;
+    uint32_t tail = length % 4U;
+    bool dma = dmaReady && length >= SECBOOT_CRC_DMA_MIN_SIZE;
+    bool inFlight = false;
+    uint32_t next = 1U;
+    uint32_t crc;
+
+    CRC_Stage(stage[0], pData, block);
+    WRITE_REG(hcrc.Instance->INIT, seed);
+    crc = HAL_CRC_Calculate(&hcrc, stage[0], block);
+    WRITE_REG(hcrc.Instance->INIT, SECBOOT_CRC32_INIT_VALUE);
+    pData += 4U * block;
+    words -= block;
+
+    while (words > 0U) {
+        block = (words < CRC_STAGE_WORDS) ? words : CRC_STAGE_WORDS;
+        CRC_Stage(stage[next], pData, block);
+
+        if (!dma) {
+            crc = HAL_CRC_Accumulate(&hcrc, stage[next], block);
+        } else {
+            if (inFlight && HAL_DMA_PollForTransfer(&hdma_crc, HAL_DMA_FULL_TRANSFER,
+                                                    SECBOOT_CRC_DMA_TIMEOUT_MS) != HAL_OK) {
+                (void)HAL_DMA_Abort(&hdma_crc);
+                return SECBOOT_CRC_ERROR;
+            }
+            if (HAL_DMA_Start(&hdma_crc, (uint32_t)stage[next], (uint32_t)&hcrc.Instance->DR, block) != HAL_OK) {
+                return SECBOOT_CRC_ERROR;
+            }
+            inFlight = true;
+        }
+
+        next ^= 1U;
+        pData += 4U * block;
+        words -= block;
+    }
+
+    if (inFlight) {
+        if (HAL_DMA_PollForTransfer(&hdma_crc, HAL_DMA_FULL_TRANSFER, SECBOOT_CRC_DMA_TIMEOUT_MS) != HAL_OK) {
+            (void)HAL_DMA_Abort(&hdma_crc);
+            return SECBOOT_CRC_ERROR;
+        }
+        crc = READ_REG(hcrc.Instance->DR);
+    }
+
+    if (tail > 0U) {
+        hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
+        crc = HAL_CRC_Accumulate(&hcrc, (uint32_t*)(uintptr_t)pData, tail);
+        hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_WORDS;
+    }
+
+    *pCrc = crc;
+    return SECBOOT_CRC_OK;
+}
+
+#endif /* SECBOOT_CRC_ENGINE == SECBOOT_CRC_ENGINE_HW */
+
 /* Function implementations --------------------------------------------------*/
 
 /**
@@ -26,23 +148,27 @@ static CRC_HandleTypeDef hcrc;
   *         - Default polynomial (0x04C11DB7)
   *         - Default initial value (0xFFFFFFFF)
   *         - No data inversion
-  *         - Byte input format
+  *         - Word input format
+  *         and the DMA channel; without it every buffer is fed by the core
   */
 SECBOOT_CRC_StatusTypeDef SECBOOT_CRC_Init(void)
 {
+#if SECBOOT_CRC_ENGINE == SECBOOT_CRC_ENGINE_HW
     /* Configure CRC peripheral settings */
     hcrc.Instance = CRC;
     hcrc.Init.DefaultPolynomialUse = DEFAULT_POLYNOMIAL_ENABLE;
     hcrc.Init.DefaultInitValueUse = DEFAULT_INIT_VALUE_ENABLE;
     hcrc.Init.InputDataInversionMode = CRC_INPUTDATA_INVERSION_NONE;
     hcrc.Init.OutputDataInversionMode = CRC_OUTPUTDATA_INVERSION_DISABLE;
-    hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
+    hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_WORDS;
 
     /* Initialize CRC peripheral */
     if (HAL_CRC_Init(&hcrc) != HAL_OK) {
         return SECBOOT_CRC_INIT_FAILED;
     }
-    
+
+    dmaReady = CRC_DmaInit();
+#endif
     return SECBOOT_CRC_OK;
 }
 
@@ -66,14 +192,13 @@ SECBOOT_CRC_StatusTypeDef SECBOOT_CRC_Calculate(
         return SECBOOT_CRC_INVALID_PARAM;
     }
 
+#if SECBOOT_CRC_ENGINE == SECBOOT_CRC_ENGINE_HW
     /* Compute CRC using hardware accelerator */
-    *pCrcResult = HAL_CRC_Calculate(
-        &hcrc, 
-        (uint32_t*)pData, 
-        dataLength
-    );
-    
+    return CRC_Feed(SECBOOT_CRC32_INIT_VALUE, pData, dataLength, pCrcResult);
+#else
+    *pCrcResult = SECBOOT_CRC32_Calculate(pData, dataLength);
     return SECBOOT_CRC_OK;
+#endif
 }
 
 /**
@@ -126,12 +251,11 @@ SECBOOT_CRC_StatusTypeDef SECBOOT_CRC_Calculate_Chunk(
         return SECBOOT_CRC_INVALID_PARAM;
     }
 
-    /* Compute CRC for this chunk */
-    *currentCrc = HAL_CRC_Accumulate(
-        &hcrc, 
-        (uint32_t*)pData, 
-        dataLength
-    );
-    
+#if SECBOOT_CRC_ENGINE == SECBOOT_CRC_ENGINE_HW
+    /* Continue from the caller's value, not from what the unit holds */
+    return CRC_Feed(*currentCrc, pData, dataLength, currentCrc);
+#else
+    *currentCrc = SECBOOT_CRC32_Accumulate(*currentCrc, pData, dataLength);
     return SECBOOT_CRC_OK;
-}
\ No newline at end of file
+#endif
+}
@@ -0,0 +1,403 @@
+/**
+  * @file    secboot_crc32.c
+  * @brief   Software CRC-32 of the STM32 CRC unit convention
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    MSB first: the first byte of a step is folded into the top of
+  *          the register, so each step XORs the next four bytes in as a
+  *          big-endian word. Byte loads keep it endian- and
+  *          alignment-neutral.
+  */
+
+#include "secboot_crc32.h"
+
+/* Slicing tables, from Script/stm32_crc_table.py ----------------------------*/
+
+static const uint32_t crc32_table[SECBOOT_CRC32_SLICES][256] = {
+    { /* T0 */
+        0x00000000U, 0x04C11DB7U, 0x09823B6EU, 0x0D4326D9U, 0x130476DCU, 0x17C56B6BU,
+        0x1A864DB2U, 0x1E475005U, 0x2608EDB8U, 0x22C9F00FU, 0x2F8AD6D6U, 0x2B4BCB61U,
+        0x350C9B64U, 0x31CD86D3U, 0x3C8EA00AU, 0x384FBDBDU, 0x4C11DB70U, 0x48D0C6C7U,
+        0x4593E01EU, 0x4152FDA9U, 0x5F15ADACU, 0x5BD4B01BU, 0x569796C2U, 0x52568B75U,
+        0x6A1936C8U, 0x6ED82B7FU, 0x639B0DA6U, 0x675A1011U, 0x791D4014U, 0x7DDC5DA3U,
+        0x709F7B7AU, 0x745E66CDU, 0x9823B6E0U, 0x9CE2AB57U, 0x91A18D8EU, 0x95609039U,
+        0x8B27C03CU, 0x8FE6DD8BU, 0x82A5FB52U, 0x8664E6E5U, 0xBE2B5B58U, 0xBAEA46EFU,
+        0xB7A96036U, 0xB3687D81U, 0xAD2F2D84U, 0xA9EE3033U, 0xA4AD16EAU, 0xA06C0B5DU,
+        0xD4326D90U, 0xD0F37027U, 0xDDB056FEU, 0xD9714B49U, 0xC7361B4CU, 0xC3F706FBU,
+        0xCEB42022U, 0xCA753D95U, 0xF23A8028U, 0xF6FB9D9FU, 0xFBB8BB46U, 0xFF79A6F1U,
+        0xE13EF6F4U, 0xE5FFEB43U, 0xE8BCCD9AU, 0xEC7DD02DU, 0x34867077U, 0x30476DC0U,
+        0x3D044B19U, 0x39C556AEU, 0x278206ABU, 0x23431B1CU, 0x2E003DC5U, 0x2AC12072U,
+        0x128E9DCFU, 0x164F8078U, 0x1B0CA6A1U, 0x1FCDBB16U, 0x018AEB13U, 0x054BF6A4U,
+        0x0808D07DU, 0x0CC9CDCAU, 0x7897AB07U, 0x7C56B6B0U, 0x71159069U, 0x75D48DDEU,
+        0x6B93DDDBU, 0x6F52C06CU, 0x6211E6B5U, 0x66D0FB02U, 0x5E9F46BFU, 0x5A5E5B08U,
+        0x571D7DD1U, 0x53DC6066U, 0x4D9B3063U, 0x495A2DD4U, 0x44190B0DU, 0x40D816BAU,
+        0xACA5C697U, 0xA864DB20U, 0xA527FDF9U, 0xA1E6E04EU, 0xBFA1B04BU, 0xBB60ADFCU,
+        0xB6238B25U, 0xB2E29692U, 0x8AAD2B2FU, 0x8E6C3698U, 0x832F1041U, 0x87EE0DF6U,
+        0x99A95DF3U, 0x9D684044U, 0x902B669DU, 0x94EA7B2AU, 0xE0B41DE7U, 0xE4750050U,
+        0xE9362689U, 0xEDF73B3EU, 0xF3B06B3BU, 0xF771768CU, 0xFA325055U, 0xFEF34DE2U,
+        0xC6BCF05FU, 0xC27DEDE8U, 0xCF3ECB31U, 0xCBFFD686U, 0xD5B88683U, 0xD1799B34U,
+        0xDC3ABDEDU, 0xD8FBA05AU, 0x690CE0EEU, 0x6DCDFD59U, 0x608EDB80U, 0x644FC637U,
+        0x7A089632U, 0x7EC98B85U, 0x738AAD5CU, 0x774BB0EBU, 0x4F040D56U, 0x4BC510E1U,
+        0x46863638U, 0x42472B8FU, 0x5C007B8AU, 0x58C1663DU, 0x558240E4U, 0x51435D53U,
+        0x251D3B9EU, 0x21DC2629U, 0x2C9F00F0U, 0x285E1D47U, 0x36194D42U, 0x32D850F5U,
+        0x3F9B762CU, 0x3B5A6B9BU, 0x0315D626U, 0x07D4CB91U, 0x0A97ED48U, 0x0E56F0FFU,
+        0x1011A0FAU, 0x14D0BD4DU, 0x19939B94U, 0x1D528623U, 0xF12F560EU, 0xF5EE4BB9U,
+        0xF8AD6D60U, 0xFC6C70D7U, 0xE22B20D2U, 0xE6EA3D65U, 0xEBA91BBCU, 0xEF68060BU,
+        0xD727BBB6U, 0xD3E6A601U, 0xDEA580D8U, 0xDA649D6FU, 0xC423CD6AU, 0xC0E2D0DDU,
+        0xCDA1F604U, 0xC960EBB3U, 0xBD3E8D7EU, 0xB9FF90C9U, 0xB4BCB610U, 0xB07DABA7U,
+        0xAE3AFBA2U, 0xAAFBE615U, 0xA7B8C0CCU, 0xA379DD7BU, 0x9B3660C6U, 0x9FF77D71U,
+        0x92B45BA8U, 0x9675461FU, 0x8832161AU, 0x8CF30BADU, 0x81B02D74U, 0x857130C3U,
+        0x5D8A9099U, 0x594B8D2EU, 0x5408ABF7U, 0x50C9B640U, 0x4E8EE645U, 0x4A4FFBF2U,
+        0x470CDD2BU, 0x43CDC09CU, 0x7B827D21U, 0x7F436096U, 0x7200464FU, 0x76C15BF8U,
+        0x68860BFDU, 0x6C47164AU, 0x61043093U, 0x65C52D24U, 0x119B4BE9U, 0x155A565EU,
+        0x18197087U, 0x1CD86D30U, 0x029F3D35U, 0x065E2082U, 0x0B1D065BU, 0x0FDC1BECU,
+        0x3793A651U, 0x3352BBE6U, 0x3E119D3FU, 0x3AD08088U, 0x2497D08DU, 0x2056CD3AU,
+        0x2D15EBE3U, 0x29D4F654U, 0xC5A92679U, 0xC1683BCEU, 0xCC2B1D17U, 0xC8EA00A0U,
+        0xD6AD50A5U, 0xD26C4D12U, 0xDF2F6BCBU, 0xDBEE767CU, 0xE3A1CBC1U, 0xE760D676U,
+        0xEA23F0AFU, 0xEEE2ED18U, 0xF0A5BD1DU, 0xF464A0AAU, 0xF9278673U, 0xFDE69BC4U,
+        0x89B8FD09U, 0x8D79E0BEU, 0x803AC667U, 0x84FBDBD0U, 0x9ABC8BD5U, 0x9E7D9662U,
+        0x933EB0BBU, 0x97FFAD0CU, 0xAFB010B1U, 0xAB710D06U, 0xA6322BDFU, 0xA2F33668U,
+        0xBCB4666DU, 0xB8757BDAU, 0xB5365D03U, 0xB1F740B4U
+    },
+    { /* T1 */
+        0x00000000U, 0xD219C1DCU, 0xA0F29E0FU, 0x72EB5FD3U, 0x452421A9U, 0x973DE075U,
+        0xE5D6BFA6U, 0x37CF7E7AU, 0x8A484352U, 0x5851828EU, 0x2ABADD5DU, 0xF8A31C81U,
+        0xCF6C62FBU, 0x1D75A327U, 0x6F9EFCF4U, 0xBD873D28U, 0x10519B13U, 0xC2485ACFU,
+        0xB0A3051CU, 0x62BAC4C0U, 0x5575BABAU, 0x876C7B66U, 0xF58724B5U, 0x279EE569U,
+        0x9A19D841U, 0x4800199DU, 0x3AEB464EU, 0xE8F28792U, 0xDF3DF9E8U, 0x0D243834U,
+        0x7FCF67E7U, 0xADD6A63BU, 0x20A33626U, 0xF2BAF7FAU, 0x8051A829U, 0x524869F5U,
+        0x6587178FU, 0xB79ED653U, 0xC5758980U, 0x176C485CU, 0xAAEB7574U, 0x78F2B4A8U,
+        0x0A19EB7BU, 0xD8002AA7U, 0xEFCF54DDU, 0x3DD69501U, 0x4F3DCAD2U, 0x9D240B0EU,
+        0x30F2AD35U, 0xE2EB6CE9U, 0x9000333AU, 0x4219F2E6U, 0x75D68C9CU, 0xA7CF4D40U,
+        0xD5241293U, 0x073DD34FU, 0xBABAEE67U, 0x68A32FBBU, 0x1A487068U, 0xC851B1B4U,
+        0xFF9ECFCEU, 0x2D870E12U, 0x5F6C51C1U, 0x8D75901DU, 0x41466C4CU, 0x935FAD90U,
+        0xE1B4F243U, 0x33AD339FU, 0x04624DE5U, 0xD67B8C39U, 0xA490D3EAU, 0x76891236U,
+        0xCB0E2F1EU, 0x1917EEC2U, 0x6BFCB111U, 0xB9E570CDU, 0x8E2A0EB7U, 0x5C33CF6BU,
+        0x2ED890B8U, 0xFCC15164U, 0x5117F75FU, 0x830E3683U, 0xF1E56950U, 0x23FCA88CU,
+        0x1433D6F6U, 0xC62A172AU, 0xB4C148F9U, 0x66D88925U, 0xDB5FB40DU, 0x094675D1U,
+        0x7BAD2A02U, 0xA9B4EBDEU, 0x9E7B95A4U, 0x4C625478U, 0x3E890BABU, 0xEC90CA77U,
+        0x61E55A6AU, 0xB3FC9BB6U, 0xC117C465U, 0x130E05B9U, 0x24C17BC3U, 0xF6D8BA1FU,
+        0x8433E5CCU, 0x562A2410U, 0xEBAD1938U, 0x39B4D8E4U, 0x4B5F8737U, 0x994646EBU,
+        0xAE893891U, 0x7C90F94DU, 0x0E7BA69EU, 0xDC626742U, 0x71B4C179U, 0xA3AD00A5U,
+        0xD1465F76U, 0x035F9EAAU, 0x3490E0D0U, 0xE689210CU, 0x94627EDFU, 0x467BBF03U,
+        0xFBFC822BU, 0x29E543F7U, 0x5B0E1C24U, 0x8917DDF8U, 0xBED8A382U, 0x6CC1625EU,
+        0x1E2A3D8DU, 0xCC33FC51U, 0x828CD898U, 0x50951944U, 0x227E4697U, 0xF067874BU,
+        0xC7A8F931U, 0x15B138EDU, 0x675A673EU, 0xB543A6E2U, 0x08C49BCAU, 0xDADD5A16U,
+        0xA83605C5U, 0x7A2FC419U, 0x4DE0BA63U, 0x9FF97BBFU, 0xED12246CU, 0x3F0BE5B0U,
+        0x92DD438BU, 0x40C48257U, 0x322FDD84U, 0xE0361C58U, 0xD7F96222U, 0x05E0A3FEU,
+        0x770BFC2DU, 0xA5123DF1U, 0x189500D9U, 0xCA8CC105U, 0xB8679ED6U, 0x6A7E5F0AU,
+        0x5DB12170U, 0x8FA8E0ACU, 0xFD43BF7FU, 0x2F5A7EA3U, 0xA22FEEBEU, 0x70362F62U,
+        0x02DD70B1U, 0xD0C4B16DU, 0xE70BCF17U, 0x35120ECBU, 0x47F95118U, 0x95E090C4U,
+        0x2867ADECU, 0xFA7E6C30U, 0x889533E3U, 0x5A8CF23FU, 0x6D438C45U, 0xBF5A4D99U,
+        0xCDB1124AU, 0x1FA8D396U, 0xB27E75ADU, 0x6067B471U, 0x128CEBA2U, 0xC0952A7EU,
+        0xF75A5404U, 0x254395D8U, 0x57A8CA0BU, 0x85B10BD7U, 0x383636FFU, 0xEA2FF723U,
+        0x98C4A8F0U, 0x4ADD692CU, 0x7D121756U, 0xAF0BD68AU, 0xDDE08959U, 0x0FF94885U,
+        0xC3CAB4D4U, 0x11D37508U, 0x63382ADBU, 0xB121EB07U, 0x86EE957DU, 0x54F754A1U,
+        0x261C0B72U, 0xF405CAAEU, 0x4982F786U, 0x9B9B365AU, 0xE9706989U, 0x3B69A855U,
+        0x0CA6D62FU, 0xDEBF17F3U, 0xAC544820U, 0x7E4D89FCU, 0xD39B2FC7U, 0x0182EE1BU,
+        0x7369B1C8U, 0xA1707014U, 0x96BF0E6EU, 0x44A6CFB2U, 0x364D9061U, 0xE45451BDU,
+        0x59D36C95U, 0x8BCAAD49U, 0xF921F29AU, 0x2B383346U, 0x1CF74D3CU, 0xCEEE8CE0U,
+        0xBC05D333U, 0x6E1C12EFU, 0xE36982F2U, 0x3170432EU, 0x439B1CFDU, 0x9182DD21U,
+        0xA64DA35BU, 0x74546287U, 0x06BF3D54U, 0xD4A6FC88U, 0x6921C1A0U, 0xBB38007CU,
+        0xC9D35FAFU, 0x1BCA9E73U, 0x2C05E009U, 0xFE1C21D5U, 0x8CF77E06U, 0x5EEEBFDAU,
+        0xF33819E1U, 0x2121D83DU, 0x53CA87EEU, 0x81D34632U, 0xB61C3848U, 0x6405F994U,
+        0x16EEA647U, 0xC4F7679BU, 0x79705AB3U, 0xAB699B6FU, 0xD982C4BCU, 0x0B9B0560U,
+        0x3C547B1AU, 0xEE4DBAC6U, 0x9CA6E515U, 0x4EBF24C9U
+    },
+    { /* T2 */
+        0x00000000U, 0x01D8AC87U, 0x03B1590EU, 0x0269F589U, 0x0762B21CU, 0x06BA1E9BU,
+        0x04D3EB12U, 0x050B4795U, 0x0EC56438U, 0x0F1DC8BFU, 0x0D743D36U, 0x0CAC91B1U,
+        0x09A7D624U, 0x087F7AA3U, 0x0A168F2AU, 0x0BCE23ADU, 0x1D8AC870U, 0x1C5264F7U,
+        0x1E3B917EU, 0x1FE33DF9U, 0x1AE87A6CU, 0x1B30D6EBU, 0x19592362U, 0x18818FE5U,
+        0x134FAC48U, 0x129700CFU, 0x10FEF546U, 0x112659C1U, 0x142D1E54U, 0x15F5B2D3U,
+        0x179C475AU, 0x1644EBDDU, 0x3B1590E0U, 0x3ACD3C67U, 0x38A4C9EEU, 0x397C6569U,
+        0x3C7722FCU, 0x3DAF8E7BU, 0x3FC67BF2U, 0x3E1ED775U, 0x35D0F4D8U, 0x3408585FU,
+        0x3661ADD6U, 0x37B90151U, 0x32B246C4U, 0x336AEA43U, 0x31031FCAU, 0x30DBB34DU,
+        0x269F5890U, 0x2747F417U, 0x252E019EU, 0x24F6AD19U, 0x21FDEA8CU, 0x2025460BU,
+        0x224CB382U, 0x23941F05U, 0x285A3CA8U, 0x2982902FU, 0x2BEB65A6U, 0x2A33C921U,
+        0x2F388EB4U, 0x2EE02233U, 0x2C89D7BAU, 0x2D517B3DU, 0x762B21C0U, 0x77F38D47U,
+        0x759A78CEU, 0x7442D449U, 0x714993DCU, 0x70913F5BU, 0x72F8CAD2U, 0x73206655U,
+        0x78EE45F8U, 0x7936E97FU, 0x7B5F1CF6U, 0x7A87B071U, 0x7F8CF7E4U, 0x7E545B63U,
+        0x7C3DAEEAU, 0x7DE5026DU, 0x6BA1E9B0U, 0x6A794537U, 0x6810B0BEU, 0x69C81C39U,
+        0x6CC35BACU, 0x6D1BF72BU, 0x6F7202A2U, 0x6EAAAE25U, 0x65648D88U, 0x64BC210FU,
+        0x66D5D486U, 0x670D7801U, 0x62063F94U, 0x63DE9313U, 0x61B7669AU, 0x606FCA1DU,
+        0x4D3EB120U, 0x4CE61DA7U, 0x4E8FE82EU, 0x4F5744A9U, 0x4A5C033CU, 0x4B84AFBBU,
+        0x49ED5A32U, 0x4835F6B5U, 0x43FBD518U, 0x4223799FU, 0x404A8C16U, 0x41922091U,
+        0x44996704U, 0x4541CB83U, 0x47283E0AU, 0x46F0928DU, 0x50B47950U, 0x516CD5D7U,
+        0x5305205EU, 0x52DD8CD9U, 0x57D6CB4CU, 0x560E67CBU, 0x54679242U, 0x55BF3EC5U,
+        0x5E711D68U, 0x5FA9B1EFU, 0x5DC04466U, 0x5C18E8E1U, 0x5913AF74U, 0x58CB03F3U,
+        0x5AA2F67AU, 0x5B7A5AFDU, 0xEC564380U, 0xED8EEF07U, 0xEFE71A8EU, 0xEE3FB609U,
+        0xEB34F19CU, 0xEAEC5D1BU, 0xE885A892U, 0xE95D0415U, 0xE29327B8U, 0xE34B8B3FU,
+        0xE1227EB6U, 0xE0FAD231U, 0xE5F195A4U, 0xE4293923U, 0xE640CCAAU, 0xE798602DU,
+        0xF1DC8BF0U, 0xF0042777U, 0xF26DD2FEU, 0xF3B57E79U, 0xF6BE39ECU, 0xF766956BU,
+        0xF50F60E2U, 0xF4D7CC65U, 0xFF19EFC8U, 0xFEC1434FU, 0xFCA8B6C6U, 0xFD701A41U,
+        0xF87B5DD4U, 0xF9A3F153U, 0xFBCA04DAU, 0xFA12A85DU, 0xD743D360U, 0xD69B7FE7U,
+        0xD4F28A6EU, 0xD52A26E9U, 0xD021617CU, 0xD1F9CDFBU, 0xD3903872U, 0xD24894F5U,
+        0xD986B758U, 0xD85E1BDFU, 0xDA37EE56U, 0xDBEF42D1U, 0xDEE40544U, 0xDF3CA9C3U,
+        0xDD555C4AU, 0xDC8DF0CDU, 0xCAC91B10U, 0xCB11B797U, 0xC978421EU, 0xC8A0EE99U,
+        0xCDABA90CU, 0xCC73058BU, 0xCE1AF002U, 0xCFC25C85U, 0xC40C7F28U, 0xC5D4D3AFU,
+        0xC7BD2626U, 0xC6658AA1U, 0xC36ECD34U, 0xC2B661B3U, 0xC0DF943AU, 0xC10738BDU,
+        0x9A7D6240U, 0x9BA5CEC7U, 0x99CC3B4EU, 0x981497C9U, 0x9D1FD05CU, 0x9CC77CDBU,
+        0x9EAE8952U, 0x9F7625D5U, 0x94B80678U, 0x9560AAFFU, 0x97095F76U, 0x96D1F3F1U,
+        0x93DAB464U, 0x920218E3U, 0x906BED6AU, 0x91B341EDU, 0x87F7AA30U, 0x862F06B7U,
+        0x8446F33EU, 0x859E5FB9U, 0x8095182CU, 0x814DB4ABU, 0x83244122U, 0x82FCEDA5U,
+        0x8932CE08U, 0x88EA628FU, 0x8A839706U, 0x8B5B3B81U, 0x8E507C14U, 0x8F88D093U,
+        0x8DE1251AU, 0x8C39899DU, 0xA168F2A0U, 0xA0B05E27U, 0xA2D9ABAEU, 0xA3010729U,
+        0xA60A40BCU, 0xA7D2EC3BU, 0xA5BB19B2U, 0xA463B535U, 0xAFAD9698U, 0xAE753A1FU,
+        0xAC1CCF96U, 0xADC46311U, 0xA8CF2484U, 0xA9178803U, 0xAB7E7D8AU, 0xAAA6D10DU,
+        0xBCE23AD0U, 0xBD3A9657U, 0xBF5363DEU, 0xBE8BCF59U, 0xBB8088CCU, 0xBA58244BU,
+        0xB831D1C2U, 0xB9E97D45U, 0xB2275EE8U, 0xB3FFF26FU, 0xB19607E6U, 0xB04EAB61U,
+        0xB545ECF4U, 0xB49D4073U, 0xB6F4B5FAU, 0xB72C197DU
+    },
+    { /* T3 */
+        0x00000000U, 0xDC6D9AB7U, 0xBC1A28D9U, 0x6077B26EU, 0x7CF54C05U, 0xA098D6B2U,
+        0xC0EF64DCU, 0x1C82FE6BU, 0xF9EA980AU, 0x258702BDU, 0x45F0B0D3U, 0x999D2A64U,
+        0x851FD40FU, 0x59724EB8U, 0x3905FCD6U, 0xE5686661U, 0xF7142DA3U, 0x2B79B714U,
+        0x4B0E057AU, 0x97639FCDU, 0x8BE161A6U, 0x578CFB11U, 0x37FB497FU, 0xEB96D3C8U,
+        0x0EFEB5A9U, 0xD2932F1EU, 0xB2E49D70U, 0x6E8907C7U, 0x720BF9ACU, 0xAE66631BU,
+        0xCE11D175U, 0x127C4BC2U, 0xEAE946F1U, 0x3684DC46U, 0x56F36E28U, 0x8A9EF49FU,
+        0x961C0AF4U, 0x4A719043U, 0x2A06222DU, 0xF66BB89AU, 0x1303DEFBU, 0xCF6E444CU,
+        0xAF19F622U, 0x73746C95U, 0x6FF692FEU, 0xB39B0849U, 0xD3ECBA27U, 0x0F812090U,
+        0x1DFD6B52U, 0xC190F1E5U, 0xA1E7438BU, 0x7D8AD93CU, 0x61082757U, 0xBD65BDE0U,
+        0xDD120F8EU, 0x017F9539U, 0xE417F358U, 0x387A69EFU, 0x580DDB81U, 0x84604136U,
+        0x98E2BF5DU, 0x448F25EAU, 0x24F89784U, 0xF8950D33U, 0xD1139055U, 0x0D7E0AE2U,
+        0x6D09B88CU, 0xB164223BU, 0xADE6DC50U, 0x718B46E7U, 0x11FCF489U, 0xCD916E3EU,
+        0x28F9085FU, 0xF49492E8U, 0x94E32086U, 0x488EBA31U, 0x540C445AU, 0x8861DEEDU,
+        0xE8166C83U, 0x347BF634U, 0x2607BDF6U, 0xFA6A2741U, 0x9A1D952FU, 0x46700F98U,
+        0x5AF2F1F3U, 0x869F6B44U, 0xE6E8D92AU, 0x3A85439DU, 0xDFED25FCU, 0x0380BF4BU,
+        0x63F70D25U, 0xBF9A9792U, 0xA31869F9U, 0x7F75F34EU, 0x1F024120U, 0xC36FDB97U,
+        0x3BFAD6A4U, 0xE7974C13U, 0x87E0FE7DU, 0x5B8D64CAU, 0x470F9AA1U, 0x9B620016U,
+        0xFB15B278U, 0x277828CFU, 0xC2104EAEU, 0x1E7DD419U, 0x7E0A6677U, 0xA267FCC0U,
+        0xBEE502ABU, 0x6288981CU, 0x02FF2A72U, 0xDE92B0C5U, 0xCCEEFB07U, 0x108361B0U,
+        0x70F4D3DEU, 0xAC994969U, 0xB01BB702U, 0x6C762DB5U, 0x0C019FDBU, 0xD06C056CU,
+        0x3504630DU, 0xE969F9BAU, 0x891E4BD4U, 0x5573D163U, 0x49F12F08U, 0x959CB5BFU,
+        0xF5EB07D1U, 0x29869D66U, 0xA6E63D1DU, 0x7A8BA7AAU, 0x1AFC15C4U, 0xC6918F73U,
+        0xDA137118U, 0x067EEBAFU, 0x660959C1U, 0xBA64C376U, 0x5F0CA517U, 0x83613FA0U,
+        0xE3168DCEU, 0x3F7B1779U, 0x23F9E912U, 0xFF9473A5U, 0x9FE3C1CBU, 0x438E5B7CU,
+        0x51F210BEU, 0x8D9F8A09U, 0xEDE83867U, 0x3185A2D0U, 0x2D075CBBU, 0xF16AC60CU,
+        0x911D7462U, 0x4D70EED5U, 0xA81888B4U, 0x74751203U, 0x1402A06DU, 0xC86F3ADAU,
+        0xD4EDC4B1U, 0x08805E06U, 0x68F7EC68U, 0xB49A76DFU, 0x4C0F7BECU, 0x9062E15BU,
+        0xF0155335U, 0x2C78C982U, 0x30FA37E9U, 0xEC97AD5EU, 0x8CE01F30U, 0x508D8587U,
+        0xB5E5E3E6U, 0x69887951U, 0x09FFCB3FU, 0xD5925188U, 0xC910AFE3U, 0x157D3554U,
+        0x750A873AU, 0xA9671D8DU, 0xBB1B564FU, 0x6776CCF8U, 0x07017E96U, 0xDB6CE421U,
+        0xC7EE1A4AU, 0x1B8380FDU, 0x7BF43293U, 0xA799A824U, 0x42F1CE45U, 0x9E9C54F2U,
+        0xFEEBE69CU, 0x22867C2BU, 0x3E048240U, 0xE26918F7U, 0x821EAA99U, 0x5E73302EU,
+        0x77F5AD48U, 0xAB9837FFU, 0xCBEF8591U, 0x17821F26U, 0x0B00E14DU, 0xD76D7BFAU,
+        0xB71AC994U, 0x6B775323U, 0x8E1F3542U, 0x5272AFF5U, 0x32051D9BU, 0xEE68872CU,
+        0xF2EA7947U, 0x2E87E3F0U, 0x4EF0519EU, 0x929DCB29U, 0x80E180EBU, 0x5C8C1A5CU,
+        0x3CFBA832U, 0xE0963285U, 0xFC14CCEEU, 0x20795659U, 0x400EE437U, 0x9C637E80U,
+        0x790B18E1U, 0xA5668256U, 0xC5113038U, 0x197CAA8FU, 0x05FE54E4U, 0xD993CE53U,
+        0xB9E47C3DU, 0x6589E68AU, 0x9D1CEBB9U, 0x4171710EU, 0x2106C360U, 0xFD6B59D7U,
+        0xE1E9A7BCU, 0x3D843D0BU, 0x5DF38F65U, 0x819E15D2U, 0x64F673B3U, 0xB89BE904U,
+        0xD8EC5B6AU, 0x0481C1DDU, 0x18033FB6U, 0xC46EA501U, 0xA419176FU, 0x78748DD8U,
+        0x6A08C61AU, 0xB6655CADU, 0xD612EEC3U, 0x0A7F7474U, 0x16FD8A1FU, 0xCA9010A8U,
+        0xAAE7A2C6U, 0x768A3871U, 0x93E25E10U, 0x4F8FC4A7U, 0x2FF876C9U, 0xF395EC7EU,
+        0xEF171215U, 0x337A88A2U, 0x530D3ACCU, 0x8F60A07BU
+    },
+    { /* T4 */
+        0x00000000U, 0x490D678DU, 0x921ACF1AU, 0xDB17A897U, 0x20F48383U, 0x69F9E40EU,
+        0xB2EE4C99U, 0xFBE32B14U, 0x41E90706U, 0x08E4608BU, 0xD3F3C81CU, 0x9AFEAF91U,
+        0x611D8485U, 0x2810E308U, 0xF3074B9FU, 0xBA0A2C12U, 0x83D20E0CU, 0xCADF6981U,
+        0x11C8C116U, 0x58C5A69BU, 0xA3268D8FU, 0xEA2BEA02U, 0x313C4295U, 0x78312518U,
+        0xC23B090AU, 0x8B366E87U, 0x5021C610U, 0x192CA19DU, 0xE2CF8A89U, 0xABC2ED04U,
+        0x70D54593U, 0x39D8221EU, 0x036501AFU, 0x4A686622U, 0x917FCEB5U, 0xD872A938U,
+        0x2391822CU, 0x6A9CE5A1U, 0xB18B4D36U, 0xF8862ABBU, 0x428C06A9U, 0x0B816124U,
+        0xD096C9B3U, 0x999BAE3EU, 0x6278852AU, 0x2B75E2A7U, 0xF0624A30U, 0xB96F2DBDU,
+        0x80B70FA3U, 0xC9BA682EU, 0x12ADC0B9U, 0x5BA0A734U, 0xA0438C20U, 0xE94EEBADU,
+        0x3259433AU, 0x7B5424B7U, 0xC15E08A5U, 0x88536F28U, 0x5344C7BFU, 0x1A49A032U,
+        0xE1AA8B26U, 0xA8A7ECABU, 0x73B0443CU, 0x3ABD23B1U, 0x06CA035EU, 0x4FC764D3U,
+        0x94D0CC44U, 0xDDDDABC9U, 0x263E80DDU, 0x6F33E750U, 0xB4244FC7U, 0xFD29284AU,
+        0x47230458U, 0x0E2E63D5U, 0xD539CB42U, 0x9C34ACCFU, 0x67D787DBU, 0x2EDAE056U,
+        0xF5CD48C1U, 0xBCC02F4CU, 0x85180D52U, 0xCC156ADFU, 0x1702C248U, 0x5E0FA5C5U,
+        0xA5EC8ED1U, 0xECE1E95CU, 0x37F641CBU, 0x7EFB2646U, 0xC4F10A54U, 0x8DFC6DD9U,
+        0x56EBC54EU, 0x1FE6A2C3U, 0xE40589D7U, 0xAD08EE5AU, 0x761F46CDU, 0x3F122140U,
+        0x05AF02F1U, 0x4CA2657CU, 0x97B5CDEBU, 0xDEB8AA66U, 0x255B8172U, 0x6C56E6FFU,
+        0xB7414E68U, 0xFE4C29E5U, 0x444605F7U, 0x0D4B627AU, 0xD65CCAEDU, 0x9F51AD60U,
+        0x64B28674U, 0x2DBFE1F9U, 0xF6A8496EU, 0xBFA52EE3U, 0x867D0CFDU, 0xCF706B70U,
+        0x1467C3E7U, 0x5D6AA46AU, 0xA6898F7EU, 0xEF84E8F3U, 0x34934064U, 0x7D9E27E9U,
+        0xC7940BFBU, 0x8E996C76U, 0x558EC4E1U, 0x1C83A36CU, 0xE7608878U, 0xAE6DEFF5U,
+        0x757A4762U, 0x3C7720EFU, 0x0D9406BCU, 0x44996131U, 0x9F8EC9A6U, 0xD683AE2BU,
+        0x2D60853FU, 0x646DE2B2U, 0xBF7A4A25U, 0xF6772DA8U, 0x4C7D01BAU, 0x05706637U,
+        0xDE67CEA0U, 0x976AA92DU, 0x6C898239U, 0x2584E5B4U, 0xFE934D23U, 0xB79E2AAEU,
+        0x8E4608B0U, 0xC74B6F3DU, 0x1C5CC7AAU, 0x5551A027U, 0xAEB28B33U, 0xE7BFECBEU,
+        0x3CA84429U, 0x75A523A4U, 0xCFAF0FB6U, 0x86A2683BU, 0x5DB5C0ACU, 0x14B8A721U,
+        0xEF5B8C35U, 0xA656EBB8U, 0x7D41432FU, 0x344C24A2U, 0x0EF10713U, 0x47FC609EU,
+        0x9CEBC809U, 0xD5E6AF84U, 0x2E058490U, 0x6708E31DU, 0xBC1F4B8AU, 0xF5122C07U,
+        0x4F180015U, 0x06156798U, 0xDD02CF0FU, 0x940FA882U, 0x6FEC8396U, 0x26E1E41BU,
+        0xFDF64C8CU, 0xB4FB2B01U, 0x8D23091FU, 0xC42E6E92U, 0x1F39C605U, 0x5634A188U,
+        0xADD78A9CU, 0xE4DAED11U, 0x3FCD4586U, 0x76C0220BU, 0xCCCA0E19U, 0x85C76994U,
+        0x5ED0C103U, 0x17DDA68EU, 0xEC3E8D9AU, 0xA533EA17U, 0x7E244280U, 0x3729250DU,
+        0x0B5E05E2U, 0x4253626FU, 0x9944CAF8U, 0xD049AD75U, 0x2BAA8661U, 0x62A7E1ECU,
+        0xB9B0497BU, 0xF0BD2EF6U, 0x4AB702E4U, 0x03BA6569U, 0xD8ADCDFEU, 0x91A0AA73U,
+        0x6A438167U, 0x234EE6EAU, 0xF8594E7DU, 0xB15429F0U, 0x888C0BEEU, 0xC1816C63U,
+        0x1A96C4F4U, 0x539BA379U, 0xA878886DU, 0xE175EFE0U, 0x3A624777U, 0x736F20FAU,
+        0xC9650CE8U, 0x80686B65U, 0x5B7FC3F2U, 0x1272A47FU, 0xE9918F6BU, 0xA09CE8E6U,
+        0x7B8B4071U, 0x328627FCU, 0x083B044DU, 0x413663C0U, 0x9A21CB57U, 0xD32CACDAU,
+        0x28CF87CEU, 0x61C2E043U, 0xBAD548D4U, 0xF3D82F59U, 0x49D2034BU, 0x00DF64C6U,
+        0xDBC8CC51U, 0x92C5ABDCU, 0x692680C8U, 0x202BE745U, 0xFB3C4FD2U, 0xB231285FU,
+        0x8BE90A41U, 0xC2E46DCCU, 0x19F3C55BU, 0x50FEA2D6U, 0xAB1D89C2U, 0xE210EE4FU,
+        0x390746D8U, 0x700A2155U, 0xCA000D47U, 0x830D6ACAU, 0x581AC25DU, 0x1117A5D0U,
+        0xEAF48EC4U, 0xA3F9E949U, 0x78EE41DEU, 0x31E32653U
+    },
+    { /* T5 */
+        0x00000000U, 0x1B280D78U, 0x36501AF0U, 0x2D781788U, 0x6CA035E0U, 0x77883898U,
+        0x5AF02F10U, 0x41D82268U, 0xD9406BC0U, 0xC26866B8U, 0xEF107130U, 0xF4387C48U,
+        0xB5E05E20U, 0xAEC85358U, 0x83B044D0U, 0x989849A8U, 0xB641CA37U, 0xAD69C74FU,
+        0x8011D0C7U, 0x9B39DDBFU, 0xDAE1FFD7U, 0xC1C9F2AFU, 0xECB1E527U, 0xF799E85FU,
+        0x6F01A1F7U, 0x7429AC8FU, 0x5951BB07U, 0x4279B67FU, 0x03A19417U, 0x1889996FU,
+        0x35F18EE7U, 0x2ED9839FU, 0x684289D9U, 0x736A84A1U, 0x5E129329U, 0x453A9E51U,
+        0x04E2BC39U, 0x1FCAB141U, 0x32B2A6C9U, 0x299AABB1U, 0xB102E219U, 0xAA2AEF61U,
+        0x8752F8E9U, 0x9C7AF591U, 0xDDA2D7F9U, 0xC68ADA81U, 0xEBF2CD09U, 0xF0DAC071U,
+        0xDE0343EEU, 0xC52B4E96U, 0xE853591EU, 0xF37B5466U, 0xB2A3760EU, 0xA98B7B76U,
+        0x84F36CFEU, 0x9FDB6186U, 0x0743282EU, 0x1C6B2556U, 0x311332DEU, 0x2A3B3FA6U,
+        0x6BE31DCEU, 0x70CB10B6U, 0x5DB3073EU, 0x469B0A46U, 0xD08513B2U, 0xCBAD1ECAU,
+        0xE6D50942U, 0xFDFD043AU, 0xBC252652U, 0xA70D2B2AU, 0x8A753CA2U, 0x915D31DAU,
+        0x09C57872U, 0x12ED750AU, 0x3F956282U, 0x24BD6FFAU, 0x65654D92U, 0x7E4D40EAU,
+        0x53355762U, 0x481D5A1AU, 0x66C4D985U, 0x7DECD4FDU, 0x5094C375U, 0x4BBCCE0DU,
+        0x0A64EC65U, 0x114CE11DU, 0x3C34F695U, 0x271CFBEDU, 0xBF84B245U, 0xA4ACBF3DU,
+        0x89D4A8B5U, 0x92FCA5CDU, 0xD32487A5U, 0xC80C8ADDU, 0xE5749D55U, 0xFE5C902DU,
+        0xB8C79A6BU, 0xA3EF9713U, 0x8E97809BU, 0x95BF8DE3U, 0xD467AF8BU, 0xCF4FA2F3U,
+        0xE237B57BU, 0xF91FB803U, 0x6187F1ABU, 0x7AAFFCD3U, 0x57D7EB5BU, 0x4CFFE623U,
+        0x0D27C44BU, 0x160FC933U, 0x3B77DEBBU, 0x205FD3C3U, 0x0E86505CU, 0x15AE5D24U,
+        0x38D64AACU, 0x23FE47D4U, 0x622665BCU, 0x790E68C4U, 0x54767F4CU, 0x4F5E7234U,
+        0xD7C63B9CU, 0xCCEE36E4U, 0xE196216CU, 0xFABE2C14U, 0xBB660E7CU, 0xA04E0304U,
+        0x8D36148CU, 0x961E19F4U, 0xA5CB3AD3U, 0xBEE337ABU, 0x939B2023U, 0x88B32D5BU,
+        0xC96B0F33U, 0xD243024BU, 0xFF3B15C3U, 0xE41318BBU, 0x7C8B5113U, 0x67A35C6BU,
+        0x4ADB4BE3U, 0x51F3469BU, 0x102B64F3U, 0x0B03698BU, 0x267B7E03U, 0x3D53737BU,
+        0x138AF0E4U, 0x08A2FD9CU, 0x25DAEA14U, 0x3EF2E76CU, 0x7F2AC504U, 0x6402C87CU,
+        0x497ADFF4U, 0x5252D28CU, 0xCACA9B24U, 0xD1E2965CU, 0xFC9A81D4U, 0xE7B28CACU,
+        0xA66AAEC4U, 0xBD42A3BCU, 0x903AB434U, 0x8B12B94CU, 0xCD89B30AU, 0xD6A1BE72U,
+        0xFBD9A9FAU, 0xE0F1A482U, 0xA12986EAU, 0xBA018B92U, 0x97799C1AU, 0x8C519162U,
+        0x14C9D8CAU, 0x0FE1D5B2U, 0x2299C23AU, 0x39B1CF42U, 0x7869ED2AU, 0x6341E052U,
+        0x4E39F7DAU, 0x5511FAA2U, 0x7BC8793DU, 0x60E07445U, 0x4D9863CDU, 0x56B06EB5U,
+        0x17684CDDU, 0x0C4041A5U, 0x2138562DU, 0x3A105B55U, 0xA28812FDU, 0xB9A01F85U,
+        0x94D8080DU, 0x8FF00575U, 0xCE28271DU, 0xD5002A65U, 0xF8783DEDU, 0xE3503095U,
+        0x754E2961U, 0x6E662419U, 0x431E3391U, 0x58363EE9U, 0x19EE1C81U, 0x02C611F9U,
+        0x2FBE0671U, 0x34960B09U, 0xAC0E42A1U, 0xB7264FD9U, 0x9A5E5851U, 0x81765529U,
+        0xC0AE7741U, 0xDB867A39U, 0xF6FE6DB1U, 0xEDD660C9U, 0xC30FE356U, 0xD827EE2EU,
+        0xF55FF9A6U, 0xEE77F4DEU, 0xAFAFD6B6U, 0xB487DBCEU, 0x99FFCC46U, 0x82D7C13EU,
+        0x1A4F8896U, 0x016785EEU, 0x2C1F9266U, 0x37379F1EU, 0x76EFBD76U, 0x6DC7B00EU,
+        0x40BFA786U, 0x5B97AAFEU, 0x1D0CA0B8U, 0x0624ADC0U, 0x2B5CBA48U, 0x3074B730U,
+        0x71AC9558U, 0x6A849820U, 0x47FC8FA8U, 0x5CD482D0U, 0xC44CCB78U, 0xDF64C600U,
+        0xF21CD188U, 0xE934DCF0U, 0xA8ECFE98U, 0xB3C4F3E0U, 0x9EBCE468U, 0x8594E910U,
+        0xAB4D6A8FU, 0xB06567F7U, 0x9D1D707FU, 0x86357D07U, 0xC7ED5F6FU, 0xDCC55217U,
+        0xF1BD459FU, 0xEA9548E7U, 0x720D014FU, 0x69250C37U, 0x445D1BBFU, 0x5F7516C7U,
+        0x1EAD34AFU, 0x058539D7U, 0x28FD2E5FU, 0x33D52327U
+    },
+    { /* T6 */
+        0x00000000U, 0x4F576811U, 0x9EAED022U, 0xD1F9B833U, 0x399CBDF3U, 0x76CBD5E2U,
+        0xA7326DD1U, 0xE86505C0U, 0x73397BE6U, 0x3C6E13F7U, 0xED97ABC4U, 0xA2C0C3D5U,
+        0x4AA5C615U, 0x05F2AE04U, 0xD40B1637U, 0x9B5C7E26U, 0xE672F7CCU, 0xA9259FDDU,
+        0x78DC27EEU, 0x378B4FFFU, 0xDFEE4A3FU, 0x90B9222EU, 0x41409A1DU, 0x0E17F20CU,
+        0x954B8C2AU, 0xDA1CE43BU, 0x0BE55C08U, 0x44B23419U, 0xACD731D9U, 0xE38059C8U,
+        0x3279E1FBU, 0x7D2E89EAU, 0xC824F22FU, 0x87739A3EU, 0x568A220DU, 0x19DD4A1CU,
+        0xF1B84FDCU, 0xBEEF27CDU, 0x6F169FFEU, 0x2041F7EFU, 0xBB1D89C9U, 0xF44AE1D8U,
+        0x25B359EBU, 0x6AE431FAU, 0x8281343AU, 0xCDD65C2BU, 0x1C2FE418U, 0x53788C09U,
+        0x2E5605E3U, 0x61016DF2U, 0xB0F8D5C1U, 0xFFAFBDD0U, 0x17CAB810U, 0x589DD001U,
+        0x89646832U, 0xC6330023U, 0x5D6F7E05U, 0x12381614U, 0xC3C1AE27U, 0x8C96C636U,
+        0x64F3C3F6U, 0x2BA4ABE7U, 0xFA5D13D4U, 0xB50A7BC5U, 0x9488F9E9U, 0xDBDF91F8U,
+        0x0A2629CBU, 0x457141DAU, 0xAD14441AU, 0xE2432C0BU, 0x33BA9438U, 0x7CEDFC29U,
+        0xE7B1820FU, 0xA8E6EA1EU, 0x791F522DU, 0x36483A3CU, 0xDE2D3FFCU, 0x917A57EDU,
+        0x4083EFDEU, 0x0FD487CFU, 0x72FA0E25U, 0x3DAD6634U, 0xEC54DE07U, 0xA303B616U,
+        0x4B66B3D6U, 0x0431DBC7U, 0xD5C863F4U, 0x9A9F0BE5U, 0x01C375C3U, 0x4E941DD2U,
+        0x9F6DA5E1U, 0xD03ACDF0U, 0x385FC830U, 0x7708A021U, 0xA6F11812U, 0xE9A67003U,
+        0x5CAC0BC6U, 0x13FB63D7U, 0xC202DBE4U, 0x8D55B3F5U, 0x6530B635U, 0x2A67DE24U,
+        0xFB9E6617U, 0xB4C90E06U, 0x2F957020U, 0x60C21831U, 0xB13BA002U, 0xFE6CC813U,
+        0x1609CDD3U, 0x595EA5C2U, 0x88A71DF1U, 0xC7F075E0U, 0xBADEFC0AU, 0xF589941BU,
+        0x24702C28U, 0x6B274439U, 0x834241F9U, 0xCC1529E8U, 0x1DEC91DBU, 0x52BBF9CAU,
+        0xC9E787ECU, 0x86B0EFFDU, 0x574957CEU, 0x181E3FDFU, 0xF07B3A1FU, 0xBF2C520EU,
+        0x6ED5EA3DU, 0x2182822CU, 0x2DD0EE65U, 0x62878674U, 0xB37E3E47U, 0xFC295656U,
+        0x144C5396U, 0x5B1B3B87U, 0x8AE283B4U, 0xC5B5EBA5U, 0x5EE99583U, 0x11BEFD92U,
+        0xC04745A1U, 0x8F102DB0U, 0x67752870U, 0x28224061U, 0xF9DBF852U, 0xB68C9043U,
+        0xCBA219A9U, 0x84F571B8U, 0x550CC98BU, 0x1A5BA19AU, 0xF23EA45AU, 0xBD69CC4BU,
+        0x6C907478U, 0x23C71C69U, 0xB89B624FU, 0xF7CC0A5EU, 0x2635B26DU, 0x6962DA7CU,
+        0x8107DFBCU, 0xCE50B7ADU, 0x1FA90F9EU, 0x50FE678FU, 0xE5F41C4AU, 0xAAA3745BU,
+        0x7B5ACC68U, 0x340DA479U, 0xDC68A1B9U, 0x933FC9A8U, 0x42C6719BU, 0x0D91198AU,
+        0x96CD67ACU, 0xD99A0FBDU, 0x0863B78EU, 0x4734DF9FU, 0xAF51DA5FU, 0xE006B24EU,
+        0x31FF0A7DU, 0x7EA8626CU, 0x0386EB86U, 0x4CD18397U, 0x9D283BA4U, 0xD27F53B5U,
+        0x3A1A5675U, 0x754D3E64U, 0xA4B48657U, 0xEBE3EE46U, 0x70BF9060U, 0x3FE8F871U,
+        0xEE114042U, 0xA1462853U, 0x49232D93U, 0x06744582U, 0xD78DFDB1U, 0x98DA95A0U,
+        0xB958178CU, 0xF60F7F9DU, 0x27F6C7AEU, 0x68A1AFBFU, 0x80C4AA7FU, 0xCF93C26EU,
+        0x1E6A7A5DU, 0x513D124CU, 0xCA616C6AU, 0x8536047BU, 0x54CFBC48U, 0x1B98D459U,
+        0xF3FDD199U, 0xBCAAB988U, 0x6D5301BBU, 0x220469AAU, 0x5F2AE040U, 0x107D8851U,
+        0xC1843062U, 0x8ED35873U, 0x66B65DB3U, 0x29E135A2U, 0xF8188D91U, 0xB74FE580U,
+        0x2C139BA6U, 0x6344F3B7U, 0xB2BD4B84U, 0xFDEA2395U, 0x158F2655U, 0x5AD84E44U,
+        0x8B21F677U, 0xC4769E66U, 0x717CE5A3U, 0x3E2B8DB2U, 0xEFD23581U, 0xA0855D90U,
+        0x48E05850U, 0x07B73041U, 0xD64E8872U, 0x9919E063U, 0x02459E45U, 0x4D12F654U,
+        0x9CEB4E67U, 0xD3BC2676U, 0x3BD923B6U, 0x748E4BA7U, 0xA577F394U, 0xEA209B85U,
+        0x970E126FU, 0xD8597A7EU, 0x09A0C24DU, 0x46F7AA5CU, 0xAE92AF9CU, 0xE1C5C78DU,
+        0x303C7FBEU, 0x7F6B17AFU, 0xE4376989U, 0xAB600198U, 0x7A99B9ABU, 0x35CED1BAU,
+        0xDDABD47AU, 0x92FCBC6BU, 0x43050458U, 0x0C526C49U
+    },
+    { /* T7 */
+        0x00000000U, 0x5BA1DCCAU, 0xB743B994U, 0xECE2655EU, 0x6A466E9FU, 0x31E7B255U,
+        0xDD05D70BU, 0x86A40BC1U, 0xD48CDD3EU, 0x8F2D01F4U, 0x63CF64AAU, 0x386EB860U,
+        0xBECAB3A1U, 0xE56B6F6BU, 0x09890A35U, 0x5228D6FFU, 0xADD8A7CBU, 0xF6797B01U,
+        0x1A9B1E5FU, 0x413AC295U, 0xC79EC954U, 0x9C3F159EU, 0x70DD70C0U, 0x2B7CAC0AU,
+        0x79547AF5U, 0x22F5A63FU, 0xCE17C361U, 0x95B61FABU, 0x1312146AU, 0x48B3C8A0U,
+        0xA451ADFEU, 0xFFF07134U, 0x5F705221U, 0x04D18EEBU, 0xE833EBB5U, 0xB392377FU,
+        0x35363CBEU, 0x6E97E074U, 0x8275852AU, 0xD9D459E0U, 0x8BFC8F1FU, 0xD05D53D5U,
+        0x3CBF368BU, 0x671EEA41U, 0xE1BAE180U, 0xBA1B3D4AU, 0x56F95814U, 0x0D5884DEU,
+        0xF2A8F5EAU, 0xA9092920U, 0x45EB4C7EU, 0x1E4A90B4U, 0x98EE9B75U, 0xC34F47BFU,
+        0x2FAD22E1U, 0x740CFE2BU, 0x262428D4U, 0x7D85F41EU, 0x91679140U, 0xCAC64D8AU,
+        0x4C62464BU, 0x17C39A81U, 0xFB21FFDFU, 0xA0802315U, 0xBEE0A442U, 0xE5417888U,
+        0x09A31DD6U, 0x5202C11CU, 0xD4A6CADDU, 0x8F071617U, 0x63E57349U, 0x3844AF83U,
+        0x6A6C797CU, 0x31CDA5B6U, 0xDD2FC0E8U, 0x868E1C22U, 0x002A17E3U, 0x5B8BCB29U,
+        0xB769AE77U, 0xECC872BDU, 0x13380389U, 0x4899DF43U, 0xA47BBA1DU, 0xFFDA66D7U,
+        0x797E6D16U, 0x22DFB1DCU, 0xCE3DD482U, 0x959C0848U, 0xC7B4DEB7U, 0x9C15027DU,
+        0x70F76723U, 0x2B56BBE9U, 0xADF2B028U, 0xF6536CE2U, 0x1AB109BCU, 0x4110D576U,
+        0xE190F663U, 0xBA312AA9U, 0x56D34FF7U, 0x0D72933DU, 0x8BD698FCU, 0xD0774436U,
+        0x3C952168U, 0x6734FDA2U, 0x351C2B5DU, 0x6EBDF797U, 0x825F92C9U, 0xD9FE4E03U,
+        0x5F5A45C2U, 0x04FB9908U, 0xE819FC56U, 0xB3B8209CU, 0x4C4851A8U, 0x17E98D62U,
+        0xFB0BE83CU, 0xA0AA34F6U, 0x260E3F37U, 0x7DAFE3FDU, 0x914D86A3U, 0xCAEC5A69U,
+        0x98C48C96U, 0xC365505CU, 0x2F873502U, 0x7426E9C8U, 0xF282E209U, 0xA9233EC3U,
+        0x45C15B9DU, 0x1E608757U, 0x79005533U, 0x22A189F9U, 0xCE43ECA7U, 0x95E2306DU,
+        0x13463BACU, 0x48E7E766U, 0xA4058238U, 0xFFA45EF2U, 0xAD8C880DU, 0xF62D54C7U,
+        0x1ACF3199U, 0x416EED53U, 0xC7CAE692U, 0x9C6B3A58U, 0x70895F06U, 0x2B2883CCU,
+        0xD4D8F2F8U, 0x8F792E32U, 0x639B4B6CU, 0x383A97A6U, 0xBE9E9C67U, 0xE53F40ADU,
+        0x09DD25F3U, 0x527CF939U, 0x00542FC6U, 0x5BF5F30CU, 0xB7179652U, 0xECB64A98U,
+        0x6A124159U, 0x31B39D93U, 0xDD51F8CDU, 0x86F02407U, 0x26700712U, 0x7DD1DBD8U,
+        0x9133BE86U, 0xCA92624CU, 0x4C36698DU, 0x1797B547U, 0xFB75D019U, 0xA0D40CD3U,
+        0xF2FCDA2CU, 0xA95D06E6U, 0x45BF63B8U, 0x1E1EBF72U, 0x98BAB4B3U, 0xC31B6879U,
+        0x2FF90D27U, 0x7458D1EDU, 0x8BA8A0D9U, 0xD0097C13U, 0x3CEB194DU, 0x674AC587U,
+        0xE1EECE46U, 0xBA4F128CU, 0x56AD77D2U, 0x0D0CAB18U, 0x5F247DE7U, 0x0485A12DU,
+        0xE867C473U, 0xB3C618B9U, 0x35621378U, 0x6EC3CFB2U, 0x8221AAECU, 0xD9807626U,
+        0xC7E0F171U, 0x9C412DBBU, 0x70A348E5U, 0x2B02942FU, 0xADA69FEEU, 0xF6074324U,
+        0x1AE5267AU, 0x4144FAB0U, 0x136C2C4FU, 0x48CDF085U, 0xA42F95DBU, 0xFF8E4911U,
+        0x792A42D0U, 0x228B9E1AU, 0xCE69FB44U, 0x95C8278EU, 0x6A3856BAU, 0x31998A70U,
+        0xDD7BEF2EU, 0x86DA33E4U, 0x007E3825U, 0x5BDFE4EFU, 0xB73D81B1U, 0xEC9C5D7BU,
+        0xBEB48B84U, 0xE515574EU, 0x09F73210U, 0x5256EEDAU, 0xD4F2E51BU, 0x8F5339D1U,
+        0x63B15C8FU, 0x38108045U, 0x9890A350U, 0xC3317F9AU, 0x2FD31AC4U, 0x7472C60EU,
+        0xF2D6CDCFU, 0xA9771105U, 0x4595745BU, 0x1E34A891U, 0x4C1C7E6EU, 0x17BDA2A4U,
+        0xFB5FC7FAU, 0xA0FE1B30U, 0x265A10F1U, 0x7DFBCC3BU, 0x9119A965U, 0xCAB875AFU,
+        0x3548049BU, 0x6EE9D851U, 0x820BBD0FU, 0xD9AA61C5U, 0x5F0E6A04U, 0x04AFB6CEU,
+        0xE84DD390U, 0xB3EC0F5AU, 0xE1C4D9A5U, 0xBA65056FU, 0x56876031U, 0x0D26BCFBU,
+        0x8B82B73AU, 0xD0236BF0U, 0x3CC10EAEU, 0x6760D264U
+    }
+};
+
+/* Function implementations --------------------------------------------------*/
+
+uint32_t SECBOOT_CRC32_Accumulate(uint32_t crc, const void *pData, size_t length)
+{
+    const uint8_t *p = (const uint8_t *)pData;
+
+    while (length >= SECBOOT_CRC32_SLICES) {
+        crc ^= ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+        crc = crc32_table[7][crc >> 24] ^ crc32_table[6][(crc >> 16) & 0xFFU] ^
+              crc32_table[5][(crc >> 8) & 0xFFU] ^ crc32_table[4][crc & 0xFFU] ^
+              crc32_table[3][p[4]] ^ crc32_table[2][p[5]] ^ crc32_table[1][p[6]] ^ crc32_table[0][p[7]];
+        p += SECBOOT_CRC32_SLICES;
+        length -= SECBOOT_CRC32_SLICES;
+    }
+
+    while (length-- > 0U) {
+        crc = (crc << 8) ^ crc32_table[0][(crc >> 24) ^ *p++];
+    }
+    return crc;
+}
+
+uint32_t SECBOOT_CRC32_Calculate(const void *pData, size_t length)
+{
+    return SECBOOT_CRC32_Accumulate(0xFFFFFFFFUL, pData, length);
+}
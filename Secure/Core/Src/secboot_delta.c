@@ -0,0 +1,244 @@
+/**
+  * @file    secboot_delta.c
+  * @brief   Streaming decoder for delta (differential) update images
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    The decoder only moves bytes; it never writes flash and never
+  *          decides whether the result is acceptable.
+  */
+
+#include "secboot_delta.h"
+#include <stddef.h>
+#include <string.h>
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Take the next patch byte, refilling the input buffer as needed
+  */
+static SECBOOT_Delta_StatusTypeDef Delta_NextByte(SECBOOT_Delta_Context *ctx, uint8_t *pByte) {
+    if (ctx->inputPos == ctx->inputLen) {
+        uint32_t chunk = ctx->patchRemaining;
+
+        if (chunk == 0) {
+            return SECBOOT_DELTA_CORRUPT;
+        }
+        if (chunk > SECBOOT_DELTA_INPUT_SIZE) {
+            chunk = SECBOOT_DELTA_INPUT_SIZE;
+        }
+        if (ctx->read(ctx->source, ctx->input, chunk) != SECBOOT_DELTA_OK) {
+            return SECBOOT_DELTA_READ_ERROR;
+        }
+        ctx->patchRemaining -= chunk;
+        ctx->inputPos = 0;
+        ctx->inputLen = chunk;
+    }
+
+    *pByte = ctx->input[ctx->inputPos++];
+    return SECBOOT_DELTA_OK;
+}
+
+/**
+  * @brief  Copy up to length literal bytes out of the patch
+  * @param  pCopied  Bytes copied; less than length when the buffer ran dry
+  */
+static SECBOOT_Delta_StatusTypeDef Delta_Literal(SECBOOT_Delta_Context *ctx, uint8_t *pOut, uint32_t length,
+                                                 uint32_t *pCopied) {
+    SECBOOT_Delta_StatusTypeDef status;
+    uint32_t available;
+
+    // Refill through Delta_NextByte, then take the rest of the buffer at once
+    status = Delta_NextByte(ctx, &pOut[0]);
+    if (status != SECBOOT_DELTA_OK) {
+        return status;
+    }
+
+    available = ctx->inputLen - ctx->inputPos;
+    if (available > length - 1U) {
+        available = length - 1U;
+    }
+    memcpy(pOut + 1, ctx->input + ctx->inputPos, available);
+    ctx->inputPos += available;
+
+    *pCopied = available + 1U;
+    return SECBOOT_DELTA_OK;
+}
+
+/**
+  * @brief  Decode the next tag and apply it if it produces no output
+  */
+static SECBOOT_Delta_StatusTypeDef Delta_NextOp(SECBOOT_Delta_Context *ctx) {
+    SECBOOT_Delta_StatusTypeDef status;
+    uint32_t length;
+    uint32_t span;
+    uint8_t tag;
+
+    status = Delta_NextByte(ctx, &tag);
+    if (status != SECBOOT_DELTA_OK) {
+        return status;
+    }
+
+    ctx->op = tag >> SECBOOT_DELTA_OP_SHIFT;
+    length = (uint32_t)(tag & SECBOOT_DELTA_LENGTH_MASK);
+
+    if (length < SECBOOT_DELTA_LENGTH_INLINE) {
+        length += 1U;
+    } else {
+        uint32_t bytes = length - SECBOOT_DELTA_LENGTH_INLINE + 1U;
+
+        length = 0;
+        for (uint32_t i = 0; i < bytes; i++) {
+            uint8_t b;
+
+            status = Delta_NextByte(ctx, &b);
+            if (status != SECBOOT_DELTA_OK) {
+                return status;
+            }
+            length |= (uint32_t)b << (8U * i);
+        }
+        if (length == 0) {
+            return SECBOOT_DELTA_CORRUPT;
+        }
+    }
+
+    // Bytes of base the op consumes, checked once against the base bounds
+    switch (ctx->op) {
+        case SECBOOT_DELTA_OP_COPY:
+        case SECBOOT_DELTA_OP_REPLACE:
+        case SECBOOT_DELTA_OP_SEEK_FWD:
+            span = length;
+            break;
+        case SECBOOT_DELTA_OP_RELOC:
+            if (length > ctx->baseSize / sizeof(uint32_t)) {
+                return SECBOOT_DELTA_CORRUPT;
+            }
+            span = length * sizeof(uint32_t);
+            break;
+        case SECBOOT_DELTA_OP_INSERT:
+            span = 0;
+            break;
+        case SECBOOT_DELTA_OP_SEEK_BACK:
+            if (length > ctx->basePos) {
+                return SECBOOT_DELTA_CORRUPT;
+            }
+            ctx->basePos -= length;
+            ctx->opRemaining = 0;
+            return SECBOOT_DELTA_OK;
+        default:
+            return SECBOOT_DELTA_CORRUPT;
+    }
+
+    if (span > ctx->baseSize - ctx->basePos) {
+        return SECBOOT_DELTA_CORRUPT;
+    }
+
+    if (ctx->op == SECBOOT_DELTA_OP_SEEK_FWD) {
+        ctx->basePos += length;
+        ctx->opRemaining = 0;
+    } else {
+        ctx->opRemaining = (ctx->op == SECBOOT_DELTA_OP_INSERT) ? length : span;
+    }
+    return SECBOOT_DELTA_OK;
+}
+
+/* Function implementations --------------------------------------------------*/
+
+SECBOOT_Delta_StatusTypeDef SECBOOT_Delta_Init(SECBOOT_Delta_Context *ctx, const uint8_t *base, uint32_t baseSize,
+                                               uint32_t relocDelta, SECBOOT_Delta_ReadFn read, void *source,
+                                               uint32_t patchSize) {
+    if (ctx == NULL || base == NULL || read == NULL || baseSize == 0 || patchSize == 0) {
+        return SECBOOT_DELTA_INVALID_PARAM;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->base = base;
+    ctx->baseSize = baseSize;
+    ctx->relocDelta = relocDelta;
+    ctx->read = read;
+    ctx->source = source;
+    ctx->patchRemaining = patchSize;
+
+    return SECBOOT_DELTA_OK;
+}
+
+SECBOOT_Delta_StatusTypeDef SECBOOT_Delta_Output(SECBOOT_Delta_Context *ctx, uint8_t *pOut, uint32_t length) {
+    SECBOOT_Delta_StatusTypeDef status;
+
+    if (ctx == NULL || pOut == NULL) {
+        return SECBOOT_DELTA_INVALID_PARAM;
+    }
+
+    while (length > 0) {
+        uint32_t n;
+
+        if (ctx->opRemaining == 0) {
+            status = Delta_NextOp(ctx);
+            if (status != SECBOOT_DELTA_OK) {
+                return status;
+            }
+            continue;
+        }
+
+        n = (length < ctx->opRemaining) ? length : ctx->opRemaining;
+
+        switch (ctx->op) {
+            case SECBOOT_DELTA_OP_COPY:
+                memcpy(pOut, ctx->base + ctx->basePos, n);
+                ctx->basePos += n;
+                break;
+
+            case SECBOOT_DELTA_OP_INSERT:
+            case SECBOOT_DELTA_OP_REPLACE:
+                status = Delta_Literal(ctx, pOut, n, &n);
+                if (status != SECBOOT_DELTA_OK) {
+                    return status;
+                }
+                if (ctx->op == SECBOOT_DELTA_OP_REPLACE) {
+                    ctx->basePos += n;
+                }
+                break;
+
+            default: /* SECBOOT_DELTA_OP_RELOC */
+                for (uint32_t i = 0; i < n; i++) {
+                    // The word is relocated when its first byte is due
+                    uint32_t offset = (ctx->opRemaining - i) % sizeof(uint32_t);
+
+                    if (offset == 0) {
+                        uint32_t word;
+
+                        memcpy(&word, ctx->base + ctx->basePos, sizeof(word));
+                        word += ctx->relocDelta;
+                        memcpy(ctx->word, &word, sizeof(word));
+                    }
+                    pOut[i] = ctx->word[(sizeof(uint32_t) - offset) % sizeof(uint32_t)];
+                    ctx->basePos++;
+                }
+                break;
+        }
+
+        pOut += n;
+        length -= n;
+        ctx->opRemaining -= n;
+    }
+
+    return SECBOOT_DELTA_OK;
+}
+
+SECBOOT_Delta_StatusTypeDef SECBOOT_Delta_Finish(SECBOOT_Delta_Context *ctx) {
+    SECBOOT_Delta_StatusTypeDef status = SECBOOT_DELTA_OK;
+
+    if (ctx == NULL) {
+        return SECBOOT_DELTA_INVALID_PARAM;
+    }
+
+    while (status == SECBOOT_DELTA_OK && ctx->opRemaining == 0 &&
+           (ctx->inputPos < ctx->inputLen || ctx->patchRemaining > 0)) {
+        status = Delta_NextOp(ctx);
+    }
+    if (status == SECBOOT_DELTA_OK && ctx->opRemaining != 0) {
+        status = SECBOOT_DELTA_CORRUPT;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    return status;
+}
@@ -1,5 +1,29 @@
 #include "secboot_diag.h"
+#include <stddef.h>
+#include <string.h>
 
+/* Private defines -----------------------------------------------------------*/
+#define DIAG_CRC_SPAN     offsetof(SECBOOT_Diag_LogEntry, crc)
+#define DIAG_FIRST_PAGE   ((SECBOOT_DIAG_LOG_BASE - SECBOOT_BOOTLOADER_ADDR) / FLASH_PAGE_SIZE)
+
+/* An entry is a whole number of flash double-words */
+typedef char Diag_EntrySizeCheck[(sizeof(SECBOOT_Diag_LogEntry) == SECBOOT_DIAG_LOG_SIZE) ? 1 : -1];
+
+/* Private types -------------------------------------------------------------*/
+
+/** @brief Write position in the flash ring */
+typedef struct {
+    bool     found;          ///< Head recovered since reset
+    uint32_t page;           ///< Page holding the newest entry
+    uint32_t freeIndex;      ///< First erased entry of that page, SECBOOT_DIAG_PAGE_ENTRIES if full
+    uint32_t sequence;       ///< Sequence number of the next entry
+    uint32_t boot;           ///< Boot number of this boot's entries
+} Diag_HeadTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static Diag_HeadTypeDef head;
+static SECBOOT_Diag_LogEntry stage[SECBOOT_DIAG_STAGE_SIZE];  // Secure RAM, not yet in flash
+static uint32_t stageCount = 0;
 
 /**
   * @brief  Basic response executor
@@ -13,82 +37,243 @@ static void SECBOOT_Diag_ExecuteResponse(SECBOOT_Diag_ResponseLevel level);
   */
 static void try_recovery_from_backup(void);
 
+/* Private functions ---------------------------------------------------------*/
+
+static const SECBOOT_Diag_LogEntry* Diag_At(uint32_t page, uint32_t index) {
+    return (const SECBOOT_Diag_LogEntry*)(SECBOOT_DIAG_LOG_BASE + (page * SECBOOT_DIAG_LOG_PAGE_SIZE) +
+                                          (index * SECBOOT_DIAG_LOG_SIZE));
+}
+
+static bool Diag_IsErased(const void *pStart, uint32_t length) {
+    const uint32_t *pWord = (const uint32_t*)pStart;
+
+    for (uint32_t i = 0; i < length / sizeof(uint32_t); i++) {
+        if (pWord[i] != 0xFFFFFFFFUL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool Diag_IsIntact(const SECBOOT_Diag_LogEntry *entry) {
+    uint32_t crc = 0;
+
+    if (SECBOOT_CRC_Calculate((uint8_t*)entry, DIAG_CRC_SPAN, &crc) != SECBOOT_CRC_OK) {
+        return false;
+    }
+    return crc == entry->crc;
+}
+
 /**
-  * @brief  Basic system lockdown
-  * @note   Performs essential security actions without complex features
+  * @brief  Erase a log page unless it already is
+  * @note   Flash must be unlocked
   */
-void system_lockdown(void);
+static SECBOOT_Diag_TypeDef Diag_ErasePage(uint32_t page) {
+    FLASH_EraseInitTypeDef erase = {0};
+    uint32_t page_error = 0;
 
-SECBOOT_Diag_TypeDef SECBOOT_Diag_LogEvent(SECBOOT_Diag_EventType event,uint8_t code,uint32_t data){
-     /* 1. Validate parameters */
-    if (event > SECBOOT_DIAG_ROLLBACK_ATTEMPT) {
-        return SECBOOT_DIAG_INVALID_PARAM;
+    if (Diag_IsErased(Diag_At(page, 0), SECBOOT_DIAG_LOG_PAGE_SIZE)) {
+        return SECBOOT_DIAG_OK;
     }
 
-    /* 2. Prepare log entry */
-    SECBOOT_Diag_LogEntry entry;
-    entry.timestamp = HAL_GetTick();
-    entry.event = event;
-    entry.error_code = code;
-    entry.context_data = data;
-    entry.crc = 0;  // Temporary zero for CRC calculation
+    erase.TypeErase = FLASH_TYPEERASE_PAGES;
+    erase.Banks = FLASH_BANK_1;
+    erase.Page = DIAG_FIRST_PAGE + page;
+    erase.NbPages = 1;
 
+    if (HAL_FLASHEx_Erase(&erase, &page_error) != HAL_OK) {
+        return SECBOOT_DIAG_FLASH_FAIL;
+    }
+    return SECBOOT_DIAG_OK;
+}
 
-    uint32_t temp_crc;
-    memcpy(&temp_crc, &entry.crc, sizeof(temp_crc));  // Safe
+/**
+  * @brief  Program one entry at the head, moving to the spare page when full
+  * @note   Flash must be unlocked
+  */
+static SECBOOT_Diag_TypeDef Diag_Program(const SECBOOT_Diag_LogEntry *entry) {
+    SECBOOT_Diag_TypeDef status;
+    uint32_t address;
+    uint64_t dword;
+
+    if (head.freeIndex == SECBOOT_DIAG_PAGE_ENTRIES) {
+        // The spare is normally erased already; a torn erase is finished here
+        status = Diag_ErasePage((head.page + 1U) % SECBOOT_DIAG_LOG_PAGES);
+        if (status != SECBOOT_DIAG_OK) {
+            return status;
+        }
+        head.page = (head.page + 1U) % SECBOOT_DIAG_LOG_PAGES;
+        head.freeIndex = 0;
+    }
 
-    //TODO FIX ALIGNEMENT SECBOOT_Diag_LogEntry
+    address = (uint32_t)Diag_At(head.page, head.freeIndex);
+    for (uint32_t i = 0; i < SECBOOT_DIAG_LOG_SIZE / sizeof(dword); i++) {
+        memcpy(&dword, (const uint8_t*)entry + (i * sizeof(dword)), sizeof(dword));
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, address + (i * sizeof(dword)), dword) != HAL_OK) {
+            // Whatever landed is not erased any more: skip the entry
+            head.freeIndex++;
+            return SECBOOT_DIAG_FLASH_FAIL;
+        }
+    }
+    head.freeIndex++;
 
-    if(SECBOOT_CRC_Calculate((uint8_t*)&entry, (sizeof(entry) - sizeof(entry.crc)), &temp_crc) != SECBOOT_CRC_OK){
-        return SECBOOT_DIAG_ERROR;
+    // First entry of a page: the oldest page becomes the new spare
+    if (head.freeIndex == 1U) {
+        return Diag_ErasePage((head.page + 1U) % SECBOOT_DIAG_LOG_PAGES);
     }
+    return SECBOOT_DIAG_OK;
+}
 
-    /* 4. Secure flash programming */
-    HAL_FLASH_Unlock();
+/* Function implementations --------------------------------------------------*/
+
+/**
+  * @brief  Find the head of the log ring
+  * @retval SECBOOT_Diag_TypeDef Status
+  * @note   The page whose first entry carries the highest sequence number
+  *         is the head page; its entries are programmed front to back, so
+  *         the first erased one is found by binary search. A torn write
+  *         leaves a programmed (if invalid) entry and keeps the search
+  *         sound.
+  */
+SECBOOT_Diag_TypeDef SECBOOT_Diag_Init(void) {
+    const SECBOOT_Diag_LogEntry *last = NULL;
+    uint32_t lo;
+    uint32_t hi;
+
+    // Empty ring: the first flush moves on to page 0 as if the last page were full
+    head.page = SECBOOT_DIAG_LOG_PAGES - 1U;
+    head.freeIndex = SECBOOT_DIAG_PAGE_ENTRIES;
+    head.sequence = 1;
+    head.boot = 1;
+
+    for (uint32_t page = 0; page < SECBOOT_DIAG_LOG_PAGES; page++) {
+        const SECBOOT_Diag_LogEntry *first = Diag_At(page, 0);
+
+        if (!Diag_IsErased(first, SECBOOT_DIAG_LOG_SIZE) && Diag_IsIntact(first) &&
+            (last == NULL || first->sequence > last->sequence)) {
+            last = first;
+            head.page = page;
+        }
+    }
+
+    if (last != NULL) {
+        lo = 1;
+        hi = SECBOOT_DIAG_PAGE_ENTRIES;
+        while (lo < hi) {
+            uint32_t mid = lo + ((hi - lo) / 2U);
+
+            if (Diag_IsErased(Diag_At(head.page, mid), SECBOOT_DIAG_LOG_SIZE)) {
+                hi = mid;
+            } else {
+                lo = mid + 1U;
+            }
+        }
+        head.freeIndex = lo;
+
+        // Newest intact entry; torn ones at the end are skipped
+        for (uint32_t i = lo - 1U; i > 0U; i--) {
+            if (Diag_IsIntact(Diag_At(head.page, i))) {
+                last = Diag_At(head.page, i);
+                break;
+            }
+        }
+        head.sequence = last->sequence + 1U;
+        head.boot = last->boot + 1U;
+    }
+
+    head.found = true;
+    return SECBOOT_DIAG_OK;
+}
 
-    /* 4.1 Get next log position (circular buffer) */
-    static uint32_t log_index = 0;
-    uint32_t log_addr = SECBOOT_DIAG_LOG_BASE + (log_index * SECBOOT_DIAG_LOG_SIZE);
+SECBOOT_Diag_TypeDef SECBOOT_Diag_LogEvent(SECBOOT_Diag_EventType event,uint8_t code,uint32_t data){
+    SECBOOT_Diag_LogEntry *entry;
+    uint32_t now = HAL_GetTick();
 
-    /* 4.2 Verify sector is erased */
-    if (*(uint32_t*)log_addr != 0xFFFFFFFF) {
-        HAL_FLASH_Lock();
-        return SECBOOT_DIAG_TAMPERED;
+    /* 1. Validate parameters */
+    if (event > SECBOOT_DIAG_ROLLBACK_ATTEMPT) {
+        return SECBOOT_DIAG_INVALID_PARAM;
     }
 
-    /* 4.3 Program entry in 64-bit chunks (STM32L5 requirement) */
-    uint64_t* pData = (uint64_t*)&entry;
-    for (uint8_t i = 0; i < SECBOOT_DIAG_LOG_SIZE/8; i++) {
-        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, log_addr + (i * 8), pData[i]) != HAL_OK) {
-            HAL_FLASH_Lock();
-            return SECBOOT_DIAG_ERROR;
+    /* 2. Coalesce with an identical staged event */
+    for (uint32_t i = 0; i < stageCount; i++) {
+        entry = &stage[i];
+        if (entry->event == (uint8_t)event && entry->error_code == code && entry->context_data == data) {
+            if (entry->count < UINT16_MAX) {
+                entry->count++;
+            }
+            entry->last_timestamp = now;
+            return SECBOOT_DIAG_OK;
         }
     }
 
-    HAL_FLASH_Lock();
+    /* 3. Stage full: write it out first */
+    if (stageCount == SECBOOT_DIAG_STAGE_SIZE) {
+        SECBOOT_Diag_TypeDef status = SECBOOT_Diag_Flush();
+        if (status != SECBOOT_DIAG_OK) {
+            return status;
+        }
+    }
 
-    /* 5. Update index with overflow protection */
-    log_index = (log_index + 1) % SECBOOT_DIAG_MAX_LOGS;
+    /* 4. Stage a new entry; sequence, boot and CRC are set by the flush */
+    entry = &stage[stageCount++];
+    memset(entry, 0xFF, sizeof(*entry));
+    entry->timestamp = now;
+    entry->last_timestamp = now;
+    entry->event = (uint8_t)event;
+    entry->error_code = code;
+    entry->count = 1;
+    entry->context_data = data;
 
-    /* 6. Verify write (anti-tamper measure) */
-    SECBOOT_Diag_LogEntry written_entry;
-    memcpy(&written_entry, (void*)log_addr, sizeof(written_entry));
-    
-    uint32_t verify_crc = 0;
+    return SECBOOT_DIAG_OK;
+}
+
+/**
+  * @brief  Program the staged events in one batch
+  * @retval SECBOOT_Diag_TypeDef Status
+  * @note   One unlock for the batch and at most one page erase, after the
+  *         entries that needed it have landed. Every entry is read back.
+  */
+SECBOOT_Diag_TypeDef SECBOOT_Diag_Flush(void) {
+    SECBOOT_Diag_TypeDef status = SECBOOT_DIAG_OK;
+    const SECBOOT_Diag_LogEntry *written[SECBOOT_DIAG_STAGE_SIZE];
+    uint32_t count = 0;
 
-    if(SECBOOT_CRC_Calculate((uint8_t*)&written_entry,(sizeof(written_entry) - sizeof(written_entry.crc)),&verify_crc) != SECBOOT_CRC_OK){
+    if (stageCount == 0) {
+        return SECBOOT_DIAG_OK;
+    }
+    if (!head.found && SECBOOT_Diag_Init() != SECBOOT_DIAG_OK) {
         return SECBOOT_DIAG_ERROR;
-    }                                      
+    }
 
-    if (written_entry.crc != verify_crc) {
-        return SECBOOT_DIAG_TAMPERED;
+    /* 1. Number and seal the batch */
+    for (uint32_t i = 0; i < stageCount; i++) {
+        stage[i].sequence = head.sequence + i;
+        stage[i].boot = head.boot;
+        if (SECBOOT_CRC_Calculate((uint8_t*)&stage[i], DIAG_CRC_SPAN, &stage[i].crc) != SECBOOT_CRC_OK) {
+            return SECBOOT_DIAG_ERROR;
+        }
     }
 
-    return SECBOOT_DIAG_OK;
+    /* 2. Program in one sequence */
+    HAL_FLASH_Unlock();
+    for (; count < stageCount && status == SECBOOT_DIAG_OK; count++) {
+        status = Diag_Program(&stage[count]);
+        written[count] = Diag_At(head.page, head.freeIndex - 1U);
+    }
+    HAL_FLASH_Lock();
 
-}
+    head.sequence += stageCount;
+    stageCount = 0;
 
+    /* 3. Verify write (anti-tamper measure) */
+    for (uint32_t i = 0; i < count && status == SECBOOT_DIAG_OK; i++) {
+        if (!Diag_IsIntact(written[i])) {
+            status = SECBOOT_DIAG_TAMPERED;
+        }
+    }
 
+    return status;
+}
 
 /**
   * @brief  Handles CRC verification failures with basic response policy
@@ -103,7 +288,7 @@ SECBOOT_Diag_TypeDef SECBOOT_Diag_LogEvent(SECBOOT_Diag_EventType event,uint8_t
 SECBOOT_Diag_ResponseLevel SECBOOT_Diag_HandleCrcFail(SECBOOT_CRC_StatusTypeDef status)
 {
     // 1. Always log the failure first
-    SECBOOT_Diag_LogEvent(SECBOOT_DIAG_CRC_FAIL, (uint8_t)status, HAL_GetTick());
+    SECBOOT_Diag_LogEvent(SECBOOT_DIAG_CRC_FAIL, (uint8_t)status, 0);
     
     // 2. Determine simple response
     SECBOOT_Diag_ResponseLevel response;
@@ -158,7 +343,7 @@ void try_recovery_from_backup(void)
     // 1. Log recovery attempt start
     SECBOOT_Diag_LogEvent(SECBOOT_DIAG_ROLLBACK_ATTEMPT, 
                          ROLLBACK_NORMAL_RECOVERY,  // Basic attempt code
-                         HAL_GetTick());
+                         0);
 
     // 2. Verify backup signature
     if(SECBOOT_BootManager_VerifyAppSignature(SECBOOT_BACKUP_IMAGE_ADDR) != SECBOOT_BOOTMANAGER_OK)
@@ -177,7 +362,7 @@ void try_recovery_from_backup(void)
         // 5. Log jump failure
         SECBOOT_Diag_LogEvent(SECBOOT_DIAG_ROLLBACK_ATTEMPT,
                              ROOLBACK_JUMP_FAILED,  // Jump fail code
-                             HAL_GetTick());
+                             0);
     }
 
     // 6. Final fallback (should never reach here)
@@ -192,6 +377,8 @@ void try_recovery_from_backup(void)
   */
 void system_lockdown(void)
 {
+    // Keep the events that led here
+    SECBOOT_Diag_Flush();
     while(1);
 }
 
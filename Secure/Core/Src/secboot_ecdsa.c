@@ -3,14 +3,47 @@
   * @brief   STM32L5 PKA-based ECDSA-P256 Signature Verification Implementation
   * @author  Soulaimane Oulad Belayachi
   * @date    2025-06-05
-  * @note    Uses HAL_PKA driver with prime256v1 curve parameters
+  * @note    Uses HAL_PKA driver with prime256v1 curve parameters. A PKA
+  *          timeout or computation error is retried with the software
+  *          verifier of secboot_p256.c (SECBOOT_ECDSA_SOFT_FALLBACK), which
+  *          is the only engine of SECBOOT_ECDSA_ENGINE_SOFT builds.
+  *          SECBOOT_ECDSA_Provision point-checks the bootloader's public
+  *          key once and keeps the PKA operands of its verifications in a
+  *          context, so the main, backup and update verifications only add
+  *          digest and signature.
   * @warning All buffers must be in accessible memory regions (secure/non-secure)
   */
 
 #include "secboot_ecdsa.h"
+#include "secboot_config.h"
+#include "secboot_diag.h"
+#include "secboot_p256.h"
+#include <string.h>
 
 static PKA_HandleTypeDef hpka;  ///< PKA hardware instance handle
 
+/** Background verification between Verify_Start and Verify_Finish */
+typedef struct {
+    bool open;
+    uint8_t *pDigest;
+    SECBOOT_ECC_Signature *pSignature;
+    SECBOOT_ECC_PublicKey *pPubKey;
+    SECBOOT_ECDSA_StatusTypeDef status;   ///< Start failure, or the software verdict
+} ECDSA_PendingTypeDef;
+
+/** Verifier context of the provisioned key, set by SECBOOT_ECDSA_Provision */
+typedef struct {
+    bool provisioned;
+    SECBOOT_ECDSA_StatusTypeDef keyStatus; ///< SECBOOT_ECDSA_OK or SECBOOT_ECDSA_INVALID_PUBKEY
+    SECBOOT_ECC_PublicKey key;             ///< Copy in secure SRAM
+    PKA_ECDSAVerifInTypeDef verifIn;       ///< Curve and key operands of every PKA verification
+} ECDSA_ContextTypeDef;
+
+static ECDSA_PendingTypeDef pending;
+static ECDSA_ContextTypeDef context;
+static volatile bool pkaDone = false;     ///< Raised by the HAL callbacks
+static volatile bool pkaFailed = false;
+
 /**
   * @brief  Initialize PKA peripheral for ECDSA operations
   * @retval SECBOOT_ECDSA_StatusTypeDef 
@@ -74,6 +107,227 @@ SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_DeInit(void)
     return SECBOOT_ECDSA_OK;
 }
 
+/**
+  * @brief  Whether pPubKey is the provisioned key of the context
+  */
+static bool ECDSA_IsProvisioned(const SECBOOT_ECC_PublicKey *pPubKey)
+{
+    return context.provisioned && memcmp(pPubKey, &context.key, sizeof(context.key)) == 0;
+}
+
+/**
+  * @brief  Point check with the software engine
+  */
+static SECBOOT_ECDSA_StatusTypeDef ECDSA_CheckKeySoft(const SECBOOT_ECC_PublicKey *pPubKey)
+{
+    return (SECBOOT_P256_CheckKey(pPubKey->Qx, pPubKey->Qy) == SECBOOT_P256_OK) ?
+           SECBOOT_ECDSA_OK : SECBOOT_ECDSA_INVALID_PUBKEY;
+}
+
+/**
+  * @brief  Verify with the software engine
+  */
+static SECBOOT_ECDSA_StatusTypeDef ECDSA_VerifySoft(const uint8_t *pDigest, const SECBOOT_ECC_Signature *pSignature,
+                                                    const SECBOOT_ECC_PublicKey *pPubKey)
+{
+    switch (SECBOOT_P256_Verify(pDigest, pSignature->R, pSignature->S, pPubKey->Qx, pPubKey->Qy)) {
+        case SECBOOT_P256_OK:
+            return SECBOOT_ECDSA_VERIFICATION_SUCCESS;
+        case SECBOOT_P256_INVALID_SIGNATURE:
+            return SECBOOT_ECDSA_INVALID_SIGNATURE;
+        case SECBOOT_P256_INVALID_PUBKEY:
+            return SECBOOT_ECDSA_INVALID_PUBKEY;
+        case SECBOOT_P256_INVALID_PARAM:
+            return SECBOOT_ECDSA_INVALID_PARAM;
+        default:
+            return SECBOOT_ECDSA_VERIFICATION_FAIL;
+    }
+}
+
+#if SECBOOT_ECDSA_ENGINE == SECBOOT_ECDSA_ENGINE_PKA
+/**
+  * @brief  Settle a PKA verdict: a PKA fault is logged and retried in software
+  */
+static SECBOOT_ECDSA_StatusTypeDef ECDSA_Settle(SECBOOT_ECDSA_StatusTypeDef status, const uint8_t *pDigest,
+                                                const SECBOOT_ECC_Signature *pSignature,
+                                                const SECBOOT_ECC_PublicKey *pPubKey)
+{
+#if SECBOOT_ECDSA_SOFT_FALLBACK
+    if (status == SECBOOT_ECDSA_PKA_TIMEOUT || status == SECBOOT_ECDSA_PKA_COMP_ERROR ||
+        status == SECBOOT_ECDSA_INVALID_STATE) {
+        SECBOOT_Diag_LogEvent(SECBOOT_DIAG_SIG_FAIL, SIG_FAIL_HW_FALLBACK, (uint32_t)status);
+        status = ECDSA_VerifySoft(pDigest, pSignature, pPubKey);
+    }
+#else
+    (void)pDigest;
+    (void)pSignature;
+    (void)pPubKey;
+#endif
+    return status;
+}
+#endif
+
+#if SECBOOT_ECDSA_ENGINE == SECBOOT_ECDSA_ENGINE_PKA || SECBOOT_ECDSA_BENCHMARK
+/**
+  * @brief  Fill the curve and key operands of a verification over prime256v1
+  * @retval false if the curve parameters are unavailable
+  */
+static bool ECDSA_FillKeyIn(PKA_ECDSAVerifInTypeDef *pIn, const SECBOOT_ECC_PublicKey *pPubKey)
+{
+    const ECC_Curve_Parameters *curve = get_prime256v1_curve();
+    if (!curve) {
+        return false;
+    }
+
+    pIn->primeOrderSize = curve->order_len;
+    pIn->modulusSize = curve->prime_len;
+    pIn->coefSign = curve->A_sign;
+    pIn->coef = curve->absA;
+    pIn->modulus = curve->prime;
+    pIn->basePointX = curve->Gx;
+    pIn->basePointY = curve->Gy;
+    pIn->primeOrder = curve->order;
+    pIn->pPubKeyCurvePtX = pPubKey->Qx;
+    pIn->pPubKeyCurvePtY = pPubKey->Qy;
+    return true;
+}
+
+/**
+  * @brief  Fill the PKA input of a verification, from the context for the
+  *         provisioned key
+  * @retval false if the curve parameters are unavailable
+  */
+static bool ECDSA_FillVerifIn(PKA_ECDSAVerifInTypeDef *pIn, uint8_t *pDigest, SECBOOT_ECC_Signature *pSignature,
+                              const SECBOOT_ECC_PublicKey *pPubKey)
+{
+    if (ECDSA_IsProvisioned(pPubKey)) {
+        *pIn = context.verifIn;
+    } else if (!ECDSA_FillKeyIn(pIn, pPubKey)) {
+        return false;
+    }
+    pIn->RSign = pSignature->R;
+    pIn->SSign = pSignature->S;
+    pIn->hash = pDigest;
+    return true;
+}
+
+/**
+  * @brief  Verify with the PKA
+  */
+static SECBOOT_ECDSA_StatusTypeDef ECDSA_VerifyPKA(uint8_t *pDigest, SECBOOT_ECC_Signature *pSignature,
+                                                   SECBOOT_ECC_PublicKey *pPubKey)
+{
+    PKA_ECDSAVerifInTypeDef Sig_verify;
+
+    /* Hardware state check */
+    if (HAL_PKA_GetState(&hpka) != HAL_PKA_STATE_READY) {
+        return SECBOOT_ECDSA_INVALID_STATE;
+    }
+
+    /* Configure PKA operation */
+    if (!ECDSA_FillVerifIn(&Sig_verify, pDigest, pSignature, pPubKey)) {
+        return SECBOOT_ECDSA_ERROR;
+    }
+
+    /* Execute verification */
+    HAL_StatusTypeDef hal_status = HAL_PKA_ECDSAVerif(&hpka, &Sig_verify, 
+                                                     SECBOOT_ECDSA_PKA_TIMEOUT_MS);
+    if (hal_status != HAL_OK) {
+        return (hal_status == HAL_TIMEOUT) ? 
+               SECBOOT_ECDSA_PKA_TIMEOUT : 
+               SECBOOT_ECDSA_PKA_COMP_ERROR;
+    }
+
+    /* Check result */
+    return HAL_PKA_ECDSAVerif_IsValidSignature(&hpka) ? 
+           SECBOOT_ECDSA_VERIFICATION_SUCCESS : 
+           SECBOOT_ECDSA_VERIFICATION_FAIL;
+}
+#endif
+
+#if SECBOOT_ECDSA_ENGINE == SECBOOT_ECDSA_ENGINE_PKA
+/**
+  * @brief  Point check with the PKA
+  * @note   The PKA reduces its operands, so the range of the coordinates is
+  *         checked here: big-endian, equal lengths, memcmp orders them
+  */
+static SECBOOT_ECDSA_StatusTypeDef ECDSA_CheckKeyPKA(const SECBOOT_ECC_PublicKey *pPubKey)
+{
+    const ECC_Curve_Parameters *curve = get_prime256v1_curve();
+    PKA_PointCheckInTypeDef Point_check;
+
+    if (!curve) {
+        return SECBOOT_ECDSA_ERROR;
+    }
+    if (HAL_PKA_GetState(&hpka) != HAL_PKA_STATE_READY) {
+        return SECBOOT_ECDSA_INVALID_STATE;
+    }
+    if (memcmp(pPubKey->Qx, curve->prime, ECC_PUBKEY_QX_SIZE) >= 0 ||
+        memcmp(pPubKey->Qy, curve->prime, ECC_PUBKEY_QY_SIZE) >= 0) {
+        return SECBOOT_ECDSA_INVALID_PUBKEY;
+    }
+
+    Point_check.modulusSize = curve->prime_len;
+    Point_check.coefSign = curve->A_sign;
+    Point_check.coefA = curve->absA;
+    Point_check.coefB = curve->B;
+    Point_check.modulus = curve->prime;
+    Point_check.pointX = pPubKey->Qx;
+    Point_check.pointY = pPubKey->Qy;
+
+    HAL_StatusTypeDef hal_status = HAL_PKA_PointCheck(&hpka, &Point_check, SECBOOT_ECDSA_PKA_TIMEOUT_MS);
+    if (hal_status != HAL_OK) {
+        return (hal_status == HAL_TIMEOUT) ?
+               SECBOOT_ECDSA_PKA_TIMEOUT :
+               SECBOOT_ECDSA_PKA_COMP_ERROR;
+    }
+
+    return HAL_PKA_PointCheck_IsOnCurve(&hpka) ? SECBOOT_ECDSA_OK : SECBOOT_ECDSA_INVALID_PUBKEY;
+}
+#endif
+
+SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_Provision(const SECBOOT_ECC_PublicKey *pPubKey)
+{
+    SECBOOT_ECDSA_StatusTypeDef status;
+
+    if (!pPubKey) {
+        return SECBOOT_ECDSA_INVALID_PARAM;
+    }
+    if (pending.open) {
+        return SECBOOT_ECDSA_INVALID_STATE;
+    }
+    memset(&context, 0, sizeof(context));
+
+#if SECBOOT_ECDSA_ENGINE == SECBOOT_ECDSA_ENGINE_SOFT
+    status = ECDSA_CheckKeySoft(pPubKey);
+#else
+    status = ECDSA_CheckKeyPKA(pPubKey);
+#if SECBOOT_ECDSA_SOFT_FALLBACK
+    if (status == SECBOOT_ECDSA_PKA_TIMEOUT || status == SECBOOT_ECDSA_PKA_COMP_ERROR ||
+        status == SECBOOT_ECDSA_INVALID_STATE) {
+        SECBOOT_Diag_LogEvent(SECBOOT_DIAG_SIG_FAIL, SIG_FAIL_HW_FALLBACK, (uint32_t)status);
+        status = ECDSA_CheckKeySoft(pPubKey);
+    }
+#endif
+#endif
+
+    /* A PKA fault leaves the key unprovisioned: verified as any other key */
+    if (status != SECBOOT_ECDSA_OK && status != SECBOOT_ECDSA_INVALID_PUBKEY) {
+        return status;
+    }
+
+    context.key = *pPubKey;
+#if SECBOOT_ECDSA_ENGINE == SECBOOT_ECDSA_ENGINE_PKA
+    if (!ECDSA_FillKeyIn(&context.verifIn, &context.key)) {
+        memset(&context, 0, sizeof(context));
+        return SECBOOT_ECDSA_ERROR;
+    }
+#endif
+    context.keyStatus = status;
+    context.provisioned = true;
+    return status;
+}
+
 /**
   * @brief  Perform ECDSA signature verification
   * @param  pDigest     32-byte SHA-256 hash
@@ -81,7 +335,9 @@ SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_DeInit(void)
   * @param  pSignature  Signature to verify
   * @param  pPubKey     Trusted public key
   * @retval SECBOOT_ECDSA_StatusTypeDef
-  * @note   Uses PKA hardware for constant-time verification
+  * @note   Uses PKA hardware for constant-time verification; a PKA fault
+  *         is logged and the signature is checked in software instead, so
+  *         the caller only sees the verdict
   */
 SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_Verify_Signature(
     uint8_t* pDigest,
@@ -98,45 +354,198 @@ SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_Verify_Signature(
         return SECBOOT_ECDSA_INVALID_PARAM;
     }
 
-    /* Hardware state check */
+    /* The PKA belongs to the background verification until its Finish */
+    if (pending.open) {
+        return SECBOOT_ECDSA_INVALID_STATE;
+    }
+
+    if (ECDSA_IsProvisioned(pPubKey) && context.keyStatus != SECBOOT_ECDSA_OK) {
+        return SECBOOT_ECDSA_INVALID_PUBKEY;
+    }
+
+#if SECBOOT_ECDSA_ENGINE == SECBOOT_ECDSA_ENGINE_SOFT
+    return ECDSA_VerifySoft(pDigest, pSignature, pPubKey);
+#else
+    return ECDSA_Settle(ECDSA_VerifyPKA(pDigest, pSignature, pPubKey), pDigest, pSignature, pPubKey);
+#endif
+}
+
+SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_Verify_Start(uint8_t *pDigest, SECBOOT_ECC_Signature *pSignature,
+                                                       SECBOOT_ECC_PublicKey *pPubKey)
+{
+    if (!pDigest || !pSignature || !pPubKey) {
+        return SECBOOT_ECDSA_INVALID_PARAM;
+    }
+    if (pending.open) {
+        return SECBOOT_ECDSA_INVALID_STATE;
+    }
+
+    pending.open = true;
+    pending.pDigest = pDigest;
+    pending.pSignature = pSignature;
+    pending.pPubKey = pPubKey;
+    pkaDone = false;
+    pkaFailed = false;
+
+    if (ECDSA_IsProvisioned(pPubKey) && context.keyStatus != SECBOOT_ECDSA_OK) {
+        pending.status = SECBOOT_ECDSA_INVALID_PUBKEY;
+        pkaDone = true;
+        return SECBOOT_ECDSA_OK;
+    }
+
+#if SECBOOT_ECDSA_ENGINE == SECBOOT_ECDSA_ENGINE_SOFT
+    pending.status = ECDSA_VerifySoft(pDigest, pSignature, pPubKey);
+    pkaDone = true;
+#else
+    PKA_ECDSAVerifInTypeDef Sig_verify;
+
+    /* A start failure is settled by Finish like a fault of the operation */
     if (HAL_PKA_GetState(&hpka) != HAL_PKA_STATE_READY) {
+        pending.status = SECBOOT_ECDSA_INVALID_STATE;
+        pkaDone = true;
+    } else if (!ECDSA_FillVerifIn(&Sig_verify, pDigest, pSignature, pPubKey)) {
+        pending.status = SECBOOT_ECDSA_ERROR;
+        pkaDone = true;
+    } else {
+        HAL_NVIC_SetPriority(PKA_IRQn, SECBOOT_ECDSA_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(PKA_IRQn);
+
+        /* The HAL loads the operands into PKA RAM before returning */
+        if (HAL_PKA_ECDSAVerif_IT(&hpka, &Sig_verify) != HAL_OK) {
+            HAL_NVIC_DisableIRQ(PKA_IRQn);
+            pending.status = SECBOOT_ECDSA_PKA_COMP_ERROR;
+            pkaDone = true;
+        } else {
+            pending.status = SECBOOT_ECDSA_OK;
+        }
+    }
+#endif
+    return SECBOOT_ECDSA_OK;
+}
+
+bool SECBOOT_ECDSA_Verify_Busy(void)
+{
+    return pending.open && !pkaDone;
+}
+
+SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_Verify_Finish(void)
+{
+    SECBOOT_ECDSA_StatusTypeDef status;
+
+    if (!pending.open) {
         return SECBOOT_ECDSA_INVALID_STATE;
     }
 
-    /* Get curve parameters */
-    const ECC_Curve_Parameters *curve = get_prime256v1_curve();
-    if (!curve) {
-        return SECBOOT_ECDSA_ERROR;
+    /* Checked with interrupts masked so the completion cannot slip in
+       between the test and the WFI */
+    while (!pkaDone) {
+        __disable_irq();
+        if (!pkaDone) {
+            __WFI();
+        }
+        __enable_irq();
     }
 
-    /* Configure PKA operation */
-    PKA_ECDSAVerifInTypeDef Sig_verify = {
-        .primeOrderSize = curve->order_len,
-        .modulusSize = curve->prime_len,
-        .coefSign = curve->A_sign,
-        .coef = curve->absA,
-        .modulus = curve->prime,
-        .basePointX = curve->Gx,
-        .basePointY = curve->Gy,
-        .primeOrder = curve->order,
-        .pPubKeyCurvePtX = pPubKey->Qx,
-        .pPubKeyCurvePtY = pPubKey->Qy,
-        .RSign = pSignature->R,
-        .SSign = pSignature->S,
-        .hash = pDigest
-    };
+#if SECBOOT_ECDSA_ENGINE == SECBOOT_ECDSA_ENGINE_SOFT
+    status = pending.status;
+#else
+    if (pending.status != SECBOOT_ECDSA_OK) {
+        status = pending.status;
+    } else {
+        HAL_NVIC_DisableIRQ(PKA_IRQn);
+        if (pkaFailed) {
+            status = SECBOOT_ECDSA_PKA_COMP_ERROR;
+        } else {
+            status = HAL_PKA_ECDSAVerif_IsValidSignature(&hpka) ?
+                     SECBOOT_ECDSA_VERIFICATION_SUCCESS :
+                     SECBOOT_ECDSA_VERIFICATION_FAIL;
+        }
+    }
+    status = ECDSA_Settle(status, pending.pDigest, pending.pSignature, pending.pPubKey);
+#endif
 
-    /* Execute verification */
-    HAL_StatusTypeDef hal_status = HAL_PKA_ECDSAVerif(&hpka, &Sig_verify, 
-                                                     SECBOOT_ECDSA_PKA_TIMEOUT_MS);
-    if (hal_status != HAL_OK) {
-        return (hal_status == HAL_TIMEOUT) ? 
-               SECBOOT_ECDSA_PKA_TIMEOUT : 
-               SECBOOT_ECDSA_PKA_COMP_ERROR;
+    memset(&pending, 0, sizeof(pending));
+    return status;
+}
+
+void SECBOOT_ECDSA_IRQHandler(void)
+{
+    HAL_PKA_IRQHandler(&hpka);
+}
+
+/**
+  * @brief  PKA end of operation; the verdict is read in thread mode
+  */
+void HAL_PKA_OperationCpltCallback(PKA_HandleTypeDef *pHpka)
+{
+    (void)pHpka;
+    pkaDone = true;
+}
+
+/**
+  * @brief  PKA RAM or address error during the operation
+  */
+void HAL_PKA_ErrorCallback(PKA_HandleTypeDef *pHpka)
+{
+    (void)pHpka;
+    pkaFailed = true;
+    pkaDone = true;
+}
+
+#if SECBOOT_ECDSA_BENCHMARK
+/* Signature of SHA-256("SecBoot ECDSA benchmark") under a throwaway key */
+static const uint8_t bench_digest[] = {
+    0x2c, 0xf9, 0x87, 0xdb, 0xc6, 0xcc, 0x53, 0xb6, 0x2d, 0x40, 0xf5, 0x3c, 0xf1, 0xc4, 0xcf, 0x98,
+    0x2a, 0x63, 0xe6, 0x07, 0xf2, 0x7b, 0x27, 0x37, 0xaf, 0xbc, 0xc7, 0xe8, 0x7b, 0xeb, 0x12, 0xfa
+};
+static const SECBOOT_ECC_PublicKey bench_key = {
+    .Qx = {
+        0xd4, 0x86, 0x3a, 0x4f, 0x9b, 0x9d, 0xd1, 0xbf, 0x32, 0x44, 0x88, 0xa1, 0x34, 0xb0, 0xc4, 0xfc,
+        0xda, 0x82, 0x74, 0xd9, 0x8e, 0x58, 0xe6, 0xa5, 0xbc, 0x78, 0x30, 0x7c, 0x6e, 0x51, 0x97, 0x8f
+    },
+    .Qy = {
+        0x68, 0x72, 0xb3, 0xf7, 0x86, 0xf2, 0xe9, 0x62, 0x87, 0x03, 0x92, 0x7d, 0xd0, 0x6b, 0x3a, 0x42,
+        0xfb, 0x95, 0xdb, 0x21, 0x70, 0x67, 0x3b, 0xb0, 0x5b, 0x43, 0xf5, 0x49, 0x4a, 0xc7, 0x6b, 0xba
+    }
+};
+static const SECBOOT_ECC_Signature bench_signature = {
+    .R = {
+        0x2a, 0x0b, 0x0e, 0x94, 0xbe, 0x6a, 0x0a, 0x69, 0xaa, 0x6a, 0x31, 0xe5, 0x9a, 0x81, 0xe4, 0xfb,
+        0x91, 0x09, 0xa4, 0x5e, 0x87, 0x03, 0x40, 0x28, 0xf8, 0x8a, 0x70, 0x6b, 0x83, 0x78, 0x0f, 0xaf
+    },
+    .S = {
+        0xfa, 0x51, 0xd7, 0xf9, 0x80, 0x2c, 0x8e, 0x57, 0x43, 0xc9, 0xbd, 0x06, 0x7d, 0x5e, 0x34, 0xe5,
+        0x59, 0x75, 0xa3, 0x0f, 0xf6, 0x6f, 0x49, 0x89, 0xdd, 0x66, 0x32, 0xa6, 0x20, 0xff, 0x07, 0xbd
     }
+};
 
-    /* Check result */
-    return HAL_PKA_ECDSAVerif_IsValidSignature(&hpka) ? 
-           SECBOOT_ECDSA_VERIFICATION_SUCCESS : 
-           SECBOOT_ECDSA_VERIFICATION_FAIL;
-}
\ No newline at end of file
+/**
+  * @brief  Time both engines on the same signature with the DWT cycle counter
+  */
+SECBOOT_ECDSA_StatusTypeDef SECBOOT_ECDSA_Benchmark(SECBOOT_ECDSA_BenchmarkTypeDef *pResult)
+{
+    uint8_t digest[SECBOOT_ECDSA_SHA256_DIGEST_SIZE];
+    SECBOOT_ECC_PublicKey key = bench_key;
+    SECBOOT_ECC_Signature signature = bench_signature;
+    uint32_t start;
+
+    if (!pResult) {
+        return SECBOOT_ECDSA_INVALID_PARAM;
+    }
+    memcpy(digest, bench_digest, sizeof(digest));
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    start = DWT->CYCCNT;
+    pResult->pkaStatus = ECDSA_VerifyPKA(digest, &signature, &key);
+    pResult->pkaCycles = DWT->CYCCNT - start;
+
+    start = DWT->CYCCNT;
+    pResult->softStatus = ECDSA_VerifySoft(digest, &signature, &key);
+    pResult->softCycles = DWT->CYCCNT - start;
+
+    return (pResult->pkaStatus == SECBOOT_ECDSA_VERIFICATION_SUCCESS &&
+            pResult->softStatus == SECBOOT_ECDSA_VERIFICATION_SUCCESS) ? SECBOOT_ECDSA_OK : SECBOOT_ECDSA_ERROR;
+}
+#endif /* SECBOOT_ECDSA_BENCHMARK */
\ No newline at end of file
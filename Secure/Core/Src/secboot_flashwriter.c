@@ -0,0 +1,340 @@
+/**
+  * @file    secboot_flashwriter.c
+  * @brief   Interrupt-completed flash writer for STM32L5 image installs
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    The HAL callbacks only raise flags; all writer state is updated
+  *          in thread mode by FlashWriter_Complete, so the queue needs no
+  *          critical sections.
+  */
+
+#include "secboot_flashwriter.h"
+#include <string.h>
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct {
+    const uint8_t *data;
+    uint32_t length;
+} FlashWriter_Buffer;
+
+typedef struct {
+    bool     open;
+    bool     failed;             ///< An operation failed; the writer is stuck
+    bool     inFlight;           ///< An erase or program was started
+    bool     eraseInFlight;      ///< The operation in flight is a page erase
+    uint32_t programType;        ///< FLASH_TYPEPROGRAM_DOUBLEWORD[_NS]
+    uint32_t eraseType;          ///< FLASH_TYPEERASE_PAGES[_NS]
+    uint32_t bank;               ///< FLASH_BANK_1 or FLASH_BANK_2
+    uint32_t bankBase;           ///< Address of page 0 of the bank
+    IRQn_Type irq;               ///< FLASH_IRQn (non-secure ops) or FLASH_S_IRQn
+    uint32_t regionEnd;          ///< End of the region (page aligned)
+    uint32_t erasedEnd;          ///< Pages below this address are erased
+    uint32_t writeCursor;        ///< Next double-word to program
+    uint32_t queuedEnd;          ///< Write cursor once the queue is drained
+    FlashWriter_Buffer queue[SECBOOT_FLASHWRITER_QUEUE_DEPTH];
+    uint32_t head;               ///< Oldest queued buffer
+    uint32_t count;              ///< Queued buffers
+    uint32_t headOffset;         ///< Bytes of the oldest buffer programmed
+} FlashWriter_StateTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static FlashWriter_StateTypeDef writer;
+static volatile bool opDone = false;
+static volatile bool opFailed = false;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Move the write cursor past one double-word of the oldest buffer
+  */
+static void FlashWriter_Advance(void)
+{
+    writer.writeCursor += sizeof(uint64_t);
+    writer.headOffset += sizeof(uint64_t);
+    if (writer.headOffset == writer.queue[writer.head].length) {
+        writer.head = (writer.head + 1U) % SECBOOT_FLASHWRITER_QUEUE_DEPTH;
+        writer.count--;
+        writer.headOffset = 0;
+    }
+}
+
+/**
+  * @brief  Account the operation that just completed
+  */
+static void FlashWriter_Complete(void)
+{
+    if (!writer.inFlight || !opDone) {
+        return;
+    }
+
+    writer.inFlight = false;
+    opDone = false;
+
+    if (opFailed) {
+        writer.failed = true;
+        return;
+    }
+
+    if (writer.eraseInFlight) {
+        writer.erasedEnd += FLASH_PAGE_SIZE;
+        return;
+    }
+
+    FlashWriter_Advance();
+}
+
+/**
+  * @brief  Sleep until the operation in flight completes
+  * @note   WFI with PRIMASK set still wakes on the pending interrupt, which
+  *         then runs once PRIMASK is cleared: no wake-up is lost between
+  *         the check and the WFI.
+  */
+static void FlashWriter_Sleep(void)
+{
+    __disable_irq();
+    if (writer.inFlight && !opDone) {
+        __WFI();
+    }
+    __enable_irq();
+}
+
+static bool FlashWriter_Drained(void)
+{
+    return !writer.inFlight && writer.count == 0 && writer.erasedEnd >= writer.regionEnd;
+}
+
+static void FlashWriter_Release(void)
+{
+    HAL_NVIC_DisableIRQ(writer.irq);
+    HAL_FLASH_Lock();
+    writer.open = false;
+    writer.count = 0;
+}
+
+/* Function implementations --------------------------------------------------*/
+
+SECBOOT_FlashWriter_StatusTypeDef SECBOOT_FlashWriter_Open(uint32_t address, uint32_t length)
+{
+    uint32_t flash_base;
+    uint32_t offset;
+    uint32_t end_offset;
+
+    if (writer.open) {
+        return SECBOOT_FLASHWRITER_BUSY;
+    }
+
+    if (address >= FLASH_BASE_NS && address < FLASH_BASE_NS + FLASH_SIZE) {
+        flash_base = FLASH_BASE_NS;
+    } else if (address >= FLASH_BASE_S && address < FLASH_BASE_S + FLASH_SIZE) {
+        flash_base = FLASH_BASE_S;
+    } else {
+        return SECBOOT_FLASHWRITER_INVALID_PARAM;
+    }
+
+    offset = address - flash_base;
+    if (length == 0 || (offset % FLASH_PAGE_SIZE) != 0 || length > FLASH_SIZE - offset) {
+        return SECBOOT_FLASHWRITER_INVALID_PARAM;
+    }
+
+    // Erase and program work per bank: the region may not straddle them
+    end_offset = offset + length - 1U;
+    if ((offset / FLASH_BANK_SIZE) != (end_offset / FLASH_BANK_SIZE)) {
+        return SECBOOT_FLASHWRITER_INVALID_PARAM;
+    }
+
+    memset(&writer, 0, sizeof(writer));
+    opDone = false;
+    opFailed = false;
+
+    if (flash_base == FLASH_BASE_NS) {
+        writer.programType = FLASH_TYPEPROGRAM_DOUBLEWORD_NS;
+        writer.eraseType = FLASH_TYPEERASE_PAGES_NS;
+        writer.irq = FLASH_IRQn;
+    } else {
+        writer.programType = FLASH_TYPEPROGRAM_DOUBLEWORD;
+        writer.eraseType = FLASH_TYPEERASE_PAGES;
+        writer.irq = FLASH_S_IRQn;
+    }
+    writer.bank = (offset < FLASH_BANK_SIZE) ? FLASH_BANK_1 : FLASH_BANK_2;
+    writer.bankBase = flash_base + ((writer.bank == FLASH_BANK_1) ? 0U : FLASH_BANK_SIZE);
+    writer.regionEnd = address + (((length + FLASH_PAGE_SIZE - 1U) / FLASH_PAGE_SIZE) * FLASH_PAGE_SIZE);
+    writer.erasedEnd = address;
+    writer.writeCursor = address;
+    writer.queuedEnd = address;
+    writer.open = true;
+
+    HAL_FLASH_Unlock();
+    HAL_NVIC_SetPriority(writer.irq, SECBOOT_FLASHWRITER_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(writer.irq);
+
+    return SECBOOT_FlashWriter_Poll();
+}
+
+SECBOOT_FlashWriter_StatusTypeDef SECBOOT_FlashWriter_Queue(const uint8_t *data, uint32_t length)
+{
+    uint32_t tail;
+
+    if (!writer.open || data == NULL || length == 0 || (length % sizeof(uint64_t)) != 0) {
+        return SECBOOT_FLASHWRITER_INVALID_PARAM;
+    }
+    if (length > writer.regionEnd - writer.queuedEnd) {
+        return SECBOOT_FLASHWRITER_INVALID_PARAM;
+    }
+
+    FlashWriter_Complete();
+    if (writer.count == SECBOOT_FLASHWRITER_QUEUE_DEPTH) {
+        return SECBOOT_FLASHWRITER_BUSY;
+    }
+
+    tail = (writer.head + writer.count) % SECBOOT_FLASHWRITER_QUEUE_DEPTH;
+    writer.queue[tail].data = data;
+    writer.queue[tail].length = length;
+    writer.count++;
+    writer.queuedEnd += length;
+
+    return SECBOOT_FlashWriter_Poll();
+}
+
+SECBOOT_FlashWriter_StatusTypeDef SECBOOT_FlashWriter_Poll(void)
+{
+    if (!writer.open) {
+        return SECBOOT_FLASHWRITER_INVALID_PARAM;
+    }
+
+    FlashWriter_Complete();
+    if (writer.failed) {
+        return SECBOOT_FLASHWRITER_FLASH_ERROR;
+    }
+    if (writer.inFlight) {
+        return SECBOOT_FLASHWRITER_OK;
+    }
+
+    opFailed = false;
+
+    while (writer.count > 0 && writer.writeCursor < writer.erasedEnd) {
+        // Data ready over an erased page: program the next double-word
+        uint64_t dword;
+
+        memcpy(&dword, writer.queue[writer.head].data + writer.headOffset, sizeof(dword));
+        if (dword == UINT64_MAX) {
+            // Already the erased value: leave it erased
+            FlashWriter_Advance();
+            continue;
+        }
+
+        writer.eraseInFlight = false;
+        writer.inFlight = true;
+        if (HAL_FLASH_Program_IT(writer.programType, writer.writeCursor, dword) != HAL_OK) {
+            writer.inFlight = false;
+            writer.failed = true;
+        }
+        break;
+    }
+
+    if (!writer.inFlight && !writer.failed && writer.erasedEnd < writer.regionEnd &&
+        (writer.count == 0 || writer.writeCursor >= writer.erasedEnd)) {
+        // Nothing to program yet: erase ahead of the write cursor
+        FLASH_EraseInitTypeDef erase = {0};
+
+        erase.TypeErase = writer.eraseType;
+        erase.Banks = writer.bank;
+        erase.Page = (writer.erasedEnd - writer.bankBase) / FLASH_PAGE_SIZE;
+        erase.NbPages = 1;
+
+        writer.eraseInFlight = true;
+        writer.inFlight = true;
+        if (HAL_FLASHEx_Erase_IT(&erase) != HAL_OK) {
+            writer.inFlight = false;
+            writer.failed = true;
+        }
+    }
+
+    return writer.failed ? SECBOOT_FLASHWRITER_FLASH_ERROR : SECBOOT_FLASHWRITER_OK;
+}
+
+SECBOOT_FlashWriter_StatusTypeDef SECBOOT_FlashWriter_WaitSlot(void)
+{
+    SECBOOT_FlashWriter_StatusTypeDef status;
+
+    if (!writer.open) {
+        return SECBOOT_FLASHWRITER_INVALID_PARAM;
+    }
+
+    while ((status = SECBOOT_FlashWriter_Poll()) == SECBOOT_FLASHWRITER_OK &&
+           writer.count == SECBOOT_FLASHWRITER_QUEUE_DEPTH) {
+        FlashWriter_Sleep();
+    }
+    return status;
+}
+
+SECBOOT_FlashWriter_StatusTypeDef SECBOOT_FlashWriter_Settle(void)
+{
+    if (!writer.open) {
+        return SECBOOT_FLASHWRITER_INVALID_PARAM;
+    }
+
+    while (writer.inFlight && !opDone) {
+        FlashWriter_Sleep();
+    }
+    FlashWriter_Complete();
+
+    return writer.failed ? SECBOOT_FLASHWRITER_FLASH_ERROR : SECBOOT_FLASHWRITER_OK;
+}
+
+SECBOOT_FlashWriter_StatusTypeDef SECBOOT_FlashWriter_Close(void)
+{
+    SECBOOT_FlashWriter_StatusTypeDef status;
+
+    if (!writer.open) {
+        return SECBOOT_FLASHWRITER_INVALID_PARAM;
+    }
+
+    while ((status = SECBOOT_FlashWriter_Poll()) == SECBOOT_FLASHWRITER_OK && !FlashWriter_Drained()) {
+        FlashWriter_Sleep();
+    }
+
+    if (status != SECBOOT_FLASHWRITER_OK) {
+        SECBOOT_FlashWriter_Abort();
+        return status;
+    }
+
+    FlashWriter_Release();
+    return SECBOOT_FLASHWRITER_OK;
+}
+
+void SECBOOT_FlashWriter_Abort(void)
+{
+    if (!writer.open) {
+        return;
+    }
+
+    while (writer.inFlight && !opDone) {
+        FlashWriter_Sleep();
+    }
+    writer.inFlight = false;
+    opDone = false;
+
+    FlashWriter_Release();
+}
+
+/* HAL callbacks -------------------------------------------------------------*/
+
+/**
+  * @brief  End of a page erase or double-word program (FLASH IRQ context)
+  */
+void HAL_FLASH_EndOfOperationCallback(uint32_t ReturnValue)
+{
+    (void)ReturnValue;
+    opDone = true;
+}
+
+/**
+  * @brief  Failed page erase or double-word program (FLASH IRQ context)
+  */
+void HAL_FLASH_OperationErrorCallback(uint32_t ReturnValue)
+{
+    (void)ReturnValue;
+    opFailed = true;
+    opDone = true;
+}
@@ -0,0 +1,157 @@
+/**
+  * @file    secboot_lz.c
+  * @brief   Streaming LZSS decompressor for compressed update images
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    Every output byte also goes into the history ring, so a match
+  *          may overlap the bytes it produces (runs).
+  */
+
+#include "secboot_lz.h"
+#include <stddef.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define LZ_WINDOW_MASK    (SECBOOT_LZ_WINDOW_SIZE - 1U)
+#define LZ_LENGTH_MASK    ((1U << SECBOOT_LZ_LENGTH_BITS) - 1U)
+#define LZ_FLAG_BITS      8U
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Take the next compressed byte, refilling the input buffer as needed
+  */
+static SECBOOT_LZ_StatusTypeDef LZ_NextByte(SECBOOT_LZ_Context *ctx, uint8_t *pByte) {
+    if (ctx->inputPos == ctx->inputLen) {
+        uint32_t chunk = ctx->inputRemaining;
+
+        if (chunk == 0) {
+            return SECBOOT_LZ_CORRUPT;
+        }
+        if (chunk > SECBOOT_LZ_INPUT_SIZE) {
+            chunk = SECBOOT_LZ_INPUT_SIZE;
+        }
+        if (ctx->read(ctx->source, ctx->input, chunk) != SECBOOT_LZ_OK) {
+            return SECBOOT_LZ_READ_ERROR;
+        }
+        ctx->inputRemaining -= chunk;
+        ctx->inputPos = 0;
+        ctx->inputLen = chunk;
+    }
+
+    *pByte = ctx->input[ctx->inputPos++];
+    return SECBOOT_LZ_OK;
+}
+
+/**
+  * @brief  Decode the next token: one literal into pByte, or start a match
+  * @param  pLiteral  Set when pByte holds a literal
+  */
+static SECBOOT_LZ_StatusTypeDef LZ_NextToken(SECBOOT_LZ_Context *ctx, uint8_t *pByte, bool *pLiteral) {
+    SECBOOT_LZ_StatusTypeDef status;
+    uint8_t lo;
+    uint8_t hi;
+    uint32_t token;
+
+    if (ctx->flagCount == 0) {
+        uint8_t flags;
+
+        status = LZ_NextByte(ctx, &flags);
+        if (status != SECBOOT_LZ_OK) {
+            return status;
+        }
+        ctx->flags = flags;
+        ctx->flagCount = LZ_FLAG_BITS;
+    }
+
+    *pLiteral = (ctx->flags & 1U) == 0U;
+    ctx->flags >>= 1;
+    ctx->flagCount--;
+
+    if (*pLiteral) {
+        return LZ_NextByte(ctx, pByte);
+    }
+
+    status = LZ_NextByte(ctx, &lo);
+    if (status == SECBOOT_LZ_OK) {
+        status = LZ_NextByte(ctx, &hi);
+    }
+    if (status != SECBOOT_LZ_OK) {
+        return status;
+    }
+
+    token = (uint32_t)lo | ((uint32_t)hi << 8);
+    ctx->matchOffset = (token >> SECBOOT_LZ_LENGTH_BITS) + 1U;
+    ctx->matchRemaining = (token & LZ_LENGTH_MASK) + SECBOOT_LZ_MIN_MATCH;
+
+    // A match may only reach back into bytes already produced
+    if (ctx->matchOffset > ctx->produced) {
+        return SECBOOT_LZ_CORRUPT;
+    }
+    return SECBOOT_LZ_OK;
+}
+
+/* Function implementations --------------------------------------------------*/
+
+SECBOOT_LZ_StatusTypeDef SECBOOT_LZ_Init(SECBOOT_LZ_Context *ctx, SECBOOT_LZ_ReadFn read, void *source,
+                                         uint32_t compressedSize) {
+    if (ctx == NULL || read == NULL || compressedSize == 0) {
+        return SECBOOT_LZ_INVALID_PARAM;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->read = read;
+    ctx->source = source;
+    ctx->inputRemaining = compressedSize;
+
+    return SECBOOT_LZ_OK;
+}
+
+SECBOOT_LZ_StatusTypeDef SECBOOT_LZ_Output(SECBOOT_LZ_Context *ctx, uint8_t *pOut, uint32_t length) {
+    SECBOOT_LZ_StatusTypeDef status;
+
+    if (ctx == NULL || pOut == NULL) {
+        return SECBOOT_LZ_INVALID_PARAM;
+    }
+
+    while (length > 0) {
+        uint8_t byte;
+
+        if (ctx->matchRemaining > 0) {
+            byte = ctx->window[(ctx->produced - ctx->matchOffset) & LZ_WINDOW_MASK];
+            ctx->matchRemaining--;
+        } else {
+            bool literal;
+
+            status = LZ_NextToken(ctx, &byte, &literal);
+            if (status != SECBOOT_LZ_OK) {
+                return status;
+            }
+            if (!literal) {
+                continue;
+            }
+        }
+
+        ctx->window[ctx->produced & LZ_WINDOW_MASK] = byte;
+        ctx->produced++;
+        *pOut++ = byte;
+        length--;
+    }
+
+    return SECBOOT_LZ_OK;
+}
+
+SECBOOT_LZ_StatusTypeDef SECBOOT_LZ_Finish(SECBOOT_LZ_Context *ctx) {
+    SECBOOT_LZ_StatusTypeDef status = SECBOOT_LZ_OK;
+
+    if (ctx == NULL) {
+        return SECBOOT_LZ_INVALID_PARAM;
+    }
+
+    if (ctx->matchRemaining != 0 || ctx->inputPos != ctx->inputLen || ctx->inputRemaining != 0) {
+        status = SECBOOT_LZ_CORRUPT;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    return status;
+}
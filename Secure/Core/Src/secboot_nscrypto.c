@@ -0,0 +1,227 @@
+/**
+  * @file    secboot_nscrypto.c
+  * @brief   Crypto engines offered to the non-secure application
+  * @date    2026-10-16
+  * @version 1.0
+  */
+
+#include "secboot_nscrypto.h"
+#include "secboot_config.h"
+#include "secboot_sha256.h"
+#include "secboot_aes.h"
+#include "secboot_ecdsa.h"
+#include <arm_cmse.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define NSCRYPTO_READ     (CMSE_NONSECURE | CMSE_MPU_READ)
+#define NSCRYPTO_WRITE    (CMSE_NONSECURE | CMSE_MPU_READWRITE)
+
+/* Private variables ---------------------------------------------------------*/
+static SECBOOT_SHA256_Context stream_ctx;     ///< Streaming SHA-256 of the non-secure side
+static bool stream_open = false;
+static const NSC_CryptoRequestTypeDef *stream_queue; ///< Queue that opened the stream
+static SECBOOT_AES_CipherContext cipher_ctx;  ///< Kept off the secure stack
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Check a buffer against the shared window and the SAU/MPU
+  * @note   A zero length accepts any pointer; it is not dereferenced.
+  */
+static bool NSCrypto_Shared(const void *p, uint32_t length, int flags)
+{
+    uintptr_t address = (uintptr_t)p;
+
+    if (length == 0U) {
+        return true;
+    }
+    if (address < SECBOOT_NSC_SHARED_BASE || length > SECBOOT_NSC_SHARED_SIZE ||
+        address - SECBOOT_NSC_SHARED_BASE > SECBOOT_NSC_SHARED_SIZE - length) {
+        return false;
+    }
+    return cmse_check_address_range((void*)p, length, flags) != NULL;
+}
+
+static NSC_CryptoStatusTypeDef NSCrypto_Sha(const NSC_CryptoRequestTypeDef *req)
+{
+    SECBOOT_SHA256_Context ctx;
+
+    if (req->outputLength < SECBOOT_ECDSA_SHA256_DIGEST_SIZE) {
+        return NSC_CRYPTO_INVALID_PARAM;
+    }
+    if (stream_open) {
+        return NSC_CRYPTO_BUSY;
+    }
+    if (SECBOOT_SHA256_Start(&ctx) != SECBOOT_SHA256_OK) {
+        return NSC_CRYPTO_ERROR;
+    }
+    if (SECBOOT_SHA256_Update(&ctx, req->input, req->inputLength) != SECBOOT_SHA256_OK ||
+        SECBOOT_SHA256_Final(&ctx, req->output) != SECBOOT_SHA256_OK) {
+        SECBOOT_SHA256_Abort(&ctx);
+        return NSC_CRYPTO_ERROR;
+    }
+    return NSC_CRYPTO_OK;
+}
+
+/**
+  * @brief  Close the open stream without a digest and free the HASH peripheral
+  */
+static void NSCrypto_StreamRelease(void)
+{
+    if (stream_open) {
+        SECBOOT_SHA256_Abort(&stream_ctx);
+        stream_open = false;
+    }
+    stream_queue = NULL;
+}
+
+/**
+  * @brief  Run a streaming SHA-256 request
+  * @note   A stream belongs to the queue that opened it. START from another
+  *         queue drops it, so a caller that never sent FINAL or ABORT does
+  *         not hold the HASH peripheral for good; START from the owner
+  *         while it is open stays NSC_CRYPTO_BUSY.
+  */
+static NSC_CryptoStatusTypeDef NSCrypto_Stream(const NSC_CryptoRequestTypeDef *req,
+                                               const NSC_CryptoRequestTypeDef *queue)
+{
+    SECBOOT_SHA_StatusTypeDef status;
+
+    if (req->op == NSC_CRYPTO_SHA256_ABORT) {
+        NSCrypto_StreamRelease();
+        return NSC_CRYPTO_OK;
+    }
+
+    if (req->op == NSC_CRYPTO_SHA256_START) {
+        if (stream_open && stream_queue == queue) {
+            return NSC_CRYPTO_BUSY;
+        }
+        NSCrypto_StreamRelease();
+        if (SECBOOT_SHA256_Start(&stream_ctx) != SECBOOT_SHA256_OK) {
+            return NSC_CRYPTO_ERROR;
+        }
+        stream_open = true;
+        stream_queue = queue;
+        return NSC_CRYPTO_OK;
+    }
+
+    if (!stream_open) {
+        return NSC_CRYPTO_BUSY;
+    }
+    if (req->op == NSC_CRYPTO_SHA256_UPDATE) {
+        status = SECBOOT_SHA256_Update(&stream_ctx, req->input, req->inputLength);
+    } else if (req->outputLength < SECBOOT_ECDSA_SHA256_DIGEST_SIZE) {
+        return NSC_CRYPTO_INVALID_PARAM;
+    } else {
+        status = SECBOOT_SHA256_Final(&stream_ctx, req->output);
+    }
+
+    // Update and Final release the peripheral on error as well
+    if (status != SECBOOT_SHA256_OK || req->op == NSC_CRYPTO_SHA256_FINAL) {
+        stream_open = false;
+        stream_queue = NULL;
+    }
+    return (status == SECBOOT_SHA256_OK) ? NSC_CRYPTO_OK : NSC_CRYPTO_ERROR;
+}
+
+static NSC_CryptoStatusTypeDef NSCrypto_Ctr(const NSC_CryptoRequestTypeDef *req)
+{
+    if ((req->keyLength != 16U && req->keyLength != 32U) || req->ivLength != AES_CTR_IV_SIZE ||
+        req->outputLength < req->inputLength) {
+        return NSC_CRYPTO_INVALID_PARAM;
+    }
+    if (SECBOOT_AES_CipherInit(&cipher_ctx, SECBOOT_AES_MODE_CTR, req->key, req->keyLength, req->iv, NULL, 0)
+        != SECBOOT_AES_OK) {
+        return NSC_CRYPTO_ERROR;
+    }
+    if (SECBOOT_AES_CipherUpdate(&cipher_ctx, req->input, req->inputLength, req->output) != SECBOOT_AES_OK) {
+        SECBOOT_AES_CipherAbort(&cipher_ctx);
+        return NSC_CRYPTO_ERROR;
+    }
+    return (SECBOOT_AES_CipherFinal(&cipher_ctx, NULL) == SECBOOT_AES_OK) ? NSC_CRYPTO_OK : NSC_CRYPTO_ERROR;
+}
+
+static NSC_CryptoStatusTypeDef NSCrypto_Verify(const NSC_CryptoRequestTypeDef *req)
+{
+    SECBOOT_ECDSA_StatusTypeDef status;
+
+    if (req->inputLength != SECBOOT_ECDSA_SHA256_DIGEST_SIZE || req->keyLength != sizeof(SECBOOT_ECC_PublicKey) ||
+        req->ivLength != sizeof(SECBOOT_ECC_Signature)) {
+        return NSC_CRYPTO_INVALID_PARAM;
+    }
+
+    status = SECBOOT_ECDSA_Verify_Signature((uint8_t*)req->input, req->inputLength,
+                                            (SECBOOT_ECC_Signature*)req->iv, (SECBOOT_ECC_PublicKey*)req->key);
+    if (status == SECBOOT_ECDSA_VERIFICATION_SUCCESS) {
+        return NSC_CRYPTO_OK;
+    }
+    if (status == SECBOOT_ECDSA_VERIFICATION_FAIL || status == SECBOOT_ECDSA_INVALID_SIGNATURE ||
+        status == SECBOOT_ECDSA_INVALID_PUBKEY) {
+        return NSC_CRYPTO_BAD_SIGNATURE;
+    }
+    return NSC_CRYPTO_ERROR;
+}
+
+/**
+  * @brief  Run one request from its secure copy
+  * @param  queue  Queue the request came from
+  */
+static NSC_CryptoStatusTypeDef NSCrypto_Run(const NSC_CryptoRequestTypeDef *req,
+                                            const NSC_CryptoRequestTypeDef *queue)
+{
+    if (!NSCrypto_Shared(req->key, req->keyLength, NSCRYPTO_READ) ||
+        !NSCrypto_Shared(req->iv, req->ivLength, NSCRYPTO_READ) ||
+        !NSCrypto_Shared(req->input, req->inputLength, NSCRYPTO_READ) ||
+        !NSCrypto_Shared(req->output, req->outputLength, NSCRYPTO_WRITE)) {
+        return NSC_CRYPTO_INVALID_PARAM;
+    }
+
+    switch (req->op) {
+    case NSC_CRYPTO_SHA256:
+        return NSCrypto_Sha(req);
+    case NSC_CRYPTO_SHA256_START:
+    case NSC_CRYPTO_SHA256_UPDATE:
+    case NSC_CRYPTO_SHA256_FINAL:
+    case NSC_CRYPTO_SHA256_ABORT:
+        return NSCrypto_Stream(req, queue);
+    case NSC_CRYPTO_AES_CTR:
+        return NSCrypto_Ctr(req);
+    case NSC_CRYPTO_ECDSA_VERIFY:
+        return NSCrypto_Verify(req);
+    default:
+        return NSC_CRYPTO_INVALID_PARAM;
+    }
+}
+
+/* Function implementations --------------------------------------------------*/
+
+uint32_t SECBOOT_NSCrypto_Submit(NSC_CryptoRequestTypeDef *queue, uint32_t count)
+{
+    NSC_CryptoRequestTypeDef req;
+    uint32_t done = 0;
+
+    if (count == 0U || count > SECBOOT_NSCRYPTO_MAX_QUEUE ||
+        !NSCrypto_Shared(queue, count * sizeof(*queue), NSCRYPTO_WRITE)) {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        queue[i].status = NSC_CRYPTO_PENDING;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        NSC_CryptoStatusTypeDef status;
+
+        // The caller may rewrite the queue meanwhile: only the copy is checked and used
+        memcpy(&req, (const void*)&queue[i], sizeof(req));
+        status = NSCrypto_Run(&req, queue);
+        queue[i].status = status;
+        if (status == NSC_CRYPTO_OK) {
+            done++;
+        }
+    }
+
+    memset(&req, 0, sizeof(req));
+    return done;
+}
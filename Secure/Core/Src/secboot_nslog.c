@@ -0,0 +1,195 @@
+/**
+  * @file    secboot_nslog.c
+  * @brief   Batched non-secure log output through USART1 TX DMA
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    Spans are started from two places: NSC_LogSubmit (thread mode,
+  *          non-secure caller) and the transmit-complete callback
+  *          (USART1_IRQn). The check-and-start is the only shared step and
+  *          runs with interrupts masked.
+  */
+
+#include "secboot_nslog.h"
+#include <arm_cmse.h>
+#include <string.h>
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct {
+    UART_HandleTypeDef *huart;
+    NSC_LogRingTypeDef *ring;    ///< Validated non-secure ring, NULL if none
+    uint32_t size;               ///< Secure copy of ring->size
+    uint32_t tail;               ///< Secure copy of ring->tail
+    uint32_t inFlight;           ///< Bytes of the span being sent, 0 if idle
+} NSLog_StateTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static NSLog_StateTypeDef nslog;
+static DMA_HandleTypeDef hdma_tx;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Send the next contiguous span of the ring if the DMA is idle
+  * @note   Called with interrupts masked
+  */
+static void NSLog_StartNext(void)
+{
+    uint32_t pending;
+    uint32_t offset;
+    uint32_t span;
+
+    if (nslog.ring == NULL || nslog.inFlight != 0U) {
+        return;
+    }
+
+    pending = nslog.ring->head - nslog.tail;
+    if (pending == 0U) {
+        return;
+    }
+    // A head the ring cannot hold is not the application's log: drop it
+    if (pending > nslog.size) {
+        nslog.tail = nslog.ring->head;
+        nslog.ring->tail = nslog.tail;
+        return;
+    }
+
+    offset = nslog.tail & (nslog.size - 1U);
+    span = nslog.size - offset;
+    if (span > pending) {
+        span = pending;
+    }
+
+    if (HAL_UART_Transmit_DMA(nslog.huart, &nslog.ring->data[offset], (uint16_t)span) == HAL_OK) {
+        nslog.inFlight = span;
+    }
+}
+
+static void NSLog_Kick(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    NSLog_StartNext();
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Bind the transmit DMA channel to the UART
+  */
+static bool NSLog_DmaInit(UART_HandleTypeDef *huart)
+{
+    __HAL_RCC_DMAMUX1_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    hdma_tx.Instance = SECBOOT_NSLOG_DMA_CHANNEL;
+    hdma_tx.Init.Request = DMA_REQUEST_USART1_TX;
+    hdma_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_tx.Init.Mode = DMA_NORMAL;
+    hdma_tx.Init.Priority = DMA_PRIORITY_LOW;
+    if (HAL_DMA_Init(&hdma_tx) != HAL_OK) {
+        return false;
+    }
+    // Secure channel reading the non-secure ring
+    if (HAL_DMA_ConfigChannelAttributes(&hdma_tx, DMA_CHANNEL_PRIV | DMA_CHANNEL_SEC | DMA_CHANNEL_DEST_SEC) != HAL_OK) {
+        return false;
+    }
+    __HAL_LINKDMA(huart, hdmatx, hdma_tx);
+
+    HAL_NVIC_SetPriority(SECBOOT_NSLOG_DMA_IRQn, SECBOOT_NSLOG_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(SECBOOT_NSLOG_DMA_IRQn);
+    return true;
+}
+
+/* Function implementations --------------------------------------------------*/
+
+SECBOOT_NSLog_StatusTypeDef SECBOOT_NSLog_Attach(UART_HandleTypeDef *huart, NSC_LogRingTypeDef *ring)
+{
+    uint32_t size;
+
+    if (huart == NULL || ring == NULL) {
+        return SECBOOT_NSLOG_INVALID_PARAM;
+    }
+
+    // The header first: size is only read once it is known to be non-secure
+    if (cmse_check_address_range(ring, sizeof(*ring), CMSE_NONSECURE | CMSE_MPU_READWRITE) == NULL) {
+        return SECBOOT_NSLOG_INVALID_PARAM;
+    }
+    size = ring->size;
+    if (size < SECBOOT_NSLOG_MIN_RING || size > SECBOOT_NSLOG_MAX_RING || (size & (size - 1U)) != 0U) {
+        return SECBOOT_NSLOG_INVALID_PARAM;
+    }
+    if (cmse_check_address_range(ring, sizeof(*ring) + size, CMSE_NONSECURE | CMSE_MPU_READWRITE) == NULL) {
+        return SECBOOT_NSLOG_INVALID_PARAM;
+    }
+
+    SECBOOT_NSLog_Flush();
+
+    if (nslog.huart != huart && !NSLog_DmaInit(huart)) {
+        (void)HAL_DMA_DeInit(&hdma_tx);
+        huart->hdmatx = NULL;
+        memset(&nslog, 0, sizeof(nslog));
+        return SECBOOT_NSLOG_UART_ERROR;
+    }
+
+    nslog.huart = huart;
+    nslog.size = size;
+    nslog.tail = ring->head;
+    nslog.inFlight = 0;
+    ring->tail = nslog.tail;
+    nslog.ring = ring;
+
+    return SECBOOT_NSLOG_OK;
+}
+
+SECBOOT_NSLog_StatusTypeDef SECBOOT_NSLog_Submit(void)
+{
+    if (nslog.ring == NULL) {
+        return SECBOOT_NSLOG_NOT_ATTACHED;
+    }
+
+    NSLog_Kick();
+    return (nslog.huart->gState == HAL_UART_STATE_ERROR) ? SECBOOT_NSLOG_UART_ERROR : SECBOOT_NSLOG_OK;
+}
+
+/**
+  * @note   WFI with PRIMASK set still wakes on the pending interrupt, which
+  *         then runs once PRIMASK is cleared (see secboot_flashwriter.c).
+  */
+void SECBOOT_NSLog_Flush(void)
+{
+    while (nslog.ring != NULL) {
+        __disable_irq();
+        NSLog_StartNext();
+        if (nslog.inFlight == 0U) {
+            __enable_irq();
+            return;
+        }
+        __WFI();
+        __enable_irq();
+    }
+}
+
+void SECBOOT_NSLog_DMA_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&hdma_tx);
+}
+
+/**
+  * @brief  UART transmit complete: account the span and start the next
+  */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart != nslog.huart || nslog.inFlight == 0U) {
+        return;
+    }
+
+    nslog.tail += nslog.inFlight;
+    nslog.inFlight = 0;
+    nslog.ring->tail = nslog.tail;
+    NSLog_StartNext();
+}
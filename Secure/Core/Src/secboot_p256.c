@@ -0,0 +1,840 @@
+/**
+  * @file    secboot_p256.c
+  * @brief   Software ECDSA P-256 signature verification (and signing for host tools)
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    Field and scalar arithmetic in the Montgomery domain on eight
+  *          32-bit limbs; R^2 comes from the precomputed Montgomery
+  *          parameters of prime256v1.c and the rest of the Montgomery
+  *          constants are derived on every call, which costs a few hundred
+  *          cycles and keeps the module free of static state.
+  *          Points are projective (X:Y:Z) with the complete a = -3
+  *          formulas of Renes, Costello and Batina (2016), so the point at
+  *          infinity (0:1:0) and doubling need no special case.
+  */
+
+#include "secboot_p256.h"
+#include "prime256v1.h"
+#include <string.h>
+
+#define P256_LIMBS        8U
+#define P256_WINDOW_BITS  4U
+#define P256_TABLE_SIZE   (1U << P256_WINDOW_BITS)
+#define P256_WINDOWS      (256U / P256_WINDOW_BITS)
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct {
+    uint32_t v[P256_LIMBS];   ///< Little-endian limbs
+} p256_int;
+
+typedef struct {
+    p256_int m;               ///< Odd modulus
+    p256_int rr;              ///< 2^512 mod m
+    p256_int one;             ///< 2^256 mod m (1 in the Montgomery domain)
+    uint32_t minv;            ///< -m^-1 mod 2^32
+} p256_mod;
+
+typedef struct {
+    p256_int x, y, z;         ///< Projective, Montgomery domain
+} p256_point;
+
+typedef struct {
+    p256_int x, y;            ///< Affine, Montgomery domain
+} p256_affine;
+
+typedef struct {
+    p256_mod p;               ///< Field
+    p256_mod n;               ///< Group order
+    p256_int b;               ///< Curve coefficient b, Montgomery domain
+} p256_curve;
+
+/* Generator multiples, from Script/stm32_p256_table.py ----------------------*/
+
+static const p256_affine p256_generator_table[P256_TABLE_SIZE - 1U] = {
+    { /* 1G */
+        { { 0x18A9143CU, 0x79E730D4U, 0x5FEDB601U, 0x75BA95FCU, 0x77622510U, 0x79FB732BU, 0xA53755C6U, 0x18905F76U } },
+        { { 0xCE95560AU, 0xDDF25357U, 0xBA19E45CU, 0x8B4AB8E4U, 0xDD21F325U, 0xD2E88688U, 0x25885D85U, 0x8571FF18U } }
+    },
+    { /* 2G */
+        { { 0x10DDD64DU, 0x850046D4U, 0xA433827DU, 0xAA6AE3C1U, 0x8D1490D9U, 0x73220503U, 0x3DCF3A3BU, 0xF6BB32E4U } },
+        { { 0x61BEE1A5U, 0x2F3648D3U, 0xEB236FF8U, 0x152CD7CBU, 0x92042DBEU, 0x19A8FB0EU, 0x0A5B8A3BU, 0x78C57751U } }
+    },
+    { /* 3G */
+        { { 0x4EEBC127U, 0xFFAC3F90U, 0x087D81FBU, 0xB027F84AU, 0x87CBBC98U, 0x66AD77DDU, 0xB6FF747EU, 0x26936A3FU } },
+        { { 0xC983A7EBU, 0xB04C5C1FU, 0x0861FE1AU, 0x583E47ADU, 0x1A2EE98EU, 0x78820831U, 0xE587CC07U, 0xD5F06A29U } }
+    },
+    { /* 4G */
+        { { 0x46918DCCU, 0x74B0B50DU, 0xC623C173U, 0x4650A6EDU, 0xE8100AF2U, 0x0CDAACACU, 0x41B0176BU, 0x577362F5U } },
+        { { 0xE4CBABA6U, 0x2D96F24CU, 0xFAD6F447U, 0x17628471U, 0xE5DDD22EU, 0x6B6C36DEU, 0x4C5AB863U, 0x84B14C39U } }
+    },
+    { /* 5G */
+        { { 0xC45C61F5U, 0xBE1B8AAEU, 0x94B9537DU, 0x90EC649AU, 0xD076C20CU, 0x941CB5AAU, 0x890523C8U, 0xC9079605U } },
+        { { 0xE7BA4F10U, 0xEB309B4AU, 0xE5EB882BU, 0x73C568EFU, 0x7E7A1F68U, 0x3540A987U, 0x2DD1E916U, 0x73A076BBU } }
+    },
+    { /* 6G */
+        { { 0x3E77664AU, 0x40394737U, 0x346CEE3EU, 0x55AE744FU, 0x5B17A3ADU, 0xD50A961AU, 0x54213673U, 0x13074B59U } },
+        { { 0xD377E44BU, 0x93D36220U, 0xADFF14B5U, 0x299C2B53U, 0xEF639F11U, 0xF424D44CU, 0x4A07F75FU, 0xA4C9916DU } }
+    },
+    { /* 7G */
+        { { 0xA0173B4FU, 0x0746354EU, 0xD23C00F7U, 0x2BD20213U, 0x0C23BB08U, 0xF43EAAB5U, 0xC3123E03U, 0x13BA5119U } },
+        { { 0x3F5B9D4DU, 0x2847D030U, 0x5DA67BDDU, 0x6742F2F2U, 0x77C94195U, 0xEF933BDCU, 0x6E240867U, 0xEAEDD915U } }
+    },
+    { /* 8G */
+        { { 0x9499A78FU, 0x27F14CD1U, 0x6F9B3455U, 0x462AB5C5U, 0xF02CFC6BU, 0x8F90F02AU, 0xB265230DU, 0xB763891EU } },
+        { { 0x532D4977U, 0xF59DA3A9U, 0xCF9EBA15U, 0x21E3327DU, 0xBE60BBF0U, 0x123C7B84U, 0x7706DF76U, 0x56EC12F2U } }
+    },
+    { /* 9G */
+        { { 0x264E20E8U, 0x75C96E8FU, 0x59A7A841U, 0xABE6BFEDU, 0x44C8EB00U, 0x2CC09C04U, 0xF0C4E16BU, 0xE05B3080U } },
+        { { 0xA45F3314U, 0x1EB7777AU, 0xCE5D45E3U, 0x56AF7BEDU, 0x88B12F1AU, 0x2B6E019AU, 0xFD835F9BU, 0x086659CDU } }
+    },
+    { /* 10G */
+        { { 0x9DC21EC8U, 0x2C18DBD1U, 0x0FCF8139U, 0x98F9868AU, 0x48250B49U, 0x737D2CD6U, 0x24B3428FU, 0xCC61C947U } },
+        { { 0x80DD9E76U, 0x0C2B4078U, 0x383FBE08U, 0xC43A8991U, 0x779BE5D2U, 0x5F7D2D65U, 0xEB3B4AB5U, 0x78719A54U } }
+    },
+    { /* 11G */
+        { { 0x6245E404U, 0xEA7D260AU, 0x6E7FDFE0U, 0x9DE40795U, 0x8DAC1AB5U, 0x1FF3A415U, 0x649C9073U, 0x3E7090F1U } },
+        { { 0x2B944E88U, 0x1A768561U, 0xE57F61C8U, 0x250F939EU, 0x1EAD643DU, 0x0C0DAA89U, 0xE125B88EU, 0x68930023U } }
+    },
+    { /* 12G */
+        { { 0xD2697768U, 0x04B71AA7U, 0xCA345A33U, 0xABDEDEF5U, 0xEE37385EU, 0x2409D29DU, 0xCB83E156U, 0x4EE1DF77U } },
+        { { 0x1CBB5B43U, 0x0CAC12D9U, 0xCA895637U, 0x170ED2F6U, 0x8ADE6D66U, 0x28228CFAU, 0x53238ACAU, 0x7FF57C95U } }
+    },
+    { /* 13G */
+        { { 0x4B2ED709U, 0xCCC42563U, 0x856FD30DU, 0x0E356769U, 0x559E9811U, 0xBCBCD43FU, 0x5395B759U, 0x738477ACU } },
+        { { 0xC00EE17FU, 0x35752B90U, 0x742ED2E3U, 0x68748390U, 0xBD1F5BC1U, 0x7CD06422U, 0xC9E7B797U, 0xFBC08769U } }
+    },
+    { /* 14G */
+        { { 0xB0CF664AU, 0xA242A35BU, 0x7F9707E3U, 0x126E48F7U, 0xC6832660U, 0x1717BF54U, 0xFD12C72EU, 0xFAAE7332U } },
+        { { 0x995D586BU, 0x27B52DB7U, 0x832237C2U, 0xBE29569EU, 0x2A65E7DBU, 0xE8E4193EU, 0x2EAA1BBBU, 0x152706DCU } }
+    },
+    { /* 15G */
+        { { 0xBC60055BU, 0x72BCD8B7U, 0x56E27E4BU, 0x03CC23EEU, 0xE4819370U, 0xEE337424U, 0x0AD3DA09U, 0xE2AA0E43U } },
+        { { 0x6383C45DU, 0x40B8524FU, 0x42A41B25U, 0xD7663554U, 0x778A4797U, 0x64EFA6DEU, 0x7079ADF4U, 0x2042170AU } }
+    }
+};
+
+/* Integer helpers -----------------------------------------------------------*/
+
+static void int_from_bytes(p256_int *r, const uint8_t *p)
+{
+    for (uint32_t i = 0; i < P256_LIMBS; i++) {
+        const uint8_t *w = &p[SECBOOT_P256_SIZE - 4U * (i + 1U)];
+
+        r->v[i] = ((uint32_t)w[0] << 24) | ((uint32_t)w[1] << 16) | ((uint32_t)w[2] << 8) | w[3];
+    }
+}
+
+static void int_to_bytes(uint8_t *p, const p256_int *a)
+{
+    for (uint32_t i = 0; i < P256_LIMBS; i++) {
+        uint8_t *w = &p[SECBOOT_P256_SIZE - 4U * (i + 1U)];
+
+        w[0] = (uint8_t)(a->v[i] >> 24);
+        w[1] = (uint8_t)(a->v[i] >> 16);
+        w[2] = (uint8_t)(a->v[i] >> 8);
+        w[3] = (uint8_t)a->v[i];
+    }
+}
+
+static uint32_t int_add(p256_int *r, const p256_int *a, const p256_int *b)
+{
+    uint64_t c = 0;
+
+    for (uint32_t i = 0; i < P256_LIMBS; i++) {
+        c += (uint64_t)a->v[i] + b->v[i];
+        r->v[i] = (uint32_t)c;
+        c >>= 32;
+    }
+    return (uint32_t)c;
+}
+
+static uint32_t int_sub(p256_int *r, const p256_int *a, const p256_int *b)
+{
+    int64_t c = 0;
+
+    for (uint32_t i = 0; i < P256_LIMBS; i++) {
+        c += (int64_t)a->v[i] - b->v[i];
+        r->v[i] = (uint32_t)c;
+        c >>= 32;
+    }
+    return (uint32_t)c & 1U;
+}
+
+/** @brief All ones when a == b, else zero */
+static uint32_t ct_eq(uint32_t a, uint32_t b)
+{
+    uint32_t x = a ^ b;
+
+    return ((((x | (0U - x)) >> 31) ^ 1U)) * 0xFFFFFFFFU;
+}
+
+/** @brief r = mask ? a : r */
+static void int_cmov(p256_int *r, const p256_int *a, uint32_t mask)
+{
+    for (uint32_t i = 0; i < P256_LIMBS; i++) {
+        r->v[i] = (r->v[i] & ~mask) | (a->v[i] & mask);
+    }
+}
+
+static uint32_t int_is_zero(const p256_int *a)
+{
+    uint32_t acc = 0;
+
+    for (uint32_t i = 0; i < P256_LIMBS; i++) {
+        acc |= a->v[i];
+    }
+    return acc == 0U;
+}
+
+static uint32_t int_equal(const p256_int *a, const p256_int *b)
+{
+    uint32_t acc = 0;
+
+    for (uint32_t i = 0; i < P256_LIMBS; i++) {
+        acc |= a->v[i] ^ b->v[i];
+    }
+    return acc == 0U;
+}
+
+/** @brief 1 when a < b */
+static uint32_t int_less(const p256_int *a, const p256_int *b)
+{
+    p256_int t;
+
+    return int_sub(&t, a, b);
+}
+
+/* Modular arithmetic --------------------------------------------------------*/
+
+static void mod_add(p256_int *r, const p256_int *a, const p256_int *b, const p256_mod *f)
+{
+    p256_int t;
+    uint32_t carry = int_add(r, a, b);
+    uint32_t borrow = int_sub(&t, r, &f->m);
+
+    int_cmov(r, &t, 0U - (carry | (borrow ^ 1U)));
+}
+
+static void mod_sub(p256_int *r, const p256_int *a, const p256_int *b, const p256_mod *f)
+{
+    p256_int t;
+    uint32_t borrow = int_sub(r, a, b);
+
+    (void)int_add(&t, r, &f->m);
+    int_cmov(r, &t, 0U - borrow);
+}
+
+/**
+  * @brief  r = a * b / 2^256 mod m (CIOS), inputs below m
+  */
+static void mont_mul(p256_int *r, const p256_int *a, const p256_int *b, const p256_mod *f)
+{
+    uint32_t t[P256_LIMBS + 2U] = { 0 };
+    p256_int lo;
+    p256_int reduced;
+    uint32_t borrow;
+
+    for (uint32_t i = 0; i < P256_LIMBS; i++) {
+        uint64_t c = 0;
+        uint32_t q;
+
+        for (uint32_t j = 0; j < P256_LIMBS; j++) {
+            c += (uint64_t)t[j] + (uint64_t)a->v[j] * b->v[i];
+            t[j] = (uint32_t)c;
+            c >>= 32;
+        }
+        c += t[P256_LIMBS];
+        t[P256_LIMBS] = (uint32_t)c;
+        t[P256_LIMBS + 1U] = (uint32_t)(c >> 32);
+
+        q = t[0] * f->minv;
+        c = ((uint64_t)t[0] + (uint64_t)q * f->m.v[0]) >> 32;
+        for (uint32_t j = 1; j < P256_LIMBS; j++) {
+            c += (uint64_t)t[j] + (uint64_t)q * f->m.v[j];
+            t[j - 1U] = (uint32_t)c;
+            c >>= 32;
+        }
+        c += t[P256_LIMBS];
+        t[P256_LIMBS - 1U] = (uint32_t)c;
+        t[P256_LIMBS] = t[P256_LIMBS + 1U] + (uint32_t)(c >> 32);
+    }
+
+    memcpy(lo.v, t, sizeof(lo.v));
+    borrow = int_sub(&reduced, &lo, &f->m);
+    int_cmov(&lo, &reduced, 0U - (t[P256_LIMBS] | (borrow ^ 1U)));
+    *r = lo;
+}
+
+static void mod_setup(p256_mod *f, const uint8_t *modulus, const uint32_t *montgomery)
+{
+    uint32_t x = 1;
+
+    int_from_bytes(&f->m, modulus);
+    memcpy(f->rr.v, montgomery, sizeof(f->rr.v));
+
+    // Newton iteration for m^-1 mod 2^32: each step doubles the correct bits
+    for (uint32_t i = 0; i < 5U; i++) {
+        x *= 2U - f->m.v[0] * x;
+    }
+    f->minv = 0U - x;
+
+    memset(&f->one, 0, sizeof(f->one));
+    f->one.v[0] = 1;
+    mont_mul(&f->one, &f->one, &f->rr, f);
+}
+
+static void to_mont(p256_int *r, const p256_int *a, const p256_mod *f)
+{
+    mont_mul(r, a, &f->rr, f);
+}
+
+/**
+  * @brief  r = a^e in the Montgomery domain, e public
+  */
+static void mod_pow(p256_int *r, const p256_int *a, const p256_int *e, const p256_mod *f)
+{
+    p256_int acc = f->one;
+
+    for (int32_t bit = 255; bit >= 0; bit--) {
+        mont_mul(&acc, &acc, &acc, f);
+        if ((e->v[bit / 32] >> (bit % 32)) & 1U) {
+            mont_mul(&acc, &acc, a, f);
+        }
+    }
+    *r = acc;
+}
+
+/* Point arithmetic ----------------------------------------------------------*/
+
+static void point_set_infinity(p256_point *r, const p256_curve *c)
+{
+    memset(&r->x, 0, sizeof(r->x));
+    r->y = c->p.one;
+    memset(&r->z, 0, sizeof(r->z));
+}
+
+/**
+  * @brief  r = p + q, complete for a = -3 (RCB 2016, algorithm 4)
+  */
+static void point_add(p256_point *r, const p256_point *p, const p256_point *q, const p256_curve *c)
+{
+    const p256_mod *f = &c->p;
+    p256_int t0, t1, t2, t3, t4, x3, y3, z3;
+
+    mont_mul(&t0, &p->x, &q->x, f);
+    mont_mul(&t1, &p->y, &q->y, f);
+    mont_mul(&t2, &p->z, &q->z, f);
+    mod_add(&t3, &p->x, &p->y, f);
+    mod_add(&t4, &q->x, &q->y, f);
+    mont_mul(&t3, &t3, &t4, f);
+    mod_add(&t4, &t0, &t1, f);
+    mod_sub(&t3, &t3, &t4, f);
+    mod_add(&t4, &p->y, &p->z, f);
+    mod_add(&x3, &q->y, &q->z, f);
+    mont_mul(&t4, &t4, &x3, f);
+    mod_add(&x3, &t1, &t2, f);
+    mod_sub(&t4, &t4, &x3, f);
+    mod_add(&x3, &p->x, &p->z, f);
+    mod_add(&y3, &q->x, &q->z, f);
+    mont_mul(&x3, &x3, &y3, f);
+    mod_add(&y3, &t0, &t2, f);
+    mod_sub(&y3, &x3, &y3, f);
+    mont_mul(&z3, &c->b, &t2, f);
+    mod_sub(&x3, &y3, &z3, f);
+    mod_add(&z3, &x3, &x3, f);
+    mod_add(&x3, &x3, &z3, f);
+    mod_sub(&z3, &t1, &x3, f);
+    mod_add(&x3, &t1, &x3, f);
+    mont_mul(&y3, &c->b, &y3, f);
+    mod_add(&t1, &t2, &t2, f);
+    mod_add(&t2, &t1, &t2, f);
+    mod_sub(&y3, &y3, &t2, f);
+    mod_sub(&y3, &y3, &t0, f);
+    mod_add(&t1, &y3, &y3, f);
+    mod_add(&y3, &t1, &y3, f);
+    mod_add(&t1, &t0, &t0, f);
+    mod_add(&t0, &t1, &t0, f);
+    mod_sub(&t0, &t0, &t2, f);
+    mont_mul(&t1, &t4, &y3, f);
+    mont_mul(&t2, &t0, &y3, f);
+    mont_mul(&y3, &x3, &z3, f);
+    mod_add(&y3, &y3, &t2, f);
+    mont_mul(&x3, &t3, &x3, f);
+    mod_sub(&x3, &x3, &t1, f);
+    mont_mul(&z3, &t4, &z3, f);
+    mont_mul(&t1, &t3, &t0, f);
+    mod_add(&z3, &z3, &t1, f);
+
+    r->x = x3;
+    r->y = y3;
+    r->z = z3;
+}
+
+/**
+  * @brief  r = 2p, complete for a = -3 (RCB 2016, algorithm 6)
+  */
+static void point_double(p256_point *r, const p256_point *p, const p256_curve *c)
+{
+    const p256_mod *f = &c->p;
+    p256_int t0, t1, t2, t3, x3, y3, z3;
+
+    mont_mul(&t0, &p->x, &p->x, f);
+    mont_mul(&t1, &p->y, &p->y, f);
+    mont_mul(&t2, &p->z, &p->z, f);
+    mont_mul(&t3, &p->x, &p->y, f);
+    mod_add(&t3, &t3, &t3, f);
+    mont_mul(&z3, &p->x, &p->z, f);
+    mod_add(&z3, &z3, &z3, f);
+    mont_mul(&y3, &c->b, &t2, f);
+    mod_sub(&y3, &y3, &z3, f);
+    mod_add(&x3, &y3, &y3, f);
+    mod_add(&y3, &x3, &y3, f);
+    mod_sub(&x3, &t1, &y3, f);
+    mod_add(&y3, &t1, &y3, f);
+    mont_mul(&y3, &x3, &y3, f);
+    mont_mul(&x3, &x3, &t3, f);
+    mod_add(&t3, &t2, &t2, f);
+    mod_add(&t2, &t2, &t3, f);
+    mont_mul(&z3, &c->b, &z3, f);
+    mod_sub(&z3, &z3, &t2, f);
+    mod_sub(&z3, &z3, &t0, f);
+    mod_add(&t3, &z3, &z3, f);
+    mod_add(&z3, &z3, &t3, f);
+    mod_add(&t3, &t0, &t0, f);
+    mod_add(&t0, &t3, &t0, f);
+    mod_sub(&t0, &t0, &t2, f);
+    mont_mul(&t0, &t0, &z3, f);
+    mod_add(&y3, &y3, &t0, f);
+    mont_mul(&t0, &p->y, &p->z, f);
+    mod_add(&t0, &t0, &t0, f);
+    mont_mul(&z3, &t0, &z3, f);
+    mod_sub(&x3, &x3, &z3, f);
+    mont_mul(&z3, &t0, &t1, f);
+    mod_add(&z3, &z3, &z3, f);
+    mod_add(&z3, &z3, &z3, f);
+
+    r->x = x3;
+    r->y = y3;
+    r->z = z3;
+}
+
+/**
+  * @brief  r = digit * G, reading every table entry
+  */
+static void select_generator(p256_point *r, uint32_t digit, const p256_curve *c)
+{
+    point_set_infinity(r, c);
+    for (uint32_t k = 1; k < P256_TABLE_SIZE; k++) {
+        uint32_t mask = ct_eq(k, digit);
+
+        int_cmov(&r->x, &p256_generator_table[k - 1U].x, mask);
+        int_cmov(&r->y, &p256_generator_table[k - 1U].y, mask);
+        int_cmov(&r->z, &c->p.one, mask);
+    }
+}
+
+/**
+  * @brief  r = table[digit], reading every table entry
+  */
+static void select_point(p256_point *r, const p256_point *table, uint32_t digit)
+{
+    *r = table[0];
+    for (uint32_t k = 1; k < P256_TABLE_SIZE; k++) {
+        uint32_t mask = ct_eq(k, digit);
+
+        int_cmov(&r->x, &table[k].x, mask);
+        int_cmov(&r->y, &table[k].y, mask);
+        int_cmov(&r->z, &table[k].z, mask);
+    }
+}
+
+static uint32_t scalar_digit(const p256_int *k, uint32_t window)
+{
+    uint32_t bit = window * P256_WINDOW_BITS;
+
+    return (k->v[bit / 32U] >> (bit % 32U)) & (P256_TABLE_SIZE - 1U);
+}
+
+/**
+  * @brief  Window table of Q: 0, Q, 2Q, ..., 15Q
+  */
+static void key_table(p256_point table[P256_TABLE_SIZE], const p256_point *q, const p256_curve *c)
+{
+    point_set_infinity(&table[0], c);
+    table[1] = *q;
+    for (uint32_t k = 2; k < P256_TABLE_SIZE; k++) {
+        point_add(&table[k], &table[k - 1U], q, c);
+    }
+}
+
+/**
+  * @brief  r = u1*G + u2*Q (Shamir's trick over 4-bit windows)
+  * @param  table  Window table of Q (key_table)
+  */
+static void double_scalar_mul(p256_point *r, const p256_int *u1, const p256_int *u2,
+                              const p256_point table[P256_TABLE_SIZE], const p256_curve *c)
+{
+    p256_point t;
+
+    point_set_infinity(r, c);
+    for (int32_t w = (int32_t)P256_WINDOWS - 1; w >= 0; w--) {
+        for (uint32_t i = 0; i < P256_WINDOW_BITS; i++) {
+            point_double(r, r, c);
+        }
+        select_generator(&t, scalar_digit(u1, (uint32_t)w), c);
+        point_add(r, r, &t, c);
+        select_point(&t, table, scalar_digit(u2, (uint32_t)w));
+        point_add(r, r, &t, c);
+    }
+}
+
+/**
+  * @brief  r = k*G over the same 4-bit windows
+  */
+static void base_scalar_mul(p256_point *r, const p256_int *k, const p256_curve *c)
+{
+    p256_point t;
+
+    point_set_infinity(r, c);
+    for (int32_t w = (int32_t)P256_WINDOWS - 1; w >= 0; w--) {
+        for (uint32_t i = 0; i < P256_WINDOW_BITS; i++) {
+            point_double(r, r, c);
+        }
+        select_generator(&t, scalar_digit(k, (uint32_t)w), c);
+        point_add(r, r, &t, c);
+    }
+}
+
+/**
+  * @brief  Affine coordinates of a finite point, out of the Montgomery domain
+  */
+static void point_to_affine(p256_int *x, p256_int *y, const p256_point *p, const p256_curve *c)
+{
+    p256_int e;
+    p256_int zinv;
+    p256_int one;
+
+    // Z^-1 = Z^(p-2) (Fermat)
+    memset(&e, 0, sizeof(e));
+    e.v[0] = 2;
+    (void)int_sub(&e, &c->p.m, &e);
+    mod_pow(&zinv, &p->z, &e, &c->p);
+
+    memset(&one, 0, sizeof(one));
+    one.v[0] = 1;
+    mont_mul(x, &p->x, &zinv, &c->p);
+    mont_mul(x, x, &one, &c->p);
+    if (y != NULL) {
+        mont_mul(y, &p->y, &zinv, &c->p);
+        mont_mul(y, y, &one, &c->p);
+    }
+}
+
+/**
+  * @brief  Scalar in [1, n-1]
+  */
+static uint32_t scalar_check(const p256_int *k, const p256_curve *c)
+{
+    return (uint32_t)(!int_is_zero(k) && int_less(k, &c->n.m));
+}
+
+/**
+  * @brief  Affine point in range and on y^2 = x^3 - 3x + b
+  */
+static uint32_t point_check(const p256_int *x, const p256_int *y, p256_point *q, const p256_curve *c)
+{
+    p256_int lhs;
+    p256_int rhs;
+    p256_int t;
+
+    if (!int_less(x, &c->p.m) || !int_less(y, &c->p.m)) {
+        return 0;
+    }
+
+    to_mont(&q->x, x, &c->p);
+    to_mont(&q->y, y, &c->p);
+    q->z = c->p.one;
+
+    mont_mul(&lhs, &q->y, &q->y, &c->p);
+    mont_mul(&rhs, &q->x, &q->x, &c->p);
+    mont_mul(&rhs, &rhs, &q->x, &c->p);
+    mod_add(&t, &q->x, &q->x, &c->p);
+    mod_add(&t, &t, &q->x, &c->p);
+    mod_sub(&rhs, &rhs, &t, &c->p);
+    mod_add(&rhs, &rhs, &c->b, &c->p);
+    return int_equal(&lhs, &rhs);
+}
+
+/**
+  * @brief  x(p) mod n == r, without inverting Z: X == r*Z, or (r+n)*Z
+  *         when r+n < p
+  */
+static uint32_t x_matches(const p256_point *p, const p256_int *r, const p256_curve *c)
+{
+    p256_int t;
+    p256_int rn;
+
+    if (int_is_zero(&p->z)) {
+        return 0;
+    }
+    to_mont(&t, r, &c->p);
+    mont_mul(&t, &t, &p->z, &c->p);
+    if (int_equal(&t, &p->x)) {
+        return 1;
+    }
+    if (int_add(&rn, r, &c->n.m) == 0U && int_less(&rn, &c->p.m)) {
+        to_mont(&t, &rn, &c->p);
+        mont_mul(&t, &t, &p->z, &c->p);
+        return int_equal(&t, &p->x);
+    }
+    return 0;
+}
+
+/* Function implementations --------------------------------------------------*/
+
+SECBOOT_P256_StatusTypeDef SECBOOT_P256_Verify(const uint8_t *digest, const uint8_t *r, const uint8_t *s,
+                                               const uint8_t *qx, const uint8_t *qy)
+{
+    const ECC_Curve_Parameters *params = get_prime256v1_curve();
+    p256_curve c;
+    p256_int e, rr, ss, x, y, w, u1, u2, t;
+    p256_point q;
+    p256_point sum;
+    p256_point table[P256_TABLE_SIZE];
+
+    if (digest == NULL || r == NULL || s == NULL || qx == NULL || qy == NULL) {
+        return SECBOOT_P256_INVALID_PARAM;
+    }
+
+    mod_setup(&c.p, params->prime, params->montgomeryP);
+    mod_setup(&c.n, params->order, params->montgomeryN);
+    int_from_bytes(&t, params->B);
+    to_mont(&c.b, &t, &c.p);
+
+    int_from_bytes(&rr, r);
+    int_from_bytes(&ss, s);
+    if (int_is_zero(&rr) || int_is_zero(&ss) || !int_less(&rr, &c.n.m) || !int_less(&ss, &c.n.m)) {
+        return SECBOOT_P256_INVALID_SIGNATURE;
+    }
+
+    int_from_bytes(&x, qx);
+    int_from_bytes(&y, qy);
+    if (!point_check(&x, &y, &q, &c)) {
+        return SECBOOT_P256_INVALID_PUBKEY;
+    }
+
+    // e = digest mod n: the digest is below 2^256 < 2n
+    int_from_bytes(&e, digest);
+    int_cmov(&e, &t, 0U - (int_sub(&t, &e, &c.n.m) ^ 1U));
+
+    // w = s^-1 mod n = s^(n-2) (Fermat); u1 = e*w, u2 = r*w
+    memset(&t, 0, sizeof(t));
+    t.v[0] = 2;
+    (void)int_sub(&t, &c.n.m, &t);
+    to_mont(&w, &ss, &c.n);
+    mod_pow(&w, &w, &t, &c.n);
+    mont_mul(&u1, &e, &w, &c.n);
+    mont_mul(&u2, &rr, &w, &c.n);
+
+    key_table(table, &q, &c);
+    double_scalar_mul(&sum, &u1, &u2, table, &c);
+    memset(table, 0, sizeof(table));
+
+    return x_matches(&sum, &rr, &c) ? SECBOOT_P256_OK : SECBOOT_P256_BAD_SIGNATURE;
+}
+
+SECBOOT_P256_StatusTypeDef SECBOOT_P256_VerifyBatch(SECBOOT_P256_BatchEntry *entries, uint32_t count,
+                                                    const uint8_t *qx, const uint8_t *qy)
+{
+    const ECC_Curve_Parameters *params = get_prime256v1_curve();
+    p256_curve c;
+    p256_int e, rr, ss, x, y, u1, u2, t, inv, sinv;
+    p256_int w[SECBOOT_P256_BATCH_MAX];
+    p256_int prefix[SECBOOT_P256_BATCH_MAX];
+    uint32_t index[SECBOOT_P256_BATCH_MAX];
+    p256_point q;
+    p256_point sum;
+    p256_point table[P256_TABLE_SIZE];
+
+    if ((entries == NULL && count > 0U) || qx == NULL || qy == NULL) {
+        return SECBOOT_P256_INVALID_PARAM;
+    }
+
+    mod_setup(&c.p, params->prime, params->montgomeryP);
+    mod_setup(&c.n, params->order, params->montgomeryN);
+    int_from_bytes(&t, params->B);
+    to_mont(&c.b, &t, &c.p);
+
+    int_from_bytes(&x, qx);
+    int_from_bytes(&y, qy);
+    if (!point_check(&x, &y, &q, &c)) {
+        for (uint32_t i = 0; i < count; i++) {
+            entries[i].status = SECBOOT_P256_INVALID_PUBKEY;
+        }
+        return SECBOOT_P256_INVALID_PUBKEY;
+    }
+    key_table(table, &q, &c);
+
+    memset(&x, 0, sizeof(x));
+    x.v[0] = 2;
+    (void)int_sub(&x, &c.n.m, &x);    // n - 2
+
+    for (uint32_t base = 0; base < count; base += SECBOOT_P256_BATCH_MAX) {
+        uint32_t k = 0;
+
+        // Products of the s of the well-formed entries, Montgomery domain
+        for (uint32_t i = base; i < count && i < base + SECBOOT_P256_BATCH_MAX; i++) {
+            SECBOOT_P256_BatchEntry *entry = &entries[i];
+
+            if (entry->digest == NULL || entry->r == NULL || entry->s == NULL) {
+                entry->status = SECBOOT_P256_INVALID_PARAM;
+                continue;
+            }
+            int_from_bytes(&rr, entry->r);
+            int_from_bytes(&ss, entry->s);
+            if (int_is_zero(&rr) || int_is_zero(&ss) || !int_less(&rr, &c.n.m) || !int_less(&ss, &c.n.m)) {
+                entry->status = SECBOOT_P256_INVALID_SIGNATURE;
+                continue;
+            }
+            to_mont(&w[k], &ss, &c.n);
+            if (k == 0U) {
+                prefix[k] = w[k];
+            } else {
+                mont_mul(&prefix[k], &prefix[k - 1U], &w[k], &c.n);
+            }
+            index[k++] = i;
+        }
+        if (k == 0U) {
+            continue;
+        }
+
+        // One inversion, then each s^-1 from the products (Montgomery's trick)
+        mod_pow(&inv, &prefix[k - 1U], &x, &c.n);
+        while (k-- > 0U) {
+            SECBOOT_P256_BatchEntry *entry = &entries[index[k]];
+
+            if (k > 0U) {
+                mont_mul(&sinv, &inv, &prefix[k - 1U], &c.n);
+                mont_mul(&inv, &inv, &w[k], &c.n);
+            } else {
+                sinv = inv;
+            }
+
+            int_from_bytes(&rr, entry->r);
+            int_from_bytes(&e, entry->digest);
+            int_cmov(&e, &t, 0U - (int_sub(&t, &e, &c.n.m) ^ 1U));
+            mont_mul(&u1, &e, &sinv, &c.n);
+            mont_mul(&u2, &rr, &sinv, &c.n);
+
+            double_scalar_mul(&sum, &u1, &u2, table, &c);
+            entry->status = x_matches(&sum, &rr, &c) ? SECBOOT_P256_OK : SECBOOT_P256_BAD_SIGNATURE;
+        }
+    }
+
+    memset(table, 0, sizeof(table));
+    return SECBOOT_P256_OK;
+}
+
+SECBOOT_P256_StatusTypeDef SECBOOT_P256_CheckKey(const uint8_t *qx, const uint8_t *qy)
+{
+    const ECC_Curve_Parameters *params = get_prime256v1_curve();
+    p256_curve c;
+    p256_int x, y, t;
+    p256_point q;
+
+    if (qx == NULL || qy == NULL) {
+        return SECBOOT_P256_INVALID_PARAM;
+    }
+
+    mod_setup(&c.p, params->prime, params->montgomeryP);
+    int_from_bytes(&t, params->B);
+    to_mont(&c.b, &t, &c.p);
+
+    int_from_bytes(&x, qx);
+    int_from_bytes(&y, qy);
+    return point_check(&x, &y, &q, &c) ? SECBOOT_P256_OK : SECBOOT_P256_INVALID_PUBKEY;
+}
+
+SECBOOT_P256_StatusTypeDef SECBOOT_P256_Sign(const uint8_t *digest, const uint8_t *d, const uint8_t *k,
+                                             uint8_t *r, uint8_t *s)
+{
+    const ECC_Curve_Parameters *params = get_prime256v1_curve();
+    p256_curve c;
+    p256_int e, dd, kk, x, w, t;
+    p256_point sum;
+    SECBOOT_P256_StatusTypeDef status = SECBOOT_P256_INVALID_SCALAR;
+
+    if (digest == NULL || d == NULL || k == NULL || r == NULL || s == NULL) {
+        return SECBOOT_P256_INVALID_PARAM;
+    }
+
+    mod_setup(&c.p, params->prime, params->montgomeryP);
+    mod_setup(&c.n, params->order, params->montgomeryN);
+    int_from_bytes(&t, params->B);
+    to_mont(&c.b, &t, &c.p);
+
+    int_from_bytes(&dd, d);
+    int_from_bytes(&kk, k);
+    if (!scalar_check(&dd, &c) || !scalar_check(&kk, &c)) {
+        return SECBOOT_P256_INVALID_SCALAR;
+    }
+
+    // r = x(k*G) mod n: x is below p < 2n
+    base_scalar_mul(&sum, &kk, &c);
+    point_to_affine(&x, NULL, &sum, &c);
+    int_cmov(&x, &t, 0U - (int_sub(&t, &x, &c.n.m) ^ 1U));
+
+    // s = k^-1 * (e + r*d) mod n; the Montgomery factors cancel as in Verify
+    int_from_bytes(&e, digest);
+    int_cmov(&e, &t, 0U - (int_sub(&t, &e, &c.n.m) ^ 1U));
+    to_mont(&t, &x, &c.n);
+    mont_mul(&t, &t, &dd, &c.n);
+    mod_add(&t, &t, &e, &c.n);
+    memset(&w, 0, sizeof(w));
+    w.v[0] = 2;
+    (void)int_sub(&w, &c.n.m, &w);
+    to_mont(&kk, &kk, &c.n);
+    mod_pow(&kk, &kk, &w, &c.n);
+    mont_mul(&t, &t, &kk, &c.n);
+
+    if (!int_is_zero(&x) && !int_is_zero(&t)) {
+        int_to_bytes(r, &x);
+        int_to_bytes(s, &t);
+        status = SECBOOT_P256_OK;
+    }
+
+    memset(&dd, 0, sizeof(dd));
+    memset(&kk, 0, sizeof(kk));
+    return status;
+}
+
+SECBOOT_P256_StatusTypeDef SECBOOT_P256_PublicKey(const uint8_t *d, uint8_t *qx, uint8_t *qy)
+{
+    const ECC_Curve_Parameters *params = get_prime256v1_curve();
+    p256_curve c;
+    p256_int dd, x, y;
+    p256_point q;
+
+    if (d == NULL || qx == NULL || qy == NULL) {
+        return SECBOOT_P256_INVALID_PARAM;
+    }
+
+    mod_setup(&c.p, params->prime, params->montgomeryP);
+    mod_setup(&c.n, params->order, params->montgomeryN);
+    int_from_bytes(&x, params->B);
+    to_mont(&c.b, &x, &c.p);
+
+    int_from_bytes(&dd, d);
+    if (!scalar_check(&dd, &c)) {
+        return SECBOOT_P256_INVALID_SCALAR;
+    }
+
+    base_scalar_mul(&q, &dd, &c);
+    point_to_affine(&x, &y, &q, &c);
+    int_to_bytes(qx, &x);
+    int_to_bytes(qy, &y);
+
+    memset(&dd, 0, sizeof(dd));
+    return SECBOOT_P256_OK;
+}
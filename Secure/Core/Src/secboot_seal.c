@@ -0,0 +1,250 @@
+/**
+  * @file    secboot_seal.c
+  * @brief   Verified-image seal records in secure flash
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    Records are appended to one 2KB page and programmed as 64-bit
+  *          double-words, like the diagnostic log. A record whose CRC does
+  *          not match (torn write, foreign data) is never trusted.
+  */
+
+#include "secboot_seal.h"
+#include "secboot_sha256.h"
+#include "secboot_crc.h"
+#include <stddef.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define SEAL_CRC_SPAN   offsetof(SECBOOT_Seal_Entry, crc)
+#define SEAL_PAGE_INDEX ((SECBOOT_SEAL_BASE - SECBOOT_BOOTLOADER_ADDR) / FLASH_PAGE_SIZE)
+
+/* Private types -------------------------------------------------------------*/
+
+/** @brief Summary of the seal page for one slot */
+typedef struct {
+    int32_t  newest;         ///< Index of the newest record of the slot, -1 if none
+    uint32_t freeIndex;      ///< First erased record, SECBOOT_SEAL_MAX_RECORDS if full
+    uint32_t sequence;       ///< Highest sequence among valid records
+    bool     corrupted;      ///< A programmed record failed its CRC
+} Seal_ScanTypeDef;
+
+/* Private functions ---------------------------------------------------------*/
+
+static const SECBOOT_Seal_Entry* Seal_At(uint32_t index) {
+    return (const SECBOOT_Seal_Entry*)(SECBOOT_SEAL_BASE + (index * SECBOOT_SEAL_RECORD_SIZE));
+}
+
+static bool Seal_IsErased(const SECBOOT_Seal_Entry *record) {
+    const uint32_t *pWord = (const uint32_t*)record;
+
+    for (uint32_t i = 0; i < SECBOOT_SEAL_RECORD_SIZE / sizeof(uint32_t); i++) {
+        if (pWord[i] != 0xFFFFFFFFUL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool Seal_IsIntact(const SECBOOT_Seal_Entry *record) {
+    uint32_t crc = 0;
+
+    if (record->magic != SECBOOT_SEAL_MAGIC && record->magic != SECBOOT_SEAL_REVOKED_MAGIC) {
+        return false;
+    }
+    if (SECBOOT_CRC_Calculate((uint8_t*)record, SEAL_CRC_SPAN, &crc) != SECBOOT_CRC_OK) {
+        return false;
+    }
+    return crc == record->crc;
+}
+
+/**
+  * @brief  Walk the seal page up to its first erased record
+  * @param  slotAddress Slot of interest
+  * @param  validateAll Check the CRC of every record (needed before writing)
+  * @param  scan        Output summary
+  */
+static void Seal_Scan(uint32_t slotAddress, bool validateAll, Seal_ScanTypeDef *scan) {
+    scan->newest = -1;
+    scan->freeIndex = SECBOOT_SEAL_MAX_RECORDS;
+    scan->sequence = 0;
+    scan->corrupted = false;
+
+    for (uint32_t i = 0; i < SECBOOT_SEAL_MAX_RECORDS; i++) {
+        const SECBOOT_Seal_Entry *record = Seal_At(i);
+
+        if (Seal_IsErased(record)) {
+            scan->freeIndex = i;
+            break;
+        }
+
+        if (validateAll) {
+            if (!Seal_IsIntact(record)) {
+                scan->corrupted = true;
+                continue;
+            }
+            if (record->sequence > scan->sequence) {
+                scan->sequence = record->sequence;
+            }
+        }
+
+        if (record->slotAddress == slotAddress) {
+            scan->newest = (int32_t)i;
+        }
+    }
+}
+
+/**
+  * @brief  Append one record, erasing the page first if it cannot take it
+  * @param  record Record to program; sequence and crc are filled in here
+  */
+static SECBOOT_Seal_StatusTypeDef Seal_Append(SECBOOT_Seal_Entry *record) {
+    Seal_ScanTypeDef scan;
+    uint32_t address;
+    uint64_t dword;
+
+    Seal_Scan(record->slotAddress, true, &scan);
+
+    record->sequence = scan.sequence + 1;
+    if (SECBOOT_CRC_Calculate((uint8_t*)record, SEAL_CRC_SPAN, &record->crc) != SECBOOT_CRC_OK) {
+        return SECBOOT_SEAL_ERROR;
+    }
+
+    HAL_FLASH_Unlock();
+
+    /* Full page or untrusted content: start over from an erased page */
+    if (scan.freeIndex == SECBOOT_SEAL_MAX_RECORDS || scan.corrupted) {
+        FLASH_EraseInitTypeDef erase = {0};
+        uint32_t page_error = 0;
+
+        erase.TypeErase = FLASH_TYPEERASE_PAGES;
+        erase.Banks = FLASH_BANK_1;
+        erase.Page = SEAL_PAGE_INDEX;
+        erase.NbPages = 1;
+
+        if (HAL_FLASHEx_Erase(&erase, &page_error) != HAL_OK) {
+            HAL_FLASH_Lock();
+            return SECBOOT_SEAL_FLASH_ERROR;
+        }
+        scan.freeIndex = 0;
+    }
+
+    /* Program in 64-bit chunks (STM32L5 requirement) */
+    address = (uint32_t)Seal_At(scan.freeIndex);
+    for (uint32_t i = 0; i < SECBOOT_SEAL_RECORD_SIZE / sizeof(dword); i++) {
+        memcpy(&dword, (uint8_t*)record + (i * sizeof(dword)), sizeof(dword));
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, address + (i * sizeof(dword)), dword) != HAL_OK) {
+            HAL_FLASH_Lock();
+            return SECBOOT_SEAL_FLASH_ERROR;
+        }
+    }
+
+    HAL_FLASH_Lock();
+
+    /* Read back */
+    if (!Seal_IsIntact(Seal_At(scan.freeIndex))) {
+        return SECBOOT_SEAL_FLASH_ERROR;
+    }
+
+    return SECBOOT_SEAL_OK;
+}
+
+static SECBOOT_Seal_StatusTypeDef Seal_HeaderDigest(uint32_t slotAddress, uint8_t *pDigest) {
+    if (SECBOOT_SHA256_Compute((uint8_t*)slotAddress, SECBOOT_FW_HEADER_SIZE, pDigest) != SECBOOT_SHA256_OK) {
+        return SECBOOT_SEAL_ERROR;
+    }
+    return SECBOOT_SEAL_OK;
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+  * @brief  Check whether a slot holds the image that was last sealed there
+  * @param  slotAddress  Header address of the slot
+  * @retval SECBOOT_Seal_StatusTypeDef
+  * @note   Only the newest record of the slot is CRC-checked; it must be a
+  *         seal (not a revocation) over the current header digest.
+  */
+SECBOOT_Seal_StatusTypeDef SECBOOT_Seal_Check(uint32_t slotAddress) {
+    const SECBOOT_Seal_Entry *record;
+    Seal_ScanTypeDef scan;
+    uint8_t digest[32];
+    SECBOOT_Seal_StatusTypeDef status = SECBOOT_SEAL_NOT_SEALED;
+
+    if (slotAddress == 0) {
+        return SECBOOT_SEAL_INVALID_PARAM;
+    }
+
+    Seal_Scan(slotAddress, false, &scan);
+    if (scan.newest < 0) {
+        return SECBOOT_SEAL_NOT_SEALED;
+    }
+
+    record = Seal_At((uint32_t)scan.newest);
+    if (record->magic != SECBOOT_SEAL_MAGIC || !Seal_IsIntact(record)) {
+        return SECBOOT_SEAL_NOT_SEALED;
+    }
+
+    if (Seal_HeaderDigest(slotAddress, digest) != SECBOOT_SEAL_OK) {
+        return SECBOOT_SEAL_ERROR;
+    }
+
+    if (memcmp(digest, record->headerDigest, sizeof(digest)) == 0) {
+        status = SECBOOT_SEAL_OK;
+    }
+
+    memset(digest, 0, sizeof(digest));
+    return status;
+}
+
+/**
+  * @brief  Seal the image in a slot after a successful full verification
+  * @param  slotAddress  Header address of the verified image
+  * @retval SECBOOT_Seal_StatusTypeDef
+  */
+SECBOOT_Seal_StatusTypeDef SECBOOT_Seal_Record(uint32_t slotAddress) {
+    SECBOOT_Seal_Entry record;
+
+    if (slotAddress == 0) {
+        return SECBOOT_SEAL_INVALID_PARAM;
+    }
+
+    memset(&record, 0xFF, sizeof(record));
+    record.magic = SECBOOT_SEAL_MAGIC;
+    record.slotAddress = slotAddress;
+    record.imageSize = *(const uint32_t*)(slotAddress + sizeof(uint32_t));
+
+    if (Seal_HeaderDigest(slotAddress, record.headerDigest) != SECBOOT_SEAL_OK) {
+        return SECBOOT_SEAL_ERROR;
+    }
+
+    return Seal_Append(&record);
+}
+
+/**
+  * @brief  Revoke the seal of a slot before it is written
+  * @param  slotAddress  Header address of the slot about to change
+  * @retval SECBOOT_Seal_StatusTypeDef
+  * @note   Nothing is written when the slot has no live seal, so repeated
+  *         updates of an unsealed slot cost no flash wear.
+  */
+SECBOOT_Seal_StatusTypeDef SECBOOT_Seal_Invalidate(uint32_t slotAddress) {
+    SECBOOT_Seal_Entry record;
+    Seal_ScanTypeDef scan;
+
+    if (slotAddress == 0) {
+        return SECBOOT_SEAL_INVALID_PARAM;
+    }
+
+    Seal_Scan(slotAddress, false, &scan);
+    if (scan.newest < 0 || Seal_At((uint32_t)scan.newest)->magic != SECBOOT_SEAL_MAGIC) {
+        return SECBOOT_SEAL_OK;
+    }
+
+    memset(&record, 0xFF, sizeof(record));
+    record.magic = SECBOOT_SEAL_REVOKED_MAGIC;
+    record.slotAddress = slotAddress;
+    record.imageSize = 0;
+    memset(record.headerDigest, 0, sizeof(record.headerDigest));
+
+    return Seal_Append(&record);
+}
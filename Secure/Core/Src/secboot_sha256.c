@@ -8,9 +8,13 @@
   */
 
 #include "secboot_sha256.h"
+#include <string.h>
 
 static HASH_HandleTypeDef hhash;
 
+/** Context currently holding the HASH peripheral, NULL when idle */
+static SECBOOT_SHA256_Context *pOwner = NULL;
+
 /**
   * @brief  Initialize HASH peripheral for SHA-256
   * @retval SECBOOT_SHA_StatusTypeDef
@@ -38,8 +42,13 @@ SECBOOT_SHA_StatusTypeDef SECBOOT_SHA256_Init(void) {
   *         1. Input validation
   *         2. Hardware computation (blocking)
   *         3. Digest extraction
+  *         Runs as a single-chunk streaming operation so that it respects
+  *         the ownership of the HASH peripheral.
   */
 SECBOOT_SHA_StatusTypeDef SECBOOT_SHA256_Compute(uint8_t *pInput, uint32_t inputLength, uint8_t *pOutputHash) {
+    SECBOOT_SHA256_Context ctx;
+    SECBOOT_SHA_StatusTypeDef status;
+
     /* Parameter validation */
     if (pInput == NULL || pOutputHash == NULL) {
         return SECBOOT_SHA256_ERROR_NULL_PTR;
@@ -49,15 +58,162 @@ SECBOOT_SHA_StatusTypeDef SECBOOT_SHA256_Compute(uint8_t *pInput, uint32_t input
         return SECBOOT_SHA256_ERROR_INVALID_LENGTH;
     }
 
+    status = SECBOOT_SHA256_Start(&ctx);
+    if (status != SECBOOT_SHA256_OK) {
+        return status;
+    }
+
     /* Compute digest */
-    if (HAL_HASHEx_SHA256_Start(&hhash, pInput, inputLength, pOutputHash, HAL_MAX_DELAY) != HAL_OK) {
-        return SECBOOT_SHA256_ERROR_COMPUTE;
+    status = SECBOOT_SHA256_Update(&ctx, pInput, inputLength);
+    if (status != SECBOOT_SHA256_OK) {
+        return status;
     }
 
     /* Finalize computation */
-    if (HAL_HASHEx_SHA256_Finish(&hhash, pOutputHash, HAL_MAX_DELAY) != HAL_OK) {
-        return SECBOOT_SHA256_ERROR_COMPUTE;
+    return SECBOOT_SHA256_Final(&ctx, pOutputHash);
+}
+
+/**
+  * @brief  Wipe a context and give the HASH peripheral back
+  * @param  ctx Context to release
+  */
+static void SHA256_Release(SECBOOT_SHA256_Context *ctx) {
+    if (pOwner == ctx) {
+        pOwner = NULL;
+    }
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+/**
+  * @brief  Open a streaming SHA-256 operation
+  * @param[out] ctx  Context to initialize
+  * @retval SECBOOT_SHA_StatusTypeDef
+  * @note   The peripheral is not touched until the first complete word:
+  *         the HAL resets the digest core on the first accumulation.
+  */
+SECBOOT_SHA_StatusTypeDef SECBOOT_SHA256_Start(SECBOOT_SHA256_Context *ctx) {
+    if (ctx == NULL) {
+        return SECBOOT_SHA256_ERROR_NULL_PTR;
+    }
+
+    /* Restarting the owning context is allowed, stealing the engine is not */
+    if (pOwner != NULL && pOwner != ctx) {
+        return SECBOOT_SHA256_ERROR_BUSY;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->hhash.Init.DataType = HASH_DATATYPE_8B;
+
+    if (HAL_HASH_Init(&ctx->hhash) != HAL_OK) {
+        return SECBOOT_SHA256_ERROR_INIT;
     }
 
+    pOwner = ctx;
     return SECBOOT_SHA256_OK;
-}
\ No newline at end of file
+}
+
+/**
+  * @brief  Absorb the next chunk of the message
+  * @param[in,out] ctx          Open context
+  * @param[in]     pInput       Chunk to hash
+  * @param[in]     inputLength  Chunk length in bytes
+  * @retval SECBOOT_SHA_StatusTypeDef
+  * @note   Processing order:
+  *         1. Complete a pending partial word from the head of the chunk
+  *         2. Stream the word-multiple body straight from its source
+  *         3. Keep the 0-3 byte tail for the next call
+  */
+SECBOOT_SHA_StatusTypeDef SECBOOT_SHA256_Update(SECBOOT_SHA256_Context *ctx, const uint8_t *pInput, uint32_t inputLength) {
+    uint32_t bodyLength;
+
+    if (ctx == NULL || (pInput == NULL && inputLength != 0U)) {
+        return SECBOOT_SHA256_ERROR_NULL_PTR;
+    }
+
+    if (pOwner != ctx) {
+        return SECBOOT_SHA256_ERROR_BUSY;
+    }
+
+    if (inputLength > (UINT32_MAX - ctx->totalLength)) {
+        SHA256_Release(ctx);
+        return SECBOOT_SHA256_ERROR_INVALID_LENGTH;
+    }
+    ctx->totalLength += inputLength;
+
+    /* 1. Complete the pending word */
+    if (ctx->pendingLength != 0U) {
+        uint32_t fill = sizeof(ctx->pending) - ctx->pendingLength;
+
+        if (fill > inputLength) {
+            fill = inputLength;
+        }
+        memcpy(&ctx->pending[ctx->pendingLength], pInput, fill);
+        ctx->pendingLength += fill;
+        pInput += fill;
+        inputLength -= fill;
+
+        if (ctx->pendingLength < sizeof(ctx->pending)) {
+            return SECBOOT_SHA256_OK;
+        }
+
+        if (HAL_HASHEx_SHA256_Accmlt(&ctx->hhash, ctx->pending, sizeof(ctx->pending)) != HAL_OK) {
+            SHA256_Release(ctx);
+            return SECBOOT_SHA256_ERROR_COMPUTE;
+        }
+        ctx->pendingLength = 0U;
+    }
+
+    /* 2. Word-multiple body, no copy */
+    bodyLength = inputLength & ~3UL;
+    if (bodyLength != 0U) {
+        if (HAL_HASHEx_SHA256_Accmlt(&ctx->hhash, (uint8_t *)pInput, bodyLength) != HAL_OK) {
+            SHA256_Release(ctx);
+            return SECBOOT_SHA256_ERROR_COMPUTE;
+        }
+    }
+
+    /* 3. Tail */
+    ctx->pendingLength = inputLength - bodyLength;
+    memcpy(ctx->pending, &pInput[bodyLength], ctx->pendingLength);
+
+    return SECBOOT_SHA256_OK;
+}
+
+/**
+  * @brief  Complete the digest and release the HASH peripheral
+  * @param[in,out] ctx          Open context
+  * @param[out]    pOutputHash  32-byte output buffer
+  * @retval SECBOOT_SHA_StatusTypeDef
+  * @note   The pending tail (possibly empty) is the last, partial word of
+  *         the message; the HAL sets NBLW from its length.
+  */
+SECBOOT_SHA_StatusTypeDef SECBOOT_SHA256_Final(SECBOOT_SHA256_Context *ctx, uint8_t *pOutputHash) {
+    SECBOOT_SHA_StatusTypeDef status = SECBOOT_SHA256_OK;
+
+    if (ctx == NULL || pOutputHash == NULL) {
+        return SECBOOT_SHA256_ERROR_NULL_PTR;
+    }
+
+    if (pOwner != ctx) {
+        return SECBOOT_SHA256_ERROR_BUSY;
+    }
+
+    if (HAL_HASHEx_SHA256_Accmlt_End(&ctx->hhash, ctx->pending, ctx->pendingLength, pOutputHash, HAL_MAX_DELAY) != HAL_OK) {
+        status = SECBOOT_SHA256_ERROR_COMPUTE;
+    }
+
+    SHA256_Release(ctx);
+    return status;
+}
+
+/**
+  * @brief  Drop an open operation without producing a digest
+  * @param[in,out] ctx  Context to release
+  * @note   The next Start re-initializes the digest core, so the partial
+  *         state left in the peripheral is never reused.
+  */
+void SECBOOT_SHA256_Abort(SECBOOT_SHA256_Context *ctx) {
+    if (ctx != NULL) {
+        SHA256_Release(ctx);
+    }
+}
@@ -0,0 +1,234 @@
+/**
+  * @file    secboot_slots.c
+  * @brief   A/B slot state records in secure flash
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    Same record discipline as the seal page: 64-bit programs, CRC
+  *          last, and a record that does not check out is never trusted.
+  *          Two pages instead of one, so the current state is never erased
+  *          before its successor is in flash.
+  */
+
+#include "secboot_slots.h"
+#include "secboot_crc.h"
+#include <stddef.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define SLOTS_CRC_SPAN    offsetof(SECBOOT_Slots_Entry, crc)
+
+/* Private types -------------------------------------------------------------*/
+
+/** @brief Summary of both state pages */
+typedef struct {
+    int32_t  page;                                ///< Page of the newest record, -1 if none
+    uint32_t freeIndex[SECBOOT_SLOTS_PAGE_COUNT]; ///< First erased record, SECBOOT_SLOTS_MAX_RECORDS if full
+    SECBOOT_Slots_Entry newest;                   ///< Newest valid record
+} Slots_ScanTypeDef;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t Slots_PageBase(uint32_t page) {
+    return SECBOOT_SLOTS_BASE + (page * SECBOOT_SLOTS_PAGE_SIZE);
+}
+
+static const SECBOOT_Slots_Entry* Slots_At(uint32_t page, uint32_t index) {
+    return (const SECBOOT_Slots_Entry*)(Slots_PageBase(page) + (index * SECBOOT_SLOTS_RECORD_SIZE));
+}
+
+static bool Slots_IsErased(uint32_t address, uint32_t length) {
+    const uint32_t *pWord = (const uint32_t*)address;
+
+    for (uint32_t i = 0; i < length / sizeof(uint32_t); i++) {
+        if (pWord[i] != 0xFFFFFFFFUL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool Slots_IsSlot(uint32_t slotAddress) {
+    return slotAddress == SECBOOT_SLOT_A_ADDR || slotAddress == SECBOOT_SLOT_B_ADDR;
+}
+
+static uint32_t Slots_Other(uint32_t slotAddress) {
+    return (slotAddress == SECBOOT_SLOT_A_ADDR) ? SECBOOT_SLOT_B_ADDR : SECBOOT_SLOT_A_ADDR;
+}
+
+static bool Slots_IsIntact(const SECBOOT_Slots_Entry *record) {
+    uint32_t crc = 0;
+
+    if (record->magic != SECBOOT_SLOTS_MAGIC) {
+        return false;
+    }
+    if (SECBOOT_CRC_Calculate((uint8_t*)record, SLOTS_CRC_SPAN, &crc) != SECBOOT_CRC_OK) {
+        return false;
+    }
+    if (crc != record->crc) {
+        return false;
+    }
+
+    /* A record naming anything but the A/B pair is foreign data */
+    return Slots_IsSlot(record->active) && record->fallback == Slots_Other(record->active);
+}
+
+/**
+  * @brief  Walk both pages up to their first erased record
+  * @param  scan  Output summary
+  */
+static void Slots_Scan(Slots_ScanTypeDef *scan) {
+    scan->page = -1;
+    memset(&scan->newest, 0, sizeof(scan->newest));
+
+    for (uint32_t page = 0; page < SECBOOT_SLOTS_PAGE_COUNT; page++) {
+        scan->freeIndex[page] = SECBOOT_SLOTS_MAX_RECORDS;
+
+        for (uint32_t i = 0; i < SECBOOT_SLOTS_MAX_RECORDS; i++) {
+            const SECBOOT_Slots_Entry *record = Slots_At(page, i);
+
+            if (Slots_IsErased((uint32_t)record, SECBOOT_SLOTS_RECORD_SIZE)) {
+                scan->freeIndex[page] = i;
+                break;
+            }
+
+            /* Torn or foreign records are skipped, the previous one stands */
+            if (!Slots_IsIntact(record)) {
+                continue;
+            }
+
+            if (scan->page < 0 || record->sequence > scan->newest.sequence) {
+                scan->page = (int32_t)page;
+                scan->newest = *record;
+            }
+        }
+    }
+}
+
+static SECBOOT_Slots_StatusTypeDef Slots_ErasePage(uint32_t page) {
+    FLASH_EraseInitTypeDef erase = {0};
+    uint32_t page_error = 0;
+
+    erase.TypeErase = FLASH_TYPEERASE_PAGES;
+    erase.Banks = FLASH_BANK_1;
+    erase.Page = (Slots_PageBase(page) - SECBOOT_BOOTLOADER_ADDR) / FLASH_PAGE_SIZE;
+    erase.NbPages = 1;
+
+    if (HAL_FLASHEx_Erase(&erase, &page_error) != HAL_OK) {
+        return SECBOOT_SLOTS_FLASH_ERROR;
+    }
+    return SECBOOT_SLOTS_OK;
+}
+
+/**
+  * @brief  Append one record after the newest one
+  * @param  scan    Current summary from Slots_Scan
+  * @param  record  Record to program; sequence and crc are filled in here
+  */
+static SECBOOT_Slots_StatusTypeDef Slots_Append(const Slots_ScanTypeDef *scan, SECBOOT_Slots_Entry *record) {
+    uint32_t page = (scan->page < 0) ? 0U : (uint32_t)scan->page;
+    uint32_t index = scan->freeIndex[page];
+    uint32_t address;
+    uint64_t dword;
+
+    record->sequence = (scan->page < 0) ? 1U : scan->newest.sequence + 1U;
+    if (SECBOOT_CRC_Calculate((uint8_t*)record, SLOTS_CRC_SPAN, &record->crc) != SECBOOT_CRC_OK) {
+        return SECBOOT_SLOTS_ERROR;
+    }
+
+    HAL_FLASH_Unlock();
+
+    /* Full page: continue on the other one, which holds only older records */
+    if (index == SECBOOT_SLOTS_MAX_RECORDS) {
+        page = (page + 1U) % SECBOOT_SLOTS_PAGE_COUNT;
+        index = 0;
+        if (!Slots_IsErased(Slots_PageBase(page), SECBOOT_SLOTS_PAGE_SIZE) &&
+            Slots_ErasePage(page) != SECBOOT_SLOTS_OK) {
+            HAL_FLASH_Lock();
+            return SECBOOT_SLOTS_FLASH_ERROR;
+        }
+    }
+
+    /* Program in 64-bit chunks (STM32L5 requirement), CRC last */
+    address = (uint32_t)Slots_At(page, index);
+    for (uint32_t i = 0; i < SECBOOT_SLOTS_RECORD_SIZE / sizeof(dword); i++) {
+        memcpy(&dword, (uint8_t*)record + (i * sizeof(dword)), sizeof(dword));
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, address + (i * sizeof(dword)), dword) != HAL_OK) {
+            HAL_FLASH_Lock();
+            return SECBOOT_SLOTS_FLASH_ERROR;
+        }
+    }
+
+    HAL_FLASH_Lock();
+
+    /* Read back */
+    if (!Slots_IsIntact(Slots_At(page, index))) {
+        return SECBOOT_SLOTS_FLASH_ERROR;
+    }
+
+    return SECBOOT_SLOTS_OK;
+}
+
+/* Function implementations --------------------------------------------------*/
+
+/**
+  * @brief  Read the current slot state
+  * @param  state  Output state
+  * @retval SECBOOT_Slots_StatusTypeDef
+  */
+SECBOOT_Slots_StatusTypeDef SECBOOT_Slots_Read(SECBOOT_Slots_StateTypeDef *state) {
+    Slots_ScanTypeDef scan;
+
+    if (state == NULL) {
+        return SECBOOT_SLOTS_INVALID_PARAM;
+    }
+
+    Slots_Scan(&scan);
+    if (scan.page < 0) {
+        /* Never updated: the factory image in slot A */
+        state->active = SECBOOT_SLOT_A_ADDR;
+        state->fallback = SECBOOT_SLOT_B_ADDR;
+        state->sequence = 0;
+        return SECBOOT_SLOTS_OK;
+    }
+
+    state->active = scan.newest.active;
+    state->fallback = scan.newest.fallback;
+    state->sequence = scan.newest.sequence;
+    return SECBOOT_SLOTS_OK;
+}
+
+/**
+  * @brief  Slot an update must be written to
+  * @param  state  Current state from SECBOOT_Slots_Read
+  * @retval Header address of the A/B slot that is not active
+  */
+uint32_t SECBOOT_Slots_Inactive(const SECBOOT_Slots_StateTypeDef *state) {
+    return Slots_Other(state->active);
+}
+
+/**
+  * @brief  Make a slot the active one, keeping the current one as fallback
+  * @param  slotAddress  SECBOOT_SLOT_A_ADDR or SECBOOT_SLOT_B_ADDR
+  * @retval SECBOOT_Slots_StatusTypeDef
+  */
+SECBOOT_Slots_StatusTypeDef SECBOOT_Slots_Activate(uint32_t slotAddress) {
+    SECBOOT_Slots_Entry record;
+    Slots_ScanTypeDef scan;
+
+    if (!Slots_IsSlot(slotAddress)) {
+        return SECBOOT_SLOTS_INVALID_PARAM;
+    }
+
+    Slots_Scan(&scan);
+    if ((scan.page < 0 && slotAddress == SECBOOT_SLOT_A_ADDR) ||
+        (scan.page >= 0 && scan.newest.active == slotAddress)) {
+        return SECBOOT_SLOTS_OK;
+    }
+
+    memset(&record, 0xFF, sizeof(record));
+    record.magic = SECBOOT_SLOTS_MAGIC;
+    record.active = slotAddress;
+    record.fallback = Slots_Other(slotAddress);
+
+    return Slots_Append(&scan, &record);
+}
@@ -0,0 +1,674 @@
+/**
+  * @file    secboot_transfer.c
+  * @brief   Windowed UART transfer of update images
+  * @date    2026-10-16
+  * @version 1.0
+  * @note    The DMA writes the ring behind the core; the core only moves
+  *          the read index. The host window keeps the DMA from lapping it:
+  *          SECBOOT_TRANSFER_WINDOW full frames fit the ring, so a page
+  *          erase (about 22ms) or the ECDSA check never loses bytes.
+  *          Staged, each chunk is programmed as soon as its frame checks
+  *          out, erasing its page on first use. Installing, the install is
+  *          the main loop: it pulls the image through Transfer_Fetch, which
+  *          services frames only while the installer waits for bytes.
+  */
+
+#include "secboot_transfer.h"
+#include "secboot_config.h"
+#include "secboot_crc.h"
+#include <stddef.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define TRANSFER_MAX_CHUNKS    (SECBOOT_UPDATE_SLOT_SIZE / SECBOOT_TRANSFER_CHUNK_SIZE)
+#define TRANSFER_MAX_PAGES     (SECBOOT_UPDATE_SLOT_SIZE / FLASH_PAGE_SIZE)
+#define TRANSFER_BITMAP_SIZE   ((TRANSFER_MAX_CHUNKS + 7U) / 8U)
+#define TRANSFER_CRC_OFFSET    2U     ///< The frame CRC starts at the type
+#define TRANSFER_HELLO_SIZE    13U    ///< HELLO reply payload
+#define TRANSFER_STATE_SIZE    (3U + TRANSFER_BITMAP_SIZE)  ///< START/QUERY reply payload
+#define TRANSFER_REPLY_PAYLOAD ((TRANSFER_STATE_SIZE > TRANSFER_HELLO_SIZE) ? TRANSFER_STATE_SIZE : TRANSFER_HELLO_SIZE)
+#define TRANSFER_TX_TIMEOUT_MS 100U
+
+/* Private types -------------------------------------------------------------*/
+
+/**
+  * @brief What a frame meant to the caller of Transfer_Poll
+  */
+typedef enum {
+    TRANSFER_EVENT_NONE = 0,      ///< Nothing, or a frame handled on its own
+    TRANSFER_EVENT_CHUNK,         ///< Install: the next chunk in order is in frame[]
+    TRANSFER_EVENT_SESSION,       ///< START opened a session for another image
+    TRANSFER_EVENT_COMMIT,        ///< COMMIT answered with SECBOOT_TRANSFER_RESULT_OK
+    TRANSFER_EVENT_REJECTED,      ///< The host was told the image is rejected
+    TRANSFER_EVENT_END            ///< Link lost; link.status says why
+} Transfer_EventTypeDef;
+
+/**
+  * @brief The line and the sink of one SECBOOT_Transfer_Receive/Install call
+  */
+typedef struct {
+    UART_HandleTypeDef *huart;
+    uint32_t entryBaud;           ///< Restored on return, and after a silence
+    uint32_t lastFrame;           ///< Tick of the last valid frame
+    uint32_t idleTimeout;         ///< Silence that ends the link; the listen window until a HELLO
+    SECBOOT_Transfer_StatusTypeDef status;  ///< Why the link ended
+    bool     install;             ///< Chunks go to the installer in order, not to the update slot
+    bool     installed;           ///< Install: the image is verified and promoted
+    uint8_t  verdict;             ///< Install: result answered to QUERY and COMMIT
+    Transfer_EventTypeDef abort;  ///< Install: why Transfer_Fetch gave up
+    uint32_t nextChunk;           ///< Install: next chunk the installer takes
+    uint32_t chunkPos;            ///< Install: bytes of the chunk in frame[] already fetched
+    uint32_t chunkLen;            ///< Install: bytes of the chunk in frame[]
+} Transfer_LinkTypeDef;
+
+/**
+  * @brief Image being received, kept across calls for resume
+  */
+typedef struct {
+    bool     open;                              ///< START accepted
+    uint32_t imageSize;                         ///< From START
+    uint32_t imageCrc;                          ///< From START, checked by COMMIT
+    uint32_t chunkCount;
+    uint8_t  received[TRANSFER_BITMAP_SIZE];    ///< Chunks programmed, or taken by the installer
+    uint8_t  erased[(TRANSFER_MAX_PAGES + 7U) / 8U];  ///< Pages erased for this image
+} Transfer_SessionTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static Transfer_SessionTypeDef session;
+static Transfer_LinkTypeDef link;
+static DMA_HandleTypeDef hdma_rx;
+static uint8_t rx_ring[SECBOOT_TRANSFER_RING_SIZE] __ALIGNED(4);
+static uint32_t rx_tail;                        ///< Next ring byte not yet parsed
+static uint8_t frame[SECBOOT_TRANSFER_MAX_FRAME] __ALIGNED(8);  ///< Payload double-word aligned
+static uint8_t reply[SECBOOT_TRANSFER_HEADER_SIZE + TRANSFER_REPLY_PAYLOAD + SECBOOT_TRANSFER_CRC_SIZE] __ALIGNED(4);
+
+/* Private functions ---------------------------------------------------------*/
+
+static bool Transfer_TestBit(const uint8_t *bitmap, uint32_t bit) {
+    return (bitmap[bit / 8U] & (1U << (bit % 8U))) != 0U;
+}
+
+static void Transfer_SetBit(uint8_t *bitmap, uint32_t bit) {
+    bitmap[bit / 8U] |= (uint8_t)(1U << (bit % 8U));
+}
+
+/**
+  * @brief  Bytes the DMA has written to the ring and the parser not consumed
+  */
+static uint32_t Transfer_RxAvailable(UART_HandleTypeDef *huart) {
+    uint32_t head = (SECBOOT_TRANSFER_RING_SIZE - __HAL_DMA_GET_COUNTER(huart->hdmarx)) % SECBOOT_TRANSFER_RING_SIZE;
+
+    return (head + SECBOOT_TRANSFER_RING_SIZE - rx_tail) % SECBOOT_TRANSFER_RING_SIZE;
+}
+
+static uint8_t Transfer_RxPeek(uint32_t offset) {
+    return rx_ring[(rx_tail + offset) % SECBOOT_TRANSFER_RING_SIZE];
+}
+
+static void Transfer_RxDrop(uint32_t length) {
+    rx_tail = (rx_tail + length) % SECBOOT_TRANSFER_RING_SIZE;
+}
+
+/**
+  * @brief  Copy length ring bytes to frame[], unwrapping the ring end
+  */
+static void Transfer_RxCopy(uint32_t length) {
+    uint32_t first = SECBOOT_TRANSFER_RING_SIZE - rx_tail;
+
+    if (first > length) {
+        first = length;
+    }
+    memcpy(frame, &rx_ring[rx_tail], first);
+    memcpy(&frame[first], rx_ring, length - first);
+}
+
+static bool Transfer_RxStart(UART_HandleTypeDef *huart) {
+    rx_tail = 0;
+    return HAL_UART_Receive_DMA(huart, rx_ring, SECBOOT_TRANSFER_RING_SIZE) == HAL_OK;
+}
+
+/**
+  * @brief  Reprogram the baud rate and restart reception
+  * @note   Bytes still in the ring are dropped: both ends change speed
+  *         only between frames
+  */
+static bool Transfer_SetBaud(UART_HandleTypeDef *huart, uint32_t baud) {
+    (void)HAL_UART_DMAStop(huart);
+    huart->Init.BaudRate = baud;
+    if (HAL_UART_Init(huart) != HAL_OK) {
+        return false;
+    }
+    return Transfer_RxStart(huart);
+}
+
+/**
+  * @brief  Take the next valid frame out of the ring into frame[]
+  * @retval Payload length, or -1 while no complete valid frame is there
+  * @note   Garbage, truncated and corrupted frames are skipped one byte at
+  *         a time until the next sync pattern
+  */
+static int32_t Transfer_NextFrame(UART_HandleTypeDef *huart) {
+    for (;;) {
+        uint32_t available = Transfer_RxAvailable(huart);
+        uint32_t length;
+        uint32_t crc;
+        uint32_t expected;
+
+        if (available < 2U) {
+            return -1;
+        }
+        if (Transfer_RxPeek(0) != SECBOOT_TRANSFER_SYNC0 || Transfer_RxPeek(1) != SECBOOT_TRANSFER_SYNC1) {
+            Transfer_RxDrop(1);
+            continue;
+        }
+        if (available < SECBOOT_TRANSFER_HEADER_SIZE) {
+            return -1;
+        }
+
+        length = (uint32_t)Transfer_RxPeek(6) | ((uint32_t)Transfer_RxPeek(7) << 8);
+        if (length > SECBOOT_TRANSFER_CHUNK_SIZE) {
+            Transfer_RxDrop(1);
+            continue;
+        }
+        if (available < SECBOOT_TRANSFER_HEADER_SIZE + length + SECBOOT_TRANSFER_CRC_SIZE) {
+            return -1;
+        }
+
+        Transfer_RxCopy(SECBOOT_TRANSFER_HEADER_SIZE + length + SECBOOT_TRANSFER_CRC_SIZE);
+        if (SECBOOT_CRC_Calculate(&frame[TRANSFER_CRC_OFFSET],
+                                  SECBOOT_TRANSFER_HEADER_SIZE - TRANSFER_CRC_OFFSET + length, &crc) != SECBOOT_CRC_OK) {
+            return -1;
+        }
+        memcpy(&expected, &frame[SECBOOT_TRANSFER_HEADER_SIZE + length], sizeof(expected));
+        if (crc != expected) {
+            Transfer_RxDrop(1);
+            continue;
+        }
+
+        Transfer_RxDrop(SECBOOT_TRANSFER_HEADER_SIZE + length + SECBOOT_TRANSFER_CRC_SIZE);
+        return (int32_t)length;
+    }
+}
+
+/**
+  * @brief  Send one device frame
+  */
+static void Transfer_Send(UART_HandleTypeDef *huart, uint8_t type, uint16_t index, const uint8_t *pPayload,
+                          uint16_t length) {
+    uint32_t crc = 0;
+
+    reply[0] = SECBOOT_TRANSFER_SYNC0;
+    reply[1] = SECBOOT_TRANSFER_SYNC1;
+    reply[2] = type | SECBOOT_TRANSFER_REPLY;
+    reply[3] = 0;
+    memcpy(&reply[4], &index, sizeof(index));
+    memcpy(&reply[6], &length, sizeof(length));
+    memcpy(&reply[SECBOOT_TRANSFER_HEADER_SIZE], pPayload, length);
+    (void)SECBOOT_CRC_Calculate(&reply[TRANSFER_CRC_OFFSET], SECBOOT_TRANSFER_HEADER_SIZE - TRANSFER_CRC_OFFSET + length,
+                                &crc);
+    memcpy(&reply[SECBOOT_TRANSFER_HEADER_SIZE + length], &crc, sizeof(crc));
+
+    // Lost replies are recovered by the host asking again
+    (void)HAL_UART_Transmit(huart, reply, SECBOOT_TRANSFER_HEADER_SIZE + length + SECBOOT_TRANSFER_CRC_SIZE,
+                            TRANSFER_TX_TIMEOUT_MS);
+}
+
+/**
+  * @brief  Send a result code, followed by the received bitmap when a
+  *         session is open
+  */
+static void Transfer_SendState(UART_HandleTypeDef *huart, uint8_t type, uint16_t index, uint8_t result) {
+    uint8_t payload[TRANSFER_STATE_SIZE];
+    uint16_t length = 1;
+    uint16_t count;
+
+    payload[0] = result;
+    if (session.open) {
+        count = (uint16_t)session.chunkCount;
+        memcpy(&payload[1], &count, sizeof(count));
+        memcpy(&payload[3], session.received, (session.chunkCount + 7U) / 8U);
+        length = (uint16_t)(3U + ((session.chunkCount + 7U) / 8U));
+    }
+    Transfer_Send(huart, type, index, payload, length);
+}
+
+/**
+  * @brief  Program one chunk at its place in the update slot
+  * @param  pData   Chunk, double-word aligned
+  * @param  length  Chunk bytes; the last double-word is padded with 0xFF
+  */
+static bool Transfer_WriteChunk(uint32_t chunk, const uint8_t *pData, uint32_t length) {
+    uint32_t address = SECBOOT_UPDATE_SLOT_ADDR + (chunk * SECBOOT_TRANSFER_CHUNK_SIZE);
+    uint32_t page = (chunk * SECBOOT_TRANSFER_CHUNK_SIZE) / FLASH_PAGE_SIZE;
+    bool ok = true;
+
+    HAL_FLASH_Unlock();
+
+    if (!Transfer_TestBit(session.erased, page)) {
+        FLASH_EraseInitTypeDef erase = {0};
+        uint32_t offset = (address & ~(FLASH_PAGE_SIZE - 1U)) - FLASH_BASE_NS;
+        uint32_t page_error = 0;
+
+        erase.TypeErase = FLASH_TYPEERASE_PAGES_NS;
+        erase.Banks = (offset < FLASH_BANK_SIZE) ? FLASH_BANK_1 : FLASH_BANK_2;
+        erase.Page = (offset % FLASH_BANK_SIZE) / FLASH_PAGE_SIZE;
+        erase.NbPages = 1;
+        ok = (HAL_FLASHEx_Erase(&erase, &page_error) == HAL_OK);
+        if (ok) {
+            Transfer_SetBit(session.erased, page);
+        }
+    }
+
+    for (uint32_t i = 0; ok && i < length; i += sizeof(uint64_t)) {
+        uint64_t dword = UINT64_MAX;
+
+        memcpy(&dword, &pData[i], (length - i < sizeof(dword)) ? length - i : sizeof(dword));
+        // Erased double-words need no programming
+        if (dword != UINT64_MAX) {
+            ok = (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD_NS, address + i, dword) == HAL_OK);
+        }
+    }
+
+    HAL_FLASH_Lock();
+    return ok;
+}
+
+static void Transfer_Hello(UART_HandleTypeDef *huart, uint32_t length) {
+    uint8_t payload[TRANSFER_HELLO_SIZE];
+    uint16_t chunkSize = SECBOOT_TRANSFER_CHUNK_SIZE;
+    uint32_t maxImage = SECBOOT_UPDATE_SLOT_SIZE;
+    uint32_t baud;
+
+    if (length != sizeof(baud)) {
+        payload[0] = SECBOOT_TRANSFER_RESULT_BAD_FRAME;
+        Transfer_Send(huart, SECBOOT_TRANSFER_HELLO, 0, payload, 1);
+        return;
+    }
+
+    memcpy(&baud, &frame[SECBOOT_TRANSFER_HEADER_SIZE], sizeof(baud));
+    if (baud < SECBOOT_TRANSFER_MIN_BAUD) {
+        baud = SECBOOT_TRANSFER_MIN_BAUD;
+    }
+    if (baud > SECBOOT_TRANSFER_MAX_BAUD) {
+        baud = SECBOOT_TRANSFER_MAX_BAUD;
+    }
+
+    payload[0] = SECBOOT_TRANSFER_RESULT_OK;
+    payload[1] = SECBOOT_TRANSFER_VERSION;
+    payload[2] = SECBOOT_TRANSFER_WINDOW;
+    memcpy(&payload[3], &chunkSize, sizeof(chunkSize));
+    memcpy(&payload[5], &baud, sizeof(baud));
+    memcpy(&payload[9], &maxImage, sizeof(maxImage));
+    Transfer_Send(huart, SECBOOT_TRANSFER_HELLO, 0, payload, sizeof(payload));
+
+    // The reply has left the shift register: change speed for the next frame
+    if (baud != huart->Init.BaudRate) {
+        (void)Transfer_SetBaud(huart, baud);
+    }
+}
+
+static Transfer_EventTypeDef Transfer_Start(UART_HandleTypeDef *huart, uint32_t length) {
+    uint32_t size;
+    uint32_t crc;
+
+    if (length != sizeof(size) + sizeof(crc)) {
+        Transfer_SendState(huart, SECBOOT_TRANSFER_START, 0, SECBOOT_TRANSFER_RESULT_BAD_FRAME);
+        return TRANSFER_EVENT_NONE;
+    }
+    memcpy(&size, &frame[SECBOOT_TRANSFER_HEADER_SIZE], sizeof(size));
+    memcpy(&crc, &frame[SECBOOT_TRANSFER_HEADER_SIZE + sizeof(size)], sizeof(crc));
+
+    if (size == 0 || size > SECBOOT_UPDATE_SLOT_SIZE) {
+        SECBOOT_Transfer_Reset();
+        Transfer_SendState(huart, SECBOOT_TRANSFER_START, 0, SECBOOT_TRANSFER_RESULT_TOO_LARGE);
+        return TRANSFER_EVENT_NONE;
+    }
+
+    // Same image as the open session: resume where it stopped
+    if (session.open && session.imageSize == size && session.imageCrc == crc) {
+        Transfer_SendState(huart, SECBOOT_TRANSFER_START, 0, link.verdict);
+        return TRANSFER_EVENT_NONE;
+    }
+
+    SECBOOT_Transfer_Reset();
+    session.open = true;
+    session.imageSize = size;
+    session.imageCrc = crc;
+    session.chunkCount = (size + SECBOOT_TRANSFER_CHUNK_SIZE - 1U) / SECBOOT_TRANSFER_CHUNK_SIZE;
+    link.installed = false;
+    link.verdict = SECBOOT_TRANSFER_RESULT_OK;
+    link.nextChunk = 0;
+    link.chunkPos = 0;
+    link.chunkLen = 0;
+    Transfer_SendState(huart, SECBOOT_TRANSFER_START, 0, SECBOOT_TRANSFER_RESULT_OK);
+    return TRANSFER_EVENT_SESSION;
+}
+
+static Transfer_EventTypeDef Transfer_Data(UART_HandleTypeDef *huart, uint32_t chunk, uint32_t length) {
+    uint32_t expected;
+
+    // Stray or duplicate chunks are dropped; the SACK tells the host
+    if (!session.open || chunk >= session.chunkCount || Transfer_TestBit(session.received, chunk)) {
+        return TRANSFER_EVENT_NONE;
+    }
+    expected = session.imageSize - (chunk * SECBOOT_TRANSFER_CHUNK_SIZE);
+    if (expected > SECBOOT_TRANSFER_CHUNK_SIZE) {
+        expected = SECBOOT_TRANSFER_CHUNK_SIZE;
+    }
+    if (length != expected) {
+        return TRANSFER_EVENT_NONE;
+    }
+
+    // The installer takes the image as a stream: chunks past a gap are
+    // dropped too, and the SACK has the host send them again
+    if (link.install) {
+        if (chunk != link.nextChunk || link.verdict != SECBOOT_TRANSFER_RESULT_OK || link.installed) {
+            return TRANSFER_EVENT_NONE;
+        }
+        Transfer_SetBit(session.received, chunk);
+        link.nextChunk++;
+        link.chunkPos = 0;
+        link.chunkLen = length;
+        return TRANSFER_EVENT_CHUNK;
+    }
+
+    if (!Transfer_WriteChunk(chunk, &frame[SECBOOT_TRANSFER_HEADER_SIZE], length)) {
+        Transfer_SendState(huart, SECBOOT_TRANSFER_QUERY, (uint16_t)chunk, SECBOOT_TRANSFER_RESULT_FLASH_ERROR);
+        link.status = SECBOOT_TRANSFER_FLASH_ERROR;
+        return TRANSFER_EVENT_END;
+    }
+    Transfer_SetBit(session.received, chunk);
+    return TRANSFER_EVENT_NONE;
+}
+
+static Transfer_EventTypeDef Transfer_Commit(UART_HandleTypeDef *huart) {
+    uint32_t crc = 0;
+
+    if (!session.open) {
+        Transfer_SendState(huart, SECBOOT_TRANSFER_COMMIT, 0, SECBOOT_TRANSFER_RESULT_NO_SESSION);
+        return TRANSFER_EVENT_NONE;
+    }
+
+    // Installing, the signed digest and the tag vouch for the image
+    if (link.install) {
+        if (link.verdict != SECBOOT_TRANSFER_RESULT_OK) {
+            Transfer_SendState(huart, SECBOOT_TRANSFER_COMMIT, 0, link.verdict);
+            return TRANSFER_EVENT_REJECTED;
+        }
+        if (!link.installed) {
+            Transfer_SendState(huart, SECBOOT_TRANSFER_COMMIT, 0, SECBOOT_TRANSFER_RESULT_INCOMPLETE);
+            return TRANSFER_EVENT_NONE;
+        }
+        Transfer_SendState(huart, SECBOOT_TRANSFER_COMMIT, 0, SECBOOT_TRANSFER_RESULT_OK);
+        return TRANSFER_EVENT_COMMIT;
+    }
+
+    for (uint32_t chunk = 0; chunk < session.chunkCount; chunk++) {
+        if (!Transfer_TestBit(session.received, chunk)) {
+            Transfer_SendState(huart, SECBOOT_TRANSFER_COMMIT, 0, SECBOOT_TRANSFER_RESULT_INCOMPLETE);
+            return TRANSFER_EVENT_NONE;
+        }
+    }
+
+    // Read back what was programmed, not what was received
+    if (SECBOOT_CRC_Calculate((uint8_t*)SECBOOT_UPDATE_SLOT_ADDR, session.imageSize, &crc) != SECBOOT_CRC_OK ||
+        crc != session.imageCrc) {
+        SECBOOT_Transfer_Reset();
+        Transfer_SendState(huart, SECBOOT_TRANSFER_COMMIT, 0, SECBOOT_TRANSFER_RESULT_CRC_MISMATCH);
+        return TRANSFER_EVENT_NONE;
+    }
+
+    Transfer_SendState(huart, SECBOOT_TRANSFER_COMMIT, 0, SECBOOT_TRANSFER_RESULT_OK);
+    return TRANSFER_EVENT_COMMIT;
+}
+
+/**
+  * @brief  Bind the receive DMA channel to the UART
+  */
+static bool Transfer_DmaInit(UART_HandleTypeDef *huart) {
+    __HAL_RCC_DMAMUX1_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    hdma_rx.Instance = SECBOOT_TRANSFER_DMA_CHANNEL;
+    hdma_rx.Init.Request = DMA_REQUEST_USART1_RX;
+    hdma_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    hdma_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_rx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_rx.Init.Mode = DMA_CIRCULAR;
+    hdma_rx.Init.Priority = DMA_PRIORITY_HIGH;
+    if (HAL_DMA_Init(&hdma_rx) != HAL_OK) {
+        return false;
+    }
+    // Secure channel writing the secure ring
+    if (HAL_DMA_ConfigChannelAttributes(&hdma_rx, DMA_CHANNEL_PRIV | DMA_CHANNEL_SEC | DMA_CHANNEL_SRC_SEC |
+                                                  DMA_CHANNEL_DEST_SEC) != HAL_OK) {
+        return false;
+    }
+    __HAL_LINKDMA(huart, hdmarx, hdma_rx);
+    return true;
+}
+
+static bool Transfer_Open(UART_HandleTypeDef *huart, bool install, uint32_t idleTimeout) {
+    memset(&link, 0, sizeof(link));
+    link.huart = huart;
+    link.entryBaud = huart->Init.BaudRate;
+    link.idleTimeout = idleTimeout;
+    link.status = SECBOOT_TRANSFER_TIMEOUT;
+    link.install = install;
+    link.verdict = SECBOOT_TRANSFER_RESULT_OK;
+
+    if (!Transfer_DmaInit(huart) || !Transfer_RxStart(huart)) {
+        (void)HAL_DMA_DeInit(&hdma_rx);
+        huart->hdmarx = NULL;
+        return false;
+    }
+    link.lastFrame = HAL_GetTick();
+    return true;
+}
+
+static void Transfer_Close(void) {
+    UART_HandleTypeDef *huart = link.huart;
+
+    (void)HAL_UART_DMAStop(huart);
+    (void)HAL_DMA_DeInit(&hdma_rx);
+    huart->hdmarx = NULL;
+    if (huart->Init.BaudRate != link.entryBaud) {
+        huart->Init.BaudRate = link.entryBaud;
+        (void)HAL_UART_Init(huart);
+    }
+}
+
+/**
+  * @brief  Handle the next frame, or sleep until the next tick
+  */
+static Transfer_EventTypeDef Transfer_Poll(void) {
+    UART_HandleTypeDef *huart = link.huart;
+    uint16_t index;
+    int32_t length;
+
+    // A receive error (overrun, framing) makes the HAL stop the DMA
+    if (huart->RxState != HAL_UART_STATE_BUSY_RX && !Transfer_RxStart(huart)) {
+        link.status = SECBOOT_TRANSFER_UART_ERROR;
+        return TRANSFER_EVENT_END;
+    }
+
+    length = Transfer_NextFrame(huart);
+    if (length < 0) {
+        uint32_t idle = HAL_GetTick() - link.lastFrame;
+
+        if (idle >= link.idleTimeout) {
+            link.status = SECBOOT_TRANSFER_TIMEOUT;
+            return TRANSFER_EVENT_END;
+        }
+        // The host lost the negotiated baud (reset, reconnect): listen at the entry baud again
+        if (huart->Init.BaudRate != link.entryBaud && idle >= SECBOOT_TRANSFER_BAUD_FALLBACK_MS &&
+            !Transfer_SetBaud(huart, link.entryBaud)) {
+            link.status = SECBOOT_TRANSFER_UART_ERROR;
+            return TRANSFER_EVENT_END;
+        }
+        // Woken by SysTick at the latest; the ring holds a whole window
+        __WFI();
+        return TRANSFER_EVENT_NONE;
+    }
+
+    link.lastFrame = HAL_GetTick();
+    memcpy(&index, &frame[4], sizeof(index));
+
+    switch (frame[2]) {
+        case SECBOOT_TRANSFER_HELLO:
+            // A host is there: a listen window stretches to the idle timeout
+            link.idleTimeout = SECBOOT_TRANSFER_IDLE_TIMEOUT_MS;
+            Transfer_Hello(huart, (uint32_t)length);
+            return TRANSFER_EVENT_NONE;
+        case SECBOOT_TRANSFER_START:
+            return Transfer_Start(huart, (uint32_t)length);
+        case SECBOOT_TRANSFER_DATA:
+            return Transfer_Data(huart, index, (uint32_t)length);
+        case SECBOOT_TRANSFER_QUERY:
+            if (!session.open) {
+                Transfer_SendState(huart, SECBOOT_TRANSFER_QUERY, index, SECBOOT_TRANSFER_RESULT_NO_SESSION);
+                return TRANSFER_EVENT_NONE;
+            }
+            Transfer_SendState(huart, SECBOOT_TRANSFER_QUERY, index, link.verdict);
+            return (link.verdict == SECBOOT_TRANSFER_RESULT_OK) ? TRANSFER_EVENT_NONE : TRANSFER_EVENT_REJECTED;
+        case SECBOOT_TRANSFER_COMMIT:
+            return Transfer_Commit(huart);
+        default:
+            Transfer_SendState(huart, frame[2] & ~SECBOOT_TRANSFER_REPLY, index, SECBOOT_TRANSFER_RESULT_BAD_FRAME);
+            return TRANSFER_EVENT_NONE;
+    }
+}
+
+/**
+  * @brief  Handle frames until one means event, or the link is lost
+  */
+static Transfer_EventTypeDef Transfer_Await(Transfer_EventTypeDef event) {
+    Transfer_EventTypeDef got;
+
+    do {
+        got = Transfer_Poll();
+    } while (got != event && got != TRANSFER_EVENT_END);
+    return got;
+}
+
+/**
+  * @brief  SECBOOT_BootManager_FetchFn: the next image bytes, in order
+  * @note   Frames are only handled here, while the installer waits
+  */
+static bool Transfer_Fetch(void *ctx, uint8_t *pData, uint32_t length) {
+    (void)ctx;
+
+    while (length > 0) {
+        uint32_t n = link.chunkLen - link.chunkPos;
+
+        if (n == 0) {
+            Transfer_EventTypeDef event = Transfer_Poll();
+
+            // Another image, or no image at all: this install is over
+            if (event == TRANSFER_EVENT_SESSION || event == TRANSFER_EVENT_END) {
+                link.abort = event;
+                return false;
+            }
+            continue;
+        }
+
+        if (n > length) {
+            n = length;
+        }
+        memcpy(pData, &frame[SECBOOT_TRANSFER_HEADER_SIZE + link.chunkPos], n);
+        link.chunkPos += n;
+        pData += n;
+        length -= n;
+    }
+    return true;
+}
+
+/* Function implementations --------------------------------------------------*/
+
+SECBOOT_Transfer_StatusTypeDef SECBOOT_Transfer_Receive(UART_HandleTypeDef *huart, uint32_t *pImageSize) {
+    SECBOOT_Transfer_StatusTypeDef status;
+
+    if (huart == NULL || pImageSize == NULL) {
+        return SECBOOT_TRANSFER_INVALID_PARAM;
+    }
+    if (!Transfer_Open(huart, false, SECBOOT_TRANSFER_IDLE_TIMEOUT_MS)) {
+        return SECBOOT_TRANSFER_UART_ERROR;
+    }
+
+    if (Transfer_Await(TRANSFER_EVENT_COMMIT) == TRANSFER_EVENT_COMMIT) {
+        *pImageSize = session.imageSize;
+        SECBOOT_Transfer_Reset();
+        status = SECBOOT_TRANSFER_OK;
+    } else {
+        status = link.status;
+    }
+
+    Transfer_Close();
+    return status;
+}
+
+/**
+  * @brief  SECBOOT_Transfer_Install, giving up after idleTimeout ms of
+  *         silence until the host says HELLO
+  */
+static SECBOOT_Transfer_StatusTypeDef Transfer_Install(UART_HandleTypeDef *huart, const uint8_t *key,
+                                                       SECBOOT_BOOTMANAGER_StatusTypeDef *pInstallStatus,
+                                                       uint32_t idleTimeout) {
+    SECBOOT_Transfer_StatusTypeDef status;
+    Transfer_EventTypeDef event;
+
+    if (huart == NULL || key == NULL || pInstallStatus == NULL) {
+        return SECBOOT_TRANSFER_INVALID_PARAM;
+    }
+    *pInstallStatus = SECBOOT_BOOTMANAGER_ERROR;
+
+    // Nothing is staged, so a session cannot outlive the call
+    SECBOOT_Transfer_Reset();
+    if (!Transfer_Open(huart, true, idleTimeout)) {
+        return SECBOOT_TRANSFER_UART_ERROR;
+    }
+
+    // Each START of another image restarts the install from its header
+    event = Transfer_Await(TRANSFER_EVENT_SESSION);
+    while (event == TRANSFER_EVENT_SESSION) {
+        link.abort = TRANSFER_EVENT_NONE;
+        *pInstallStatus = SECBOOT_BootManager_UpdateFirmwareStream(session.imageSize, key, Transfer_Fetch, NULL);
+        event = link.abort;
+    }
+
+    if (event == TRANSFER_EVENT_END) {
+        status = link.status;
+    } else if (*pInstallStatus == SECBOOT_BOOTMANAGER_OK) {
+        // Installed and promoted: the COMMIT answer is a courtesy
+        link.installed = true;
+        (void)Transfer_Await(TRANSFER_EVENT_COMMIT);
+        status = SECBOOT_TRANSFER_OK;
+    } else {
+        link.verdict = SECBOOT_TRANSFER_RESULT_REJECTED;
+        (void)Transfer_Await(TRANSFER_EVENT_REJECTED);
+        status = SECBOOT_TRANSFER_REJECTED;
+    }
+
+    SECBOOT_Transfer_Reset();
+    Transfer_Close();
+    return status;
+}
+
+SECBOOT_Transfer_StatusTypeDef SECBOOT_Transfer_Install(UART_HandleTypeDef *huart, const uint8_t *key,
+                                                        SECBOOT_BOOTMANAGER_StatusTypeDef *pInstallStatus) {
+    return Transfer_Install(huart, key, pInstallStatus, SECBOOT_TRANSFER_IDLE_TIMEOUT_MS);
+}
+
+SECBOOT_Transfer_StatusTypeDef SECBOOT_Transfer_Listen(UART_HandleTypeDef *huart, uint32_t window, const uint8_t *key,
+                                                       SECBOOT_BOOTMANAGER_StatusTypeDef *pInstallStatus) {
+    if (window == 0U) {
+        return SECBOOT_TRANSFER_TIMEOUT;
+    }
+    return Transfer_Install(huart, key, pInstallStatus, window);
+}
+
+void SECBOOT_Transfer_Reset(void) {
+    memset(&session, 0, sizeof(session));
+}
@@ -22,6 +22,8 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "secure_nsc.h"
+#include "secboot_nslog.h"
+#include "secboot_nscrypto.h"
 /** @addtogroup STM32L5xx_HAL_Examples
 
   * @{
@@ -73,8 +75,36 @@ CMSE_NS_ENTRY void SECURE_RegisterCallback(SECURE_CallbackIDTypeDef CallbackId,
   */
 
 CMSE_NS_ENTRY void NSC_print(int ch){
+  /* Keep the order with text still queued in the log ring */
+  SECBOOT_NSLog_Flush();
   HAL_UART_Transmit(&huart1,(uint8_t*)&ch,1,HAL_MAX_DELAY);
 }
+
+/**
+  * @brief  Attach the non-secure log ring (see secboot_nslog.h)
+  * @param  ring  Ring in non-secure RAM, size a power of two
+  * @retval 0 on success, -1 when the ring was refused
+  */
+CMSE_NS_ENTRY int32_t NSC_LogAttach(NSC_LogRingTypeDef *ring){
+  return (SECBOOT_NSLog_Attach(&huart1, ring) == SECBOOT_NSLOG_OK) ? 0 : -1;
+}
+
+/**
+  * @brief  Send what was written to the log ring; returns without waiting
+  */
+CMSE_NS_ENTRY void NSC_LogSubmit(void){
+  (void)SECBOOT_NSLog_Submit();
+}
+
+/**
+  * @brief  Run a queue of crypto requests (see secboot_nscrypto.h)
+  * @param  queue  Requests in non-secure SRAM2
+  * @param  count  Number of requests
+  * @retval Number of requests that completed with NSC_CRYPTO_OK
+  */
+CMSE_NS_ENTRY uint32_t NSC_CryptoSubmit(NSC_CryptoRequestTypeDef *queue, uint32_t count){
+  return SECBOOT_NSCrypto_Submit(queue, count);
+}
 /**
   * @}
   */
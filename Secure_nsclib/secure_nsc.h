@@ -36,11 +36,75 @@ typedef enum
   GTZC_ERROR_CB_ID       = 0x01U  /*!< GTZC secure error callback ID */
 } SECURE_CallbackIDTypeDef;
 
+/**
+  * @brief  Non-secure log ring, shared with the secure side (secboot_nslog.h)
+  * @note   head and tail are free-running byte counts; the non-secure side
+  *         only writes head and data, the secure side only writes tail.
+  */
+typedef struct
+{
+  volatile uint32_t head;  /*!< Bytes written by the non-secure side */
+  volatile uint32_t tail;  /*!< Bytes sent by the secure side */
+  uint32_t size;           /*!< Size of data, a power of two */
+  uint8_t data[];          /*!< Log text */
+} NSC_LogRingTypeDef;
+
+/**
+  * @brief  Crypto operations of NSC_CryptoSubmit (secboot_nscrypto.h)
+  */
+typedef enum
+{
+  NSC_CRYPTO_SHA256        = 0x01U, /*!< SHA-256 of input into output (32 bytes) */
+  NSC_CRYPTO_SHA256_START  = 0x02U, /*!< Open the streaming SHA-256; drops a stream another queue left open */
+  NSC_CRYPTO_SHA256_UPDATE = 0x03U, /*!< Absorb input into the open SHA-256 */
+  NSC_CRYPTO_SHA256_FINAL  = 0x04U, /*!< Close the SHA-256, digest into output (32 bytes) */
+  NSC_CRYPTO_AES_CTR       = 0x05U, /*!< Encrypt or decrypt input into output: key (16 or 32 bytes),
+                                         iv = initial counter block (16 bytes) */
+  NSC_CRYPTO_ECDSA_VERIFY  = 0x06U, /*!< P-256: input = SHA-256 digest, key = Qx || Qy,
+                                         iv = R || S (big-endian) */
+  NSC_CRYPTO_SHA256_ABORT  = 0x07U  /*!< Drop the open SHA-256, if any, without a digest */
+} NSC_CryptoOpTypeDef;
+
+/**
+  * @brief  Result written back to NSC_CryptoRequestTypeDef.status
+  */
+typedef enum
+{
+  NSC_CRYPTO_OK            = 0,     /*!< Done */
+  NSC_CRYPTO_PENDING       = 1,     /*!< Not processed (queue cut short) */
+  NSC_CRYPTO_INVALID_PARAM = 2,     /*!< Unknown op, bad length, or buffer outside the shared SRAM2 */
+  NSC_CRYPTO_BUSY          = 3,     /*!< SHA-256: a stream is already open, or none is */
+  NSC_CRYPTO_ERROR         = 4,     /*!< Engine failure */
+  NSC_CRYPTO_BAD_SIGNATURE = 5      /*!< ECDSA: signature does not match */
+} NSC_CryptoStatusTypeDef;
+
+/**
+  * @brief  One crypto request; every buffer must lie in non-secure SRAM2
+  * @note   The engines read input and write output in place, without
+  *         copies through secure memory. Unused pointers may be NULL.
+  */
+typedef struct
+{
+  uint32_t op;                  /*!< NSC_CryptoOpTypeDef */
+  volatile int32_t status;      /*!< NSC_CryptoStatusTypeDef, written by the secure side */
+  const uint8_t *key;           /*!< AES key, or ECDSA public key */
+  uint32_t keyLength;
+  const uint8_t *iv;            /*!< AES counter block, or ECDSA signature */
+  uint32_t ivLength;
+  const uint8_t *input;
+  uint32_t inputLength;
+  uint8_t *output;              /*!< May equal input for AES */
+  uint32_t outputLength;        /*!< Room in output */
+} NSC_CryptoRequestTypeDef;
+
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 void SECURE_RegisterCallback(SECURE_CallbackIDTypeDef CallbackId, void *func);
 void NSC_print(int ch);
+int32_t NSC_LogAttach(NSC_LogRingTypeDef *ring);
+void NSC_LogSubmit(void);
+uint32_t NSC_CryptoSubmit(NSC_CryptoRequestTypeDef *queue, uint32_t count);
 void GreenLED_ON(void);
 void GreenLED_OFF(void);
 void RedLED_ON(void);
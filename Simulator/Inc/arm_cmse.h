@@ -0,0 +1,35 @@
+/**
+  * @file    arm_cmse.h
+  * @brief   Host replacement for the Armv8-M Security Extensions header
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    The simulator runs the secure image as a plain host process, so
+  *          there is no security state to query. Address range checks accept
+  *          every range, matching a secure caller with no SAU restrictions.
+  */
+
+#ifndef __ARM_CMSE_H
+#define __ARM_CMSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CMSE_MPU_UNPRIV        4
+#define CMSE_MPU_READWRITE     1
+#define CMSE_MPU_READ          8
+#define CMSE_NONSECURE         0x10000
+#define CMSE_AU_NONSECURE      0x20000
+#define CMSE_MPU_NONSECURE     0x40000
+
+#define cmse_nsfptr_create(p)  (p)
+#define cmse_is_nsfptr(p)      (0)
+
+static inline void *cmse_check_address_range(void *p, size_t s, int flags)
+{
+  (void)s;
+  (void)flags;
+  return p;
+}
+
+#endif /* __ARM_CMSE_H */
@@ -0,0 +1,150 @@
+/**
+  * @file    cmsis_compiler.h
+  * @brief   Host replacement for the CMSIS compiler header (boot simulator)
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    Placed ahead of Drivers/CMSIS/Include on the simulator include
+  *          path. Provides the CMSIS attribute macros and core intrinsics
+  *          without any Arm inline assembly so the unmodified device and HAL
+  *          headers build for the host. Core register accesses that matter
+  *          to the boot flow (non-secure MSP) are routed to the simulator.
+  */
+
+#ifndef __CMSIS_COMPILER_H
+#define __CMSIS_COMPILER_H
+
+#include <stdint.h>
+
+#ifndef __has_builtin
+  #define __has_builtin(x) (0)
+#endif
+
+/* CMSIS compiler specific defines --------------------------------------*/
+#define __ASM                                  __asm
+#define __INLINE                               inline
+#define __STATIC_INLINE                        static inline
+#define __STATIC_FORCEINLINE                   __attribute__((always_inline)) static inline
+#define __NO_RETURN                            __attribute__((__noreturn__))
+#define __USED                                 __attribute__((used))
+#define __WEAK                                 __attribute__((weak))
+#define __PACKED                               __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT                        struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION                         union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)                           __attribute__((aligned(x)))
+#define __RESTRICT                             __restrict
+#define __COMPILER_BARRIER()                   __ASM volatile("":::"memory")
+
+__PACKED_STRUCT T_UINT32 { uint32_t v; };
+__PACKED_STRUCT T_UINT16_WRITE { uint16_t v; };
+__PACKED_STRUCT T_UINT16_READ { uint16_t v; };
+__PACKED_STRUCT T_UINT32_WRITE { uint32_t v; };
+__PACKED_STRUCT T_UINT32_READ { uint32_t v; };
+#define __UNALIGNED_UINT32(x)                  (((struct T_UINT32 *)(x))->v)
+#define __UNALIGNED_UINT16_WRITE(addr, val)    (void)((((struct T_UINT16_WRITE *)(void *)(addr))->v) = (val))
+#define __UNALIGNED_UINT16_READ(addr)          (((const struct T_UINT16_READ *)(const void *)(addr))->v)
+#define __UNALIGNED_UINT32_WRITE(addr, val)    (void)((((struct T_UINT32_WRITE *)(void *)(addr))->v) = (val))
+#define __UNALIGNED_UINT32_READ(addr)          (((const struct T_UINT32_READ *)(const void *)(addr))->v)
+
+/* Core register hooks implemented by the simulator ---------------------*/
+
+/**
+  * @brief  Record the non-secure MSP programmed before the non-secure jump
+  * @note   The simulator treats this as the point of no return of
+  *         SECBOOT_BootManager_JumpTo and ends the secure boot run there.
+  */
+void SIM_Core_SetMSP_NS(uint32_t topOfMainStack);
+
+/**
+  * @brief  Sleep until the next modelled interrupt
+  * @note   Advances the clock to the pending event (flash end of
+  *         operation), or else to the next SysTick, giving a host on the
+  *         UART line that long in real time to send. Received bytes are
+  *         delivered on the way out.
+  */
+void SIM_Core_WaitForInterrupt(void);
+
+/* Core instruction access ----------------------------------------------*/
+#define __NOP()                                __COMPILER_BARRIER()
+#define __WFI()                                SIM_Core_WaitForInterrupt()
+#define __WFE()                                __COMPILER_BARRIER()
+#define __SEV()                                __COMPILER_BARRIER()
+#define __BKPT(value)                          __COMPILER_BARRIER()
+
+__STATIC_FORCEINLINE void __enable_irq(void)        { __COMPILER_BARRIER(); }
+__STATIC_FORCEINLINE void __disable_irq(void)       { __COMPILER_BARRIER(); }
+__STATIC_FORCEINLINE void __enable_fault_irq(void)  { __COMPILER_BARRIER(); }
+__STATIC_FORCEINLINE void __disable_fault_irq(void) { __COMPILER_BARRIER(); }
+__STATIC_FORCEINLINE void __ISB(void)               { __sync_synchronize(); }
+__STATIC_FORCEINLINE void __DSB(void)               { __sync_synchronize(); }
+__STATIC_FORCEINLINE void __DMB(void)               { __sync_synchronize(); }
+
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void)   { return 0U; }
+__STATIC_FORCEINLINE void __set_PRIMASK(uint32_t priMask) { (void)priMask; }
+__STATIC_FORCEINLINE uint32_t __get_BASEPRI(void)   { return 0U; }
+__STATIC_FORCEINLINE void __set_BASEPRI(uint32_t basePri) { (void)basePri; }
+__STATIC_FORCEINLINE void __set_BASEPRI_MAX(uint32_t basePri) { (void)basePri; }
+__STATIC_FORCEINLINE uint32_t __get_FAULTMASK(void) { return 0U; }
+__STATIC_FORCEINLINE void __set_FAULTMASK(uint32_t faultMask) { (void)faultMask; }
+__STATIC_FORCEINLINE uint32_t __get_CONTROL(void)   { return 0U; }
+__STATIC_FORCEINLINE void __set_CONTROL(uint32_t control) { (void)control; }
+__STATIC_FORCEINLINE uint32_t __get_IPSR(void)      { return 0U; }
+__STATIC_FORCEINLINE uint32_t __get_MSP(void)       { return 0U; }
+__STATIC_FORCEINLINE void __set_MSP(uint32_t topOfMainStack) { (void)topOfMainStack; }
+__STATIC_FORCEINLINE uint32_t __get_PSP(void)       { return 0U; }
+__STATIC_FORCEINLINE void __set_PSP(uint32_t topOfProcStack) { (void)topOfProcStack; }
+__STATIC_FORCEINLINE uint32_t __get_MSPLIM(void)    { return 0U; }
+__STATIC_FORCEINLINE void __set_MSPLIM(uint32_t MainStackPtrLimit) { (void)MainStackPtrLimit; }
+__STATIC_FORCEINLINE uint32_t __get_PSPLIM(void)    { return 0U; }
+__STATIC_FORCEINLINE void __set_PSPLIM(uint32_t ProcStackPtrLimit) { (void)ProcStackPtrLimit; }
+__STATIC_FORCEINLINE uint32_t __get_FPSCR(void)     { return 0U; }
+__STATIC_FORCEINLINE void __set_FPSCR(uint32_t fpscr) { (void)fpscr; }
+
+__STATIC_FORCEINLINE uint32_t __TZ_get_MSP_NS(void) { return 0U; }
+__STATIC_FORCEINLINE void __TZ_set_MSP_NS(uint32_t topOfMainStack) { SIM_Core_SetMSP_NS(topOfMainStack); }
+__STATIC_FORCEINLINE uint32_t __TZ_get_PSP_NS(void) { return 0U; }
+__STATIC_FORCEINLINE void __TZ_set_PSP_NS(uint32_t topOfProcStack) { (void)topOfProcStack; }
+__STATIC_FORCEINLINE uint32_t __TZ_get_CONTROL_NS(void) { return 0U; }
+__STATIC_FORCEINLINE void __TZ_set_CONTROL_NS(uint32_t control) { (void)control; }
+__STATIC_FORCEINLINE uint32_t __TZ_get_PRIMASK_NS(void) { return 0U; }
+__STATIC_FORCEINLINE void __TZ_set_PRIMASK_NS(uint32_t priMask) { (void)priMask; }
+__STATIC_FORCEINLINE uint32_t __TZ_get_SP_NS(void)  { return 0U; }
+__STATIC_FORCEINLINE void __TZ_set_SP_NS(uint32_t topOfStack) { (void)topOfStack; }
+__STATIC_FORCEINLINE uint32_t __TZ_get_MSPLIM_NS(void) { return 0U; }
+__STATIC_FORCEINLINE void __TZ_set_MSPLIM_NS(uint32_t MainStackPtrLimit) { (void)MainStackPtrLimit; }
+
+/* Data manipulation ----------------------------------------------------*/
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t value)   { return __builtin_bswap32(value); }
+__STATIC_FORCEINLINE uint32_t __REV16(uint32_t value)
+{
+  return ((value & 0xFF00FF00UL) >> 8) | ((value & 0x00FF00FFUL) << 8);
+}
+__STATIC_FORCEINLINE int16_t __REVSH(int16_t value)   { return (int16_t)__builtin_bswap16((uint16_t)value); }
+__STATIC_FORCEINLINE uint32_t __ROR(uint32_t op1, uint32_t op2)
+{
+  op2 %= 32U;
+  return (op2 == 0U) ? op1 : ((op1 >> op2) | (op1 << (32U - op2)));
+}
+__STATIC_FORCEINLINE uint32_t __RBIT(uint32_t value)
+{
+  uint32_t result = 0U;
+  for (uint32_t i = 0U; i < 32U; i++) {
+    result = (result << 1) | ((value >> i) & 1U);
+  }
+  return result;
+}
+__STATIC_FORCEINLINE uint8_t __CLZ(uint32_t value)
+{
+  return (value == 0U) ? 32U : (uint8_t)__builtin_clz(value);
+}
+
+/* Exclusive access: the simulator is single threaded --------------------*/
+__STATIC_FORCEINLINE uint32_t __LDREXW(volatile uint32_t *addr) { return *addr; }
+__STATIC_FORCEINLINE uint32_t __STREXW(uint32_t value, volatile uint32_t *addr) { *addr = value; return 0U; }
+__STATIC_FORCEINLINE uint16_t __LDREXH(volatile uint16_t *addr) { return *addr; }
+__STATIC_FORCEINLINE uint32_t __STREXH(uint16_t value, volatile uint16_t *addr) { *addr = value; return 0U; }
+__STATIC_FORCEINLINE uint8_t __LDREXB(volatile uint8_t *addr) { return *addr; }
+__STATIC_FORCEINLINE uint32_t __STREXB(uint8_t value, volatile uint8_t *addr) { *addr = value; return 0U; }
+__STATIC_FORCEINLINE void __CLREX(void) { }
+
+#endif /* __CMSIS_COMPILER_H */
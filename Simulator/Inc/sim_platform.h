@@ -0,0 +1,351 @@
+/**
+  * @file    sim_platform.h
+  * @brief   Host boot simulator platform model for STM32L562
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @details The simulator runs the secure boot sources from Secure/Core/Src
+  *          as a Linux process. This module owns the emulated address space:
+  *          - 512KB flash image mapped read-only at both its non-secure
+  *            (0x08000000) and secure (0x0C000000) aliases, as on silicon
+  *          - scratch windows for the peripheral and system control space
+  *            registers touched by HAL macros (RCC, SCB, SCB_NS)
+  *          - the device information page (UID, flash size)
+  *          It also keeps the cycle clock and per-engine counters that the
+  *          HAL stand-ins advance, so boot latency can be modelled without
+  *          a board.
+  */
+
+#ifndef SIM_PLATFORM_H
+#define SIM_PLATFORM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Emulated memory map -------------------------------------------------*/
+#define SIM_FLASH_NS_BASE          0x08000000UL  /* Non-secure flash alias */
+#define SIM_FLASH_S_BASE           0x0C000000UL  /* Secure flash alias */
+#define SIM_FLASH_SIZE             (512 * 1024)  /* STM32L562xE */
+#define SIM_FLASH_PAGE_SIZE        0x800UL       /* 2KB pages (DBANK=1) */
+#define SIM_FLASH_BANK_SIZE        (SIM_FLASH_SIZE / 2)
+#define SIM_FLASH_ERASED_BYTE      0xFFU
+#define SIM_POWER_CUT_NEVER        UINT64_MAX
+#define SIM_EVENT_SOURCES          4U            /* Background engines with an interrupt pending */
+
+#define SIM_PERIPH_NS_BASE         0x40000000UL  /* Non-secure APB/AHB peripherals */
+#define SIM_PERIPH_S_BASE          0x50000000UL  /* Secure APB/AHB peripherals */
+#define SIM_PERIPH_SIZE            0x02100000UL  /* Up to the end of AHB2 (PKA, OTFDEC) */
+#define SIM_SCS_BASE               0xE000E000UL  /* System control space */
+#define SIM_SCS_NS_BASE            0xE002E000UL  /* System control space (NS alias) */
+#define SIM_SCS_SIZE               0x00001000UL
+#define SIM_DEVINFO_BASE           0x0BFA0000UL  /* UID / flash size page */
+#define SIM_DEVINFO_SIZE           0x00001000UL
+
+/* Unique ID of the bench board the Artifacts were provisioned for: the
+ * bootloader derives the key-unwrap key from it (see get_AES_key). */
+#define SIM_DEFAULT_UID_W0         0x00240028UL
+#define SIM_DEFAULT_UID_W1         0x32365003UL
+#define SIM_DEFAULT_UID_W2         0x2034354EUL
+
+/* Cycle cost model ----------------------------------------------------*/
+/* Figures are per-operation estimates for the STM32L5 engines at the
+ * clock configured by SystemClock_Config. They are model constants, not
+ * measurements: override on the make command line after calibrating
+ * against a bench trace (e.g. make SIM_DEFS=-DSIM_CYCLES_PKA_ECDSA_VERIF=...). */
+#ifndef SIM_CYCLES_FLASH_WORD_READ
+#define SIM_CYCLES_FLASH_WORD_READ 2U        /* 1 wait state data read */
+#endif
+#ifndef SIM_CYCLES_CRC_WORD
+#define SIM_CYCLES_CRC_WORD        4U        /* DR write, 32-bit input */
+#endif
+#ifndef SIM_CYCLES_CRC_BYTE_PACK
+#define SIM_CYCLES_CRC_BYTE_PACK   3U        /* HAL byte packing, per byte */
+#endif
+#ifndef SIM_CYCLES_HASH_WORD
+#define SIM_CYCLES_HASH_WORD       4U        /* DIN write, per word */
+#endif
+#ifndef SIM_CYCLES_HASH_BLOCK
+#define SIM_CYCLES_HASH_BLOCK      66U       /* SHA-256 core, per 64B block */
+#endif
+#ifndef SIM_CYCLES_AES_BLOCK
+#define SIM_CYCLES_AES_BLOCK       84U       /* 51 core + 8 register accesses */
+#endif
+#ifndef SIM_CYCLES_PKA_ECDSA_VERIF
+#define SIM_CYCLES_PKA_ECDSA_VERIF 3400000U  /* P-256 verification */
+#endif
+#ifndef SIM_CYCLES_PKA_POINT_CHECK
+#define SIM_CYCLES_PKA_POINT_CHECK 6000U
+#endif
+#ifndef SIM_FLASH_PROGRAM_US
+#define SIM_FLASH_PROGRAM_US       82U       /* Double-word program, typ. */
+#endif
+#ifndef SIM_FLASH_PAGE_ERASE_US
+#define SIM_FLASH_PAGE_ERASE_US    22000U    /* 2KB page erase, typ. */
+#endif
+
+/* Engine accounting ---------------------------------------------------*/
+typedef enum {
+    SIM_ENGINE_CRC = 0,
+    SIM_ENGINE_HASH,
+    SIM_ENGINE_CRYP,
+    SIM_ENGINE_PKA,
+    SIM_ENGINE_FLASH_PROGRAM,
+    SIM_ENGINE_FLASH_ERASE,
+    SIM_ENGINE_COUNT
+} SIM_EngineTypeDef;
+
+typedef struct {
+    uint64_t calls;        /* HAL calls serviced */
+    uint64_t bytes;        /* Bytes consumed or produced by the engine */
+    uint64_t flash_bytes;  /* Subset of bytes read directly from flash */
+    uint64_t cycles;       /* Modelled cycles spent in the engine */
+} SIM_EngineStats;
+
+/* Outcome of a simulated boot ------------------------------------------*/
+typedef enum {
+    SIM_BOOT_RUNNING = 0,
+    SIM_BOOT_JUMPED,       /* Reached the non-secure jump */
+    SIM_BOOT_RETURNED,     /* Secure main returned */
+    SIM_BOOT_FAULT,        /* Stray access (e.g. store to flash) */
+    SIM_BOOT_HANG,         /* Watchdog expired: lockdown or endless loop */
+    SIM_BOOT_POWER_LOSS    /* Power cut injected with SIM_Power_CutAt */
+} SIM_BootOutcomeTypeDef;
+
+typedef struct {
+    SIM_BootOutcomeTypeDef outcome;
+    uint32_t vtor_ns;      /* SCB_NS->VTOR at jump time */
+    uint32_t msp_ns;       /* Non-secure MSP at jump time */
+    uint32_t reset_ns;     /* Non-secure reset handler at jump time */
+    uintptr_t fault_addr;  /* Faulting address for SIM_BOOT_FAULT */
+    uint64_t cycles;       /* Modelled cycles at the end of the run */
+    uint64_t nanos;        /* Modelled boot latency */
+} SIM_BootResult;
+
+/* Platform API ---------------------------------------------------------*/
+
+/**
+  * @brief  Map the emulated address space
+  * @param  flash_path  Backing file for the flash image, or NULL for a
+  *                     volatile image. A new or short file is extended
+  *                     and filled with the erased pattern.
+  * @retval 0 on success, -1 on failure (errno describes the cause)
+  */
+int SIM_Platform_Init(const char *flash_path);
+
+/**
+  * @brief  Release all mappings created by SIM_Platform_Init
+  */
+void SIM_Platform_DeInit(void);
+
+/**
+  * @brief  Set the 96-bit device unique ID returned by HAL_GetUIDw0..2
+  */
+void SIM_Platform_SetUID(uint32_t w0, uint32_t w1, uint32_t w2);
+
+/**
+  * @brief  Erase the whole flash image to the erased pattern
+  */
+void SIM_Flash_MassErase(void);
+
+/**
+  * @brief  Load a file into flash at an absolute address (either alias)
+  * @retval Number of bytes loaded, or -1 on error
+  */
+long SIM_Flash_LoadFile(const char *path, uint32_t address);
+
+/**
+  * @brief  Translate an emulated flash address to its writable backing byte
+  * @retval Pointer into the backing store, NULL if outside flash
+  */
+uint8_t *SIM_Flash_Backing(uint32_t address, uint32_t length);
+
+/**
+  * @brief  Check whether a host pointer range lies inside emulated flash
+  */
+bool SIM_Flash_Contains(const void *ptr, size_t length);
+
+/**
+  * @brief  Advance the modelled clock and account work to an engine
+  * @param  engine  Engine the work belongs to
+  * @param  src     Source buffer (used to detect flash reads), may be NULL
+  * @param  bytes   Bytes processed
+  * @param  cycles  Engine cycles, excluding flash wait states
+  */
+void SIM_Account(SIM_EngineTypeDef engine, const void *src, size_t bytes, uint64_t cycles);
+
+/**
+  * @brief  Account work an engine performs in the background
+  * @note   Updates the engine counters without advancing the clock: the
+  *         caller schedules the completion with SIM_Event_Schedule
+  */
+void SIM_Account_Background(SIM_EngineTypeDef engine, size_t bytes, uint64_t cycles);
+
+/**
+  * @brief  Advance the modelled clock without engine attribution
+  * @note   Fires the pending event when the clock reaches it
+  */
+void SIM_Clock_Advance(uint64_t cycles);
+
+/**
+  * @brief  Schedule the completion interrupt of a background operation
+  * @param  at_cycle  Clock value at which the handler runs
+  * @param  handler   Interrupt handler; replaces the pending event of the
+  *                   same handler
+  * @note   Each handler is one event source (flash controller, PKA), up to
+  *         SIM_EVENT_SOURCES of them pending at once; the earliest fires
+  *         first. The handler runs from inside the clock advance that
+  *         reaches at_cycle, like an interrupt preempting the core.
+  */
+void SIM_Event_Schedule(uint64_t at_cycle, void (*handler)(void));
+
+/**
+  * @brief  Whether any event is scheduled
+  */
+bool SIM_Event_Pending(void);
+
+/**
+  * @brief  Mark a flash bank as busy with a program or erase operation
+  * @param  bank  0 or 1, -1 when the controller is idle
+  * @note   Reads of a busy bank through SIM_Account stall until the
+  *         pending event completes the operation (no read-while-write
+  *         within a bank)
+  */
+void SIM_Flash_SetBusyBank(int bank);
+
+/**
+  * @brief  Count a flash program or page erase operation that starts
+  * @retval true when the power fails during this operation: the caller
+  *         leaves it torn and calls SIM_Power_Fail
+  */
+bool SIM_Flash_OperationStart(void);
+
+/**
+  * @brief  Flash program and page erase operations started since reset
+  */
+uint64_t SIM_Flash_Operations(void);
+
+/**
+  * @brief  Cut the power during a given flash operation
+  * @param  op_index  Zero-based operation index, counted like
+  *                   SIM_Flash_Operations; SIM_POWER_CUT_NEVER disarms
+  * @note   Stays armed across SIM_Stats_Reset, so it can be set before
+  *         the run it applies to
+  */
+void SIM_Power_CutAt(uint64_t op_index);
+
+/**
+  * @brief  End the run as if the supply dropped (SIM_BOOT_POWER_LOSS)
+  * @note   Flash keeps whatever state it was left in
+  */
+void SIM_Power_Fail(void);
+
+/**
+  * @brief  Current modelled cycle count since reset
+  */
+uint64_t SIM_Clock_Cycles(void);
+
+/**
+  * @brief  Modelled time since reset in nanoseconds
+  * @note   Integrated per advance, so it stays exact across clock switches
+  */
+uint64_t SIM_Clock_Nanos(void);
+
+/**
+  * @brief  Set the modelled core clock (called by the RCC stand-in)
+  */
+void SIM_Clock_SetCoreHz(uint32_t hz);
+
+/**
+  * @brief  Modelled core clock in Hz
+  */
+uint32_t SIM_Clock_CoreHz(void);
+
+/**
+  * @brief  Convert microseconds to cycles at the current core clock
+  */
+uint64_t SIM_Clock_UsToCycles(uint32_t us);
+
+/**
+  * @brief  Read the counters of one engine
+  */
+const SIM_EngineStats *SIM_Stats_Get(SIM_EngineTypeDef engine);
+
+/**
+  * @brief  Printable engine name
+  */
+const char *SIM_Stats_Name(SIM_EngineTypeDef engine);
+
+/**
+  * @brief  Reset clock and counters (called at simulated power-on)
+  */
+void SIM_Stats_Reset(void);
+
+/**
+  * @brief  Route UART transmit to stdout (default) or discard it
+  */
+void SIM_Console_Enable(bool enable);
+
+/**
+  * @brief  Whether UART transmit is routed to stdout
+  */
+bool SIM_Console_Enabled(void);
+
+/**
+  * @brief  Connect USART1 to a host serial line
+  * @param  path  A tty, or "pty" to create a pty pair; its host end is
+  *               printed on stderr for the host tool to open
+  * @retval 0 on success, -1 on failure (errno describes the cause)
+  * @note   UART transmit then goes to the line instead of stdout
+  */
+int SIM_Uart_Attach(const char *path);
+
+/**
+  * @brief  Close the host serial line
+  */
+void SIM_Uart_Detach(void);
+
+/**
+  * @brief  Wait in real time, up to us microseconds, for the host to send
+  * @retval true when the host has sent bytes not delivered yet
+  */
+bool SIM_Uart_Wait(uint32_t us);
+
+/**
+  * @brief  Deliver the bytes the line carried since the last call, at the
+  *         programmed baud rate, to the receive DMA ring
+  */
+void SIM_Uart_Service(void);
+
+/**
+  * @brief  Run a secure entry point until it jumps to non-secure code,
+  *         returns, faults or exceeds the host watchdog
+  * @param  entry       Secure main renamed for the simulator build
+  * @param  timeout_s   Host watchdog in seconds (0 disables it)
+  * @param  result      Outcome of the run
+  */
+void SIM_Run(int (*entry)(void), unsigned int timeout_s, SIM_BootResult *result);
+
+/**
+  * @brief  Run one power cycle of the device in a child process
+  * @param  cycle  Work done between power-on and power-off, e.g. a SIM_Run
+  *                and its report
+  * @retval Value returned by cycle (0..255), -1 if it could not run or
+  *         crashed
+  * @note   Flash is shared with the child and keeps what it writes; RAM
+  *         (including the secure image's static state), peripheral
+  *         registers and the clock start over from the caller's state,
+  *         as after a reset. Needed after a SIM_Power_Fail, which leaves
+  *         RAM mid-operation.
+  */
+int SIM_Power_Cycle(int (*cycle)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_PLATFORM_H */
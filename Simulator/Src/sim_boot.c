@@ -0,0 +1,998 @@
+/**
+  * @file    sim_boot.c
+  * @brief   Host boot simulator entry point
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @details Loads the build artifacts into the emulated flash at their real
+  *          addresses, powers the secure image on and runs the unmodified
+  *          Secure/Core/Src/main.c sequence (Init, VerifyBootloaderCRC,
+  *          VerifyFirstValid, JumpTo) until the non-secure jump. The boot
+  *          manager entry points are wrapped at link time (--wrap) so each
+  *          stage reports its status, the bytes every engine consumed and
+  *          the modelled latency.
+  *
+  *          With -i an encrypted update image is first installed through
+  *          SECBOOT_BootManager_FlashFirmware in a separate secure run, as
+  *          an update agent would, and the install latency is reported
+  *          against the flash erase and program time it cannot go below.
+  *          -U installs it as an A/B update (SECBOOT_BootManager_UpdateFirmware)
+  *          into whichever slot is inactive; a boot that finds it staged
+  *          and not installed yet installs it the same way
+  *          (SECBOOT_BootManager_UpdateStaged), with the -x key in place of
+  *          the one the security block provisions; that boot installs
+  *          only an image newer than the active one. The install runs in its
+  *          own power cycle (SIM_Power_Cycle), so -p can cut the power
+  *          during any flash operation and the boot that follows starts from
+  *          the torn flash with reset RAM. -P sweeps the cut over the whole
+  *          install: after every cut the device must boot the old or the
+  *          new image, and a retried install must boot the new one.
+  *          With -R the A/B update arrives over the UART instead, from
+  *          Script/stm32_uart_sender.py on a pty pair, and is installed
+  *          while it is received (SECBOOT_Transfer_Install); -S stages it
+  *          in the update slot (SECBOOT_Transfer_Receive) and installs it
+  *          like -U. -L attaches the line to the boot itself instead: it
+  *          starts once the host is sending HELLO, and main.c installs the
+  *          update in its listen window (SECBOOT_Transfer_Listen), opened
+  *          for SIM_LISTEN_MS when SECBOOT_TRANSFER_LISTEN_MS leaves it shut.
+  *
+  *          Exit status: 0 when the boot reached the expected image (or,
+  *          after a power cut, the old or new one), 1 when the install
+  *          failed, the boot jumped elsewhere, faulted, returned or hung,
+  *          or a sweep found a failing cut, or the boot took longer than
+  *          the -m budget, 2 on usage or setup errors.
+  */
+
+#include "sim_platform.h"
+#include "secboot_config.h"
+#include "secboot_bootmanager.h"
+#include "secboot_diag.h"
+#include "secboot_crc.h"
+#include "secboot_transfer.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private defines ------------------------------------------------------*/
+#define SIM_MAX_STAGES        16U
+#define SIM_MAX_LOADS         8U
+#define SIM_MAX_DIAG_EVENTS   16U
+
+#define SIM_CYCLE_POWER_LOSS  100   /* install_cycle: cut short by -p */
+#define SIM_CYCLE_FAILED      101   /* install_cycle: faulted or hung */
+
+#define SIM_LISTEN_MS         50U   /* -L: listen window of a build without one */
+
+#define SIM_DEFAULT_BOOTLOADER  "../Artifacts/SecBoot_Bootloader.bin"
+#define SIM_DEFAULT_MAIN_APP    "../Artifacts/Secboot_MainApp.bin"
+#define SIM_DEFAULT_BACKUP      "../Artifacts/SecBoot_Backup.bin"
+
+/* Private types --------------------------------------------------------*/
+typedef struct {
+    const char *name;
+    uint32_t address;                       /* Image argument, 0 if none */
+    int status;                             /* Returned status, -1 if it never returned */
+    uint64_t cycles;
+    uint64_t nanos;
+    SIM_EngineStats engines[SIM_ENGINE_COUNT];
+} SIM_Stage;
+
+typedef struct {
+    const char *path;
+    uint32_t address;
+} SIM_Load;
+
+/* Flash content at power-on, reloaded before every sweep step */
+typedef struct {
+    const char *bootloader;
+    const char *main_app;
+    const char *backup;
+    SIM_Load loads[SIM_MAX_LOADS];
+    uint32_t load_count;
+    bool erase;
+    uint32_t uid[3];
+} SIM_Setup;
+
+/* Image a power cycle booted, from boot_cycle */
+typedef enum {
+    SIM_BOOTED_OLD = 0,
+    SIM_BOOTED_NEW,
+    SIM_BOOTED_OTHER
+} SIM_BootedTypeDef;
+
+typedef struct {
+    SECBOOT_Diag_EventType event;
+    uint8_t code;
+    uint32_t data;
+    int status;
+} SIM_DiagEvent;
+
+/* Private variables ----------------------------------------------------*/
+static SIM_Stage stages[SIM_MAX_STAGES];
+static uint32_t stage_count = 0;
+static SIM_DiagEvent diag_events[SIM_MAX_DIAG_EVENTS];
+static uint32_t diag_count = 0;
+
+static uint32_t install_dest = 0;           /* -i slot, 0 for an A/B update (-U) */
+static uint32_t install_size = 0;
+static int receive_status = -1;
+static bool receive_staged = false;         /* -S: stage, then install like -U */
+static uint32_t receive_target = 0;         /* -R: slot the update went to */
+static uint8_t install_key[FW_UPDATE_KEY_SIZE];
+static bool have_key = false;               /* -x given */
+static uint32_t listen_ms = 0;              /* -L: window in place of a shut one */
+static int install_status = -1;
+static uint64_t install_cut = SIM_POWER_CUT_NEVER;
+static unsigned int run_timeout_s = 5;
+static bool cycle_quiet = false;             /* Sweep: no per-run reports */
+static uint32_t old_vtor = 0;                /* boot_cycle: image before the update */
+static uint32_t new_vtor = 0;                /* boot_cycle: image of the update */
+
+/* Secure main from Secure/Core/Src/main.c, renamed by the Makefile */
+extern int SECBOOT_SecureMain(void);
+extern void SystemClock_Config(void);
+extern UART_HandleTypeDef huart1;
+
+/* Stage tracing --------------------------------------------------------*/
+
+static SIM_Stage *stage_open(const char *name, uint32_t address)
+{
+    SIM_Stage *st;
+
+    if (stage_count >= SIM_MAX_STAGES) {
+        return NULL;
+    }
+
+    st = &stages[stage_count++];
+    st->name = name;
+    st->address = address;
+    st->status = -1;
+    st->cycles = SIM_Clock_Cycles();
+    st->nanos = SIM_Clock_Nanos();
+    for (uint32_t e = 0; e < SIM_ENGINE_COUNT; e++) {
+        st->engines[e] = *SIM_Stats_Get((SIM_EngineTypeDef)e);
+    }
+    return st;
+}
+
+static void stage_close(SIM_Stage *st, int status)
+{
+    if (st == NULL) {
+        return;
+    }
+
+    st->status = status;
+    st->cycles = SIM_Clock_Cycles() - st->cycles;
+    st->nanos = SIM_Clock_Nanos() - st->nanos;
+    for (uint32_t e = 0; e < SIM_ENGINE_COUNT; e++) {
+        const SIM_EngineStats *now = SIM_Stats_Get((SIM_EngineTypeDef)e);
+        st->engines[e].calls = now->calls - st->engines[e].calls;
+        st->engines[e].bytes = now->bytes - st->engines[e].bytes;
+        st->engines[e].flash_bytes = now->flash_bytes - st->engines[e].flash_bytes;
+        st->engines[e].cycles = now->cycles - st->engines[e].cycles;
+    }
+}
+
+SECBOOT_BOOTMANAGER_StatusTypeDef __real_SECBOOT_BootManager_Init(void);
+SECBOOT_BOOTMANAGER_StatusTypeDef __real_SECBOOT_BootManager_VerifyBootloaderCRC(void);
+SECBOOT_BOOTMANAGER_StatusTypeDef __real_SECBOOT_BootManager_VerifyAppSignature(uint32_t image_address);
+SECBOOT_BOOTMANAGER_StatusTypeDef __real_SECBOOT_BootManager_JumpTo(uint32_t jump_to_address);
+SECBOOT_BOOTMANAGER_StatusTypeDef __real_SECBOOT_BootManager_UpdateStaged(const uint8_t *key);
+SECBOOT_BOOTMANAGER_StatusTypeDef __real_SECBOOT_BootManager_GetUpdateKey(uint8_t *key);
+SECBOOT_Transfer_StatusTypeDef __real_SECBOOT_Transfer_Listen(UART_HandleTypeDef *huart, uint32_t window,
+                                                              const uint8_t *key,
+                                                              SECBOOT_BOOTMANAGER_StatusTypeDef *pInstallStatus);
+uint32_t __real_SECBOOT_BootManager_VerifyFirstValid(const uint32_t *pImages, uint32_t count,
+                                                     SECBOOT_BOOTMANAGER_StatusTypeDef *pStatus);
+SECBOOT_Diag_TypeDef __real_SECBOOT_Diag_LogEvent(SECBOOT_Diag_EventType event, uint8_t code, uint32_t data);
+
+SECBOOT_BOOTMANAGER_StatusTypeDef __wrap_SECBOOT_BootManager_Init(void)
+{
+    SIM_Stage *st = stage_open("Init", 0U);
+    SECBOOT_BOOTMANAGER_StatusTypeDef status = __real_SECBOOT_BootManager_Init();
+    stage_close(st, status);
+    return status;
+}
+
+SECBOOT_BOOTMANAGER_StatusTypeDef __wrap_SECBOOT_BootManager_VerifyBootloaderCRC(void)
+{
+    SIM_Stage *st = stage_open("VerifyBootloaderCRC", BOOTLOADER_START_ADDR);
+    SECBOOT_BOOTMANAGER_StatusTypeDef status = __real_SECBOOT_BootManager_VerifyBootloaderCRC();
+    stage_close(st, status);
+    return status;
+}
+
+SECBOOT_BOOTMANAGER_StatusTypeDef __wrap_SECBOOT_BootManager_VerifyAppSignature(uint32_t image_address)
+{
+    SIM_Stage *st = stage_open("VerifyAppSignature", image_address);
+    SECBOOT_BOOTMANAGER_StatusTypeDef status = __real_SECBOOT_BootManager_VerifyAppSignature(image_address);
+    stage_close(st, status);
+    return status;
+}
+
+/* Status of the pipeline stage: that of the image chosen, or of the first
+   image when none passed */
+uint32_t __wrap_SECBOOT_BootManager_VerifyFirstValid(const uint32_t *pImages, uint32_t count,
+                                                     SECBOOT_BOOTMANAGER_StatusTypeDef *pStatus)
+{
+    SIM_Stage *st = stage_open("VerifyFirstValid", (count > 0U) ? pImages[0] : 0U);
+    uint32_t chosen = __real_SECBOOT_BootManager_VerifyFirstValid(pImages, count, pStatus);
+    stage_close(st, (chosen < count) ? pStatus[chosen] : (count > 0U) ? pStatus[0] : SECBOOT_BOOTMANAGER_ERROR);
+    if (st != NULL && chosen < count) {
+        st->address = pImages[chosen];
+    }
+    return chosen;
+}
+
+SECBOOT_BOOTMANAGER_StatusTypeDef __wrap_SECBOOT_BootManager_UpdateStaged(const uint8_t *key)
+{
+    SIM_Stage *st = stage_open("UpdateStaged", SECBOOT_UPDATE_SLOT_ADDR);
+    SECBOOT_BOOTMANAGER_StatusTypeDef status = __real_SECBOOT_BootManager_UpdateStaged(key);
+    stage_close(st, status);
+    return status;
+}
+
+SECBOOT_Transfer_StatusTypeDef __wrap_SECBOOT_Transfer_Listen(UART_HandleTypeDef *huart, uint32_t window,
+                                                              const uint8_t *key,
+                                                              SECBOOT_BOOTMANAGER_StatusTypeDef *pInstallStatus)
+{
+    SIM_Stage *st = stage_open("TransferListen", 0U);
+    SECBOOT_Transfer_StatusTypeDef status;
+
+    if (window == 0U) {
+        window = listen_ms;
+    }
+    status = __real_SECBOOT_Transfer_Listen(huart, window, key, pInstallStatus);
+    stage_close(st, status);
+    return status;
+}
+
+/* -x stands for the update key provisioned in the security block */
+SECBOOT_BOOTMANAGER_StatusTypeDef __wrap_SECBOOT_BootManager_GetUpdateKey(uint8_t *key)
+{
+    if (!have_key || key == NULL) {
+        return __real_SECBOOT_BootManager_GetUpdateKey(key);
+    }
+    memcpy(key, install_key, FW_UPDATE_KEY_SIZE);
+    return SECBOOT_BOOTMANAGER_OK;
+}
+
+SECBOOT_BOOTMANAGER_StatusTypeDef __wrap_SECBOOT_BootManager_JumpTo(uint32_t jump_to_address)
+{
+    /* Closed by main(): a successful jump never returns here */
+    SIM_Stage *st = stage_open("JumpTo", jump_to_address);
+    SECBOOT_BOOTMANAGER_StatusTypeDef status = __real_SECBOOT_BootManager_JumpTo(jump_to_address);
+    stage_close(st, status);
+    return status;
+}
+
+SECBOOT_Diag_TypeDef __wrap_SECBOOT_Diag_LogEvent(SECBOOT_Diag_EventType event, uint8_t code, uint32_t data)
+{
+    SECBOOT_Diag_TypeDef status = __real_SECBOOT_Diag_LogEvent(event, code, data);
+
+    if (diag_count < SIM_MAX_DIAG_EVENTS) {
+        diag_events[diag_count].event = event;
+        diag_events[diag_count].code = code;
+        diag_events[diag_count].data = data;
+        diag_events[diag_count].status = status;
+        diag_count++;
+    }
+    return status;
+}
+
+/* Reporting ------------------------------------------------------------*/
+
+static const char *outcome_name(SIM_BootOutcomeTypeDef outcome)
+{
+    switch (outcome) {
+        case SIM_BOOT_JUMPED:   return "JUMPED";
+        case SIM_BOOT_RETURNED: return "RETURNED";
+        case SIM_BOOT_FAULT:    return "FAULT";
+        case SIM_BOOT_HANG:     return "HANG";
+        case SIM_BOOT_POWER_LOSS: return "POWER_LOSS";
+        default:                return "RUNNING";
+    }
+}
+
+static const char *diag_event_name(SECBOOT_Diag_EventType event)
+{
+    switch (event) {
+        case SECBOOT_DIAG_CRC_FAIL:          return "CRC_FAIL";
+        case SECBOOT_DIAG_SIG_FAIL:          return "SIG_FAIL";
+        case SECBOOT_DIAG_SECURE_VIOLATION:  return "SECURE_VIOLATION";
+        case SECBOOT_DIAG_ROLLBACK_ATTEMPT:  return "ROLLBACK_ATTEMPT";
+        default:                             return "?";
+    }
+}
+
+static void print_engines(const SIM_EngineStats *engines)
+{
+    for (uint32_t e = 0; e < SIM_ENGINE_COUNT; e++) {
+        if (engines[e].calls == 0U) {
+            continue;
+        }
+        printf("      %-11s calls %-6" PRIu64 " bytes %-8" PRIu64 " from flash %-8" PRIu64
+               " cycles %" PRIu64 "\n",
+               SIM_Stats_Name((SIM_EngineTypeDef)e), engines[e].calls, engines[e].bytes,
+               engines[e].flash_bytes, engines[e].cycles);
+    }
+}
+
+static void print_report(const SIM_BootResult *res, uint32_t expect_vtor)
+{
+    uint64_t staged_nanos = 0;
+    SIM_EngineStats totals[SIM_ENGINE_COUNT];
+
+    printf("\n=== SecBoot host simulation ===\n");
+    printf("Outcome : %s", outcome_name(res->outcome));
+    if (res->outcome == SIM_BOOT_JUMPED) {
+        printf(" -> VTOR_NS 0x%08" PRIX32 " MSP_NS 0x%08" PRIX32 " Reset_Handler 0x%08" PRIX32 "%s",
+               res->vtor_ns, res->msp_ns, res->reset_ns,
+               (res->vtor_ns == expect_vtor) ? "" : "  (unexpected image)");
+    } else if (res->outcome == SIM_BOOT_FAULT) {
+        printf(" at host address %p", (void *)res->fault_addr);
+    }
+    printf("\n");
+    printf("Latency : %" PRIu64 ".%03" PRIu64 " ms (%" PRIu64 " cycles, core %" PRIu32 " Hz at exit)\n\n",
+           res->nanos / 1000000U, (res->nanos / 1000U) % 1000U, res->cycles, SIM_Clock_CoreHz());
+
+    printf("Stages:\n");
+    for (uint32_t i = 0; i < stage_count; i++) {
+        const SIM_Stage *st = &stages[i];
+
+        printf("  %-20s", st->name);
+        if (st->address != 0U) {
+            printf(" @0x%08" PRIX32, st->address);
+        } else {
+            printf("            ");
+        }
+        if (st->status >= 0) {
+            printf("  status %-2d", st->status);
+        } else {
+            printf("  (no return)");
+        }
+        printf("  %8" PRIu64 ".%03" PRIu64 " ms\n", st->nanos / 1000000U, (st->nanos / 1000U) % 1000U);
+        print_engines(st->engines);
+        staged_nanos += st->nanos;
+    }
+    if (res->nanos >= staged_nanos) {
+        uint64_t rest = res->nanos - staged_nanos;
+        printf("  %-20s             %-12s %8" PRIu64 ".%03" PRIu64 " ms\n", "(main.c, unstaged)", "",
+               rest / 1000000U, (rest / 1000U) % 1000U);
+    }
+
+    printf("\nEngine totals:\n");
+    for (uint32_t e = 0; e < SIM_ENGINE_COUNT; e++) {
+        totals[e] = *SIM_Stats_Get((SIM_EngineTypeDef)e);
+    }
+    print_engines(totals);
+
+    if (diag_count > 0U) {
+        printf("\nDiagnostic events:\n");
+        for (uint32_t i = 0; i < diag_count; i++) {
+            printf("  %-18s code %-3u data 0x%08" PRIX32 "  -> status %d\n",
+                   diag_event_name(diag_events[i].event), diag_events[i].code,
+                   diag_events[i].data, diag_events[i].status);
+        }
+    }
+}
+
+/* Update install -------------------------------------------------------*/
+
+/**
+  * @brief  Secure run that installs the image staged in the update slot
+  */
+static int install_entry(void)
+{
+    /* Same bring-up as main.c, which does not gate on the Init status */
+    HAL_Init();
+    SystemClock_Config();
+    (void)SECBOOT_BootManager_Init();
+
+    if (install_dest == 0U) {
+        install_status = SECBOOT_BootManager_UpdateFirmware(SECBOOT_UPDATE_SLOT_ADDR, install_size, install_key);
+    } else {
+        install_status = SECBOOT_BootManager_FlashFirmware(SECBOOT_UPDATE_SLOT_ADDR, install_dest, install_size,
+                                                           install_key, NULL);
+    }
+    return install_status;
+}
+
+/**
+  * @brief  Secure run that receives an update over the UART, into the
+  *         update slot (-S) or straight into the inactive slot (-R)
+  */
+static int receive_entry(void)
+{
+    SECBOOT_Slots_StateTypeDef slots;
+    SECBOOT_BOOTMANAGER_StatusTypeDef status = SECBOOT_BOOTMANAGER_ERROR;
+
+    /* Same bring-up as main.c; the CRC unit checks every frame */
+    HAL_Init();
+    SystemClock_Config();
+    (void)SECBOOT_BootManager_Init();
+    (void)SECBOOT_CRC_Init();
+
+    huart1.Instance = USART1;
+    huart1.Init.BaudRate = 9600;
+    huart1.Init.WordLength = UART_WORDLENGTH_8B;
+    huart1.Init.StopBits = UART_STOPBITS_1;
+    huart1.Init.Parity = UART_PARITY_NONE;
+    huart1.Init.Mode = UART_MODE_TX_RX;
+    (void)HAL_UART_Init(&huart1);
+
+    if (receive_staged) {
+        receive_status = SECBOOT_Transfer_Receive(&huart1, &install_size);
+        return receive_status;
+    }
+
+    if (SECBOOT_Slots_Read(&slots) == SECBOOT_SLOTS_OK) {
+        receive_target = SECBOOT_Slots_Inactive(&slots);
+    }
+    receive_status = SECBOOT_Transfer_Install(&huart1, install_key, &status);
+    install_status = status;
+    return receive_status;
+}
+
+static void print_receive(const SIM_BootResult *res)
+{
+    SIM_EngineStats totals[SIM_ENGINE_COUNT];
+    uint64_t flash_nanos;
+
+    for (uint32_t e = 0; e < SIM_ENGINE_COUNT; e++) {
+        totals[e] = *SIM_Stats_Get((SIM_EngineTypeDef)e);
+    }
+    flash_nanos = ((totals[SIM_ENGINE_FLASH_PROGRAM].cycles + totals[SIM_ENGINE_FLASH_ERASE].cycles) * 1000000000ULL) /
+                  SIM_Clock_CoreHz();
+
+    printf("\n=== UART transfer ===\n");
+    if (receive_staged) {
+        printf("Transfer_Receive -> 0x%08lX: %s, status %d, %" PRIu32 " bytes\n",
+               (unsigned long)SECBOOT_UPDATE_SLOT_ADDR, outcome_name(res->outcome), receive_status,
+               (receive_status == SECBOOT_TRANSFER_OK) ? install_size : 0U);
+    } else {
+        printf("Transfer_Install -> 0x%08lX (A/B): %s, status %d, install status %d\n",
+               (unsigned long)receive_target, outcome_name(res->outcome), receive_status, install_status);
+    }
+    printf("Latency : %" PRIu64 ".%03" PRIu64 " ms modelled, including the host's pauses\n",
+           res->nanos / 1000000U, (res->nanos / 1000U) % 1000U);
+    printf("Flash   : %" PRIu64 ".%03" PRIu64 " ms of erase and program, overlapped with reception\n",
+           flash_nanos / 1000000U, (flash_nanos / 1000U) % 1000U);
+    print_engines(totals);
+}
+
+static void print_install(const SIM_BootResult *res)
+{
+    SIM_EngineStats totals[SIM_ENGINE_COUNT];
+    uint64_t flash_cycles;
+    uint64_t flash_nanos;
+
+    for (uint32_t e = 0; e < SIM_ENGINE_COUNT; e++) {
+        totals[e] = *SIM_Stats_Get((SIM_EngineTypeDef)e);
+    }
+    flash_cycles = totals[SIM_ENGINE_FLASH_PROGRAM].cycles + totals[SIM_ENGINE_FLASH_ERASE].cycles;
+    flash_nanos = (flash_cycles * 1000000000ULL) / SIM_Clock_CoreHz();
+
+    printf("\n=== Update install ===\n");
+    if (install_dest == 0U) {
+        printf("UpdateFirmware (A/B)");
+    } else {
+        printf("FlashFirmware @0x%08" PRIX32, install_dest);
+    }
+    printf(" <- 0x%08" PRIX32 " (%" PRIu32 " bytes): %s", (uint32_t)SECBOOT_UPDATE_SLOT_ADDR, install_size,
+           outcome_name(res->outcome));
+    if (res->outcome == SIM_BOOT_POWER_LOSS) {
+        printf(" during flash operation %" PRIu64 "\n", install_cut);
+    } else {
+        printf(", status %d, %" PRIu64 " flash operations\n", install_status, SIM_Flash_Operations());
+    }
+    printf("Latency : %" PRIu64 ".%03" PRIu64 " ms (%" PRIu64 " cycles)\n",
+           res->nanos / 1000000U, (res->nanos / 1000U) % 1000U, res->cycles);
+    printf("Flash   : %" PRIu64 ".%03" PRIu64 " ms of erase and program\n",
+           flash_nanos / 1000000U, (flash_nanos / 1000U) % 1000U);
+    print_engines(totals);
+}
+
+/**
+  * @brief  Power cycle that installs the staged update, cut short by -p
+  * @retval Install status, SIM_CYCLE_POWER_LOSS or SIM_CYCLE_FAILED
+  */
+static int install_cycle(void)
+{
+    SIM_BootResult res;
+
+    SIM_Stats_Reset();
+    SIM_Power_CutAt(install_cut);
+    SIM_Run(install_entry, run_timeout_s, &res);
+    SIM_Power_CutAt(SIM_POWER_CUT_NEVER);
+
+    if (!cycle_quiet) {
+        print_install(&res);
+    }
+    if (res.outcome == SIM_BOOT_POWER_LOSS) {
+        return SIM_CYCLE_POWER_LOSS;
+    }
+    return (res.outcome == SIM_BOOT_RETURNED) ? install_status : SIM_CYCLE_FAILED;
+}
+
+/**
+  * @brief  Power cycle that boots and reports which image it reached
+  * @retval SIM_BootedTypeDef
+  */
+static int boot_cycle(void)
+{
+    SIM_BootResult res;
+
+    SIM_Stats_Reset();
+    SIM_Run(SECBOOT_SecureMain, run_timeout_s, &res);
+
+    if (res.outcome == SIM_BOOT_JUMPED && res.vtor_ns == old_vtor) {
+        return SIM_BOOTED_OLD;
+    }
+    if (res.outcome == SIM_BOOT_JUMPED && res.vtor_ns == new_vtor) {
+        return SIM_BOOTED_NEW;
+    }
+    return SIM_BOOTED_OTHER;
+}
+
+static bool parse_key(const char *s, uint8_t *key)
+{
+    if (strlen(s) != 2U * FW_UPDATE_KEY_SIZE) {
+        return false;
+    }
+    for (size_t i = 0; i < FW_UPDATE_KEY_SIZE; i++) {
+        unsigned int byte;
+
+        if (sscanf(&s[2U * i], "%2x", &byte) != 1) {
+            return false;
+        }
+        key[i] = (uint8_t)byte;
+    }
+    return true;
+}
+
+/* Command line ---------------------------------------------------------*/
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -b FILE        Secure bootloader image, loaded at 0x%08lX\n"
+            "                 (default %s)\n"
+            "  -a FILE        Main application image, loaded at 0x%08lX\n"
+            "                 (default %s)\n"
+            "  -k FILE        Backup image, loaded at 0x%08lX\n"
+            "                 (default %s)\n"
+            "  -l FILE@ADDR   Load an additional file at ADDR (repeatable)\n"
+            "  -i FILE@ADDR   Stage an encrypted update image in the update slot and\n"
+            "                 install it to the slot at ADDR before booting\n"
+            "  -U FILE        Same, as an A/B update into the inactive slot; the boot\n"
+            "                 is then expected to reach the update\n"
+            "  -R PORT        Receive the A/B update over the UART instead of -U and\n"
+            "                 install it while it arrives: PORT is a tty, or \"pty\"\n"
+            "                 for a new pty pair (host end on stderr)\n"
+            "  -S PORT        Same, but stage it in the update slot, then install it\n"
+            "  -L PORT        Attach the UART to the boot itself, once the host sends:\n"
+            "                 main.c installs what a host sends in its listen window\n"
+            "                 (SECBOOT_TRANSFER_LISTEN_MS, 50 ms if 0); -e is the image\n"
+            "                 it installs\n"
+            "  -x KEY         AES-128 update key for -i/-U/-R/-S (32 hex digits), also\n"
+            "                 used by the boot for staged updates\n"
+            "  -p N           Cut the power during flash operation N of the install\n"
+            "  -P STEP        Sweep the power cut over every STEP-th flash operation\n"
+            "                 of the install; -e is the image before the update\n"
+            "  -f FILE        Keep the flash image in FILE across runs (default: volatile)\n"
+            "  -n             Do not mass erase before loading (use with -f)\n"
+            "  -u W0:W1:W2    Device unique ID (hex), default %08lX:%08lX:%08lX\n"
+            "  -e ADDR        Expected non-secure vector table (default 0x%08lX)\n"
+            "  -m MS          Fail when the boot's modelled latency exceeds MS\n"
+            "  -t SECONDS     Host watchdog for lockdown loops (default 5)\n"
+            "  -q             Discard the bootloader's UART output\n",
+            prog,
+            (unsigned long)SECBOOT_BOOTLOADER_ADDR, SIM_DEFAULT_BOOTLOADER,
+            (unsigned long)SECBOOT_MAIN_APP_IMAGE_ADDR, SIM_DEFAULT_MAIN_APP,
+            (unsigned long)SECBOOT_BACKUP_IMAGE_ADDR, SIM_DEFAULT_BACKUP,
+            (unsigned long)SIM_DEFAULT_UID_W0, (unsigned long)SIM_DEFAULT_UID_W1,
+            (unsigned long)SIM_DEFAULT_UID_W2,
+            (unsigned long)(SECBOOT_MAIN_APP_IMAGE_ADDR + SECBOOT_FW_HEADER_SIZE));
+}
+
+static bool parse_u32(const char *s, uint32_t *out)
+{
+    char *end = NULL;
+    unsigned long v;
+
+    errno = 0;
+    v = strtoul(s, &end, 0);
+    if (errno != 0 || end == s || *end != '\0' || v > 0xFFFFFFFFUL) {
+        return false;
+    }
+    *out = (uint32_t)v;
+    return true;
+}
+
+static bool load_image(const char *path, uint32_t address)
+{
+    long n = SIM_Flash_LoadFile(path, address);
+
+    if (n < 0) {
+        fprintf(stderr, "sim: cannot load %s at 0x%08" PRIX32 ": %s\n", path, address, strerror(errno));
+        return false;
+    }
+    if (!cycle_quiet) {
+        printf("sim: loaded %-40s %7ld bytes at 0x%08" PRIX32 "\n", path, n, address);
+    }
+    return true;
+}
+
+
+static bool setup_flash(const SIM_Setup *setup)
+{
+    if (setup->erase) {
+        SIM_Flash_MassErase();
+    }
+
+    /* An empty path skips an image, e.g. -a "" to boot without a main app */
+    if ((setup->bootloader[0] != '\0' && !load_image(setup->bootloader, SECBOOT_BOOTLOADER_ADDR)) ||
+        (setup->main_app[0] != '\0' && !load_image(setup->main_app, SECBOOT_MAIN_APP_IMAGE_ADDR)) ||
+        (setup->backup[0] != '\0' && !load_image(setup->backup, SECBOOT_BACKUP_IMAGE_ADDR))) {
+        return false;
+    }
+    for (uint32_t i = 0; i < setup->load_count; i++) {
+        if (!load_image(setup->loads[i].path, setup->loads[i].address)) {
+            return false;
+        }
+    }
+
+    SIM_Platform_SetUID(setup->uid[0], setup->uid[1], setup->uid[2]);
+    return true;
+}
+
+/**
+  * @brief  Take the vector table of the update from the header at address
+  */
+static void update_vtor(uint32_t address)
+{
+    const uint8_t *entry = SIM_Flash_Backing(address + offsetof(FirmwareHeader_TypeDef, entryPoint), sizeof(uint32_t));
+
+    memcpy(&new_vtor, entry, sizeof(new_vtor));
+}
+
+/**
+  * @brief  Copy an update image to the update slot
+  */
+static bool stage_update(const char *path)
+{
+    long n = SIM_Flash_LoadFile(path, SECBOOT_UPDATE_SLOT_ADDR);
+
+    if (n < 0 || n > SECBOOT_UPDATE_SLOT_SIZE) {
+        fprintf(stderr, "sim: cannot stage %s in the update slot\n", path);
+        return false;
+    }
+    if (!cycle_quiet) {
+        printf("sim: staged %-40s %7ld bytes at 0x%08lX\n", path, n, (unsigned long)SECBOOT_UPDATE_SLOT_ADDR);
+    }
+    install_size = (uint32_t)n;
+    update_vtor(SECBOOT_UPDATE_SLOT_ADDR);
+    return true;
+}
+
+/**
+  * @brief  Cut the power during every step-th flash operation of the install
+  * @retval 0 when every cut recovered, 1 otherwise, 2 on setup errors
+  * @note   For each cut: install until the cut, boot (old or new image
+  *         expected), install again without cut, boot (new image expected).
+  *         The boot after the cut finds the update still staged and
+  *         installs it itself (SECBOOT_BootManager_UpdateStaged); when it
+  *         reaches the new image, that was the retried install.
+  *         The sweep ends at the first cut the install finishes before.
+  */
+static int power_cut_sweep(const SIM_Setup *setup, const char *path, uint32_t step)
+{
+    uint32_t cuts = 0;
+    uint32_t failures = 0;
+    uint32_t booted[SIM_BOOTED_OTHER + 1] = {0};
+    uint64_t cut;
+
+    cycle_quiet = true;
+    SIM_Console_Enable(false);
+
+    for (cut = 0; ; cut += step) {
+        int rc;
+
+        if (!setup_flash(setup)) {
+            return 2;
+        }
+
+        /* Before staging: a staged update is installed by the boot */
+        if (cut == 0U && SIM_Power_Cycle(boot_cycle) != SIM_BOOTED_OLD) {
+            fprintf(stderr, "sim: the image at -e does not boot before the update\n");
+            return 2;
+        }
+        if (!stage_update(path)) {
+            return 2;
+        }
+
+        install_cut = cut;
+        rc = SIM_Power_Cycle(install_cycle);
+        install_cut = SIM_POWER_CUT_NEVER;
+        if (rc != SIM_CYCLE_POWER_LOSS) {
+            if (rc != SECBOOT_BOOTMANAGER_OK) {
+                printf("  uninterrupted install failed: %d\n", rc);
+                failures++;
+            }
+            break;
+        }
+        cuts++;
+
+        rc = SIM_Power_Cycle(boot_cycle);
+        booted[(rc >= 0 && rc <= SIM_BOOTED_OTHER) ? rc : SIM_BOOTED_OTHER]++;
+        if (rc != SIM_BOOTED_OLD && rc != SIM_BOOTED_NEW) {
+            printf("  cut at flash operation %-6" PRIu64 " boot reached neither image\n", cut);
+            failures++;
+            continue;
+        }
+        if (rc == SIM_BOOTED_NEW) {
+            continue;
+        }
+
+        rc = SIM_Power_Cycle(install_cycle);
+        if (rc != SECBOOT_BOOTMANAGER_OK) {
+            printf("  cut at flash operation %-6" PRIu64 " retried install failed: %d\n", cut, rc);
+            failures++;
+            continue;
+        }
+        if (SIM_Power_Cycle(boot_cycle) != SIM_BOOTED_NEW) {
+            printf("  cut at flash operation %-6" PRIu64 " retried install does not boot\n", cut);
+            failures++;
+        }
+    }
+
+    printf("\n=== Power-cut sweep ===\n");
+    printf("%" PRIu32 " cuts, one every %" PRIu32 " flash operations; the install completes before operation %" PRIu64 "\n",
+           cuts, step, cut);
+    printf("After the cut: %" PRIu32 " booted the old image, %" PRIu32 " the new one, %" PRIu32 " neither\n",
+           booted[SIM_BOOTED_OLD], booted[SIM_BOOTED_NEW], booted[SIM_BOOTED_OTHER]);
+    printf("Failures: %" PRIu32 "\n", failures);
+    return (failures == 0U) ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    SIM_Setup setup = {
+        .bootloader = SIM_DEFAULT_BOOTLOADER,
+        .main_app = SIM_DEFAULT_MAIN_APP,
+        .backup = SIM_DEFAULT_BACKUP,
+        .load_count = 0,
+        .erase = true,
+        .uid = { SIM_DEFAULT_UID_W0, SIM_DEFAULT_UID_W1, SIM_DEFAULT_UID_W2 },
+    };
+    const char *flash_file = NULL;
+    const char *install_file = NULL;
+    const char *receive_port = NULL;
+    const char *boot_port = NULL;
+    bool have_expect = false;
+    bool ab_update = false;
+    uint32_t sweep_step = 0;
+    uint32_t cut = 0;
+    uint32_t expect_vtor = SECBOOT_MAIN_APP_IMAGE_ADDR + SECBOOT_FW_HEADER_SIZE;
+    bool quiet = false;
+    uint32_t budget_ms = 0;
+    SIM_BootResult res;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:a:k:l:i:U:R:S:L:x:p:P:f:nu:e:m:t:qh")) != -1) {
+        switch (opt) {
+            case 'b': setup.bootloader = optarg; break;
+            case 'a': setup.main_app = optarg; break;
+            case 'k': setup.backup = optarg; break;
+            case 'f': flash_file = optarg; break;
+            case 'n': setup.erase = false; break;
+            case 'q': quiet = true; break;
+            case 'l': {
+                char *at = strrchr(optarg, '@');
+                if (at == NULL || setup.load_count >= SIM_MAX_LOADS ||
+                    !parse_u32(at + 1, &setup.loads[setup.load_count].address)) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                *at = '\0';
+                setup.loads[setup.load_count++].path = optarg;
+                break;
+            }
+            case 'i': {
+                char *at = strrchr(optarg, '@');
+                if (at == NULL || !parse_u32(at + 1, &install_dest) || install_dest == 0U) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                *at = '\0';
+                install_file = optarg;
+                break;
+            }
+            case 'U':
+                install_file = optarg;
+                ab_update = true;
+                break;
+            case 'R':
+            case 'S':
+                receive_port = optarg;
+                receive_staged = (opt == 'S');
+                ab_update = true;
+                break;
+            case 'L':
+                boot_port = optarg;
+                listen_ms = SIM_LISTEN_MS;
+                break;
+            case 'x':
+                if (!parse_key(optarg, install_key)) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                have_key = true;
+                break;
+            case 'p':
+                if (!parse_u32(optarg, &cut)) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                install_cut = cut;
+                break;
+            case 'P':
+                if (!parse_u32(optarg, &sweep_step) || sweep_step == 0U) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'u':
+                if (sscanf(optarg, "%" SCNx32 ":%" SCNx32 ":%" SCNx32,
+                           &setup.uid[0], &setup.uid[1], &setup.uid[2]) != 3) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'e':
+                if (!parse_u32(optarg, &expect_vtor)) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                have_expect = true;
+                break;
+            case 'm':
+                if (!parse_u32(optarg, &budget_ms)) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 't':
+                run_timeout_s = (unsigned int)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+
+    if (ab_update) {
+        install_dest = 0U;
+    }
+    if (receive_port != NULL && (install_file != NULL || sweep_step != 0U)) {
+        fprintf(stderr, "sim: -R and -S receive the update: no -i, -U or -P\n");
+        return 2;
+    }
+    if (boot_port != NULL && (receive_port != NULL || sweep_step != 0U)) {
+        fprintf(stderr, "sim: -L attaches the UART to the boot: no -R, -S or -P\n");
+        return 2;
+    }
+    if ((install_file != NULL || receive_port != NULL) && !have_key) {
+        fprintf(stderr, "sim: -i, -U, -R and -S need the update key (-x)\n");
+        return 2;
+    }
+    if ((install_cut != SIM_POWER_CUT_NEVER || sweep_step != 0U) && install_file == NULL && !receive_staged) {
+        fprintf(stderr, "sim: -p and -P cut the power during an install (-i, -U or -S)\n");
+        return 2;
+    }
+
+    if (SIM_Platform_Init(flash_file) != 0) {
+        fprintf(stderr, "sim: cannot map the emulated address space: %s\n", strerror(errno));
+        return 2;
+    }
+
+    old_vtor = expect_vtor;
+    if (sweep_step != 0U) {
+        int rc = power_cut_sweep(&setup, install_file, sweep_step);
+        SIM_Platform_DeInit();
+        return rc;
+    }
+
+    if (!setup_flash(&setup)) {
+        SIM_Platform_DeInit();
+        return 2;
+    }
+    SIM_Console_Enable(!quiet);
+
+    if (receive_port != NULL) {
+        if (SIM_Uart_Attach(receive_port) != 0) {
+            fprintf(stderr, "sim: cannot open the UART line %s: %s\n", receive_port, strerror(errno));
+            SIM_Platform_DeInit();
+            return 2;
+        }
+
+        /* The host sets the pace: no watchdog, the transfer has its own idle timeout */
+        SIM_Stats_Reset();
+        SIM_Run(receive_entry, 0U, &res);
+        SIM_Uart_Detach();
+        print_receive(&res);
+        if (res.outcome != SIM_BOOT_RETURNED || receive_status != SECBOOT_TRANSFER_OK) {
+            SIM_Platform_DeInit();
+            return 1;
+        }
+        update_vtor(receive_staged ? SECBOOT_UPDATE_SLOT_ADDR : receive_target);
+        if (!receive_staged && !have_expect) {
+            expect_vtor = new_vtor;
+        }
+    }
+
+    if (install_file != NULL || receive_staged) {
+        if (install_file != NULL && !stage_update(install_file)) {
+            SIM_Platform_DeInit();
+            return 2;
+        }
+
+        /* An A/B update is expected to boot, unless -e says otherwise */
+        if (ab_update && !have_expect) {
+            expect_vtor = new_vtor;
+        }
+
+        install_status = SIM_Power_Cycle(install_cycle);
+    }
+
+    /* Power on once the host is sending, as when it is started before the reset */
+    if (boot_port != NULL) {
+        if (SIM_Uart_Attach(boot_port) != 0) {
+            fprintf(stderr, "sim: cannot open the UART line %s: %s\n", boot_port, strerror(errno));
+            SIM_Platform_DeInit();
+            return 2;
+        }
+        fprintf(stderr, "sim: waiting for the host\n");
+        while (!SIM_Uart_Wait(1000000U)) {
+        }
+    }
+
+    SIM_Stats_Reset();
+    fflush(stdout);
+
+    /* With -L the host sets the pace, as with -R */
+    SIM_Run(SECBOOT_SecureMain, (boot_port != NULL) ? 0U : run_timeout_s, &res);
+    if (boot_port != NULL) {
+        SIM_Uart_Detach();
+    }
+
+    /* JumpTo never returns on success: charge it up to the jump */
+    if (stage_count > 0U && stages[stage_count - 1U].status == -1) {
+        stage_close(&stages[stage_count - 1U], -1);
+    }
+
+    /* After a power cut either side of the update is a valid outcome */
+    if (install_status == SIM_CYCLE_POWER_LOSS && res.outcome == SIM_BOOT_JUMPED &&
+        (res.vtor_ns == old_vtor || res.vtor_ns == new_vtor)) {
+        expect_vtor = res.vtor_ns;
+    }
+
+    print_report(&res, expect_vtor);
+    SIM_Platform_DeInit();
+
+    if (budget_ms != 0U && res.nanos > (uint64_t)budget_ms * 1000000U) {
+        printf("Budget  : exceeded, %" PRIu32 " ms\n", budget_ms);
+        return 1;
+    }
+    if ((install_file != NULL || receive_port != NULL) && install_status != SECBOOT_BOOTMANAGER_OK &&
+        install_status != SIM_CYCLE_POWER_LOSS) {
+        return 1;
+    }
+    return (res.outcome == SIM_BOOT_JUMPED && res.vtor_ns == expect_vtor) ? 0 : 1;
+}
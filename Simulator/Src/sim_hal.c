@@ -0,0 +1,191 @@
+/**
+  * @file    sim_hal.c
+  * @brief   Host stand-ins for the HAL core, clock, GPIO and TrustZone
+  *          controller functions used by the secure boot sources
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    These peripherals do not influence the verification result, so
+  *          they are modelled only as far as the boot flow observes them:
+  *          the tick follows the modelled cycle clock, GPIO writes land in
+  *          the ODR of the emulated register window (LED state can be read
+  *          back after a run). The UART lives in sim_hal_uart.c.
+  */
+
+#include "stm32l5xx_hal.h"
+#include "sim_platform.h"
+
+/* Exported variables ---------------------------------------------------*/
+uint32_t SystemCoreClock = 4000000U;
+
+/* HAL core -------------------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_Init(void)
+{
+    SystemCoreClock = 4000000U;
+    SIM_Clock_SetCoreHz(SystemCoreClock);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DeInit(void)
+{
+    return HAL_OK;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(SIM_Clock_Cycles() / (SIM_Clock_CoreHz() / 1000U));
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    SIM_Clock_Advance(SIM_Clock_UsToCycles(Delay * 1000U));
+}
+
+uint32_t HAL_GetUIDw0(void)
+{
+    return READ_REG(*((uint32_t *)UID_BASE));
+}
+
+uint32_t HAL_GetUIDw1(void)
+{
+    return READ_REG(*((uint32_t *)(UID_BASE + 4U)));
+}
+
+uint32_t HAL_GetUIDw2(void)
+{
+    return READ_REG(*((uint32_t *)(UID_BASE + 8U)));
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    (void)IRQn;
+    (void)PreemptPriority;
+    (void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+/* Power and clocks -----------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_PWREx_ControlVoltageScaling(uint32_t VoltageScaling)
+{
+    (void)VoltageScaling;
+    return HAL_OK;
+}
+
+void HAL_PWREx_EnableVddIO2(void)
+{
+}
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct)
+{
+    return (RCC_OscInitStruct == NULL) ? HAL_ERROR : HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency)
+{
+    (void)FLatency;
+
+    if (RCC_ClkInitStruct == NULL) {
+        return HAL_ERROR;
+    }
+
+    if ((RCC_ClkInitStruct->ClockType & RCC_CLOCKTYPE_SYSCLK) != 0U) {
+        switch (RCC_ClkInitStruct->SYSCLKSource) {
+            case RCC_SYSCLKSOURCE_HSI:
+                SystemCoreClock = 16000000U;
+                break;
+            case RCC_SYSCLKSOURCE_MSI:
+                SystemCoreClock = 4000000U;
+                break;
+            default:
+                /* PLL and HSE are not used by the bootloader */
+                return HAL_ERROR;
+        }
+    }
+
+    SIM_Clock_SetCoreHz(SystemCoreClock);
+    return HAL_OK;
+}
+
+uint32_t HAL_RCC_GetHCLKFreq(void)
+{
+    return SystemCoreClock;
+}
+
+/* Cache, OTFDEC, RNG ---------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_ICACHE_ConfigAssociativityMode(uint32_t AssociativityMode)
+{
+    (void)AssociativityMode;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ICACHE_Enable(void)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_OTFDEC_Init(OTFDEC_HandleTypeDef *hotfdec)
+{
+    if (hotfdec == NULL) {
+        return HAL_ERROR;
+    }
+    hotfdec->State = HAL_OTFDEC_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RNG_Init(RNG_HandleTypeDef *hrng)
+{
+    if (hrng == NULL) {
+        return HAL_ERROR;
+    }
+    hrng->State = HAL_RNG_STATE_READY;
+    return HAL_OK;
+}
+
+/* GPIO -----------------------------------------------------------------*/
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    (void)GPIOx;
+    (void)GPIO_Init;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState != GPIO_PIN_RESET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return ((GPIOx->IDR & GPIO_Pin) != 0U) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+/* TrustZone controller -------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_GTZC_TZSC_ConfigPeriphAttributes(uint32_t PeriphId, uint32_t PeriphAttributes)
+{
+    (void)PeriphId;
+    (void)PeriphAttributes;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_GTZC_MPCBB_ConfigMem(uint32_t MemBaseAddress, const MPCBB_ConfigTypeDef *pMPCBB_desc)
+{
+    (void)MemBaseAddress;
+    return (pMPCBB_desc == NULL) ? HAL_ERROR : HAL_OK;
+}
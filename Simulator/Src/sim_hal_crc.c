@@ -0,0 +1,291 @@
+/**
+  * @file    sim_hal_crc.c
+  * @brief   Host stand-in for the STM32L5 CRC calculation unit
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    Bit-exact with the peripheral for 32-bit polynomials: the
+  *          register shifts MSB-first, input inversion is applied per
+  *          written unit and output inversion reverses the full register.
+  *          Byte format data is fed in DR-sized chunks the way
+  *          HAL_CRC_Calculate packs it (four bytes per 32-bit write, then a
+  *          16-bit and an 8-bit tail write) so the cycle figures match the
+  *          HAL driver, not an idealised engine.
+  *          Memory-to-memory DMA into DR, the CRC unit's feed, is modelled
+  *          here as well: the words reach the register at once, and the
+  *          channel stays busy for their CRC time, in the background, until
+  *          HAL_DMA_PollForTransfer waits it out.
+  */
+
+#include "stm32l5xx_hal.h"
+#include "sim_platform.h"
+
+#include <string.h>
+
+/* Private variables ----------------------------------------------------*/
+static uint32_t crc_table[256];
+static uint32_t crc_table_poly;
+static bool crc_table_valid = false;
+static CRC_HandleTypeDef *crc_handle = NULL;  /* Last initialised: owner of DR */
+static DMA_HandleTypeDef *dma_crc = NULL;     /* Channel feeding DR */
+static uint64_t dma_crc_done = 0;             /* Cycle its last item lands */
+
+/* Private functions ----------------------------------------------------*/
+
+static uint32_t reflect(uint32_t value, uint32_t width)
+{
+    uint32_t out = 0U;
+
+    for (uint32_t i = 0U; i < width; i++) {
+        out = (out << 1) | ((value >> i) & 1U);
+    }
+    return out;
+}
+
+static void build_table(uint32_t poly)
+{
+    for (uint32_t i = 0U; i < 256U; i++) {
+        uint32_t c = i << 24;
+
+        for (uint32_t bit = 0U; bit < 8U; bit++) {
+            c = ((c & 0x80000000U) != 0U) ? ((c << 1) ^ poly) : (c << 1);
+        }
+        crc_table[i] = c;
+    }
+    crc_table_poly = poly;
+    crc_table_valid = true;
+}
+
+/**
+  * @brief  Feed one DR write of 'width' bits into the CRC register
+  */
+static void crc_write(CRC_HandleTypeDef *hcrc, uint32_t data, uint32_t width)
+{
+    uint32_t inv = hcrc->Init.InputDataInversionMode;
+    uint32_t crc = hcrc->Instance->DR;
+
+    /* REV_IN reverses bits within each byte, halfword or word of the write */
+    if (inv == CRC_INPUTDATA_INVERSION_BYTE) {
+        uint32_t out = 0U;
+        for (uint32_t b = 0U; b < width; b += 8U) {
+            out |= reflect((data >> b) & 0xFFU, 8U) << b;
+        }
+        data = out;
+    } else if (inv == CRC_INPUTDATA_INVERSION_HALFWORD && width >= 16U) {
+        uint32_t out = 0U;
+        for (uint32_t h = 0U; h < width; h += 16U) {
+            out |= reflect((data >> h) & 0xFFFFU, 16U) << h;
+        }
+        data = out;
+    } else if (inv == CRC_INPUTDATA_INVERSION_WORD && width == 32U) {
+        data = reflect(data, 32U);
+    } else if (inv != CRC_INPUTDATA_INVERSION_NONE) {
+        /* Inversion wider than the write: reversed as a single unit */
+        data = reflect(data, width);
+    }
+
+    for (int shift = (int)width - 8; shift >= 0; shift -= 8) {
+        crc = (crc << 8) ^ crc_table[((crc >> 24) ^ (data >> shift)) & 0xFFU];
+    }
+
+    hcrc->Instance->DR = crc;
+}
+
+static uint32_t crc_read(CRC_HandleTypeDef *hcrc)
+{
+    uint32_t crc = hcrc->Instance->DR;
+
+    if (hcrc->Init.OutputDataInversionMode == CRC_OUTPUTDATA_INVERSION_ENABLE) {
+        crc = reflect(crc, 32U);
+    }
+    return crc;
+}
+
+static uint32_t crc_feed(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+    uint32_t i;
+
+    switch (hcrc->InputDataFormat) {
+        case CRC_INPUTDATA_FORMAT_WORDS:
+            for (i = 0U; i < BufferLength; i++) {
+                crc_write(hcrc, pBuffer[i], 32U);
+            }
+            SIM_Account(SIM_ENGINE_CRC, pBuffer, (size_t)BufferLength * 4U,
+                        (uint64_t)BufferLength * SIM_CYCLES_CRC_WORD);
+            break;
+
+        case CRC_INPUTDATA_FORMAT_HALFWORDS: {
+            const uint16_t *p = (const uint16_t *)(void *)pBuffer;
+            for (i = 0U; i < BufferLength; i++) {
+                crc_write(hcrc, p[i], 16U);
+            }
+            SIM_Account(SIM_ENGINE_CRC, pBuffer, (size_t)BufferLength * 2U,
+                        (uint64_t)BufferLength * SIM_CYCLES_CRC_WORD);
+            break;
+        }
+
+        case CRC_INPUTDATA_FORMAT_BYTES: {
+            const uint8_t *p = (const uint8_t *)pBuffer;
+            for (i = 0U; i + 4U <= BufferLength; i += 4U) {
+                crc_write(hcrc, ((uint32_t)p[i] << 24) | ((uint32_t)p[i + 1U] << 16) |
+                                ((uint32_t)p[i + 2U] << 8) | (uint32_t)p[i + 3U], 32U);
+            }
+            if ((BufferLength & 2U) != 0U) {
+                crc_write(hcrc, ((uint32_t)p[i] << 8) | (uint32_t)p[i + 1U], 16U);
+                i += 2U;
+            }
+            if ((BufferLength & 1U) != 0U) {
+                crc_write(hcrc, p[i], 8U);
+            }
+            SIM_Account(SIM_ENGINE_CRC, pBuffer, BufferLength,
+                        (uint64_t)BufferLength * SIM_CYCLES_CRC_BYTE_PACK +
+                        (uint64_t)((BufferLength + 3U) / 4U) * SIM_CYCLES_CRC_WORD);
+            break;
+        }
+
+        default:
+            hcrc->State = HAL_CRC_STATE_ERROR;
+            break;
+    }
+
+    return crc_read(hcrc);
+}
+
+/* Exported functions ---------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef *hcrc)
+{
+    uint32_t poly;
+
+    if (hcrc == NULL || hcrc->Instance == NULL) {
+        return HAL_ERROR;
+    }
+
+    if (hcrc->Init.DefaultPolynomialUse == DEFAULT_POLYNOMIAL_ENABLE) {
+        poly = DEFAULT_CRC32_POLY;
+    } else if (hcrc->Init.CRCLength == CRC_POLYLENGTH_32B) {
+        poly = hcrc->Init.GeneratingPolynomial;
+    } else {
+        /* 7/8/16-bit polynomials are not used by the bootloader */
+        return HAL_ERROR;
+    }
+
+    if (hcrc->InputDataFormat == CRC_INPUTDATA_FORMAT_UNDEFINED) {
+        return HAL_ERROR;
+    }
+
+    if (!crc_table_valid || crc_table_poly != poly) {
+        build_table(poly);
+    }
+
+    hcrc->Instance->INIT = (hcrc->Init.DefaultInitValueUse == DEFAULT_INIT_VALUE_ENABLE) ?
+                           DEFAULT_CRC_INITVALUE : hcrc->Init.InitValue;
+    hcrc->Instance->POL = poly;
+    hcrc->Instance->DR = hcrc->Instance->INIT;
+    hcrc->State = HAL_CRC_STATE_READY;
+    crc_handle = hcrc;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CRC_DeInit(CRC_HandleTypeDef *hcrc)
+{
+    if (hcrc == NULL) {
+        return HAL_ERROR;
+    }
+    hcrc->State = HAL_CRC_STATE_RESET;
+    return HAL_OK;
+}
+
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+    hcrc->State = HAL_CRC_STATE_BUSY;
+    hcrc->Instance->DR = hcrc->Instance->INIT;
+    uint32_t crc = crc_feed(hcrc, pBuffer, BufferLength);
+    hcrc->State = HAL_CRC_STATE_READY;
+    return crc;
+}
+
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+    hcrc->State = HAL_CRC_STATE_BUSY;
+    uint32_t crc = crc_feed(hcrc, pBuffer, BufferLength);
+    hcrc->State = HAL_CRC_STATE_READY;
+    return crc;
+}
+
+HAL_CRC_StateTypeDef HAL_CRC_GetState(const CRC_HandleTypeDef *hcrc)
+{
+    return hcrc->State;
+}
+
+/* Memory-to-memory DMA -------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
+{
+    const uint8_t *src = (const uint8_t *)(uintptr_t)SrcAddress;
+    uint32_t width;
+
+    if (hdma == NULL || DataLength == 0U) {
+        return HAL_ERROR;
+    }
+    if (hdma->State != HAL_DMA_STATE_READY) {
+        return HAL_BUSY;
+    }
+
+    /* The bootloader's only memory-to-memory transfer: into the CRC unit */
+    if (hdma->Init.Direction != DMA_MEMORY_TO_MEMORY || crc_handle == NULL ||
+        DstAddress != (uint32_t)(uintptr_t)&crc_handle->Instance->DR || hdma->Init.MemInc != DMA_MINC_DISABLE ||
+        hdma->Init.PeriphDataAlignment != (hdma->Init.MemDataAlignment >> 2)) {
+        return HAL_ERROR;
+    }
+
+    switch (hdma->Init.PeriphDataAlignment) {
+        case DMA_PDATAALIGN_WORD:     width = 32U; break;
+        case DMA_PDATAALIGN_HALFWORD: width = 16U; break;
+        default:                      width = 8U;  break;
+    }
+    for (uint32_t i = 0U; i < DataLength; i++) {
+        uint32_t item = 0U;
+
+        memcpy(&item, src + (size_t)i * (width / 8U), width / 8U);
+        crc_write(crc_handle, item, width);
+    }
+
+    SIM_Account_Background(SIM_ENGINE_CRC, (size_t)DataLength * (width / 8U),
+                           (uint64_t)DataLength * SIM_CYCLES_CRC_WORD);
+    hdma->State = HAL_DMA_STATE_BUSY;
+    dma_crc = hdma;
+    dma_crc_done = SIM_Clock_Cycles() + (uint64_t)DataLength * SIM_CYCLES_CRC_WORD;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_PollForTransfer(DMA_HandleTypeDef *hdma, HAL_DMA_LevelCompleteTypeDef CompleteLevel,
+                                          uint32_t Timeout)
+{
+    uint64_t now = SIM_Clock_Cycles();
+
+    (void)CompleteLevel;
+    (void)Timeout;
+
+    if (hdma == NULL || hdma != dma_crc || hdma->State != HAL_DMA_STATE_BUSY) {
+        return HAL_ERROR;
+    }
+    if (now < dma_crc_done) {
+        SIM_Clock_Advance(dma_crc_done - now);
+    }
+    hdma->State = HAL_DMA_STATE_READY;
+    dma_crc = NULL;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma)
+{
+    if (hdma == NULL) {
+        return HAL_ERROR;
+    }
+    if (hdma == dma_crc) {
+        dma_crc = NULL;
+    }
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
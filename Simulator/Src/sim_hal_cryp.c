@@ -0,0 +1,522 @@
+/**
+  * @file    sim_hal_cryp.c
+  * @brief   Host stand-in for the STM32L5 AES co-processor
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    Software AES-128/256 in ECB, CBC, CTR and GCM chaining modes with
+  *          the peripheral's register semantics:
+  *          - key and IV words are written most significant word first
+  *          - DATATYPE selects the swap applied to each 32-bit data word
+  *          - the key and IV/counter registers belong to the peripheral, so
+  *            with CRYP_KEYIVCONFIG_ONCE consecutive calls continue the
+  *            chaining state, with CRYP_KEYIVCONFIG_ALWAYS every call
+  *            restarts from Init.pKey / Init.pInitVect
+  *          - GCM: pInitVect is the first payload counter (IV || 2), the
+  *            init and header phases run when the key is (re)loaded and the
+  *            GHASH state carries over ONCE calls until the final phase
+  */
+
+#include "stm32l5xx_hal.h"
+#include "sim_platform.h"
+
+#include <string.h>
+
+/* Private types --------------------------------------------------------*/
+typedef struct {
+    uint8_t  round_key[15 * 16];
+    uint32_t rounds;
+    uint8_t  iv[16];        /* IVR0..3: CBC chaining value or CTR counter */
+    uint8_t  h[16];         /* GCM hash subkey E(K, 0) */
+    uint8_t  j0[16];        /* GCM pre-counter block, encrypted for the tag */
+    uint8_t  ghash[16];     /* GCM running GHASH */
+} SIM_AesEngine;
+
+/* Phase value of the HAL's private CRYPEx_PHASE_PROCESS / _FINAL */
+#define SIM_CRYP_PHASE_PROCESS  0x00000002U
+#define SIM_CRYP_PHASE_FINAL    0x00000003U
+
+/* Private variables ----------------------------------------------------*/
+static SIM_AesEngine engine;
+
+static const uint8_t sbox[256] = {
+    0x63,0x7c,0x77,0x7b,0xf2,0x6b,0x6f,0xc5,0x30,0x01,0x67,0x2b,0xfe,0xd7,0xab,0x76,
+    0xca,0x82,0xc9,0x7d,0xfa,0x59,0x47,0xf0,0xad,0xd4,0xa2,0xaf,0x9c,0xa4,0x72,0xc0,
+    0xb7,0xfd,0x93,0x26,0x36,0x3f,0xf7,0xcc,0x34,0xa5,0xe5,0xf1,0x71,0xd8,0x31,0x15,
+    0x04,0xc7,0x23,0xc3,0x18,0x96,0x05,0x9a,0x07,0x12,0x80,0xe2,0xeb,0x27,0xb2,0x75,
+    0x09,0x83,0x2c,0x1a,0x1b,0x6e,0x5a,0xa0,0x52,0x3b,0xd6,0xb3,0x29,0xe3,0x2f,0x84,
+    0x53,0xd1,0x00,0xed,0x20,0xfc,0xb1,0x5b,0x6a,0xcb,0xbe,0x39,0x4a,0x4c,0x58,0xcf,
+    0xd0,0xef,0xaa,0xfb,0x43,0x4d,0x33,0x85,0x45,0xf9,0x02,0x7f,0x50,0x3c,0x9f,0xa8,
+    0x51,0xa3,0x40,0x8f,0x92,0x9d,0x38,0xf5,0xbc,0xb6,0xda,0x21,0x10,0xff,0xf3,0xd2,
+    0xcd,0x0c,0x13,0xec,0x5f,0x97,0x44,0x17,0xc4,0xa7,0x7e,0x3d,0x64,0x5d,0x19,0x73,
+    0x60,0x81,0x4f,0xdc,0x22,0x2a,0x90,0x88,0x46,0xee,0xb8,0x14,0xde,0x5e,0x0b,0xdb,
+    0xe0,0x32,0x3a,0x0a,0x49,0x06,0x24,0x5c,0xc2,0xd3,0xac,0x62,0x91,0x95,0xe4,0x79,
+    0xe7,0xc8,0x37,0x6d,0x8d,0xd5,0x4e,0xa9,0x6c,0x56,0xf4,0xea,0x65,0x7a,0xae,0x08,
+    0xba,0x78,0x25,0x2e,0x1c,0xa6,0xb4,0xc6,0xe8,0xdd,0x74,0x1f,0x4b,0xbd,0x8b,0x8a,
+    0x70,0x3e,0xb5,0x66,0x48,0x03,0xf6,0x0e,0x61,0x35,0x57,0xb9,0x86,0xc1,0x1d,0x9e,
+    0xe1,0xf8,0x98,0x11,0x69,0xd9,0x8e,0x94,0x9b,0x1e,0x87,0xe9,0xce,0x55,0x28,0xdf,
+    0x8c,0xa1,0x89,0x0d,0xbf,0xe6,0x42,0x68,0x41,0x99,0x2d,0x0f,0xb0,0x54,0xbb,0x16
+};
+
+static uint8_t inv_sbox[256];
+
+/* Private functions ----------------------------------------------------*/
+
+static uint8_t xtime(uint8_t x)
+{
+    return (uint8_t)((x << 1) ^ (((x >> 7) & 1U) * 0x1BU));
+}
+
+static uint8_t gmul(uint8_t a, uint8_t b)
+{
+    uint8_t r = 0U;
+
+    while (b != 0U) {
+        if ((b & 1U) != 0U) {
+            r ^= a;
+        }
+        a = xtime(a);
+        b >>= 1;
+    }
+    return r;
+}
+
+static void key_expand(const uint8_t *key, uint32_t key_len)
+{
+    uint32_t nk = key_len / 4U;
+    uint32_t total = (nk + 7U) * 4U;
+    uint8_t rcon = 0x01U;
+    uint8_t *w = engine.round_key;
+
+    if (inv_sbox[sbox[1]] != 1U) {
+        for (uint32_t i = 0U; i < 256U; i++) {
+            inv_sbox[sbox[i]] = (uint8_t)i;
+        }
+    }
+
+    engine.rounds = nk + 6U;
+    memcpy(w, key, key_len);
+
+    for (uint32_t i = nk; i < total; i++) {
+        uint8_t t[4];
+
+        memcpy(t, &w[4U * (i - 1U)], 4U);
+        if ((i % nk) == 0U) {
+            uint8_t tmp = t[0];
+            t[0] = (uint8_t)(sbox[t[1]] ^ rcon);
+            t[1] = sbox[t[2]];
+            t[2] = sbox[t[3]];
+            t[3] = sbox[tmp];
+            rcon = xtime(rcon);
+        } else if (nk > 6U && (i % nk) == 4U) {
+            for (uint32_t j = 0U; j < 4U; j++) {
+                t[j] = sbox[t[j]];
+            }
+        }
+        for (uint32_t j = 0U; j < 4U; j++) {
+            w[4U * i + j] = (uint8_t)(w[4U * (i - nk) + j] ^ t[j]);
+        }
+    }
+}
+
+static void add_round_key(uint8_t s[16], uint32_t round)
+{
+    for (uint32_t i = 0U; i < 16U; i++) {
+        s[i] ^= engine.round_key[16U * round + i];
+    }
+}
+
+static void aes_encrypt_block(uint8_t s[16])
+{
+    add_round_key(s, 0U);
+
+    for (uint32_t round = 1U; round <= engine.rounds; round++) {
+        uint8_t t[16];
+
+        /* SubBytes + ShiftRows */
+        for (uint32_t c = 0U; c < 4U; c++) {
+            for (uint32_t r = 0U; r < 4U; r++) {
+                t[4U * c + r] = sbox[s[4U * ((c + r) % 4U) + r]];
+            }
+        }
+        /* MixColumns */
+        if (round != engine.rounds) {
+            for (uint32_t c = 0U; c < 4U; c++) {
+                uint8_t *col = &t[4U * c];
+                uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+                col[0] = (uint8_t)(xtime(a0) ^ xtime(a1) ^ a1 ^ a2 ^ a3);
+                col[1] = (uint8_t)(a0 ^ xtime(a1) ^ xtime(a2) ^ a2 ^ a3);
+                col[2] = (uint8_t)(a0 ^ a1 ^ xtime(a2) ^ xtime(a3) ^ a3);
+                col[3] = (uint8_t)(xtime(a0) ^ a0 ^ a1 ^ a2 ^ xtime(a3));
+            }
+        }
+        memcpy(s, t, 16U);
+        add_round_key(s, round);
+    }
+}
+
+static void aes_decrypt_block(uint8_t s[16])
+{
+    add_round_key(s, engine.rounds);
+
+    for (uint32_t round = engine.rounds; round-- > 0U;) {
+        uint8_t t[16];
+
+        /* InvShiftRows + InvSubBytes */
+        for (uint32_t c = 0U; c < 4U; c++) {
+            for (uint32_t r = 0U; r < 4U; r++) {
+                t[4U * ((c + r) % 4U) + r] = inv_sbox[s[4U * c + r]];
+            }
+        }
+        memcpy(s, t, 16U);
+        add_round_key(s, round);
+        /* InvMixColumns */
+        if (round != 0U) {
+            for (uint32_t c = 0U; c < 4U; c++) {
+                uint8_t *col = &s[4U * c];
+                uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+                col[0] = (uint8_t)(gmul(a0, 14U) ^ gmul(a1, 11U) ^ gmul(a2, 13U) ^ gmul(a3, 9U));
+                col[1] = (uint8_t)(gmul(a0, 9U) ^ gmul(a1, 14U) ^ gmul(a2, 11U) ^ gmul(a3, 13U));
+                col[2] = (uint8_t)(gmul(a0, 13U) ^ gmul(a1, 9U) ^ gmul(a2, 14U) ^ gmul(a3, 11U));
+                col[3] = (uint8_t)(gmul(a0, 11U) ^ gmul(a1, 13U) ^ gmul(a2, 9U) ^ gmul(a3, 14U));
+            }
+        }
+    }
+}
+
+static void words_to_bytes_be(const uint32_t *w, uint32_t count, uint8_t *out)
+{
+    for (uint32_t i = 0U; i < count; i++) {
+        out[4U * i]      = (uint8_t)(w[i] >> 24);
+        out[4U * i + 1U] = (uint8_t)(w[i] >> 16);
+        out[4U * i + 2U] = (uint8_t)(w[i] >> 8);
+        out[4U * i + 3U] = (uint8_t)(w[i]);
+    }
+}
+
+/**
+  * @brief  Convert one data word between memory and block byte order
+  * @note   The swaps are involutions, so the same routine is used on the
+  *         way into DINR and out of DOUTR.
+  */
+static void swap_word(uint32_t datatype, const uint8_t in[4], uint8_t out[4])
+{
+    switch (datatype) {
+        case CRYP_DATATYPE_8B:
+            memcpy(out, in, 4U);
+            break;
+        case CRYP_DATATYPE_16B:
+            out[0] = in[1]; out[1] = in[0]; out[2] = in[3]; out[3] = in[2];
+            break;
+        case CRYP_DATATYPE_1B:
+            for (uint32_t b = 0U; b < 4U; b++) {
+                uint8_t v = 0U;
+                for (uint32_t bit = 0U; bit < 8U; bit++) {
+                    v = (uint8_t)((v << 1) | ((in[b] >> bit) & 1U));
+                }
+                out[b] = v;
+            }
+            break;
+        default: /* CRYP_DATATYPE_32B: no swapping, MSB is the first block byte */
+            out[0] = in[3]; out[1] = in[2]; out[2] = in[1]; out[3] = in[0];
+            break;
+    }
+}
+
+static void load_key_iv(CRYP_HandleTypeDef *hcryp)
+{
+    uint8_t key[32];
+    uint32_t key_words = (hcryp->Init.KeySize == CRYP_KEYSIZE_256B) ? 8U : 4U;
+
+    words_to_bytes_be(hcryp->Init.pKey, key_words, key);
+    key_expand(key, key_words * 4U);
+    memset(key, 0, sizeof(key));
+
+    if (hcryp->Init.Algorithm != CRYP_AES_ECB && hcryp->Init.pInitVect != NULL) {
+        words_to_bytes_be(hcryp->Init.pInitVect, 4U, engine.iv);
+    }
+}
+
+static void ctr_increment(uint8_t ctr[16])
+{
+    /* The peripheral increments the least significant 32 bits only */
+    for (int i = 15; i >= 12; i--) {
+        if (++ctr[i] != 0U) {
+            break;
+        }
+    }
+}
+
+/** @brief GF(2^128) multiply of the GHASH state by H (bit-serial, SP 800-38D) */
+static void gcm_mult_h(uint8_t x[16])
+{
+    uint8_t z[16] = { 0U };
+    uint8_t v[16];
+
+    memcpy(v, engine.h, 16U);
+    for (uint32_t i = 0U; i < 128U; i++) {
+        if ((x[i / 8U] >> (7U - (i % 8U))) & 1U) {
+            for (uint32_t b = 0U; b < 16U; b++) {
+                z[b] ^= v[b];
+            }
+        }
+        uint8_t lsb = v[15] & 1U;
+        for (int b = 15; b > 0; b--) {
+            v[b] = (uint8_t)((v[b] >> 1) | (v[b - 1] << 7));
+        }
+        v[0] >>= 1;
+        if (lsb != 0U) {
+            v[0] ^= 0xE1U;
+        }
+    }
+    memcpy(x, z, 16U);
+}
+
+static void gcm_ghash_block(const uint8_t blk[16])
+{
+    for (uint32_t i = 0U; i < 16U; i++) {
+        engine.ghash[i] ^= blk[i];
+    }
+    gcm_mult_h(engine.ghash);
+}
+
+/** @brief GCM init and header phases, run whenever the key is (re)loaded */
+static void gcm_init_phase(CRYP_HandleTypeDef *hcryp)
+{
+    const uint8_t *aad = (const uint8_t *)hcryp->Init.Header;
+    uint32_t aad_bytes = hcryp->Init.HeaderSize;
+    uint8_t word[4];
+
+    memset(engine.h, 0, 16U);
+    aes_encrypt_block(engine.h);
+    memset(engine.ghash, 0, 16U);
+
+    memcpy(engine.j0, engine.iv, 16U);
+    for (int i = 15; i >= 12; i--) {
+        if (engine.j0[i]-- != 0U) {
+            break;
+        }
+    }
+
+    if (hcryp->Init.HeaderWidthUnit != CRYP_HEADERWIDTHUNIT_BYTE) {
+        aad_bytes *= 4U;
+    }
+    for (uint32_t off = 0U; aad != NULL && off < aad_bytes; off += 16U) {
+        uint8_t blk[16] = { 0U };
+        uint32_t n = (aad_bytes - off < 16U) ? (aad_bytes - off) : 16U;
+
+        for (uint32_t i = 0U; i < n; i += 4U) {
+            memset(word, 0, sizeof(word));
+            memcpy(word, &aad[off + i], (n - i < 4U) ? (n - i) : 4U);
+            swap_word(hcryp->Init.DataType, word, &blk[i]);
+        }
+        memset(&blk[n], 0, 16U - n);
+        gcm_ghash_block(blk);
+    }
+}
+
+static HAL_StatusTypeDef cryp_process(CRYP_HandleTypeDef *hcryp, bool encrypt, uint32_t *Input,
+                                      uint16_t Size, uint32_t *Output)
+{
+    const uint8_t *in = (const uint8_t *)Input;
+    uint8_t *out = (uint8_t *)Output;
+    uint32_t bytes;
+
+    if (hcryp == NULL || Input == NULL || Output == NULL) {
+        return HAL_ERROR;
+    }
+    if (hcryp->State != HAL_CRYP_STATE_READY) {
+        hcryp->ErrorCode |= HAL_CRYP_ERROR_BUSY;
+        return HAL_ERROR;
+    }
+
+    bytes = (hcryp->Init.DataWidthUnit == CRYP_DATAWIDTHUNIT_WORD) ? (uint32_t)Size * 4U : Size;
+
+    if ((bytes % 16U) != 0U && hcryp->Init.Algorithm != CRYP_AES_CTR &&
+        hcryp->Init.Algorithm != CRYP_AES_GCM_GMAC) {
+        hcryp->ErrorCode |= HAL_CRYP_ERROR_NOT_SUPPORTED;
+        return HAL_ERROR;
+    }
+    if (hcryp->Init.Algorithm != CRYP_AES_ECB && hcryp->Init.Algorithm != CRYP_AES_CBC &&
+        hcryp->Init.Algorithm != CRYP_AES_CTR && hcryp->Init.Algorithm != CRYP_AES_GCM_GMAC) {
+        hcryp->ErrorCode |= HAL_CRYP_ERROR_NOT_SUPPORTED;
+        return HAL_ERROR;
+    }
+
+    hcryp->State = HAL_CRYP_STATE_BUSY;
+
+    if (hcryp->Init.KeyIVConfigSkip == CRYP_KEYIVCONFIG_ALWAYS || hcryp->KeyIVConfig == 0U) {
+        load_key_iv(hcryp);
+        hcryp->KeyIVConfig = 1U;
+        hcryp->SizesSum = bytes;
+        if (hcryp->Init.Algorithm == CRYP_AES_GCM_GMAC) {
+            gcm_init_phase(hcryp);
+        }
+    } else {
+        hcryp->SizesSum += bytes;
+    }
+
+    for (uint32_t off = 0U; off < bytes; off += 16U) {
+        uint8_t blk[16] = { 0U };
+        uint8_t res[16];
+        uint32_t n = (bytes - off < 16U) ? (bytes - off) : 16U;
+        uint8_t word[4];
+
+        for (uint32_t i = 0U; i < n; i += 4U) {
+            memset(word, 0, sizeof(word));
+            memcpy(word, &in[off + i], (n - i < 4U) ? (n - i) : 4U);
+            swap_word(hcryp->Init.DataType, word, &blk[i]);
+        }
+
+        switch (hcryp->Init.Algorithm) {
+            case CRYP_AES_ECB:
+                memcpy(res, blk, 16U);
+                encrypt ? aes_encrypt_block(res) : aes_decrypt_block(res);
+                break;
+
+            case CRYP_AES_CBC:
+                if (encrypt) {
+                    for (uint32_t i = 0U; i < 16U; i++) {
+                        res[i] = blk[i] ^ engine.iv[i];
+                    }
+                    aes_encrypt_block(res);
+                    memcpy(engine.iv, res, 16U);
+                } else {
+                    memcpy(res, blk, 16U);
+                    aes_decrypt_block(res);
+                    for (uint32_t i = 0U; i < 16U; i++) {
+                        res[i] ^= engine.iv[i];
+                    }
+                    memcpy(engine.iv, blk, 16U);
+                }
+                break;
+
+            default: /* CRYP_AES_CTR, CRYP_AES_GCM_GMAC */
+                memcpy(res, engine.iv, 16U);
+                aes_encrypt_block(res);
+                for (uint32_t i = 0U; i < 16U; i++) {
+                    res[i] ^= blk[i];
+                }
+                ctr_increment(engine.iv);
+
+                if (hcryp->Init.Algorithm == CRYP_AES_GCM_GMAC) {
+                    /* GHASH runs over the ciphertext, zero-padded (NPBLB) */
+                    if (encrypt) {
+                        memset(&res[n], 0, 16U - n);
+                        gcm_ghash_block(res);
+                    } else {
+                        gcm_ghash_block(blk);
+                    }
+                }
+                break;
+        }
+
+        for (uint32_t i = 0U; i < n; i += 4U) {
+            swap_word(hcryp->Init.DataType, &res[i], word);
+            memcpy(&out[off + i], word, (n - i < 4U) ? (n - i) : 4U);
+        }
+    }
+
+    SIM_Account(SIM_ENGINE_CRYP, Input, bytes, (uint64_t)((bytes + 15U) / 16U) * SIM_CYCLES_AES_BLOCK);
+
+    if (hcryp->Init.Algorithm == CRYP_AES_GCM_GMAC) {
+        hcryp->Phase = SIM_CRYP_PHASE_PROCESS;
+    }
+    hcryp->State = HAL_CRYP_STATE_READY;
+    return HAL_OK;
+}
+
+/* Exported functions ---------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_CRYP_Init(CRYP_HandleTypeDef *hcryp)
+{
+    if (hcryp == NULL || hcryp->Init.pKey == NULL) {
+        return HAL_ERROR;
+    }
+
+    hcryp->ErrorCode = HAL_CRYP_ERROR_NONE;
+    hcryp->KeyIVConfig = 0U;
+    hcryp->SizesSum = 0U;
+    hcryp->State = HAL_CRYP_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CRYP_DeInit(CRYP_HandleTypeDef *hcryp)
+{
+    if (hcryp == NULL) {
+        return HAL_ERROR;
+    }
+
+    memset(&engine, 0, sizeof(engine));
+    hcryp->KeyIVConfig = 0U;
+    hcryp->State = HAL_CRYP_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CRYP_Encrypt(CRYP_HandleTypeDef *hcryp, uint32_t *Input, uint16_t Size, uint32_t *Output,
+                                   uint32_t Timeout)
+{
+    (void)Timeout;
+    return cryp_process(hcryp, true, Input, Size, Output);
+}
+
+HAL_StatusTypeDef HAL_CRYP_Decrypt(CRYP_HandleTypeDef *hcryp, uint32_t *Input, uint16_t Size, uint32_t *Output,
+                                   uint32_t Timeout)
+{
+    (void)Timeout;
+    return cryp_process(hcryp, false, Input, Size, Output);
+}
+
+HAL_CRYP_STATETypeDef HAL_CRYP_GetState(CRYP_HandleTypeDef *hcryp)
+{
+    return hcryp->State;
+}
+
+uint32_t HAL_CRYP_GetError(CRYP_HandleTypeDef *hcryp)
+{
+    return hcryp->ErrorCode;
+}
+
+HAL_StatusTypeDef HAL_CRYPEx_AESGCM_GenerateAuthTAG(CRYP_HandleTypeDef *hcryp, uint32_t *AuthTag, uint32_t Timeout)
+{
+    uint64_t header_bits;
+    uint64_t payload_bits;
+    uint8_t blk[16];
+    uint8_t *out = (uint8_t *)AuthTag;
+
+    (void)Timeout;
+
+    if (hcryp == NULL || AuthTag == NULL || hcryp->State != HAL_CRYP_STATE_READY) {
+        return HAL_ERROR;
+    }
+    if (hcryp->Phase != SIM_CRYP_PHASE_PROCESS) {
+        hcryp->ErrorCode |= HAL_CRYP_ERROR_AUTH_TAG_SEQUENCE;
+        return HAL_ERROR;
+    }
+    hcryp->Phase = SIM_CRYP_PHASE_FINAL;
+
+    header_bits = (uint64_t)hcryp->Init.HeaderSize * 8U;
+    if (hcryp->Init.HeaderWidthUnit != CRYP_HEADERWIDTHUNIT_BYTE) {
+        header_bits *= 4U;
+    }
+    payload_bits = (uint64_t)hcryp->SizesSum * 8U;
+
+    for (uint32_t i = 0U; i < 8U; i++) {
+        blk[i] = (uint8_t)(header_bits >> (56U - (8U * i)));
+        blk[8U + i] = (uint8_t)(payload_bits >> (56U - (8U * i)));
+    }
+    gcm_ghash_block(blk);
+
+    memcpy(blk, engine.j0, 16U);
+    aes_encrypt_block(blk);
+    for (uint32_t i = 0U; i < 16U; i++) {
+        blk[i] ^= engine.ghash[i];
+    }
+
+    for (uint32_t i = 0U; i < 16U; i += 4U) {
+        swap_word(hcryp->Init.DataType, &blk[i], &out[i]);
+    }
+
+    SIM_Account(SIM_ENGINE_CRYP, NULL, 16U, SIM_CYCLES_AES_BLOCK);
+    return HAL_OK;
+}
@@ -0,0 +1,377 @@
+/**
+  * @file    sim_hal_flash.c
+  * @brief   Host stand-in for the STM32L5 flash programming interface
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    Models the rules the bootloader can trip over on silicon:
+  *          - programming requires HAL_FLASH_Unlock
+  *          - only 64-bit aligned double-words can be programmed, and only
+  *            over an erased double-word (otherwise PROGERR)
+  *          - erase works on 2KB pages per bank (DBANK=1 layout)
+  *          - one operation at a time: the HAL lock is held from the start
+  *            of an interrupt-driven operation until its IRQ handler has
+  *            run the callbacks, so a new operation can only be started
+  *            from thread mode (HAL_BUSY otherwise)
+  *          - reads of the bank being written stall (see SIM_Account)
+  *          - a power cut (SIM_Power_CutAt) leaves the operation torn: an
+  *            interrupted program has only its first word in the cells, an
+  *            interrupted page erase only the first half of the page
+  *          Program and erase times come from sim_platform.h. Blocking
+  *          calls advance the clock; the _IT variants schedule the end of
+  *          operation as a clock event and take effect when it fires.
+  */
+
+#include "stm32l5xx_hal.h"
+#include "sim_platform.h"
+
+#include <string.h>
+
+/* Exported variables ---------------------------------------------------*/
+FLASH_ProcessTypeDef pFlash = {
+    .Lock = HAL_UNLOCKED,
+    .ErrorCode = HAL_FLASH_ERROR_NONE,
+};
+
+/* Private types --------------------------------------------------------*/
+typedef struct {
+    uint32_t type;         /* ProcedureOnGoing without the non-secure mask */
+    uint32_t address;      /* Program: target address */
+    uint64_t data;         /* Program: double-word */
+    uint32_t bank_base;    /* Erase: secure alias of the bank */
+    uint32_t page;         /* Erase: current page */
+    uint32_t pages_left;   /* Erase: pages after the current one */
+} SIM_FlashOp;
+
+/* Private variables ----------------------------------------------------*/
+static bool flash_locked = true;
+static SIM_FlashOp flash_op;
+
+/* Private functions ----------------------------------------------------*/
+
+static bool is_erased(const uint8_t *p, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        if (p[i] != SIM_FLASH_ERASED_BYTE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool is_program_type(uint32_t type)
+{
+    return type == FLASH_TYPEPROGRAM_DOUBLEWORD || type == FLASH_TYPEPROGRAM_DOUBLEWORD_NS;
+}
+
+static bool is_page_erase_type(uint32_t type)
+{
+    return type == FLASH_TYPEERASE_PAGES || type == FLASH_TYPEERASE_PAGES_NS;
+}
+
+static int bank_index(uint32_t bank_base)
+{
+    return (bank_base == SIM_FLASH_S_BASE) ? 0 : 1;
+}
+
+/**
+  * @brief  Check a double-word program request
+  * @retval Backing bytes of the target, NULL with pFlash.ErrorCode set
+  */
+static uint8_t *program_target(uint32_t TypeProgram, uint32_t Address)
+{
+    uint8_t *dst;
+
+    if (!is_program_type(TypeProgram) || flash_locked) {
+        pFlash.ErrorCode = HAL_FLASH_ERROR_PGS;
+        return NULL;
+    }
+
+    if ((Address & 0x7U) != 0U) {
+        pFlash.ErrorCode = HAL_FLASH_ERROR_PGA;
+        return NULL;
+    }
+
+    dst = SIM_Flash_Backing(Address, sizeof(uint64_t));
+    if (dst == NULL) {
+        pFlash.ErrorCode = HAL_FLASH_ERROR_OP;
+    }
+    return dst;
+}
+
+/**
+  * @brief  Check a page erase request
+  * @retval Secure alias of the bank, 0 with pFlash.ErrorCode set
+  */
+static uint32_t erase_bank_base(const FLASH_EraseInitTypeDef *pEraseInit)
+{
+    if (flash_locked) {
+        pFlash.ErrorCode = HAL_FLASH_ERROR_PGS;
+        return 0U;
+    }
+
+    if (!is_page_erase_type(pEraseInit->TypeErase)) {
+        /* Mass erase would wipe the running bootloader */
+        pFlash.ErrorCode = HAL_FLASH_ERROR_OP;
+        return 0U;
+    }
+
+    if (pEraseInit->Banks == FLASH_BANK_1) {
+        return SIM_FLASH_S_BASE;
+    }
+    if (pEraseInit->Banks == FLASH_BANK_2) {
+        return SIM_FLASH_S_BASE + SIM_FLASH_BANK_SIZE;
+    }
+
+    pFlash.ErrorCode = HAL_FLASH_ERROR_OP;
+    return 0U;
+}
+
+static void tear_program(uint8_t *dst, uint64_t data)
+{
+    const uint8_t *src = (const uint8_t *)&data;
+
+    /* Programming only clears bits */
+    for (uint32_t i = 0; i < sizeof(uint32_t); i++) {
+        dst[i] &= src[i];
+    }
+    SIM_Power_Fail();
+}
+
+static void tear_erase(uint8_t *page)
+{
+    memset(page, SIM_FLASH_ERASED_BYTE, SIM_FLASH_PAGE_SIZE / 2U);
+    SIM_Power_Fail();
+}
+
+static void flash_irq_event(void)
+{
+    /* On silicon the NVIC enters FLASH_IRQHandler, which calls this */
+    HAL_FLASH_IRQHandler();
+}
+
+static void start_page_erase(void)
+{
+    if (SIM_Flash_OperationStart()) {
+        tear_erase(SIM_Flash_Backing(flash_op.bank_base + flash_op.page * SIM_FLASH_PAGE_SIZE, SIM_FLASH_PAGE_SIZE));
+    }
+    SIM_Account_Background(SIM_ENGINE_FLASH_ERASE, SIM_FLASH_PAGE_SIZE, SIM_Clock_UsToCycles(SIM_FLASH_PAGE_ERASE_US));
+    SIM_Flash_SetBusyBank(bank_index(flash_op.bank_base));
+    SIM_Event_Schedule(SIM_Clock_Cycles() + SIM_Clock_UsToCycles(SIM_FLASH_PAGE_ERASE_US), flash_irq_event);
+}
+
+/* Exported functions ---------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    flash_locked = false;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    flash_locked = true;
+    return HAL_OK;
+}
+
+uint32_t HAL_FLASH_GetError(void)
+{
+    return pFlash.ErrorCode;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    uint8_t *dst;
+
+    if (pFlash.Lock == HAL_LOCKED) {
+        return HAL_BUSY;
+    }
+
+    pFlash.ErrorCode = HAL_FLASH_ERROR_NONE;
+
+    dst = program_target(TypeProgram, Address);
+    if (dst == NULL) {
+        return HAL_ERROR;
+    }
+
+    if (SIM_Flash_OperationStart()) {
+        tear_program(dst, Data);
+    }
+
+    SIM_Account(SIM_ENGINE_FLASH_PROGRAM, NULL, sizeof(Data), SIM_Clock_UsToCycles(SIM_FLASH_PROGRAM_US));
+
+    if (!is_erased(dst, sizeof(Data))) {
+        pFlash.ErrorCode = HAL_FLASH_ERROR_PROG;
+        return HAL_ERROR;
+    }
+
+    memcpy(dst, &Data, sizeof(Data));
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program_IT(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    uint8_t *dst;
+
+    if (pFlash.Lock == HAL_LOCKED) {
+        return HAL_BUSY;
+    }
+
+    pFlash.ErrorCode = HAL_FLASH_ERROR_NONE;
+
+    dst = program_target(TypeProgram, Address);
+    if (dst == NULL) {
+        return HAL_ERROR;
+    }
+
+    if (SIM_Flash_OperationStart()) {
+        tear_program(dst, Data);
+    }
+
+    pFlash.Lock = HAL_LOCKED;
+    pFlash.ProcedureOnGoing = TypeProgram;
+    pFlash.Address = Address;
+
+    flash_op.type = FLASH_TYPEPROGRAM_DOUBLEWORD;
+    flash_op.address = Address;
+    flash_op.data = Data;
+
+    SIM_Account_Background(SIM_ENGINE_FLASH_PROGRAM, sizeof(Data), SIM_Clock_UsToCycles(SIM_FLASH_PROGRAM_US));
+    SIM_Flash_SetBusyBank((int)((Address & (SIM_FLASH_SIZE - 1U)) / SIM_FLASH_BANK_SIZE));
+    SIM_Event_Schedule(SIM_Clock_Cycles() + SIM_Clock_UsToCycles(SIM_FLASH_PROGRAM_US), flash_irq_event);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+    uint32_t bank_base;
+
+    if (pEraseInit == NULL || PageError == NULL) {
+        return HAL_ERROR;
+    }
+
+    if (pFlash.Lock == HAL_LOCKED) {
+        return HAL_BUSY;
+    }
+
+    *PageError = 0xFFFFFFFFU;
+    pFlash.ErrorCode = HAL_FLASH_ERROR_NONE;
+
+    bank_base = erase_bank_base(pEraseInit);
+    if (bank_base == 0U) {
+        return HAL_ERROR;
+    }
+
+    for (uint32_t page = pEraseInit->Page; page < pEraseInit->Page + pEraseInit->NbPages; page++) {
+        uint8_t *dst;
+
+        if (page >= SIM_FLASH_BANK_SIZE / SIM_FLASH_PAGE_SIZE) {
+            *PageError = page;
+            pFlash.ErrorCode = HAL_FLASH_ERROR_OP;
+            return HAL_ERROR;
+        }
+
+        dst = SIM_Flash_Backing(bank_base + page * SIM_FLASH_PAGE_SIZE, SIM_FLASH_PAGE_SIZE);
+        if (SIM_Flash_OperationStart()) {
+            tear_erase(dst);
+        }
+        SIM_Account(SIM_ENGINE_FLASH_ERASE, NULL, SIM_FLASH_PAGE_SIZE, SIM_Clock_UsToCycles(SIM_FLASH_PAGE_ERASE_US));
+        memset(dst, SIM_FLASH_ERASED_BYTE, SIM_FLASH_PAGE_SIZE);
+    }
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase_IT(FLASH_EraseInitTypeDef *pEraseInit)
+{
+    uint32_t bank_base;
+
+    if (pEraseInit == NULL) {
+        return HAL_ERROR;
+    }
+
+    if (pFlash.Lock == HAL_LOCKED) {
+        return HAL_BUSY;
+    }
+
+    pFlash.ErrorCode = HAL_FLASH_ERROR_NONE;
+
+    bank_base = erase_bank_base(pEraseInit);
+    if (bank_base == 0U) {
+        return HAL_ERROR;
+    }
+
+    if (pEraseInit->NbPages == 0U ||
+        pEraseInit->Page + pEraseInit->NbPages > SIM_FLASH_BANK_SIZE / SIM_FLASH_PAGE_SIZE) {
+        pFlash.ErrorCode = HAL_FLASH_ERROR_OP;
+        return HAL_ERROR;
+    }
+
+    pFlash.Lock = HAL_LOCKED;
+    pFlash.ProcedureOnGoing = pEraseInit->TypeErase;
+    pFlash.Bank = pEraseInit->Banks;
+    pFlash.Page = pEraseInit->Page;
+    pFlash.NbPagesToErase = pEraseInit->NbPages;
+
+    flash_op.type = FLASH_TYPEERASE_PAGES;
+    flash_op.bank_base = bank_base;
+    flash_op.page = pEraseInit->Page;
+    flash_op.pages_left = pEraseInit->NbPages - 1U;
+
+    start_page_erase();
+    return HAL_OK;
+}
+
+void HAL_FLASH_IRQHandler(void)
+{
+    uint32_t param = 0xFFFFFFFFU;
+    bool failed = false;
+
+    SIM_Flash_SetBusyBank(-1);
+
+    if (flash_op.type == FLASH_TYPEPROGRAM_DOUBLEWORD) {
+        uint8_t *dst = SIM_Flash_Backing(flash_op.address, sizeof(flash_op.data));
+
+        param = flash_op.address;
+        if (!is_erased(dst, sizeof(flash_op.data))) {
+            pFlash.ErrorCode |= HAL_FLASH_ERROR_PROG;
+            failed = true;
+        } else {
+            memcpy(dst, &flash_op.data, sizeof(flash_op.data));
+        }
+    } else {
+        memset(SIM_Flash_Backing(flash_op.bank_base + flash_op.page * SIM_FLASH_PAGE_SIZE, SIM_FLASH_PAGE_SIZE),
+               SIM_FLASH_ERASED_BYTE, SIM_FLASH_PAGE_SIZE);
+        param = flash_op.page;
+    }
+
+    if (failed) {
+        pFlash.ProcedureOnGoing = 0U;
+        HAL_FLASH_OperationErrorCallback(param);
+    } else if (flash_op.type == FLASH_TYPEERASE_PAGES && flash_op.pages_left > 0U) {
+        /* Same sequence as the HAL: the next page starts from the handler */
+        flash_op.pages_left--;
+        flash_op.page++;
+        pFlash.Page = flash_op.page;
+        pFlash.NbPagesToErase--;
+        HAL_FLASH_EndOfOperationCallback(param);
+        start_page_erase();
+    } else {
+        pFlash.ProcedureOnGoing = 0U;
+        HAL_FLASH_EndOfOperationCallback((flash_op.type == FLASH_TYPEERASE_PAGES) ? 0xFFFFFFFFU : param);
+    }
+
+    if (pFlash.ProcedureOnGoing == 0U) {
+        pFlash.Lock = HAL_UNLOCKED;
+    }
+}
+
+__weak void HAL_FLASH_EndOfOperationCallback(uint32_t ReturnValue)
+{
+    (void)ReturnValue;
+}
+
+__weak void HAL_FLASH_OperationErrorCallback(uint32_t ReturnValue)
+{
+    (void)ReturnValue;
+}
@@ -0,0 +1,287 @@
+/**
+  * @file    sim_hal_hash.c
+  * @brief   Host stand-in for the STM32L5 HASH processor (SHA-256 only)
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    The peripheral holds one digest context in its registers, so the
+  *          stand-in keeps a single engine state shared by all handles, as
+  *          silicon does. Start/Accmlt/Accmlt_End follow the HAL phase
+  *          rules (Accmlt needs a multiple of 4 bytes, the first call starts
+  *          a new digest) and Finish re-reads the last digest from the
+  *          output registers. DATATYPE swapping is applied per 32-bit word.
+  */
+
+#include "stm32l5xx_hal.h"
+#include "sim_platform.h"
+
+#include <string.h>
+
+/* Private types --------------------------------------------------------*/
+typedef struct {
+    uint32_t state[8];
+    uint64_t length;        /* Message bytes absorbed */
+    uint8_t  block[64];
+    uint32_t block_len;
+    uint8_t  digest[32];    /* HASH_HR0..7 */
+} SIM_HashEngine;
+
+/* Private variables ----------------------------------------------------*/
+static SIM_HashEngine engine;
+
+static const uint32_t K[64] = {
+    0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U, 0x3956c25bU, 0x59f111f1U, 0x923f82a4U, 0xab1c5ed5U,
+    0xd807aa98U, 0x12835b01U, 0x243185beU, 0x550c7dc3U, 0x72be5d74U, 0x80deb1feU, 0x9bdc06a7U, 0xc19bf174U,
+    0xe49b69c1U, 0xefbe4786U, 0x0fc19dc6U, 0x240ca1ccU, 0x2de92c6fU, 0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU,
+    0x983e5152U, 0xa831c66dU, 0xb00327c8U, 0xbf597fc7U, 0xc6e00bf3U, 0xd5a79147U, 0x06ca6351U, 0x14292967U,
+    0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU, 0x53380d13U, 0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U,
+    0xa2bfe8a1U, 0xa81a664bU, 0xc24b8b70U, 0xc76c51a3U, 0xd192e819U, 0xd6990624U, 0xf40e3585U, 0x106aa070U,
+    0x19a4c116U, 0x1e376c08U, 0x2748774cU, 0x34b0bcb5U, 0x391c0cb3U, 0x4ed8aa4aU, 0x5b9cca4fU, 0x682e6ff3U,
+    0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U, 0x90befffaU, 0xa4506cebU, 0xbef9a3f7U, 0xc67178f2U
+};
+
+/* Private functions ----------------------------------------------------*/
+
+#define ROR(x, n)  (((x) >> (n)) | ((x) << (32U - (n))))
+
+static void sha256_block(uint32_t st[8], const uint8_t *p)
+{
+    uint32_t w[64];
+    uint32_t a, b, c, d, e, f, g, h;
+
+    for (uint32_t i = 0U; i < 16U; i++) {
+        w[i] = ((uint32_t)p[4U * i] << 24) | ((uint32_t)p[4U * i + 1U] << 16) |
+               ((uint32_t)p[4U * i + 2U] << 8) | (uint32_t)p[4U * i + 3U];
+    }
+    for (uint32_t i = 16U; i < 64U; i++) {
+        uint32_t s0 = ROR(w[i - 15U], 7U) ^ ROR(w[i - 15U], 18U) ^ (w[i - 15U] >> 3);
+        uint32_t s1 = ROR(w[i - 2U], 17U) ^ ROR(w[i - 2U], 19U) ^ (w[i - 2U] >> 10);
+        w[i] = w[i - 16U] + s0 + w[i - 7U] + s1;
+    }
+
+    a = st[0]; b = st[1]; c = st[2]; d = st[3];
+    e = st[4]; f = st[5]; g = st[6]; h = st[7];
+
+    for (uint32_t i = 0U; i < 64U; i++) {
+        uint32_t t1 = h + (ROR(e, 6U) ^ ROR(e, 11U) ^ ROR(e, 25U)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        uint32_t t2 = (ROR(a, 2U) ^ ROR(a, 13U) ^ ROR(a, 22U)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    st[0] += a; st[1] += b; st[2] += c; st[3] += d;
+    st[4] += e; st[5] += f; st[6] += g; st[7] += h;
+}
+
+static void engine_start(void)
+{
+    static const uint32_t iv[8] = {
+        0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
+        0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U
+    };
+
+    memcpy(engine.state, iv, sizeof(iv));
+    engine.length = 0U;
+    engine.block_len = 0U;
+}
+
+static void engine_byte(uint8_t byte)
+{
+    engine.block[engine.block_len++] = byte;
+    engine.length++;
+    if (engine.block_len == sizeof(engine.block)) {
+        sha256_block(engine.state, engine.block);
+        engine.block_len = 0U;
+    }
+}
+
+/**
+  * @brief  Push input through the DIN register with DATATYPE swapping
+  * @note   Only the final write of a message may be partial; its valid
+  *         bytes are the low-order bytes of the swapped word (NBLW).
+  */
+static void engine_feed(HASH_HandleTypeDef *hhash, const uint8_t *p, uint32_t size)
+{
+    uint64_t blocks_before = engine.length / 64U;
+
+    for (uint32_t i = 0U; i < size; i += 4U) {
+        uint8_t w[4] = { 0U, 0U, 0U, 0U };
+        uint8_t msg[4];
+        uint32_t n = (size - i < 4U) ? (size - i) : 4U;
+
+        memcpy(w, &p[i], n);
+
+        switch (hhash->Init.DataType) {
+            case HASH_DATATYPE_8B:
+                memcpy(msg, w, 4U);
+                break;
+            case HASH_DATATYPE_16B:
+                msg[0] = w[1]; msg[1] = w[0]; msg[2] = w[3]; msg[3] = w[2];
+                break;
+            case HASH_DATATYPE_1B:
+                for (uint32_t b = 0U; b < 4U; b++) {
+                    uint8_t in = w[b];
+                    uint8_t out = 0U;
+                    for (uint32_t bit = 0U; bit < 8U; bit++) {
+                        out = (uint8_t)((out << 1) | ((in >> bit) & 1U));
+                    }
+                    msg[b] = out;
+                }
+                break;
+            default: /* HASH_DATATYPE_32B: word taken as-is, MSB first */
+                msg[0] = w[3]; msg[1] = w[2]; msg[2] = w[1]; msg[3] = w[0];
+                break;
+        }
+
+        for (uint32_t b = 0U; b < n; b++) {
+            engine_byte(msg[b]);
+        }
+    }
+
+    SIM_Account(SIM_ENGINE_HASH, p, size,
+                (uint64_t)((size + 3U) / 4U) * SIM_CYCLES_HASH_WORD +
+                (engine.length / 64U - blocks_before) * SIM_CYCLES_HASH_BLOCK);
+}
+
+static void engine_final(void)
+{
+    uint64_t bits = engine.length * 8U;
+    uint32_t pad_blocks = (engine.block_len < 56U) ? 1U : 2U;
+
+    engine.block[engine.block_len++] = 0x80U;
+    while (engine.block_len != 56U) {
+        if (engine.block_len == sizeof(engine.block)) {
+            sha256_block(engine.state, engine.block);
+            engine.block_len = 0U;
+            continue;
+        }
+        engine.block[engine.block_len++] = 0x00U;
+    }
+    for (int i = 7; i >= 0; i--) {
+        engine.block[engine.block_len++] = (uint8_t)(bits >> (8 * i));
+    }
+    sha256_block(engine.state, engine.block);
+    engine.block_len = 0U;
+
+    for (uint32_t i = 0U; i < 8U; i++) {
+        engine.digest[4U * i]      = (uint8_t)(engine.state[i] >> 24);
+        engine.digest[4U * i + 1U] = (uint8_t)(engine.state[i] >> 16);
+        engine.digest[4U * i + 2U] = (uint8_t)(engine.state[i] >> 8);
+        engine.digest[4U * i + 3U] = (uint8_t)(engine.state[i]);
+    }
+
+    SIM_Account(SIM_ENGINE_HASH, NULL, 0U, (uint64_t)pad_blocks * SIM_CYCLES_HASH_BLOCK);
+}
+
+static void read_digest(uint8_t *pOutBuffer)
+{
+    memcpy(pOutBuffer, engine.digest, sizeof(engine.digest));
+    SIM_Account(SIM_ENGINE_HASH, NULL, 0U, 8U * SIM_CYCLES_HASH_WORD);
+}
+
+/* Exported functions ---------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_HASH_Init(HASH_HandleTypeDef *hhash)
+{
+    if (hhash == NULL) {
+        return HAL_ERROR;
+    }
+
+    hhash->State = HAL_HASH_STATE_READY;
+    hhash->Phase = HAL_HASH_PHASE_READY;
+    hhash->HashInCount = 0U;
+    hhash->Accumulation = 0U;
+    hhash->ErrorCode = HAL_HASH_ERROR_NONE;
+    hhash->Status = HAL_OK;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_HASH_DeInit(HASH_HandleTypeDef *hhash)
+{
+    if (hhash == NULL) {
+        return HAL_ERROR;
+    }
+
+    hhash->State = HAL_HASH_STATE_RESET;
+    hhash->Phase = HAL_HASH_PHASE_READY;
+    memset(&engine, 0, sizeof(engine));
+    return HAL_OK;
+}
+
+HAL_HASH_StateTypeDef HAL_HASH_GetState(HASH_HandleTypeDef *hhash)
+{
+    return hhash->State;
+}
+
+HAL_StatusTypeDef HAL_HASHEx_SHA256_Start(HASH_HandleTypeDef *hhash, uint8_t *pInBuffer, uint32_t Size,
+                                          uint8_t *pOutBuffer, uint32_t Timeout)
+{
+    (void)Timeout;
+
+    if (hhash->State != HAL_HASH_STATE_READY) {
+        return HAL_BUSY;
+    }
+    /* Size 0 is legal: it closes an accumulation or hashes the empty message */
+    if (pInBuffer == NULL || pOutBuffer == NULL) {
+        return HAL_ERROR;
+    }
+
+    /* A pending accumulation is continued, as with the HAL driver */
+    if (hhash->Phase == HAL_HASH_PHASE_READY) {
+        engine_start();
+    }
+
+    hhash->State = HAL_HASH_STATE_BUSY;
+    engine_feed(hhash, pInBuffer, Size);
+    engine_final();
+    read_digest(pOutBuffer);
+
+    hhash->Phase = HAL_HASH_PHASE_READY;
+    hhash->State = HAL_HASH_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_HASHEx_SHA256_Accmlt(HASH_HandleTypeDef *hhash, uint8_t *pInBuffer, uint32_t Size)
+{
+    if ((Size % 4U) != 0U) {
+        return HAL_ERROR;
+    }
+    if (hhash->State != HAL_HASH_STATE_READY) {
+        return HAL_BUSY;
+    }
+    if (pInBuffer == NULL || Size == 0U) {
+        return HAL_ERROR;
+    }
+
+    if (hhash->Phase == HAL_HASH_PHASE_READY) {
+        engine_start();
+        hhash->Phase = HAL_HASH_PHASE_PROCESS;
+    }
+
+    hhash->State = HAL_HASH_STATE_BUSY;
+    engine_feed(hhash, pInBuffer, Size);
+    hhash->Accumulation = 1U;
+    hhash->State = HAL_HASH_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_HASHEx_SHA256_Accmlt_End(HASH_HandleTypeDef *hhash, uint8_t *pInBuffer, uint32_t Size,
+                                               uint8_t *pOutBuffer, uint32_t Timeout)
+{
+    HAL_StatusTypeDef status = HAL_HASHEx_SHA256_Start(hhash, pInBuffer, Size, pOutBuffer, Timeout);
+
+    hhash->Accumulation = 0U;
+    return status;
+}
+
+HAL_StatusTypeDef HAL_HASHEx_SHA256_Finish(HASH_HandleTypeDef *hhash, uint8_t *pOutBuffer, uint32_t Timeout)
+{
+    (void)Timeout;
+
+    if (hhash->State != HAL_HASH_STATE_READY || pOutBuffer == NULL) {
+        return HAL_ERROR;
+    }
+
+    read_digest(pOutBuffer);
+    return HAL_OK;
+}
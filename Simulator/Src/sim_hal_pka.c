@@ -0,0 +1,595 @@
+/**
+  * @file    sim_hal_pka.c
+  * @brief   Host stand-in for the STM32L5 public key accelerator
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    Implements the operations the bootloader issues (ECDSA
+  *          verification and point check) in software for prime-field
+  *          curves of up to 256 bits, taking every curve parameter from the
+  *          HAL input structure like the PKA does. The arithmetic is plain
+  *          Montgomery multiplication on 64-bit limbs; it is written for
+  *          clarity and is not constant-time, which is irrelevant for
+  *          verification of public data on a host.
+  *          HAL_PKA_ECDSAVerif_IT computes the verdict at once but keeps
+  *          the PKA busy for SIM_CYCLES_PKA_ECDSA_VERIF: the verdict is
+  *          published and the completion callback runs from the clock event
+  *          that ends the operation, so the core can work meanwhile.
+  */
+
+#include "stm32l5xx_hal.h"
+#include "sim_platform.h"
+
+#include <string.h>
+
+/* Private defines ------------------------------------------------------*/
+#define BN_LIMBS   4U                  /* 256-bit operands */
+#define BN_BYTES   (BN_LIMBS * 8U)
+
+/* Private types --------------------------------------------------------*/
+typedef struct {
+    uint64_t v[BN_LIMBS];              /* Little-endian limbs */
+} bn_t;
+
+typedef struct {
+    bn_t m;                            /* Odd modulus */
+    bn_t rr;                           /* R^2 mod m, R = 2^256 */
+    bn_t one;                          /* R mod m (Montgomery 1) */
+    uint64_t minv;                     /* -m^-1 mod 2^64 */
+} mont_t;
+
+typedef struct {
+    bn_t x, y, z;                      /* Jacobian, Montgomery domain; z == 0 is infinity */
+} point_t;
+
+typedef struct {
+    const mont_t *f;
+    bn_t a;                            /* Curve coefficient a (Montgomery domain) */
+} curve_t;
+
+/* Private variables ----------------------------------------------------*/
+static uint32_t ecdsa_valid;
+static uint32_t point_on_curve;
+static PKA_HandleTypeDef *it_hpka = NULL;   /* Handle of the operation in flight */
+static uint32_t it_valid;                   /* Its verdict, published at the end */
+
+/* Big number helpers ---------------------------------------------------*/
+
+static bool bn_from_bytes(bn_t *r, const uint8_t *p, uint32_t len)
+{
+    memset(r, 0, sizeof(*r));
+    if (p == NULL || len == 0U || len > BN_BYTES) {
+        return false;
+    }
+    for (uint32_t i = 0U; i < len; i++) {
+        uint32_t bit = 8U * (len - 1U - i);
+        r->v[bit / 64U] |= (uint64_t)p[i] << (bit % 64U);
+    }
+    return true;
+}
+
+static bool bn_is_zero(const bn_t *a)
+{
+    return (a->v[0] | a->v[1] | a->v[2] | a->v[3]) == 0U;
+}
+
+static int bn_cmp(const bn_t *a, const bn_t *b)
+{
+    for (int i = (int)BN_LIMBS - 1; i >= 0; i--) {
+        if (a->v[i] != b->v[i]) {
+            return (a->v[i] > b->v[i]) ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+static uint64_t bn_add(bn_t *r, const bn_t *a, const bn_t *b)
+{
+    unsigned __int128 c = 0;
+
+    for (uint32_t i = 0U; i < BN_LIMBS; i++) {
+        c += (unsigned __int128)a->v[i] + b->v[i];
+        r->v[i] = (uint64_t)c;
+        c >>= 64;
+    }
+    return (uint64_t)c;
+}
+
+static uint64_t bn_sub(bn_t *r, const bn_t *a, const bn_t *b)
+{
+    uint64_t borrow = 0U;
+
+    for (uint32_t i = 0U; i < BN_LIMBS; i++) {
+        uint64_t ai = a->v[i];
+        uint64_t d = ai - b->v[i] - borrow;
+        borrow = (ai < b->v[i] || (ai == b->v[i] && borrow != 0U)) ? 1U : 0U;
+        r->v[i] = d;
+    }
+    return borrow;
+}
+
+static void mod_add(bn_t *r, const bn_t *a, const bn_t *b, const bn_t *m)
+{
+    uint64_t carry = bn_add(r, a, b);
+
+    if (carry != 0U || bn_cmp(r, m) >= 0) {
+        (void)bn_sub(r, r, m);
+    }
+}
+
+static void mod_sub(bn_t *r, const bn_t *a, const bn_t *b, const bn_t *m)
+{
+    if (bn_sub(r, a, b) != 0U) {
+        (void)bn_add(r, r, m);
+    }
+}
+
+/* Montgomery arithmetic ------------------------------------------------*/
+
+static void mont_mul(bn_t *r, const bn_t *a, const bn_t *b, const mont_t *f)
+{
+    uint64_t t[BN_LIMBS + 2U] = { 0U };
+
+    for (uint32_t i = 0U; i < BN_LIMBS; i++) {
+        unsigned __int128 c = 0;
+        uint64_t q;
+
+        for (uint32_t j = 0U; j < BN_LIMBS; j++) {
+            c += (unsigned __int128)a->v[j] * b->v[i] + t[j];
+            t[j] = (uint64_t)c;
+            c >>= 64;
+        }
+        c += t[BN_LIMBS];
+        t[BN_LIMBS] = (uint64_t)c;
+        t[BN_LIMBS + 1U] = (uint64_t)(c >> 64);
+
+        q = t[0] * f->minv;
+        c = (unsigned __int128)q * f->m.v[0] + t[0];
+        c >>= 64;
+        for (uint32_t j = 1U; j < BN_LIMBS; j++) {
+            c += (unsigned __int128)q * f->m.v[j] + t[j];
+            t[j - 1U] = (uint64_t)c;
+            c >>= 64;
+        }
+        c += t[BN_LIMBS];
+        t[BN_LIMBS - 1U] = (uint64_t)c;
+        t[BN_LIMBS] = t[BN_LIMBS + 1U] + (uint64_t)(c >> 64);
+    }
+
+    memcpy(r->v, t, sizeof(r->v));
+    if (t[BN_LIMBS] != 0U || bn_cmp(r, &f->m) >= 0) {
+        (void)bn_sub(r, r, &f->m);
+    }
+}
+
+static bool mont_setup(mont_t *f, const uint8_t *modulus, uint32_t len)
+{
+    uint64_t inv = 1U;
+
+    if (!bn_from_bytes(&f->m, modulus, len) || (f->m.v[0] & 1U) == 0U) {
+        return false;
+    }
+
+    /* Newton iteration for m^-1 mod 2^64 */
+    for (uint32_t i = 0U; i < 6U; i++) {
+        inv *= 2U - f->m.v[0] * inv;
+    }
+    f->minv = (uint64_t)0U - inv;
+
+    /* R^2 mod m by doubling 1 512 times */
+    memset(&f->rr, 0, sizeof(f->rr));
+    f->rr.v[0] = 1U;
+    for (uint32_t i = 0U; i < 2U * 64U * BN_LIMBS; i++) {
+        mod_add(&f->rr, &f->rr, &f->rr, &f->m);
+    }
+
+    memset(&f->one, 0, sizeof(f->one));
+    f->one.v[0] = 1U;
+    mont_mul(&f->one, &f->one, &f->rr, f);
+    return true;
+}
+
+static void to_mont(bn_t *r, const bn_t *a, const mont_t *f)
+{
+    mont_mul(r, a, &f->rr, f);
+}
+
+static void from_mont(bn_t *r, const bn_t *a, const mont_t *f)
+{
+    bn_t one = { { 1U, 0U, 0U, 0U } };
+
+    mont_mul(r, a, &one, f);
+}
+
+/**
+  * @brief  Inverse of a (Montgomery domain) by Fermat, modulus must be prime
+  */
+static void mont_inv(bn_t *r, const bn_t *a, const mont_t *f)
+{
+    bn_t e;
+    bn_t two = { { 2U, 0U, 0U, 0U } };
+    bn_t acc = f->one;
+
+    (void)bn_sub(&e, &f->m, &two);
+    for (int i = (int)(64U * BN_LIMBS) - 1; i >= 0; i--) {
+        mont_mul(&acc, &acc, &acc, f);
+        if (((e.v[i / 64] >> (i % 64)) & 1U) != 0U) {
+            mont_mul(&acc, &acc, a, f);
+        }
+    }
+    *r = acc;
+}
+
+/* Curve arithmetic (Jacobian coordinates) ------------------------------*/
+
+static void point_double(point_t *r, const point_t *p, const curve_t *c)
+{
+    const mont_t *f = c->f;
+    const bn_t *m = &f->m;
+    bn_t xx, yy, yyyy, zz, s, mm, t;
+
+    if (bn_is_zero(&p->z) || bn_is_zero(&p->y)) {
+        memset(r, 0, sizeof(*r));
+        return;
+    }
+
+    mont_mul(&xx, &p->x, &p->x, f);
+    mont_mul(&yy, &p->y, &p->y, f);
+    mont_mul(&yyyy, &yy, &yy, f);
+    mont_mul(&zz, &p->z, &p->z, f);
+
+    /* S = 4*X*Y^2 */
+    mont_mul(&s, &p->x, &yy, f);
+    mod_add(&s, &s, &s, m);
+    mod_add(&s, &s, &s, m);
+
+    /* M = 3*X^2 + a*Z^4 */
+    mod_add(&mm, &xx, &xx, m);
+    mod_add(&mm, &mm, &xx, m);
+    mont_mul(&t, &zz, &zz, f);
+    mont_mul(&t, &t, &c->a, f);
+    mod_add(&mm, &mm, &t, m);
+
+    /* Z' = 2*Y*Z */
+    mont_mul(&r->z, &p->y, &p->z, f);
+    mod_add(&r->z, &r->z, &r->z, m);
+
+    /* X' = M^2 - 2*S */
+    mont_mul(&t, &mm, &mm, f);
+    mod_sub(&t, &t, &s, m);
+    mod_sub(&r->x, &t, &s, m);
+
+    /* Y' = M*(S - X') - 8*Y^4 */
+    mod_sub(&s, &s, &r->x, m);
+    mont_mul(&t, &mm, &s, f);
+    mod_add(&yyyy, &yyyy, &yyyy, m);
+    mod_add(&yyyy, &yyyy, &yyyy, m);
+    mod_add(&yyyy, &yyyy, &yyyy, m);
+    mod_sub(&r->y, &t, &yyyy, m);
+}
+
+static void point_add(point_t *r, const point_t *p, const point_t *q, const curve_t *c)
+{
+    const mont_t *f = c->f;
+    const bn_t *m = &f->m;
+    bn_t z1z1, z2z2, u1, u2, s1, s2, h, rr, hh, hhh, v, t;
+
+    if (bn_is_zero(&p->z)) {
+        *r = *q;
+        return;
+    }
+    if (bn_is_zero(&q->z)) {
+        *r = *p;
+        return;
+    }
+
+    mont_mul(&z1z1, &p->z, &p->z, f);
+    mont_mul(&z2z2, &q->z, &q->z, f);
+    mont_mul(&u1, &p->x, &z2z2, f);
+    mont_mul(&u2, &q->x, &z1z1, f);
+    mont_mul(&s1, &p->y, &q->z, f);
+    mont_mul(&s1, &s1, &z2z2, f);
+    mont_mul(&s2, &q->y, &p->z, f);
+    mont_mul(&s2, &s2, &z1z1, f);
+
+    mod_sub(&h, &u2, &u1, m);
+    mod_sub(&rr, &s2, &s1, m);
+
+    if (bn_is_zero(&h)) {
+        if (bn_is_zero(&rr)) {
+            point_double(r, p, c);
+        } else {
+            memset(r, 0, sizeof(*r));
+        }
+        return;
+    }
+
+    mont_mul(&hh, &h, &h, f);
+    mont_mul(&hhh, &hh, &h, f);
+    mont_mul(&v, &u1, &hh, f);
+
+    /* X3 = R^2 - H^3 - 2*V */
+    mont_mul(&t, &rr, &rr, f);
+    mod_sub(&t, &t, &hhh, m);
+    mod_sub(&t, &t, &v, m);
+    mod_sub(&t, &t, &v, m);
+
+    /* Y3 = R*(V - X3) - S1*H^3 */
+    mod_sub(&v, &v, &t, m);
+    mont_mul(&v, &rr, &v, f);
+    mont_mul(&s1, &s1, &hhh, f);
+    mod_sub(&r->y, &v, &s1, m);
+
+    /* Z3 = Z1*Z2*H */
+    mont_mul(&r->z, &p->z, &q->z, f);
+    mont_mul(&r->z, &r->z, &h, f);
+    r->x = t;
+}
+
+static bool load_affine(point_t *p, const uint8_t *x, const uint8_t *y, uint32_t len, const mont_t *f)
+{
+    bn_t bx, by;
+
+    if (!bn_from_bytes(&bx, x, len) || !bn_from_bytes(&by, y, len)) {
+        return false;
+    }
+    if (bn_cmp(&bx, &f->m) >= 0 || bn_cmp(&by, &f->m) >= 0) {
+        return false;
+    }
+    to_mont(&p->x, &bx, f);
+    to_mont(&p->y, &by, f);
+    p->z = f->one;
+    return true;
+}
+
+static bool load_coef(bn_t *r, const uint8_t *abs, uint32_t sign, uint32_t len, const mont_t *f)
+{
+    bn_t v;
+
+    if (!bn_from_bytes(&v, abs, len) || bn_cmp(&v, &f->m) >= 0) {
+        return false;
+    }
+    if (sign != 0U && !bn_is_zero(&v)) {
+        (void)bn_sub(&v, &f->m, &v);
+    }
+    to_mont(r, &v, f);
+    return true;
+}
+
+/* Operations -----------------------------------------------------------*/
+
+static bool ecdsa_verify(const PKA_ECDSAVerifInTypeDef *in)
+{
+    mont_t fp, fn;
+    curve_t curve;
+    bn_t r, s, e, w, u1, u2, x;
+    point_t g, q, gq, acc;
+
+    if (in->primeOrderSize > BN_BYTES || in->modulusSize > BN_BYTES) {
+        return false;
+    }
+    if (!mont_setup(&fp, in->modulus, in->modulusSize) ||
+        !mont_setup(&fn, in->primeOrder, in->primeOrderSize)) {
+        return false;
+    }
+
+    curve.f = &fp;
+    if (!load_coef(&curve.a, in->coef, in->coefSign, in->modulusSize, &fp)) {
+        return false;
+    }
+
+    /* 0 < r, s < n */
+    if (!bn_from_bytes(&r, in->RSign, in->primeOrderSize) ||
+        !bn_from_bytes(&s, in->SSign, in->primeOrderSize) ||
+        !bn_from_bytes(&e, in->hash, in->primeOrderSize)) {
+        return false;
+    }
+    if (bn_is_zero(&r) || bn_is_zero(&s) || bn_cmp(&r, &fn.m) >= 0 || bn_cmp(&s, &fn.m) >= 0) {
+        return false;
+    }
+    if (bn_cmp(&e, &fn.m) >= 0) {
+        (void)bn_sub(&e, &e, &fn.m);
+    }
+
+    /* w = s^-1, u1 = e*w, u2 = r*w (mod n) */
+    to_mont(&w, &s, &fn);
+    mont_inv(&w, &w, &fn);
+    mont_mul(&u1, &e, &w, &fn);        /* e plain x w mont -> plain */
+    mont_mul(&u2, &r, &w, &fn);
+
+    if (!load_affine(&g, in->basePointX, in->basePointY, in->modulusSize, &fp) ||
+        !load_affine(&q, in->pPubKeyCurvePtX, in->pPubKeyCurvePtY, in->modulusSize, &fp)) {
+        return false;
+    }
+
+    /* Shamir's trick: u1*G + u2*Q in one double-and-add pass */
+    point_add(&gq, &g, &q, &curve);
+    memset(&acc, 0, sizeof(acc));
+    for (int i = (int)(64U * BN_LIMBS) - 1; i >= 0; i--) {
+        uint32_t b1 = (uint32_t)((u1.v[i / 64] >> (i % 64)) & 1U);
+        uint32_t b2 = (uint32_t)((u2.v[i / 64] >> (i % 64)) & 1U);
+
+        point_double(&acc, &acc, &curve);
+        if (b1 != 0U && b2 != 0U) {
+            point_add(&acc, &acc, &gq, &curve);
+        } else if (b1 != 0U) {
+            point_add(&acc, &acc, &g, &curve);
+        } else if (b2 != 0U) {
+            point_add(&acc, &acc, &q, &curve);
+        }
+    }
+
+    if (bn_is_zero(&acc.z)) {
+        return false;
+    }
+
+    /* x = X / Z^2, compared with r mod n */
+    mont_inv(&w, &acc.z, &fp);
+    mont_mul(&w, &w, &w, &fp);
+    mont_mul(&x, &acc.x, &w, &fp);
+    from_mont(&x, &x, &fp);
+    if (bn_cmp(&x, &fn.m) >= 0) {
+        (void)bn_sub(&x, &x, &fn.m);
+    }
+
+    return bn_cmp(&x, &r) == 0;
+}
+
+static bool point_check(const PKA_PointCheckInTypeDef *in)
+{
+    mont_t fp;
+    bn_t a, b, x, y, lhs, rhs, t;
+    point_t p;
+
+    if (!mont_setup(&fp, in->modulus, in->modulusSize) ||
+        !load_coef(&a, in->coefA, in->coefSign, in->modulusSize, &fp) ||
+        !load_coef(&b, in->coefB, 0U, in->modulusSize, &fp) ||
+        !load_affine(&p, in->pointX, in->pointY, in->modulusSize, &fp)) {
+        return false;
+    }
+    x = p.x;
+    y = p.y;
+
+    /* y^2 == x^3 + a*x + b */
+    mont_mul(&lhs, &y, &y, &fp);
+    mont_mul(&rhs, &x, &x, &fp);
+    mont_mul(&rhs, &rhs, &x, &fp);
+    mont_mul(&t, &a, &x, &fp);
+    mod_add(&rhs, &rhs, &t, &fp.m);
+    mod_add(&rhs, &rhs, &b, &fp.m);
+
+    return bn_cmp(&lhs, &rhs) == 0;
+}
+
+/* Exported functions ---------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_PKA_Init(PKA_HandleTypeDef *hpka)
+{
+    if (hpka == NULL) {
+        return HAL_ERROR;
+    }
+
+    hpka->State = HAL_PKA_STATE_READY;
+    hpka->ErrorCode = HAL_PKA_ERROR_NONE;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PKA_DeInit(PKA_HandleTypeDef *hpka)
+{
+    if (hpka == NULL) {
+        return HAL_ERROR;
+    }
+
+    hpka->State = HAL_PKA_STATE_RESET;
+    hpka->ErrorCode = HAL_PKA_ERROR_NONE;
+    ecdsa_valid = 0U;
+    point_on_curve = 0U;
+    it_hpka = NULL;
+    return HAL_OK;
+}
+
+HAL_PKA_StateTypeDef HAL_PKA_GetState(const PKA_HandleTypeDef *hpka)
+{
+    return hpka->State;
+}
+
+uint32_t HAL_PKA_GetError(const PKA_HandleTypeDef *hpka)
+{
+    return hpka->ErrorCode;
+}
+
+HAL_StatusTypeDef HAL_PKA_ECDSAVerif(PKA_HandleTypeDef *hpka, PKA_ECDSAVerifInTypeDef *in, uint32_t Timeout)
+{
+    (void)Timeout;
+
+    if (hpka == NULL || in == NULL) {
+        return HAL_ERROR;
+    }
+    if (hpka->State != HAL_PKA_STATE_READY) {
+        return HAL_BUSY;
+    }
+
+    hpka->State = HAL_PKA_STATE_BUSY;
+    ecdsa_valid = ecdsa_verify(in) ? 1U : 0U;
+    SIM_Account(SIM_ENGINE_PKA, NULL, 4U * in->modulusSize + 3U * in->primeOrderSize,
+                SIM_CYCLES_PKA_ECDSA_VERIF);
+    hpka->State = HAL_PKA_STATE_READY;
+    return HAL_OK;
+}
+
+static void pka_irq_event(void)
+{
+    /* On silicon the NVIC enters PKA_IRQHandler, which calls this */
+    if (it_hpka != NULL) {
+        HAL_PKA_IRQHandler(it_hpka);
+    }
+}
+
+HAL_StatusTypeDef HAL_PKA_ECDSAVerif_IT(PKA_HandleTypeDef *hpka, PKA_ECDSAVerifInTypeDef *in)
+{
+    if (hpka == NULL || in == NULL) {
+        return HAL_ERROR;
+    }
+    if (hpka->State != HAL_PKA_STATE_READY) {
+        return HAL_BUSY;
+    }
+
+    hpka->State = HAL_PKA_STATE_BUSY;
+    it_hpka = hpka;
+    it_valid = ecdsa_verify(in) ? 1U : 0U;
+    SIM_Account_Background(SIM_ENGINE_PKA, 4U * in->modulusSize + 3U * in->primeOrderSize,
+                           SIM_CYCLES_PKA_ECDSA_VERIF);
+    SIM_Event_Schedule(SIM_Clock_Cycles() + SIM_CYCLES_PKA_ECDSA_VERIF, pka_irq_event);
+    return HAL_OK;
+}
+
+void HAL_PKA_IRQHandler(PKA_HandleTypeDef *hpka)
+{
+    if (hpka == NULL || hpka != it_hpka) {
+        return;
+    }
+    it_hpka = NULL;
+    ecdsa_valid = it_valid;
+    hpka->State = HAL_PKA_STATE_READY;
+    HAL_PKA_OperationCpltCallback(hpka);
+}
+
+__weak void HAL_PKA_OperationCpltCallback(PKA_HandleTypeDef *hpka)
+{
+    (void)hpka;
+}
+
+__weak void HAL_PKA_ErrorCallback(PKA_HandleTypeDef *hpka)
+{
+    (void)hpka;
+}
+
+uint32_t HAL_PKA_ECDSAVerif_IsValidSignature(PKA_HandleTypeDef const *const hpka)
+{
+    (void)hpka;
+    return ecdsa_valid;
+}
+
+HAL_StatusTypeDef HAL_PKA_PointCheck(PKA_HandleTypeDef *hpka, PKA_PointCheckInTypeDef *in, uint32_t Timeout)
+{
+    (void)Timeout;
+
+    if (hpka == NULL || in == NULL) {
+        return HAL_ERROR;
+    }
+    if (hpka->State != HAL_PKA_STATE_READY) {
+        return HAL_BUSY;
+    }
+
+    hpka->State = HAL_PKA_STATE_BUSY;
+    point_on_curve = point_check(in) ? 1U : 0U;
+    SIM_Account(SIM_ENGINE_PKA, NULL, 5U * in->modulusSize, SIM_CYCLES_PKA_POINT_CHECK);
+    hpka->State = HAL_PKA_STATE_READY;
+    return HAL_OK;
+}
+
+uint32_t HAL_PKA_PointCheck_IsOnCurve(PKA_HandleTypeDef const *const hpka)
+{
+    (void)hpka;
+    return point_on_curve;
+}
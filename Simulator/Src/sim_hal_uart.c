@@ -0,0 +1,355 @@
+/**
+  * @file    sim_hal_uart.c
+  * @brief   Host stand-in for USART1 and its receive DMA channel
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    Transmit goes to stdout, or to the host line once one is
+  *          attached with SIM_Uart_Attach (a tty, or a new pty pair for a
+  *          host tool). Receive is modelled for circular DMA only, the way
+  *          secboot_transfer.c uses it: bytes from the line are written to
+  *          the ring and CNDTR counts down, no faster than the programmed
+  *          baud rate allows for the modelled time that passed. Nothing
+  *          happens behind the core's back: the line is serviced from
+  *          SIM_Core_WaitForInterrupt, which is where firmware waiting for
+  *          data ends up. Bytes arriving without a receiver are lost, as
+  *          on silicon.
+  *          DMA transmit writes the bytes at once but holds the UART busy
+  *          for their line time; the transmit-complete callback runs from
+  *          SIM_Uart_Service once that time has passed.
+  */
+
+#include "stm32l5xx_hal.h"
+#include "sim_platform.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+/* Private variables ----------------------------------------------------*/
+static int line_fd = -1;                   /* Host side of the serial line */
+static int line_peer_fd = -1;              /* Pty: our handle on the host end */
+static uint64_t line_nanos = 0;            /* Line time received up to */
+static uint32_t line_baud = 0;             /* Last baud rate programmed */
+static UART_HandleTypeDef *rx_huart = NULL;  /* Receiver with DMA running */
+static UART_HandleTypeDef *tx_huart = NULL;  /* Transmitter with DMA running */
+static uint64_t tx_start_nanos = 0;        /* When it started */
+static uint64_t tx_done_nanos = 0;         /* When its last byte leaves */
+
+/* Private functions ----------------------------------------------------*/
+
+static void make_raw(int fd)
+{
+    struct termios tio;
+
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        (void)tcsetattr(fd, TCSANOW, &tio);
+    }
+}
+
+/**
+  * @brief  Store one received byte where the DMA would, wrapping the ring
+  */
+static void dma_store(uint8_t byte)
+{
+    DMA_HandleTypeDef *hdma = rx_huart->hdmarx;
+    uint32_t remaining = hdma->Instance->CNDTR;
+
+    rx_huart->pRxBuffPtr[rx_huart->RxXferSize - remaining] = byte;
+    hdma->Instance->CNDTR = (remaining > 1U) ? remaining - 1U : rx_huart->RxXferSize;
+}
+
+/* 10 bit times per character (8N1) */
+static uint64_t line_time_nanos(const UART_HandleTypeDef *huart, uint32_t length)
+{
+    return (huart->Init.BaudRate != 0U) ? ((uint64_t)length * 10000000000ULL) / huart->Init.BaudRate : 0U;
+}
+
+static void line_write(const uint8_t *pData, size_t length)
+{
+    while (length > 0U) {
+        ssize_t n = write(line_fd, pData, length);
+
+        if (n < 0) {
+            struct pollfd pfd = { .fd = line_fd, .events = POLLOUT };
+
+            /* Host not reading: wait, but do not hang the run on a dead line */
+            if (poll(&pfd, 1, 1000) <= 0) {
+                return;
+            }
+            continue;
+        }
+        pData += n;
+        length -= (size_t)n;
+    }
+}
+
+/* Line -----------------------------------------------------------------*/
+
+int SIM_Uart_Attach(const char *path)
+{
+    int fd;
+
+    if (strcmp(path, "pty") == 0) {
+        const char *name;
+
+        fd = posix_openpt(O_RDWR | O_NOCTTY);
+        if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0 || (name = ptsname(fd)) == NULL) {
+            return -1;
+        }
+        /* Holding the host end open keeps the line up across host tool restarts */
+        line_peer_fd = open(name, O_RDWR | O_NOCTTY);
+        if (line_peer_fd < 0) {
+            close(fd);
+            return -1;
+        }
+        make_raw(line_peer_fd);
+        fprintf(stderr, "sim: UART on %s\n", name);
+    } else {
+        fd = open(path, O_RDWR | O_NOCTTY);
+        if (fd < 0) {
+            return -1;
+        }
+        if (isatty(fd)) {
+            make_raw(fd);
+        }
+    }
+
+    (void)fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    line_fd = fd;
+    line_nanos = SIM_Clock_Nanos();
+    return 0;
+}
+
+void SIM_Uart_Detach(void)
+{
+    if (line_peer_fd >= 0) {
+        int pending = 0;
+
+        /* Hanging up a pty drops what the host has not read yet: give it a second */
+        for (int i = 0; i < 100 && ioctl(line_peer_fd, FIONREAD, &pending) == 0 && pending > 0; i++) {
+            usleep(10000);
+        }
+        close(line_peer_fd);
+    } else if (line_fd >= 0) {
+        (void)tcdrain(line_fd);
+    }
+    if (line_fd >= 0) {
+        close(line_fd);
+    }
+    line_fd = -1;
+    line_peer_fd = -1;
+}
+
+bool SIM_Uart_Wait(uint32_t us)
+{
+    struct pollfd pfd = { .fd = line_fd, .events = POLLIN };
+
+    if (line_fd < 0) {
+        return false;
+    }
+    return poll(&pfd, 1, (int)((us + 999U) / 1000U)) > 0;
+}
+
+void SIM_Uart_Service(void)
+{
+    uint64_t now = SIM_Clock_Nanos();
+    uint64_t budget;
+    uint64_t taken = 0;
+
+    if (tx_huart != NULL && (now >= tx_done_nanos || now < tx_start_nanos)) {
+        UART_HandleTypeDef *huart = tx_huart;
+
+        tx_huart = NULL;
+        huart->gState = HAL_UART_STATE_READY;
+        if (huart->hdmatx != NULL) {
+            huart->hdmatx->State = HAL_DMA_STATE_READY;
+        }
+        HAL_UART_TxCpltCallback(huart);
+    }
+
+    if (line_fd < 0 || line_baud == 0U) {
+        return;
+    }
+    if (now < line_nanos) {
+        line_nanos = now;     /* Clock reset by a new power cycle */
+    }
+
+    /* 10 bit times per character (8N1) */
+    budget = ((now - line_nanos) * line_baud) / 10000000000ULL;
+    while (taken < budget) {
+        uint8_t buf[256];
+        size_t want = (budget - taken < sizeof(buf)) ? (size_t)(budget - taken) : sizeof(buf);
+        ssize_t n = read(line_fd, buf, want);
+
+        if (n <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < n; i++) {
+            if (rx_huart != NULL) {
+                dma_store(buf[i]);
+            }
+        }
+        taken += (uint64_t)n;
+    }
+
+    /* An idle line builds up no credit */
+    if (taken < budget) {
+        line_nanos = now;
+    } else {
+        line_nanos += (taken * 10000000000ULL) / line_baud;
+    }
+}
+
+/* UART -----------------------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
+{
+    if (huart == NULL) {
+        return HAL_ERROR;
+    }
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    line_baud = huart->Init.BaudRate;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_SetTxFifoThreshold(UART_HandleTypeDef *huart, uint32_t Threshold)
+{
+    (void)Threshold;
+    return (huart == NULL) ? HAL_ERROR : HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_SetRxFifoThreshold(UART_HandleTypeDef *huart, uint32_t Threshold)
+{
+    (void)Threshold;
+    return (huart == NULL) ? HAL_ERROR : HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_DisableFifoMode(UART_HandleTypeDef *huart)
+{
+    return (huart == NULL) ? HAL_ERROR : HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+
+    if (huart == NULL || pData == NULL || Size == 0U) {
+        return HAL_ERROR;
+    }
+
+    /* 10 bit times per character (8N1) */
+    if (huart->Init.BaudRate != 0U) {
+        SIM_Clock_Advance(SIM_Clock_UsToCycles((uint32_t)(((uint64_t)Size * 10U * 1000000U) / huart->Init.BaudRate)));
+    }
+
+    if (line_fd >= 0) {
+        line_write(pData, Size);
+    } else if (SIM_Console_Enabled()) {
+        fwrite(pData, 1, Size, stdout);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    if (huart == NULL || pData == NULL || Size == 0U || huart->hdmatx == NULL) {
+        return HAL_ERROR;
+    }
+    if (huart->gState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+
+    if (line_fd >= 0) {
+        line_write(pData, Size);
+    } else if (SIM_Console_Enabled()) {
+        fwrite(pData, 1, Size, stdout);
+    }
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    huart->hdmatx->State = HAL_DMA_STATE_BUSY;
+    tx_huart = huart;
+    tx_start_nanos = SIM_Clock_Nanos();
+    tx_done_nanos = tx_start_nanos + line_time_nanos(huart, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    if (huart == NULL || pData == NULL || Size == 0U || huart->hdmarx == NULL) {
+        return HAL_ERROR;
+    }
+    if (huart->RxState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    huart->hdmarx->Instance->CNDTR = Size;
+    huart->hdmarx->State = HAL_DMA_STATE_BUSY;
+    rx_huart = huart;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_DMAStop(UART_HandleTypeDef *huart)
+{
+    if (huart == NULL) {
+        return HAL_ERROR;
+    }
+    if (huart->hdmarx != NULL) {
+        huart->hdmarx->State = HAL_DMA_STATE_READY;
+    }
+    huart->RxState = HAL_UART_STATE_READY;
+    if (rx_huart == huart) {
+        rx_huart = NULL;
+    }
+    if (tx_huart == huart) {
+        huart->gState = HAL_UART_STATE_READY;
+        tx_huart = NULL;
+    }
+    return HAL_OK;
+}
+
+__weak void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
+
+/* DMA ------------------------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+    if (hdma == NULL || hdma->Instance == NULL) {
+        return HAL_ERROR;
+    }
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma)
+{
+    if (hdma == NULL || hdma->Instance == NULL) {
+        return HAL_ERROR;
+    }
+    hdma->Instance->CNDTR = 0U;
+    hdma->State = HAL_DMA_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_ConfigChannelAttributes(DMA_HandleTypeDef *hdma, uint32_t ChannelAttributes)
+{
+    (void)ChannelAttributes;
+    return (hdma == NULL) ? HAL_ERROR : HAL_OK;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;     /* Transfers complete from SIM_Uart_Service */
+}
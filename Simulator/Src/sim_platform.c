@@ -0,0 +1,591 @@
+/**
+  * @file    sim_platform.c
+  * @brief   Host boot simulator platform model for STM32L562
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @details Owns the emulated address space and the modelled clock:
+  *          - the flash image is one file (or memfd) mapped read-only at
+  *            the non-secure and secure aliases, plus one private writable
+  *            view used by the flash programming stand-in and the loader
+  *          - peripheral and system control space windows are anonymous
+  *            zero-filled mappings so HAL register macros land somewhere
+  *          - SIM_Run executes the secure entry point under a host
+  *            watchdog and turns the non-secure jump, stray stores and
+  *            endless loops into a SIM_BootResult
+  *          - SIM_Power_Cycle runs a power cycle in a forked child: the
+  *            shared flash mapping survives it, RAM does not
+  */
+
+#include "sim_platform.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE        0x100000
+#endif
+
+/* Private types --------------------------------------------------------*/
+typedef struct {
+    uintptr_t base;
+    size_t size;
+} SIM_Window;
+
+/** Completion interrupt of one event source */
+typedef struct {
+    uint64_t at;
+    void (*handler)(void);
+} SIM_Event;
+
+/* Private variables ----------------------------------------------------*/
+static int flash_fd = -1;
+static uint8_t *flash_rw = NULL;          /* Writable view of the flash image */
+static bool platform_up = false;
+
+static const SIM_Window windows[] = {
+    { SIM_PERIPH_NS_BASE, SIM_PERIPH_SIZE },
+    { SIM_PERIPH_S_BASE,  SIM_PERIPH_SIZE },
+    { SIM_SCS_BASE,       SIM_SCS_SIZE },
+    { SIM_SCS_NS_BASE,    SIM_SCS_SIZE },
+    { SIM_DEVINFO_BASE,   SIM_DEVINFO_SIZE },
+};
+
+static uint64_t clock_cycles = 0;
+static uint64_t clock_nanos = 0;
+static uint32_t core_clock_hz = 4000000U;  /* MSI after reset */
+static SIM_EngineStats engine_stats[SIM_ENGINE_COUNT];
+
+static SIM_Event events[SIM_EVENT_SOURCES];   /* handler NULL: free */
+static int flash_busy_bank = -1;
+static uint64_t flash_operations = 0;
+static uint64_t power_cut_at = SIM_POWER_CUT_NEVER;
+
+static const char *const engine_names[SIM_ENGINE_COUNT] = {
+    "CRC", "HASH", "CRYP", "PKA", "FLASH-PROG", "FLASH-ERASE"
+};
+
+static bool console_enabled = true;
+
+static sigjmp_buf run_env;
+static volatile sig_atomic_t run_active = 0;
+static SIM_BootResult *run_result = NULL;
+static uint8_t alt_stack[64 * 1024];
+
+/* Private functions ----------------------------------------------------*/
+
+static int map_fixed(uintptr_t base, size_t size, int prot, int flags, int fd)
+{
+    void *p = mmap((void *)base, size, prot, flags | MAP_FIXED_NOREPLACE, fd, 0);
+    if (p == MAP_FAILED) {
+        return -1;
+    }
+    if ((uintptr_t)p != base) {
+        /* Kernels before 4.17 treat the flag as a hint only */
+        munmap(p, size);
+        errno = EEXIST;
+        return -1;
+    }
+    return 0;
+}
+
+static void run_signal_handler(int sig, siginfo_t *info, void *uctx)
+{
+    (void)uctx;
+
+    if (!run_active || run_result == NULL) {
+        signal(sig, SIG_DFL);
+        raise(sig);
+        return;
+    }
+
+    if (sig == SIGALRM) {
+        run_result->outcome = SIM_BOOT_HANG;
+    } else {
+        run_result->outcome = SIM_BOOT_FAULT;
+        run_result->fault_addr = (uintptr_t)info->si_addr;
+    }
+    siglongjmp(run_env, 1);
+}
+
+/* Platform API ---------------------------------------------------------*/
+
+int SIM_Platform_Init(const char *flash_path)
+{
+    struct stat st;
+
+    if (platform_up) {
+        return 0;
+    }
+
+    if (flash_path != NULL) {
+        flash_fd = open(flash_path, O_RDWR | O_CREAT, 0644);
+    } else {
+        flash_fd = memfd_create("secboot-flash", 0);
+    }
+    if (flash_fd < 0) {
+        return -1;
+    }
+
+    if (fstat(flash_fd, &st) != 0) {
+        goto fail;
+    }
+
+    if ((size_t)st.st_size < SIM_FLASH_SIZE) {
+        if (ftruncate(flash_fd, SIM_FLASH_SIZE) != 0) {
+            goto fail;
+        }
+    }
+
+    flash_rw = mmap(NULL, SIM_FLASH_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, flash_fd, 0);
+    if (flash_rw == MAP_FAILED) {
+        flash_rw = NULL;
+        goto fail;
+    }
+
+    /* Bytes past the old end of file read as zero: bring them to the erased state */
+    if ((size_t)st.st_size < SIM_FLASH_SIZE) {
+        memset(flash_rw + st.st_size, SIM_FLASH_ERASED_BYTE, SIM_FLASH_SIZE - (size_t)st.st_size);
+    }
+
+    /* The CPU only reads flash; programming goes through HAL_FLASH_Program */
+    if (map_fixed(SIM_FLASH_NS_BASE, SIM_FLASH_SIZE, PROT_READ, MAP_SHARED, flash_fd) != 0) {
+        goto fail;
+    }
+    if (map_fixed(SIM_FLASH_S_BASE, SIM_FLASH_SIZE, PROT_READ, MAP_SHARED, flash_fd) != 0) {
+        munmap((void *)SIM_FLASH_NS_BASE, SIM_FLASH_SIZE);
+        goto fail;
+    }
+
+    for (size_t i = 0; i < sizeof(windows) / sizeof(windows[0]); i++) {
+        if (map_fixed(windows[i].base, windows[i].size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1) != 0) {
+            while (i-- > 0) {
+                munmap((void *)windows[i].base, windows[i].size);
+            }
+            munmap((void *)SIM_FLASH_NS_BASE, SIM_FLASH_SIZE);
+            munmap((void *)SIM_FLASH_S_BASE, SIM_FLASH_SIZE);
+            goto fail;
+        }
+    }
+
+    /* Device information page: flash size in KB, package, default UID */
+    *(volatile uint16_t *)(SIM_DEVINFO_BASE + 0x5E0UL) = (uint16_t)(SIM_FLASH_SIZE / 1024);
+    platform_up = true;
+    SIM_Platform_SetUID(SIM_DEFAULT_UID_W0, SIM_DEFAULT_UID_W1, SIM_DEFAULT_UID_W2);
+    SIM_Stats_Reset();
+    return 0;
+
+fail:
+    if (flash_rw != NULL) {
+        munmap(flash_rw, SIM_FLASH_SIZE);
+        flash_rw = NULL;
+    }
+    close(flash_fd);
+    flash_fd = -1;
+    return -1;
+}
+
+void SIM_Platform_DeInit(void)
+{
+    if (!platform_up) {
+        return;
+    }
+
+    for (size_t i = 0; i < sizeof(windows) / sizeof(windows[0]); i++) {
+        munmap((void *)windows[i].base, windows[i].size);
+    }
+    munmap((void *)SIM_FLASH_NS_BASE, SIM_FLASH_SIZE);
+    munmap((void *)SIM_FLASH_S_BASE, SIM_FLASH_SIZE);
+    msync(flash_rw, SIM_FLASH_SIZE, MS_SYNC);
+    munmap(flash_rw, SIM_FLASH_SIZE);
+    flash_rw = NULL;
+    close(flash_fd);
+    flash_fd = -1;
+    platform_up = false;
+}
+
+void SIM_Platform_SetUID(uint32_t w0, uint32_t w1, uint32_t w2)
+{
+    volatile uint32_t *uid = (volatile uint32_t *)(SIM_DEVINFO_BASE + 0x590UL);
+
+    uid[0] = w0;
+    uid[1] = w1;
+    uid[2] = w2;
+}
+
+void SIM_Flash_MassErase(void)
+{
+    memset(flash_rw, SIM_FLASH_ERASED_BYTE, SIM_FLASH_SIZE);
+}
+
+long SIM_Flash_LoadFile(const char *path, uint32_t address)
+{
+    FILE *f = fopen(path, "rb");
+    long loaded = 0;
+    size_t n;
+    uint8_t buf[4096];
+
+    if (f == NULL) {
+        return -1;
+    }
+
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        uint8_t *dst = SIM_Flash_Backing(address + (uint32_t)loaded, (uint32_t)n);
+        if (dst == NULL) {
+            fclose(f);
+            errno = EFBIG;
+            return -1;
+        }
+        memcpy(dst, buf, n);
+        loaded += (long)n;
+    }
+
+    fclose(f);
+    return loaded;
+}
+
+uint8_t *SIM_Flash_Backing(uint32_t address, uint32_t length)
+{
+    uint32_t offset;
+
+    if (address >= SIM_FLASH_NS_BASE && address < SIM_FLASH_NS_BASE + SIM_FLASH_SIZE) {
+        offset = address - SIM_FLASH_NS_BASE;
+    } else if (address >= SIM_FLASH_S_BASE && address < SIM_FLASH_S_BASE + SIM_FLASH_SIZE) {
+        offset = address - SIM_FLASH_S_BASE;
+    } else {
+        return NULL;
+    }
+
+    if (length > SIM_FLASH_SIZE - offset) {
+        return NULL;
+    }
+
+    return flash_rw + offset;
+}
+
+bool SIM_Flash_Contains(const void *ptr, size_t length)
+{
+    uintptr_t p = (uintptr_t)ptr;
+
+    if (p >= SIM_FLASH_NS_BASE && p + length <= SIM_FLASH_NS_BASE + SIM_FLASH_SIZE) {
+        return true;
+    }
+    return (p >= SIM_FLASH_S_BASE && p + length <= SIM_FLASH_S_BASE + SIM_FLASH_SIZE);
+}
+
+static int flash_bank_of(const void *ptr)
+{
+    uintptr_t p = (uintptr_t)ptr;
+    uintptr_t base = (p >= SIM_FLASH_S_BASE) ? SIM_FLASH_S_BASE : SIM_FLASH_NS_BASE;
+
+    return (int)((p - base) / SIM_FLASH_BANK_SIZE);
+}
+
+static void clock_step(uint64_t cycles)
+{
+    clock_cycles += cycles;
+    clock_nanos += (cycles * 1000000000ULL) / core_clock_hz;
+}
+
+/* Clock and accounting -------------------------------------------------*/
+
+void SIM_Account(SIM_EngineTypeDef engine, const void *src, size_t bytes, uint64_t cycles)
+{
+    SIM_EngineStats *st;
+
+    if (engine >= SIM_ENGINE_COUNT) {
+        return;
+    }
+
+    st = &engine_stats[engine];
+    st->calls++;
+    st->bytes += bytes;
+
+    if (src != NULL && bytes > 0 && SIM_Flash_Contains(src, bytes)) {
+        st->flash_bytes += bytes;
+        cycles += ((bytes + 3U) / 4U) * SIM_CYCLES_FLASH_WORD_READ;
+
+        /* The bus stalls until the bank finishes its program or erase */
+        if (flash_busy_bank >= 0 && flash_bank_of(src) == flash_busy_bank) {
+            uint64_t start = clock_cycles;
+
+            while (flash_busy_bank >= 0 && SIM_Event_Pending()) {
+                SIM_Core_WaitForInterrupt();
+            }
+            st->cycles += clock_cycles - start;
+        }
+    }
+
+    st->cycles += cycles;
+    SIM_Clock_Advance(cycles);
+}
+
+void SIM_Account_Background(SIM_EngineTypeDef engine, size_t bytes, uint64_t cycles)
+{
+    if (engine >= SIM_ENGINE_COUNT) {
+        return;
+    }
+
+    engine_stats[engine].calls++;
+    engine_stats[engine].bytes += bytes;
+    engine_stats[engine].cycles += cycles;
+}
+
+/* Earliest pending event, NULL if none */
+static SIM_Event *event_next(void)
+{
+    SIM_Event *next = NULL;
+
+    for (uint32_t i = 0; i < SIM_EVENT_SOURCES; i++) {
+        if (events[i].handler != NULL && (next == NULL || events[i].at < next->at)) {
+            next = &events[i];
+        }
+    }
+    return next;
+}
+
+void SIM_Clock_Advance(uint64_t cycles)
+{
+    uint64_t target = clock_cycles + cycles;
+    SIM_Event *ev;
+
+    while ((ev = event_next()) != NULL && ev->at <= target) {
+        void (*handler)(void) = ev->handler;
+
+        if (ev->at > clock_cycles) {
+            clock_step(ev->at - clock_cycles);
+        }
+        ev->handler = NULL;
+        handler();
+    }
+
+    if (target > clock_cycles) {
+        clock_step(target - clock_cycles);
+    }
+}
+
+void SIM_Event_Schedule(uint64_t at_cycle, void (*handler)(void))
+{
+    SIM_Event *slot = NULL;
+
+    for (uint32_t i = 0; i < SIM_EVENT_SOURCES; i++) {
+        if (events[i].handler == handler) {
+            slot = &events[i];
+            break;
+        }
+        if (events[i].handler == NULL && slot == NULL) {
+            slot = &events[i];
+        }
+    }
+    if (slot == NULL) {
+        fprintf(stderr, "sim: more than %u event sources pending\n", (unsigned)SIM_EVENT_SOURCES);
+        abort();
+    }
+    slot->at = at_cycle;
+    slot->handler = handler;
+}
+
+bool SIM_Event_Pending(void)
+{
+    return event_next() != NULL;
+}
+
+void SIM_Flash_SetBusyBank(int bank)
+{
+    flash_busy_bank = bank;
+}
+
+bool SIM_Flash_OperationStart(void)
+{
+    return flash_operations++ == power_cut_at;
+}
+
+uint64_t SIM_Flash_Operations(void)
+{
+    return flash_operations;
+}
+
+void SIM_Power_CutAt(uint64_t op_index)
+{
+    power_cut_at = op_index;
+}
+
+void SIM_Core_WaitForInterrupt(void)
+{
+    SIM_Event *ev = event_next();
+
+    if (ev != NULL) {
+        SIM_Clock_Advance((ev->at > clock_cycles) ? ev->at - clock_cycles : 0U);
+    } else {
+        uint64_t tick = core_clock_hz / 1000U;
+
+        SIM_Uart_Wait(1000U);
+        SIM_Clock_Advance(tick - (clock_cycles % tick));
+    }
+    SIM_Uart_Service();
+}
+
+uint64_t SIM_Clock_Cycles(void)
+{
+    return clock_cycles;
+}
+
+uint64_t SIM_Clock_Nanos(void)
+{
+    return clock_nanos;
+}
+
+void SIM_Clock_SetCoreHz(uint32_t hz)
+{
+    if (hz != 0U) {
+        core_clock_hz = hz;
+    }
+}
+
+uint32_t SIM_Clock_CoreHz(void)
+{
+    return core_clock_hz;
+}
+
+uint64_t SIM_Clock_UsToCycles(uint32_t us)
+{
+    return ((uint64_t)us * core_clock_hz) / 1000000U;
+}
+
+const SIM_EngineStats *SIM_Stats_Get(SIM_EngineTypeDef engine)
+{
+    return (engine < SIM_ENGINE_COUNT) ? &engine_stats[engine] : NULL;
+}
+
+const char *SIM_Stats_Name(SIM_EngineTypeDef engine)
+{
+    return (engine < SIM_ENGINE_COUNT) ? engine_names[engine] : "?";
+}
+
+void SIM_Stats_Reset(void)
+{
+    memset(engine_stats, 0, sizeof(engine_stats));
+    memset(events, 0, sizeof(events));
+    flash_busy_bank = -1;
+    flash_operations = 0;
+    clock_cycles = 0;
+    clock_nanos = 0;
+    core_clock_hz = 4000000U;
+}
+
+/* Console --------------------------------------------------------------*/
+
+void SIM_Console_Enable(bool enable)
+{
+    console_enabled = enable;
+}
+
+bool SIM_Console_Enabled(void)
+{
+    return console_enabled;
+}
+
+/* Boot run -------------------------------------------------------------*/
+
+void SIM_Core_SetMSP_NS(uint32_t topOfMainStack)
+{
+    volatile uint32_t *vtor_ns = (volatile uint32_t *)(SIM_SCS_NS_BASE + 0xD08UL);
+    uint32_t vtor = *vtor_ns;
+    const uint8_t *reset = SIM_Flash_Backing(vtor + 4U, 4U);
+
+    if (!run_active || run_result == NULL) {
+        return;
+    }
+
+    /* Everything after the MSP_NS write is the non-secure branch itself */
+    run_result->outcome = SIM_BOOT_JUMPED;
+    run_result->vtor_ns = vtor;
+    run_result->msp_ns = topOfMainStack;
+    run_result->reset_ns = 0U;
+    if (reset != NULL) {
+        memcpy(&run_result->reset_ns, reset, sizeof(run_result->reset_ns));
+    }
+    siglongjmp(run_env, 1);
+}
+
+void SIM_Power_Fail(void)
+{
+    if (!run_active || run_result == NULL) {
+        return;
+    }
+
+    run_result->outcome = SIM_BOOT_POWER_LOSS;
+    siglongjmp(run_env, 1);
+}
+
+int SIM_Power_Cycle(int (*cycle)(void))
+{
+    pid_t pid;
+    int wstatus;
+
+    fflush(NULL);
+    pid = fork();
+    if (pid < 0) {
+        return -1;
+    }
+    if (pid == 0) {
+        int rc = cycle();
+        fflush(NULL);
+        _exit(rc & 0xFF);
+    }
+
+    if (waitpid(pid, &wstatus, 0) != pid || !WIFEXITED(wstatus)) {
+        return -1;
+    }
+    return WEXITSTATUS(wstatus);
+}
+
+void SIM_Run(int (*entry)(void), unsigned int timeout_s, SIM_BootResult *result)
+{
+    struct sigaction sa, old_segv, old_bus, old_alrm;
+    stack_t ss;
+
+    memset(result, 0, sizeof(*result));
+    result->outcome = SIM_BOOT_RUNNING;
+
+    ss.ss_sp = alt_stack;
+    ss.ss_size = sizeof(alt_stack);
+    ss.ss_flags = 0;
+    sigaltstack(&ss, NULL);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = run_signal_handler;
+    sa.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_NODEFER;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGSEGV, &sa, &old_segv);
+    sigaction(SIGBUS, &sa, &old_bus);
+    sigaction(SIGALRM, &sa, &old_alrm);
+
+    run_result = result;
+    if (sigsetjmp(run_env, 1) == 0) {
+        run_active = 1;
+        alarm(timeout_s);
+        entry();
+        result->outcome = SIM_BOOT_RETURNED;
+    }
+    alarm(0);
+    run_active = 0;
+    run_result = NULL;
+
+    sigaction(SIGSEGV, &old_segv, NULL);
+    sigaction(SIGBUS, &old_bus, NULL);
+    sigaction(SIGALRM, &old_alrm, NULL);
+
+    result->cycles = clock_cycles;
+    result->nanos = clock_nanos;
+}
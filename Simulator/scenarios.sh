@@ -0,0 +1,112 @@
+#!/usr/bin/env bash
+# =============================================================================
+# Boot scenarios on the host simulator, run by "make test"
+#
+# Builds its update images in build/scenarios from the Artifacts/ main app
+# payload, signed with Script/keys/ec_private.pem by Tools/build/secboot_image
+# (delta images by Script/stm32_delta_builder.py) under a test AES_KEY1, then
+# boots every scenario and checks the simulator's exit status:
+#   - boot:   Artifacts/ as flashed, within BOOT_BUDGET_MS of modelled latency
+#   - seal:   the second boot of the same flash skips ECDSA, within
+#             SEALED_BUDGET_MS
+#   - install, A/B CTR, GCM, LZSS and delta updates
+#   - the power cut swept over every flash operation of an A/B install
+#   - UART: installed as received (-R), staged (-S) and in the boot's listen
+#     window (-L), sent by Script/stm32_uart_sender.py over a pty
+#
+# Usage: scenarios.sh SIM SECBOOT_IMAGE
+# Exit status: 0 when every scenario passed, 1 otherwise, 2 when the images
+#              cannot be built
+# Requirements: python3 with cryptography (Script/requirements.txt)
+# =============================================================================
+
+SIM=$1
+IMAGE=$2
+WORK=build/scenarios
+KEY=00112233445566778899aabbccddeeff
+PEM=../Script/keys/ec_private.pem
+BOOT_BUDGET_MS=${BOOT_BUDGET_MS:-250}
+SEALED_BUDGET_MS=${SEALED_BUDGET_MS:-10}
+SLOT_B_VTOR=0x0804D100
+
+failures=0
+
+# run NAME COMMAND...: one scenario, its output kept in $WORK/NAME.log
+run() {
+    local name=$1
+    shift
+    if "$@" > "$WORK/$name.log" 2>&1; then
+        printf "PASS  %s\n" "$name"
+    else
+        printf "FAIL  %s (see %s)\n" "$name" "$WORK/$name.log"
+        failures=$((failures + 1))
+    fi
+}
+
+# uart IMAGE SIM_OPTION...: boot the simulator on a new pty and send IMAGE
+uart() {
+    local image=$1 err pid pty i
+    shift
+    err=$(mktemp)
+    "$SIM" -q "$@" 2> "$err" &
+    pid=$!
+    for i in $(seq 50); do
+        pty=$(sed -n 's/^sim: UART on //p' "$err")
+        [ -n "$pty" ] && break
+        sleep 0.1
+    done
+    if [ -z "$pty" ]; then
+        kill "$pid" 2> /dev/null
+        wait "$pid"
+        cat "$err"
+        rm -f "$err"
+        return 1
+    fi
+    python3 ../Script/stm32_uart_sender.py "$pty" "$image" || kill "$pid" 2> /dev/null
+    wait "$pid"
+    i=$?
+    cat "$err"
+    rm -f "$err"
+    return $i
+}
+
+# sealed_boot: boot once to seal the main app, then boot the same flash
+sealed_boot() {
+    rm -f "$WORK/flash.bin"
+    "$SIM" -q -f "$WORK/flash.bin" || return 1
+    "$SIM" -q -f "$WORK/flash.bin" -n -b "" -a "" -k "" -m "$SEALED_BUDGET_MS"
+}
+
+# --- Images ---
+rm -rf "$WORK"
+mkdir -p "$WORK"
+tail -c +257 ../Artifacts/Secboot_MainApp.bin > "$WORK/ns.bin"
+
+sign() {
+    "$IMAGE" sign -k "$PEM" -x "$KEY" "$@" "$WORK/ns.bin" > /dev/null
+}
+if ! sign -o "$WORK/slotA.bin" -E ctr -O "$WORK/slotA_ctr.bin" ||
+   ! sign -o "$WORK/slotB.bin" -V 1.0.0.1 -e "$SLOT_B_VTOR" -E ctr -O "$WORK/slotB_ctr.bin" ||
+   ! sign -o "$WORK/slotB.bin" -V 1.0.0.1 -e "$SLOT_B_VTOR" -E gcm -O "$WORK/slotB_gcm.bin" ||
+   ! sign -o "$WORK/slotB.bin" -V 1.0.0.1 -e "$SLOT_B_VTOR" -E gcm -O "$WORK/slotB_lz.bin" -z ||
+   ! SECBOOT_AES_KEY_1=$KEY python3 ../Script/stm32_delta_builder.py \
+         "$WORK/slotA.bin" "$WORK/slotB.bin" "$WORK/delta.bin" > "$WORK/delta.log"; then
+    echo "scenarios: cannot build the update images"
+    exit 2
+fi
+
+# --- Scenarios ---
+run boot            "$SIM" -q -m "$BOOT_BUDGET_MS"
+run seal            sealed_boot
+run install         "$SIM" -q -a "" -i "$WORK/slotA_ctr.bin@0x08040000" -x "$KEY"
+run ab-ctr          "$SIM" -q -U "$WORK/slotB_ctr.bin" -x "$KEY"
+run ab-gcm          "$SIM" -q -U "$WORK/slotB_gcm.bin" -x "$KEY"
+run ab-lzss         "$SIM" -q -U "$WORK/slotB_lz.bin" -x "$KEY"
+run ab-delta        "$SIM" -q -a "$WORK/slotA.bin" -U "$WORK/delta.bin" -x "$KEY"
+run power-cut-sweep "$SIM" -q -U "$WORK/slotB_ctr.bin" -x "$KEY" -P 1
+run uart-install    uart "$WORK/slotB_gcm.bin" -R pty -x "$KEY"
+run uart-staged     uart "$WORK/slotB_gcm.bin" -S pty -x "$KEY"
+run uart-listen     uart "$WORK/slotB_gcm.bin" -L pty -x "$KEY" -e "$SLOT_B_VTOR"
+
+echo "Scenarios: $( [ "$failures" -eq 0 ] && echo PASS || echo FAIL ) ($failures failed)"
+[ "$failures" -eq 0 ]
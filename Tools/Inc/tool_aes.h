@@ -0,0 +1,81 @@
+/**
+  * @file    tool_aes.h
+  * @brief   AES-128/256 encryption modes for the host tools
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    The modes the scripts use, with the bootloader's conventions:
+  *          CBC for the key wrap of the security block, CTR with a 32-bit
+  *          big-endian block counter in the last word (the AES peripheral
+  *          increments nothing else), GCM with a 96-bit IV and a 16-byte
+  *          tag. Only the forward cipher is needed: CTR and GCM decrypt
+  *          with it too. Streaming calls take multiples of
+  *          TOOL_AES_BLOCK_SIZE bytes except the last.
+  */
+
+#ifndef __TOOL_AES_H
+#define __TOOL_AES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TOOL_AES_BLOCK_SIZE    16U
+#define TOOL_AES_GCM_IV_SIZE   12U
+#define TOOL_AES_GCM_TAG_SIZE  16U
+
+/** @brief Expanded key */
+typedef struct {
+    uint8_t  roundKey[15U * TOOL_AES_BLOCK_SIZE];
+    uint32_t rounds;
+} TOOL_AES_Key;
+
+/** @brief GCM state */
+typedef struct {
+    const TOOL_AES_Key *key;
+    uint8_t  h[TOOL_AES_BLOCK_SIZE];        ///< Hash subkey E(K, 0)
+    uint8_t  j0[TOOL_AES_BLOCK_SIZE];       ///< Pre-counter block IV || 1
+    uint8_t  counter[TOOL_AES_BLOCK_SIZE];  ///< Next payload counter
+    uint8_t  ghash[TOOL_AES_BLOCK_SIZE];
+    uint64_t aadLen;                        ///< Bytes
+    uint64_t textLen;                       ///< Bytes
+} TOOL_AES_GCM;
+
+/**
+  * @brief  Expand a key
+  * @param  keyLen  16, 24 or 32 bytes
+  * @retval 0, or -1 for another length
+  */
+int TOOL_AES_SetKey(TOOL_AES_Key *key, const uint8_t *pKey, size_t keyLen);
+
+void TOOL_AES_EncryptBlock(const TOOL_AES_Key *key, const uint8_t in[TOOL_AES_BLOCK_SIZE],
+                           uint8_t out[TOOL_AES_BLOCK_SIZE]);
+
+/**
+  * @brief  CBC encryption, length a multiple of TOOL_AES_BLOCK_SIZE
+  * @param  iv  Chaining value, updated for the next call
+  */
+void TOOL_AES_CBC_Encrypt(const TOOL_AES_Key *key, uint8_t iv[TOOL_AES_BLOCK_SIZE], const uint8_t *in,
+                          uint8_t *out, size_t length);
+
+/**
+  * @brief  CTR encryption or decryption
+  * @param  counter  Counter block, advanced by the blocks used
+  */
+void TOOL_AES_CTR(const TOOL_AES_Key *key, uint8_t counter[TOOL_AES_BLOCK_SIZE], const uint8_t *in,
+                  uint8_t *out, size_t length);
+
+/**
+  * @brief  Start GCM: hash subkey, pre-counter and the additional data
+  */
+void TOOL_AES_GCM_Start(TOOL_AES_GCM *gcm, const TOOL_AES_Key *key, const uint8_t iv[TOOL_AES_GCM_IV_SIZE],
+                        const uint8_t *aad, size_t aadLen);
+
+void TOOL_AES_GCM_Encrypt(TOOL_AES_GCM *gcm, const uint8_t *in, uint8_t *out, size_t length);
+void TOOL_AES_GCM_Decrypt(TOOL_AES_GCM *gcm, const uint8_t *in, uint8_t *out, size_t length);
+
+/**
+  * @brief  Tag over the additional data and the ciphertext so far
+  */
+void TOOL_AES_GCM_Tag(TOOL_AES_GCM *gcm, uint8_t tag[TOOL_AES_GCM_TAG_SIZE]);
+
+#endif /* __TOOL_AES_H */
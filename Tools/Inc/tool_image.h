@@ -0,0 +1,222 @@
+/**
+  * @file    tool_image.h
+  * @brief   Signed image and bootloader layouts for the host tools
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    Mirrors FirmwareHeader_TypeDef and the header descriptors of
+  *          secboot_bootmanager.h and the security block the bootloader
+  *          reads at 0x8000, which cannot be included here (HAL types).
+  *          Signing, image checks and the key wrap are the ones of
+  *          stm32_application_signer.py and stm32_secure_boot_builder.py,
+  *          except that ECDSA nonces are derived per RFC 6979 instead of
+  *          drawn at random: the same inputs give the same image.
+  */
+
+#ifndef __TOOL_IMAGE_H
+#define __TOOL_IMAGE_H
+
+#include "secboot_config.h"
+#include "secboot_p256.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Signed image (secboot_bootmanager.h) ---------------------------------*/
+#define TOOL_FW_MAGIC_V1           0xDEADBEEFUL   /* FW_MAGIC_NUMBER */
+#define TOOL_FW_MAGIC_V2           0xDEADB10CUL   /* FW_MAGIC_NUMBER_V2 */
+#define TOOL_FW_HEADER_SIZE        SECBOOT_FW_HEADER_SIZE
+#define TOOL_FW_HEADER_CRC_SPAN    112U           /* FW_HEADER_CRC_SPAN */
+#define TOOL_FW_HEADER_FIELDS      (TOOL_FW_HEADER_CRC_SPAN + 4U)  /* sizeof(FirmwareHeader_TypeDef), GCM AAD */
+#define TOOL_FW_BLOCK_SIZE         2048U          /* FW_BLOCK_SIZE */
+#define TOOL_FW_BLOCK_COUNT(size)  (((size) + TOOL_FW_BLOCK_SIZE - 1U) / TOOL_FW_BLOCK_SIZE)
+#define TOOL_FW_TABLE_OFFSET(size) (((size) + 7U) & ~(size_t)7U)  /* FW_BLOCK_TABLE_OFFSET */
+#define TOOL_FW_DELTA_INFO_OFFSET  0x80U
+#define TOOL_FW_DELTA_MAGIC        0xDE17A001UL
+#define TOOL_FW_COMP_INFO_OFFSET   0xB0U
+#define TOOL_FW_COMP_MAGIC_LZSS    0xC0DE1255UL
+#define TOOL_FW_ENC_INFO_OFFSET    0xC0U
+#define TOOL_FW_ENC_MAGIC          0xE4C0DE01UL
+#define TOOL_FW_ENC_MODE_CTR       0U             /* SECBOOT_AES_MODE_CTR */
+#define TOOL_FW_ENC_MODE_GCM       1U             /* SECBOOT_AES_MODE_GCM */
+
+/* Bootloader image and its security block (AES_KEY_OFFSET..) -----------*/
+#define TOOL_BOOTLOADER_IMAGE_SIZE 254016U        /* Bytes of SecBoot_S.bin, as the builder enforces */
+#define TOOL_SECBLOCK_OFFSET       0x8000U        /* Also the span of the bootloader CRC */
+#define TOOL_SECBLOCK_KEY          0x8000U        /* Wrapped AES_KEY1, 32 bytes, words byte-swapped */
+#define TOOL_SECBLOCK_IV           0x8020U        /* AES IV, 16 bytes, words byte-swapped */
+#define TOOL_SECBLOCK_PUBKEY       0x8030U        /* Qx || Qy, big-endian */
+#define TOOL_SECBLOCK_CRC          0x8070U        /* CRC of the first 0x8000 bytes, little-endian */
+#define TOOL_SECBLOCK_SIZE         0x74U
+#define TOOL_WRAPPED_KEY_SIZE      32U            /* AES_KEY1 (16 bytes) + PKCS#7 block */
+#define TOOL_UID_WORDS             3U             /* HAL_GetUIDw0..2 */
+#define TOOL_DEVICE_KEY_SIZE       16U            /* UID words || FW_MAGIC_NUMBER */
+
+/** @brief Image check results, worst first in each group */
+typedef enum {
+    TOOL_IMAGE_OK = 0,
+    TOOL_IMAGE_TRUNCATED,        ///< Shorter than the header, or than the payload it announces
+    TOOL_IMAGE_BAD_MAGIC,        ///< Not a signed image
+    TOOL_IMAGE_BAD_HEADER_CRC,   ///< headerCRC does not match
+    TOOL_IMAGE_BAD_TABLE,        ///< v2: a block differs from its table entry
+    TOOL_IMAGE_BAD_HASH,         ///< Payload (v1) or block table (v2) differs from firmwareHash
+    TOOL_IMAGE_BAD_SIGNATURE,    ///< r||s does not verify against the key
+    TOOL_IMAGE_BAD_PUBKEY,       ///< The key is not a curve point
+    TOOL_IMAGE_NEED_KEY,         ///< Encrypted update image and no AES key
+    TOOL_IMAGE_BAD_TAG,          ///< GCM tag mismatch
+    TOOL_IMAGE_BAD_STREAM        ///< Descriptor out of range, or the LZSS stream is corrupt
+} TOOL_Image_StatusTypeDef;
+
+/** @brief Header fields, host byte order */
+typedef struct {
+    uint32_t magic;
+    uint32_t size;               ///< Payload bytes
+    uint8_t  version[4];
+    uint32_t entryPoint;
+    uint8_t  firmwareHash[SECBOOT_P256_SIZE];
+    uint8_t  signature[2U * SECBOOT_P256_SIZE];  ///< r || s
+    uint32_t headerCRC;
+} TOOL_ImageHeader;
+
+/** @brief Header padding descriptors that are present */
+typedef struct {
+    bool     encrypted;
+    uint32_t encMode;            ///< TOOL_FW_ENC_MODE_
+    uint8_t  encIv[16];
+    uint8_t  encTag[16];
+    bool     compressed;
+    uint32_t compressedSize;
+    bool     delta;
+    uint32_t patchSize;
+    uint8_t  baseHash[SECBOOT_P256_SIZE];
+} TOOL_ImageDescriptors;
+
+/* Little-endian fields ---------------------------------------------------*/
+uint32_t TOOL_GetLE32(const uint8_t *p);
+void TOOL_PutLE32(uint8_t *p, uint32_t value);
+
+/* Headers ----------------------------------------------------------------*/
+
+/**
+  * @brief  Header bytes: fields, CRC over the first TOOL_FW_HEADER_CRC_SPAN
+  *         bytes (also stored in h->headerCRC), then 0xFF to
+  *         TOOL_FW_HEADER_SIZE
+  */
+void TOOL_Image_BuildHeader(TOOL_ImageHeader *h, uint8_t out[TOOL_FW_HEADER_SIZE]);
+
+/**
+  * @brief  Decode a header and check its magic and CRC
+  * @retval TOOL_IMAGE_OK, TOOL_IMAGE_BAD_MAGIC or TOOL_IMAGE_BAD_HEADER_CRC
+  */
+TOOL_Image_StatusTypeDef TOOL_Image_ParseHeader(const uint8_t hdr[TOOL_FW_HEADER_SIZE], TOOL_ImageHeader *h);
+
+/**
+  * @brief  Descriptors of the header padding
+  */
+void TOOL_Image_ParseDescriptors(const uint8_t hdr[TOOL_FW_HEADER_SIZE], TOOL_ImageDescriptors *d);
+
+/**
+  * @brief  Bytes after the header of a clear image: payload, then for v2
+  *         the pad to 8 and the block table
+  */
+size_t TOOL_Image_StreamSize(const TOOL_ImageHeader *h);
+
+/* Checks -----------------------------------------------------------------*/
+
+/**
+  * @brief  Check the payload stream of a clear image against firmwareHash
+  * @param  stream  TOOL_Image_StreamSize bytes following the header
+  * @param  length  Bytes available at stream
+  * @param  pBadBlock  v2: first block that failed (may be NULL)
+  */
+TOOL_Image_StatusTypeDef TOOL_Image_CheckStream(const TOOL_ImageHeader *h, const uint8_t *stream, size_t length,
+                                                uint32_t *pBadBlock);
+
+/**
+  * @brief  Check r||s of the header against firmwareHash and the key
+  */
+TOOL_Image_StatusTypeDef TOOL_Image_CheckSignature(const TOOL_ImageHeader *h, const uint8_t *qx, const uint8_t *qy);
+
+/**
+  * @brief  Clear stream of an encrypted update image: decrypt (checking the
+  *         GCM tag) and decompress
+  * @param  image      Whole update image, header first
+  * @param  length     Its size
+  * @param  key        AES key; keyLen 16 or 32
+  * @param  pStream    malloc'd stream (out), TOOL_Image_StreamSize bytes,
+  *                    or the patch of a delta image
+  * @param  pLength    Its size (out)
+  */
+TOOL_Image_StatusTypeDef TOOL_Image_Decrypt(const uint8_t *image, size_t length, const uint8_t *key, size_t keyLen,
+                                            uint8_t **pStream, size_t *pLength);
+
+const char *TOOL_Image_StatusName(TOOL_Image_StatusTypeDef status);
+
+/* Keys and signatures ----------------------------------------------------*/
+
+/**
+  * @brief  Load a P-256 private key, PEM "EC PRIVATE KEY" (SEC 1) or
+  *         unencrypted "PRIVATE KEY" (PKCS #8)
+  * @retval 0, or -1 with a message on stderr
+  */
+int TOOL_LoadPrivateKey(const char *path, uint8_t d[SECBOOT_P256_SIZE]);
+
+/**
+  * @brief  ECDSA P-256 signature of a digest, nonce per RFC 6979
+  * @retval 0, or -1 when d is not a valid private key
+  */
+int TOOL_Sign(const uint8_t digest[SECBOOT_P256_SIZE], const uint8_t d[SECBOOT_P256_SIZE],
+              uint8_t signature[2U * SECBOOT_P256_SIZE]);
+
+/**
+  * @brief  Hex bytes from an argument, "@FILE" for a file holding them
+  * @param  max  Capacity of out
+  * @retval Bytes decoded, or -1 (odd length, bad digit, too long)
+  */
+int TOOL_ParseHex(const char *arg, uint8_t *out, size_t max);
+
+/**
+  * @brief  Key material from an option (TOOL_ParseHex), or from the
+  *         environment variable env when arg is NULL
+  * @param  what   Name for messages
+  * @param  sizes  Accepted lengths, 0-terminated
+  * @retval Length, or -1 with a message on stderr
+  */
+int TOOL_KeyArgument(const char *arg, const char *env, const char *what, uint8_t *out, size_t max,
+                     const size_t *sizes);
+
+/* Bootloader security block ----------------------------------------------*/
+
+/**
+  * @brief  AES_KEY1 wrapped the way get_AES_key unwraps it: AES-CBC under
+  *         the wrapping key (AES_KEY2, UID words || FW_MAGIC_NUMBER on the
+  *         device) with PKCS#7 padding
+  * @retval 0, or -1 for a bad key length (key1 16 bytes, wrap 16 or 32)
+  */
+int TOOL_WrapKey(const uint8_t *key1, size_t key1Len, const uint8_t *wrapKey, size_t wrapKeyLen,
+                 const uint8_t iv[16], uint8_t wrapped[TOOL_WRAPPED_KEY_SIZE]);
+
+/**
+  * @brief  Wrapping key of one device, as get_AES_key builds it: UID words
+  *         w0, w1, w2 then FW_MAGIC_NUMBER, each most significant byte
+  *         first (the AES peripheral's key word order)
+  */
+void TOOL_DeviceKey(const uint32_t uid[TOOL_UID_WORDS], uint8_t key[TOOL_DEVICE_KEY_SIZE]);
+
+/**
+  * @brief  Security block bytes, as stm32_secure_boot_builder.py lays them out
+  * @param  crc  CRC of the first TOOL_SECBLOCK_OFFSET bytes of the image
+  */
+void TOOL_BuildSecBlock(const uint8_t wrapped[TOOL_WRAPPED_KEY_SIZE], const uint8_t iv[16], const uint8_t *qx,
+                        const uint8_t *qy, uint32_t crc, uint8_t out[TOOL_SECBLOCK_SIZE]);
+
+/* Files ------------------------------------------------------------------*/
+
+/**
+  * @brief  Read a whole (small) file into a malloc'd buffer
+  * @retval 0, or -1 with a message on stderr
+  */
+int TOOL_ReadFile(const char *path, uint8_t **pData, size_t *pSize);
+
+#endif /* __TOOL_IMAGE_H */
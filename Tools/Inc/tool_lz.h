@@ -0,0 +1,32 @@
+/**
+  * @file    tool_lz.h
+  * @brief   LZSS compressor for update images (the secboot_lz.h format)
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    The greedy parse of lzss_compress in
+  *          stm32_application_signer.py, token for token: at each position
+  *          the last TOOL_LZ_MAX_CHAIN earlier positions with the same
+  *          3-byte prefix are tried, newest first, until one is more than
+  *          SECBOOT_LZ_WINDOW_SIZE back; the first longest match wins.
+  *          Positions are chained by a 16-bit hash instead of a dictionary
+  *          of prefixes, and collisions are skipped without counting.
+  */
+
+#ifndef __TOOL_LZ_H
+#define __TOOL_LZ_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TOOL_LZ_MAX_MATCH  66U     ///< MIN_MATCH + (1 << SECBOOT_LZ_LENGTH_BITS) - 1
+#define TOOL_LZ_MAX_CHAIN  64U     ///< Candidates tried per position
+
+/**
+  * @brief  Compress a buffer
+  * @param  pLength  Compressed size (out)
+  * @retval malloc'd compressed stream, NULL when out of memory
+  */
+uint8_t *TOOL_LZ_Compress(const uint8_t *in, size_t length, size_t *pLength);
+
+#endif /* __TOOL_LZ_H */
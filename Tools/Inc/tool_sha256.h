@@ -0,0 +1,66 @@
+/**
+  * @file    tool_sha256.h
+  * @brief   SHA-256 and HMAC-SHA256 for the host tools
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    The block function is picked once, on first use: the x86 SHA
+  *          extensions (SHA-NI) when the CPU has them, portable C
+  *          otherwise. Both give the digests of the bootloader's HASH unit;
+  *          TOOL_SHA256_Engine names the one in use; threads call it
+  *          once before they start hashing.
+  */
+
+#ifndef __TOOL_SHA256_H
+#define __TOOL_SHA256_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TOOL_SHA256_SIZE        32U    ///< Digest bytes
+#define TOOL_SHA256_BLOCK_SIZE  64U    ///< Message block bytes
+
+/** @brief Streaming SHA-256 state */
+typedef struct {
+    uint32_t state[8];
+    uint64_t length;                          ///< Message bytes absorbed
+    uint8_t  block[TOOL_SHA256_BLOCK_SIZE];   ///< Partial block
+    uint32_t blockLen;
+} TOOL_SHA256_Context;
+
+void TOOL_SHA256_Init(TOOL_SHA256_Context *ctx);
+void TOOL_SHA256_Update(TOOL_SHA256_Context *ctx, const void *pData, size_t length);
+void TOOL_SHA256_Final(TOOL_SHA256_Context *ctx, uint8_t digest[TOOL_SHA256_SIZE]);
+
+/**
+  * @brief  One-shot SHA-256
+  */
+void TOOL_SHA256(const void *pData, size_t length, uint8_t digest[TOOL_SHA256_SIZE]);
+
+/**
+  * @brief  SHA-256 of count independent messages, two at a time
+  * @param  messages  Message pointers
+  * @param  lengths   Their lengths
+  * @param  digests   count digests (out)
+  */
+void TOOL_SHA256_Multi(const uint8_t *const *messages, const size_t *lengths, size_t count,
+                       uint8_t (*digests)[TOOL_SHA256_SIZE]);
+
+/**
+  * @brief  HMAC-SHA256 of the concatenation of count parts (RFC 2104)
+  * @param  key      Key, at most TOOL_SHA256_BLOCK_SIZE bytes
+  * @param  keyLen   Key length
+  * @param  parts    Message parts, hashed in order
+  * @param  lengths  Their lengths
+  * @param  count    Number of parts
+  * @param  mac      TOOL_SHA256_SIZE bytes (out)
+  */
+void TOOL_HMAC_SHA256(const uint8_t *key, size_t keyLen, const uint8_t *const *parts, const size_t *lengths,
+                      size_t count, uint8_t mac[TOOL_SHA256_SIZE]);
+
+/**
+  * @brief  Name of the block function in use: "sha-ni" or "portable"
+  */
+const char *TOOL_SHA256_Engine(void);
+
+#endif /* __TOOL_SHA256_H */
@@ -0,0 +1,644 @@
+/**
+  * @file    secboot_flash.c
+  * @brief   Full-chip flash images for production programming
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @details Places the bootloader, application images and any other file
+  *          at their addresses in the 512 KB flash of the STM32L562 (the
+  *          secure 0x0C000000 and non-secure 0x08000000 aliases are the
+  *          same bytes), then writes the result as:
+  *          - a full image, erased bytes as 0xFF (-o)
+  *          - a sparse image holding only the pages that are not erased,
+  *            after a table of regions and their checksums (-s)
+  *          - Intel HEX of the same pages, for programmers that write only
+  *            the ranges a file covers (-x)
+  *
+  *          Regions are those of secboot_config.h and the secure linker
+  *          script: bootloader (ROM), secrets (SECRETS, with the security
+  *          block), seal, slots, logger (LOGGER), nsc (ROM_NSC), then main,
+  *          slot1, slot2, update and backup; pages outside them form
+  *          gap_<address> regions, so every page is in one. Each gets a
+  *          CRC-32 (the bootloader's polynomial, so a readback can be
+  *          checked on the device) and a SHA-256. With -p, the regions are compared with
+  *          those of a previous sparse image; -d then leaves the pages of
+  *          unchanged regions out of the outputs, so the line only erases,
+  *          writes and reads back what differs. Erased pages are never in
+  *          the outputs: a region that changed is erased whole before its
+  *          pages are written.
+  *
+  *          A bootloader binary also covers seal, slots and logger, which
+  *          the bootloader writes at run time; objcopy fills them with
+  *          0x00. -e leaves them erased instead, as on a new device.
+  *
+  *          Sparse image, little-endian:
+  *            header   magic "SBSP", version, flags (bit 0: delta), page
+  *                     size, flash size, region count, page count, CRC-32
+  *                     of the full image (32 bytes)
+  *            regions  name (16 bytes, NUL padded), address, size, CRC-32,
+  *                     pages not erased, SHA-256 (64 bytes each)
+  *            pages    offset in flash (4 bytes), then the page
+  *            trailer  CRC-32 of everything before it
+  *
+  *          Exit status: 0, 1 when a file cannot be placed or written, 2
+  *          on usage errors.
+  */
+
+#include "tool_image.h"
+#include "tool_sha256.h"
+#include "secboot_crc32.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FLASH_NS_BASE       0x08000000UL
+#define FLASH_S_BASE        0x0C000000UL
+#define FLASH_SIZE          (512U * 1024U)   /* STM32L562xE */
+#define FLASH_PAGE_SIZE     2048U            /* DBANK=1 */
+#define FLASH_PAGES         (FLASH_SIZE / FLASH_PAGE_SIZE)
+#define FLASH_ERASED        0xFFU
+
+#define SECRETS_ADDR        (BOOTLOADER_START_ADDR + BOOTLOADER_SIZE)  /* SECRETS in STM32L562xE_FLASH_s.ld */
+#define SECRETS_SIZE        (8U * 1024U)
+#define SLOTS_SIZE          (2U * SECBOOT_SLOTS_PAGE_SIZE)
+#define LOGGER_SIZE         (SECBOOT_DIAG_LOG_PAGES * SECBOOT_DIAG_LOG_PAGE_SIZE)
+#define NSC_ADDR            0x0C03E000UL     /* ROM_NSC */
+#define NSC_SIZE            (8U * 1024U)
+
+#define SPARSE_MAGIC        0x50534253UL     /* "SBSP" */
+#define SPARSE_VERSION      1U
+#define SPARSE_FLAG_DELTA   0x1U
+#define SPARSE_HEADER_SIZE  32U
+#define SPARSE_REGION_SIZE  64U
+#define SPARSE_NAME_SIZE    16U
+
+#define MAX_FILES           16U
+#define MAX_REGIONS         32U
+
+/* Private types --------------------------------------------------------*/
+
+/** @brief One region of the layout and its checksums */
+typedef struct {
+    char        name[SPARSE_NAME_SIZE];
+    uint32_t    address;
+    uint32_t    size;
+    bool        state;                    /* Written by the bootloader at run time */
+    uint32_t    crc;
+    uint32_t    pages;                    /* Not erased */
+    uint8_t     sha[TOOL_SHA256_SIZE];
+    int         previous;                 /* -p: -1 new, 0 changed, 1 same */
+} FLASH_Region;
+
+/** @brief A file to place */
+typedef struct {
+    const char *path;
+    uint32_t    address;
+} FLASH_File;
+
+/* Private variables ----------------------------------------------------*/
+static const FLASH_Region layout[] = {
+    { .name = "bootloader", .address = BOOTLOADER_START_ADDR,        .size = BOOTLOADER_SIZE },
+    { .name = "secrets",    .address = SECRETS_ADDR,                 .size = SECRETS_SIZE },
+    { .name = "seal",       .address = SECBOOT_SEAL_BASE,            .size = SECBOOT_SEAL_PAGE_SIZE, .state = true },
+    { .name = "slots",      .address = SECBOOT_SLOTS_BASE,           .size = SLOTS_SIZE, .state = true },
+    { .name = "logger",     .address = SECBOOT_DIAG_LOG_BASE,        .size = LOGGER_SIZE, .state = true },
+    { .name = "nsc",        .address = NSC_ADDR,                     .size = NSC_SIZE },
+    { .name = "main",       .address = SECBOOT_MAIN_APP_IMAGE_ADDR,  .size = SECBOOT_MAIN_APP_IMAGE_SIZE },
+    { .name = "slot1",      .address = SECBOOT_SLOT1_ADDR,           .size = SECBOOT_SLOT1_SIZE },
+    { .name = "slot2",      .address = SECBOOT_SLOT2_ADDR,           .size = SECBOOT_SLOT2_SIZE },
+    { .name = "update",     .address = SECBOOT_UPDATE_SLOT_ADDR,     .size = SECBOOT_UPDATE_SLOT_SIZE },
+    { .name = "backup",     .address = SECBOOT_BACKUP_IMAGE_ADDR,    .size = SECBOOT_BACKUP_IMAGE_SIZE },
+};
+#define LAYOUT_COUNT (sizeof(layout) / sizeof(layout[0]))
+
+static FLASH_Region regions[MAX_REGIONS];   /* layout[] and the gaps between, by offset */
+static uint32_t region_count;
+
+static uint8_t flash[FLASH_SIZE];
+static uint8_t owner[FLASH_SIZE];         /* 1 + index into files[], 0 for erased */
+static bool erased[FLASH_PAGES];
+static bool skipped[FLASH_PAGES];         /* -d: page of an unchanged region */
+
+static FLASH_File files[MAX_FILES];
+static uint32_t file_count;
+
+static bool csv;
+static bool erase_state;                  /* -e */
+
+/* Helpers --------------------------------------------------------------*/
+
+/** @brief Offset in flash of an address in either alias, or -1 */
+static long flash_offset(uint32_t address)
+{
+    if (address >= FLASH_NS_BASE && address - FLASH_NS_BASE < FLASH_SIZE) {
+        return (long)(address - FLASH_NS_BASE);
+    }
+    if (address >= FLASH_S_BASE && address - FLASH_S_BASE < FLASH_SIZE) {
+        return (long)(address - FLASH_S_BASE);
+    }
+    return -1;
+}
+
+static bool region_holds(const FLASH_Region *r, uint32_t offset)
+{
+    uint32_t start = (uint32_t)flash_offset(r->address);
+
+    return offset >= start && offset - start < r->size;
+}
+
+/** @brief Address of a byte in the alias of the region holding it */
+static uint32_t page_address(uint32_t offset)
+{
+    for (uint32_t i = 0U; i < region_count; i++) {
+        if (region_holds(&regions[i], offset)) {
+            return regions[i].address - (uint32_t)flash_offset(regions[i].address) + offset;
+        }
+    }
+    return FLASH_NS_BASE + offset;
+}
+
+static int compare_regions(const void *a, const void *b)
+{
+    long x = flash_offset(((const FLASH_Region *)a)->address);
+    long y = flash_offset(((const FLASH_Region *)b)->address);
+
+    return (x > y) - (x < y);
+}
+
+/**
+  * @brief  layout[], plus a "gap_<address>" region for each run of pages
+  *         outside it, so that every page has a region and a checksum
+  */
+static void build_regions(void)
+{
+    bool covered[FLASH_PAGES] = { false };
+
+    for (uint32_t i = 0U; i < LAYOUT_COUNT; i++) {
+        uint32_t first = (uint32_t)flash_offset(layout[i].address) / FLASH_PAGE_SIZE;
+
+        regions[region_count++] = layout[i];
+        for (uint32_t p = first; p < first + layout[i].size / FLASH_PAGE_SIZE; p++) {
+            covered[p] = true;
+        }
+    }
+    for (uint32_t p = 0U; p < FLASH_PAGES;) {
+        uint32_t end = p;
+
+        while (end < FLASH_PAGES && !covered[end]) {
+            end++;
+        }
+        if (end > p && region_count < MAX_REGIONS) {
+            FLASH_Region *gap = &regions[region_count++];
+
+            // Below the main slot is the secure bootloader's half
+            memset(gap, 0, sizeof(*gap));
+            gap->address = ((p * FLASH_PAGE_SIZE < SECBOOT_MAIN_APP_IMAGE_ADDR - FLASH_NS_BASE) ? FLASH_S_BASE :
+                            FLASH_NS_BASE) + p * FLASH_PAGE_SIZE;
+            gap->size = (end - p) * FLASH_PAGE_SIZE;
+            snprintf(gap->name, sizeof(gap->name), "gap_%08" PRIX32, gap->address);
+        }
+        p = (end > p) ? end : p + 1U;
+    }
+    qsort(regions, region_count, sizeof(regions[0]), compare_regions);
+}
+
+static bool page_erased(uint32_t page)
+{
+    const uint8_t *p = &flash[page * FLASH_PAGE_SIZE];
+
+    return p[0] == FLASH_ERASED && memcmp(p, p + 1, FLASH_PAGE_SIZE - 1U) == 0;
+}
+
+static void add_file(const char *path, uint32_t address)
+{
+    if (file_count == MAX_FILES) {
+        fprintf(stderr, "secboot_flash: more than %u files\n", MAX_FILES);
+        exit(2);
+    }
+    files[file_count].path = path;
+    files[file_count].address = address;
+    file_count++;
+}
+
+/** @brief Copy a file into flash; no byte may belong to two files */
+static int place_file(uint32_t index)
+{
+    const FLASH_File *file = &files[index];
+    long offset = flash_offset(file->address);
+    uint8_t *data;
+    size_t size;
+    int rc = 0;
+
+    if (offset < 0) {
+        fprintf(stderr, "secboot_flash: %s: 0x%08" PRIX32 " is not in flash\n", file->path, file->address);
+        return -1;
+    }
+    if (TOOL_ReadFile(file->path, &data, &size) != 0) {
+        return -1;
+    }
+    if (size > FLASH_SIZE - (size_t)offset) {
+        fprintf(stderr, "secboot_flash: %s: %zu bytes at 0x%08" PRIX32 " run past the end of flash\n", file->path,
+                size, file->address);
+        rc = -1;
+    }
+    for (size_t i = 0U; rc == 0 && i < size; i++) {
+        if (owner[offset + i] != 0U) {
+            fprintf(stderr, "secboot_flash: %s overlaps %s at 0x%08" PRIX32 "\n", file->path,
+                    files[owner[offset + i] - 1U].path, page_address((uint32_t)(offset + i)));
+            rc = -1;
+        }
+        owner[offset + i] = (uint8_t)(index + 1U);
+    }
+    if (rc == 0) {
+        memcpy(&flash[offset], data, size);
+    }
+    free(data);
+    return rc;
+}
+
+static void summarise_regions(void)
+{
+    for (uint32_t i = 0U; i < region_count; i++) {
+        FLASH_Region *r = &regions[i];
+        uint32_t offset = (uint32_t)flash_offset(r->address);
+
+        r->crc = SECBOOT_CRC32_Accumulate(0xFFFFFFFFUL, &flash[offset], r->size);
+        TOOL_SHA256(&flash[offset], r->size, r->sha);
+        r->pages = 0U;
+        for (uint32_t p = offset / FLASH_PAGE_SIZE; p < (offset + r->size) / FLASH_PAGE_SIZE; p++) {
+            r->pages += erased[p] ? 0U : 1U;
+        }
+        r->previous = -1;
+    }
+}
+
+/* Previous image -------------------------------------------------------*/
+
+/** @brief Mark the regions whose SHA-256 matches the previous sparse image */
+static int compare_previous(const char *path)
+{
+    uint8_t *data;
+    size_t size;
+    uint32_t count;
+
+    if (TOOL_ReadFile(path, &data, &size) != 0) {
+        return -1;
+    }
+    if (size < SPARSE_HEADER_SIZE + 4U || TOOL_GetLE32(data) != SPARSE_MAGIC ||
+        TOOL_GetLE32(&data[4]) != SPARSE_VERSION ||
+        SECBOOT_CRC32_Accumulate(0xFFFFFFFFUL, data, size - 4U) != TOOL_GetLE32(&data[size - 4U])) {
+        fprintf(stderr, "secboot_flash: %s: not a sparse image, or corrupt\n", path);
+        free(data);
+        return -1;
+    }
+    count = TOOL_GetLE32(&data[20]);
+    if (count > (size - SPARSE_HEADER_SIZE - 4U) / SPARSE_REGION_SIZE) {
+        fprintf(stderr, "secboot_flash: %s: bad region table\n", path);
+        free(data);
+        return -1;
+    }
+
+    for (uint32_t i = 0U; i < region_count; i++) {
+        FLASH_Region *r = &regions[i];
+
+        for (uint32_t j = 0U; j < count; j++) {
+            const uint8_t *e = &data[SPARSE_HEADER_SIZE + j * SPARSE_REGION_SIZE];
+
+            if (strncmp((const char *)e, r->name, SPARSE_NAME_SIZE) == 0) {
+                bool same = TOOL_GetLE32(&e[16]) == r->address && TOOL_GetLE32(&e[20]) == r->size &&
+                            memcmp(&e[32], r->sha, TOOL_SHA256_SIZE) == 0;
+
+                r->previous = same ? 1 : 0;
+                break;
+            }
+        }
+    }
+    free(data);
+    return 0;
+}
+
+/* Outputs --------------------------------------------------------------*/
+
+static int close_output(FILE *f, const char *path)
+{
+    bool failed = ferror(f) != 0;
+
+    if (fclose(f) != 0 || failed) {
+        fprintf(stderr, "secboot_flash: %s: write error\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+static int write_full(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+
+    if (f == NULL) {
+        fprintf(stderr, "secboot_flash: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    fwrite(flash, 1U, FLASH_SIZE, f);
+    return close_output(f, path);
+}
+
+/** @brief fwrite that keeps the CRC of what was written */
+static void put(FILE *f, const void *p, size_t n, uint32_t *pCrc)
+{
+    *pCrc = SECBOOT_CRC32_Accumulate(*pCrc, p, n);
+    fwrite(p, 1U, n, f);
+}
+
+static int write_sparse(const char *path, bool delta, uint32_t pages)
+{
+    FILE *f = fopen(path, "wb");
+    uint8_t header[SPARSE_HEADER_SIZE] = { 0U };
+    uint32_t crc = 0xFFFFFFFFUL;
+
+    if (f == NULL) {
+        fprintf(stderr, "secboot_flash: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    TOOL_PutLE32(&header[0], SPARSE_MAGIC);
+    TOOL_PutLE32(&header[4], SPARSE_VERSION);
+    TOOL_PutLE32(&header[8], delta ? SPARSE_FLAG_DELTA : 0U);
+    TOOL_PutLE32(&header[12], FLASH_PAGE_SIZE);
+    TOOL_PutLE32(&header[16], FLASH_SIZE);
+    TOOL_PutLE32(&header[20], region_count);
+    TOOL_PutLE32(&header[24], pages);
+    TOOL_PutLE32(&header[28], SECBOOT_CRC32_Accumulate(0xFFFFFFFFUL, flash, FLASH_SIZE));
+    put(f, header, sizeof(header), &crc);
+
+    for (uint32_t i = 0U; i < region_count; i++) {
+        const FLASH_Region *r = &regions[i];
+        uint8_t e[SPARSE_REGION_SIZE] = { 0U };
+
+        memcpy(e, r->name, SPARSE_NAME_SIZE);
+        TOOL_PutLE32(&e[16], r->address);
+        TOOL_PutLE32(&e[20], r->size);
+        TOOL_PutLE32(&e[24], r->crc);
+        TOOL_PutLE32(&e[28], r->pages);
+        memcpy(&e[32], r->sha, TOOL_SHA256_SIZE);
+        put(f, e, sizeof(e), &crc);
+    }
+
+    for (uint32_t p = 0U; p < FLASH_PAGES; p++) {
+        uint8_t offset[4];
+
+        if (erased[p] || skipped[p]) {
+            continue;
+        }
+        TOOL_PutLE32(offset, p * FLASH_PAGE_SIZE);
+        put(f, offset, sizeof(offset), &crc);
+        put(f, &flash[p * FLASH_PAGE_SIZE], FLASH_PAGE_SIZE, &crc);
+    }
+
+    uint8_t trailer[4];
+
+    TOOL_PutLE32(trailer, crc);
+    fwrite(trailer, 1U, sizeof(trailer), f);
+    return close_output(f, path);
+}
+
+static void hex_record(FILE *f, uint8_t type, uint16_t address, const uint8_t *data, uint32_t length)
+{
+    uint8_t sum = (uint8_t)(length + (address >> 8) + address + type);
+
+    fprintf(f, ":%02" PRIX32 "%04X%02X", length, address, type);
+    for (uint32_t i = 0U; i < length; i++) {
+        fprintf(f, "%02X", data[i]);
+        sum = (uint8_t)(sum + data[i]);
+    }
+    fprintf(f, "%02X\n", (uint8_t)(0U - sum));
+}
+
+static int write_hex(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    uint32_t upper = UINT32_MAX;
+
+    if (f == NULL) {
+        fprintf(stderr, "secboot_flash: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    for (uint32_t p = 0U; p < FLASH_PAGES; p++) {
+        uint32_t address = page_address(p * FLASH_PAGE_SIZE);
+
+        if (erased[p] || skipped[p]) {
+            continue;
+        }
+        for (uint32_t off = 0U; off < FLASH_PAGE_SIZE; off += 32U) {
+            const uint8_t *row = &flash[p * FLASH_PAGE_SIZE + off];
+
+            if ((address + off) >> 16 != upper) {
+                uint8_t ext[2];
+
+                upper = (address + off) >> 16;
+                ext[0] = (uint8_t)(upper >> 8);
+                ext[1] = (uint8_t)upper;
+                hex_record(f, 0x04U, 0U, ext, sizeof(ext));
+            }
+            hex_record(f, 0x00U, (uint16_t)(address + off), row, 32U);
+        }
+    }
+    hex_record(f, 0x01U, 0U, NULL, 0U);
+    return close_output(f, path);
+}
+
+/* Report ---------------------------------------------------------------*/
+
+static const char *previous_name(int previous)
+{
+    return (previous > 0) ? "same" : (previous == 0) ? "changed" : "new";
+}
+
+static void print_report(bool comparing, uint32_t pages, uint32_t written)
+{
+    if (csv) {
+        printf("region,address,size,pages,crc32,sha256%s\n", comparing ? ",previous" : "");
+    } else {
+        printf("%-12s  %-10s  %7s  %5s  %-10s  %-16s%s\n", "region", "address", "size", "pages", "crc32", "sha256",
+               comparing ? "  previous" : "");
+    }
+    for (uint32_t i = 0U; i < region_count; i++) {
+        const FLASH_Region *r = &regions[i];
+        char sha[2U * TOOL_SHA256_SIZE + 1U];
+
+        for (uint32_t b = 0U; b < TOOL_SHA256_SIZE; b++) {
+            snprintf(&sha[2U * b], 3, "%02X", r->sha[b]);
+        }
+        if (csv) {
+            printf("%s,0x%08" PRIX32 ",%" PRIu32 ",%" PRIu32 ",0x%08" PRIX32 ",%s", r->name, r->address, r->size,
+                   r->pages, r->crc, sha);
+            printf(comparing ? ",%s\n" : "\n", previous_name(r->previous));
+        } else {
+            sha[16] = '\0';
+            printf("%-12s  0x%08" PRIX32 "  %7" PRIu32 "  %2" PRIu32 "/%-2" PRIu32 "  0x%08" PRIX32 "  %-16s", r->name,
+                   r->address, r->size, r->pages, r->size / FLASH_PAGE_SIZE, r->crc, sha);
+            printf(comparing ? "  %s\n" : "\n", previous_name(r->previous));
+        }
+    }
+    if (!csv) {
+        printf("\n%" PRIu32 " of %u pages not erased, %" PRIu32 " to program (%" PRIu32 " KB of %u KB)\n", pages,
+               FLASH_PAGES, written, written * (FLASH_PAGE_SIZE / 1024U), FLASH_SIZE / 1024U);
+    }
+}
+
+/* Command line ---------------------------------------------------------*/
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [files] [outputs] [-p PREVIOUS [-d]] [-c]\n"
+            "  -b FILE        Bootloader, at 0x%08lX\n"
+            "  -a FILE        Main application image, at 0x%08lX\n"
+            "  -1 FILE        Slot 1 image, at 0x%08lX\n"
+            "  -2 FILE        Slot 2 image, at 0x%08lX\n"
+            "  -u FILE        Update slot image, at 0x%08lX\n"
+            "  -k FILE        Backup image, at 0x%08lX\n"
+            "  -l FILE@ADDR   Any other file (repeatable)\n"
+            "  -o FILE        Full %u KB image\n"
+            "  -s FILE        Sparse image: region checksums and the pages not erased\n"
+            "  -x FILE        Intel HEX of the pages not erased\n"
+            "  -p PREVIOUS    Compare the regions with a previous sparse image\n"
+            "  -d             With -p: leave unchanged regions out of -s and -x\n"
+            "  -e             Leave seal, slots and logger erased\n"
+            "  -c             CSV region report\n"
+            "  -h             This help\n",
+            prog, (unsigned long)SECBOOT_BOOTLOADER_ADDR, (unsigned long)SECBOOT_MAIN_APP_IMAGE_ADDR,
+            (unsigned long)SECBOOT_SLOT1_ADDR, (unsigned long)SECBOOT_SLOT2_ADDR,
+            (unsigned long)SECBOOT_UPDATE_SLOT_ADDR, (unsigned long)SECBOOT_BACKUP_IMAGE_ADDR, FLASH_SIZE / 1024U);
+}
+
+int main(int argc, char **argv)
+{
+    const char *fullPath = NULL;
+    const char *sparsePath = NULL;
+    const char *hexPath = NULL;
+    const char *previousPath = NULL;
+    bool delta = false;
+    uint32_t pages = 0U;
+    uint32_t written = 0U;
+    int rc = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:a:1:2:u:k:l:o:s:x:p:dech")) != -1) {
+        switch (opt) {
+            case 'b':
+                add_file(optarg, SECBOOT_BOOTLOADER_ADDR);
+                break;
+            case 'a':
+                add_file(optarg, SECBOOT_MAIN_APP_IMAGE_ADDR);
+                break;
+            case '1':
+                add_file(optarg, SECBOOT_SLOT1_ADDR);
+                break;
+            case '2':
+                add_file(optarg, SECBOOT_SLOT2_ADDR);
+                break;
+            case 'u':
+                add_file(optarg, SECBOOT_UPDATE_SLOT_ADDR);
+                break;
+            case 'k':
+                add_file(optarg, SECBOOT_BACKUP_IMAGE_ADDR);
+                break;
+            case 'l': {
+                char *at = strrchr(optarg, '@');
+                char *end;
+                unsigned long address;
+
+                if (at == NULL) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                errno = 0;
+                address = strtoul(at + 1, &end, 0);
+                if (errno != 0 || end == at + 1 || *end != '\0' || address > UINT32_MAX) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                *at = '\0';
+                add_file(optarg, (uint32_t)address);
+                break;
+            }
+            case 'o':
+                fullPath = optarg;
+                break;
+            case 's':
+                sparsePath = optarg;
+                break;
+            case 'x':
+                hexPath = optarg;
+                break;
+            case 'p':
+                previousPath = optarg;
+                break;
+            case 'd':
+                delta = true;
+                break;
+            case 'e':
+                erase_state = true;
+                break;
+            case 'c':
+                csv = true;
+                break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (optind != argc || file_count == 0U || (delta && previousPath == NULL)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    build_regions();
+    memset(flash, FLASH_ERASED, sizeof(flash));
+    for (uint32_t i = 0U; i < file_count; i++) {
+        if (place_file(i) != 0) {
+            rc = 1;
+        }
+    }
+    if (rc != 0) {
+        return rc;
+    }
+    for (uint32_t i = 0U; erase_state && i < region_count; i++) {
+        if (regions[i].state) {
+            memset(&flash[flash_offset(regions[i].address)], FLASH_ERASED, regions[i].size);
+        }
+    }
+    for (uint32_t p = 0U; p < FLASH_PAGES; p++) {
+        erased[p] = page_erased(p);
+        pages += erased[p] ? 0U : 1U;
+    }
+    summarise_regions();
+    if (previousPath != NULL && compare_previous(previousPath) != 0) {
+        return 1;
+    }
+
+    // -d: a page is left as the line already has it when every region holding it is unchanged
+    for (uint32_t p = 0U; p < FLASH_PAGES; p++) {
+        skipped[p] = delta;
+        for (uint32_t i = 0U; i < region_count; i++) {
+            if (region_holds(&regions[i], p * FLASH_PAGE_SIZE) && regions[i].previous <= 0) {
+                skipped[p] = false;
+            }
+        }
+        written += (erased[p] || skipped[p]) ? 0U : 1U;
+    }
+
+    if ((fullPath != NULL && write_full(fullPath) != 0) ||
+        (sparsePath != NULL && write_sparse(sparsePath, delta, written) != 0) ||
+        (hexPath != NULL && write_hex(hexPath) != 0)) {
+        rc = 1;
+    }
+    print_report(previousPath != NULL, pages, written);
+    return rc;
+}
@@ -0,0 +1,838 @@
+/**
+  * @file    secboot_fleet.c
+  * @brief   Parallel verification of archives of signed images
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @details Checks every signed image (Secboot_MainApp.bin format) under
+  *          the given files and directory trees the way the bootloader
+  *          does: magic, header CRC, payload (v1) or block table and
+  *          blocks (v2) against firmwareHash, then r||s against the public
+  *          key of the matching bootloader's security block (0x8030).
+  *
+  *          The matching bootloader is the nearest SecBoot_Bootloader.bin
+  *          (-B NAME) in the image's directory or above it, as in the
+  *          Artifacts/ layout; -b uses one bootloader for every image.
+  *          Directories contribute their *.bin files; files named on the
+  *          command line are always checked. Encrypted update images are
+  *          decrypted first when -x gives the AES key.
+  *
+  *          Images are mapped, not read. The sorted list is split into one
+  *          contiguous range per thread; a thread claims up to
+  *          SECBOOT_P256_BATCH_MAX images at a time from the front of its
+  *          range, and an idle thread steals the back half of the largest
+  *          range left. Neighbouring images share a directory and so a key:
+  *          within a claim, v1 payloads are hashed two at a time
+  *          (TOOL_SHA256_Multi, as are the blocks of a v2 image) and the
+  *          signatures of one key are verified as one batch
+  *          (SECBOOT_P256_VerifyBatch).
+  *
+  *          Reports, in path order whatever the thread count, as aligned
+  *          columns, CSV (-c) or JSON (-J): one row per image with its
+  *          verdict (the names of secboot_image verify, plus no_key and
+  *          unreadable), format, size, version, entry point and the
+  *          bootloader used; the columns report ends with a summary.
+  *
+  *          Exit status: 0 when every image is valid, 1 otherwise, 2 on
+  *          usage errors.
+  */
+
+#include "tool_image.h"
+#include "tool_sha256.h"
+#include "secboot_p256.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <libgen.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_BOOTLOADER  "SecBoot_Bootloader.bin"
+#define IMAGE_SUFFIX        ".bin"
+#define CLAIM_SIZE          SECBOOT_P256_BATCH_MAX   /* Images per claim */
+#define MAX_THREADS         256U
+
+/* Verdicts beyond TOOL_Image_StatusTypeDef */
+#define FLEET_NO_KEY        ((int)TOOL_IMAGE_BAD_STREAM + 1)   /* No bootloader found for the image */
+#define FLEET_UNREADABLE    ((int)TOOL_IMAGE_BAD_STREAM + 2)   /* Could not open or map the image */
+#define FLEET_STATUSES      ((int)TOOL_IMAGE_BAD_STREAM + 3)
+
+/* Private types --------------------------------------------------------*/
+
+/** @brief Public key of one bootloader */
+typedef struct {
+    char    *path;
+    uint8_t  q[2U * SECBOOT_P256_SIZE];   /* Qx || Qy */
+    bool     present;                     /* Security block read */
+} FLEET_Key;
+
+/** @brief One image and its verdict */
+typedef struct {
+    char            *path;
+    int32_t          key;                 /* Index into keys[], -1 for none */
+    int              status;
+    uint32_t         badBlock;
+    bool             parsed;              /* h holds a valid header */
+    bool             encrypted;
+    TOOL_ImageHeader h;
+} FLEET_Image;
+
+/** @brief A mapped image, alive for one claim */
+typedef struct {
+    const uint8_t *data;
+    size_t         size;
+    uint8_t       *clear;                 /* Decrypted stream, malloc'd */
+    const uint8_t *stream;                /* What follows the header, clear */
+    size_t         streamLen;
+} FLEET_Map;
+
+/** @brief Thread state; range packs [begin, end) as end << 32 | begin */
+typedef struct {
+    pthread_t        thread;
+    bool             started;
+    _Atomic uint64_t range;
+    uint64_t         bytes;
+} FLEET_Worker;
+
+/** @brief Directory -> key lookup cache entry */
+typedef struct {
+    char   *dir;
+    int32_t key;
+} FLEET_DirKey;
+
+/* Private variables ----------------------------------------------------*/
+static FLEET_Image *images;
+static size_t image_count;
+static size_t image_capacity;
+
+static FLEET_Key *keys;
+static size_t key_count;
+static size_t key_capacity;
+
+static FLEET_DirKey *dir_keys;
+static size_t dir_key_count;
+static size_t dir_key_capacity;
+
+static FLEET_Worker *workers;
+static uint32_t worker_count;
+
+static const char *bootloader_name = DEFAULT_BOOTLOADER;
+static int32_t fixed_key = -1;            /* -b */
+static uint8_t aes_key[32];
+static size_t aes_key_len;
+static bool csv;
+static bool json;
+static bool failures_only;
+static unsigned unreadable_paths;
+
+/* Helpers --------------------------------------------------------------*/
+
+static void *grow(void *array, size_t elem, size_t *pCapacity)
+{
+    size_t capacity = (*pCapacity == 0U) ? 64U : 2U * *pCapacity;
+    void *p = realloc(array, capacity * elem);
+
+    if (p == NULL) {
+        fprintf(stderr, "secboot_fleet: out of memory\n");
+        exit(2);
+    }
+    *pCapacity = capacity;
+    return p;
+}
+
+static const char *status_name(int status)
+{
+    if (status == FLEET_NO_KEY) {
+        return "no_key";
+    }
+    if (status == FLEET_UNREADABLE) {
+        return "unreadable";
+    }
+    return TOOL_Image_StatusName((TOOL_Image_StatusTypeDef)status);
+}
+
+static bool has_suffix(const char *name, const char *suffix)
+{
+    size_t n = strlen(name);
+    size_t m = strlen(suffix);
+
+    return n >= m && strcmp(&name[n - m], suffix) == 0;
+}
+
+static double seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+/* Keys -----------------------------------------------------------------*/
+
+/** @brief Register a bootloader and read its key */
+static int32_t load_key(const char *path)
+{
+    FLEET_Key *key;
+    int fd;
+
+    if (key_count == key_capacity) {
+        keys = grow(keys, sizeof(*keys), &key_capacity);
+    }
+    key = &keys[key_count];
+    memset(key, 0, sizeof(*key));
+    key->path = strdup(path);
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "secboot_fleet: %s: %s\n", path, strerror(errno));
+    } else {
+        key->present = (pread(fd, key->q, sizeof(key->q), TOOL_SECBLOCK_PUBKEY) == (ssize_t)sizeof(key->q));
+        if (!key->present) {
+            fprintf(stderr, "secboot_fleet: %s: no security block\n", path);
+        }
+        close(fd);
+    }
+    return (int32_t)key_count++;
+}
+
+/**
+  * @brief  Key for the images of a directory: its bootloader, else its
+  *         parent's
+  */
+static int32_t key_for_dir(const char *dir)
+{
+    char path[PATH_MAX];
+    char parent[PATH_MAX];
+    struct stat st;
+    int32_t key = -1;
+
+    for (size_t i = dir_key_count; i > 0U; i--) {
+        if (strcmp(dir_keys[i - 1U].dir, dir) == 0) {
+            return dir_keys[i - 1U].key;
+        }
+    }
+
+    if (snprintf(path, sizeof(path), "%s/%s", dir, bootloader_name) < (int)sizeof(path) &&
+        stat(path, &st) == 0 && S_ISREG(st.st_mode)) {
+        key = load_key(path);
+    } else if (strcmp(dir, "/") != 0) {
+        snprintf(parent, sizeof(parent), "%s", dir);
+        key = key_for_dir(dirname(parent));
+    }
+
+    if (dir_key_count == dir_key_capacity) {
+        dir_keys = grow(dir_keys, sizeof(*dir_keys), &dir_key_capacity);
+    }
+    dir_keys[dir_key_count].dir = strdup(dir);
+    dir_keys[dir_key_count].key = key;
+    dir_key_count++;
+    return key;
+}
+
+/* Collection -----------------------------------------------------------*/
+
+static void add_image(const char *path)
+{
+    char dir[PATH_MAX];
+    char *real;
+    FLEET_Image *image;
+
+    if (image_count == image_capacity) {
+        images = grow(images, sizeof(*images), &image_capacity);
+    }
+    image = &images[image_count++];
+    memset(image, 0, sizeof(*image));
+    image->path = strdup(path);
+    image->key = fixed_key;
+    if (fixed_key < 0) {
+        real = realpath(path, NULL);
+        if (real != NULL) {
+            snprintf(dir, sizeof(dir), "%s", real);
+            image->key = key_for_dir(dirname(dir));
+            free(real);
+        }
+    }
+}
+
+static int compare_names(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static void collect(const char *path, bool named)
+{
+    struct stat st;
+
+    if (stat(path, &st) != 0) {
+        fprintf(stderr, "secboot_fleet: %s: %s\n", path, strerror(errno));
+        unreadable_paths++;
+        return;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(path);
+        struct dirent *de;
+        char **names = NULL;
+        size_t count = 0U;
+        size_t capacity = 0U;
+
+        if (dir == NULL) {
+            fprintf(stderr, "secboot_fleet: %s: %s\n", path, strerror(errno));
+            unreadable_paths++;
+            return;
+        }
+        while ((de = readdir(dir)) != NULL) {
+            if (de->d_name[0] == '.') {
+                continue;
+            }
+            if (count == capacity) {
+                names = grow(names, sizeof(*names), &capacity);
+            }
+            if (asprintf(&names[count], "%s/%s", path, de->d_name) < 0) {
+                fprintf(stderr, "secboot_fleet: out of memory\n");
+                exit(2);
+            }
+            count++;
+        }
+        closedir(dir);
+
+        // Sorted, so the report does not depend on the file system
+        qsort(names, count, sizeof(*names), compare_names);
+        for (size_t i = 0U; i < count; i++) {
+            collect(names[i], false);
+            free(names[i]);
+        }
+        free(names);
+    } else if (S_ISREG(st.st_mode)) {
+        const char *base = strrchr(path, '/');
+
+        base = (base != NULL) ? base + 1 : path;
+        if (named || (has_suffix(base, IMAGE_SUFFIX) && strcmp(base, bootloader_name) != 0)) {
+            add_image(path);
+        }
+    }
+}
+
+/* Checks ---------------------------------------------------------------*/
+
+/** @brief Map an image and check its header; status set on failure */
+static bool open_image(FLEET_Image *image, FLEET_Map *map)
+{
+    TOOL_ImageDescriptors d;
+    struct stat st;
+    int fd;
+
+    memset(map, 0, sizeof(*map));
+    fd = open(image->path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        image->status = FLEET_UNREADABLE;
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    if ((size_t)st.st_size < TOOL_FW_HEADER_SIZE) {
+        image->status = TOOL_IMAGE_TRUNCATED;
+        close(fd);
+        return false;
+    }
+    map->size = (size_t)st.st_size;
+    map->data = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map->data == MAP_FAILED) {
+        map->data = NULL;
+        image->status = FLEET_UNREADABLE;
+        return false;
+    }
+    (void)madvise((void *)map->data, map->size, MADV_WILLNEED);
+
+    image->status = TOOL_Image_ParseHeader(map->data, &image->h);
+    if (image->status != TOOL_IMAGE_OK) {
+        return false;
+    }
+    image->parsed = true;
+
+    TOOL_Image_ParseDescriptors(map->data, &d);
+    image->encrypted = d.encrypted;
+    if (d.encrypted) {
+        image->status = TOOL_Image_Decrypt(map->data, map->size, (aes_key_len > 0U) ? aes_key : NULL, aes_key_len,
+                                           &map->clear, &map->streamLen);
+        map->stream = map->clear;
+        if (image->status == TOOL_IMAGE_OK && d.delta) {
+            map->stream = NULL;      /* A patch is checked against its base, on the device */
+        }
+    } else {
+        map->stream = &map->data[TOOL_FW_HEADER_SIZE];
+        map->streamLen = map->size - TOOL_FW_HEADER_SIZE;
+    }
+    if (image->status == TOOL_IMAGE_OK && map->stream != NULL &&
+        map->streamLen < TOOL_Image_StreamSize(&image->h)) {
+        image->status = TOOL_IMAGE_TRUNCATED;
+    }
+    return image->status == TOOL_IMAGE_OK;
+}
+
+static void close_image(FLEET_Map *map)
+{
+    if (map->data != NULL) {
+        munmap((void *)map->data, map->size);
+    }
+    free(map->clear);
+}
+
+/** @brief Verify images [first, first + count) */
+static uint64_t check_claim(uint32_t first, uint32_t count)
+{
+    FLEET_Map maps[CLAIM_SIZE];
+    bool pending[CLAIM_SIZE];
+    const uint8_t *messages[CLAIM_SIZE];
+    size_t lengths[CLAIM_SIZE];
+    uint32_t owners[CLAIM_SIZE];
+    uint8_t digests[CLAIM_SIZE][TOOL_SHA256_SIZE];
+    SECBOOT_P256_BatchEntry entries[CLAIM_SIZE];
+    uint32_t v1 = 0U;
+    uint64_t bytes = 0U;
+
+    for (uint32_t i = 0U; i < count; i++) {
+        FLEET_Image *image = &images[first + i];
+
+        pending[i] = open_image(image, &maps[i]);
+        bytes += maps[i].size;
+        if (!pending[i] || maps[i].stream == NULL) {
+            continue;
+        }
+        if (image->h.magic == TOOL_FW_MAGIC_V2) {
+            image->status = TOOL_Image_CheckStream(&image->h, maps[i].stream, maps[i].streamLen, &image->badBlock);
+            pending[i] = (image->status == TOOL_IMAGE_OK);
+        } else {
+            messages[v1] = maps[i].stream;
+            lengths[v1] = image->h.size;
+            owners[v1++] = i;
+        }
+    }
+
+    // v1 payloads of the claim, hashed two at a time
+    if (v1 > 0U) {
+        TOOL_SHA256_Multi(messages, lengths, v1, digests);
+    }
+    for (uint32_t j = 0U; j < v1; j++) {
+        FLEET_Image *image = &images[first + owners[j]];
+
+        if (memcmp(digests[j], image->h.firmwareHash, TOOL_SHA256_SIZE) != 0) {
+            image->status = TOOL_IMAGE_BAD_HASH;
+            pending[owners[j]] = false;
+        }
+    }
+
+    // Signatures, one batch per key
+    for (uint32_t i = 0U; i < count; i++) {
+        int32_t key = images[first + i].key;
+        uint32_t n = 0U;
+
+        if (!pending[i]) {
+            continue;
+        }
+        if (key < 0 || !keys[key].present) {
+            images[first + i].status = FLEET_NO_KEY;
+            pending[i] = false;
+            continue;
+        }
+        for (uint32_t j = i; j < count; j++) {
+            const TOOL_ImageHeader *h = &images[first + j].h;
+
+            if (pending[j] && images[first + j].key == key) {
+                entries[n].digest = h->firmwareHash;
+                entries[n].r = h->signature;
+                entries[n].s = &h->signature[SECBOOT_P256_SIZE];
+                owners[n++] = j;
+            }
+        }
+        (void)SECBOOT_P256_VerifyBatch(entries, n, keys[key].q, &keys[key].q[SECBOOT_P256_SIZE]);
+        for (uint32_t j = 0U; j < n; j++) {
+            images[first + owners[j]].status = (entries[j].status == SECBOOT_P256_OK) ? TOOL_IMAGE_OK :
+                                               (entries[j].status == SECBOOT_P256_INVALID_PUBKEY) ?
+                                               TOOL_IMAGE_BAD_PUBKEY : TOOL_IMAGE_BAD_SIGNATURE;
+            pending[owners[j]] = false;
+        }
+    }
+
+    for (uint32_t i = 0U; i < count; i++) {
+        close_image(&maps[i]);
+    }
+    return bytes;
+}
+
+/* Scheduler ------------------------------------------------------------*/
+
+#define RANGE(begin, end)  (((uint64_t)(end) << 32) | (uint64_t)(begin))
+#define RANGE_BEGIN(r)     ((uint32_t)(r))
+#define RANGE_END(r)       ((uint32_t)((r) >> 32))
+
+/** @brief Take up to CLAIM_SIZE images from the front of the own range */
+static bool claim(FLEET_Worker *self, uint32_t *pFirst, uint32_t *pCount)
+{
+    uint64_t r = atomic_load(&self->range);
+
+    for (;;) {
+        uint32_t begin = RANGE_BEGIN(r);
+        uint32_t end = RANGE_END(r);
+        uint32_t n = (end - begin < CLAIM_SIZE) ? (end - begin) : CLAIM_SIZE;
+
+        if (n == 0U) {
+            return false;
+        }
+        if (atomic_compare_exchange_weak(&self->range, &r, RANGE(begin + n, end))) {
+            *pFirst = begin;
+            *pCount = n;
+            return true;
+        }
+    }
+}
+
+/** @brief Move the back half of the largest other range to the own one */
+static bool steal(FLEET_Worker *self)
+{
+    for (;;) {
+        FLEET_Worker *victim = NULL;
+        uint64_t best = 0U;
+        uint32_t most = 1U;
+
+        for (uint32_t i = 0U; i < worker_count; i++) {
+            uint64_t r = atomic_load(&workers[i].range);
+
+            if (&workers[i] != self && RANGE_END(r) - RANGE_BEGIN(r) > most) {
+                most = RANGE_END(r) - RANGE_BEGIN(r);
+                best = r;
+                victim = &workers[i];
+            }
+        }
+        if (victim == NULL) {
+            return false;        /* What is left is being claimed by its owners */
+        }
+
+        uint32_t begin = RANGE_BEGIN(best);
+        uint32_t end = RANGE_END(best);
+        uint32_t mid = begin + (end - begin) / 2U;
+
+        // Only the owner moves begin and only thieves move end: one CAS settles both
+        if (atomic_compare_exchange_strong(&victim->range, &best, RANGE(begin, mid))) {
+            atomic_store(&self->range, RANGE(mid, end));
+            return true;
+        }
+    }
+}
+
+static void *worker_main(void *arg)
+{
+    FLEET_Worker *self = arg;
+    uint32_t first;
+    uint32_t count;
+
+    do {
+        while (claim(self, &first, &count)) {
+            self->bytes += check_claim(first, count);
+        }
+    } while (steal(self));
+    return NULL;
+}
+
+/* Report ---------------------------------------------------------------*/
+
+static void print_csv_field(const char *s)
+{
+    if (strpbrk(s, ",\"\n") == NULL) {
+        fputs(s, stdout);
+        return;
+    }
+    putchar('"');
+    for (; *s != '\0'; s++) {
+        if (*s == '"') {
+            putchar('"');
+        }
+        putchar(*s);
+    }
+    putchar('"');
+}
+
+static void print_json_string(const char *s)
+{
+    putchar('"');
+    for (; *s != '\0'; s++) {
+        unsigned char c = (unsigned char)*s;
+
+        if (c == '"' || c == '\\') {
+            printf("\\%c", c);
+        } else if (c < 0x20U) {
+            printf("\\u%04x", c);
+        } else {
+            putchar(c);
+        }
+    }
+    putchar('"');
+}
+
+static void format_image(const FLEET_Image *image, char cells[6][24])
+{
+    const TOOL_ImageHeader *h = &image->h;
+
+    if (image->status == TOOL_IMAGE_BAD_TABLE) {
+        snprintf(cells[0], 24, "%" PRIu32, image->badBlock);
+    } else {
+        cells[0][0] = '\0';
+    }
+    if (!image->parsed) {
+        for (int c = 1; c < 6; c++) {
+            cells[c][0] = '\0';
+        }
+        return;
+    }
+    snprintf(cells[1], 24, "v%d%s", (h->magic == TOOL_FW_MAGIC_V2) ? 2 : 1, image->encrypted ? "+enc" : "");
+    snprintf(cells[2], 24, "%" PRIu32, h->size);
+    snprintf(cells[3], 24, "%u.%u.%u.%u", h->version[0], h->version[1], h->version[2], h->version[3]);
+    snprintf(cells[4], 24, "0x%08" PRIX32, h->entryPoint);
+    for (uint32_t i = 0U; i < 8U; i++) {
+        snprintf(&cells[5][2U * i], 3, "%02X", h->firmwareHash[i]);
+    }
+}
+
+static void print_report(const unsigned *per_status, double elapsed, uint64_t bytes)
+{
+    static const char *const header[] = {
+        "image", "status", "bad_block", "format", "size", "version", "entry", "hash", "bootloader"
+    };
+    int path_width = 5;
+    bool first = true;
+
+    for (size_t i = 0U; i < image_count; i++) {
+        int n = (int)strlen(images[i].path);
+
+        path_width = (n > path_width) ? n : path_width;
+    }
+
+    if (json) {
+        printf("{\n  \"images\": [");
+    } else if (csv) {
+        for (int c = 0; c < 9; c++) {
+            printf((c > 0) ? ",%s" : "%s", header[c]);
+        }
+        putchar('\n');
+    } else {
+        printf("%-*s  %-14s  %9s  %-6s  %7s  %-15s  %-10s  %-16s  %s\n", path_width, header[0], header[1], header[2],
+               header[3], header[4], header[5], header[6], header[7], header[8]);
+    }
+
+    for (size_t i = 0U; i < image_count; i++) {
+        const FLEET_Image *image = &images[i];
+        const char *key = (image->key >= 0) ? keys[image->key].path : "";
+        char cells[6][24];
+
+        if (failures_only && image->status == TOOL_IMAGE_OK) {
+            continue;
+        }
+        format_image(image, cells);
+
+        if (json) {
+            printf("%s\n    {\"image\": ", first ? "" : ",");
+            print_json_string(image->path);
+            printf(", \"status\": \"%s\"", status_name(image->status));
+            if (image->status == TOOL_IMAGE_BAD_TABLE) {
+                printf(", \"bad_block\": %s", cells[0]);
+            }
+            if (image->parsed) {
+                printf(", \"format\": \"%s\", \"size\": %s, \"version\": \"%s\", \"entry\": \"%s\", \"hash\": \"",
+                       cells[1], cells[2], cells[3], cells[4]);
+                for (uint32_t b = 0U; b < TOOL_SHA256_SIZE; b++) {
+                    printf("%02X", image->h.firmwareHash[b]);
+                }
+                putchar('"');
+            }
+            printf(", \"bootloader\": ");
+            if (image->key >= 0) {
+                print_json_string(key);
+            } else {
+                printf("null");
+            }
+            putchar('}');
+        } else if (csv) {
+            print_csv_field(image->path);
+            printf(",%s,%s,%s,%s,%s,%s,", status_name(image->status), cells[0], cells[1], cells[2], cells[3],
+                   cells[4]);
+            for (uint32_t b = 0U; image->parsed && b < TOOL_SHA256_SIZE; b++) {
+                printf("%02X", image->h.firmwareHash[b]);
+            }
+            putchar(',');
+            print_csv_field(key);
+            putchar('\n');
+        } else {
+            printf("%-*s  %-14s  %9s  %-6s  %7s  %-15s  %-10s  %-16s  %s\n", path_width, image->path,
+                   status_name(image->status), cells[0], cells[1], cells[2], cells[3], cells[4], cells[5], key);
+        }
+        first = false;
+    }
+
+    if (json) {
+        printf("%s],\n  \"summary\": {\"images\": %zu, \"ok\": %u, \"failed\": %zu, \"statuses\": {",
+               first ? "" : "\n  ", image_count, per_status[TOOL_IMAGE_OK], image_count - per_status[TOOL_IMAGE_OK]);
+        first = true;
+        for (int s = 1; s < FLEET_STATUSES; s++) {
+            if (per_status[s] > 0U) {
+                printf("%s\"%s\": %u", first ? "" : ", ", status_name(s), per_status[s]);
+                first = false;
+            }
+        }
+        printf("}, \"bytes\": %" PRIu64 ", \"seconds\": %.3f, \"threads\": %" PRIu32 "}\n}\n", bytes, elapsed,
+               worker_count);
+    } else if (!csv) {
+        printf("\nImages: %zu, ok %u, failed %zu", image_count, per_status[TOOL_IMAGE_OK],
+               image_count - per_status[TOOL_IMAGE_OK]);
+        for (int s = 1; s < FLEET_STATUSES; s++) {
+            if (per_status[s] > 0U) {
+                printf(", %s %u", status_name(s), per_status[s]);
+            }
+        }
+        printf("\n%.1f MB in %.3f s, %" PRIu32 " thread%s, SHA-256 on %s\n", (double)bytes / 1e6, elapsed,
+               worker_count, (worker_count == 1U) ? "" : "s", TOOL_SHA256_Engine());
+    }
+}
+
+/* Command line ---------------------------------------------------------*/
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options] IMAGE|DIR...\n"
+            "  IMAGE          Signed image; DIR is searched recursively for *%s\n"
+            "  -b BOOTLOADER  Verify every image against this bootloader's key\n"
+            "                 (default: the nearest %s at or above the image)\n"
+            "  -B NAME        Bootloader file name to look for\n"
+            "  -x AES_KEY     Decrypt encrypted update images (hex or @FILE)\n"
+            "  -t THREADS     Worker threads (default: online CPUs)\n"
+            "  -c             CSV instead of aligned columns\n"
+            "  -J             JSON instead of aligned columns\n"
+            "  -f             Report the failed images only\n"
+            "  -h             This help\n",
+            prog, IMAGE_SUFFIX, DEFAULT_BOOTLOADER);
+}
+
+int main(int argc, char **argv)
+{
+    const char *bootPath = NULL;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned per_status[FLEET_STATUSES] = { 0U };
+    uint64_t bytes = 0U;
+    double start;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:B:x:t:cJfh")) != -1) {
+        switch (opt) {
+            case 'b':
+                bootPath = optarg;
+                break;
+            case 'B':
+                bootloader_name = optarg;
+                break;
+            case 'x': {
+                int n = TOOL_ParseHex(optarg, aes_key, sizeof(aes_key));
+
+                if (n != 16 && n != 32) {
+                    fprintf(stderr, "secboot_fleet: bad AES key\n");
+                    return 2;
+                }
+                aes_key_len = (size_t)n;
+                break;
+            }
+            case 't': {
+                char *end;
+
+                threads = strtol(optarg, &end, 0);
+                if (*end != '\0' || threads < 1 || threads > (long)MAX_THREADS) {
+                    fprintf(stderr, "secboot_fleet: bad thread count '%s'\n", optarg);
+                    return 2;
+                }
+                break;
+            }
+            case 'c':
+                csv = true;
+                break;
+            case 'J':
+                json = true;
+                break;
+            case 'f':
+                failures_only = true;
+                break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (optind >= argc || (csv && json)) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (bootPath != NULL) {
+        fixed_key = load_key(bootPath);
+        if (!keys[fixed_key].present) {
+            return 1;
+        }
+    }
+
+    start = seconds();
+    for (int i = optind; i < argc; i++) {
+        collect(argv[i], true);
+    }
+    if (image_count > UINT32_MAX) {
+        fprintf(stderr, "secboot_fleet: too many images\n");
+        return 2;
+    }
+
+    // One contiguous range per thread; block functions resolved before they start
+    (void)TOOL_SHA256_Engine();
+    if (threads < 1) {
+        threads = 1;
+    }
+    worker_count = (image_count < (size_t)threads) ? (uint32_t)((image_count > 0U) ? image_count : 1U) :
+                   (uint32_t)threads;
+    workers = calloc(worker_count, sizeof(*workers));
+    if (workers == NULL) {
+        fprintf(stderr, "secboot_fleet: out of memory\n");
+        return 2;
+    }
+    for (uint32_t w = 0U; w < worker_count; w++) {
+        atomic_init(&workers[w].range, RANGE(image_count * w / worker_count, image_count * (w + 1U) / worker_count));
+    }
+    for (uint32_t w = 1U; w < worker_count; w++) {
+        workers[w].started = (pthread_create(&workers[w].thread, NULL, worker_main, &workers[w]) == 0);
+    }
+    (void)worker_main(&workers[0]);
+    for (uint32_t w = 1U; w < worker_count; w++) {
+        if (workers[w].started) {
+            pthread_join(workers[w].thread, NULL);
+        } else {
+            (void)worker_main(&workers[w]);     /* Drain what the thieves left */
+        }
+    }
+    for (uint32_t w = 0U; w < worker_count; w++) {
+        bytes += workers[w].bytes;
+    }
+
+    for (size_t i = 0U; i < image_count; i++) {
+        per_status[images[i].status]++;
+    }
+    print_report(per_status, seconds() - start, bytes);
+
+    return (per_status[TOOL_IMAGE_OK] == image_count && unreadable_paths == 0U) ? 0 : 1;
+}
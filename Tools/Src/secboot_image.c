@@ -0,0 +1,975 @@
+/**
+  * @file    secboot_image.c
+  * @brief   Signing, bootloader building and checks of SecBoot images
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @details Native replacement of the release steps of
+  *          stm32_application_signer.py and stm32_secure_boot_builder.py,
+  *          writing the same bytes for the same inputs:
+  *          - sign:              raw application -> signed image (v1 or
+  *                               v2), optionally the encrypted (CTR/GCM,
+  *                               optionally LZSS) update image too
+  *          - build-bootloader:  SecBoot_S.bin -> bootloader with the
+  *                               security block at 0x8000
+  *          - verify:            magic, header CRC, payload or block table
+  *                               against firmwareHash, r||s against the
+  *                               key; encrypted update images are
+  *                               decrypted first when the key is given
+  *          - inspect:           header, descriptors or security block
+  *          - pad:               pad a raw binary with 0xFF to a fixed size
+  *
+  *          The signature is the one difference from the scripts: they
+  *          draw the ECDSA nonce at random, this tool derives it per
+  *          RFC 6979, so r||s (and the header CRC over it) differ from any
+  *          one script run but are as valid, and repeat for the same key
+  *          and payload. Update image IVs are random unless -n pins them.
+  *
+  *          CRC-32 is the slicing-by-8 secboot_crc32.c, SHA-256 runs on the
+  *          SHA extensions when the CPU has them (tool_sha256.c), and the
+  *          payload is streamed through fixed buffers; only LZSS
+  *          compression holds the whole stream.
+  *
+  *          AES keys are hex on the command line, "@FILE" for a file
+  *          holding the hex, or else read from the environment:
+  *          SECBOOT_AES_KEY_1, SECBOOT_AES_KEY_2 and SECBOOT_AES_IV, the
+  *          names store_keys.py gives them in the keyring.
+  *
+  *          Exit status: 0 on success (verify: every image valid), 1 when
+  *          an image failed or a file could not be processed, 2 on usage
+  *          errors.
+  */
+
+#include "tool_aes.h"
+#include "tool_image.h"
+#include "tool_lz.h"
+#include "tool_sha256.h"
+#include "secboot_crc32.h"
+#include "secboot_p256.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+#include <sys/stat.h>
+
+#define IO_BUFFER_SIZE       (32U * TOOL_FW_BLOCK_SIZE)   /* Multiple of the block and AES sizes */
+#define DEFAULT_ENTRY_POINT  0x08040100UL                 /* Slot A, as the signer is configured */
+#define NONCE_SIZE           TOOL_AES_GCM_IV_SIZE         /* Random part of the update image IV */
+
+/* Private types --------------------------------------------------------*/
+
+/** @brief Buffered output, encrypting on the way when a mode is set */
+typedef struct {
+    FILE        *f;
+    const char  *path;
+    int          mode;          /* -1 clear, else TOOL_FW_ENC_MODE_ */
+    TOOL_AES_Key key;
+    uint8_t      counter[TOOL_AES_BLOCK_SIZE];
+    TOOL_AES_GCM gcm;
+    uint8_t      buf[IO_BUFFER_SIZE];
+    size_t       len;
+    bool         failed;
+} IMG_Writer;
+
+/** @brief sign options */
+typedef struct {
+    const char *keyPath;
+    const char *outPath;
+    const char *encPath;
+    int         format;
+    uint8_t     version[4];
+    uint32_t    entryPoint;
+    int         encMode;        /* -1: no update image */
+    uint8_t     aesKey[32];
+    size_t      aesKeyLen;
+    uint8_t     nonce[NONCE_SIZE];
+    bool        nonceSet;
+    bool        compress;
+} IMG_SignOptions;
+
+/* Private variables ----------------------------------------------------*/
+static uint8_t io_buffer[IO_BUFFER_SIZE];
+
+/* Helpers --------------------------------------------------------------*/
+
+static void print_hex(const uint8_t *p, size_t n)
+{
+    for (size_t i = 0U; i < n; i++) {
+        printf("%02X", p[i]);
+    }
+}
+
+static int parse_u32(const char *arg, uint32_t *pValue)
+{
+    char *end;
+    unsigned long v;
+
+    errno = 0;
+    v = strtoul(arg, &end, 0);
+    if (errno != 0 || *end != '\0' || arg[0] == '\0' || v > UINT32_MAX) {
+        return -1;
+    }
+    *pValue = (uint32_t)v;
+    return 0;
+}
+
+static int parse_version(const char *arg, uint8_t version[4])
+{
+    unsigned v[4];
+    char extra;
+
+    if (sscanf(arg, "%u.%u.%u.%u%c", &v[0], &v[1], &v[2], &v[3], &extra) != 4 ||
+        v[0] > 255U || v[1] > 255U || v[2] > 255U || v[3] > 255U) {
+        return -1;
+    }
+    for (int i = 0; i < 4; i++) {
+        version[i] = (uint8_t)v[i];
+    }
+    return 0;
+}
+
+static FILE *open_input(const char *path, size_t *pSize)
+{
+    FILE *f = fopen(path, "rb");
+    struct stat st;
+
+    if (f == NULL || fstat(fileno(f), &st) != 0) {
+        fprintf(stderr, "secboot_image: %s: %s\n", path, strerror(errno));
+        if (f != NULL) {
+            fclose(f);
+        }
+        return NULL;
+    }
+    *pSize = (size_t)st.st_size;
+    return f;
+}
+
+static int read_exact(FILE *f, const char *path, uint8_t *p, size_t n)
+{
+    if (fread(p, 1, n, f) != n) {
+        fprintf(stderr, "secboot_image: %s: short read\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+/* Writer ---------------------------------------------------------------*/
+
+static int writer_open(IMG_Writer *w, const char *path)
+{
+    memset(w, 0, offsetof(IMG_Writer, buf));
+    w->path = path;
+    w->mode = -1;
+    w->f = fopen(path, "wb");
+    if (w->f == NULL) {
+        fprintf(stderr, "secboot_image: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+static void writer_flush(IMG_Writer *w)
+{
+    if (w->len == 0U) {
+        return;
+    }
+    if (w->mode == (int)TOOL_FW_ENC_MODE_CTR) {
+        TOOL_AES_CTR(&w->key, w->counter, w->buf, w->buf, w->len);
+    } else if (w->mode == (int)TOOL_FW_ENC_MODE_GCM) {
+        TOOL_AES_GCM_Encrypt(&w->gcm, w->buf, w->buf, w->len);
+    }
+    if (fwrite(w->buf, 1, w->len, w->f) != w->len) {
+        w->failed = true;
+    }
+    w->len = 0U;
+}
+
+static void writer_put(IMG_Writer *w, const uint8_t *p, size_t n)
+{
+    while (n > 0U) {
+        size_t take = sizeof(w->buf) - w->len;
+
+        if (take > n) {
+            take = n;
+        }
+        memcpy(&w->buf[w->len], p, take);
+        w->len += take;
+        p += take;
+        n -= take;
+        if (w->len == sizeof(w->buf)) {
+            writer_flush(w);
+        }
+    }
+}
+
+static void writer_fill(IMG_Writer *w, uint8_t value, size_t n)
+{
+    uint8_t fill[64];
+
+    memset(fill, value, sizeof(fill));
+    while (n > 0U) {
+        size_t take = (n < sizeof(fill)) ? n : sizeof(fill);
+
+        writer_put(w, fill, take);
+        n -= take;
+    }
+}
+
+/** @brief Stream size bytes of in to w */
+static int writer_copy(IMG_Writer *w, FILE *in, const char *inPath, size_t size)
+{
+    while (size > 0U) {
+        size_t n = (size < sizeof(io_buffer)) ? size : sizeof(io_buffer);
+
+        if (read_exact(in, inPath, io_buffer, n) != 0) {
+            return -1;
+        }
+        writer_put(w, io_buffer, n);
+        size -= n;
+    }
+    return 0;
+}
+
+static int writer_close(IMG_Writer *w)
+{
+    writer_flush(w);
+    if (fclose(w->f) != 0 || w->failed) {
+        fprintf(stderr, "secboot_image: %s: write failed\n", w->path);
+        return -1;
+    }
+    return 0;
+}
+
+/* sign -----------------------------------------------------------------*/
+
+/**
+  * @brief  Write the update image: clear header with the descriptors, then
+  *         payload, v2 pad and table as one encrypted (compressed) stream
+  */
+static int sign_update_image(const IMG_SignOptions *o, const uint8_t header[TOOL_FW_HEADER_SIZE], FILE *in,
+                             const char *inPath, size_t size, const uint8_t *table, size_t tableLen, size_t pad)
+{
+    uint8_t encHeader[TOOL_FW_HEADER_SIZE];
+    uint8_t iv[TOOL_AES_BLOCK_SIZE] = { 0U };
+    uint8_t tag[TOOL_AES_GCM_TAG_SIZE];
+    size_t streamLen = size + pad + tableLen;
+    uint8_t *stream = NULL;
+    uint8_t *packed = NULL;
+    size_t packedLen = 0U;
+    IMG_Writer *w = malloc(sizeof(*w));
+    int rc = -1;
+
+    if (w == NULL) {
+        return -1;
+    }
+
+    if (o->nonceSet) {
+        memcpy(iv, o->nonce, NONCE_SIZE);
+    } else if (getrandom(iv, NONCE_SIZE, 0) != (ssize_t)NONCE_SIZE) {
+        fprintf(stderr, "secboot_image: no random IV: %s\n", strerror(errno));
+        free(w);
+        return -1;
+    }
+
+    /* Compression needs the whole stream; a stream that does not shrink is stored as is */
+    if (o->compress) {
+        stream = malloc(streamLen + 1U);
+        if (stream == NULL || fseek(in, 0, SEEK_SET) != 0 || read_exact(in, inPath, stream, size) != 0) {
+            goto done;
+        }
+        memset(&stream[size], 0xFF, pad);
+        memcpy(&stream[size + pad], table, tableLen);
+        packed = TOOL_LZ_Compress(stream, streamLen, &packedLen);
+        if (packed == NULL) {
+            fprintf(stderr, "secboot_image: out of memory\n");
+            goto done;
+        }
+        if (packedLen >= streamLen) {
+            fprintf(stderr, "secboot_image: warning: LZSS does not shrink the stream (%zu bytes), "
+                    "storing it uncompressed\n", packedLen);
+            free(packed);
+            packed = NULL;
+        }
+    }
+
+    memcpy(encHeader, header, sizeof(encHeader));
+    TOOL_PutLE32(&encHeader[TOOL_FW_ENC_INFO_OFFSET], TOOL_FW_ENC_MAGIC);
+    TOOL_PutLE32(&encHeader[TOOL_FW_ENC_INFO_OFFSET + 4U], (uint32_t)o->encMode);
+    memcpy(&encHeader[TOOL_FW_ENC_INFO_OFFSET + 8U], iv, sizeof(iv));
+    memset(&encHeader[TOOL_FW_ENC_INFO_OFFSET + 24U], 0xFF, sizeof(tag));
+    if (packed != NULL) {
+        TOOL_PutLE32(&encHeader[TOOL_FW_COMP_INFO_OFFSET], TOOL_FW_COMP_MAGIC_LZSS);
+        TOOL_PutLE32(&encHeader[TOOL_FW_COMP_INFO_OFFSET + 4U], (uint32_t)packedLen);
+    }
+
+    if (writer_open(w, o->encPath) != 0) {
+        goto done;
+    }
+    writer_put(w, encHeader, sizeof(encHeader));
+    writer_flush(w);
+
+    (void)TOOL_AES_SetKey(&w->key, o->aesKey, o->aesKeyLen);
+    w->mode = o->encMode;
+    memcpy(w->counter, iv, sizeof(iv));
+    if (o->encMode == (int)TOOL_FW_ENC_MODE_GCM) {
+        /* The clear header fields are authenticated as AAD */
+        TOOL_AES_GCM_Start(&w->gcm, &w->key, iv, header, TOOL_FW_HEADER_FIELDS);
+    }
+
+    if (packed != NULL) {
+        writer_put(w, packed, packedLen);
+    } else if (stream != NULL) {
+        writer_put(w, stream, streamLen);
+    } else {
+        if (fseek(in, 0, SEEK_SET) != 0 || writer_copy(w, in, inPath, size) != 0) {
+            fclose(w->f);
+            goto done;
+        }
+        writer_fill(w, 0xFF, pad);
+        writer_put(w, table, tableLen);
+    }
+    writer_flush(w);
+
+    /* The tag is known last: patch it into the header */
+    if (o->encMode == (int)TOOL_FW_ENC_MODE_GCM) {
+        TOOL_AES_GCM_Tag(&w->gcm, tag);
+        if (fseek(w->f, TOOL_FW_ENC_INFO_OFFSET + 24L, SEEK_SET) != 0 ||
+            fwrite(tag, 1, sizeof(tag), w->f) != sizeof(tag)) {
+            w->failed = true;
+        }
+    }
+    w->mode = -1;
+    if (writer_close(w) != 0) {
+        goto done;
+    }
+
+    printf("update   %s  AES-%zu-%s  IV ", o->encPath, o->aesKeyLen * 8U, (o->encMode == 0) ? "CTR" : "GCM");
+    print_hex(iv, sizeof(iv));
+    if (packed != NULL) {
+        printf("  LZSS %zu -> %zu bytes (%.1f%%)", streamLen, packedLen, 100.0 * (double)packedLen / (double)streamLen);
+    }
+    printf("\n");
+    rc = 0;
+
+done:
+    free(stream);
+    free(packed);
+    memset(w, 0, sizeof(*w));
+    free(w);
+    return rc;
+}
+
+static int cmd_sign(const IMG_SignOptions *o, const char *inPath)
+{
+    TOOL_ImageHeader h;
+    TOOL_SHA256_Context ctx;
+    uint8_t header[TOOL_FW_HEADER_SIZE];
+    uint8_t d[SECBOOT_P256_SIZE];
+    uint8_t *table = NULL;
+    size_t tableLen = 0U;
+    size_t pad = 0U;
+    size_t size;
+    size_t done = 0U;
+    IMG_Writer *w = NULL;
+    FILE *in;
+    int rc = 1;
+
+    if (TOOL_LoadPrivateKey(o->keyPath, d) != 0) {
+        return 1;
+    }
+    in = open_input(inPath, &size);
+    if (in == NULL) {
+        return 1;
+    }
+    if (size > UINT32_MAX) {
+        fprintf(stderr, "secboot_image: %s: too large\n", inPath);
+        goto done;
+    }
+
+    /* Pass 1: digest, v2 one hash per block and the hash of the table */
+    memset(&h, 0, sizeof(h));
+    h.magic = (o->format == 1) ? TOOL_FW_MAGIC_V1 : TOOL_FW_MAGIC_V2;
+    h.size = (uint32_t)size;
+    memcpy(h.version, o->version, sizeof(h.version));
+    h.entryPoint = o->entryPoint;
+    if (o->format == 2) {
+        tableLen = (size_t)TOOL_FW_BLOCK_COUNT(size) * TOOL_SHA256_SIZE;
+        pad = TOOL_FW_TABLE_OFFSET(size) - size;
+        table = malloc(tableLen + 1U);
+        if (table == NULL) {
+            fprintf(stderr, "secboot_image: out of memory\n");
+            goto done;
+        }
+    }
+    TOOL_SHA256_Init(&ctx);
+    while (done < size) {
+        size_t n = (size - done < sizeof(io_buffer)) ? (size - done) : sizeof(io_buffer);
+
+        if (read_exact(in, inPath, io_buffer, n) != 0) {
+            goto done;
+        }
+        if (o->format == 2) {
+            for (size_t off = 0U; off < n; off += TOOL_FW_BLOCK_SIZE) {
+                size_t blockLen = (n - off < TOOL_FW_BLOCK_SIZE) ? (n - off) : TOOL_FW_BLOCK_SIZE;
+
+                TOOL_SHA256(&io_buffer[off], blockLen, &table[((done + off) / TOOL_FW_BLOCK_SIZE) * TOOL_SHA256_SIZE]);
+            }
+        } else {
+            TOOL_SHA256_Update(&ctx, io_buffer, n);
+        }
+        done += n;
+    }
+    if (o->format == 2) {
+        TOOL_SHA256_Update(&ctx, table, tableLen);
+    }
+    TOOL_SHA256_Final(&ctx, h.firmwareHash);
+
+    if (TOOL_Sign(h.firmwareHash, d, h.signature) != 0) {
+        fprintf(stderr, "secboot_image: %s: signing failed\n", o->keyPath);
+        goto done;
+    }
+    TOOL_Image_BuildHeader(&h, header);
+
+    /* Pass 2: header, payload, v2 pad and table */
+    w = malloc(sizeof(*w));
+    if (w == NULL || fseek(in, 0, SEEK_SET) != 0 || writer_open(w, o->outPath) != 0) {
+        goto done;
+    }
+    writer_put(w, header, sizeof(header));
+    if (writer_copy(w, in, inPath, size) != 0) {
+        fclose(w->f);
+        goto done;
+    }
+    writer_fill(w, 0xFF, pad);
+    writer_put(w, table, tableLen);
+    if (writer_close(w) != 0) {
+        goto done;
+    }
+
+    printf("signed   %s  v%d  %zu bytes  version %u.%u.%u.%u  entry 0x%08lX\n", o->outPath, o->format,
+           TOOL_FW_HEADER_SIZE + size + pad + tableLen, h.version[0], h.version[1], h.version[2], h.version[3],
+           (unsigned long)h.entryPoint);
+    printf("         %s ", (o->format == 2) ? "root  " : "sha256");
+    print_hex(h.firmwareHash, sizeof(h.firmwareHash));
+    printf("  crc 0x%08lX\n", (unsigned long)h.headerCRC);
+
+    if (o->encMode >= 0 && sign_update_image(o, header, in, inPath, size, table, tableLen, pad) != 0) {
+        goto done;
+    }
+    rc = 0;
+
+done:
+    memset(d, 0, sizeof(d));
+    free(table);
+    free(w);
+    fclose(in);
+    return rc;
+}
+
+/* build-bootloader -----------------------------------------------------*/
+
+static int cmd_build_bootloader(const char *keyPath, const char *outPath, const char *key1Arg, const char *key2Arg,
+                                const char *ivArg, const char *inPath)
+{
+    static const size_t key1Sizes[] = { 16U, 0U };
+    static const size_t key2Sizes[] = { 16U, 32U, 0U };
+    static const size_t ivSizes[] = { 16U, 0U };
+    uint8_t d[SECBOOT_P256_SIZE];
+    uint8_t qx[SECBOOT_P256_SIZE];
+    uint8_t qy[SECBOOT_P256_SIZE];
+    uint8_t key1[16];
+    uint8_t key2[32];
+    uint8_t iv[16];
+    uint8_t wrapped[TOOL_WRAPPED_KEY_SIZE];
+    uint8_t block[TOOL_SECBLOCK_SIZE];
+    int key2Len;
+    uint32_t crc = 0xFFFFFFFFUL;
+    size_t size;
+    IMG_Writer *w = NULL;
+    FILE *in = NULL;
+    int rc = 1;
+
+    if (TOOL_KeyArgument(key1Arg, "SECBOOT_AES_KEY_1", "AES_KEY1", key1, sizeof(key1), key1Sizes) < 0 ||
+        (key2Len = TOOL_KeyArgument(key2Arg, "SECBOOT_AES_KEY_2", "AES_KEY2", key2, sizeof(key2), key2Sizes)) < 0 ||
+        TOOL_KeyArgument(ivArg, "SECBOOT_AES_IV", "AES_IV", iv, sizeof(iv), ivSizes) < 0) {
+        return 2;
+    }
+    if (TOOL_LoadPrivateKey(keyPath, d) != 0 || SECBOOT_P256_PublicKey(d, qx, qy) != SECBOOT_P256_OK) {
+        goto done;
+    }
+    (void)TOOL_WrapKey(key1, sizeof(key1), key2, (size_t)key2Len, iv, wrapped);
+
+    in = open_input(inPath, &size);
+    if (in == NULL) {
+        goto done;
+    }
+    if (size != TOOL_BOOTLOADER_IMAGE_SIZE) {
+        fprintf(stderr, "secboot_image: %s: %zu bytes, the bootloader must be exactly %u (see pad)\n", inPath, size,
+                TOOL_BOOTLOADER_IMAGE_SIZE);
+        goto done;
+    }
+
+    /* The CRC covers what precedes the block; the block replaces its bytes */
+    w = malloc(sizeof(*w));
+    if (w == NULL || writer_open(w, outPath) != 0) {
+        goto done;
+    }
+    for (size_t done = 0U; done < TOOL_SECBLOCK_OFFSET;) {
+        size_t n = (TOOL_SECBLOCK_OFFSET - done < sizeof(io_buffer)) ? (TOOL_SECBLOCK_OFFSET - done) : sizeof(io_buffer);
+
+        if (read_exact(in, inPath, io_buffer, n) != 0) {
+            fclose(w->f);
+            goto done;
+        }
+        crc = SECBOOT_CRC32_Accumulate(crc, io_buffer, n);
+        writer_put(w, io_buffer, n);
+        done += n;
+    }
+    TOOL_BuildSecBlock(wrapped, iv, qx, qy, crc, block);
+    writer_put(w, block, sizeof(block));
+    if (fseek(in, (long)sizeof(block), SEEK_CUR) != 0 ||
+        writer_copy(w, in, inPath, size - TOOL_SECBLOCK_OFFSET - sizeof(block)) != 0) {
+        fclose(w->f);
+        goto done;
+    }
+    if (writer_close(w) != 0) {
+        goto done;
+    }
+
+    printf("bootloader %s  %zu bytes  crc 0x%08lX over 0x%X bytes\n", outPath, size, (unsigned long)crc,
+           TOOL_SECBLOCK_OFFSET);
+    printf("           Qx ");
+    print_hex(qx, sizeof(qx));
+    printf("\n           Qy ");
+    print_hex(qy, sizeof(qy));
+    printf("\n");
+    rc = 0;
+
+done:
+    memset(d, 0, sizeof(d));
+    memset(key1, 0, sizeof(key1));
+    memset(key2, 0, sizeof(key2));
+    memset(wrapped, 0, sizeof(wrapped));
+    free(w);
+    if (in != NULL) {
+        fclose(in);
+    }
+    return rc;
+}
+
+/* verify ---------------------------------------------------------------*/
+
+/**
+  * @brief  Check one image file
+  * @retval TOOL_IMAGE_OK or the first failure
+  */
+static TOOL_Image_StatusTypeDef verify_image(const char *path, const uint8_t *qx, const uint8_t *qy,
+                                             const uint8_t *aesKey, size_t aesKeyLen, TOOL_ImageHeader *h,
+                                             TOOL_ImageDescriptors *d, uint32_t *pBadBlock)
+{
+    TOOL_Image_StatusTypeDef status;
+    uint8_t *data;
+    uint8_t *stream = NULL;
+    size_t size;
+    size_t streamLen;
+
+    if (TOOL_ReadFile(path, &data, &size) != 0) {
+        return TOOL_IMAGE_TRUNCATED;
+    }
+    if (size < TOOL_FW_HEADER_SIZE) {
+        free(data);
+        return TOOL_IMAGE_TRUNCATED;
+    }
+
+    status = TOOL_Image_ParseHeader(data, h);
+    TOOL_Image_ParseDescriptors(data, d);
+    if (status == TOOL_IMAGE_OK) {
+        status = TOOL_Image_CheckSignature(h, qx, qy);
+    }
+    if (status == TOOL_IMAGE_OK && d->encrypted) {
+        status = TOOL_Image_Decrypt(data, size, aesKey, aesKeyLen, &stream, &streamLen);
+    }
+    /* A delta patch is checked when applied, against its base */
+    if (status == TOOL_IMAGE_OK && !d->delta) {
+        if (stream != NULL) {
+            status = TOOL_Image_CheckStream(h, stream, streamLen, pBadBlock);
+        } else {
+            status = TOOL_Image_CheckStream(h, &data[TOOL_FW_HEADER_SIZE], size - TOOL_FW_HEADER_SIZE, pBadBlock);
+        }
+    }
+
+    free(stream);
+    free(data);
+    return status;
+}
+
+static int cmd_verify(int count, char **paths, const uint8_t *qx, const uint8_t *qy, const uint8_t *aesKey,
+                      size_t aesKeyLen)
+{
+    int failed = 0;
+
+    for (int i = 0; i < count; i++) {
+        TOOL_ImageHeader h;
+        TOOL_ImageDescriptors d;
+        uint32_t badBlock = 0U;
+        TOOL_Image_StatusTypeDef status;
+
+        memset(&h, 0, sizeof(h));
+        status = verify_image(paths[i], qx, qy, aesKey, aesKeyLen, &h, &d, &badBlock);
+        printf("%s: %s", paths[i], TOOL_Image_StatusName(status));
+        if (status == TOOL_IMAGE_BAD_TABLE) {
+            printf(" (block %lu)", (unsigned long)badBlock);
+        }
+        if (status == TOOL_IMAGE_OK) {
+            printf("  v%d  %lu bytes  version %u.%u.%u.%u  entry 0x%08lX%s%s", (h.magic == TOOL_FW_MAGIC_V2) ? 2 : 1,
+                   (unsigned long)h.size, h.version[0], h.version[1], h.version[2], h.version[3],
+                   (unsigned long)h.entryPoint, d.encrypted ? "  encrypted" : "",
+                   d.delta ? "  delta (patch not checked)" : "");
+        }
+        printf("\n");
+        failed |= (status != TOOL_IMAGE_OK);
+    }
+    return failed;
+}
+
+/* inspect --------------------------------------------------------------*/
+
+static void inspect_image(const uint8_t *data, size_t size)
+{
+    TOOL_ImageHeader h;
+    TOOL_ImageDescriptors d;
+    TOOL_Image_StatusTypeDef status = TOOL_Image_ParseHeader(data, &h);
+
+    TOOL_Image_ParseDescriptors(data, &d);
+    printf("  format      v%d (magic 0x%08lX)\n", (h.magic == TOOL_FW_MAGIC_V2) ? 2 : 1, (unsigned long)h.magic);
+    printf("  payload     %lu bytes, stream %zu, file %zu\n", (unsigned long)h.size, TOOL_Image_StreamSize(&h), size);
+    printf("  version     %u.%u.%u.%u\n", h.version[0], h.version[1], h.version[2], h.version[3]);
+    printf("  entry       0x%08lX\n", (unsigned long)h.entryPoint);
+    printf("  %s ", (h.magic == TOOL_FW_MAGIC_V2) ? "root       " : "sha256     ");
+    print_hex(h.firmwareHash, sizeof(h.firmwareHash));
+    printf("\n  r           ");
+    print_hex(h.signature, SECBOOT_P256_SIZE);
+    printf("\n  s           ");
+    print_hex(&h.signature[SECBOOT_P256_SIZE], SECBOOT_P256_SIZE);
+    printf("\n  header crc  0x%08lX (%s)\n", (unsigned long)h.headerCRC,
+           (status == TOOL_IMAGE_OK) ? "ok" : TOOL_Image_StatusName(status));
+    if (h.magic == TOOL_FW_MAGIC_V2) {
+        printf("  blocks      %lu x %u bytes\n", (unsigned long)TOOL_FW_BLOCK_COUNT(h.size), TOOL_FW_BLOCK_SIZE);
+    }
+    if (d.encrypted) {
+        printf("  encryption  %s  IV ", (d.encMode == TOOL_FW_ENC_MODE_CTR) ? "AES-CTR" :
+               (d.encMode == TOOL_FW_ENC_MODE_GCM) ? "AES-GCM" : "unknown mode");
+        print_hex(d.encIv, sizeof(d.encIv));
+        if (d.encMode == TOOL_FW_ENC_MODE_GCM) {
+            printf("  tag ");
+            print_hex(d.encTag, sizeof(d.encTag));
+        }
+        printf("\n");
+    }
+    if (d.compressed) {
+        printf("  compression LZSS, %lu bytes\n", (unsigned long)d.compressedSize);
+    }
+    if (d.delta) {
+        printf("  delta       patch %lu bytes, base ", (unsigned long)d.patchSize);
+        print_hex(d.baseHash, sizeof(d.baseHash));
+        printf("\n");
+    }
+}
+
+static void inspect_bootloader(const uint8_t *data, size_t size)
+{
+    const uint8_t *block = &data[TOOL_SECBLOCK_OFFSET];
+    const uint8_t *qx = &data[TOOL_SECBLOCK_PUBKEY];
+    const uint8_t *qy = &data[TOOL_SECBLOCK_PUBKEY + SECBOOT_P256_SIZE];
+    uint32_t stored = TOOL_GetLE32(&data[TOOL_SECBLOCK_CRC]);
+    uint32_t crc = SECBOOT_CRC32_Calculate(data, TOOL_SECBLOCK_OFFSET);
+
+    printf("  bootloader  %zu bytes%s\n", size, (size == TOOL_BOOTLOADER_IMAGE_SIZE) ? "" : " (not the enforced size)");
+    printf("  wrapped key ");
+    print_hex(block, TOOL_WRAPPED_KEY_SIZE);
+    printf("\n  iv          ");
+    print_hex(&data[TOOL_SECBLOCK_IV], 16U);
+    printf("\n  Qx          ");
+    print_hex(qx, SECBOOT_P256_SIZE);
+    printf("\n  Qy          ");
+    print_hex(qy, SECBOOT_P256_SIZE);
+    printf(" (%s)\n", (SECBOOT_P256_CheckKey(qx, qy) == SECBOOT_P256_OK) ? "on the curve" : "NOT a curve point");
+    printf("  crc         0x%08lX over 0x%X bytes (%s)\n", (unsigned long)stored, TOOL_SECBLOCK_OFFSET,
+           (stored == crc) ? "ok" : "MISMATCH");
+}
+
+static int cmd_inspect(int count, char **paths)
+{
+    int failed = 0;
+
+    for (int i = 0; i < count; i++) {
+        uint8_t *data;
+        size_t size;
+
+        if (TOOL_ReadFile(paths[i], &data, &size) != 0) {
+            failed = 1;
+            continue;
+        }
+        printf("%s\n", paths[i]);
+        if (size >= TOOL_FW_HEADER_SIZE &&
+            (TOOL_GetLE32(data) == TOOL_FW_MAGIC_V1 || TOOL_GetLE32(data) == TOOL_FW_MAGIC_V2)) {
+            inspect_image(data, size);
+        } else if (size >= TOOL_SECBLOCK_OFFSET + TOOL_SECBLOCK_SIZE) {
+            inspect_bootloader(data, size);
+        } else {
+            printf("  neither a signed image nor a bootloader\n");
+            failed = 1;
+        }
+        free(data);
+    }
+    return failed;
+}
+
+/* pad ------------------------------------------------------------------*/
+
+static int cmd_pad(const char *inPath, const char *outPath, uint32_t target, uint8_t fill)
+{
+    IMG_Writer *w;
+    size_t size;
+    FILE *in = open_input(inPath, &size);
+    int rc = 1;
+
+    if (in == NULL) {
+        return 1;
+    }
+    if (size > target) {
+        fprintf(stderr, "secboot_image: %s: %zu bytes, larger than %lu\n", inPath, size, (unsigned long)target);
+        fclose(in);
+        return 1;
+    }
+    w = malloc(sizeof(*w));
+    if (w != NULL && writer_open(w, outPath) == 0) {
+        if (writer_copy(w, in, inPath, size) == 0) {
+            writer_fill(w, fill, target - size);
+            rc = (writer_close(w) == 0) ? 0 : 1;
+        } else {
+            fclose(w->f);
+        }
+    }
+    if (rc == 0) {
+        printf("padded   %s  %zu -> %lu bytes\n", outPath, size, (unsigned long)target);
+    }
+    free(w);
+    fclose(in);
+    return rc;
+}
+
+/* Main -----------------------------------------------------------------*/
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s COMMAND [options] FILE...\n"
+            "  sign -k KEY.pem -o OUT [-f 1|2] [-V A.B.C.D] [-e ENTRY]\n"
+            "       [-E ctr|gcm -O UPDATE [-x AES_KEY] [-n NONCE] [-z]] APP.bin\n"
+            "                 Signed image (default v2, 1.0.0.0, entry 0x%08lX); -E also\n"
+            "                 writes the AES-128 update image (-x default\n"
+            "                 $SECBOOT_AES_KEY_1, -n 12-byte IV, -z LZSS)\n"
+            "  build-bootloader -k KEY.pem -o OUT [-a AES_KEY1] [-w AES_KEY2] [-i AES_IV]\n"
+            "       SecBoot_S.bin\n"
+            "                 Security block at 0x%X (keys default to\n"
+            "                 $SECBOOT_AES_KEY_1, $SECBOOT_AES_KEY_2, $SECBOOT_AES_IV)\n"
+            "  verify (-b BOOTLOADER.bin | -k KEY.pem | -p QXQY) [-x AES_KEY] IMAGE...\n"
+            "                 Check images against the public key\n"
+            "  inspect FILE...\n"
+            "                 Print a signed image header or a bootloader security block\n"
+            "  pad [-s SIZE] [-F FILL] IN OUT\n"
+            "                 Pad IN to SIZE bytes (default %u) with FILL (default 0xFF)\n"
+            "  Keys: hex, or @FILE for a file holding the hex\n",
+            prog, (unsigned long)DEFAULT_ENTRY_POINT, TOOL_SECBLOCK_OFFSET, TOOL_BOOTLOADER_IMAGE_SIZE);
+}
+
+int main(int argc, char **argv)
+{
+    static const size_t aesSizes[] = { 16U, 0U };   /* The bootloader installs AES-128 images */
+    const char *cmd;
+    const char *keyPath = NULL;
+    const char *outPath = NULL;
+    const char *bootPath = NULL;
+    const char *key1Arg = NULL;
+    const char *key2Arg = NULL;
+    const char *ivArg = NULL;
+    const char *aesArg = NULL;
+    uint8_t pubkey[2U * SECBOOT_P256_SIZE];
+    bool pubkeySet = false;
+    uint32_t padSize = TOOL_BOOTLOADER_IMAGE_SIZE;
+    uint32_t padFill = 0xFFU;
+    IMG_SignOptions o;
+    int opt;
+
+    if (argc < 2 || strcmp(argv[1], "-h") == 0) {
+        usage(argv[0]);
+        return (argc < 2) ? 2 : 0;
+    }
+    cmd = argv[1];
+
+    memset(&o, 0, sizeof(o));
+    o.format = 2;
+    o.version[0] = 1U;
+    o.entryPoint = DEFAULT_ENTRY_POINT;
+    o.encMode = -1;
+
+    optind = 2;
+    while ((opt = getopt(argc, argv, "k:o:f:V:e:E:O:x:n:za:w:i:b:p:s:F:h")) != -1) {
+        switch (opt) {
+            case 'k': keyPath = optarg; break;
+            case 'o': outPath = optarg; break;
+            case 'O': o.encPath = optarg; break;
+            case 'a': key1Arg = optarg; break;
+            case 'w': key2Arg = optarg; break;
+            case 'i': ivArg = optarg; break;
+            case 'x': aesArg = optarg; break;
+            case 'b': bootPath = optarg; break;
+            case 'z': o.compress = true; break;
+            case 'f':
+                if (strcmp(optarg, "1") != 0 && strcmp(optarg, "2") != 0) {
+                    fprintf(stderr, "secboot_image: bad format '%s'\n", optarg);
+                    return 2;
+                }
+                o.format = optarg[0] - '0';
+                break;
+            case 'V':
+                if (parse_version(optarg, o.version) != 0) {
+                    fprintf(stderr, "secboot_image: bad version '%s'\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'e':
+                if (parse_u32(optarg, &o.entryPoint) != 0) {
+                    fprintf(stderr, "secboot_image: bad entry point '%s'\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'E':
+                if (strcmp(optarg, "ctr") == 0) {
+                    o.encMode = (int)TOOL_FW_ENC_MODE_CTR;
+                } else if (strcmp(optarg, "gcm") == 0) {
+                    o.encMode = (int)TOOL_FW_ENC_MODE_GCM;
+                } else {
+                    fprintf(stderr, "secboot_image: bad encryption '%s'\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'n':
+                if (TOOL_ParseHex(optarg, o.nonce, sizeof(o.nonce)) != (int)NONCE_SIZE) {
+                    fprintf(stderr, "secboot_image: the nonce is %u hex bytes\n", NONCE_SIZE);
+                    return 2;
+                }
+                o.nonceSet = true;
+                break;
+            case 'p':
+                if (TOOL_ParseHex(optarg, pubkey, sizeof(pubkey)) != (int)sizeof(pubkey)) {
+                    fprintf(stderr, "secboot_image: the public key is Qx || Qy, %zu hex bytes\n", sizeof(pubkey));
+                    return 2;
+                }
+                pubkeySet = true;
+                break;
+            case 's':
+                if (parse_u32(optarg, &padSize) != 0) {
+                    fprintf(stderr, "secboot_image: bad size '%s'\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'F':
+                if (parse_u32(optarg, &padFill) != 0 || padFill > 0xFFU) {
+                    fprintf(stderr, "secboot_image: bad fill '%s'\n", optarg);
+                    return 2;
+                }
+                break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? 0 : 2;
+        }
+    }
+
+    if (strcmp(cmd, "sign") == 0) {
+        if (keyPath == NULL || outPath == NULL || optind != argc - 1 || (o.encMode >= 0) != (o.encPath != NULL)) {
+            usage(argv[0]);
+            return 2;
+        }
+        if (o.encMode >= 0) {
+            int n = TOOL_KeyArgument(aesArg, "SECBOOT_AES_KEY_1", "AES key", o.aesKey, sizeof(o.aesKey), aesSizes);
+
+            if (n < 0) {
+                return 2;
+            }
+            o.aesKeyLen = (size_t)n;
+        }
+        o.keyPath = keyPath;
+        o.outPath = outPath;
+        return cmd_sign(&o, argv[optind]);
+    }
+    if (strcmp(cmd, "build-bootloader") == 0) {
+        if (keyPath == NULL || outPath == NULL || optind != argc - 1) {
+            usage(argv[0]);
+            return 2;
+        }
+        return cmd_build_bootloader(keyPath, outPath, key1Arg, key2Arg, ivArg, argv[optind]);
+    }
+    if (strcmp(cmd, "verify") == 0) {
+        uint8_t aesKey[32];
+        int aesKeyLen = 0;
+
+        if (optind >= argc || (bootPath != NULL) + (keyPath != NULL) + pubkeySet != 1) {
+            usage(argv[0]);
+            return 2;
+        }
+        if (bootPath != NULL) {
+            uint8_t *boot;
+            size_t size;
+
+            if (TOOL_ReadFile(bootPath, &boot, &size) != 0) {
+                return 1;
+            }
+            if (size < TOOL_SECBLOCK_PUBKEY + sizeof(pubkey)) {
+                fprintf(stderr, "secboot_image: %s: no security block\n", bootPath);
+                free(boot);
+                return 1;
+            }
+            memcpy(pubkey, &boot[TOOL_SECBLOCK_PUBKEY], sizeof(pubkey));
+            free(boot);
+        } else if (keyPath != NULL) {
+            uint8_t d[SECBOOT_P256_SIZE];
+
+            if (TOOL_LoadPrivateKey(keyPath, d) != 0) {
+                return 1;
+            }
+            (void)SECBOOT_P256_PublicKey(d, pubkey, &pubkey[SECBOOT_P256_SIZE]);
+            memset(d, 0, sizeof(d));
+        }
+        if (aesArg != NULL &&
+            (aesKeyLen = TOOL_KeyArgument(aesArg, "SECBOOT_AES_KEY_1", "AES key", aesKey, sizeof(aesKey), aesSizes)) < 0) {
+            return 2;
+        }
+        return cmd_verify(argc - optind, &argv[optind], pubkey, &pubkey[SECBOOT_P256_SIZE],
+                          (aesKeyLen > 0) ? aesKey : NULL, (size_t)aesKeyLen);
+    }
+    if (strcmp(cmd, "inspect") == 0) {
+        if (optind >= argc) {
+            usage(argv[0]);
+            return 2;
+        }
+        return cmd_inspect(argc - optind, &argv[optind]);
+    }
+    if (strcmp(cmd, "pad") == 0) {
+        if (optind != argc - 2) {
+            usage(argv[0]);
+            return 2;
+        }
+        return cmd_pad(argv[optind], argv[optind + 1], padSize, (uint8_t)padFill);
+    }
+
+    fprintf(stderr, "secboot_image: unknown command '%s'\n", cmd);
+    usage(argv[0]);
+    return 2;
+}
@@ -0,0 +1,768 @@
+/**
+  * @file    secboot_log.c
+  * @brief   Decoder and fleet aggregator for diagnostic log dumps
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @details Reads raw dumps of the LOGGER ring (SECBOOT_DIAG_LOG_PAGES pages
+  *          at SECBOOT_DIAG_LOG_BASE) or of the whole flash, from files or
+  *          directory trees, checks every SECBOOT_Diag_LogEntry against its
+  *          CRC (STM32 CRC unit convention: polynomial 0x04C11DB7, initial
+  *          0xFFFFFFFF, MSB first, no final XOR) and decodes the event and
+  *          failure codes of secboot_diag.h.
+  *
+  *          The device of a dump is its file name without the extension.
+  *          Dumps of the same device are merged by sequence number, so a
+  *          log pulled twice is not counted twice. Reports, as aligned
+  *          columns or CSV (-c):
+  *          - devices: entries, events (coalesced repeats counted), boots
+  *                     that logged, entries missing between the oldest and
+  *                     newest one (lost), corrupt entries, events per type
+  *          - events:  per event and code, entries, events and devices
+  *          - entries: every valid entry
+  *
+  *          -L decodes the single 2KB page of 64-byte slots that
+  *          bootloaders wrote before the ring (at 0x0C00A000); those
+  *          entries carry no sequence or boot number, so the slot order
+  *          stands in for the sequence.
+  *
+  *          Exit status: 0 when every dump was read, 1 when some could not
+  *          be, 2 on usage errors.
+  */
+
+#include "secboot_config.h"
+#include "secboot_crc32.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/* Log layout (secboot_diag.h) ------------------------------------------*/
+#define LOG_ENTRY_SIZE       32U     /* SECBOOT_DIAG_LOG_SIZE */
+#define LOG_REGION_SIZE      (SECBOOT_DIAG_LOG_PAGES * SECBOOT_DIAG_LOG_PAGE_SIZE)
+#define LOG_REGION_OFFSET    (SECBOOT_DIAG_LOG_BASE - SECBOOT_BOOTLOADER_ADDR)
+#define LOG_CRC_SPAN         28U     /* offsetof(SECBOOT_Diag_LogEntry, crc) */
+
+#define LEGACY_BASE          0x0C00A000UL
+#define LEGACY_REGION_SIZE   2048U
+#define LEGACY_SLOT_SIZE     64U
+#define LEGACY_CRC_SPAN      16U     /* Entry fields before the crc */
+
+#define FLASH_DUMP_SIZE      (512U * 1024U)
+#define EVENT_TYPES          4U      /* SECBOOT_DIAG_CRC_FAIL .. ROLLBACK_ATTEMPT */
+
+/* Private types --------------------------------------------------------*/
+
+/** @brief One decoded entry, tagged with its device */
+typedef struct {
+    uint32_t device;         /* Index into devices[] */
+    uint32_t sequence;
+    uint32_t boot;
+    uint32_t timestamp;
+    uint32_t last_timestamp;
+    uint8_t event;
+    uint8_t code;
+    uint16_t count;
+    uint32_t data;
+} LOG_Entry;
+
+typedef struct {
+    char *name;
+    uint32_t dumps;
+    uint32_t corrupt;
+    /* Filled in by the aggregation */
+    uint32_t entries;
+    uint64_t events;
+    uint32_t boots;
+    uint32_t lost;
+    uint32_t first_sequence;
+    uint32_t last_sequence;
+    uint64_t per_type[EVENT_TYPES];
+} LOG_Device;
+
+typedef struct {
+    uint32_t entries;
+    uint64_t events;
+    uint32_t devices;
+    uint32_t last_device;    /* Device counted last, UINT32_MAX for none */
+} LOG_EventStats;
+
+typedef enum {
+    REPORT_DEVICES = 1U << 0,
+    REPORT_EVENTS  = 1U << 1,
+    REPORT_ENTRIES = 1U << 2
+} LOG_ReportTypeDef;
+
+/* Private variables ----------------------------------------------------*/
+static LOG_Entry *entries = NULL;
+static size_t entry_count = 0;
+static size_t entry_capacity = 0;
+
+static LOG_Device *devices = NULL;
+static uint32_t device_count = 0;
+static uint32_t device_capacity = 0;
+
+static LOG_EventStats event_stats[EVENT_TYPES][256];
+
+static bool csv = false;
+static bool legacy = false;
+static long region_offset = -1;      /* -O, -1: from the dump size */
+static uint32_t dump_count = 0;
+static uint32_t unreadable = 0;
+
+/* Names (secboot_diag.h) -----------------------------------------------*/
+
+static const char *event_name(uint8_t event)
+{
+    switch (event) {
+        case 0x10: return "CRC_FAIL";
+        case 0x20: return "SIG_FAIL";
+        case 0x30: return "SECURE_VIOLATION";
+        case 0x40: return "ROLLBACK_ATTEMPT";
+        default:   return NULL;
+    }
+}
+
+/* Failure codes are unique across the event types */
+static const char *code_name(uint8_t code)
+{
+    switch (code) {
+        case 0x10: return "CRC_FAIL_MAIN_IMAGE";
+        case 0x11: return "CRC_FAIL_BACKUP_IMAGE";
+        case 0x12: return "CRC_FAIL_CONFIG_DATA";
+        case 0x13: return "CRC_FAIL_CRITICAL_SECRET";
+        case 0x14: return "CRC_FAIL_LOG_ENTRY";
+        case 0x20: return "SIG_FAIL_MAIN_IMAGE";
+        case 0x21: return "SIG_FAIL_BACKUP_IMAGE";
+        case 0x22: return "SIG_FAIL_CONFIG_SIGNATURE";
+        case 0x23: return "SIG_FAIL_KEY_EXPIRED";
+        case 0x24: return "SIG_FAIL_HW_CRYPTO_ERROR";
+        case 0x25: return "SIG_FAIL_HW_FALLBACK";
+        case 0x26: return "SIG_FAIL_PUBKEY_INVALID";
+        case 0x30: return "SECURE_VIOLATION_MEMORY_TAMPER";
+        case 0x31: return "SECURE_VIOLATION_DEBUG_PORT";
+        case 0x32: return "SECURE_VIOLATION_CLOCK_TAMPER";
+        case 0x33: return "SECURE_VIOLATION_KEY_ACCESS";
+        case 0x34: return "SECURE_VIOLATION_STACK_OVERFLOW";
+        case 0x40: return "ROLLBACK_NORMAL_RECOVERY";
+        case 0x41: return "ROLLBACK_INVALID_SIGNATURE";
+        case 0x42: return "ROLLBACK_VERSION_REJECTED";
+        case 0x43: return "ROLLBACK_HW_FAULT";
+        case 0x44: return "ROLLBACK_UNAUTHORIZED_CMD";
+        case 0x45: return "ROOLBACK_JUMP_FAILED";
+        default:   return "";
+    }
+}
+
+static uint32_t event_type(uint8_t event)
+{
+    return (uint32_t)(event >> 4) - 1U;
+}
+
+/* Ingestion ------------------------------------------------------------*/
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool is_erased(const uint8_t *p, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        if (p[i] != 0xFFU) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void *grow(void *array, size_t element, size_t *pCapacity)
+{
+    size_t capacity = (*pCapacity == 0U) ? 1024U : *pCapacity * 2U;
+    void *p = realloc(array, capacity * element);
+
+    if (p == NULL) {
+        fprintf(stderr, "secboot_log: out of memory\n");
+        exit(2);
+    }
+    *pCapacity = capacity;
+    return p;
+}
+
+static uint32_t device_add(const char *path)
+{
+    const char *base = strrchr(path, '/');
+    const char *dot;
+    size_t length;
+    LOG_Device *dev;
+
+    base = (base != NULL) ? base + 1 : path;
+    dot = strrchr(base, '.');
+    length = (dot != NULL && dot != base) ? (size_t)(dot - base) : strlen(base);
+
+    if (device_count == device_capacity) {
+        size_t capacity = device_capacity;
+        devices = grow(devices, sizeof(*devices), &capacity);
+        device_capacity = (uint32_t)capacity;
+    }
+    dev = &devices[device_count];
+    memset(dev, 0, sizeof(*dev));
+    dev->name = strndup(base, length);
+    dev->dumps = 1;
+    return device_count++;
+}
+
+static LOG_Entry *entry_add(uint32_t device)
+{
+    if (entry_count == entry_capacity) {
+        entries = grow(entries, sizeof(*entries), &entry_capacity);
+    }
+    memset(&entries[entry_count], 0, sizeof(LOG_Entry));
+    entries[entry_count].device = device;
+    return &entries[entry_count++];
+}
+
+/**
+  * @brief  Decode one dump of the ring: every programmed entry is either
+  *         valid or counted corrupt (torn write, foreign data)
+  */
+static void decode_ring(uint32_t device, const uint8_t *region, size_t length)
+{
+    for (size_t offset = 0; offset + LOG_ENTRY_SIZE <= length; offset += LOG_ENTRY_SIZE) {
+        const uint8_t *p = region + offset;
+        LOG_Entry *entry;
+
+        if (is_erased(p, LOG_ENTRY_SIZE)) {
+            continue;
+        }
+        if (SECBOOT_CRC32_Calculate(p, LOG_CRC_SPAN) != get_le32(p + LOG_CRC_SPAN) || event_name(p[16]) == NULL) {
+            devices[device].corrupt++;
+            continue;
+        }
+
+        entry = entry_add(device);
+        entry->sequence = get_le32(p);
+        entry->boot = get_le32(p + 4);
+        entry->timestamp = get_le32(p + 8);
+        entry->last_timestamp = get_le32(p + 12);
+        entry->event = p[16];
+        entry->code = p[17];
+        entry->count = (uint16_t)(p[18] | (p[19] << 8));
+        entry->data = get_le32(p + 20);
+    }
+}
+
+/**
+  * @brief  Decode one dump of the pre-ring log: a 20-byte entry at the
+  *         start of each 64-byte slot, the event as a 32-bit enum
+  */
+static void decode_legacy(uint32_t device, const uint8_t *region, size_t length)
+{
+    for (size_t offset = 0; offset + LEGACY_SLOT_SIZE <= length; offset += LEGACY_SLOT_SIZE) {
+        const uint8_t *p = region + offset;
+        uint32_t event = get_le32(p + 4);
+        LOG_Entry *entry;
+
+        if (is_erased(p, LEGACY_CRC_SPAN + 4U)) {
+            continue;
+        }
+        if (SECBOOT_CRC32_Calculate(p, LEGACY_CRC_SPAN) != get_le32(p + LEGACY_CRC_SPAN) || event > 0xFFU ||
+            event_name((uint8_t)event) == NULL) {
+            devices[device].corrupt++;
+            continue;
+        }
+
+        entry = entry_add(device);
+        entry->sequence = (uint32_t)(offset / LEGACY_SLOT_SIZE) + 1U;
+        entry->timestamp = get_le32(p);
+        entry->last_timestamp = entry->timestamp;
+        entry->event = (uint8_t)event;
+        entry->code = p[8];
+        entry->count = 1;
+        entry->data = get_le32(p + 12);
+    }
+}
+
+static void read_dump(const char *path, size_t size)
+{
+    size_t region_size = legacy ? LEGACY_REGION_SIZE : LOG_REGION_SIZE;
+    long offset = region_offset;
+    uint8_t *buf;
+    FILE *f;
+
+    // A dump of the region itself, or of the whole flash from its base
+    if (offset < 0) {
+        if (size >= FLASH_DUMP_SIZE) {
+            offset = (long)(legacy ? (LEGACY_BASE - SECBOOT_BOOTLOADER_ADDR) : LOG_REGION_OFFSET);
+        } else {
+            offset = 0;
+        }
+    }
+    if ((size_t)offset >= size) {
+        fprintf(stderr, "secboot_log: %s: no log at offset 0x%lX\n", path, offset);
+        unreadable++;
+        return;
+    }
+    if (size - (size_t)offset < region_size) {
+        region_size = size - (size_t)offset;
+    }
+
+    buf = malloc(region_size);
+    f = fopen(path, "rb");
+    if (buf == NULL || f == NULL || fseek(f, offset, SEEK_SET) != 0 || fread(buf, 1, region_size, f) != region_size) {
+        fprintf(stderr, "secboot_log: %s: %s\n", path, strerror(errno));
+        unreadable++;
+    } else if (legacy) {
+        decode_legacy(device_add(path), buf, region_size);
+        dump_count++;
+    } else {
+        decode_ring(device_add(path), buf, region_size);
+        dump_count++;
+    }
+    if (f != NULL) {
+        fclose(f);
+    }
+    free(buf);
+}
+
+static int compare_names(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static void read_path(const char *path)
+{
+    struct stat st;
+
+    if (stat(path, &st) != 0) {
+        fprintf(stderr, "secboot_log: %s: %s\n", path, strerror(errno));
+        unreadable++;
+        return;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(path);
+        struct dirent *de;
+        char **names = NULL;
+        size_t count = 0;
+        size_t capacity = 0;
+
+        if (dir == NULL) {
+            fprintf(stderr, "secboot_log: %s: %s\n", path, strerror(errno));
+            unreadable++;
+            return;
+        }
+        while ((de = readdir(dir)) != NULL) {
+            if (de->d_name[0] == '.') {
+                continue;
+            }
+            if (count == capacity) {
+                names = grow(names, sizeof(*names), &capacity);
+            }
+            if (asprintf(&names[count], "%s/%s", path, de->d_name) < 0) {
+                fprintf(stderr, "secboot_log: out of memory\n");
+                exit(2);
+            }
+            count++;
+        }
+        closedir(dir);
+
+        // Sorted, so the reports do not depend on the file system
+        qsort(names, count, sizeof(*names), compare_names);
+        for (size_t i = 0; i < count; i++) {
+            read_path(names[i]);
+            free(names[i]);
+        }
+        free(names);
+    } else if (S_ISREG(st.st_mode)) {
+        read_dump(path, (size_t)st.st_size);
+    }
+}
+
+/* Aggregation ----------------------------------------------------------*/
+
+static int compare_devices(const void *a, const void *b)
+{
+    const uint32_t ia = *(const uint32_t *)a;
+    const uint32_t ib = *(const uint32_t *)b;
+    int order = strcmp(devices[ia].name, devices[ib].name);
+
+    return (order != 0) ? order : (ia > ib) - (ia < ib);
+}
+
+static int compare_entries(const void *a, const void *b)
+{
+    const LOG_Entry *ea = a;
+    const LOG_Entry *eb = b;
+
+    if (ea->device != eb->device) {
+        return (ea->device > eb->device) - (ea->device < eb->device);
+    }
+    return (ea->sequence > eb->sequence) - (ea->sequence < eb->sequence);
+}
+
+/**
+  * @brief  Merge the dumps of each device, order everything by device name
+  *         and sequence, drop entries seen in more than one dump and fill
+  *         in the statistics
+  */
+static void aggregate(void)
+{
+    uint32_t *order = malloc((device_count + 1U) * sizeof(*order));
+    uint32_t *merged_of = malloc((device_count + 1U) * sizeof(*merged_of));
+    LOG_Device *merged = calloc(device_count + 1U, sizeof(*merged));
+    uint32_t merged_count = 0;
+    size_t kept = 0;
+
+    if (order == NULL || merged_of == NULL || merged == NULL) {
+        fprintf(stderr, "secboot_log: out of memory\n");
+        exit(2);
+    }
+
+    for (uint32_t i = 0; i < device_count; i++) {
+        order[i] = i;
+    }
+    qsort(order, device_count, sizeof(*order), compare_devices);
+
+    for (uint32_t i = 0; i < device_count; i++) {
+        LOG_Device *dev = &devices[order[i]];
+
+        if (merged_count == 0U || strcmp(merged[merged_count - 1U].name, dev->name) != 0) {
+            merged[merged_count].name = dev->name;
+            merged[merged_count].dumps = dev->dumps;
+            merged_count++;
+        } else {
+            free(dev->name);
+            merged[merged_count - 1U].dumps += dev->dumps;
+        }
+        merged[merged_count - 1U].corrupt += dev->corrupt;
+        merged_of[order[i]] = merged_count - 1U;
+    }
+
+    free(devices);
+    devices = merged;
+    device_count = merged_count;
+    device_capacity = merged_count;
+
+    for (size_t i = 0; i < entry_count; i++) {
+        entries[i].device = merged_of[entries[i].device];
+    }
+    qsort(entries, entry_count, sizeof(*entries), compare_entries);
+
+    memset(event_stats, 0, sizeof(event_stats));
+    for (uint32_t t = 0; t < EVENT_TYPES; t++) {
+        for (uint32_t c = 0; c < 256U; c++) {
+            event_stats[t][c].last_device = UINT32_MAX;
+        }
+    }
+
+    for (size_t i = 0; i < entry_count; i++) {
+        LOG_Entry *entry = &entries[i];
+        LOG_Device *dev = &devices[entry->device];
+        LOG_EventStats *ev = &event_stats[event_type(entry->event)][entry->code];
+        const LOG_Entry *prev = (kept > 0U) ? &entries[kept - 1U] : NULL;
+
+        if (prev != NULL && prev->device == entry->device) {
+            if (prev->sequence == entry->sequence) {
+                continue;     // Same entry from another dump of the device
+            }
+            dev->lost += entry->sequence - prev->sequence - 1U;
+            if (prev->boot != entry->boot) {
+                dev->boots++;
+            }
+        } else {
+            dev->first_sequence = entry->sequence;
+            dev->boots = legacy ? 0U : 1U;
+        }
+        dev->last_sequence = entry->sequence;
+        dev->entries++;
+        dev->events += entry->count;
+        dev->per_type[event_type(entry->event)] += entry->count;
+
+        ev->entries++;
+        ev->events += entry->count;
+        if (ev->last_device != entry->device) {
+            ev->last_device = entry->device;
+            ev->devices++;
+        }
+
+        entries[kept++] = *entry;
+    }
+    entry_count = kept;
+
+    free(order);
+    free(merged_of);
+}
+
+/* Reports --------------------------------------------------------------*/
+
+static void print_csv_field(const char *field)
+{
+    if (strpbrk(field, ",\"\n") == NULL) {
+        fputs(field, stdout);
+        return;
+    }
+    putchar('"');
+    for (; *field != '\0'; field++) {
+        if (*field == '"') {
+            putchar('"');
+        }
+        putchar(*field);
+    }
+    putchar('"');
+}
+
+/**
+  * @brief  One row: CSV, or columns of the given widths (negative: left
+  *         aligned)
+  */
+static void print_row(const char *const *fields, const int *widths, int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (csv) {
+            if (i > 0) {
+                putchar(',');
+            }
+            print_csv_field(fields[i]);
+        } else {
+            printf((i + 1 < count) ? "%*s  " : "%*s", widths[i], fields[i]);
+        }
+    }
+    putchar('\n');
+}
+
+static int name_width(void)
+{
+    int width = 6;
+
+    for (uint32_t i = 0; i < device_count; i++) {
+        int length = (int)strlen(devices[i].name);
+        if (length > width) {
+            width = length;
+        }
+    }
+    return width;
+}
+
+static void print_devices(void)
+{
+    static const char *const header[] = {
+        "device", "dumps", "entries", "events", "boots", "lost", "corrupt", "first_seq", "last_seq",
+        "crc_fail", "sig_fail", "secure_violation", "rollback_attempt"
+    };
+    int widths[] = { -name_width(), 5, 7, 8, 6, 5, 7, 9, 9, 8, 8, 16, 16 };
+    char cells[12][24];
+    const char *fields[13];
+
+    if (!csv) {
+        printf("Devices: %" PRIu32 " from %" PRIu32 " dumps\n", device_count, dump_count);
+    }
+    print_row(header, widths, 13);
+
+    for (uint32_t i = 0; i < device_count; i++) {
+        const LOG_Device *dev = &devices[i];
+
+        fields[0] = dev->name;
+        snprintf(cells[0], sizeof(cells[0]), "%" PRIu32, dev->dumps);
+        snprintf(cells[1], sizeof(cells[1]), "%" PRIu32, dev->entries);
+        snprintf(cells[2], sizeof(cells[2]), "%" PRIu64, dev->events);
+        snprintf(cells[3], sizeof(cells[3]), "%" PRIu32, dev->boots);
+        snprintf(cells[4], sizeof(cells[4]), "%" PRIu32, dev->lost);
+        snprintf(cells[5], sizeof(cells[5]), "%" PRIu32, dev->corrupt);
+        snprintf(cells[6], sizeof(cells[6]), "%" PRIu32, dev->first_sequence);
+        snprintf(cells[7], sizeof(cells[7]), "%" PRIu32, dev->last_sequence);
+        for (uint32_t t = 0; t < EVENT_TYPES; t++) {
+            snprintf(cells[8 + t], sizeof(cells[8 + t]), "%" PRIu64, dev->per_type[t]);
+        }
+        for (int c = 0; c < 12; c++) {
+            fields[c + 1] = cells[c];
+        }
+        print_row(fields, widths, 13);
+    }
+}
+
+static void print_events(void)
+{
+    static const char *const header[] = { "event", "code", "code_name", "entries", "events", "devices" };
+    static const int widths[] = { -16, 4, -31, 7, 8, 7 };
+    char cells[4][24];
+    const char *fields[6];
+
+    if (!csv) {
+        printf("Events:\n");
+    }
+    print_row(header, widths, 6);
+
+    for (uint32_t t = 0; t < EVENT_TYPES; t++) {
+        for (uint32_t c = 0; c < 256U; c++) {
+            const LOG_EventStats *ev = &event_stats[t][c];
+
+            if (ev->entries == 0U) {
+                continue;
+            }
+            fields[0] = event_name((uint8_t)((t + 1U) << 4));
+            snprintf(cells[0], sizeof(cells[0]), "0x%02" PRIX32, c);
+            fields[1] = cells[0];
+            fields[2] = code_name((uint8_t)c);
+            snprintf(cells[1], sizeof(cells[1]), "%" PRIu32, ev->entries);
+            snprintf(cells[2], sizeof(cells[2]), "%" PRIu64, ev->events);
+            snprintf(cells[3], sizeof(cells[3]), "%" PRIu32, ev->devices);
+            fields[3] = cells[1];
+            fields[4] = cells[2];
+            fields[5] = cells[3];
+            print_row(fields, widths, 6);
+        }
+    }
+}
+
+static void print_entries(void)
+{
+    static const char *const header[] = {
+        "device", "sequence", "boot", "first_ms", "last_ms", "event", "code", "code_name", "count", "data"
+    };
+    int widths[] = { -name_width(), 8, 6, 10, 10, -16, 4, -31, 5, 10 };
+    char cells[7][24];
+    const char *fields[10];
+
+    if (!csv) {
+        printf("Entries:\n");
+    }
+    print_row(header, widths, 10);
+
+    for (size_t i = 0; i < entry_count; i++) {
+        const LOG_Entry *entry = &entries[i];
+
+        snprintf(cells[0], sizeof(cells[0]), "%" PRIu32, entry->sequence);
+        snprintf(cells[1], sizeof(cells[1]), "%" PRIu32, entry->boot);
+        snprintf(cells[2], sizeof(cells[2]), "%" PRIu32, entry->timestamp);
+        snprintf(cells[3], sizeof(cells[3]), "%" PRIu32, entry->last_timestamp);
+        snprintf(cells[4], sizeof(cells[4]), "0x%02X", entry->code);
+        snprintf(cells[5], sizeof(cells[5]), "%u", entry->count);
+        snprintf(cells[6], sizeof(cells[6]), "0x%08" PRIX32, entry->data);
+        fields[0] = devices[entry->device].name;
+        fields[1] = cells[0];
+        fields[2] = cells[1];
+        fields[3] = cells[2];
+        fields[4] = cells[3];
+        fields[5] = event_name(entry->event);
+        fields[6] = cells[4];
+        fields[7] = code_name(entry->code);
+        fields[8] = cells[5];
+        fields[9] = cells[6];
+        print_row(fields, widths, 10);
+    }
+}
+
+/* Command line ---------------------------------------------------------*/
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options] DUMP|DIR...\n"
+            "  DUMP           Raw dump of the log region (0x%08lX, %u bytes), or of the\n"
+            "                 whole flash from its base; DIR is searched recursively\n"
+            "  -r REPORTS     Comma-separated: devices, events, entries\n"
+            "                 (default devices,events)\n"
+            "  -c             CSV instead of aligned columns\n"
+            "  -O OFFSET      Log region offset in the dumps (default from the size)\n"
+            "  -L             Pre-ring format: one 2KB page of 64-byte slots (0x%08lX)\n"
+            "  -h             This help\n",
+            prog, (unsigned long)SECBOOT_DIAG_LOG_BASE, (unsigned)LOG_REGION_SIZE, (unsigned long)LEGACY_BASE);
+}
+
+static int parse_reports(const char *arg, unsigned *pReports)
+{
+    char *copy = strdup(arg);
+    char *save = NULL;
+
+    *pReports = 0;
+    for (char *tok = strtok_r(copy, ",", &save); tok != NULL; tok = strtok_r(NULL, ",", &save)) {
+        if (strcmp(tok, "devices") == 0) {
+            *pReports |= REPORT_DEVICES;
+        } else if (strcmp(tok, "events") == 0) {
+            *pReports |= REPORT_EVENTS;
+        } else if (strcmp(tok, "entries") == 0) {
+            *pReports |= REPORT_ENTRIES;
+        } else {
+            free(copy);
+            return -1;
+        }
+    }
+    free(copy);
+    return (*pReports != 0U) ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned reports = REPORT_DEVICES | REPORT_EVENTS;
+    bool first = true;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:cO:Lh")) != -1) {
+        switch (opt) {
+            case 'r':
+                if (parse_reports(optarg, &reports) != 0) {
+                    fprintf(stderr, "secboot_log: bad report list '%s'\n", optarg);
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'c':
+                csv = true;
+                break;
+            case 'O': {
+                char *end;
+                region_offset = strtol(optarg, &end, 0);
+                if (*end != '\0' || region_offset < 0) {
+                    fprintf(stderr, "secboot_log: bad offset '%s'\n", optarg);
+                    return 2;
+                }
+                break;
+            }
+            case 'L':
+                legacy = true;
+                break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    for (int i = optind; i < argc; i++) {
+        read_path(argv[i]);
+    }
+    aggregate();
+
+    // Tables one after the other, a blank line apart
+    if (reports & REPORT_DEVICES) {
+        print_devices();
+        first = false;
+    }
+    if (reports & REPORT_EVENTS) {
+        if (!first) {
+            putchar('\n');
+        }
+        print_events();
+        first = false;
+    }
+    if (reports & REPORT_ENTRIES) {
+        if (!first) {
+            putchar('\n');
+        }
+        print_entries();
+    }
+
+    return (unreadable > 0U) ? 1 : 0;
+}
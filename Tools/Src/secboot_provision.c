@@ -0,0 +1,533 @@
+/**
+  * @file    secboot_provision.c
+  * @brief   Per-device bootloader images for a production batch
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @details get_AES_key unwraps AES_KEY1 with a key made of the device's
+  *          UID words and FW_MAGIC_NUMBER, so every device needs its own
+  *          security block. Given one bootloader (SecBoot_S.bin padded to
+  *          254016 bytes, or a built SecBoot_Bootloader.bin, whose block is
+  *          replaced) and a list of UIDs, this writes one image per device
+  *          (-o DIR, named after the UID) and/or one patch record per
+  *          device (-r FILE): the security block bytes and the address
+  *          they go to, for a programmer that flashes the shared image once
+  *          per device and the record over it.
+  *
+  *          Only the wrapped key changes from one device to the next. The
+  *          bootloader is mapped once; the CRC of its first 0x8000 bytes,
+  *          which precede the block, is computed once; each device costs a
+  *          key wrap (two AES blocks), a 0x74-byte block and, with -o, one
+  *          gathered write of the mapped bytes around it. Devices are
+  *          handed to threads in claims of CLAIM_SIZE.
+  *
+  *          UIDs, one per line: W0:W1:W2 (as secboot_sim -u takes them)
+  *          or 24 hex digits, w0 first. Blank lines and '#' comments are
+  *          skipped; "-" reads standard input. Duplicates are rejected.
+  *
+  *          Records are CSV, in input order: uid,address,data, with data
+  *          the TOOL_SECBLOCK_SIZE bytes in hex.
+  *
+  *          Exit status: 0 when every device was written, 1 otherwise, 2 on
+  *          usage errors.
+  */
+
+#include "tool_image.h"
+#include "secboot_crc32.h"
+#include "secboot_p256.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CLAIM_SIZE     64U                /* Devices per claim */
+#define MAX_THREADS    256U
+#define UID_HEX        (8U * TOOL_UID_WORDS)
+#define RECORD_SIZE    (UID_HEX + 1U + 10U + 1U + 2U * TOOL_SECBLOCK_SIZE + 1U)  /* One CSV line */
+
+/* Private types --------------------------------------------------------*/
+
+/** @brief One device of the batch */
+typedef struct {
+    uint32_t uid[TOOL_UID_WORDS];
+    unsigned line;                        /* In the UID list, for messages */
+} PROV_Device;
+
+/** @brief Thread state */
+typedef struct {
+    pthread_t thread;
+    bool      started;
+    uint64_t  bytes;
+} PROV_Worker;
+
+/* Private variables ----------------------------------------------------*/
+static PROV_Device *devices;
+static size_t device_count;
+static size_t device_capacity;
+
+static const uint8_t *image;              /* Mapped bootloader */
+static uint8_t key1[16];
+static uint8_t iv[16];
+static uint8_t pubkey[2U * SECBOOT_P256_SIZE];
+static uint32_t image_crc;
+
+static const char *out_dir;               /* -o */
+static char *records;                     /* -r, RECORD_SIZE bytes per device */
+
+static _Atomic size_t next_device;
+static _Atomic unsigned failures;
+
+/* Helpers --------------------------------------------------------------*/
+
+static void *grow(void *array, size_t elem, size_t *pCapacity)
+{
+    size_t capacity = (*pCapacity == 0U) ? 1024U : 2U * *pCapacity;
+    void *p = realloc(array, capacity * elem);
+
+    if (p == NULL) {
+        fprintf(stderr, "secboot_provision: out of memory\n");
+        exit(2);
+    }
+    *pCapacity = capacity;
+    return p;
+}
+
+static double seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static void format_uid(const uint32_t uid[TOOL_UID_WORDS], char out[UID_HEX + 1U])
+{
+    snprintf(out, UID_HEX + 1U, "%08" PRIX32 "%08" PRIX32 "%08" PRIX32, uid[0], uid[1], uid[2]);
+}
+
+/* UID list -------------------------------------------------------------*/
+
+/** @brief W0:W1:W2 or 24 hex digits, surrounding blanks allowed */
+static bool parse_uid(const char *s, uint32_t uid[TOOL_UID_WORDS])
+{
+    char tail;
+
+    if (strchr(s, ':') != NULL) {
+        return sscanf(s, " %" SCNx32 " : %" SCNx32 " : %" SCNx32 " %c", &uid[0], &uid[1], &uid[2], &tail) == 3;
+    }
+
+    uint8_t bytes[4U * TOOL_UID_WORDS];
+    char digits[2U * sizeof(bytes) + 2U];
+
+    if (sscanf(s, " %25s %c", digits, &tail) != 1 || strlen(digits) != UID_HEX ||
+        TOOL_ParseHex(digits, bytes, sizeof(bytes)) != (int)sizeof(bytes)) {
+        return false;
+    }
+    for (uint32_t i = 0U; i < TOOL_UID_WORDS; i++) {
+        uid[i] = ((uint32_t)bytes[4U * i] << 24) | ((uint32_t)bytes[4U * i + 1U] << 16) |
+                 ((uint32_t)bytes[4U * i + 2U] << 8) | (uint32_t)bytes[4U * i + 3U];
+    }
+    return true;
+}
+
+static int compare_uids(const void *a, const void *b)
+{
+    const PROV_Device *x = a;
+    const PROV_Device *y = b;
+
+    for (uint32_t i = 0U; i < TOOL_UID_WORDS; i++) {
+        if (x->uid[i] != y->uid[i]) {
+            return (x->uid[i] < y->uid[i]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static int load_uids(const char *path)
+{
+    FILE *f = (strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+    char *line = NULL;
+    size_t lineCap = 0U;
+    unsigned lineNo = 0U;
+    int rc = 0;
+
+    if (f == NULL) {
+        fprintf(stderr, "secboot_provision: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    while (getline(&line, &lineCap, f) >= 0) {
+        char *hash = strchr(line, '#');
+        PROV_Device device;
+
+        lineNo++;
+        if (hash != NULL) {
+            *hash = '\0';
+        }
+        if (strspn(line, " \t\r\n") == strlen(line)) {
+            continue;
+        }
+        if (!parse_uid(line, device.uid)) {
+            fprintf(stderr, "secboot_provision: %s:%u: bad UID\n", path, lineNo);
+            rc = -1;
+            continue;
+        }
+        device.line = lineNo;
+        if (device_count == device_capacity) {
+            devices = grow(devices, sizeof(*devices), &device_capacity);
+        }
+        devices[device_count++] = device;
+    }
+    free(line);
+    if (f != stdin) {
+        fclose(f);
+    }
+    if (rc != 0 || device_count == 0U) {
+        if (rc == 0) {
+            fprintf(stderr, "secboot_provision: %s: no UIDs\n", path);
+        }
+        return -1;
+    }
+
+    // Two devices with one UID would share a key; refuse the batch
+    PROV_Device *sorted = malloc(device_count * sizeof(*sorted));
+
+    if (sorted == NULL) {
+        fprintf(stderr, "secboot_provision: out of memory\n");
+        return -1;
+    }
+    memcpy(sorted, devices, device_count * sizeof(*sorted));
+    qsort(sorted, device_count, sizeof(*sorted), compare_uids);
+    for (size_t i = 1U; i < device_count; i++) {
+        if (compare_uids(&sorted[i - 1U], &sorted[i]) == 0) {
+            char uid[UID_HEX + 1U];
+
+            format_uid(sorted[i].uid, uid);
+            fprintf(stderr, "secboot_provision: %s:%u: duplicate UID %s (line %u)\n", path,
+                    (sorted[i].line > sorted[i - 1U].line) ? sorted[i].line : sorted[i - 1U].line, uid,
+                    (sorted[i].line > sorted[i - 1U].line) ? sorted[i - 1U].line : sorted[i].line);
+            rc = -1;
+        }
+    }
+    free(sorted);
+    return rc;
+}
+
+/* Personalisation ------------------------------------------------------*/
+
+/** @brief Whole image: mapped bytes around the device's block */
+static int write_image(const PROV_Device *device, const uint8_t block[TOOL_SECBLOCK_SIZE])
+{
+    char uid[UID_HEX + 1U];
+    char path[PATH_MAX];
+    struct iovec iov[3] = {
+        { (void *)image, TOOL_SECBLOCK_OFFSET },
+        { (void *)block, TOOL_SECBLOCK_SIZE },
+        { (void *)&image[TOOL_SECBLOCK_OFFSET + TOOL_SECBLOCK_SIZE],
+          TOOL_BOOTLOADER_IMAGE_SIZE - TOOL_SECBLOCK_OFFSET - TOOL_SECBLOCK_SIZE },
+    };
+    struct iovec *v = iov;
+    int count = 3;
+    int fd;
+
+    format_uid(device->uid, uid);
+    snprintf(path, sizeof(path), "%s/%s.bin", out_dir, uid);
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "secboot_provision: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    while (count > 0) {
+        ssize_t n = writev(fd, v, count);
+
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "secboot_provision: %s: %s\n", path, strerror(errno));
+            close(fd);
+            return -1;
+        }
+        while (count > 0 && (size_t)n >= v->iov_len) {
+            n -= (ssize_t)v->iov_len;
+            v++;
+            count--;
+        }
+        if (count > 0) {
+            v->iov_base = (uint8_t *)v->iov_base + n;
+            v->iov_len -= (size_t)n;
+        }
+    }
+    if (close(fd) != 0) {
+        fprintf(stderr, "secboot_provision: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+static void format_record(const PROV_Device *device, const uint8_t block[TOOL_SECBLOCK_SIZE], char *out)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    char *p = out;
+
+    format_uid(device->uid, p);
+    p += UID_HEX;
+    p += sprintf(p, ",0x%08lX,", (unsigned long)(SECBOOT_BOOTLOADER_ADDR + TOOL_SECBLOCK_OFFSET));
+    for (uint32_t i = 0U; i < TOOL_SECBLOCK_SIZE; i++) {
+        *p++ = hex[block[i] >> 4];
+        *p++ = hex[block[i] & 0x0FU];
+    }
+    *p = '\n';
+}
+
+static void *worker_main(void *arg)
+{
+    PROV_Worker *self = arg;
+
+    for (;;) {
+        size_t first = atomic_fetch_add(&next_device, CLAIM_SIZE);
+
+        if (first >= device_count) {
+            break;
+        }
+        size_t last = (device_count - first < CLAIM_SIZE) ? device_count : first + CLAIM_SIZE;
+
+        for (size_t i = first; i < last; i++) {
+            uint8_t deviceKey[TOOL_DEVICE_KEY_SIZE];
+            uint8_t wrapped[TOOL_WRAPPED_KEY_SIZE];
+            uint8_t block[TOOL_SECBLOCK_SIZE];
+
+            TOOL_DeviceKey(devices[i].uid, deviceKey);
+            (void)TOOL_WrapKey(key1, sizeof(key1), deviceKey, sizeof(deviceKey), iv, wrapped);
+            TOOL_BuildSecBlock(wrapped, iv, pubkey, &pubkey[SECBOOT_P256_SIZE], image_crc, block);
+            memset(deviceKey, 0, sizeof(deviceKey));
+            memset(wrapped, 0, sizeof(wrapped));
+
+            if (records != NULL) {
+                format_record(&devices[i], block, &records[i * RECORD_SIZE]);
+            }
+            if (out_dir != NULL) {
+                if (write_image(&devices[i], block) != 0) {
+                    atomic_fetch_add(&failures, 1U);
+                } else {
+                    self->bytes += TOOL_BOOTLOADER_IMAGE_SIZE;
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Main -----------------------------------------------------------------*/
+
+static int map_bootloader(const char *path)
+{
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        fprintf(stderr, "secboot_provision: %s: %s\n", path, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    if ((size_t)st.st_size != TOOL_BOOTLOADER_IMAGE_SIZE) {
+        fprintf(stderr, "secboot_provision: %s: %lld bytes, the bootloader must be exactly %u (secboot_image pad)\n",
+                path, (long long)st.st_size, TOOL_BOOTLOADER_IMAGE_SIZE);
+        close(fd);
+        return -1;
+    }
+    image = mmap(NULL, TOOL_BOOTLOADER_IMAGE_SIZE, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        fprintf(stderr, "secboot_provision: %s: %s\n", path, strerror(errno));
+        image = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static int write_records(const char *path)
+{
+    FILE *f = (strcmp(path, "-") == 0) ? stdout : fopen(path, "w");
+    int rc = 0;
+
+    if (f == NULL) {
+        fprintf(stderr, "secboot_provision: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    fputs("uid,address,data\n", f);
+    if (fwrite(records, RECORD_SIZE, device_count, f) != device_count) {
+        rc = -1;
+    }
+    if ((f == stdout) ? fflush(f) != 0 : fclose(f) != 0) {
+        rc = -1;
+    }
+    if (rc != 0) {
+        fprintf(stderr, "secboot_provision: %s: %s\n", path, strerror(errno));
+    }
+    return rc;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s (-k KEY.pem | -p QXQY) [options] BOOTLOADER UIDS\n"
+            "  BOOTLOADER     SecBoot_S.bin padded to %u bytes, or a built bootloader\n"
+            "  UIDS           One device UID per line, W0:W1:W2 or 24 hex digits (- for stdin)\n"
+            "  -k KEY.pem     Signing key whose public key goes in the block\n"
+            "  -p QXQY        The public key itself (hex or @FILE)\n"
+            "  -a AES_KEY1    Firmware key to wrap (default $SECBOOT_AES_KEY_1)\n"
+            "  -i AES_IV      IV of the block (default $SECBOOT_AES_IV)\n"
+            "  -o DIR         Write DIR/<UID>.bin for each device\n"
+            "  -r FILE        Write the patch records (CSV, - for stdout)\n"
+            "  -t THREADS     Worker threads (default: online CPUs)\n"
+            "  -h             This help\n",
+            prog, TOOL_BOOTLOADER_IMAGE_SIZE);
+}
+
+int main(int argc, char **argv)
+{
+    static const size_t key1Sizes[] = { 16U, 0U };
+    static const size_t ivSizes[] = { 16U, 0U };
+    static const size_t pubkeySizes[] = { 2U * SECBOOT_P256_SIZE, 0U };
+    const char *keyPath = NULL;
+    const char *pubkeyArg = NULL;
+    const char *key1Arg = NULL;
+    const char *ivArg = NULL;
+    const char *recordPath = NULL;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    PROV_Worker *workers;
+    uint32_t worker_count;
+    uint64_t bytes = 0U;
+    double start;
+    int rc = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "k:p:a:i:o:r:t:h")) != -1) {
+        switch (opt) {
+            case 'k':
+                keyPath = optarg;
+                break;
+            case 'p':
+                pubkeyArg = optarg;
+                break;
+            case 'a':
+                key1Arg = optarg;
+                break;
+            case 'i':
+                ivArg = optarg;
+                break;
+            case 'o':
+                out_dir = optarg;
+                break;
+            case 'r':
+                recordPath = optarg;
+                break;
+            case 't': {
+                char *end;
+
+                threads = strtol(optarg, &end, 0);
+                if (*end != '\0' || threads < 1 || threads > (long)MAX_THREADS) {
+                    fprintf(stderr, "secboot_provision: bad thread count '%s'\n", optarg);
+                    return 2;
+                }
+                break;
+            }
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (argc - optind != 2 || (keyPath != NULL) == (pubkeyArg != NULL) || (out_dir == NULL && recordPath == NULL)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (TOOL_KeyArgument(key1Arg, "SECBOOT_AES_KEY_1", "AES_KEY1", key1, sizeof(key1), key1Sizes) < 0 ||
+        TOOL_KeyArgument(ivArg, "SECBOOT_AES_IV", "AES_IV", iv, sizeof(iv), ivSizes) < 0 ||
+        (pubkeyArg != NULL &&
+         TOOL_KeyArgument(pubkeyArg, "", "public key", pubkey, sizeof(pubkey), pubkeySizes) < 0)) {
+        return 2;
+    }
+    if (keyPath != NULL) {
+        uint8_t d[SECBOOT_P256_SIZE];
+        bool ok = TOOL_LoadPrivateKey(keyPath, d) == 0 &&
+                  SECBOOT_P256_PublicKey(d, pubkey, &pubkey[SECBOOT_P256_SIZE]) == SECBOOT_P256_OK;
+
+        memset(d, 0, sizeof(d));
+        if (!ok) {
+            return 1;
+        }
+    }
+    if (map_bootloader(argv[optind]) != 0 || load_uids(argv[optind + 1]) != 0) {
+        return 1;
+    }
+    if (out_dir != NULL && mkdir(out_dir, 0777) != 0 && errno != EEXIST) {
+        fprintf(stderr, "secboot_provision: %s: %s\n", out_dir, strerror(errno));
+        return 1;
+    }
+    if (recordPath != NULL) {
+        records = malloc(device_count * RECORD_SIZE);
+        if (records == NULL) {
+            fprintf(stderr, "secboot_provision: out of memory\n");
+            return 1;
+        }
+    }
+
+    // The block follows the CRC span: one CRC for the whole batch
+    start = seconds();
+    image_crc = SECBOOT_CRC32_Accumulate(0xFFFFFFFFUL, image, TOOL_SECBLOCK_OFFSET);
+
+    worker_count = (device_count < (size_t)threads) ? (uint32_t)device_count : (uint32_t)threads;
+    workers = calloc(worker_count, sizeof(*workers));
+    if (workers == NULL) {
+        fprintf(stderr, "secboot_provision: out of memory\n");
+        return 1;
+    }
+    for (uint32_t w = 1U; w < worker_count; w++) {
+        workers[w].started = (pthread_create(&workers[w].thread, NULL, worker_main, &workers[w]) == 0);
+    }
+    (void)worker_main(&workers[0]);
+    for (uint32_t w = 1U; w < worker_count; w++) {
+        if (workers[w].started) {
+            pthread_join(workers[w].thread, NULL);
+        }
+        bytes += workers[w].bytes;
+    }
+    bytes += workers[0].bytes;
+    memset(key1, 0, sizeof(key1));
+
+    if (recordPath != NULL && write_records(recordPath) != 0) {
+        rc = 1;
+    }
+    if (atomic_load(&failures) != 0U) {
+        rc = 1;
+    }
+
+    FILE *summary = (recordPath != NULL && strcmp(recordPath, "-") == 0) ? stderr : stdout;
+
+    fprintf(summary, "%zu device%s, crc 0x%08lX", device_count, (device_count == 1U) ? "" : "s",
+            (unsigned long)image_crc);
+    if (out_dir != NULL) {
+        fprintf(summary, ", %.1f MB of images", (double)bytes / 1e6);
+    }
+    fprintf(summary, " in %.3f s, %" PRIu32 " thread%s%s\n", seconds() - start, worker_count,
+            (worker_count == 1U) ? "" : "s", (rc != 0) ? ", with errors" : "");
+    return rc;
+}
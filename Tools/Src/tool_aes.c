@@ -0,0 +1,241 @@
+/**
+  * @file    tool_aes.c
+  * @brief   AES-128/256 encryption modes for the host tools
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    Byte-oriented AES and bitwise GHASH, as in the simulator's AES
+  *          model; the tools push kilobytes, not gigabytes, through them.
+  */
+
+#include "tool_aes.h"
+
+#include <string.h>
+
+/* Private variables ----------------------------------------------------*/
+static const uint8_t sbox[256] = {
+    0x63,0x7c,0x77,0x7b,0xf2,0x6b,0x6f,0xc5,0x30,0x01,0x67,0x2b,0xfe,0xd7,0xab,0x76,
+    0xca,0x82,0xc9,0x7d,0xfa,0x59,0x47,0xf0,0xad,0xd4,0xa2,0xaf,0x9c,0xa4,0x72,0xc0,
+    0xb7,0xfd,0x93,0x26,0x36,0x3f,0xf7,0xcc,0x34,0xa5,0xe5,0xf1,0x71,0xd8,0x31,0x15,
+    0x04,0xc7,0x23,0xc3,0x18,0x96,0x05,0x9a,0x07,0x12,0x80,0xe2,0xeb,0x27,0xb2,0x75,
+    0x09,0x83,0x2c,0x1a,0x1b,0x6e,0x5a,0xa0,0x52,0x3b,0xd6,0xb3,0x29,0xe3,0x2f,0x84,
+    0x53,0xd1,0x00,0xed,0x20,0xfc,0xb1,0x5b,0x6a,0xcb,0xbe,0x39,0x4a,0x4c,0x58,0xcf,
+    0xd0,0xef,0xaa,0xfb,0x43,0x4d,0x33,0x85,0x45,0xf9,0x02,0x7f,0x50,0x3c,0x9f,0xa8,
+    0x51,0xa3,0x40,0x8f,0x92,0x9d,0x38,0xf5,0xbc,0xb6,0xda,0x21,0x10,0xff,0xf3,0xd2,
+    0xcd,0x0c,0x13,0xec,0x5f,0x97,0x44,0x17,0xc4,0xa7,0x7e,0x3d,0x64,0x5d,0x19,0x73,
+    0x60,0x81,0x4f,0xdc,0x22,0x2a,0x90,0x88,0x46,0xee,0xb8,0x14,0xde,0x5e,0x0b,0xdb,
+    0xe0,0x32,0x3a,0x0a,0x49,0x06,0x24,0x5c,0xc2,0xd3,0xac,0x62,0x91,0x95,0xe4,0x79,
+    0xe7,0xc8,0x37,0x6d,0x8d,0xd5,0x4e,0xa9,0x6c,0x56,0xf4,0xea,0x65,0x7a,0xae,0x08,
+    0xba,0x78,0x25,0x2e,0x1c,0xa6,0xb4,0xc6,0xe8,0xdd,0x74,0x1f,0x4b,0xbd,0x8b,0x8a,
+    0x70,0x3e,0xb5,0x66,0x48,0x03,0xf6,0x0e,0x61,0x35,0x57,0xb9,0x86,0xc1,0x1d,0x9e,
+    0xe1,0xf8,0x98,0x11,0x69,0xd9,0x8e,0x94,0x9b,0x1e,0x87,0xe9,0xce,0x55,0x28,0xdf,
+    0x8c,0xa1,0x89,0x0d,0xbf,0xe6,0x42,0x68,0x41,0x99,0x2d,0x0f,0xb0,0x54,0xbb,0x16
+};
+
+/* Private functions ----------------------------------------------------*/
+
+static uint8_t xtime(uint8_t x)
+{
+    return (uint8_t)((x << 1) ^ (((x >> 7) & 1U) * 0x1BU));
+}
+
+static void add_round_key(uint8_t s[16], const TOOL_AES_Key *key, uint32_t round)
+{
+    for (uint32_t i = 0U; i < 16U; i++) {
+        s[i] ^= key->roundKey[16U * round + i];
+    }
+}
+
+static void xor_block(uint8_t *r, const uint8_t *a, const uint8_t *b, size_t n)
+{
+    for (size_t i = 0U; i < n; i++) {
+        r[i] = (uint8_t)(a[i] ^ b[i]);
+    }
+}
+
+/** @brief 32-bit big-endian increment of the last word */
+static void inc32(uint8_t counter[16])
+{
+    for (int i = 15; i >= 12; i--) {
+        if (++counter[i] != 0U) {
+            break;
+        }
+    }
+}
+
+/** @brief x = x * H in GF(2^128), GCM bit order */
+static void gcm_mult_h(uint8_t x[16], const uint8_t h[16])
+{
+    uint8_t z[16] = { 0U };
+    uint8_t v[16];
+
+    memcpy(v, h, 16U);
+    for (uint32_t i = 0U; i < 128U; i++) {
+        if ((x[i / 8U] >> (7U - (i % 8U))) & 1U) {
+            xor_block(z, z, v, 16U);
+        }
+        uint8_t lsb = v[15] & 1U;
+        for (int b = 15; b > 0; b--) {
+            v[b] = (uint8_t)((v[b] >> 1) | (v[b - 1] << 7));
+        }
+        v[0] >>= 1;
+        if (lsb != 0U) {
+            v[0] ^= 0xE1U;
+        }
+    }
+    memcpy(x, z, 16U);
+}
+
+/** @brief GHASH over data, the last block zero padded */
+static void gcm_ghash(TOOL_AES_GCM *gcm, const uint8_t *p, size_t length)
+{
+    for (size_t off = 0U; off < length; off += 16U) {
+        size_t n = (length - off < 16U) ? (length - off) : 16U;
+
+        xor_block(gcm->ghash, gcm->ghash, &p[off], n);
+        gcm_mult_h(gcm->ghash, gcm->h);
+    }
+}
+
+/* Function implementations ---------------------------------------------*/
+
+int TOOL_AES_SetKey(TOOL_AES_Key *key, const uint8_t *pKey, size_t keyLen)
+{
+    uint32_t nk = (uint32_t)(keyLen / 4U);
+    uint32_t total = (nk + 7U) * 4U;
+    uint8_t rcon = 0x01U;
+    uint8_t *w = key->roundKey;
+
+    if (keyLen != 16U && keyLen != 24U && keyLen != 32U) {
+        return -1;
+    }
+
+    key->rounds = nk + 6U;
+    memcpy(w, pKey, keyLen);
+
+    for (uint32_t i = nk; i < total; i++) {
+        uint8_t t[4];
+
+        memcpy(t, &w[4U * (i - 1U)], 4U);
+        if ((i % nk) == 0U) {
+            uint8_t tmp = t[0];
+            t[0] = (uint8_t)(sbox[t[1]] ^ rcon);
+            t[1] = sbox[t[2]];
+            t[2] = sbox[t[3]];
+            t[3] = sbox[tmp];
+            rcon = xtime(rcon);
+        } else if (nk > 6U && (i % nk) == 4U) {
+            for (uint32_t j = 0U; j < 4U; j++) {
+                t[j] = sbox[t[j]];
+            }
+        }
+        for (uint32_t j = 0U; j < 4U; j++) {
+            w[4U * i + j] = (uint8_t)(w[4U * (i - nk) + j] ^ t[j]);
+        }
+    }
+    return 0;
+}
+
+void TOOL_AES_EncryptBlock(const TOOL_AES_Key *key, const uint8_t in[TOOL_AES_BLOCK_SIZE],
+                           uint8_t out[TOOL_AES_BLOCK_SIZE])
+{
+    uint8_t s[16];
+
+    memcpy(s, in, 16U);
+    add_round_key(s, key, 0U);
+
+    for (uint32_t round = 1U; round <= key->rounds; round++) {
+        uint8_t t[16];
+
+        /* SubBytes + ShiftRows */
+        for (uint32_t c = 0U; c < 4U; c++) {
+            for (uint32_t r = 0U; r < 4U; r++) {
+                t[4U * c + r] = sbox[s[4U * ((c + r) % 4U) + r]];
+            }
+        }
+        /* MixColumns */
+        if (round != key->rounds) {
+            for (uint32_t c = 0U; c < 4U; c++) {
+                uint8_t *col = &t[4U * c];
+                uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+                col[0] = (uint8_t)(xtime(a0) ^ xtime(a1) ^ a1 ^ a2 ^ a3);
+                col[1] = (uint8_t)(a0 ^ xtime(a1) ^ xtime(a2) ^ a2 ^ a3);
+                col[2] = (uint8_t)(a0 ^ a1 ^ xtime(a2) ^ xtime(a3) ^ a3);
+                col[3] = (uint8_t)(xtime(a0) ^ a0 ^ a1 ^ a2 ^ xtime(a3));
+            }
+        }
+        memcpy(s, t, 16U);
+        add_round_key(s, key, round);
+    }
+    memcpy(out, s, 16U);
+}
+
+void TOOL_AES_CBC_Encrypt(const TOOL_AES_Key *key, uint8_t iv[TOOL_AES_BLOCK_SIZE], const uint8_t *in,
+                          uint8_t *out, size_t length)
+{
+    for (size_t off = 0U; off + TOOL_AES_BLOCK_SIZE <= length; off += TOOL_AES_BLOCK_SIZE) {
+        xor_block(iv, iv, &in[off], TOOL_AES_BLOCK_SIZE);
+        TOOL_AES_EncryptBlock(key, iv, iv);
+        memcpy(&out[off], iv, TOOL_AES_BLOCK_SIZE);
+    }
+}
+
+void TOOL_AES_CTR(const TOOL_AES_Key *key, uint8_t counter[TOOL_AES_BLOCK_SIZE], const uint8_t *in,
+                  uint8_t *out, size_t length)
+{
+    uint8_t stream[TOOL_AES_BLOCK_SIZE];
+
+    for (size_t off = 0U; off < length; off += TOOL_AES_BLOCK_SIZE) {
+        size_t n = (length - off < TOOL_AES_BLOCK_SIZE) ? (length - off) : TOOL_AES_BLOCK_SIZE;
+
+        TOOL_AES_EncryptBlock(key, counter, stream);
+        inc32(counter);
+        xor_block(&out[off], &in[off], stream, n);
+    }
+}
+
+void TOOL_AES_GCM_Start(TOOL_AES_GCM *gcm, const TOOL_AES_Key *key, const uint8_t iv[TOOL_AES_GCM_IV_SIZE],
+                        const uint8_t *aad, size_t aadLen)
+{
+    memset(gcm, 0, sizeof(*gcm));
+    gcm->key = key;
+    TOOL_AES_EncryptBlock(key, gcm->h, gcm->h);
+
+    memcpy(gcm->j0, iv, TOOL_AES_GCM_IV_SIZE);
+    gcm->j0[15] = 1U;
+    memcpy(gcm->counter, gcm->j0, sizeof(gcm->counter));
+    inc32(gcm->counter);
+
+    gcm_ghash(gcm, aad, aadLen);
+    gcm->aadLen = aadLen;
+}
+
+void TOOL_AES_GCM_Encrypt(TOOL_AES_GCM *gcm, const uint8_t *in, uint8_t *out, size_t length)
+{
+    TOOL_AES_CTR(gcm->key, gcm->counter, in, out, length);
+    gcm_ghash(gcm, out, length);
+    gcm->textLen += length;
+}
+
+void TOOL_AES_GCM_Decrypt(TOOL_AES_GCM *gcm, const uint8_t *in, uint8_t *out, size_t length)
+{
+    gcm_ghash(gcm, in, length);
+    gcm->textLen += length;
+    TOOL_AES_CTR(gcm->key, gcm->counter, in, out, length);
+}
+
+void TOOL_AES_GCM_Tag(TOOL_AES_GCM *gcm, uint8_t tag[TOOL_AES_GCM_TAG_SIZE])
+{
+    uint8_t lengths[16];
+    uint64_t aadBits = gcm->aadLen * 8U;
+    uint64_t textBits = gcm->textLen * 8U;
+
+    for (uint32_t i = 0U; i < 8U; i++) {
+        lengths[7U - i] = (uint8_t)(aadBits >> (8U * i));
+        lengths[15U - i] = (uint8_t)(textBits >> (8U * i));
+    }
+    gcm_ghash(gcm, lengths, sizeof(lengths));
+
+    TOOL_AES_EncryptBlock(gcm->key, gcm->j0, tag);
+    xor_block(tag, tag, gcm->ghash, TOOL_AES_GCM_TAG_SIZE);
+}
@@ -0,0 +1,666 @@
+/**
+  * @file    tool_image.c
+  * @brief   Signed image and bootloader layouts for the host tools
+  * @version 1.0
+  * @date    2026-10-16
+  */
+
+#include "tool_image.h"
+#include "tool_aes.h"
+#include "tool_sha256.h"
+#include "secboot_crc32.h"
+#include "secboot_lz.h"
+#include "prime256v1.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define CHECK_BLOCKS  32U    /* v2 blocks hashed per TOOL_SHA256_Multi call */
+
+/* Private types --------------------------------------------------------*/
+typedef struct {
+    const uint8_t *p;
+    size_t remaining;
+} TOOL_LzSource;
+
+/* Private functions ----------------------------------------------------*/
+
+/** @brief Swap the bytes of each 32-bit word, as hex_string_to_words_le does */
+static void swap_words(uint8_t *out, const uint8_t *in, size_t length)
+{
+    for (size_t i = 0U; i + 4U <= length; i += 4U) {
+        out[i]      = in[i + 3U];
+        out[i + 1U] = in[i + 2U];
+        out[i + 2U] = in[i + 1U];
+        out[i + 3U] = in[i];
+    }
+}
+
+static int base64_value(int c)
+{
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A';
+    }
+    if (c >= 'a' && c <= 'z') {
+        return c - 'a' + 26;
+    }
+    if (c >= '0' && c <= '9') {
+        return c - '0' + 52;
+    }
+    return (c == '+') ? 62 : (c == '/') ? 63 : -1;
+}
+
+/**
+  * @brief  DER body of the first PEM block of the given label
+  * @retval Decoded bytes, or 0 when there is none
+  */
+static size_t pem_decode(const char *text, const char *label, uint8_t *out, size_t max)
+{
+    char begin[64];
+    char end[64];
+    const char *p;
+    const char *stop;
+    uint32_t acc = 0U;
+    uint32_t bits = 0U;
+    size_t n = 0U;
+
+    snprintf(begin, sizeof(begin), "-----BEGIN %s-----", label);
+    snprintf(end, sizeof(end), "-----END %s-----", label);
+    p = strstr(text, begin);
+    if (p == NULL) {
+        return 0U;
+    }
+    p += strlen(begin);
+    stop = strstr(p, end);
+    if (stop == NULL) {
+        return 0U;
+    }
+
+    for (; p < stop && *p != '='; p++) {
+        int v = base64_value((unsigned char)*p);
+
+        if (v < 0) {
+            continue;       /* Line breaks */
+        }
+        acc = (acc << 6) | (uint32_t)v;
+        bits += 6U;
+        if (bits >= 8U) {
+            bits -= 8U;
+            if (n == max) {
+                return 0U;
+            }
+            out[n++] = (uint8_t)(acc >> bits);
+        }
+    }
+    return n;
+}
+
+/**
+  * @brief  Enter one DER element: checks its tag, returns its body
+  * @retval Body length, or -1
+  */
+static long der_enter(const uint8_t **pp, const uint8_t *end, uint8_t tag)
+{
+    const uint8_t *p = *pp;
+    size_t length;
+
+    if (end - p < 2 || p[0] != tag) {
+        return -1;
+    }
+    length = p[1];
+    p += 2;
+    if (length & 0x80U) {
+        size_t bytes = length & 0x7FU;
+
+        if (bytes == 0U || bytes > 2U || (size_t)(end - p) < bytes) {
+            return -1;
+        }
+        length = 0U;
+        while (bytes-- > 0U) {
+            length = (length << 8) | *p++;
+        }
+    }
+    if ((size_t)(end - p) < length) {
+        return -1;
+    }
+    *pp = p;
+    return (long)length;
+}
+
+/**
+  * @brief  Private key of an ECPrivateKey (SEC 1) body
+  */
+static int sec1_private_key(const uint8_t *p, const uint8_t *end, uint8_t d[SECBOOT_P256_SIZE])
+{
+    long len;
+
+    if ((len = der_enter(&p, end, 0x30U)) < 0) {
+        return -1;
+    }
+    end = p + len;
+    if (der_enter(&p, end, 0x02U) != 1 || *p != 1U) {    /* version 1 */
+        return -1;
+    }
+    p++;
+    len = der_enter(&p, end, 0x04U);
+    if (len <= 0 || len > (long)SECBOOT_P256_SIZE) {
+        return -1;
+    }
+    memset(d, 0, SECBOOT_P256_SIZE);
+    memcpy(&d[SECBOOT_P256_SIZE - (size_t)len], p, (size_t)len);
+    return 0;
+}
+
+/**
+  * @brief  ECPrivateKey inside a PrivateKeyInfo (PKCS #8) body
+  */
+static int pkcs8_private_key(const uint8_t *p, const uint8_t *end, uint8_t d[SECBOOT_P256_SIZE])
+{
+    long len;
+
+    if ((len = der_enter(&p, end, 0x30U)) < 0) {
+        return -1;
+    }
+    end = p + len;
+    if (der_enter(&p, end, 0x02U) != 1 || *p != 0U) {    /* version 0 */
+        return -1;
+    }
+    p++;
+    if ((len = der_enter(&p, end, 0x30U)) < 0) {       /* AlgorithmIdentifier */
+        return -1;
+    }
+    p += len;
+    if ((len = der_enter(&p, end, 0x04U)) < 0) {
+        return -1;
+    }
+    return sec1_private_key(p, p + len, d);
+}
+
+/** @brief a - b on 32-byte big-endian integers, a >= b */
+static void be_sub(uint8_t *r, const uint8_t *a, const uint8_t *b)
+{
+    int borrow = 0;
+
+    for (int i = (int)SECBOOT_P256_SIZE - 1; i >= 0; i--) {
+        int v = (int)a[i] - (int)b[i] - borrow;
+
+        borrow = (v < 0);
+        r[i] = (uint8_t)v;
+    }
+}
+
+static SECBOOT_LZ_StatusTypeDef lz_read(void *source, uint8_t *pData, uint32_t length)
+{
+    TOOL_LzSource *src = source;
+
+    if (length > src->remaining) {
+        return SECBOOT_LZ_READ_ERROR;
+    }
+    memcpy(pData, src->p, length);
+    src->p += length;
+    src->remaining -= length;
+    return SECBOOT_LZ_OK;
+}
+
+/* Little-endian fields -------------------------------------------------*/
+
+uint32_t TOOL_GetLE32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void TOOL_PutLE32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+/* Headers --------------------------------------------------------------*/
+
+void TOOL_Image_BuildHeader(TOOL_ImageHeader *h, uint8_t out[TOOL_FW_HEADER_SIZE])
+{
+    memset(out, 0xFF, TOOL_FW_HEADER_SIZE);
+    TOOL_PutLE32(&out[0], h->magic);
+    TOOL_PutLE32(&out[4], h->size);
+    memcpy(&out[8], h->version, sizeof(h->version));
+    TOOL_PutLE32(&out[12], h->entryPoint);
+    memcpy(&out[16], h->firmwareHash, sizeof(h->firmwareHash));
+    memcpy(&out[48], h->signature, sizeof(h->signature));
+    h->headerCRC = SECBOOT_CRC32_Calculate(out, TOOL_FW_HEADER_CRC_SPAN);
+    TOOL_PutLE32(&out[TOOL_FW_HEADER_CRC_SPAN], h->headerCRC);
+}
+
+TOOL_Image_StatusTypeDef TOOL_Image_ParseHeader(const uint8_t hdr[TOOL_FW_HEADER_SIZE], TOOL_ImageHeader *h)
+{
+    h->magic = TOOL_GetLE32(&hdr[0]);
+    h->size = TOOL_GetLE32(&hdr[4]);
+    memcpy(h->version, &hdr[8], sizeof(h->version));
+    h->entryPoint = TOOL_GetLE32(&hdr[12]);
+    memcpy(h->firmwareHash, &hdr[16], sizeof(h->firmwareHash));
+    memcpy(h->signature, &hdr[48], sizeof(h->signature));
+    h->headerCRC = TOOL_GetLE32(&hdr[TOOL_FW_HEADER_CRC_SPAN]);
+
+    if (h->magic != TOOL_FW_MAGIC_V1 && h->magic != TOOL_FW_MAGIC_V2) {
+        return TOOL_IMAGE_BAD_MAGIC;
+    }
+    if (SECBOOT_CRC32_Calculate(hdr, TOOL_FW_HEADER_CRC_SPAN) != h->headerCRC) {
+        return TOOL_IMAGE_BAD_HEADER_CRC;
+    }
+    return TOOL_IMAGE_OK;
+}
+
+void TOOL_Image_ParseDescriptors(const uint8_t hdr[TOOL_FW_HEADER_SIZE], TOOL_ImageDescriptors *d)
+{
+    const uint8_t *enc = &hdr[TOOL_FW_ENC_INFO_OFFSET];
+    const uint8_t *comp = &hdr[TOOL_FW_COMP_INFO_OFFSET];
+    const uint8_t *delta = &hdr[TOOL_FW_DELTA_INFO_OFFSET];
+
+    memset(d, 0, sizeof(*d));
+    if (TOOL_GetLE32(enc) == TOOL_FW_ENC_MAGIC) {
+        d->encrypted = true;
+        d->encMode = TOOL_GetLE32(&enc[4]);
+        memcpy(d->encIv, &enc[8], sizeof(d->encIv));
+        memcpy(d->encTag, &enc[24], sizeof(d->encTag));
+    }
+    if (TOOL_GetLE32(comp) == TOOL_FW_COMP_MAGIC_LZSS) {
+        d->compressed = true;
+        d->compressedSize = TOOL_GetLE32(&comp[4]);
+    }
+    if (TOOL_GetLE32(delta) == TOOL_FW_DELTA_MAGIC) {
+        d->delta = true;
+        d->patchSize = TOOL_GetLE32(&delta[4]);
+        memcpy(d->baseHash, &delta[8], sizeof(d->baseHash));
+    }
+}
+
+size_t TOOL_Image_StreamSize(const TOOL_ImageHeader *h)
+{
+    if (h->magic != TOOL_FW_MAGIC_V2) {
+        return h->size;
+    }
+    return TOOL_FW_TABLE_OFFSET((size_t)h->size) + (size_t)TOOL_FW_BLOCK_COUNT(h->size) * TOOL_SHA256_SIZE;
+}
+
+/* Checks ---------------------------------------------------------------*/
+
+TOOL_Image_StatusTypeDef TOOL_Image_CheckStream(const TOOL_ImageHeader *h, const uint8_t *stream, size_t length,
+                                                uint32_t *pBadBlock)
+{
+    uint8_t digest[TOOL_SHA256_SIZE];
+
+    if (length < TOOL_Image_StreamSize(h)) {
+        return TOOL_IMAGE_TRUNCATED;
+    }
+
+    if (h->magic != TOOL_FW_MAGIC_V2) {
+        TOOL_SHA256(stream, h->size, digest);
+        return (memcmp(digest, h->firmwareHash, sizeof(digest)) == 0) ? TOOL_IMAGE_OK : TOOL_IMAGE_BAD_HASH;
+    }
+
+    /* v2: the table under the signed root first, then every block against it */
+    const uint8_t *table = &stream[TOOL_FW_TABLE_OFFSET((size_t)h->size)];
+    uint32_t blocks = TOOL_FW_BLOCK_COUNT(h->size);
+
+    TOOL_SHA256(table, (size_t)blocks * TOOL_SHA256_SIZE, digest);
+    if (memcmp(digest, h->firmwareHash, sizeof(digest)) != 0) {
+        return TOOL_IMAGE_BAD_HASH;
+    }
+    /* Blocks are independent messages: hashed several at a time */
+    for (uint32_t first = 0U; first < blocks; first += CHECK_BLOCKS) {
+        const uint8_t *messages[CHECK_BLOCKS];
+        size_t lengths[CHECK_BLOCKS];
+        uint8_t digests[CHECK_BLOCKS][TOOL_SHA256_SIZE];
+        uint32_t count = (blocks - first < CHECK_BLOCKS) ? (blocks - first) : CHECK_BLOCKS;
+
+        for (uint32_t i = 0U; i < count; i++) {
+            size_t off = (size_t)(first + i) * TOOL_FW_BLOCK_SIZE;
+
+            messages[i] = &stream[off];
+            lengths[i] = (h->size - off < TOOL_FW_BLOCK_SIZE) ? (h->size - off) : TOOL_FW_BLOCK_SIZE;
+        }
+        TOOL_SHA256_Multi(messages, lengths, count, digests);
+        for (uint32_t i = 0U; i < count; i++) {
+            if (memcmp(digests[i], &table[(size_t)(first + i) * TOOL_SHA256_SIZE], TOOL_SHA256_SIZE) != 0) {
+                if (pBadBlock != NULL) {
+                    *pBadBlock = first + i;
+                }
+                return TOOL_IMAGE_BAD_TABLE;
+            }
+        }
+    }
+    return TOOL_IMAGE_OK;
+}
+
+TOOL_Image_StatusTypeDef TOOL_Image_CheckSignature(const TOOL_ImageHeader *h, const uint8_t *qx, const uint8_t *qy)
+{
+    switch (SECBOOT_P256_Verify(h->firmwareHash, h->signature, &h->signature[SECBOOT_P256_SIZE], qx, qy)) {
+        case SECBOOT_P256_OK:
+            return TOOL_IMAGE_OK;
+        case SECBOOT_P256_INVALID_PUBKEY:
+            return TOOL_IMAGE_BAD_PUBKEY;
+        default:
+            return TOOL_IMAGE_BAD_SIGNATURE;
+    }
+}
+
+TOOL_Image_StatusTypeDef TOOL_Image_Decrypt(const uint8_t *image, size_t length, const uint8_t *key, size_t keyLen,
+                                            uint8_t **pStream, size_t *pLength)
+{
+    TOOL_ImageHeader h;
+    TOOL_ImageDescriptors d;
+    TOOL_AES_Key aes;
+    size_t cipherLen;
+    size_t streamLen;
+    uint8_t *clear;
+
+    if (length < TOOL_FW_HEADER_SIZE) {
+        return TOOL_IMAGE_TRUNCATED;
+    }
+    (void)TOOL_Image_ParseHeader(image, &h);
+    TOOL_Image_ParseDescriptors(image, &d);
+    streamLen = TOOL_Image_StreamSize(&h);
+    cipherLen = d.delta ? d.patchSize : d.compressed ? d.compressedSize : streamLen;
+    if (length - TOOL_FW_HEADER_SIZE < cipherLen) {
+        return TOOL_IMAGE_TRUNCATED;
+    }
+    if (d.encrypted && (key == NULL || TOOL_AES_SetKey(&aes, key, keyLen) != 0)) {
+        return TOOL_IMAGE_NEED_KEY;
+    }
+    if (d.encrypted && d.encMode != TOOL_FW_ENC_MODE_CTR && d.encMode != TOOL_FW_ENC_MODE_GCM) {
+        return TOOL_IMAGE_BAD_STREAM;
+    }
+
+    clear = malloc(cipherLen + 1U);
+    if (clear == NULL) {
+        return TOOL_IMAGE_BAD_STREAM;
+    }
+    if (!d.encrypted) {
+        memcpy(clear, &image[TOOL_FW_HEADER_SIZE], cipherLen);
+    } else if (d.encMode == TOOL_FW_ENC_MODE_CTR) {
+        uint8_t counter[TOOL_AES_BLOCK_SIZE];
+
+        memcpy(counter, d.encIv, sizeof(counter));
+        TOOL_AES_CTR(&aes, counter, &image[TOOL_FW_HEADER_SIZE], clear, cipherLen);
+    } else {
+        TOOL_AES_GCM gcm;
+        uint8_t tag[TOOL_AES_GCM_TAG_SIZE];
+
+        TOOL_AES_GCM_Start(&gcm, &aes, d.encIv, image, TOOL_FW_HEADER_FIELDS);
+        TOOL_AES_GCM_Decrypt(&gcm, &image[TOOL_FW_HEADER_SIZE], clear, cipherLen);
+        TOOL_AES_GCM_Tag(&gcm, tag);
+        if (memcmp(tag, d.encTag, sizeof(tag)) != 0) {
+            free(clear);
+            return TOOL_IMAGE_BAD_TAG;
+        }
+    }
+
+    if (d.compressed && !d.delta) {
+        SECBOOT_LZ_Context *lz = malloc(sizeof(*lz));
+        uint8_t *stream = malloc(streamLen + 1U);
+        TOOL_LzSource src = { clear, cipherLen };
+        bool ok = (lz != NULL && stream != NULL && cipherLen <= UINT32_MAX && streamLen <= UINT32_MAX);
+
+        ok = ok && SECBOOT_LZ_Init(lz, lz_read, &src, (uint32_t)cipherLen) == SECBOOT_LZ_OK;
+        ok = ok && SECBOOT_LZ_Output(lz, stream, (uint32_t)streamLen) == SECBOOT_LZ_OK;
+        ok = ok && SECBOOT_LZ_Finish(lz) == SECBOOT_LZ_OK;
+        free(lz);
+        free(clear);
+        if (!ok) {
+            free(stream);
+            return TOOL_IMAGE_BAD_STREAM;
+        }
+        clear = stream;
+        cipherLen = streamLen;
+    }
+
+    *pStream = clear;
+    *pLength = cipherLen;
+    return TOOL_IMAGE_OK;
+}
+
+const char *TOOL_Image_StatusName(TOOL_Image_StatusTypeDef status)
+{
+    static const char *const names[] = {
+        "ok", "truncated", "bad_magic", "bad_header_crc", "bad_block", "bad_hash", "bad_signature",
+        "bad_pubkey", "need_key", "bad_tag", "bad_stream"
+    };
+
+    return ((size_t)status < sizeof(names) / sizeof(names[0])) ? names[status] : "unknown";
+}
+
+/* Keys and signatures --------------------------------------------------*/
+
+int TOOL_LoadPrivateKey(const char *path, uint8_t d[SECBOOT_P256_SIZE])
+{
+    uint8_t *text;
+    size_t size;
+    uint8_t der[512];
+    size_t n;
+    int rc = -1;
+
+    if (TOOL_ReadFile(path, &text, &size) != 0) {
+        return -1;
+    }
+    text[size] = '\0';
+
+    if ((n = pem_decode((const char *)text, "EC PRIVATE KEY", der, sizeof(der))) > 0U) {
+        rc = sec1_private_key(der, der + n, d);
+    } else if ((n = pem_decode((const char *)text, "PRIVATE KEY", der, sizeof(der))) > 0U) {
+        rc = pkcs8_private_key(der, der + n, d);
+    }
+    if (rc == 0 && SECBOOT_P256_PublicKey(d, der, &der[SECBOOT_P256_SIZE]) != SECBOOT_P256_OK) {
+        rc = -1;
+    }
+    if (rc != 0) {
+        fprintf(stderr, "%s: %s: not an unencrypted P-256 private key\n", program_invocation_short_name, path);
+    }
+
+    memset(der, 0, sizeof(der));
+    memset(text, 0, size);
+    free(text);
+    return rc;
+}
+
+int TOOL_Sign(const uint8_t digest[SECBOOT_P256_SIZE], const uint8_t d[SECBOOT_P256_SIZE],
+              uint8_t signature[2U * SECBOOT_P256_SIZE])
+{
+    static const uint8_t zero = 0x00U;
+    static const uint8_t one = 0x01U;
+    const uint8_t *order = get_prime256v1_curve()->order;
+    uint8_t h1[SECBOOT_P256_SIZE];
+    uint8_t v[TOOL_SHA256_SIZE];
+    uint8_t k[TOOL_SHA256_SIZE];
+    const size_t vLen = sizeof(v);
+    int rc = -1;
+
+    /* A bad d would otherwise look like an endless run of bad nonces */
+    if (SECBOOT_P256_PublicKey(d, v, k) != SECBOOT_P256_OK) {
+        return -1;
+    }
+
+    /* RFC 6979 3.2, qlen = hlen = 256: bits2octets(h1) is h1 mod n */
+    memcpy(h1, digest, sizeof(h1));
+    if (memcmp(h1, order, sizeof(h1)) >= 0) {
+        be_sub(h1, h1, order);
+    }
+
+    memset(v, 0x01, sizeof(v));
+    memset(k, 0x00, sizeof(k));
+    for (uint32_t round = 0U; round < 2U; round++) {
+        const uint8_t *parts[] = { v, (round == 0U) ? &zero : &one, d, h1 };
+        const size_t lengths[] = { vLen, 1U, SECBOOT_P256_SIZE, sizeof(h1) };
+
+        TOOL_HMAC_SHA256(k, sizeof(k), parts, lengths, 4U, k);
+        TOOL_HMAC_SHA256(k, sizeof(k), (const uint8_t *const[]){ v }, &vLen, 1U, v);
+    }
+
+    /* A candidate fails with probability ~2^-128: the bound is never reached */
+    for (uint32_t tries = 0U; tries < 16U && rc != 0; tries++) {
+        const uint8_t *parts[] = { v, &zero };
+        const size_t lengths[] = { vLen, 1U };
+
+        TOOL_HMAC_SHA256(k, sizeof(k), (const uint8_t *const[]){ v }, &vLen, 1U, v);
+        if (SECBOOT_P256_Sign(digest, d, v, signature, &signature[SECBOOT_P256_SIZE]) == SECBOOT_P256_OK) {
+            rc = 0;
+        } else {
+            /* K = HMAC_K(V || 0x00), V = HMAC_K(V) */
+            TOOL_HMAC_SHA256(k, sizeof(k), parts, lengths, 2U, k);
+            TOOL_HMAC_SHA256(k, sizeof(k), (const uint8_t *const[]){ v }, &vLen, 1U, v);
+        }
+    }
+
+    memset(k, 0, sizeof(k));
+    memset(v, 0, sizeof(v));
+    return rc;
+}
+
+int TOOL_ParseHex(const char *arg, uint8_t *out, size_t max)
+{
+    uint8_t *file = NULL;
+    const char *p = arg;
+    size_t n = 0U;
+    int high = -1;
+    int rc;
+
+    if (arg[0] == '@') {
+        size_t size;
+
+        if (TOOL_ReadFile(&arg[1], &file, &size) != 0) {
+            return -1;
+        }
+        file[size] = '\0';
+        p = (const char *)file;
+    }
+
+    for (rc = 0; *p != '\0'; p++) {
+        int c = (unsigned char)*p;
+        int v;
+
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            continue;
+        }
+        v = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 :
+            (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+        if (v < 0 || (high < 0 && n == max)) {
+            rc = -1;
+            break;
+        }
+        if (high < 0) {
+            high = v;
+        } else {
+            out[n++] = (uint8_t)((high << 4) | v);
+            high = -1;
+        }
+    }
+    if (high >= 0) {
+        rc = -1;
+    }
+
+    if (file != NULL) {
+        memset(file, 0, strlen((const char *)file));
+        free(file);
+    }
+    return (rc == 0) ? (int)n : -1;
+}
+
+int TOOL_KeyArgument(const char *arg, const char *env, const char *what, uint8_t *out, size_t max,
+                     const size_t *sizes)
+{
+    int n;
+
+    if (arg == NULL) {
+        arg = getenv(env);
+    }
+    if (arg == NULL) {
+        fprintf(stderr, "%s: no %s (option or $%s)\n", program_invocation_short_name, what, env);
+        return -1;
+    }
+    n = TOOL_ParseHex(arg, out, max);
+    for (size_t i = 0U; n >= 0 && sizes[i] != 0U; i++) {
+        if ((size_t)n == sizes[i]) {
+            return n;
+        }
+    }
+    fprintf(stderr, "%s: bad %s\n", program_invocation_short_name, what);
+    return -1;
+}
+
+/* Bootloader security block --------------------------------------------*/
+
+int TOOL_WrapKey(const uint8_t *key1, size_t key1Len, const uint8_t *wrapKey, size_t wrapKeyLen,
+                 const uint8_t iv[16], uint8_t wrapped[TOOL_WRAPPED_KEY_SIZE])
+{
+    TOOL_AES_Key aes;
+    uint8_t chain[TOOL_AES_BLOCK_SIZE];
+    uint8_t padded[TOOL_WRAPPED_KEY_SIZE];
+
+    if (key1Len != 16U || (wrapKeyLen != 16U && wrapKeyLen != 32U) ||
+        TOOL_AES_SetKey(&aes, wrapKey, wrapKeyLen) != 0) {
+        return -1;
+    }
+
+    /* PKCS#7: a 16-byte key gets a whole block of 0x10 */
+    memcpy(padded, key1, 16U);
+    memset(&padded[16], 16, 16U);
+    memcpy(chain, iv, sizeof(chain));
+    TOOL_AES_CBC_Encrypt(&aes, chain, padded, wrapped, sizeof(padded));
+
+    memset(padded, 0, sizeof(padded));
+    memset(&aes, 0, sizeof(aes));
+    return 0;
+}
+
+void TOOL_DeviceKey(const uint32_t uid[TOOL_UID_WORDS], uint8_t key[TOOL_DEVICE_KEY_SIZE])
+{
+    uint8_t words[TOOL_DEVICE_KEY_SIZE];
+
+    for (uint32_t i = 0U; i < TOOL_UID_WORDS; i++) {
+        TOOL_PutLE32(&words[4U * i], uid[i]);
+    }
+    TOOL_PutLE32(&words[4U * TOOL_UID_WORDS], TOOL_FW_MAGIC_V1);
+    swap_words(key, words, sizeof(words));
+}
+
+void TOOL_BuildSecBlock(const uint8_t wrapped[TOOL_WRAPPED_KEY_SIZE], const uint8_t iv[16], const uint8_t *qx,
+                        const uint8_t *qy, uint32_t crc, uint8_t out[TOOL_SECBLOCK_SIZE])
+{
+    swap_words(&out[TOOL_SECBLOCK_KEY - TOOL_SECBLOCK_OFFSET], wrapped, TOOL_WRAPPED_KEY_SIZE);
+    swap_words(&out[TOOL_SECBLOCK_IV - TOOL_SECBLOCK_OFFSET], iv, 16U);
+    memcpy(&out[TOOL_SECBLOCK_PUBKEY - TOOL_SECBLOCK_OFFSET], qx, SECBOOT_P256_SIZE);
+    memcpy(&out[TOOL_SECBLOCK_PUBKEY - TOOL_SECBLOCK_OFFSET + SECBOOT_P256_SIZE], qy, SECBOOT_P256_SIZE);
+    TOOL_PutLE32(&out[TOOL_SECBLOCK_CRC - TOOL_SECBLOCK_OFFSET], crc);
+}
+
+/* Files ----------------------------------------------------------------*/
+
+int TOOL_ReadFile(const char *path, uint8_t **pData, size_t *pSize)
+{
+    FILE *f = fopen(path, "rb");
+    struct stat st;
+    uint8_t *data;
+
+    if (f == NULL || fstat(fileno(f), &st) != 0) {
+        fprintf(stderr, "%s: %s: %s\n", program_invocation_short_name, path, strerror(errno));
+        if (f != NULL) {
+            fclose(f);
+        }
+        return -1;
+    }
+    /* One spare byte, so text can be terminated */
+    data = malloc((size_t)st.st_size + 1U);
+    if (data == NULL || fread(data, 1, (size_t)st.st_size, f) != (size_t)st.st_size) {
+        fprintf(stderr, "%s: %s: read failed\n", program_invocation_short_name, path);
+        free(data);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    *pData = data;
+    *pSize = (size_t)st.st_size;
+    return 0;
+}
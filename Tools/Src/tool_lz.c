@@ -0,0 +1,111 @@
+/**
+  * @file    tool_lz.c
+  * @brief   LZSS compressor for update images (the secboot_lz.h format)
+  * @version 1.0
+  * @date    2026-10-16
+  */
+
+#include "tool_lz.h"
+#include "secboot_lz.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LZ_HASH_BITS  16U
+#define LZ_NONE       SIZE_MAX
+
+/* Private functions ----------------------------------------------------*/
+
+static uint32_t prefix_hash(const uint8_t *p)
+{
+    uint32_t key = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+
+    return (key * 2654435761U) >> (32U - LZ_HASH_BITS);
+}
+
+/* Function implementations ---------------------------------------------*/
+
+uint8_t *TOOL_LZ_Compress(const uint8_t *in, size_t length, size_t *pLength)
+{
+    /* Worst case: all literals, one flag byte per eight */
+    uint8_t *out = malloc(length + length / 8U + 1U);
+    size_t *head = malloc(((size_t)1U << LZ_HASH_BITS) * sizeof(size_t));
+    size_t *prev = malloc((length + 1U) * sizeof(size_t));
+    size_t outLen = 0U;
+    size_t flagsAt = 0U;
+    uint32_t tokens = 0U;
+    size_t i = 0U;
+
+    if (out == NULL || head == NULL || prev == NULL) {
+        free(out);
+        free(head);
+        free(prev);
+        return NULL;
+    }
+    for (size_t h = 0U; h < ((size_t)1U << LZ_HASH_BITS); h++) {
+        head[h] = LZ_NONE;
+    }
+
+    while (i < length) {
+        size_t bestLen = 0U;
+        size_t bestOff = 0U;
+
+        if ((tokens % 8U) == 0U) {
+            flagsAt = outLen;
+            out[outLen++] = 0U;
+        }
+
+        if (i + SECBOOT_LZ_MIN_MATCH <= length) {
+            size_t limit = (length - i < TOOL_LZ_MAX_MATCH) ? (length - i) : TOOL_LZ_MAX_MATCH;
+            uint32_t tried = 0U;
+
+            for (size_t j = head[prefix_hash(&in[i])]; j != LZ_NONE && tried < TOOL_LZ_MAX_CHAIN; j = prev[j]) {
+                size_t n = 0U;
+
+                if (i - j > SECBOOT_LZ_WINDOW_SIZE) {
+                    break;
+                }
+                if (memcmp(&in[j], &in[i], SECBOOT_LZ_MIN_MATCH) != 0) {
+                    continue;       /* Hash collision: not in the prefix's chain */
+                }
+                tried++;
+                while (n < limit && in[j + n] == in[i + n]) {
+                    n++;
+                }
+                if (n > bestLen) {
+                    bestLen = n;
+                    bestOff = i - j;
+                    if (n == limit) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (bestLen >= SECBOOT_LZ_MIN_MATCH) {
+            uint32_t token = (uint32_t)((bestOff - 1U) << SECBOOT_LZ_LENGTH_BITS) |
+                             (uint32_t)(bestLen - SECBOOT_LZ_MIN_MATCH);
+
+            out[flagsAt] |= (uint8_t)(1U << (tokens % 8U));
+            out[outLen++] = (uint8_t)token;
+            out[outLen++] = (uint8_t)(token >> 8);
+        } else {
+            bestLen = 1U;
+            out[outLen++] = in[i];
+        }
+        for (size_t k = 0U; k < bestLen; k++, i++) {
+            if (i + SECBOOT_LZ_MIN_MATCH <= length) {
+                uint32_t h = prefix_hash(&in[i]);
+
+                prev[i] = head[h];
+                head[h] = i;
+            }
+        }
+        tokens++;
+    }
+
+    free(head);
+    free(prev);
+    *pLength = outLen;
+    return out;
+}
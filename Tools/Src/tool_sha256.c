@@ -0,0 +1,371 @@
+/**
+  * @file    tool_sha256.c
+  * @brief   SHA-256 and HMAC-SHA256 for the host tools
+  * @version 1.0
+  * @date    2026-10-16
+  *
+  * @note    SHA-NI runs two rounds per sha256rnds2 on the state split as
+  *          ABEF / CDGH, with sha256msg1/msg2 extending the schedule four
+  *          words at a time; the portable function is the one of the
+  *          simulator's HASH model. SECBOOT_TOOL_SHA=portable in the
+  *          environment forces the portable one.
+  *          TOOL_SHA256_Multi interleaves the rounds of two messages on
+  *          SHA-NI: each sha256rnds2 waits for the one before it, and a
+  *          second, independent chain fills those cycles.
+  */
+
+#include "tool_sha256.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define TOOL_SHA256_HAVE_SHANI  1
+#endif
+
+typedef void (*sha256_blocks_fn)(uint32_t state[8], const uint8_t *p, size_t blocks);
+typedef void (*sha256_blocks_x2_fn)(uint32_t *state[2], const uint8_t *const p[2], size_t blocks);
+
+/* Private variables ----------------------------------------------------*/
+static const uint32_t K[64] = {
+    0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U, 0x3956c25bU, 0x59f111f1U, 0x923f82a4U, 0xab1c5ed5U,
+    0xd807aa98U, 0x12835b01U, 0x243185beU, 0x550c7dc3U, 0x72be5d74U, 0x80deb1feU, 0x9bdc06a7U, 0xc19bf174U,
+    0xe49b69c1U, 0xefbe4786U, 0x0fc19dc6U, 0x240ca1ccU, 0x2de92c6fU, 0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU,
+    0x983e5152U, 0xa831c66dU, 0xb00327c8U, 0xbf597fc7U, 0xc6e00bf3U, 0xd5a79147U, 0x06ca6351U, 0x14292967U,
+    0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU, 0x53380d13U, 0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U,
+    0xa2bfe8a1U, 0xa81a664bU, 0xc24b8b70U, 0xc76c51a3U, 0xd192e819U, 0xd6990624U, 0xf40e3585U, 0x106aa070U,
+    0x19a4c116U, 0x1e376c08U, 0x2748774cU, 0x34b0bcb5U, 0x391c0cb3U, 0x4ed8aa4aU, 0x5b9cca4fU, 0x682e6ff3U,
+    0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U, 0x90befffaU, 0xa4506cebU, 0xbef9a3f7U, 0xc67178f2U
+};
+
+static const uint32_t H0[8] = {
+    0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU, 0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U
+};
+
+static sha256_blocks_fn blocks_fn = NULL;
+static sha256_blocks_x2_fn blocks_x2_fn = NULL;
+static const char *engine_name = "portable";
+
+/* Private functions ----------------------------------------------------*/
+
+#define ROR(x, n)  (((x) >> (n)) | ((x) << (32U - (n))))
+
+static void sha256_blocks_portable(uint32_t st[8], const uint8_t *p, size_t blocks)
+{
+    for (; blocks > 0U; blocks--, p += TOOL_SHA256_BLOCK_SIZE) {
+        uint32_t w[64];
+        uint32_t a, b, c, d, e, f, g, h;
+
+        for (uint32_t i = 0U; i < 16U; i++) {
+            w[i] = ((uint32_t)p[4U * i] << 24) | ((uint32_t)p[4U * i + 1U] << 16) |
+                   ((uint32_t)p[4U * i + 2U] << 8) | (uint32_t)p[4U * i + 3U];
+        }
+        for (uint32_t i = 16U; i < 64U; i++) {
+            uint32_t s0 = ROR(w[i - 15U], 7U) ^ ROR(w[i - 15U], 18U) ^ (w[i - 15U] >> 3);
+            uint32_t s1 = ROR(w[i - 2U], 17U) ^ ROR(w[i - 2U], 19U) ^ (w[i - 2U] >> 10);
+            w[i] = w[i - 16U] + s0 + w[i - 7U] + s1;
+        }
+
+        a = st[0]; b = st[1]; c = st[2]; d = st[3];
+        e = st[4]; f = st[5]; g = st[6]; h = st[7];
+
+        for (uint32_t i = 0U; i < 64U; i++) {
+            uint32_t t1 = h + (ROR(e, 6U) ^ ROR(e, 11U) ^ ROR(e, 25U)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            uint32_t t2 = (ROR(a, 2U) ^ ROR(a, 13U) ^ ROR(a, 22U)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        st[0] += a; st[1] += b; st[2] += c; st[3] += d;
+        st[4] += e; st[5] += f; st[6] += g; st[7] += h;
+    }
+}
+
+static void sha256_blocks_portable_x2(uint32_t *st[2], const uint8_t *const p[2], size_t blocks)
+{
+    sha256_blocks_portable(st[0], p[0], blocks);
+    sha256_blocks_portable(st[1], p[1], blocks);
+}
+
+#ifdef TOOL_SHA256_HAVE_SHANI
+__attribute__((target("sha,sse4.1,ssse3")))
+static void sha256_blocks_shani(uint32_t st[8], const uint8_t *p, size_t blocks)
+{
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+    __m128i state0, state1, tmp;
+
+    // ABCD / EFGH -> ABEF / CDGH, the operand order of sha256rnds2
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&st[0]), 0xB1);
+    state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&st[4]), 0x1B);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    for (; blocks > 0U; blocks--, p += TOOL_SHA256_BLOCK_SIZE) {
+        const __m128i abef = state0;
+        const __m128i cdgh = state1;
+        __m128i w[16];
+
+        for (uint32_t i = 0U; i < 16U; i++) {
+            __m128i msg;
+
+            if (i < 4U) {
+                w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&p[16U * i]), bswap);
+            } else {
+                msg = _mm_sha256msg1_epu32(w[i - 4U], w[i - 3U]);
+                msg = _mm_add_epi32(msg, _mm_alignr_epi8(w[i - 1U], w[i - 2U], 4));
+                w[i] = _mm_sha256msg2_epu32(msg, w[i - 1U]);
+            }
+            msg = _mm_add_epi32(w[i], _mm_loadu_si128((const __m128i *)&K[4U * i]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+        }
+
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    _mm_storeu_si128((__m128i *)&st[0], _mm_blend_epi16(tmp, state1, 0xF0));
+    _mm_storeu_si128((__m128i *)&st[4], _mm_alignr_epi8(state1, tmp, 8));
+}
+
+/**
+  * @brief  Two messages, the same number of blocks each, round by round
+  *         in lockstep; the schedule keeps the last four words per lane
+  */
+__attribute__((target("sha,sse4.1,ssse3")))
+static void sha256_blocks_shani_x2(uint32_t *st[2], const uint8_t *const p[2], size_t blocks)
+{
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+    __m128i state0[2], state1[2], tmp;
+    size_t off = 0U;
+
+    for (uint32_t l = 0U; l < 2U; l++) {
+        tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&st[l][0]), 0xB1);
+        state1[l] = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&st[l][4]), 0x1B);
+        state0[l] = _mm_alignr_epi8(tmp, state1[l], 8);
+        state1[l] = _mm_blend_epi16(state1[l], tmp, 0xF0);
+    }
+
+    for (; blocks > 0U; blocks--, off += TOOL_SHA256_BLOCK_SIZE) {
+        const __m128i abef[2] = { state0[0], state0[1] };
+        const __m128i cdgh[2] = { state1[0], state1[1] };
+        __m128i w[2][4];
+
+#pragma GCC unroll 16
+        for (uint32_t i = 0U; i < 16U; i++) {
+            const __m128i k = _mm_loadu_si128((const __m128i *)&K[4U * i]);
+
+            for (uint32_t l = 0U; l < 2U; l++) {
+                __m128i msg;
+
+                if (i < 4U) {
+                    w[l][i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&p[l][off + 16U * i]), bswap);
+                } else {
+                    msg = _mm_sha256msg1_epu32(w[l][i % 4U], w[l][(i + 1U) % 4U]);
+                    msg = _mm_add_epi32(msg, _mm_alignr_epi8(w[l][(i + 3U) % 4U], w[l][(i + 2U) % 4U], 4));
+                    w[l][i % 4U] = _mm_sha256msg2_epu32(msg, w[l][(i + 3U) % 4U]);
+                }
+                msg = _mm_add_epi32(w[l][i % 4U], k);
+                state1[l] = _mm_sha256rnds2_epu32(state1[l], state0[l], msg);
+                state0[l] = _mm_sha256rnds2_epu32(state0[l], state1[l], _mm_shuffle_epi32(msg, 0x0E));
+            }
+        }
+
+        for (uint32_t l = 0U; l < 2U; l++) {
+            state0[l] = _mm_add_epi32(state0[l], abef[l]);
+            state1[l] = _mm_add_epi32(state1[l], cdgh[l]);
+        }
+    }
+
+    for (uint32_t l = 0U; l < 2U; l++) {
+        tmp = _mm_shuffle_epi32(state0[l], 0x1B);
+        state1[l] = _mm_shuffle_epi32(state1[l], 0xB1);
+        _mm_storeu_si128((__m128i *)&st[l][0], _mm_blend_epi16(tmp, state1[l], 0xF0));
+        _mm_storeu_si128((__m128i *)&st[l][4], _mm_alignr_epi8(state1[l], tmp, 8));
+    }
+}
+
+static int cpu_has_shani(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || (ecx & bit_SSE4_1) == 0U || (ecx & bit_SSSE3) == 0U) {
+        return 0;
+    }
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    return (ebx & (1U << 29)) != 0U;    /* CPUID.7.0:EBX.SHA */
+}
+#endif
+
+static void sha256_select(void)
+{
+    const char *force = getenv("SECBOOT_TOOL_SHA");
+
+    blocks_x2_fn = sha256_blocks_portable_x2;
+    blocks_fn = sha256_blocks_portable;
+#ifdef TOOL_SHA256_HAVE_SHANI
+    if ((force == NULL || strcmp(force, "portable") != 0) && cpu_has_shani()) {
+        blocks_x2_fn = sha256_blocks_shani_x2;
+        blocks_fn = sha256_blocks_shani;
+        engine_name = "sha-ni";
+    }
+#else
+    (void)force;
+#endif
+}
+
+static void sha256_blocks(uint32_t st[8], const uint8_t *p, size_t blocks)
+{
+    if (blocks_fn == NULL) {
+        sha256_select();
+    }
+    blocks_fn(st, p, blocks);
+}
+
+/* Function implementations ---------------------------------------------*/
+
+void TOOL_SHA256_Init(TOOL_SHA256_Context *ctx)
+{
+    memcpy(ctx->state, H0, sizeof(ctx->state));
+    ctx->length = 0U;
+    ctx->blockLen = 0U;
+}
+
+void TOOL_SHA256_Update(TOOL_SHA256_Context *ctx, const void *pData, size_t length)
+{
+    const uint8_t *p = pData;
+
+    ctx->length += length;
+    if (ctx->blockLen > 0U) {
+        size_t take = TOOL_SHA256_BLOCK_SIZE - ctx->blockLen;
+
+        if (take > length) {
+            take = length;
+        }
+        memcpy(&ctx->block[ctx->blockLen], p, take);
+        ctx->blockLen += (uint32_t)take;
+        p += take;
+        length -= take;
+        if (ctx->blockLen < TOOL_SHA256_BLOCK_SIZE) {
+            return;
+        }
+        sha256_blocks(ctx->state, ctx->block, 1U);
+        ctx->blockLen = 0U;
+    }
+    if (length >= TOOL_SHA256_BLOCK_SIZE) {
+        size_t blocks = length / TOOL_SHA256_BLOCK_SIZE;
+
+        sha256_blocks(ctx->state, p, blocks);
+        p += blocks * TOOL_SHA256_BLOCK_SIZE;
+        length -= blocks * TOOL_SHA256_BLOCK_SIZE;
+    }
+    memcpy(ctx->block, p, length);
+    ctx->blockLen = (uint32_t)length;
+}
+
+void TOOL_SHA256_Final(TOOL_SHA256_Context *ctx, uint8_t digest[TOOL_SHA256_SIZE])
+{
+    uint64_t bits = ctx->length * 8U;
+
+    ctx->block[ctx->blockLen++] = 0x80U;
+    if (ctx->blockLen > TOOL_SHA256_BLOCK_SIZE - 8U) {
+        memset(&ctx->block[ctx->blockLen], 0, TOOL_SHA256_BLOCK_SIZE - ctx->blockLen);
+        sha256_blocks(ctx->state, ctx->block, 1U);
+        ctx->blockLen = 0U;
+    }
+    memset(&ctx->block[ctx->blockLen], 0, TOOL_SHA256_BLOCK_SIZE - 8U - ctx->blockLen);
+    for (uint32_t i = 0U; i < 8U; i++) {
+        ctx->block[TOOL_SHA256_BLOCK_SIZE - 1U - i] = (uint8_t)(bits >> (8U * i));
+    }
+    sha256_blocks(ctx->state, ctx->block, 1U);
+
+    for (uint32_t i = 0U; i < 8U; i++) {
+        digest[4U * i]      = (uint8_t)(ctx->state[i] >> 24);
+        digest[4U * i + 1U] = (uint8_t)(ctx->state[i] >> 16);
+        digest[4U * i + 2U] = (uint8_t)(ctx->state[i] >> 8);
+        digest[4U * i + 3U] = (uint8_t)ctx->state[i];
+    }
+}
+
+void TOOL_SHA256(const void *pData, size_t length, uint8_t digest[TOOL_SHA256_SIZE])
+{
+    TOOL_SHA256_Context ctx;
+
+    TOOL_SHA256_Init(&ctx);
+    TOOL_SHA256_Update(&ctx, pData, length);
+    TOOL_SHA256_Final(&ctx, digest);
+}
+
+void TOOL_HMAC_SHA256(const uint8_t *key, size_t keyLen, const uint8_t *const *parts, const size_t *lengths,
+                      size_t count, uint8_t mac[TOOL_SHA256_SIZE])
+{
+    uint8_t pad[TOOL_SHA256_BLOCK_SIZE];
+    uint8_t inner[TOOL_SHA256_SIZE];
+    TOOL_SHA256_Context ctx;
+
+    memset(pad, 0x36, sizeof(pad));
+    for (size_t i = 0U; i < keyLen && i < sizeof(pad); i++) {
+        pad[i] ^= key[i];
+    }
+    TOOL_SHA256_Init(&ctx);
+    TOOL_SHA256_Update(&ctx, pad, sizeof(pad));
+    for (size_t i = 0U; i < count; i++) {
+        TOOL_SHA256_Update(&ctx, parts[i], lengths[i]);
+    }
+    TOOL_SHA256_Final(&ctx, inner);
+
+    for (size_t i = 0U; i < sizeof(pad); i++) {
+        pad[i] ^= 0x36U ^ 0x5CU;
+    }
+    TOOL_SHA256_Init(&ctx);
+    TOOL_SHA256_Update(&ctx, pad, sizeof(pad));
+    TOOL_SHA256_Update(&ctx, inner, sizeof(inner));
+    TOOL_SHA256_Final(&ctx, mac);
+
+    memset(pad, 0, sizeof(pad));
+}
+
+void TOOL_SHA256_Multi(const uint8_t *const *messages, const size_t *lengths, size_t count,
+                       uint8_t (*digests)[TOOL_SHA256_SIZE])
+{
+    size_t i = 0U;
+
+    if (blocks_fn == NULL) {
+        sha256_select();
+    }
+
+    for (; i + 1U < count; i += 2U) {
+        TOOL_SHA256_Context ctx[2];
+        uint32_t *st[2] = { ctx[0].state, ctx[1].state };
+        const uint8_t *p[2] = { messages[i], messages[i + 1U] };
+        size_t common = ((lengths[i] < lengths[i + 1U]) ? lengths[i] : lengths[i + 1U]) / TOOL_SHA256_BLOCK_SIZE;
+
+        TOOL_SHA256_Init(&ctx[0]);
+        TOOL_SHA256_Init(&ctx[1]);
+        if (common > 0U) {
+            blocks_x2_fn(st, p, common);
+        }
+        for (uint32_t l = 0U; l < 2U; l++) {
+            ctx[l].length = common * TOOL_SHA256_BLOCK_SIZE;
+            TOOL_SHA256_Update(&ctx[l], &p[l][ctx[l].length], lengths[i + l] - ctx[l].length);
+            TOOL_SHA256_Final(&ctx[l], digests[i + l]);
+        }
+    }
+    if (i < count) {
+        TOOL_SHA256(messages[i], lengths[i], digests[i]);
+    }
+}
+
+const char *TOOL_SHA256_Engine(void)
+{
+    if (blocks_fn == NULL) {
+        sha256_select();
+    }
+    return engine_name;
+}